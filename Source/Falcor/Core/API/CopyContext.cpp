@@ -317,45 +317,49 @@ void CopyContext::updateTextureSubresources(
     }
 }
 
-CopyContext::ReadTextureTask::SharedPtr CopyContext::ReadTextureTask::create(
-    CopyContext* pCtx,
-    const Texture* pTexture,
-    uint32_t subresourceIndex
-)
+CopyContext::TextureReadbackLayout CopyContext::getTextureReadbackLayout(const Texture* pTexture, uint32_t subresourceIndex) const
 {
-    SharedPtr pThis = SharedPtr(new ReadTextureTask);
-    pThis->mpContext = pCtx;
-    // Get footprint
     gfx::ITextureResource* srcTexture = pTexture->getGfxTextureResource();
     gfx::FormatInfo formatInfo;
     gfx::gfxGetFormatInfo(srcTexture->getDesc()->format, &formatInfo);
 
     auto mipLevel = pTexture->getSubresourceMipLevel(subresourceIndex);
-    pThis->mActualRowSize =
-        uint32_t((pTexture->getWidth(mipLevel) + formatInfo.blockWidth - 1) / formatInfo.blockWidth * formatInfo.blockSizeInBytes);
+    TextureReadbackLayout layout;
+    layout.rowSize = uint32_t((pTexture->getWidth(mipLevel) + formatInfo.blockWidth - 1) / formatInfo.blockWidth * formatInfo.blockSizeInBytes);
     size_t rowAlignment = 1;
-    pCtx->mpDevice->getGfxDevice()->getTextureRowAlignment(&rowAlignment);
-    pThis->mRowSize = align_to(static_cast<uint32_t>(rowAlignment), pThis->mActualRowSize);
-    uint64_t rowCount = (pTexture->getHeight(mipLevel) + formatInfo.blockHeight - 1) / formatInfo.blockHeight;
-    uint64_t size = pTexture->getDepth(mipLevel) * rowCount * pThis->mRowSize;
+    mpDevice->getGfxDevice()->getTextureRowAlignment(&rowAlignment);
+    layout.rowPitch = align_to(static_cast<uint32_t>(rowAlignment), layout.rowSize);
+    layout.rowCount = (pTexture->getHeight(mipLevel) + formatInfo.blockHeight - 1) / formatInfo.blockHeight;
+    layout.depth = pTexture->getDepth(mipLevel);
+    return layout;
+}
 
-    // Create buffer
-    pThis->mpBuffer = pCtx->getDevice()->createBuffer(size, ResourceBindFlags::None, MemoryType::ReadBack, nullptr);
+void CopyContext::copyTextureSubresourceToBuffer(const Texture* pTexture, uint32_t subresourceIndex, const Buffer* pBuffer, uint64_t dstOffset)
+{
+    TextureReadbackLayout layout = getTextureReadbackLayout(pTexture, subresourceIndex);
+    FALCOR_CHECK(
+        dstOffset + layout.getTotalSize() <= pBuffer->getSize(),
+        "Buffer is too small ({} bytes) to hold the texture subresource ({} bytes at offset {}).",
+        pBuffer->getSize(),
+        layout.getTotalSize(),
+        dstOffset
+    );
 
-    // Copy from texture to buffer
-    pCtx->resourceBarrier(pTexture, Resource::State::CopySource);
-    auto encoder = pCtx->getLowLevelData()->getResourceCommandEncoder();
+    auto mipLevel = pTexture->getSubresourceMipLevel(subresourceIndex);
+    resourceBarrier(pTexture, Resource::State::CopySource);
+    resourceBarrier(pBuffer, Resource::State::CopyDest);
+    auto encoder = getLowLevelData()->getResourceCommandEncoder();
     gfx::SubresourceRange srcSubresource = {};
     srcSubresource.baseArrayLayer = pTexture->getSubresourceArraySlice(subresourceIndex);
     srcSubresource.mipLevel = mipLevel;
     srcSubresource.layerCount = 1;
     srcSubresource.mipLevelCount = 1;
     encoder->copyTextureToBuffer(
-        pThis->mpBuffer->getGfxBufferResource(),
-        0,
-        size,
-        pThis->mRowSize,
-        srcTexture,
+        pBuffer->getGfxBufferResource(),
+        dstOffset,
+        layout.getTotalSize(),
+        layout.rowPitch,
+        pTexture->getGfxTextureResource(),
         gfx::ResourceState::CopySource,
         srcSubresource,
         gfx::ITextureResource::Offset3D(0, 0, 0),
@@ -364,21 +368,40 @@ CopyContext::ReadTextureTask::SharedPtr CopyContext::ReadTextureTask::create(
             static_cast<gfx::GfxIndex>(pTexture->getHeight(mipLevel)),
             static_cast<gfx::GfxIndex>(pTexture->getDepth(mipLevel))}
     );
-    pCtx->setPendingCommands(true);
+    setPendingCommands(true);
+}
+
+CopyContext::ReadTextureTask::SharedPtr CopyContext::ReadTextureTask::create(
+    CopyContext* pCtx,
+    const Texture* pTexture,
+    uint32_t subresourceIndex
+)
+{
+    SharedPtr pThis = SharedPtr(new ReadTextureTask);
+    pThis->mpContext = pCtx;
+
+    // Get footprint
+    TextureReadbackLayout layout = pCtx->getTextureReadbackLayout(pTexture, subresourceIndex);
+    pThis->mActualRowSize = layout.rowSize;
+    pThis->mRowSize = layout.rowPitch;
+
+    // Create buffer and copy from texture to buffer
+    pThis->mpBuffer = pCtx->getDevice()->createBuffer(layout.getTotalSize(), ResourceBindFlags::None, MemoryType::ReadBack, nullptr);
+    pCtx->copyTextureSubresourceToBuffer(pTexture, subresourceIndex, pThis->mpBuffer.get());
 
     // Create a fence and signal
     pThis->mpFence = pCtx->getDevice()->createFence();
     pThis->mpFence->breakStrongReferenceToDevice();
     pCtx->submit(false);
     pCtx->signal(pThis->mpFence.get());
-    pThis->mRowCount = (uint32_t)rowCount;
-    pThis->mDepth = pTexture->getDepth(mipLevel);
+    pThis->mRowCount = layout.rowCount;
+    pThis->mDepth = layout.depth;
     return pThis;
 }
 
 void CopyContext::ReadTextureTask::getData(void* pData, size_t size) const
 {
-    FALCOR_ASSERT(size == size_t(mRowCount) * mActualRowSize * mDepth);
+    FALCOR_ASSERT(size == getDataSize());
 
     mpFence->wait();
 
@@ -402,7 +425,7 @@ void CopyContext::ReadTextureTask::getData(void* pData, size_t size) const
 
 std::vector<uint8_t> CopyContext::ReadTextureTask::getData() const
 {
-    std::vector<uint8_t> result(size_t(mRowCount) * mActualRowSize * mDepth);
+    std::vector<uint8_t> result(getDataSize());
     getData(result.data(), result.size());
     return result;
 }
@@ -49,6 +49,19 @@ class Profiler;
 class FALCOR_API CopyContext
 {
 public:
+    /**
+     * Layout of a texture subresource copied into a buffer. Rows are padded to the device texture row alignment.
+     */
+    struct TextureReadbackLayout
+    {
+        uint32_t rowPitch = 0; ///< Size of a row in the buffer in bytes (including padding).
+        uint32_t rowSize = 0;  ///< Size of the row data in bytes.
+        uint32_t rowCount = 0; ///< Number of rows (of blocks) per depth slice.
+        uint32_t depth = 0;    ///< Number of depth slices.
+
+        uint64_t getTotalSize() const { return uint64_t(rowPitch) * rowCount * depth; }
+    };
+
     class FALCOR_API ReadTextureTask
     {
     public:
@@ -56,6 +69,8 @@ public:
         static SharedPtr create(CopyContext* pCtx, const Texture* pTexture, uint32_t subresourceIndex);
         void getData(void* pData, size_t size) const;
         std::vector<uint8_t> getData() const;
+        /// Get the size in bytes of the tightly packed data returned by getData().
+        size_t getDataSize() const { return size_t(mRowCount) * mActualRowSize * mDepth; }
 
     private:
         ReadTextureTask() = default;
@@ -224,6 +239,21 @@ public:
      */
     ReadTextureTask::SharedPtr asyncReadTextureSubresource(const Texture* pTexture, uint32_t subresourceIndex);
 
+    /**
+     * Get the layout of a texture subresource when copied into a buffer with copyTextureSubresourceToBuffer().
+     */
+    TextureReadbackLayout getTextureReadbackLayout(const Texture* pTexture, uint32_t subresourceIndex) const;
+
+    /**
+     * Record a copy of a texture subresource into a buffer. The data is laid out as described by getTextureReadbackLayout().
+     * This only records the copy, the caller is responsible for submitting and synchronizing before accessing the buffer.
+     * @param[in] pTexture Source texture.
+     * @param[in] subresourceIndex Source subresource.
+     * @param[in] pBuffer Destination buffer.
+     * @param[in] dstOffset Offset into the destination buffer in bytes.
+     */
+    void copyTextureSubresourceToBuffer(const Texture* pTexture, uint32_t subresourceIndex, const Buffer* pBuffer, uint64_t dstOffset = 0);
+
     /**
      * Get the low-level context data
      */
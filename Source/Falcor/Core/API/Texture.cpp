@@ -37,7 +37,9 @@
 #include "Utils/Logger.h"
 #include "Utils/Threading.h"
 #include "Utils/Math/Common.h"
+#include "Utils/Image/ImageBufferPool.h"
 #include "Utils/Image/ImageIO.h"
+#include "Utils/Image/TextureDecoder.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Scripting/ndarray.h"
 #include "Core/Pass/FullScreenPass.h"
@@ -48,7 +50,29 @@ namespace Falcor
 {
 namespace
 {
-static constexpr bool kTopDown = true; // Memory layout when loading from file
+ref<Texture> createFromDecoded(ref<Device> pDevice, const DecodedTexture* pDecoded, ResourceBindFlags bindFlags)
+{
+    if (!pDecoded)
+        return nullptr;
+
+    ref<Texture> pTex = TextureUploader(pDevice).upload(*pDecoded, bindFlags);
+
+    if (pTex != nullptr)
+    {
+        // Log debug info.
+        std::string str = fmt::format(
+            "Loaded texture: size={}x{} mips={} format={} path={}",
+            pTex->getWidth(),
+            pTex->getHeight(),
+            pTex->getMipCount(),
+            to_string(pTex->getFormat()),
+            pDecoded->sourcePath
+        );
+        logDebug(str);
+    }
+
+    return pTex;
+}
 
 gfx::IResource::Type getGfxResourceType(Texture::Type type)
 {
@@ -268,97 +292,12 @@ ref<Texture> Texture::createMippedFromFiles(
     Bitmap::ImportFlags importFlags
 )
 {
-    std::vector<Bitmap::UniqueConstPtr> mips;
-    mips.reserve(paths.size());
-    size_t combinedSize = 0;
-    std::filesystem::path fullPathMip0;
-
-    for (const auto& path : paths)
-    {
-        Bitmap::UniqueConstPtr pBitmap;
-        if (hasExtension(path, "dds"))
-        {
-            pBitmap = ImageIO::loadBitmapFromDDS(path);
-        }
-        else
-        {
-            pBitmap = Bitmap::createFromFile(path, kTopDown, importFlags);
-        }
-        if (!pBitmap)
-        {
-            logWarning("Error loading mip {}. Loading failed for image file '{}'.", mips.size(), path);
-            break;
-        }
-
-        if (!mips.empty())
-        {
-            if (mips.back()->getFormat() != pBitmap->getFormat())
-            {
-                logWarning("Error loading mip {} from file {}. Texture format of all mip levels must match.", mips.size(), path);
-                break;
-            }
-            if (std::max(mips.back()->getWidth() / 2, 1u) != pBitmap->getWidth() ||
-                std::max(mips.back()->getHeight() / 2, 1u) != pBitmap->getHeight())
-            {
-                logWarning(
-                    "Error loading mip {} from file {}. Image resolution must decrease by half. ({}, {}) != ({}, {})/2",
-                    mips.size(),
-                    path,
-                    pBitmap->getWidth(),
-                    pBitmap->getHeight(),
-                    mips.back()->getWidth(),
-                    mips.back()->getHeight()
-                );
-                break;
-            }
-        }
-        else
-        {
-            fullPathMip0 = path;
-        }
-        combinedSize += pBitmap->getSize();
-        mips.emplace_back(std::move(pBitmap));
-    }
-
-    ref<Texture> pTex;
-    if (!mips.empty())
-    {
-        // Combine all the mip data into a single buffer
-        size_t copyDst = 0;
-        std::unique_ptr<uint8_t[]> combinedData(new uint8_t[combinedSize]);
-        for (auto& mip : mips)
-        {
-            std::memcpy(&combinedData[copyDst], mip->getData(), mip->getSize());
-            copyDst += mip->getSize();
-        }
-
-        ResourceFormat texFormat = mips[0]->getFormat();
-        if (loadAsSrgb)
-            texFormat = linearToSrgbFormat(texFormat);
-
-        // Create mip mapped texture.
-        pTex =
-            pDevice->createTexture2D(mips[0]->getWidth(), mips[0]->getHeight(), texFormat, 1, mips.size(), combinedData.get(), bindFlags);
-    }
-
-    if (pTex != nullptr)
-    {
-        pTex->setSourcePath(fullPathMip0);
-        pTex->mImportFlags = importFlags;
-
-        // Log debug info.
-        std::string str = fmt::format(
-            "Loaded texture: size={}x{} mips={} format={} path={}",
-            pTex->getWidth(),
-            pTex->getHeight(),
-            pTex->getMipCount(),
-            to_string(pTex->getFormat()),
-            fullPathMip0
-        );
-        logDebug(str);
-    }
+    TextureDecoder::Request request;
+    request.paths.assign(paths.begin(), paths.end());
+    request.loadAsSRGB = loadAsSrgb;
+    request.importFlags = importFlags;
 
-    return pTex;
+    return createFromDecoded(pDevice, TextureDecoder::decode(request).get(), bindFlags);
 }
 
 ref<Texture> Texture::createFromFile(
@@ -370,65 +309,13 @@ ref<Texture> Texture::createFromFile(
     Bitmap::ImportFlags importFlags
 )
 {
-    if (!std::filesystem::exists(path))
-    {
-        logWarning("Error when loading image file. File '{}' does not exist.", path);
-        return nullptr;
-    }
+    TextureDecoder::Request request;
+    request.paths = {path};
+    request.generateMipLevels = generateMipLevels;
+    request.loadAsSRGB = loadAsSrgb;
+    request.importFlags = importFlags;
 
-    ref<Texture> pTex;
-    if (hasExtension(path, "dds"))
-    {
-        try
-        {
-            pTex = ImageIO::loadTextureFromDDS(pDevice, path, loadAsSrgb);
-        }
-        catch (const std::exception& e)
-        {
-            logWarning("Error loading '{}': {}", path, e.what());
-        }
-    }
-    else
-    {
-        Bitmap::UniqueConstPtr pBitmap = Bitmap::createFromFile(path, kTopDown, importFlags);
-        if (pBitmap)
-        {
-            ResourceFormat texFormat = pBitmap->getFormat();
-            if (loadAsSrgb)
-            {
-                texFormat = linearToSrgbFormat(texFormat);
-            }
-
-            pTex = pDevice->createTexture2D(
-                pBitmap->getWidth(),
-                pBitmap->getHeight(),
-                texFormat,
-                1,
-                generateMipLevels ? Texture::kMaxPossible : 1,
-                pBitmap->getData(),
-                bindFlags
-            );
-        }
-    }
-
-    if (pTex != nullptr)
-    {
-        pTex->setSourcePath(path);
-        pTex->mImportFlags = importFlags;
-
-        // Log debug info.
-        std::string str = fmt::format(
-            "Loaded texture: size={}x{} mips={} format={} path={}",
-            pTex->getWidth(),
-            pTex->getHeight(),
-            pTex->getMipCount(),
-            to_string(pTex->getFormat()),
-            path
-        );
-        logDebug(str);
-    }
-
-    return pTex;
+    return createFromDecoded(pDevice, TextureDecoder::decode(request).get(), bindFlags);
 }
 
 gfx::IResource* Texture::getGfxResource() const
@@ -605,7 +492,7 @@ void Texture::captureToFile(
     // Handle the special case where we have an HDR texture with less then 3 channels.
     FormatType type = getFormatType(mFormat);
     uint32_t channels = getFormatChannelCount(mFormat);
-    std::vector<uint8_t> textureData;
+    CopyContext::ReadTextureTask::SharedPtr pReadTask;
     ResourceFormat resourceFormat = mFormat;
 
     if (type == FormatType::Float && channels < 3)
@@ -620,19 +507,24 @@ void Texture::captureToFile(
             ResourceBindFlags::RenderTarget | ResourceBindFlags::ShaderResource
         );
         pContext->blit(getSRV(mipLevel, 1, arraySlice, 1), pOther->getRTV(0, 0, 1));
-        textureData = pContext->readTextureSubresource(pOther.get(), 0);
+        pReadTask = pContext->asyncReadTextureSubresource(pOther.get(), 0);
         resourceFormat = ResourceFormat::RGBA32Float;
     }
     else
     {
         uint32_t subresource = getSubresourceIndex(arraySlice, mipLevel);
-        textureData = pContext->readTextureSubresource(this, subresource);
+        pReadTask = pContext->asyncReadTextureSubresource(this, subresource);
     }
 
+    // Read back into a pooled buffer. It is shared with the (possibly async) save task to avoid copying the data.
+    size_t dataSize = pReadTask->getDataSize();
+    auto pTextureData = std::make_shared<ImageBufferPool::Buffer>(ImageBufferPool::getGlobal().allocate(dataSize));
+    pReadTask->getData(pTextureData->get(), dataSize);
+
     uint32_t width = getWidth(mipLevel);
     uint32_t height = getHeight(mipLevel);
 
-    auto func = [=]() { Bitmap::saveImage(path, width, height, format, exportFlags, resourceFormat, true, (void*)textureData.data()); };
+    auto func = [=]() { Bitmap::saveImage(path, width, height, format, exportFlags, resourceFormat, true, pTextureData->get()); };
 
     if (async)
         Threading::dispatchTask(func);
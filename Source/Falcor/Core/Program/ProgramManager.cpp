@@ -114,6 +114,15 @@ ProgramManager::ProgramManager(Device* pDevice) : mpDevice(pDevice)
 
     addGlobalDefines(globalDefines);
 
+    mpVariantCache = std::make_unique<ProgramVariantCache>(mpDevice->getDesc().shaderCachePath);
+}
+
+ProgramManager::~ProgramManager()
+{
+    // Drop pending background compilation, but finish the variant currently being compiled.
+    mPrecompileThreadPool.purge();
+    mPrecompileThreadPool.wait_for_tasks();
+    mpVariantCache->flush();
 }
 
 ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& program, std::string& log) const
@@ -121,53 +130,37 @@ ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& pr
     CpuTimer timer;
     timer.update();
 
-    auto pSlangRequest = createSlangCompileRequest(program);
-    if (pSlangRequest == nullptr)
-        return nullptr;
+    std::lock_guard<std::mutex> lock(mCompileMutex);
 
-    SlangResult slangResult = spCompile(pSlangRequest);
-    log += spGetDiagnosticOutput(pSlangRequest);
-    if (SLANG_FAILED(slangResult))
+    // Reuse the compilation artifacts of the variant if it was compiled before (or precompiled in the background).
+    const std::string key = computeVariantKey(program.mDesc, program.getDefineList());
+    ProgramVariantCache::Artifacts artifacts;
+    bool needsCompile = mpVariantCache->lookup(key, &artifacts) != ProgramVariantCache::LookupResult::MemoryHit;
+    if (!needsCompile)
     {
-        spDestroyCompileRequest(pSlangRequest);
-        return nullptr;
+        // Variants precompiled in the background live in the worker's Slang global session. Slang objects must not be used
+        // concurrently, so the session is retired and the worker moves on to a new one. If a background compile is still
+        // running on the session, compile the variant here instead of waiting for it.
+        slang::IGlobalSession* pSession = artifacts.pSlangGlobalScope->getSession()->getGlobalSession();
+        std::lock_guard<std::mutex> sessionLock(mPrecompileSessionMutex);
+        if (pSession == mpPrecompileSlangSession)
+            mpPrecompileSlangSession = nullptr;
+        needsCompile = mPrecompileInFlightCounts.count(pSession) > 0;
     }
-
-    Slang::ComPtr<slang::IComponentType> pSlangGlobalScope;
-    spCompileRequest_getProgram(pSlangRequest, pSlangGlobalScope.writeRef());
-
-    Slang::ComPtr<slang::ISession> pSlangSession(pSlangGlobalScope->getSession());
-
-    // Prepare entry points.
-    std::vector<Slang::ComPtr<slang::IComponentType>> pSlangEntryPoints;
-    for (const auto& entryPointGroup : program.mDesc.entryPointGroups)
+    if (needsCompile)
     {
-        for (const auto& entryPoint : entryPointGroup.entryPoints)
-        {
-            Slang::ComPtr<slang::IComponentType> pSlangEntryPoint;
-            spCompileRequest_getEntryPoint(pSlangRequest, entryPoint.globalIndex, pSlangEntryPoint.writeRef());
-
-            // Rename entry point in the generated code if the exported name differs from the source name.
-            // This makes it possible to generate different specializations of the same source entry point,
-            // for example by setting different type conformances.
-            if (entryPoint.exportName != entryPoint.name)
-            {
-                Slang::ComPtr<slang::IComponentType> pRenamedEntryPoint;
-                pSlangEntryPoint->renameEntryPoint(entryPoint.exportName.c_str(), pRenamedEntryPoint.writeRef());
-                pSlangEntryPoints.push_back(pRenamedEntryPoint);
-            }
-            else
-            {
-                pSlangEntryPoints.push_back(pSlangEntryPoint);
-            }
-        }
+        if (!compileVariant(program.mDesc, program.getDefineList(), artifacts, log))
+            return nullptr;
+        mpVariantCache->insert(key, program.mDesc, program.getDefineList(), artifacts);
     }
 
-    // Extract list of files referenced, for dependency-tracking purposes.
-    int depFileCount = spGetDependencyFileCount(pSlangRequest);
-    for (int ii = 0; ii < depFileCount; ++ii)
+    const auto& pSlangGlobalScope = artifacts.pSlangGlobalScope;
+    const auto& pSlangEntryPoints = artifacts.pSlangEntryPoints;
+
+    // Record the files referenced, for dependency-tracking purposes.
+    program.mFileTimeMap.clear(); // TODO @skallweit
+    for (const auto& depFilePath : artifacts.dependencies)
     {
-        std::string depFilePath = spGetDependencyFilePath(pSlangRequest, ii);
         if (std::filesystem::exists(depFilePath))
             program.mFileTimeMap[depFilePath] = getFileModifiedTime(depFilePath);
     }
@@ -185,19 +178,6 @@ ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& pr
     // TODO @skallweit remove const cast
     ref<ProgramVersion> pVersion = ProgramVersion::createEmpty(const_cast<Program*>(&program), pSlangGlobalScope);
 
-    // Note: Because of interactions between how `SV_Target` outputs
-    // and `u` register bindings work in Slang today (as a compatibility
-    // feature for Shader Model 5.0 and below), we need to make sure
-    // that the entry points are included in the component type we use
-    // for reflection.
-    //
-    // TODO: Once Slang drops that behavior for SM 5.1+, we should be able
-    // to just use `pSlangGlobalScope` for the reflection step instead
-    // of `pSlangProgram`.
-    //
-    Slang::ComPtr<slang::IComponentType> pSlangProgram;
-    spCompileRequest_getProgram(pSlangRequest, pSlangProgram.writeRef());
-
     ref<const ProgramReflection> pReflector;
     if (!doSlangReflection(*pVersion, pSlangGlobalScope, pSlangEntryPoints, pReflector, log))
     {
@@ -217,6 +197,75 @@ ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& pr
     return pVersion;
 }
 
+bool ProgramManager::compileVariant(
+    const ProgramDesc& desc,
+    const DefineList& defines,
+    ProgramVariantCache::Artifacts& artifacts,
+    std::string& log
+) const
+{
+    auto pSlangRequest = createSlangCompileRequest(mpDevice->getSlangGlobalSession(), desc, defines);
+    if (pSlangRequest == nullptr)
+        return false;
+
+    return compileRequest(pSlangRequest, desc, artifacts, log);
+}
+
+bool ProgramManager::compileRequest(
+    SlangCompileRequest* pSlangRequest,
+    const ProgramDesc& desc,
+    ProgramVariantCache::Artifacts& artifacts,
+    std::string& log
+) const
+{
+    SlangResult slangResult = spCompile(pSlangRequest);
+    log += spGetDiagnosticOutput(pSlangRequest);
+    if (SLANG_FAILED(slangResult))
+    {
+        spDestroyCompileRequest(pSlangRequest);
+        return false;
+    }
+
+    spCompileRequest_getProgram(pSlangRequest, artifacts.pSlangGlobalScope.writeRef());
+
+    // Prepare entry points.
+    artifacts.pSlangEntryPoints.clear();
+    for (const auto& entryPointGroup : desc.entryPointGroups)
+    {
+        for (const auto& entryPoint : entryPointGroup.entryPoints)
+        {
+            Slang::ComPtr<slang::IComponentType> pSlangEntryPoint;
+            spCompileRequest_getEntryPoint(pSlangRequest, entryPoint.globalIndex, pSlangEntryPoint.writeRef());
+
+            // Rename entry point in the generated code if the exported name differs from the source name.
+            // This makes it possible to generate different specializations of the same source entry point,
+            // for example by setting different type conformances.
+            if (entryPoint.exportName != entryPoint.name)
+            {
+                Slang::ComPtr<slang::IComponentType> pRenamedEntryPoint;
+                pSlangEntryPoint->renameEntryPoint(entryPoint.exportName.c_str(), pRenamedEntryPoint.writeRef());
+                artifacts.pSlangEntryPoints.push_back(pRenamedEntryPoint);
+            }
+            else
+            {
+                artifacts.pSlangEntryPoints.push_back(pSlangEntryPoint);
+            }
+        }
+    }
+
+    // Extract list of files referenced, for dependency-tracking purposes.
+    artifacts.dependencies.clear();
+    int depFileCount = spGetDependencyFileCount(pSlangRequest);
+    for (int ii = 0; ii < depFileCount; ++ii)
+    {
+        std::string depFilePath = spGetDependencyFilePath(pSlangRequest, ii);
+        if (std::filesystem::exists(depFilePath))
+            artifacts.dependencies.push_back(depFilePath);
+    }
+
+    return true;
+}
+
 ref<const ProgramKernels> ProgramManager::createProgramKernels(
     const Program& program,
     const ProgramVersion& programVersion,
@@ -227,6 +276,8 @@ ref<const ProgramKernels> ProgramManager::createProgramKernels(
     CpuTimer timer;
     timer.update();
 
+    std::lock_guard<std::mutex> lock(mCompileMutex);
+
     auto pSlangGlobalScope = programVersion.getSlangGlobalScope();
     auto pSlangSession = pSlangGlobalScope->getSession();
 
@@ -548,6 +599,157 @@ ref<const EntryPointGroupKernels> ProgramManager::createEntryPointGroupKernels(
     return nullptr;
 }
 
+void ProgramManager::precompileVariants(ProgramDesc desc, const std::vector<DefineList>& variants)
+{
+    desc = normalizeDesc(std::move(desc));
+    for (const auto& defines : variants)
+        mPrecompileThreadPool.push_task([this, desc, defines]() { precompileVariant(desc, defines); });
+}
+
+size_t ProgramManager::precompileKnownVariants(ProgramDesc desc, const DefineList& defines, const std::vector<std::string>& axes)
+{
+    desc = normalizeDesc(std::move(desc));
+
+    auto differsOnlyInAxes = [&](const DefineList& other)
+    {
+        auto isAxis = [&](const std::string& name) { return std::find(axes.begin(), axes.end(), name) != axes.end(); };
+        for (const auto& [name, value] : defines)
+        {
+            auto it = other.find(name);
+            if (!isAxis(name) && (it == other.end() || it->second != value))
+                return false;
+        }
+        for (const auto& [name, value] : other)
+        {
+            if (!isAxis(name) && defines.find(name) == defines.end())
+                return false;
+        }
+        return true;
+    };
+
+    std::vector<DefineList> variants;
+    for (const auto& entry : mpVariantCache->getEntries(ProgramVariantCache::getDescription(desc)))
+    {
+        if (entry.defines != defines && differsOnlyInAxes(entry.defines))
+            variants.push_back(entry.defines);
+    }
+
+    precompileVariants(std::move(desc), variants);
+    return variants.size();
+}
+
+void ProgramManager::waitForPrecompilation()
+{
+    mPrecompileThreadPool.wait_for_tasks();
+    mpVariantCache->flush();
+}
+
+ProgramDesc ProgramManager::normalizeDesc(ProgramDesc desc) const
+{
+    // Apply the same adjustments as the Program constructor so that keys match.
+    desc.finalize();
+    if (desc.shaderModel == ShaderModel::Unknown)
+        desc.shaderModel = mpDevice->getDefaultShaderModel();
+    return desc;
+}
+
+std::string ProgramManager::computeVariantKey(const ProgramDesc& desc, const DefineList& defines) const
+{
+    // Collect all global compiler state that affects the compilation result.
+    std::vector<std::string> extraArguments;
+    extraArguments.push_back(fmt::format("device={}", int(mpDevice->getType())));
+    for (const auto& [name, value] : mGlobalDefineList)
+        extraArguments.push_back(fmt::format("-D{}={}", name, value));
+    for (const auto& arg : mGlobalCompilerArguments)
+        extraArguments.push_back(arg);
+    extraArguments.push_back(fmt::format("forceEnabled={}", uint32_t(mForcedCompilerFlags.enabled)));
+    extraArguments.push_back(fmt::format("forceDisabled={}", uint32_t(mForcedCompilerFlags.disabled)));
+    extraArguments.push_back(fmt::format("debugInfo={}", mGenerateDebugInfo));
+    extraArguments.push_back(fmt::format("spirv={}", getEnvironmentVariable("FALCOR_USE_SLANG_SPIRV_BACKEND").value_or("")));
+    for (const auto& path : getShaderDirectoriesList())
+        extraArguments.push_back(path.string());
+    return ProgramVariantCache::computeKey(desc, defines, extraArguments);
+}
+
+void ProgramManager::precompileVariant(const ProgramDesc& desc, const DefineList& defines)
+{
+    CpuTimer timer;
+    timer.update();
+
+    // The worker compiles on its own Slang global session, so the compile mutex is only held while the compile request
+    // is created from the global compiler state.
+    std::string key;
+    {
+        std::lock_guard<std::mutex> compileLock(mCompileMutex);
+        key = computeVariantKey(desc, defines);
+        if (mpVariantCache->hasArtifacts(key))
+            return;
+    }
+
+    // Mark a compile in flight on the current session, so that its variants are not used elsewhere until it is done.
+    // Creating a global session is slow, so it is done without holding the session mutex.
+    Slang::ComPtr<slang::IGlobalSession> pSession;
+    while (!pSession)
+    {
+        {
+            std::lock_guard<std::mutex> sessionLock(mPrecompileSessionMutex);
+            if (mpPrecompileSlangSession)
+            {
+                pSession = mpPrecompileSlangSession;
+                mPrecompileInFlightCounts[pSession.get()]++;
+                break;
+            }
+        }
+        Slang::ComPtr<slang::IGlobalSession> pNewSession;
+        slang::createGlobalSession(pNewSession.writeRef());
+        std::lock_guard<std::mutex> sessionLock(mPrecompileSessionMutex);
+        if (!mpPrecompileSlangSession)
+            mpPrecompileSlangSession = pNewSession;
+    }
+
+    bool succeeded = false;
+    try
+    {
+        SlangCompileRequest* pSlangRequest = nullptr;
+        {
+            std::lock_guard<std::mutex> compileLock(mCompileMutex);
+            pSlangRequest = createSlangCompileRequest(pSession, desc, defines);
+        }
+
+        std::string log;
+        ProgramVariantCache::Artifacts artifacts;
+        if (pSlangRequest && compileRequest(pSlangRequest, desc, artifacts, log))
+        {
+            mpVariantCache->insert(key, desc, defines, std::move(artifacts), true);
+            succeeded = true;
+        }
+        else
+        {
+            logWarning("Failed to precompile program variant '{}':\n{}", ProgramVariantCache::getDescription(desc), log);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        logWarning("Failed to precompile program variant '{}': {}", ProgramVariantCache::getDescription(desc), e.what());
+    }
+
+    {
+        std::lock_guard<std::mutex> sessionLock(mPrecompileSessionMutex);
+        auto it = mPrecompileInFlightCounts.find(pSession.get());
+        if (--it->second == 0)
+            mPrecompileInFlightCounts.erase(it);
+    }
+    if (!succeeded)
+        return;
+
+    // Write the manifest once the queue of variants has been worked off.
+    if (mPrecompileThreadPool.get_tasks_queued() == 0)
+        mpVariantCache->flush();
+
+    timer.update();
+    logDebug("Precompiled program variant in {:.3f} s: {}", timer.delta(), ProgramVariantCache::getDescription(desc));
+}
+
 std::string ProgramManager::getHlslLanguagePrelude() const
 {
     Slang::ComPtr<ISlangBlob> prelude;
@@ -588,18 +790,25 @@ bool ProgramManager::reloadAllPrograms(bool forceReload)
 
 void ProgramManager::addGlobalDefines(const DefineList& defineList)
 {
-    mGlobalDefineList.add(defineList);
+    {
+        std::lock_guard<std::mutex> lock(mCompileMutex);
+        mGlobalDefineList.add(defineList);
+    }
     reloadAllPrograms(true);
 }
 
 void ProgramManager::removeGlobalDefines(const DefineList& defineList)
 {
-    mGlobalDefineList.remove(defineList);
+    {
+        std::lock_guard<std::mutex> lock(mCompileMutex);
+        mGlobalDefineList.remove(defineList);
+    }
     reloadAllPrograms(true);
 }
 
 void ProgramManager::setGenerateDebugInfoEnabled(bool enabled)
 {
+    std::lock_guard<std::mutex> lock(mCompileMutex);
     mGenerateDebugInfo = enabled;
 }
 
@@ -610,7 +819,10 @@ bool ProgramManager::isGenerateDebugInfoEnabled()
 
 void ProgramManager::setForcedCompilerFlags(ForcedCompilerFlags forcedCompilerFlags)
 {
-    mForcedCompilerFlags = forcedCompilerFlags;
+    {
+        std::lock_guard<std::mutex> lock(mCompileMutex);
+        mForcedCompilerFlags = forcedCompilerFlags;
+    }
     reloadAllPrograms(true);
 }
 
@@ -619,9 +831,12 @@ ProgramManager::ForcedCompilerFlags ProgramManager::getForcedCompilerFlags()
     return mForcedCompilerFlags;
 }
 
-SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& program) const
+SlangCompileRequest* ProgramManager::createSlangCompileRequest(
+    slang::IGlobalSession* pSlangGlobalSession,
+    const ProgramDesc& desc,
+    const DefineList& defines
+) const
 {
-    slang::IGlobalSession* pSlangGlobalSession = mpDevice->getSlangGlobalSession();
     FALCOR_ASSERT(pSlangGlobalSession);
 
     slang::SessionDesc sessionDesc;
@@ -644,13 +859,13 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
 
     slang::TargetDesc targetDesc;
     targetDesc.format = SLANG_TARGET_UNKNOWN;
-    targetDesc.profile = pSlangGlobalSession->findProfile(getSlangProfileString(program.mDesc.shaderModel).c_str());
+    targetDesc.profile = pSlangGlobalSession->findProfile(getSlangProfileString(desc.shaderModel).c_str());
 
     if (targetDesc.profile == SLANG_PROFILE_UNKNOWN)
-        FALCOR_THROW("Can't find Slang profile for shader model {}", program.mDesc.shaderModel);
+        FALCOR_THROW("Can't find Slang profile for shader model {}", desc.shaderModel);
 
     // Get compiler flags and adjust with forced flags.
-    SlangCompilerFlags compilerFlags = program.mDesc.compilerFlags;
+    SlangCompilerFlags compilerFlags = desc.compilerFlags;
     compilerFlags &= ~mForcedCompilerFlags.disabled;
     compilerFlags |= mForcedCompilerFlags.enabled;
 
@@ -676,7 +891,7 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
 
     targetDesc.forceGLSLScalarBufferLayout = true;
 
-    if (getEnvironmentVariable("FALCOR_USE_SLANG_SPIRV_BACKEND") == "1" || program.mDesc.useSPIRVBackend)
+    if (getEnvironmentVariable("FALCOR_USE_SLANG_SPIRV_BACKEND") == "1" || desc.useSPIRVBackend)
     {
         targetDesc.flags |= SLANG_TARGET_FLAG_GENERATE_SPIRV_DIRECTLY;
     }
@@ -711,7 +926,7 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
     // Add global followed by program specific defines.
     for (const auto& shaderDefine : mGlobalDefineList)
         addSlangDefine(shaderDefine.first.c_str(), shaderDefine.second.c_str());
-    for (const auto& shaderDefine : program.getDefineList())
+    for (const auto& shaderDefine : defines)
         addSlangDefine(shaderDefine.first.c_str(), shaderDefine.second.c_str());
 
     // Add a `#define`s based on the target and shader model.
@@ -719,7 +934,7 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
 
     // Add a `#define` based on the shader model.
     std::string sm = fmt::format(
-        "__SM_{}_{}__", getShaderModelMajorVersion(program.mDesc.shaderModel), getShaderModelMinorVersion(program.mDesc.shaderModel)
+        "__SM_{}_{}__", getShaderModelMajorVersion(desc.shaderModel), getShaderModelMinorVersion(desc.shaderModel)
     );
     addSlangDefine(sm.c_str(), "1");
 
@@ -764,18 +979,16 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
     pSlangGlobalSession->createSession(sessionDesc, pSlangSession.writeRef());
     FALCOR_ASSERT(pSlangSession);
 
-    program.mFileTimeMap.clear(); // TODO @skallweit
-
     SlangCompileRequest* pSlangRequest = nullptr;
     pSlangSession->createCompileRequest(&pSlangRequest);
     FALCOR_ASSERT(pSlangRequest);
 
     // Enable/disable intermediates dump
-    bool dumpIR = is_set(program.mDesc.compilerFlags, SlangCompilerFlags::DumpIntermediates);
+    bool dumpIR = is_set(desc.compilerFlags, SlangCompilerFlags::DumpIntermediates);
     spSetDumpIntermediates(pSlangRequest, dumpIR);
 
     // Set debug level
-    if (mGenerateDebugInfo || is_set(program.mDesc.compilerFlags, SlangCompilerFlags::GenerateDebugInfo))
+    if (mGenerateDebugInfo || is_set(desc.compilerFlags, SlangCompilerFlags::GenerateDebugInfo))
         spSetDebugInfoLevel(pSlangRequest, SLANG_DEBUG_INFO_LEVEL_STANDARD);
 
     // Configure any flags for the Slang compilation step
@@ -794,7 +1007,7 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
         std::vector<const char*> args;
         for (const auto& arg : mGlobalCompilerArguments)
             args.push_back(arg.c_str());
-        for (const auto& arg : program.mDesc.compilerArguments)
+        for (const auto& arg : desc.compilerArguments)
             args.push_back(arg.c_str());
 #if FALCOR_NVAPI_AVAILABLE
         // If NVAPI is available, we need to inform slang/dxc where to find it.
@@ -806,9 +1019,9 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
             spProcessCommandLineArguments(pSlangRequest, args.data(), (int)args.size());
     }
 
-    for (size_t moduleIndex = 0; moduleIndex < program.mDesc.shaderModules.size(); ++moduleIndex)
+    for (size_t moduleIndex = 0; moduleIndex < desc.shaderModules.size(); ++moduleIndex)
     {
-        const auto& module = program.mDesc.shaderModules[moduleIndex];
+        const auto& module = desc.shaderModules[moduleIndex];
         // If module name is empty, pass in nullptr to let Slang generate a name internally.
         const char* name = !module.name.empty() ? module.name.c_str() : nullptr;
         int translationUnitIndex = spAddTranslationUnit(pSlangRequest, SLANG_SOURCE_LANGUAGE_SLANG, name);
@@ -850,7 +1063,7 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
     // Each entry point references the index of the source
     // it uses, and luckily, the Slang API can use these
     // indices directly.
-    for (const auto& entryPointGroup : program.mDesc.entryPointGroups)
+    for (const auto& entryPointGroup : desc.entryPointGroups)
     {
         for (const auto& entryPoint : entryPointGroup.entryPoints)
         {
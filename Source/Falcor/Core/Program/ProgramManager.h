@@ -27,10 +27,15 @@
  **************************************************************************/
 #pragma once
 #include "Program.h"
+#include "ProgramVariantCache.h"
 #include "Core/Macros.h"
 #include "Core/API/fwd.h"
 
+#include <BS_thread_pool/BS_thread_pool.hpp>
+
+#include <map>
 #include <memory>
+#include <mutex>
 
 namespace Falcor
 {
@@ -39,6 +44,7 @@ class FALCOR_API ProgramManager
 {
 public:
     ProgramManager(Device* pDevice);
+    ~ProgramManager();
 
     /**
      * Defines flags that should be forcefully disabled or enabled on all shaders.
@@ -144,8 +150,41 @@ public:
     const CompilationStats& getCompilationStats() { return mCompilationStats; }
     void resetCompilationStats() { mCompilationStats = {}; }
 
+    /**
+     * Compile program variants in the background.
+     * Variants are compiled one at a time on a worker thread and stored in the program variant cache,
+     * so that creating the corresponding program versions later does not need to invoke the Slang compiler.
+     * @param[in] desc Program description.
+     * @param[in] variants List of define lists, one per variant.
+     */
+    void precompileVariants(ProgramDesc desc, const std::vector<DefineList>& variants);
+
+    /**
+     * Compile known variants of a program in the background.
+     * Known variants are the variants of the same program that were used in previous runs (see ProgramVariantCache).
+     * Only variants that differ from the given defines in the listed axes are compiled.
+     * @param[in] desc Program description.
+     * @param[in] defines Defines of the currently used variant.
+     * @param[in] axes Names of the defines allowed to differ.
+     * @return Returns the number of variants scheduled for compilation.
+     */
+    size_t precompileKnownVariants(ProgramDesc desc, const DefineList& defines, const std::vector<std::string>& axes);
+
+    /// Wait for all background compilation to finish.
+    void waitForPrecompilation();
+
+    /// Get the program variant cache.
+    ProgramVariantCache& getVariantCache() const { return *mpVariantCache; }
+
 private:
-    SlangCompileRequest* createSlangCompileRequest(const Program& program) const;
+    ProgramDesc normalizeDesc(ProgramDesc desc) const;
+    std::string computeVariantKey(const ProgramDesc& desc, const DefineList& defines) const;
+    bool compileVariant(const ProgramDesc& desc, const DefineList& defines, ProgramVariantCache::Artifacts& artifacts, std::string& log) const;
+    bool compileRequest(SlangCompileRequest* pSlangRequest, const ProgramDesc& desc, ProgramVariantCache::Artifacts& artifacts, std::string& log)
+        const;
+    void precompileVariant(const ProgramDesc& desc, const DefineList& defines);
+    SlangCompileRequest* createSlangCompileRequest(slang::IGlobalSession* pSlangGlobalSession, const ProgramDesc& desc, const DefineList& defines)
+        const;
 
     Device* mpDevice;
 
@@ -158,6 +197,18 @@ private:
     ForcedCompilerFlags mForcedCompilerFlags;
 
     mutable uint32_t mHitGroupID = 0;
+
+    /// Serializes all use of the device's Slang global session and of the global compiler state.
+    mutable std::mutex mCompileMutex;
+    /// Slang global session used by the precompilation worker. It is retired once one of its variants is used on another
+    /// thread, and the worker moves on to a new session. mPrecompileSessionMutex only guards the session pointer and the
+    /// in-flight counts, it is never held across a compile. Lock order is mCompileMutex, then mPrecompileSessionMutex.
+    mutable std::mutex mPrecompileSessionMutex;
+    mutable Slang::ComPtr<slang::IGlobalSession> mpPrecompileSlangSession;
+    /// Number of background compiles in flight per Slang global session (including retired ones).
+    mutable std::map<slang::IGlobalSession*, uint32_t> mPrecompileInFlightCounts;
+    std::unique_ptr<ProgramVariantCache> mpVariantCache;
+    BS::thread_pool mPrecompileThreadPool{1};
 };
 
 } // namespace Falcor
@@ -0,0 +1,470 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ProgramVariantCache.h"
+#include "Core/Error.h"
+#include "Core/Platform/OS.h"
+#include "Utils/CryptoUtils.h"
+#include "Utils/Logger.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+const char kManifestFilename[] = "program_variants.json";
+const uint32_t kManifestVersion = 1;
+const std::chrono::seconds kManifestWriteInterval{5};
+
+void updateString(SHA1& sha1, std::string_view str)
+{
+    // Prefix with the length to avoid ambiguities between concatenated strings.
+    sha1.update(uint64_t(str.size()));
+    sha1.update(str);
+}
+
+std::string hashString(std::string_view str)
+{
+    return SHA1::toString(SHA1::compute(str.data(), str.size()));
+}
+
+std::string hashFileContent(const std::filesystem::path& path)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+        return {};
+    SHA1 sha1;
+    char buffer[64 * 1024];
+    while (stream)
+    {
+        stream.read(buffer, sizeof(buffer));
+        sha1.update(buffer, size_t(stream.gcount()));
+    }
+    return SHA1::toString(sha1.finalize());
+}
+} // namespace
+
+ProgramVariantCache::ProgramVariantCache(std::filesystem::path directory, size_t maxMemoryEntryCount)
+    : mMaxMemoryEntryCount(maxMemoryEntryCount), mLastSaveTime(std::chrono::steady_clock::now())
+{
+    if (!directory.empty())
+    {
+        mManifestPath = directory / kManifestFilename;
+        load();
+    }
+}
+
+ProgramVariantCache::~ProgramVariantCache()
+{
+    flush();
+}
+
+std::string ProgramVariantCache::computeKey(const ProgramDesc& desc, const DefineList& defines, const std::vector<std::string>& extraArguments)
+{
+    SHA1 sha1;
+
+    sha1.update(uint32_t(desc.shaderModules.size()));
+    for (const auto& module : desc.shaderModules)
+    {
+        updateString(sha1, module.name);
+        sha1.update(uint32_t(module.sources.size()));
+        for (const auto& source : module.sources)
+        {
+            sha1.update(uint32_t(source.type));
+            updateString(sha1, source.path.generic_string());
+            if (source.type == ProgramDesc::ShaderSource::Type::File)
+            {
+                // Files that cannot be found are keyed by path only, compilation will report the error.
+                std::filesystem::path fullPath;
+                if (findFileInShaderDirectories(source.path, fullPath))
+                    updateString(sha1, hashFileContent(fullPath));
+            }
+            else
+            {
+                updateString(sha1, source.string);
+            }
+        }
+    }
+
+    auto updateTypeConformances = [&](const TypeConformanceList& typeConformances)
+    {
+        sha1.update(uint32_t(typeConformances.size()));
+        for (const auto& [conformance, id] : typeConformances)
+        {
+            updateString(sha1, conformance.typeName);
+            updateString(sha1, conformance.interfaceName);
+            sha1.update(id);
+        }
+    };
+
+    sha1.update(uint32_t(desc.entryPointGroups.size()));
+    for (const auto& group : desc.entryPointGroups)
+    {
+        sha1.update(group.shaderModuleIndex);
+        updateTypeConformances(group.typeConformances);
+        sha1.update(uint32_t(group.entryPoints.size()));
+        for (const auto& entryPoint : group.entryPoints)
+        {
+            sha1.update(uint32_t(entryPoint.type));
+            updateString(sha1, entryPoint.name);
+            updateString(sha1, entryPoint.exportName);
+            sha1.update(entryPoint.globalIndex);
+        }
+    }
+    updateTypeConformances(desc.typeConformances);
+
+    sha1.update(uint32_t(desc.shaderModel));
+    sha1.update(uint32_t(desc.compilerFlags));
+    sha1.update(uint32_t(desc.compilerArguments.size()));
+    for (const auto& arg : desc.compilerArguments)
+        updateString(sha1, arg);
+    sha1.update(desc.maxTraceRecursionDepth);
+    sha1.update(desc.maxPayloadSize);
+    sha1.update(desc.maxAttributeSize);
+    sha1.update(uint32_t(desc.rtPipelineFlags));
+    sha1.update(desc.useSPIRVBackend);
+
+    // DefineList is an ordered map, so the key does not depend on the order defines were added in.
+    sha1.update(uint32_t(defines.size()));
+    for (const auto& [name, value] : defines)
+    {
+        updateString(sha1, name);
+        updateString(sha1, value);
+    }
+
+    sha1.update(uint32_t(extraArguments.size()));
+    for (const auto& arg : extraArguments)
+        updateString(sha1, arg);
+
+    return SHA1::toString(sha1.finalize());
+}
+
+std::string ProgramVariantCache::getDescription(const ProgramDesc& desc)
+{
+    std::string str;
+
+    for (const auto& module : desc.shaderModules)
+    {
+        for (const auto& source : module.sources)
+        {
+            if (source.type == ProgramDesc::ShaderSource::Type::File)
+                str += source.path.generic_string();
+            else
+                str += "<string:" + hashString(source.string).substr(0, 8) + ">";
+            str += " ";
+        }
+    }
+
+    str += "(";
+    size_t entryPointIndex = 0;
+    for (const auto& group : desc.entryPointGroups)
+    {
+        for (const auto& entryPoint : group.entryPoints)
+        {
+            if (entryPointIndex++ > 0)
+                str += ", ";
+            str += entryPoint.exportName;
+        }
+    }
+    str += ")";
+
+    return str;
+}
+
+std::vector<DefineList> ProgramVariantCache::expandDefineMatrix(
+    const DefineList& base,
+    const std::map<std::string, std::vector<std::string>>& axes
+)
+{
+    std::vector<DefineList> variants = {base};
+    for (const auto& [name, values] : axes)
+    {
+        FALCOR_CHECK(!values.empty(), "Define matrix axis '{}' has no values.", name);
+        std::vector<DefineList> expanded;
+        expanded.reserve(variants.size() * values.size());
+        for (const auto& variant : variants)
+        {
+            for (const auto& value : values)
+            {
+                DefineList defines = variant;
+                defines[name] = value;
+                expanded.push_back(std::move(defines));
+            }
+        }
+        variants = std::move(expanded);
+    }
+    return variants;
+}
+
+ProgramVariantCache::LookupResult ProgramVariantCache::lookup(const std::string& key, Artifacts* pArtifacts)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto entryIt = mEntries.find(key);
+    if (entryIt == mEntries.end())
+    {
+        mStats.missCount++;
+        return LookupResult::Miss;
+    }
+
+    if (!isValid(entryIt->second))
+    {
+        mEntries.erase(entryIt);
+        mManifestDirty = true;
+        if (mArtifacts.erase(key) > 0)
+            mArtifactOrder.erase(std::find(mArtifactOrder.begin(), mArtifactOrder.end(), key));
+        mStats.staleCount++;
+        return LookupResult::Stale;
+    }
+
+    entryIt->second.useCount++;
+
+    auto artifactIt = mArtifacts.find(key);
+    if (artifactIt == mArtifacts.end())
+    {
+        mStats.diskHitCount++;
+        return LookupResult::DiskHit;
+    }
+
+    if (pArtifacts)
+        *pArtifacts = artifactIt->second;
+    mStats.memoryHitCount++;
+    return LookupResult::MemoryHit;
+}
+
+bool ProgramVariantCache::hasArtifacts(const std::string& key) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mArtifacts.find(key) != mArtifacts.end();
+}
+
+void ProgramVariantCache::insert(const std::string& key, const ProgramDesc& desc, const DefineList& defines, Artifacts artifacts, bool precompiled)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    Entry entry;
+    entry.key = key;
+    entry.description = getDescription(desc);
+    entry.defines = defines;
+    for (const auto& path : artifacts.dependencies)
+        entry.dependencies[path] = hashFile(path);
+
+    bool changed = true;
+    if (auto it = mEntries.find(key); it != mEntries.end())
+    {
+        changed = it->second.dependencies != entry.dependencies;
+        entry.useCount = it->second.useCount;
+    }
+    if (!precompiled)
+        entry.useCount = std::max<uint64_t>(entry.useCount, 1);
+    mEntries[key] = std::move(entry);
+
+    if (mArtifacts.find(key) == mArtifacts.end())
+    {
+        mArtifactOrder.push_back(key);
+        while (mArtifactOrder.size() > mMaxMemoryEntryCount)
+        {
+            mArtifacts.erase(mArtifactOrder.front());
+            mArtifactOrder.pop_front();
+        }
+    }
+    mArtifacts[key] = std::move(artifacts);
+
+    if (precompiled)
+        mStats.precompiledCount++;
+
+    // Inserting many variants in a row (e.g. when precompiling) must not rewrite the manifest every time.
+    mManifestDirty |= changed;
+    if (mManifestDirty && std::chrono::steady_clock::now() - mLastSaveTime >= kManifestWriteInterval)
+        flushLocked();
+}
+
+std::vector<ProgramVariantCache::Entry> ProgramVariantCache::getEntries(const std::string& description) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    std::vector<Entry> entries;
+    for (const auto& [key, entry] : mEntries)
+    {
+        if (description.empty() || entry.description == description)
+            entries.push_back(entry);
+    }
+    return entries;
+}
+
+void ProgramVariantCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    mEntries.clear();
+    mArtifacts.clear();
+    mArtifactOrder.clear();
+    flushLocked();
+}
+
+bool ProgramVariantCache::load()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mManifestPath.empty() || !std::filesystem::exists(mManifestPath))
+        return false;
+
+    try
+    {
+        std::ifstream stream(mManifestPath);
+        nlohmann::json manifest = nlohmann::json::parse(stream);
+        if (manifest.value("version", 0u) != kManifestVersion)
+        {
+            logWarning("Ignoring program variant manifest '{}' with unsupported version.", mManifestPath);
+            return false;
+        }
+
+        std::map<std::string, Entry> entries;
+        for (const auto& jsonEntry : manifest.at("variants"))
+        {
+            Entry entry;
+            entry.key = jsonEntry.at("key").get<std::string>();
+            entry.description = jsonEntry.at("description").get<std::string>();
+            for (const auto& [name, value] : jsonEntry.at("defines").items())
+                entry.defines[name] = value.get<std::string>();
+            for (const auto& [path, hash] : jsonEntry.at("dependencies").items())
+                entry.dependencies[path] = hash.get<std::string>();
+            entry.useCount = jsonEntry.value("useCount", uint64_t(0));
+            entries[entry.key] = std::move(entry);
+        }
+        mEntries = std::move(entries);
+    }
+    catch (const std::exception& e)
+    {
+        logWarning("Failed to load program variant manifest '{}': {}", mManifestPath, e.what());
+        return false;
+    }
+
+    return true;
+}
+
+void ProgramVariantCache::save() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    saveLocked();
+}
+
+void ProgramVariantCache::flush()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mManifestDirty)
+        flushLocked();
+}
+
+ProgramVariantCache::Stats ProgramVariantCache::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
+
+void ProgramVariantCache::resetStats()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStats = {};
+}
+
+std::string ProgramVariantCache::hashFile(const std::filesystem::path& path)
+{
+    // Hashes are cached by modification time, so unchanged files are only read once.
+    const std::string pathStr = path.string();
+    const time_t modifiedTime = std::filesystem::exists(path) ? getFileModifiedTime(path) : 0;
+    auto it = mFileHashes.find(pathStr);
+    if (it == mFileHashes.end() || it->second.modifiedTime != modifiedTime)
+        it = mFileHashes.insert_or_assign(pathStr, FileHash{modifiedTime, hashFileContent(path)}).first;
+    return it->second.hash;
+}
+
+bool ProgramVariantCache::isValid(const Entry& entry)
+{
+    for (const auto& [path, hash] : entry.dependencies)
+    {
+        if (hashFile(path) != hash)
+            return false;
+    }
+    return true;
+}
+
+void ProgramVariantCache::flushLocked()
+{
+    saveLocked();
+    mManifestDirty = false;
+    mLastSaveTime = std::chrono::steady_clock::now();
+}
+
+void ProgramVariantCache::saveLocked() const
+{
+    if (mManifestPath.empty())
+        return;
+
+    nlohmann::json variants = nlohmann::json::array();
+    for (const auto& [key, entry] : mEntries)
+    {
+        nlohmann::json jsonEntry;
+        jsonEntry["key"] = entry.key;
+        jsonEntry["description"] = entry.description;
+        jsonEntry["defines"] = nlohmann::json::object();
+        for (const auto& [name, value] : entry.defines)
+            jsonEntry["defines"][name] = value;
+        jsonEntry["dependencies"] = nlohmann::json::object();
+        for (const auto& [path, hash] : entry.dependencies)
+            jsonEntry["dependencies"][path] = hash;
+        jsonEntry["useCount"] = entry.useCount;
+        variants.push_back(std::move(jsonEntry));
+    }
+
+    nlohmann::json manifest;
+    manifest["version"] = kManifestVersion;
+    manifest["variants"] = std::move(variants);
+
+    // Write to a temporary file first so that a crash never leaves a truncated manifest behind.
+    std::error_code ec;
+    std::filesystem::create_directories(mManifestPath.parent_path(), ec);
+    std::filesystem::path tempPath = mManifestPath;
+    tempPath += ".tmp";
+    {
+        std::ofstream stream(tempPath, std::ios::trunc);
+        if (!stream)
+        {
+            logWarning("Failed to write program variant manifest '{}'.", mManifestPath);
+            return;
+        }
+        stream << manifest.dump(1);
+    }
+    std::filesystem::rename(tempPath, mManifestPath, ec);
+    if (ec)
+        logWarning("Failed to write program variant manifest '{}': {}", mManifestPath, ec.message());
+}
+} // namespace Falcor
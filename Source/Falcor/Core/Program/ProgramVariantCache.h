@@ -0,0 +1,211 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Program.h"
+#include "DefineList.h"
+#include "Core/Macros.h"
+
+#include <slang.h>
+
+#include <chrono>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Cache of compiled program variants.
+ *
+ * A program variant is identified by a content hash over the program description, the contents of its shader
+ * source files, its define list and any additional compiler state (global defines, compiler arguments, etc.).
+ *
+ * The cache stores two kinds of information:
+ * - A persistent manifest of known variants, stored as JSON in the cache directory. Each entry records the
+ *   variant's defines and the content hashes of all source files it depends on. This allows enumerating and
+ *   precompiling the variants used in previous runs. The compiled kernels themselves are persisted by the
+ *   GFX shader cache, which lives in the same directory.
+ * - An in-memory store of Slang front-end compilation results. It lets variants that were already compiled
+ *   (or precompiled in the background) during this run skip Slang compilation entirely.
+ *
+ * All methods are thread-safe.
+ */
+class FALCOR_API ProgramVariantCache
+{
+public:
+    /// Result of a cache lookup.
+    enum class LookupResult
+    {
+        Miss,      ///< Variant is unknown.
+        Stale,     ///< Variant is known but one of its source files has changed.
+        DiskHit,   ///< Variant is known from a previous run, its kernels are likely in the shader cache.
+        MemoryHit, ///< Variant was compiled during this run, compilation artifacts are available.
+    };
+
+    /// Slang front-end compilation artifacts of a program variant.
+    struct Artifacts
+    {
+        Slang::ComPtr<slang::IComponentType> pSlangGlobalScope;
+        std::vector<Slang::ComPtr<slang::IComponentType>> pSlangEntryPoints;
+        std::vector<std::string> dependencies; ///< Paths of all source files the variant depends on.
+    };
+
+    /// Persistent information about a known program variant.
+    struct Entry
+    {
+        std::string key;                                 ///< Variant key (see computeKey()).
+        std::string description;                         ///< Program description (see getDescription()).
+        DefineList defines;                              ///< Program defines, excluding global defines.
+        std::map<std::string, std::string> dependencies; ///< Source file path to content hash.
+        uint64_t useCount = 0;                           ///< Number of times the variant was requested.
+    };
+
+    struct Stats
+    {
+        uint64_t memoryHitCount = 0;
+        uint64_t diskHitCount = 0;
+        uint64_t missCount = 0;
+        uint64_t staleCount = 0;
+        uint64_t precompiledCount = 0;
+    };
+
+    /**
+     * Create a program variant cache.
+     * @param[in] directory Directory to store the manifest in. If empty, the manifest is not persisted.
+     * @param[in] maxMemoryEntryCount Maximum number of variants to keep compilation artifacts for.
+     */
+    ProgramVariantCache(std::filesystem::path directory, size_t maxMemoryEntryCount = 128);
+
+    /// Destructor. Writes pending manifest changes to disk.
+    ~ProgramVariantCache();
+
+    /**
+     * Compute the key identifying a program variant.
+     * The key is independent of the order in which defines were added. Shader source files are hashed by content,
+     * so touching a file without changing it does not change the key.
+     * @param[in] desc Program description. Entry points are expected to be finalized.
+     * @param[in] defines Program defines.
+     * @param[in] extraArguments Additional compiler state affecting the compilation result.
+     * @return Returns the key as a 40-character hexadecimal string.
+     */
+    static std::string computeKey(const ProgramDesc& desc, const DefineList& defines, const std::vector<std::string>& extraArguments = {});
+
+    /**
+     * Get a short description of a program, used to group variants of the same program.
+     * This includes the shader modules and entry points, but not the defines.
+     */
+    static std::string getDescription(const ProgramDesc& desc);
+
+    /**
+     * Expand a define matrix into a list of define lists.
+     * @param[in] base Defines shared by all variants.
+     * @param[in] axes List of defines with all values they can take. Each combination results in one variant.
+     * @return Returns the cartesian product of all axes, each combined with the base defines.
+     */
+    static std::vector<DefineList> expandDefineMatrix(const DefineList& base, const std::map<std::string, std::vector<std::string>>& axes);
+
+    /**
+     * Look up a program variant.
+     * Known variants are validated against the current content of their source files.
+     * Stale variants are removed from the cache.
+     * @param[in] key Variant key.
+     * @param[out] pArtifacts Compilation artifacts, only written on a memory hit.
+     * @return Returns the lookup result.
+     */
+    LookupResult lookup(const std::string& key, Artifacts* pArtifacts = nullptr);
+
+    /**
+     * Check if compilation artifacts of a variant are available, without updating the statistics.
+     */
+    bool hasArtifacts(const std::string& key) const;
+
+    /**
+     * Insert a compiled program variant.
+     * If the variant was not known yet or its dependencies changed, the manifest is marked as modified.
+     * Modified manifests are written at most once every few seconds, see flush() to write them immediately.
+     * @param[in] key Variant key.
+     * @param[in] desc Program description.
+     * @param[in] defines Program defines.
+     * @param[in] artifacts Compilation artifacts.
+     * @param[in] precompiled True if the variant was compiled ahead of its first use.
+     */
+    void insert(const std::string& key, const ProgramDesc& desc, const DefineList& defines, Artifacts artifacts, bool precompiled = false);
+
+    /**
+     * Get all known variants of a program.
+     * @param[in] description Program description (see getDescription()). If empty, all variants are returned.
+     */
+    std::vector<Entry> getEntries(const std::string& description = {}) const;
+
+    /// Remove all variants from the cache and the manifest.
+    void clear();
+
+    /// Load the manifest from disk. Returns false if no valid manifest exists.
+    bool load();
+
+    /// Write the manifest to disk.
+    void save() const;
+
+    /// Write the manifest to disk if it was modified since it was last written.
+    void flush();
+
+    /// Get the path of the manifest file.
+    const std::filesystem::path& getManifestPath() const { return mManifestPath; }
+
+    Stats getStats() const;
+    void resetStats();
+
+private:
+    std::string hashFile(const std::filesystem::path& path);
+    bool isValid(const Entry& entry);
+    void saveLocked() const;
+    void flushLocked();
+
+    struct FileHash
+    {
+        time_t modifiedTime;
+        std::string hash;
+    };
+
+    std::filesystem::path mManifestPath;
+    size_t mMaxMemoryEntryCount;
+
+    mutable std::mutex mMutex;
+    std::map<std::string, Entry> mEntries;
+    std::map<std::string, Artifacts> mArtifacts;
+    std::deque<std::string> mArtifactOrder; ///< Keys of variants with artifacts, oldest first.
+    std::map<std::string, FileHash> mFileHashes;
+    bool mManifestDirty = false;
+    std::chrono::steady_clock::time_point mLastSaveTime;
+    Stats mStats;
+};
+} // namespace Falcor
@@ -35,6 +35,7 @@
 #include "Utils/Algorithm/DirectedGraphTraversal.h"
 #include "Utils/Scripting/Scripting.h"
 #include "Utils/Scripting/ScriptBindings.h"
+#include "Utils/Timing/CpuTimer.h"
 
 namespace Falcor
 {
@@ -139,7 +140,7 @@ uint32_t RenderGraph::addPass(const ref<RenderPass>& pPass, const std::string& p
     uint32_t passIndex = mpGraph->addNode();
     mNameToIndex[passName] = passIndex;
 
-    pPass->mPassChangedCB = [this]() { mRecompile = true; };
+    pPass->mPassChangedCB = [this, passIndex]() { mDirtyPasses.insert(passIndex); };
     pPass->mName = passName;
 
     if (mpScene)
@@ -187,7 +188,7 @@ void RenderGraph::updatePass(const std::string& passName, const Properties& prop
     std::string passTypeName = pOldPass->getType();
     auto pPass = RenderPass::create(passTypeName, mpDevice, props);
     pPassIt->second.pPass = pPass;
-    pPass->mPassChangedCB = [this]() { mRecompile = true; };
+    pPass->mPassChangedCB = [this, index]() { mDirtyPasses.insert(index); };
     pPass->mName = pOldPass->getName();
 
     if (mpScene)
@@ -423,21 +424,82 @@ std::vector<std::string> RenderGraph::getUnmarkedOutputs() const
 
 bool RenderGraph::compile(RenderContext* pRenderContext, std::string& log)
 {
-    if (!mRecompile)
+    if (!isRecompileNeeded())
         return true;
-    mpExe = nullptr;
+
+    auto startTime = CpuTimer::getCurrentTimePoint();
+    RenderGraphCompiler::Stats stats;
 
     try
     {
-        mpExe = RenderGraphCompiler::compile(*this, pRenderContext, mCompilerDeps);
+        // If only passes requested a recompile, try to recompile them in place. Otherwise compile the graph while reusing
+        // the state of the previous compilation for everything that didn't change.
+        bool recompiled = !mRecompile && mpExe && RenderGraphCompiler::recompilePasses(pRenderContext, *mpExe, mDirtyPasses, &stats);
+        if (!recompiled)
+        {
+            const RenderGraphExe* pPrevious = mRecompile ? nullptr : mpExe.get();
+            if (!pPrevious)
+                mpExe = nullptr;
+            auto pExe = RenderGraphCompiler::compile(*this, pRenderContext, mCompilerDeps, &stats, pPrevious, mDirtyPasses);
+            mpExe = std::move(pExe);
+        }
         mRecompile = false;
-        return true;
+        mDirtyPasses.clear();
     }
     catch (const std::exception& e)
     {
+        mpExe = nullptr;
         log = e.what();
         return false;
     }
+
+    stats.timeMs = CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+    mCompileStats = stats;
+    logInfo(
+        "Compiled render graph '{}' in {:.2f} ms ({}, {}/{} passes compiled, {} resources allocated, {} reused).",
+        mName,
+        stats.timeMs,
+        stats.incremental ? "incremental" : "full",
+        stats.compiledPassCount,
+        stats.passCount,
+        stats.allocatedResourceCount,
+        stats.reusedResourceCount
+    );
+    return true;
+}
+
+void RenderGraph::setResourceAliasingEnabled(bool enabled)
+{
+    if (mCompilerDeps.enableResourceAliasing == enabled)
+        return;
+    mCompilerDeps.enableResourceAliasing = enabled;
+    mRecompile = true;
+}
+
+const RenderGraphMemoryReport& RenderGraph::getMemoryReport() const
+{
+    FALCOR_CHECK(mpExe && !isRecompileNeeded(), "Can't get the memory report. The graph wasn't successfully compiled yet.");
+    return mpExe->getMemoryReport();
+}
+
+RenderGraphScheduler::Schedule RenderGraph::getSchedule(uint32_t queueCount, const std::map<std::string, double>& passTimes) const
+{
+    FALCOR_CHECK(mpExe && !isRecompileNeeded(), "Can't compute the schedule. The graph wasn't successfully compiled yet.");
+    auto names = mpExe->getPassNames();
+    std::vector<double> times(names.size(), 1.0);
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        auto it = passTimes.find(names[i]);
+        if (it != passTimes.end())
+            times[i] = it->second;
+    }
+    return mpExe->computeSchedule(queueCount, times);
+}
+
+std::vector<std::string> RenderGraph::getPassNames() const
+{
+    FALCOR_CHECK(mpExe && !isRecompileNeeded(), "Can't get the pass names. The graph wasn't successfully compiled yet.");
+    return mpExe->getPassNames();
 }
 
 void RenderGraph::execute(RenderContext* pRenderContext)
@@ -610,7 +672,7 @@ bool RenderGraph::isGraphOutput(const std::string& name) const
 
 ref<Resource> RenderGraph::getOutput(const std::string& name)
 {
-    if (mRecompile)
+    if (isRecompileNeeded())
         FALCOR_THROW("Can't fetch the output '{}'. The graph wasn't successfuly compiled yet.", name);
 
     str_pair strPair;
@@ -731,9 +793,80 @@ FALCOR_SCRIPT_BINDING(RenderGraph)
     renderPass.def("getDictionary", [](RenderPass& pass) { return pass.getProperties().toPython(); });
     // PYTHONDEPRECATED END
 
+    // RenderGraphMemoryReport
+    pybind11::class_<RenderGraphMemoryReport> memoryReport(m, "RenderGraphMemoryReport");
+    memoryReport.def_property_readonly("peak_bytes_before_aliasing", &RenderGraphMemoryReport::getPeakBytesBeforeAliasing);
+    memoryReport.def_property_readonly("peak_bytes_after_aliasing", &RenderGraphMemoryReport::getPeakBytesAfterAliasing);
+    memoryReport.def_property_readonly("min_peak_bytes", &RenderGraphMemoryReport::getMinPeakBytes);
+    memoryReport.def_property_readonly(
+        "resources",
+        [](const RenderGraphMemoryReport& self)
+        {
+            pybind11::list resources;
+            for (const auto& r : self.getResources())
+            {
+                pybind11::dict d;
+                d["name"] = r.name;
+                d["aliases"] = r.aliases;
+                d["type"] = to_string(r.type);
+                d["format"] = r.format;
+                d["width"] = r.width;
+                d["height"] = r.height;
+                d["depth"] = r.depth;
+                d["mip_count"] = r.mipCount;
+                d["array_size"] = r.arraySize;
+                d["sample_count"] = r.sampleCount;
+                d["size_in_bytes"] = r.sizeInBytes;
+                d["first_pass"] = r.firstPass;
+                d["last_pass"] = r.lastPass;
+                d["graph_output"] = r.graphOutput;
+                d["persistent"] = r.persistent;
+                d["alias_slot"] = r.aliasSlot;
+                resources.append(d);
+            }
+            return resources;
+        }
+    );
+    memoryReport.def_property_readonly(
+        "passes",
+        [](const RenderGraphMemoryReport& self)
+        {
+            pybind11::list passes;
+            for (const auto& p : self.getPasses())
+            {
+                pybind11::dict d;
+                d["name"] = p.name;
+                d["bytes_read"] = p.bytesRead;
+                d["bytes_written"] = p.bytesWritten;
+                d["bytes_alive"] = p.bytesAlive;
+                passes.append(d);
+            }
+            return passes;
+        }
+    );
+    memoryReport.def("to_table", &RenderGraphMemoryReport::toTable);
+    memoryReport.def("to_json", &RenderGraphMemoryReport::toJson);
+    memoryReport.def("__repr__", &RenderGraphMemoryReport::toTable);
+
     // RenderGraph
     pybind11::class_<RenderGraph, ref<RenderGraph>> renderGraph(m, "RenderGraph");
     renderGraph.def_property("name", &RenderGraph::getName, &RenderGraph::setName);
+    renderGraph.def_property("resource_aliasing", &RenderGraph::isResourceAliasingEnabled, &RenderGraph::setResourceAliasingEnabled);
+    renderGraph.def_property_readonly(
+        "compile_stats",
+        [](const RenderGraph& graph)
+        {
+            const auto& stats = graph.getCompileStats();
+            pybind11::dict d;
+            d["incremental"] = stats.incremental;
+            d["pass_count"] = stats.passCount;
+            d["compiled_pass_count"] = stats.compiledPassCount;
+            d["allocated_resource_count"] = stats.allocatedResourceCount;
+            d["reused_resource_count"] = stats.reusedResourceCount;
+            d["time_ms"] = stats.timeMs;
+            return d;
+        }
+    );
 
     renderGraph.def(
         "create_pass",
@@ -759,6 +892,60 @@ FALCOR_SCRIPT_BINDING(RenderGraph)
     renderGraph.def("get_pass", &RenderGraph::getPass, "name"_a);
     renderGraph.def("__getitem__", [](RenderGraph& self, const std::string& name) { return self.getPass(name); });
     renderGraph.def("get_output", pybind11::overload_cast<const std::string&>(&RenderGraph::getOutput), "name"_a);
+    renderGraph.def(
+        "get_memory_report",
+        [](RenderGraph& graph)
+        {
+            std::string log;
+            if (!graph.compile(graph.getDevice()->getRenderContext(), log))
+                FALCOR_THROW("Failed to compile render graph:\n{}", log);
+            return graph.getMemoryReport();
+        }
+    );
+    renderGraph.def(
+        "get_schedule",
+        [](RenderGraph& graph, uint32_t queue_count, const std::map<std::string, double>& pass_times)
+        {
+            std::string log;
+            if (!graph.compile(graph.getDevice()->getRenderContext(), log))
+                FALCOR_THROW("Failed to compile render graph:\n{}", log);
+
+            auto schedule = graph.getSchedule(queue_count, pass_times);
+            auto names = graph.getPassNames();
+
+            pybind11::dict passes;
+            for (size_t i = 0; i < names.size(); i++)
+            {
+                pybind11::dict d;
+                d["queue"] = schedule.passes[i].queue;
+                d["start"] = schedule.passes[i].start;
+                d["end"] = schedule.passes[i].end;
+                passes[names[i].c_str()] = d;
+            }
+            pybind11::list queues;
+            for (const auto& queue : schedule.queues)
+            {
+                pybind11::list l;
+                for (uint32_t p : queue)
+                    l.append(names[p]);
+                queues.append(l);
+            }
+            pybind11::list barriers;
+            for (const auto& b : schedule.barriers)
+                barriers.append(pybind11::make_tuple(names[b.srcPass], names[b.dstPass]));
+
+            pybind11::dict d;
+            d["passes"] = passes;
+            d["queues"] = queues;
+            d["barriers"] = barriers;
+            d["makespan"] = schedule.makespan;
+            d["serial_time"] = schedule.serialTime;
+            d["text"] = schedule.toString(names);
+            return d;
+        },
+        "queue_count"_a = 2,
+        "pass_times"_a = std::map<std::string, double>()
+    );
 
     // PYTHONDEPRECATED BEGIN
     renderGraph.def(
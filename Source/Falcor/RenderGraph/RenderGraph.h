@@ -37,7 +37,9 @@
 #include "Utils/Algorithm/DirectedGraph.h"
 #include "Scene/Scene.h"
 #include <filesystem>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -311,6 +313,45 @@ public:
         return compile(pRenderContext, s);
     }
 
+    /**
+     * Enable/disable aliasing of transient resources.
+     * If enabled, resources with disjoint lifetimes and identical descs share the same allocation.
+     * Passes that rely on the content of a non-internal output to persist across frames must mark it as persistent.
+     */
+    void setResourceAliasingEnabled(bool enabled);
+
+    /**
+     * Check if aliasing of transient resources is enabled.
+     */
+    bool isResourceAliasingEnabled() const { return mCompilerDeps.enableResourceAliasing; }
+
+    /**
+     * Get the memory and bandwidth report of the compiled graph.
+     * Throws an exception if the graph is not compiled.
+     */
+    const RenderGraphMemoryReport& getMemoryReport() const;
+
+    /**
+     * Schedule the passes of the compiled graph onto multiple queues, running independent branches concurrently.
+     * Execution itself is still serial on the render context. The schedule is used to predict the speedup from recorded pass times.
+     * Throws an exception if the graph is not compiled.
+     * @param[in] queueCount Number of queues.
+     * @param[in] passTimes Execution time of passes, by pass name. Passes without a time are assumed to take 1.0.
+     * @return The schedule. Pass indices refer to getPassNames().
+     */
+    RenderGraphScheduler::Schedule getSchedule(uint32_t queueCount, const std::map<std::string, double>& passTimes = {}) const;
+
+    /**
+     * Get the names of the passes of the compiled graph in execution order, including passes inserted by the compiler.
+     * Throws an exception if the graph is not compiled.
+     */
+    std::vector<std::string> getPassNames() const;
+
+    /**
+     * Get the statistics of the last successful compilation.
+     */
+    const RenderGraphCompiler::Stats& getCompileStats() const { return mCompileStats; }
+
 private:
     struct EdgeData
     {
@@ -362,6 +403,7 @@ private:
     );
 
     bool isGraphOutput(const GraphOut& graphOut) const;
+    bool isRecompileNeeded() const { return mRecompile || !mDirtyPasses.empty(); }
 
     ref<Device> mpDevice;
 
@@ -378,6 +420,8 @@ private:
     std::unique_ptr<RenderGraphExe> mpExe;           ///< Helper for allocating resources and executing the graph.
     RenderGraphCompiler::Dependencies mCompilerDeps; ///< Data needed by the graph compiler.
     bool mRecompile = false; ///< Set to true to trigger a recompilation after any graph changes (topology/scene/size/passes/etc.)
+    std::set<uint32_t> mDirtyPasses;          ///< Node IDs of passes that requested a recompile. These can be recompiled incrementally.
+    RenderGraphCompiler::Stats mCompileStats; ///< Statistics of the last successful compilation.
 
     friend class RenderGraphUI;
     friend class RenderGraphExporter;
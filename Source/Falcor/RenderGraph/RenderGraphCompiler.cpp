@@ -31,6 +31,10 @@
 #include "Core/Error.h"
 #include "Utils/Algorithm/DirectedGraphTraversal.h"
 #include "Utils/StringUtils.h"
+#include <algorithm>
+#include <map>
+#include <set>
+#include <unordered_map>
 
 namespace Falcor
 {
@@ -49,10 +53,15 @@ RenderGraphCompiler::RenderGraphCompiler(RenderGraph& graph, const Dependencies&
 std::unique_ptr<RenderGraphExe> RenderGraphCompiler::compile(
     RenderGraph& graph,
     RenderContext* pRenderContext,
-    const Dependencies& dependencies
+    const Dependencies& dependencies,
+    Stats* pStats,
+    const RenderGraphExe* pPrevious,
+    const std::set<uint32_t>& dirtyPasses
 )
 {
     RenderGraphCompiler c = RenderGraphCompiler(graph, dependencies);
+    c.mpPrevious = pPrevious;
+    c.mpDirtyPasses = &dirtyPasses;
 
     // Register the external resources
     auto pResourcesCache = std::make_unique<ResourceCache>();
@@ -64,20 +73,77 @@ std::unique_ptr<RenderGraphExe> RenderGraphCompiler::compile(
     if (c.insertAutoPasses())
         c.resolveExecutionOrder();
     c.validateGraph();
-    c.allocateResources(pRenderContext->getDevice(), pResourcesCache.get());
+    auto allocationStats = c.allocateResources(pRenderContext->getDevice(), pResourcesCache.get());
 
     auto pExe = std::make_unique<RenderGraphExe>();
     pExe->mExecutionList.reserve(c.mExecutionList.size());
+    pExe->mCompiledPasses.reserve(c.mExecutionList.size());
 
+    std::vector<RenderGraphMemoryReport::PassDesc> reportPasses;
+    reportPasses.reserve(c.mExecutionList.size());
     for (auto e : c.mExecutionList)
     {
         pExe->insertPass(e.name, e.pPass);
+        pExe->mCompiledPasses.push_back({e.index, e.pPass, e.reflector, c.prepPassCompilationData(e)});
+        reportPasses.push_back({e.name, e.reflector});
     }
+    pExe->mMemoryReport = RenderGraphMemoryReport::generate(reportPasses, *pResourcesCache, dependencies.defaultResourceProps);
+    pExe->mDependencyGraph = c.buildDependencyGraph(pExe->mMemoryReport);
     c.restoreCompilationChanges();
     pExe->mpResourceCache = std::move(pResourcesCache);
+
+    if (pStats)
+    {
+        pStats->incremental = pPrevious != nullptr;
+        pStats->passCount = (uint32_t)c.mExecutionList.size();
+        pStats->compiledPassCount = c.mCompiledPassCount;
+        pStats->allocatedResourceCount = allocationStats.allocatedCount;
+        pStats->reusedResourceCount = allocationStats.reusedCount;
+    }
     return pExe;
 }
 
+bool RenderGraphCompiler::recompilePasses(
+    RenderContext* pRenderContext,
+    RenderGraphExe& exe,
+    const std::set<uint32_t>& dirtyPasses,
+    Stats* pStats
+)
+{
+    // Check that the I/O of all dirty passes is unchanged before recompiling any of them.
+    std::vector<const RenderGraphExe::CompiledPass*> passes;
+    for (const auto& p : exe.mCompiledPasses)
+    {
+        if (dirtyPasses.count(p.nodeIndex) == 0)
+            continue;
+        if (p.pPass->reflect(p.compileData) != p.reflector)
+            return false;
+        passes.push_back(&p);
+    }
+
+    for (const auto* p : passes)
+    {
+        try
+        {
+            p->pPass->compile(pRenderContext, p->compileData);
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+    }
+
+    if (pStats)
+    {
+        pStats->incremental = true;
+        pStats->passCount = (uint32_t)exe.mCompiledPasses.size();
+        pStats->compiledPassCount = (uint32_t)passes.size();
+        pStats->allocatedResourceCount = 0;
+        pStats->reusedResourceCount = 0;
+    }
+    return true;
+}
+
 void RenderGraphCompiler::validateGraph() const
 {
     std::string err;
@@ -261,15 +327,8 @@ bool RenderGraphCompiler::insertAutoPasses()
     return addedPasses;
 }
 
-void RenderGraphCompiler::allocateResources(ref<Device> pDevice, ResourceCache* pResourceCache)
+ResourceCache::AllocationStats RenderGraphCompiler::allocateResources(ref<Device> pDevice, ResourceCache* pResourceCache)
 {
-    // Build list to look up execution order index from the pass
-    std::unordered_map<RenderPass*, uint32_t> passToIndex;
-    for (size_t i = 0; i < mExecutionList.size(); i++)
-    {
-        passToIndex.emplace(mExecutionList[i].pPass.get(), uint32_t(i));
-    }
-
     for (size_t i = 0; i < mExecutionList.size(); i++)
     {
         uint32_t nodeIndex = mExecutionList[i].index;
@@ -336,13 +395,109 @@ void RenderGraphCompiler::allocateResources(ref<Device> pDevice, ResourceCache*
             std::string srcFieldName = mGraph.mNodeData[pEdge->getSourceNode()].name + '.' + edgeData.srcField;
             std::string dstFieldName = mGraph.mNodeData[nodeIndex].name + '.' + dstField.getName();
 
-            const auto& pSrcPass = mGraph.mNodeData[pEdge->getSourceNode()].pPass.get();
-            const auto& srcReflection = mExecutionList[passToIndex.at(pSrcPass)].reflector;
-            pResourceCache->registerField(dstFieldName, dstField, passToIndex[pSrcPass], srcFieldName);
+            // The resource must stay alive until the consuming pass has executed.
+            pResourceCache->registerField(dstFieldName, dstField, uint32_t(i), srcFieldName);
+        }
+    }
+
+    const ResourceCache* pPreviousCache = mpPrevious ? mpPrevious->mpResourceCache.get() : nullptr;
+    return pResourceCache->allocateResources(
+        pDevice, mDependencies.defaultResourceProps, mDependencies.enableResourceAliasing, pPreviousCache
+    );
+}
+
+DirectedGraph RenderGraphCompiler::buildDependencyGraph(const RenderGraphMemoryReport& memoryReport) const
+{
+    DirectedGraph dependencies;
+    std::unordered_map<uint32_t, uint32_t> nodeToPass;
+    for (uint32_t i = 0; i < (uint32_t)mExecutionList.size(); i++)
+    {
+        dependencies.addNode();
+        nodeToPass[mExecutionList[i].index] = i;
+    }
+
+    std::set<std::pair<uint32_t, uint32_t>> added;
+    auto addDependency = [&](uint32_t src, uint32_t dst)
+    {
+        if (src != dst && added.insert({src, dst}).second)
+            dependencies.addEdge(src, dst);
+    };
+
+    for (uint32_t i = 0; i < (uint32_t)mExecutionList.size(); i++)
+    {
+        const auto& passData = mExecutionList[i];
+        const DirectedGraph::Node* pNode = mGraph.mpGraph->getNode(passData.index);
+        for (uint32_t e = 0; e < pNode->getIncomingEdgeCount(); e++)
+        {
+            uint32_t edgeIndex = pNode->getIncomingEdge(e);
+            const DirectedGraph::Edge* pEdge = mGraph.mpGraph->getEdge(edgeIndex);
+            auto srcIt = nodeToPass.find(pEdge->getSourceNode());
+            if (srcIt == nodeToPass.end())
+                continue;
+
+            // Data and execution edges.
+            addDependency(srcIt->second, i);
+
+            // A pass writing an input in place must wait for all other readers of the same resource that run before it.
+            const auto& edgeData = mGraph.mEdgeData.at(edgeIndex);
+            if (edgeData.dstField.empty())
+                continue;
+            const auto& dstField = *passData.reflector.getField(edgeData.dstField);
+            if (!is_set(dstField.getVisibility(), RenderPassReflection::Field::Visibility::Output))
+                continue;
+
+            const DirectedGraph::Node* pSrcNode = mGraph.mpGraph->getNode(pEdge->getSourceNode());
+            for (uint32_t o = 0; o < pSrcNode->getOutgoingEdgeCount(); o++)
+            {
+                uint32_t otherEdge = pSrcNode->getOutgoingEdge(o);
+                if (otherEdge == edgeIndex || mGraph.mEdgeData.at(otherEdge).srcField != edgeData.srcField)
+                    continue;
+                auto readerIt = nodeToPass.find(mGraph.mpGraph->getEdge(otherEdge)->getDestNode());
+                if (readerIt != nodeToPass.end() && readerIt->second < i)
+                    addDependency(readerIt->second, i);
+            }
+        }
+    }
+
+    // Resources sharing an aliased allocation must not overlap. The first user of a resource waits for every user of the
+    // resource that previously occupied the same slot, not only the last one, as earlier readers may otherwise be scheduled
+    // after the memory is overwritten.
+    if (mDependencies.enableResourceAliasing)
+    {
+        std::unordered_map<std::string, uint32_t> passByName;
+        for (uint32_t i = 0; i < (uint32_t)mExecutionList.size(); i++)
+            passByName[mExecutionList[i].name] = i;
+
+        const auto& resources = memoryReport.getResources();
+        std::map<uint32_t, std::vector<uint32_t>> slots;
+        for (uint32_t r = 0; r < (uint32_t)resources.size(); r++)
+            slots[resources[r].aliasSlot].push_back(r);
+
+        for (auto& [slot, members] : slots)
+        {
+            std::sort(
+                members.begin(),
+                members.end(),
+                [&](uint32_t a, uint32_t b) { return resources[a].firstPass < resources[b].firstPass; }
+            );
+            for (size_t m = 1; m < members.size(); m++)
+            {
+                const auto& prev = resources[members[m - 1]];
+                const auto& next = resources[members[m]];
+                if (prev.lastPass >= next.firstPass || next.firstPass >= mExecutionList.size())
+                    continue;
+                addDependency(prev.lastPass, next.firstPass);
+                for (const auto& alias : prev.aliases)
+                {
+                    auto it = passByName.find(alias.substr(0, alias.rfind('.')));
+                    if (it != passByName.end() && it->second < next.firstPass)
+                        addDependency(it->second, next.firstPass);
+                }
+            }
         }
     }
 
-    pResourceCache->allocateResources(pDevice, mDependencies.defaultResourceProps);
+    return dependencies;
 }
 
 void RenderGraphCompiler::restoreCompilationChanges()
@@ -356,6 +511,24 @@ void RenderGraphCompiler::restoreCompilationChanges()
     mCompilationChanges.removedEdges.clear();
 }
 
+bool RenderGraphCompiler::canSkipPassCompilation(const PassData& passData, const RenderPass::CompileData& compileData) const
+{
+    if (!mpPrevious || mpDirtyPasses->count(passData.index))
+        return false;
+
+    // A clean pass doesn't need to be recompiled if it sees exactly the same I/O as in the previous compilation.
+    for (const auto& p : mpPrevious->mCompiledPasses)
+    {
+        if (p.nodeIndex != passData.index)
+            continue;
+        return p.pPass == passData.pPass && p.reflector == passData.reflector &&
+               all(p.compileData.defaultTexDims == compileData.defaultTexDims) &&
+               p.compileData.defaultTexFormat == compileData.defaultTexFormat &&
+               p.compileData.connectedResources == compileData.connectedResources;
+    }
+    return false;
+}
+
 RenderPass::CompileData RenderGraphCompiler::prepPassCompilationData(const PassData& passData)
 {
     RenderPass::CompileData compileData;
@@ -450,7 +623,11 @@ void RenderGraphCompiler::compilePasses(RenderContext* pRenderContext)
         {
             try
             {
-                p.pPass->compile(pRenderContext, prepPassCompilationData(p));
+                auto compileData = prepPassCompilationData(p);
+                if (canSkipPassCompilation(p, compileData))
+                    continue;
+                p.pPass->compile(pRenderContext, compileData);
+                mCompiledPassCount++;
             }
             catch (const std::exception& e)
             {
@@ -31,6 +31,7 @@
 #include "ResourceCache.h"
 #include "RenderGraphExe.h"
 #include "Core/Macros.h"
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -46,8 +47,57 @@ public:
     {
         ResourceCache::DefaultProperties defaultResourceProps;
         ResourceCache::ResourcesMap externalResources;
+        bool enableResourceAliasing = false; ///< Share allocations between transient resources with disjoint lifetimes.
     };
-    static std::unique_ptr<RenderGraphExe> compile(RenderGraph& graph, RenderContext* pRenderContext, const Dependencies& dependencies);
+
+    /**
+     * Statistics of a compilation.
+     */
+    struct Stats
+    {
+        bool incremental = false;            ///< True if the previous compilation was used to skip work.
+        uint32_t passCount = 0;              ///< Number of passes in the execution list.
+        uint32_t compiledPassCount = 0;      ///< Number of passes whose compile() was called.
+        uint32_t allocatedResourceCount = 0; ///< Number of newly created resources.
+        uint32_t reusedResourceCount = 0;    ///< Number of resources taken over from the previous compilation.
+        double timeMs = 0.0;                 ///< Compilation time in milliseconds.
+    };
+
+    /**
+     * Compile a graph.
+     * @param[in] graph The graph.
+     * @param[in] pRenderContext Render context.
+     * @param[in] dependencies Compilation dependencies.
+     * @param[out] pStats Optional. Compilation statistics.
+     * @param[in] pPrevious Optional. Result of the previous compilation, if only the passes in `dirtyPasses` requested a
+     * recompile since then. Passes that are not dirty and whose reflection and connected resources didn't change are not
+     * recompiled, and unchanged resources are kept.
+     * @param[in] dirtyPasses Node IDs of the passes that requested a recompile.
+     */
+    static std::unique_ptr<RenderGraphExe> compile(
+        RenderGraph& graph,
+        RenderContext* pRenderContext,
+        const Dependencies& dependencies,
+        Stats* pStats = nullptr,
+        const RenderGraphExe* pPrevious = nullptr,
+        const std::set<uint32_t>& dirtyPasses = {}
+    );
+
+    /**
+     * Recompile passes of a compiled graph in place. This only succeeds if the reflection of all dirty passes is unchanged,
+     * in which case the execution order and resources stay valid.
+     * @param[in] pRenderContext Render context.
+     * @param[in] exe The compiled graph.
+     * @param[in] dirtyPasses Node IDs of the passes that requested a recompile.
+     * @param[out] pStats Optional. Compilation statistics.
+     * @return True if successful, false if the graph needs to be compiled with compile().
+     */
+    static bool recompilePasses(
+        RenderContext* pRenderContext,
+        RenderGraphExe& exe,
+        const std::set<uint32_t>& dirtyPasses,
+        Stats* pStats = nullptr
+    );
 
 private:
     RenderGraphCompiler(RenderGraph& graph, const Dependencies& dependencies);
@@ -55,6 +105,9 @@ private:
     RenderGraph& mGraph;
     ref<Device> mpDevice;
     const Dependencies& mDependencies;
+    const RenderGraphExe* mpPrevious = nullptr;
+    const std::set<uint32_t>* mpDirtyPasses = nullptr;
+    uint32_t mCompiledPassCount = 0;
 
     struct PassData
     {
@@ -75,9 +128,11 @@ private:
     void resolveExecutionOrder();
     void compilePasses(RenderContext* pRenderContext);
     bool insertAutoPasses();
-    void allocateResources(ref<Device> pDevice, ResourceCache* pResourceCache);
+    ResourceCache::AllocationStats allocateResources(ref<Device> pDevice, ResourceCache* pResourceCache);
     void validateGraph() const;
     void restoreCompilationChanges();
+    DirectedGraph buildDependencyGraph(const RenderGraphMemoryReport& memoryReport) const;
     RenderPass::CompileData prepPassCompilationData(const PassData& passData);
+    bool canSkipPassCompilation(const PassData& passData, const RenderPass::CompileData& compileData) const;
 };
 } // namespace Falcor
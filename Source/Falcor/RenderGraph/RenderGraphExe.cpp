@@ -117,4 +117,21 @@ void RenderGraphExe::setInput(const std::string& name, const ref<Resource>& pRes
 {
     mpResourceCache->registerExternalResource(name, pResource);
 }
+
+std::vector<std::string> RenderGraphExe::getPassNames() const
+{
+    std::vector<std::string> names;
+    names.reserve(mExecutionList.size());
+    for (const auto& pass : mExecutionList)
+        names.push_back(pass.name);
+    return names;
+}
+
+RenderGraphScheduler::Schedule RenderGraphExe::computeSchedule(uint32_t queueCount, const std::vector<double>& passTimes) const
+{
+    std::vector<double> times(mExecutionList.size(), 1.0);
+    for (size_t i = 0; i < std::min(times.size(), passTimes.size()); i++)
+        times[i] = passTimes[i];
+    return RenderGraphScheduler::schedule(mDependencyGraph, times, queueCount);
+}
 } // namespace Falcor
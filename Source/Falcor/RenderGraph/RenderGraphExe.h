@@ -28,6 +28,8 @@
 #pragma once
 #include "RenderPass.h"
 #include "ResourceCache.h"
+#include "RenderGraphMemoryReport.h"
+#include "RenderGraphScheduler.h"
 #include "Core/Macros.h"
 #include "Core/HotReloadFlags.h"
 #include "Core/API/Formats.h"
@@ -99,6 +101,30 @@ public:
      */
     void setInput(const std::string& name, const ref<Resource>& pResource);
 
+    /**
+     * Get the memory and bandwidth report computed when the graph was compiled.
+     */
+    const RenderGraphMemoryReport& getMemoryReport() const { return mMemoryReport; }
+
+    /**
+     * Get the dependency DAG between the passes. Node i is the pass at index i in the execution list.
+     * Contains data and execution edges, write-after-read hazards and, if resource aliasing is enabled, the ordering
+     * between resources sharing an allocation.
+     */
+    const DirectedGraph& getDependencyGraph() const { return mDependencyGraph; }
+
+    /**
+     * Get the names of the passes in execution order.
+     */
+    std::vector<std::string> getPassNames() const;
+
+    /**
+     * Schedule the passes onto multiple queues. See RenderGraphScheduler.
+     * @param[in] queueCount Number of queues.
+     * @param[in] passTimes Execution time of each pass in execution order. Passes without a time are assumed to take 1.0.
+     */
+    RenderGraphScheduler::Schedule computeSchedule(uint32_t queueCount, const std::vector<double>& passTimes = {}) const;
+
 private:
     friend class RenderGraphCompiler;
 
@@ -114,7 +140,21 @@ private:
         Pass(const std::string& name_, const ref<RenderPass>& pPass_) : name(name_), pPass(pPass_) {}
     };
 
+    /**
+     * Compilation state of a pass, used for incremental recompilation.
+     */
+    struct CompiledPass
+    {
+        uint32_t nodeIndex;
+        ref<RenderPass> pPass;
+        RenderPassReflection reflector;
+        RenderPass::CompileData compileData;
+    };
+
     std::vector<Pass> mExecutionList;
+    std::vector<CompiledPass> mCompiledPasses;
     std::unique_ptr<ResourceCache> mpResourceCache;
+    RenderGraphMemoryReport mMemoryReport;
+    DirectedGraph mDependencyGraph;
 };
 } // namespace Falcor
@@ -0,0 +1,213 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "RenderGraphMemoryReport.h"
+#include "Utils/StringUtils.h"
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+
+namespace Falcor
+{
+uint64_t RenderGraphMemoryReport::estimateFieldSize(
+    const RenderPassReflection::Field& field,
+    const ResourceCache::DefaultProperties& defaultProps
+)
+{
+    return ResourceCache::resolveFieldDesc(field, defaultProps).sizeInBytes;
+}
+
+RenderGraphMemoryReport RenderGraphMemoryReport::generate(
+    const std::vector<PassDesc>& passes,
+    const ResourceCache& resourceCache,
+    const ResourceCache::DefaultProperties& defaultProps
+)
+{
+    RenderGraphMemoryReport report;
+    const uint32_t passCount = (uint32_t)passes.size();
+    const uint32_t kUnused = uint32_t(-1);
+
+    // Resolve all graph owned resources.
+    report.mResources.resize(resourceCache.mResourceData.size());
+    for (size_t i = 0; i < resourceCache.mResourceData.size(); i++)
+    {
+        const auto& data = resourceCache.mResourceData[i];
+        auto& info = report.mResources[i];
+        static_cast<ResourceCache::ResolvedDesc&>(info) = ResourceCache::resolveFieldDesc(data.field, defaultProps);
+        if (!data.field.isValid())
+            info.sizeInBytes = 0;
+        info.name = data.name;
+        info.firstPass = kUnused;
+        info.lastPass = 0;
+        info.graphOutput = data.lifetime.second == uint32_t(-1);
+        info.persistent = data.persistent;
+    }
+    for (const auto& [name, index] : resourceCache.mNameToIndex)
+        report.mResources[index].aliases.push_back(name);
+    for (auto& info : report.mResources)
+        std::sort(info.aliases.begin(), info.aliases.end());
+
+    // Accumulate traffic from the fields each pass binds, and derive lifetimes from the actual accesses.
+    report.mPasses.resize(passCount);
+    for (uint32_t p = 0; p < passCount; p++)
+    {
+        const auto& pass = passes[p];
+        auto& passInfo = report.mPasses[p];
+        passInfo.name = pass.name;
+
+        for (size_t f = 0; f < pass.reflector.getFieldCount(); f++)
+        {
+            const auto& field = *pass.reflector.getField(f);
+            auto it = resourceCache.mNameToIndex.find(pass.name + '.' + field.getName());
+            if (it == resourceCache.mNameToIndex.end())
+                continue; // Not bound to a graph owned resource.
+
+            auto& info = report.mResources[it->second];
+            info.firstPass = std::min(info.firstPass, p);
+            info.lastPass = std::max(info.lastPass, p);
+
+            auto visibility = field.getVisibility();
+            bool isInternal = is_set(visibility, RenderPassReflection::Field::Visibility::Internal);
+            if (isInternal || is_set(visibility, RenderPassReflection::Field::Visibility::Input))
+                passInfo.bytesRead += info.sizeInBytes;
+            if (isInternal || is_set(visibility, RenderPassReflection::Field::Visibility::Output))
+                passInfo.bytesWritten += info.sizeInBytes;
+        }
+    }
+
+    for (size_t i = 0; i < report.mResources.size(); i++)
+    {
+        auto& info = report.mResources[i];
+        if (info.firstPass == kUnused)
+        {
+            // Not referenced by any of the passes, fall back to the lifetime registered in the cache.
+            const auto& lifetime = resourceCache.mResourceData[i].lifetime;
+            info.firstPass = std::min(lifetime.first, passCount ? passCount - 1 : 0);
+            info.lastPass = info.firstPass;
+        }
+        if (info.graphOutput || info.persistent)
+            info.lastPass = passCount ? passCount - 1 : 0;
+
+        report.mPeakBytesBeforeAliasing += info.sizeInBytes;
+        for (uint32_t p = info.firstPass; p <= info.lastPass && p < passCount; p++)
+            report.mPasses[p].bytesAlive += info.sizeInBytes;
+    }
+
+    for (const auto& passInfo : report.mPasses)
+        report.mMinPeakBytes = std::max(report.mMinPeakBytes, passInfo.bytesAlive);
+
+    auto plan = resourceCache.planAliasing(defaultProps);
+    for (size_t i = 0; i < report.mResources.size(); i++)
+        report.mResources[i].aliasSlot = plan.slotOfRequest[i];
+    report.mPeakBytesAfterAliasing = plan.aliasedBytes;
+
+    return report;
+}
+
+std::string RenderGraphMemoryReport::toTable() const
+{
+    std::string s;
+    s += fmt::format("{:<48} {:>12} {:>24} {:>12} {:>10} {:>6}\n", "Resource", "Size", "Format", "Dims", "Lifetime", "Slot");
+    for (const auto& r : mResources)
+    {
+        std::string dims = fmt::format("{}x{}x{}", r.width, r.height, r.depth);
+        std::string lifetime = fmt::format("{}-{}{}", r.firstPass, r.lastPass, r.graphOutput ? "*" : "");
+        std::string format = r.type == RenderPassReflection::Field::Type::RawBuffer ? "RawBuffer" : to_string(r.format);
+        s += fmt::format(
+            "{:<48} {:>12} {:>24} {:>12} {:>10} {:>6}\n", r.name, formatByteSize(r.sizeInBytes), format, dims, lifetime, r.aliasSlot
+        );
+    }
+    s += "\n";
+    s += fmt::format("{:<4} {:<40} {:>12} {:>12} {:>12}\n", "#", "Pass", "Read", "Written", "Alive");
+    for (size_t i = 0; i < mPasses.size(); i++)
+    {
+        const auto& p = mPasses[i];
+        s += fmt::format(
+            "{:<4} {:<40} {:>12} {:>12} {:>12}\n",
+            i,
+            p.name,
+            formatByteSize(p.bytesRead),
+            formatByteSize(p.bytesWritten),
+            formatByteSize(p.bytesAlive)
+        );
+    }
+    s += "\n";
+    s += fmt::format(
+        "Peak memory before aliasing: {}, after aliasing: {}, lower bound: {}\n",
+        formatByteSize(mPeakBytesBeforeAliasing),
+        formatByteSize(mPeakBytesAfterAliasing),
+        formatByteSize(mMinPeakBytes)
+    );
+    return s;
+}
+
+std::string RenderGraphMemoryReport::toJson() const
+{
+    nlohmann::json resources = nlohmann::json::array();
+    for (const auto& r : mResources)
+    {
+        resources.push_back({
+            {"name", r.name},
+            {"aliases", r.aliases},
+            {"type", to_string(r.type)},
+            {"format", to_string(r.format)},
+            {"width", r.width},
+            {"height", r.height},
+            {"depth", r.depth},
+            {"mipCount", r.mipCount},
+            {"arraySize", r.arraySize},
+            {"sampleCount", r.sampleCount},
+            {"sizeInBytes", r.sizeInBytes},
+            {"firstPass", r.firstPass},
+            {"lastPass", r.lastPass},
+            {"graphOutput", r.graphOutput},
+            {"persistent", r.persistent},
+            {"aliasSlot", r.aliasSlot},
+        });
+    }
+
+    nlohmann::json passes = nlohmann::json::array();
+    for (const auto& p : mPasses)
+    {
+        passes.push_back({
+            {"name", p.name},
+            {"bytesRead", p.bytesRead},
+            {"bytesWritten", p.bytesWritten},
+            {"bytesAlive", p.bytesAlive},
+        });
+    }
+
+    nlohmann::json j = {
+        {"resources", resources},
+        {"passes", passes},
+        {"peakBytesBeforeAliasing", mPeakBytesBeforeAliasing},
+        {"peakBytesAfterAliasing", mPeakBytesAfterAliasing},
+        {"minPeakBytes", mMinPeakBytes},
+    };
+    return j.dump(4);
+}
+} // namespace Falcor
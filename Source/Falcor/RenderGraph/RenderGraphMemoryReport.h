@@ -0,0 +1,140 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "RenderPassReflection.h"
+#include "ResourceCache.h"
+#include "Core/Macros.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Memory and bandwidth accounting for a compiled render graph.
+ * The report is computed on the CPU from the pass reflection and the resource cache registration data only,
+ * it does not require the resources to be allocated. Traffic numbers are estimates that assume every bound
+ * resource is fully read and/or written once per execution of the pass.
+ */
+class FALCOR_API RenderGraphMemoryReport
+{
+public:
+    /**
+     * A pass in execution order, as seen by the report.
+     */
+    struct PassDesc
+    {
+        std::string name;
+        RenderPassReflection reflector;
+    };
+
+    /**
+     * A resource owned by the render graph. The desc members hold the resolved desc of the resource.
+     */
+    struct ResourceInfo : ResourceCache::ResolvedDesc
+    {
+        std::string name;                 ///< Name of the field that created the resource (PassName.FieldName).
+        std::vector<std::string> aliases; ///< All fields bound to the resource, including `name`.
+        uint32_t firstPass = 0;           ///< Index of the first pass using the resource.
+        uint32_t lastPass = 0;            ///< Index of the last pass using the resource.
+        bool graphOutput = false;         ///< True if the resource is a graph output (kept alive until the end of the graph).
+        bool persistent = false;          ///< True if the resource was requested as persistent.
+        uint32_t aliasSlot = 0;           ///< Allocation slot in the aliasing plan. Resources sharing a slot can share memory.
+    };
+
+    /**
+     * Per-pass traffic and residency.
+     */
+    struct PassInfo
+    {
+        std::string name;
+        uint64_t bytesRead = 0;    ///< Estimated bytes read by the pass.
+        uint64_t bytesWritten = 0; ///< Estimated bytes written by the pass.
+        uint64_t bytesAlive = 0;   ///< Size of all graph resources alive while the pass executes.
+    };
+
+    /**
+     * Generate the report.
+     * @param[in] passes Passes in execution order.
+     * @param[in] resourceCache Resource cache with all fields registered. Resources don't have to be allocated.
+     * @param[in] defaultProps Properties used to resolve unspecified field dimensions and format.
+     * @return The report.
+     */
+    static RenderGraphMemoryReport generate(
+        const std::vector<PassDesc>& passes,
+        const ResourceCache& resourceCache,
+        const ResourceCache::DefaultProperties& defaultProps
+    );
+
+    /**
+     * Estimate the size in bytes of the resource created for a field.
+     * Dimensions and format are resolved the same way the resource cache resolves them on allocation.
+     * Returns 0 if the format can't be resolved.
+     */
+    static uint64_t estimateFieldSize(const RenderPassReflection::Field& field, const ResourceCache::DefaultProperties& defaultProps);
+
+    const std::vector<ResourceInfo>& getResources() const { return mResources; }
+    const std::vector<PassInfo>& getPasses() const { return mPasses; }
+
+    /**
+     * Get the peak memory of the graph resources without aliasing.
+     * Graph resources are allocated when the graph is compiled and stay resident while it executes, so without aliasing
+     * the peak is the size of all resources, each with its own allocation.
+     */
+    uint64_t getPeakBytesBeforeAliasing() const { return mPeakBytesBeforeAliasing; }
+
+    /**
+     * Get the peak memory of the graph resources when transient resources are aliased (see ResourceCache::planAliasing()),
+     * i.e. the size of all allocation slots.
+     */
+    uint64_t getPeakBytesAfterAliasing() const { return mPeakBytesAfterAliasing; }
+
+    /**
+     * Get the maximum size of resources alive at the same time over all passes.
+     * This is a lower bound for the peak memory of any aliasing plan.
+     */
+    uint64_t getMinPeakBytes() const { return mMinPeakBytes; }
+
+    /**
+     * Format the report as a human readable table.
+     */
+    std::string toTable() const;
+
+    /**
+     * Format the report as a JSON string.
+     */
+    std::string toJson() const;
+
+private:
+    std::vector<ResourceInfo> mResources;
+    std::vector<PassInfo> mPasses;
+    uint64_t mPeakBytesBeforeAliasing = 0;
+    uint64_t mPeakBytesAfterAliasing = 0;
+    uint64_t mMinPeakBytes = 0;
+};
+} // namespace Falcor
@@ -0,0 +1,216 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "RenderGraphScheduler.h"
+#include "Core/Error.h"
+#include "Utils/Algorithm/DirectedGraphTraversal.h"
+#include <fmt/format.h>
+#include <algorithm>
+
+namespace Falcor
+{
+RenderGraphScheduler::Schedule RenderGraphScheduler::schedule(
+    const DirectedGraph& dependencies,
+    const std::vector<double>& passTimes,
+    uint32_t queueCount
+)
+{
+    FALCOR_CHECK(queueCount > 0, "Queue count must be at least 1.");
+    const uint32_t passCount = (uint32_t)passTimes.size();
+
+    // Gather predecessors and successors.
+    std::vector<std::vector<uint32_t>> preds(passCount);
+    std::vector<std::vector<uint32_t>> succs(passCount);
+    for (uint32_t i = 0; i < passCount; i++)
+    {
+        FALCOR_CHECK(dependencies.doesNodeExist(i), "Dependency graph is missing node {}.", i);
+        const DirectedGraph::Node* pNode = dependencies.getNode(i);
+        for (uint32_t e = 0; e < pNode->getIncomingEdgeCount(); e++)
+        {
+            uint32_t src = dependencies.getEdge(pNode->getIncomingEdge(e))->getSourceNode();
+            FALCOR_CHECK(src < passCount, "Dependency graph has an edge from unknown node {}.", src);
+            preds[i].push_back(src);
+            succs[src].push_back(i);
+        }
+    }
+
+    // Compute the upward rank of each pass in reverse topological order.
+    std::vector<double> rank(passCount, 0.0);
+    auto order = DirectedGraphTopologicalSort::sort(dependencies);
+    for (auto it = order.rbegin(); it != order.rend(); it++)
+    {
+        uint32_t i = *it;
+        if (i >= passCount)
+            continue;
+        double maxSucc = 0.0;
+        for (uint32_t s : succs[i])
+            maxSucc = std::max(maxSucc, rank[s]);
+        rank[i] = std::max(passTimes[i], 0.0) + maxSucc;
+    }
+
+    Schedule schedule;
+    schedule.passes.resize(passCount);
+    schedule.queues.resize(queueCount);
+
+    std::vector<uint32_t> remainingPreds(passCount);
+    std::vector<uint32_t> ready;
+    for (uint32_t i = 0; i < passCount; i++)
+    {
+        remainingPreds[i] = (uint32_t)preds[i].size();
+        if (remainingPreds[i] == 0)
+            ready.push_back(i);
+    }
+
+    // Vector clocks used to compute the minimal set of barriers. clock[q][r] is the last position on queue r
+    // that queue q is known to have synchronized with. Positions are 1-based, 0 means no synchronization.
+    std::vector<std::vector<uint32_t>> queueClock(queueCount, std::vector<uint32_t>(queueCount, 0));
+    std::vector<std::vector<uint32_t>> passClock(passCount);
+    std::vector<uint32_t> position(passCount, 0);
+    std::vector<double> queueFree(queueCount, 0.0);
+
+    uint32_t scheduledCount = 0;
+    while (!ready.empty())
+    {
+        // Pick the ready pass with the highest rank. Ties are broken on execution order.
+        auto best = std::min_element(
+            ready.begin(),
+            ready.end(),
+            [&](uint32_t a, uint32_t b)
+            {
+                if (rank[a] != rank[b])
+                    return rank[a] > rank[b];
+                return a < b;
+            }
+        );
+        uint32_t p = *best;
+        ready.erase(best);
+
+        double readyTime = 0.0;
+        uint32_t lastPred = kInvalidIndex;
+        for (uint32_t u : preds[p])
+        {
+            if (lastPred == kInvalidIndex || schedule.passes[u].end > readyTime)
+            {
+                readyTime = schedule.passes[u].end;
+                lastPred = u;
+            }
+        }
+
+        // Pick the queue where the pass starts the earliest. Prefer the queue of the last finishing
+        // predecessor to avoid a barrier, then the lowest queue index.
+        uint32_t queue = 0;
+        double bestStart = std::max(queueFree[0], readyTime);
+        for (uint32_t q = 1; q < queueCount; q++)
+        {
+            double start = std::max(queueFree[q], readyTime);
+            if (start < bestStart)
+            {
+                bestStart = start;
+                queue = q;
+            }
+        }
+        if (lastPred != kInvalidIndex)
+        {
+            uint32_t predQueue = schedule.passes[lastPred].queue;
+            if (std::max(queueFree[predQueue], readyTime) <= bestStart)
+                queue = predQueue;
+        }
+
+        auto& sp = schedule.passes[p];
+        sp.queue = queue;
+        sp.start = std::max(queueFree[queue], readyTime);
+        sp.end = sp.start + std::max(passTimes[p], 0.0);
+        queueFree[queue] = sp.end;
+        schedule.queues[queue].push_back(p);
+        position[p] = (uint32_t)schedule.queues[queue].size();
+
+        // Insert barriers for cross-queue dependencies that are not already covered by earlier synchronization.
+        auto& clock = queueClock[queue];
+        // Positions are only comparable within a queue: first find the latest uncovered predecessor on each queue,
+        // then wait on the one finishing last, since its clock is the most likely to cover the others.
+        std::vector<uint32_t> latestOnQueue(queueCount);
+        while (true)
+        {
+            std::fill(latestOnQueue.begin(), latestOnQueue.end(), kInvalidIndex);
+            for (uint32_t u : preds[p])
+            {
+                uint32_t q = schedule.passes[u].queue;
+                if (q == queue || position[u] <= clock[q])
+                    continue;
+                if (latestOnQueue[q] == kInvalidIndex || position[u] > position[latestOnQueue[q]])
+                    latestOnQueue[q] = u;
+            }
+
+            uint32_t waitOn = kInvalidIndex;
+            for (uint32_t u : latestOnQueue)
+            {
+                if (u != kInvalidIndex && (waitOn == kInvalidIndex || schedule.passes[u].end > schedule.passes[waitOn].end))
+                    waitOn = u;
+            }
+            if (waitOn == kInvalidIndex)
+                break;
+
+            schedule.barriers.push_back({waitOn, p});
+            for (uint32_t q = 0; q < queueCount; q++)
+                clock[q] = std::max(clock[q], passClock[waitOn][q]);
+        }
+        clock[queue] = position[p];
+        passClock[p] = clock;
+
+        schedule.serialTime += std::max(passTimes[p], 0.0);
+        schedule.makespan = std::max(schedule.makespan, sp.end);
+        scheduledCount++;
+
+        for (uint32_t s : succs[p])
+        {
+            if (--remainingPreds[s] == 0)
+                ready.push_back(s);
+        }
+    }
+
+    FALCOR_CHECK(scheduledCount == passCount, "Dependency graph contains a cycle.");
+    return schedule;
+}
+
+std::string RenderGraphScheduler::Schedule::toString(const std::vector<std::string>& passNames) const
+{
+    auto getName = [&](uint32_t p) { return p < passNames.size() ? passNames[p] : fmt::format("#{}", p); };
+
+    std::string s;
+    for (size_t q = 0; q < queues.size(); q++)
+    {
+        s += fmt::format("Queue {}:\n", q);
+        for (uint32_t p : queues[q])
+            s += fmt::format("  {:<40} {:>10.3f} - {:>10.3f}\n", getName(p), passes[p].start, passes[p].end);
+    }
+    s += "Barriers:\n";
+    for (const auto& b : barriers)
+        s += fmt::format("  {} (queue {}) -> {} (queue {})\n", getName(b.srcPass), passes[b.srcPass].queue, getName(b.dstPass), passes[b.dstPass].queue);
+    s += fmt::format("Makespan: {:.3f}, serial: {:.3f}\n", makespan, serialTime);
+    return s;
+}
+} // namespace Falcor
@@ -0,0 +1,90 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Algorithm/DirectedGraph.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Schedules render graph passes onto multiple queues.
+ * The input is a dependency DAG where node i is the pass at index i in the execution list, and an edge (a, b) means
+ * that pass b must wait for pass a. Passes are list-scheduled in order of decreasing upward rank (length of the longest
+ * path to the end of the graph) onto the queue where they can start the earliest. Cross-queue dependencies are reduced
+ * to the minimal set of barriers, taking into account that passes on the same queue execute in order.
+ * The scheduler only works on plain data, so it can be used to predict the makespan from recorded pass times without a device.
+ */
+class FALCOR_API RenderGraphScheduler
+{
+public:
+    static constexpr uint32_t kInvalidIndex = uint32_t(-1);
+
+    struct ScheduledPass
+    {
+        uint32_t queue = 0;   ///< Queue the pass is assigned to.
+        double start = 0.0;   ///< Simulated start time.
+        double end = 0.0;     ///< Simulated end time.
+    };
+
+    /**
+     * A cross-queue dependency. The destination queue waits for the source pass to finish before starting the destination pass.
+     */
+    struct Barrier
+    {
+        uint32_t srcPass = kInvalidIndex;
+        uint32_t dstPass = kInvalidIndex;
+    };
+
+    struct Schedule
+    {
+        std::vector<ScheduledPass> passes;          ///< Scheduling info for each pass, indexed like the execution list.
+        std::vector<std::vector<uint32_t>> queues;  ///< Pass indices in submission order for each queue.
+        std::vector<Barrier> barriers;              ///< Minimal set of cross-queue barriers, in submission order.
+        double makespan = 0.0;                      ///< Simulated time until all queues are idle.
+        double serialTime = 0.0;                    ///< Simulated time when running all passes on a single queue.
+
+        /**
+         * Format the schedule as a human readable string.
+         * @param[in] passNames Optional pass names, indexed like the execution list.
+         */
+        std::string toString(const std::vector<std::string>& passNames = {}) const;
+    };
+
+    /**
+     * Compute a schedule.
+     * @param[in] dependencies Dependency DAG with nodes [0, passTimes.size()).
+     * @param[in] passTimes Recorded or estimated execution time of each pass. Use 1.0 for all passes if unknown.
+     * @param[in] queueCount Number of queues. Must be at least 1.
+     * @return The schedule.
+     */
+    static Schedule schedule(const DirectedGraph& dependencies, const std::vector<double>& passTimes, uint32_t queueCount);
+};
+} // namespace Falcor
@@ -251,6 +251,8 @@ protected:
      * Request a recompilation of the render graph.
      * Call this function if the I/O requirements of the pass have changed.
      * During the recompile, reflect() will be called for the pass to report the new requirements.
+     * The recompile is incremental: if the reflection is unchanged, only this pass is compiled again. Otherwise only the passes
+     * whose I/O changed are compiled again and unchanged resources are kept.
      */
     void requestRecompile() { mPassChangedCB(); }
 
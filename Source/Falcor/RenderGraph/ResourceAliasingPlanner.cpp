@@ -0,0 +1,114 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ResourceAliasingPlanner.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <numeric>
+
+namespace Falcor
+{
+ResourceAliasingPlanner::Plan ResourceAliasingPlanner::plan(const std::vector<Request>& requests)
+{
+    Plan plan;
+    plan.slotOfRequest.resize(requests.size(), kNoSlot);
+
+    // Process large resources first so that smaller ones fill in the gaps.
+    // Ties are broken on first use and then on index so that the plan is deterministic.
+    std::vector<uint32_t> order(requests.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(
+        order.begin(),
+        order.end(),
+        [&](uint32_t a, uint32_t b)
+        {
+            if (requests[a].size != requests[b].size)
+                return requests[a].size > requests[b].size;
+            if (requests[a].firstUse != requests[b].firstUse)
+                return requests[a].firstUse < requests[b].firstUse;
+            return a < b;
+        }
+    );
+
+    auto overlaps = [&](const Slot& slot, const Request& r)
+    {
+        for (uint32_t i : slot.requests)
+        {
+            const Request& other = requests[i];
+            if (r.firstUse <= other.lastUse && other.firstUse <= r.lastUse)
+                return true;
+        }
+        return false;
+    };
+
+    std::vector<bool> slotAliasable;
+    for (uint32_t i : order)
+    {
+        const Request& r = requests[i];
+        FALCOR_CHECK(r.firstUse <= r.lastUse, "Invalid resource lifetime [{}, {}].", r.firstUse, r.lastUse);
+
+        uint32_t slotIndex = kNoSlot;
+        if (r.aliasable)
+        {
+            for (uint32_t s = 0; s < (uint32_t)plan.slots.size(); s++)
+            {
+                const Slot& slot = plan.slots[s];
+                if (slotAliasable[s] && slot.compatibilityClass == r.compatibilityClass && !overlaps(slot, r))
+                {
+                    slotIndex = s;
+                    break;
+                }
+            }
+        }
+
+        if (slotIndex == kNoSlot)
+        {
+            slotIndex = (uint32_t)plan.slots.size();
+            Slot slot;
+            slot.compatibilityClass = r.compatibilityClass;
+            plan.slots.push_back(slot);
+            slotAliasable.push_back(r.aliasable);
+        }
+
+        Slot& slot = plan.slots[slotIndex];
+        slot.size = std::max(slot.size, r.size);
+        slot.requests.push_back(i);
+        plan.slotOfRequest[i] = slotIndex;
+        plan.unaliasedBytes += r.size;
+    }
+
+    for (auto& slot : plan.slots)
+    {
+        std::sort(
+            slot.requests.begin(), slot.requests.end(), [&](uint32_t a, uint32_t b) { return requests[a].firstUse < requests[b].firstUse; }
+        );
+        plan.aliasedBytes += slot.size;
+    }
+
+    return plan;
+}
+} // namespace Falcor
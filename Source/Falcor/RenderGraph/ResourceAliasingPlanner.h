@@ -0,0 +1,78 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Plans memory aliasing of transient render graph resources.
+ * Resources whose lifetimes don't overlap and that belong to the same compatibility class are assigned to the same
+ * slot, i.e. they share a single backing allocation. The assignment is done with greedy first-fit over resources
+ * sorted by decreasing size, which is a simple interval-graph coloring.
+ * The planner works on plain data and doesn't require a device.
+ */
+class FALCOR_API ResourceAliasingPlanner
+{
+public:
+    static constexpr uint32_t kNoSlot = uint32_t(-1);
+
+    struct Request
+    {
+        uint64_t size = 0;               ///< Size of the resource in bytes.
+        uint32_t firstUse = 0;           ///< Index of the first pass using the resource.
+        uint32_t lastUse = 0;            ///< Index of the last pass using the resource (inclusive).
+        uint32_t compatibilityClass = 0; ///< Only resources with the same class can share a slot.
+        bool aliasable = true;           ///< If false, the resource always gets a dedicated slot.
+    };
+
+    struct Slot
+    {
+        uint64_t size = 0;                ///< Size of the slot, i.e. the size of the largest resource assigned to it.
+        uint32_t compatibilityClass = 0;  ///< Compatibility class of all resources in the slot.
+        std::vector<uint32_t> requests;   ///< Indices of the requests assigned to this slot, ordered by first use.
+    };
+
+    struct Plan
+    {
+        std::vector<uint32_t> slotOfRequest; ///< Slot index for each request.
+        std::vector<Slot> slots;             ///< All slots.
+        uint64_t unaliasedBytes = 0;         ///< Total size of all requests when every resource has a dedicated allocation.
+        uint64_t aliasedBytes = 0;           ///< Total size of all slots.
+    };
+
+    /**
+     * Compute an aliasing plan.
+     * @param[in] requests List of resources. Requests with lastUse < firstUse are invalid.
+     * @return The plan. Every request is assigned to exactly one slot.
+     */
+    static Plan plan(const std::vector<Request>& requests);
+};
+} // namespace Falcor
@@ -30,9 +30,97 @@
 #include "Core/API/Texture.h"
 #include "Core/API/Buffer.h"
 #include "Utils/Logger.h"
+#include "Utils/Math/Common.h"
+#include "Utils/StringUtils.h"
+#include <map>
+#include <tuple>
 
 namespace Falcor
 {
+namespace
+{
+uint32_t getFullMipCount(uint32_t width, uint32_t height, uint32_t depth)
+{
+    uint32_t dim = std::max(width, std::max(height, depth));
+    uint32_t count = 1;
+    while (dim > 1)
+    {
+        dim >>= 1;
+        count++;
+    }
+    return count;
+}
+
+uint64_t computeResourceSize(const ResourceCache::ResolvedDesc& desc)
+{
+    if (desc.type == RenderPassReflection::Field::Type::RawBuffer)
+        return desc.width;
+    if (desc.format == ResourceFormat::Unknown)
+        return 0;
+
+    const uint32_t blockWidth = getFormatWidthCompressionRatio(desc.format);
+    const uint32_t blockHeight = getFormatHeightCompressionRatio(desc.format);
+    const uint64_t bytesPerBlock = getFormatBytesPerBlock(desc.format);
+
+    uint64_t size = 0;
+    for (uint32_t mip = 0; mip < desc.mipCount; mip++)
+    {
+        uint64_t w = std::max(desc.width >> mip, 1u);
+        uint64_t h = std::max(desc.height >> mip, 1u);
+        uint64_t d = std::max(desc.depth >> mip, 1u);
+        size += div_round_up(w, (uint64_t)blockWidth) * div_round_up(h, (uint64_t)blockHeight) * d * bytesPerBlock;
+    }
+
+    uint64_t layers = desc.arraySize * desc.sampleCount;
+    if (desc.type == RenderPassReflection::Field::Type::TextureCube)
+        layers *= 6;
+    return size * layers;
+}
+} // namespace
+
+ResourceCache::ResolvedDesc ResourceCache::resolveFieldDesc(const RenderPassReflection::Field& field, const DefaultProperties& params)
+{
+    using Type = RenderPassReflection::Field::Type;
+
+    // Resolve the properties the same way createResourceForPass() does when creating the resource.
+    ResolvedDesc desc;
+    desc.type = field.getType();
+    desc.width = field.getWidth() ? field.getWidth() : params.dims.x;
+    desc.height = field.getHeight() ? field.getHeight() : params.dims.y;
+    desc.depth = field.getDepth() ? field.getDepth() : 1;
+    desc.sampleCount = field.getSampleCount() ? field.getSampleCount() : 1;
+    desc.arraySize = std::max(field.getArraySize(), 1u);
+    desc.mipCount = field.getMipCount();
+
+    switch (desc.type)
+    {
+    case Type::RawBuffer:
+        desc.height = desc.depth = desc.arraySize = desc.mipCount = desc.sampleCount = 1;
+        desc.sizeInBytes = computeResourceSize(desc);
+        return desc;
+    case Type::Texture1D:
+        desc.height = desc.depth = desc.sampleCount = 1;
+        break;
+    case Type::Texture2D:
+    case Type::TextureCube:
+        desc.depth = 1;
+        break;
+    case Type::Texture3D:
+        desc.arraySize = desc.sampleCount = 1;
+        break;
+    default:
+        FALCOR_UNREACHABLE();
+    }
+
+    desc.format = field.getFormat() == ResourceFormat::Unknown ? params.format : field.getFormat();
+    if (desc.sampleCount > 1)
+        desc.mipCount = 1;
+    else if (desc.mipCount == RenderPassReflection::Field::kMaxMipLevels || desc.mipCount == 0)
+        desc.mipCount = getFullMipCount(desc.width, desc.height, desc.depth);
+    desc.sizeInBytes = computeResourceSize(desc);
+    return desc;
+}
+
 void ResourceCache::reset()
 {
     mNameToIndex.clear();
@@ -106,7 +194,8 @@ void ResourceCache::registerField(
         FALCOR_ASSERT(mNameToIndex.count(name) == 0);
         mNameToIndex[name] = (uint32_t)mResourceData.size();
         bool resolveBindFlags = (field.getBindFlags() == ResourceBindFlags::None);
-        mResourceData.push_back({field, {timePoint, timePoint}, nullptr, resolveBindFlags, name});
+        bool persistent = is_set(field.getFlags(), RenderPassReflection::Field::Flags::Persistent);
+        mResourceData.push_back({field, {timePoint, timePoint}, nullptr, resolveBindFlags, name, persistent});
     }
     else // Add alias
     {
@@ -116,30 +205,23 @@ void ResourceCache::registerField(
         mergeTimePoint(mResourceData[index].lifetime, timePoint);
         mResourceData[index].pResource = nullptr;
         mResourceData[index].resolveBindFlags = mResourceData[index].resolveBindFlags || (field.getBindFlags() == ResourceBindFlags::None);
+        mResourceData[index].persistent =
+            mResourceData[index].persistent || is_set(field.getFlags(), RenderPassReflection::Field::Flags::Persistent);
     }
 }
 
-inline ref<Resource> createResourceForPass(
+inline ResourceBindFlags getResourceBindFlags(
     ref<Device> pDevice,
     const ResourceCache::DefaultProperties& params,
     const RenderPassReflection::Field& field,
-    bool resolveBindFlags,
-    const std::string& resourceName
+    bool resolveBindFlags
 )
 {
-    uint32_t width = field.getWidth() ? field.getWidth() : params.dims.x;
-    uint32_t height = field.getHeight() ? field.getHeight() : params.dims.y;
-    uint32_t depth = field.getDepth() ? field.getDepth() : 1;
-    uint32_t sampleCount = field.getSampleCount() ? field.getSampleCount() : 1;
     auto bindFlags = field.getBindFlags();
-    auto arraySize = field.getArraySize();
-    auto mipLevels = field.getMipCount();
-
-    ResourceFormat format = ResourceFormat::Unknown;
 
     if (field.getType() != RenderPassReflection::Field::Type::RawBuffer)
     {
-        format = field.getFormat() == ResourceFormat::Unknown ? params.format : field.getFormat();
+        ResourceFormat format = field.getFormat() == ResourceFormat::Unknown ? params.format : field.getFormat();
         if (resolveBindFlags)
         {
             ResourceBindFlags mask = ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource;
@@ -157,6 +239,28 @@ inline ref<Resource> createResourceForPass(
         if (resolveBindFlags)
             bindFlags = ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource;
     }
+    return bindFlags;
+}
+
+inline ref<Resource> createResourceForPass(
+    ref<Device> pDevice,
+    const ResourceCache::DefaultProperties& params,
+    const RenderPassReflection::Field& field,
+    ResourceBindFlags bindFlags,
+    const std::string& resourceName
+)
+{
+    uint32_t width = field.getWidth() ? field.getWidth() : params.dims.x;
+    uint32_t height = field.getHeight() ? field.getHeight() : params.dims.y;
+    uint32_t depth = field.getDepth() ? field.getDepth() : 1;
+    uint32_t sampleCount = field.getSampleCount() ? field.getSampleCount() : 1;
+    auto arraySize = field.getArraySize();
+    auto mipLevels = field.getMipCount();
+
+    ResourceFormat format = ResourceFormat::Unknown;
+    if (field.getType() != RenderPassReflection::Field::Type::RawBuffer)
+        format = field.getFormat() == ResourceFormat::Unknown ? params.format : field.getFormat();
+
     ref<Resource> pResource;
 
     switch (field.getType())
@@ -191,14 +295,143 @@ inline ref<Resource> createResourceForPass(
     return pResource;
 }
 
-void ResourceCache::allocateResources(ref<Device> pDevice, const DefaultProperties& params)
+ResourceAliasingPlanner::Plan ResourceCache::planAliasing(const DefaultProperties& params) const
+{
+    using Visibility = RenderPassReflection::Field::Visibility;
+
+    // Resources can only share an allocation if their resolved descs match. Bind flags are merged on allocation.
+    using DescKey = std::tuple<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t>;
+    std::map<DescKey, uint32_t> descToClass;
+
+    std::vector<ResourceAliasingPlanner::Request> requests(mResourceData.size());
+    for (size_t i = 0; i < mResourceData.size(); i++)
+    {
+        const auto& data = mResourceData[i];
+        auto info = resolveFieldDesc(data.field, params);
+
+        DescKey key = {
+            (uint32_t)info.type,
+            (uint32_t)info.format,
+            info.width,
+            info.height,
+            info.depth,
+            info.mipCount,
+            info.arraySize,
+            info.sampleCount,
+        };
+        auto it = descToClass.emplace(key, (uint32_t)descToClass.size()).first;
+
+        bool graphOutput = data.lifetime.second == uint32_t(-1);
+        bool internal = is_set(data.field.getVisibility(), Visibility::Internal);
+
+        auto& r = requests[i];
+        r.size = info.sizeInBytes;
+        r.compatibilityClass = it->second;
+        r.aliasable = !graphOutput && !internal && !data.persistent && info.sizeInBytes > 0;
+        r.firstUse = r.aliasable ? data.lifetime.first : 0;
+        r.lastUse = r.aliasable ? data.lifetime.second : 0;
+    }
+
+    return ResourceAliasingPlanner::plan(requests);
+}
+
+ref<Resource> ResourceCache::findReusableResource(
+    const std::string& fieldName,
+    const std::string& resourceName,
+    const DefaultProperties& params,
+    const RenderPassReflection::Field& field,
+    ResourceBindFlags bindFlags
+) const
+{
+    auto it = mNameToIndex.find(fieldName);
+    if (it == mNameToIndex.end())
+        return nullptr;
+
+    // The resource must not have been shared with a different set of fields.
+    const ref<Resource>& pResource = mResourceData[it->second].pResource;
+    if (!pResource || pResource->getName() != resourceName || pResource->getBindFlags() != bindFlags)
+        return nullptr;
+
+    auto info = resolveFieldDesc(field, params);
+    if (info.type == RenderPassReflection::Field::Type::RawBuffer)
+    {
+        auto pBuffer = pResource->asBuffer();
+        return (pBuffer && pBuffer->getSize() == info.width) ? pResource : nullptr;
+    }
+
+    auto pTexture = pResource->asTexture();
+    if (!pTexture || resourceTypeToFieldType(pTexture->getType()) != info.type)
+        return nullptr;
+    bool match = pTexture->getFormat() == info.format && pTexture->getWidth() == info.width && pTexture->getHeight() == info.height &&
+                 pTexture->getDepth() == info.depth && pTexture->getMipCount() == info.mipCount &&
+                 pTexture->getArraySize() == info.arraySize && pTexture->getSampleCount() == info.sampleCount;
+    return match ? pResource : nullptr;
+}
+
+ResourceCache::AllocationStats ResourceCache::allocateResources(
+    ref<Device> pDevice,
+    const DefaultProperties& params,
+    bool enableAliasing,
+    const ResourceCache* pPrevious
+)
 {
+    AllocationStats stats;
+
+    auto getResource = [&](const std::string& fieldName,
+                           const std::string& resourceName,
+                           const RenderPassReflection::Field& field,
+                           ResourceBindFlags bindFlags) -> ref<Resource>
+    {
+        if (pPrevious)
+        {
+            if (auto pResource = pPrevious->findReusableResource(fieldName, resourceName, params, field, bindFlags))
+            {
+                stats.reusedCount++;
+                return pResource;
+            }
+        }
+        stats.allocatedCount++;
+        return createResourceForPass(pDevice, params, field, bindFlags, resourceName);
+    };
+
+    if (enableAliasing)
+    {
+        auto plan = planAliasing(params);
+        for (const auto& slot : plan.slots)
+        {
+            if (slot.requests.size() < 2)
+                continue;
+
+            // All resources in the slot have the same desc, create a single resource with the union of their bind flags.
+            ResourceBindFlags bindFlags = ResourceBindFlags::None;
+            std::vector<std::string> names;
+            bool valid = true;
+            for (uint32_t i : slot.requests)
+            {
+                const auto& data = mResourceData[i];
+                valid = valid && data.pResource == nullptr && data.field.isValid();
+                bindFlags |= getResourceBindFlags(pDevice, params, data.field, data.resolveBindFlags);
+                names.push_back(data.name);
+            }
+            if (!valid)
+                continue;
+
+            const auto& first = mResourceData[slot.requests[0]];
+            auto pResource = getResource(first.name, joinStrings(names, "|"), first.field, bindFlags);
+            for (uint32_t i : slot.requests)
+                mResourceData[i].pResource = pResource;
+        }
+    }
+
     for (auto& data : mResourceData)
     {
         if ((data.pResource == nullptr) && (data.field.isValid()))
         {
-            data.pResource = createResourceForPass(pDevice, params, data.field, data.resolveBindFlags, data.name);
+            auto bindFlags = getResourceBindFlags(pDevice, params, data.field, data.resolveBindFlags);
+            data.pResource = getResource(data.name, data.name, data.field, bindFlags);
         }
     }
+
+    return stats;
 }
 } // namespace Falcor
@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "RenderPassReflection.h"
+#include "ResourceAliasingPlanner.h"
 #include "Core/Macros.h"
 #include "Core/API/fwd.h"
 #include "Core/API/Resource.h"
@@ -51,6 +52,30 @@ public:
         ResourceFormat format = ResourceFormat::Unknown; ///< Format to use for texture creation
     };
 
+    /**
+     * Desc of the resource created for a field, with all unspecified properties resolved.
+     */
+    struct ResolvedDesc
+    {
+        RenderPassReflection::Field::Type type = RenderPassReflection::Field::Type::Texture2D;
+        ResourceFormat format = ResourceFormat::Unknown; ///< Resolved format. Unknown for buffers.
+        uint32_t width = 0;       ///< Resolved width. For buffers, the size in bytes.
+        uint32_t height = 0;      ///< Resolved height.
+        uint32_t depth = 0;       ///< Resolved depth.
+        uint32_t mipCount = 0;    ///< Resolved mip count.
+        uint32_t arraySize = 0;   ///< Resolved array size.
+        uint32_t sampleCount = 0; ///< Resolved sample count.
+        uint64_t sizeInBytes = 0; ///< Estimated size of the allocation. 0 if the format can't be resolved.
+    };
+
+    /**
+     * Resolve the desc of the resource created for a field, the same way as on allocation.
+     * @param[in] field Reflection data for the field.
+     * @param[in] params Default properties for resources that are not fully specified.
+     * @return The resolved desc.
+     */
+    static ResolvedDesc resolveFieldDesc(const RenderPassReflection::Field& field, const DefaultProperties& params);
+
     /**
      * Add/Remove reference to a graph input resource not owned by the cache
      * @param[in] name The resource's name
@@ -83,11 +108,39 @@ public:
      */
     const RenderPassReflection::Field& getResourceReflection(const std::string& name) const;
 
+    /**
+     * Statistics of a call to allocateResources().
+     */
+    struct AllocationStats
+    {
+        uint32_t allocatedCount = 0; ///< Number of newly created resources.
+        uint32_t reusedCount = 0;    ///< Number of resources taken over from the previous cache.
+    };
+
     /**
      * Allocate all resources that need to be created/updated.
      * This includes new resources, resources whose properties have been updated since last allocation call.
+     * @param[in] pDevice GPU device.
+     * @param[in] params Default properties for resources that are not fully specified.
+     * @param[in] enableAliasing If true, transient resources with disjoint lifetimes and identical descs share the same allocation.
+     * @param[in] pPrevious Optional. Cache of a previous compilation. Resources with the same name, desc and bind flags are
+     * taken over from it instead of being recreated, which also preserves their content.
+     * @return Allocation statistics.
+     */
+    AllocationStats allocateResources(
+        ref<Device> pDevice,
+        const DefaultProperties& params,
+        bool enableAliasing = false,
+        const ResourceCache* pPrevious = nullptr
+    );
+
+    /**
+     * Compute the aliasing plan for the registered resources. This doesn't require a device.
+     * Graph outputs, persistent and internal resources are never aliased. Internal resources commonly hold data across frames.
+     * @param[in] params Default properties for resources that are not fully specified.
+     * @return Plan with one request per registered resource, in registration order.
      */
-    void allocateResources(ref<Device> pDevice, const DefaultProperties& params);
+    ResourceAliasingPlanner::Plan planAliasing(const DefaultProperties& params) const;
 
     /**
      * Clears all registered field/resource properties and allocated resources.
@@ -95,6 +148,8 @@ public:
     void reset();
 
 private:
+    friend class RenderGraphMemoryReport;
+
     struct ResourceData
     {
         RenderPassReflection::Field field;      // Holds merged properties for aliased resources
@@ -102,8 +157,17 @@ private:
         ref<Resource> pResource;                // The resource
         bool resolveBindFlags;                  // Whether or not we should resolve the field's bind-flags before creating the resource
         std::string name;                       // Full name of the resource, including the pass name
+        bool persistent;                        // Whether any of the fields bound to the resource is persistent
     };
 
+    ref<Resource> findReusableResource(
+        const std::string& fieldName,
+        const std::string& resourceName,
+        const DefaultProperties& params,
+        const RenderPassReflection::Field& field,
+        ResourceBindFlags bindFlags
+    ) const;
+
     // Resources and properties for fields within (and therefore owned by) a render graph
     std::unordered_map<std::string, uint32_t> mNameToIndex;
     std::vector<ResourceData> mResourceData;
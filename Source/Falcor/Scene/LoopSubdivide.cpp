@@ -0,0 +1,545 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+
+// This code is based on pbrt:
+// pbrt is Copyright(c) 1998-2020 Matt Pharr, Wenzel Jakob, and Greg Humphreys.
+// The pbrt source code is licensed under the Apache License, Version 2.0.
+// SPDX: Apache-2.0
+
+#include "LoopSubdivide.h"
+#include "Core/Error.h"
+
+#include <BS_thread_pool/BS_thread_pool.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include <cmath>
+
+namespace Falcor
+{
+namespace
+{
+constexpr uint32_t kInvalidIndex = uint32_t(-1);
+
+/// Loops with fewer iterations run on the calling thread.
+constexpr uint32_t kMinParallelCount = 4096;
+
+/// Call func(i) for all i in [0, count). Large loops are split into blocks on the thread pool.
+template<typename Func>
+void parallelFor(BS::thread_pool& threadPool, uint32_t count, const Func& func)
+{
+    auto loop = [&func](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; ++i)
+            func(i);
+    };
+    if (count < kMinParallelCount)
+        loop(0, count);
+    else
+        threadPool.parallelize_loop(0u, count, loop).wait();
+}
+
+inline uint32_t next(uint32_t i)
+{
+    return (i + 1) % 3;
+}
+
+inline uint32_t prev(uint32_t i)
+{
+    return (i + 2) % 3;
+}
+
+inline float beta(uint32_t valence)
+{
+    if (valence == 3)
+        return 3.f / 16.f;
+    else
+        return 3.f / (8.f * valence);
+}
+
+inline float loopGamma(uint32_t valence)
+{
+    return 1.f / (valence + 3.f / (8.f * beta(valence)));
+}
+
+/**
+ * Subdivision mesh stored in flat half-edge arrays.
+ * Half-edge h = 3 * face + k of a face runs from vertex indices[h] to vertex indices[3 * face + next(k)].
+ */
+struct SubdivisionMesh
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;    ///< Start vertex of each half-edge.
+    std::vector<uint32_t> neighbors;  ///< Face on the other side of each half-edge, kInvalidIndex on boundary edges.
+    std::vector<uint32_t> startFaces; ///< Face where one-ring traversals of each vertex start, kInvalidIndex for unused vertices.
+    std::vector<uint8_t> boundary;    ///< Flag for each vertex on the boundary.
+    std::vector<uint8_t> regular;     ///< Flag for each regular vertex (valence 6 inside, valence 4 on the boundary).
+
+    uint32_t getVertexCount() const { return uint32_t(positions.size()); }
+    uint32_t getFaceCount() const { return uint32_t(indices.size() / 3); }
+
+    /// Get the corner of a face at the given vertex.
+    uint32_t corner(uint32_t face, uint32_t vertex) const
+    {
+        const uint32_t* v = &indices[3 * face];
+        FALCOR_ASSERT(v[0] == vertex || v[1] == vertex || v[2] == vertex);
+        return v[0] == vertex ? 0 : (v[1] == vertex ? 1 : 2);
+    }
+
+    uint32_t nextFace(uint32_t face, uint32_t vertex) const { return neighbors[3 * face + corner(face, vertex)]; }
+    uint32_t prevFace(uint32_t face, uint32_t vertex) const { return neighbors[3 * face + prev(corner(face, vertex))]; }
+    uint32_t nextVert(uint32_t face, uint32_t vertex) const { return indices[3 * face + next(corner(face, vertex))]; }
+    uint32_t prevVert(uint32_t face, uint32_t vertex) const { return indices[3 * face + prev(corner(face, vertex))]; }
+
+    /// Get the vertex of a face that is not on the edge v0-v1. Degenerate faces return v0.
+    uint32_t otherVert(uint32_t face, uint32_t v0, uint32_t v1) const
+    {
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            uint32_t v = indices[3 * face + k];
+            if (v != v0 && v != v1)
+                return v;
+        }
+        return v0;
+    }
+
+    uint32_t valence(uint32_t vertex) const
+    {
+        uint32_t startFace = startFaces[vertex];
+        uint32_t f = startFace;
+        if (!boundary[vertex])
+        {
+            // Compute valence of interior vertex.
+            uint32_t nf = 1;
+            while ((f = nextFace(f, vertex)) != startFace)
+                ++nf;
+            return nf;
+        }
+        else
+        {
+            // Compute valence of boundary vertex.
+            uint32_t nf = 1;
+            while ((f = nextFace(f, vertex)) != kInvalidIndex)
+                ++nf;
+            f = startFace;
+            while ((f = prevFace(f, vertex)) != kInvalidIndex)
+                ++nf;
+            return nf + 1;
+        }
+    }
+
+    /// Call a function for each vertex in the one-ring of a vertex. Boundary vertices start with the vertex on the last face.
+    template<typename F>
+    void forEachRingVertex(uint32_t vertex, F func) const
+    {
+        uint32_t face = startFaces[vertex];
+        if (!boundary[vertex])
+        {
+            // Get one-ring vertices for interior vertex.
+            do
+            {
+                func(nextVert(face, vertex));
+                face = nextFace(face, vertex);
+            } while (face != startFaces[vertex]);
+        }
+        else
+        {
+            // Get one-ring vertices for boundary vertex.
+            uint32_t f2;
+            while ((f2 = nextFace(face, vertex)) != kInvalidIndex)
+                face = f2;
+            func(nextVert(face, vertex));
+            do
+            {
+                func(prevVert(face, vertex));
+                face = prevFace(face, vertex);
+            } while (face != kInvalidIndex);
+        }
+    }
+
+    float3 weightOneRing(uint32_t vertex, float beta) const
+    {
+        uint32_t valence = this->valence(vertex);
+        float3 p = (1 - valence * beta) * positions[vertex];
+        forEachRingVertex(vertex, [&](uint32_t v) { p += beta * positions[v]; });
+        return p;
+    }
+
+    float3 weightBoundary(uint32_t vertex, float beta) const
+    {
+        float3 first;
+        float3 last;
+        uint32_t count = 0;
+        forEachRingVertex(
+            vertex,
+            [&](uint32_t v)
+            {
+                if (count++ == 0)
+                    first = positions[v];
+                last = positions[v];
+            }
+        );
+        float3 p = (1 - 2 * beta) * positions[vertex];
+        p += beta * first;
+        p += beta * last;
+        return p;
+    }
+};
+
+/**
+ * Get the half-edges sorted by edge key (the sorted vertex pair) and half-edge index.
+ * Half-edges of the same edge are adjacent in the returned list, in the order of the faces.
+ */
+std::vector<std::pair<uint64_t, uint32_t>> sortEdges(BS::thread_pool& threadPool, const std::vector<uint32_t>& indices)
+{
+    std::vector<std::pair<uint64_t, uint32_t>> edges(indices.size());
+    parallelFor(
+        threadPool,
+        uint32_t(indices.size()),
+        [&](uint32_t h)
+        {
+            uint32_t v0 = indices[h];
+            uint32_t v1 = indices[h - h % 3 + next(h % 3)];
+            edges[h] = {(uint64_t(std::min(v0, v1)) << 32) | std::max(v0, v1), h};
+        }
+    );
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+
+SubdivisionMesh createMesh(BS::thread_pool& threadPool, fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+{
+    SubdivisionMesh mesh;
+    const uint32_t vertexCount = uint32_t(positions.size());
+    const uint32_t faceCount = uint32_t(indices.size() / 3);
+    mesh.positions.assign(positions.begin(), positions.end());
+    mesh.indices.assign(indices.begin(), indices.begin() + 3 * faceCount);
+
+    // Set vertex to face pointers.
+    mesh.startFaces.resize(vertexCount, kInvalidIndex);
+    for (uint32_t h = 0; h < mesh.indices.size(); ++h)
+    {
+        FALCOR_CHECK(mesh.indices[h] < vertexCount, "Vertex index {} is out of range ({} vertices).", mesh.indices[h], vertexCount);
+        mesh.startFaces[mesh.indices[h]] = h / 3;
+    }
+
+    // Set neighbor pointers in faces. Half-edges of the same edge are paired in the order of their faces, a third face on a
+    // non-manifold edge starts a new pair.
+    mesh.neighbors.resize(mesh.indices.size(), kInvalidIndex);
+    auto edges = sortEdges(threadPool, mesh.indices);
+    for (size_t i = 0; i + 1 < edges.size(); ++i)
+    {
+        if (edges[i].first == edges[i + 1].first)
+        {
+            uint32_t h0 = edges[i].second;
+            uint32_t h1 = edges[i + 1].second;
+            mesh.neighbors[h0] = h1 / 3;
+            mesh.neighbors[h1] = h0 / 3;
+            ++i;
+        }
+    }
+
+    // Finish vertex initialization.
+    mesh.boundary.resize(vertexCount);
+    mesh.regular.resize(vertexCount);
+    parallelFor(
+        threadPool,
+        vertexCount,
+        [&](uint32_t v)
+        {
+            uint32_t startFace = mesh.startFaces[v];
+            if (startFace == kInvalidIndex)
+                return;
+            uint32_t f = startFace;
+            do
+            {
+                f = mesh.nextFace(f, v);
+            } while (f != kInvalidIndex && f != startFace);
+            mesh.boundary[v] = f == kInvalidIndex;
+            uint32_t valence = mesh.valence(v);
+            mesh.regular[v] = mesh.boundary[v] ? valence == 4 : valence == 6;
+        }
+    );
+
+    return mesh;
+}
+
+SubdivisionMesh subdivide(BS::thread_pool& threadPool, const SubdivisionMesh& mesh)
+{
+    const uint32_t vertexCount = mesh.getVertexCount();
+    const uint32_t faceCount = mesh.getFaceCount();
+    const uint32_t halfEdgeCount = 3 * faceCount;
+    FALCOR_CHECK(uint64_t(faceCount) * 12 <= std::numeric_limits<uint32_t>::max(), "Mesh is too large to subdivide further.");
+
+    // Find the first half-edge of each edge and number the new odd vertices in that order.
+    std::vector<uint32_t> firstHalfEdges(halfEdgeCount);
+    {
+        auto edges = sortEdges(threadPool, mesh.indices);
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            bool isFirst = i == 0 || edges[i].first != edges[i - 1].first;
+            firstHalfEdges[edges[i].second] = isFirst ? edges[i].second : firstHalfEdges[edges[i - 1].second];
+        }
+    }
+    std::vector<uint32_t> oddVertices(halfEdgeCount);
+    uint32_t newVertexCount = vertexCount;
+    for (uint32_t h = 0; h < halfEdgeCount; ++h)
+        oddVertices[h] = firstHalfEdges[h] == h ? newVertexCount++ : oddVertices[firstHalfEdges[h]];
+
+    SubdivisionMesh result;
+    result.positions.resize(newVertexCount);
+    result.indices.resize(4 * halfEdgeCount);
+    result.neighbors.resize(4 * halfEdgeCount);
+    result.startFaces.resize(newVertexCount);
+    result.boundary.resize(newVertexCount);
+    result.regular.resize(newVertexCount);
+
+    // Update vertex positions for even vertices. Children of faces are stored at index 4 * face + k.
+    parallelFor(
+        threadPool,
+        vertexCount,
+        [&](uint32_t v)
+        {
+            uint32_t startFace = mesh.startFaces[v];
+            result.boundary[v] = mesh.boundary[v];
+            result.regular[v] = mesh.regular[v];
+            if (startFace == kInvalidIndex)
+            {
+                result.positions[v] = mesh.positions[v];
+                result.startFaces[v] = kInvalidIndex;
+                return;
+            }
+
+            if (!mesh.boundary[v])
+            {
+                // Apply one-ring rule for even vertex.
+                if (mesh.regular[v])
+                    result.positions[v] = mesh.weightOneRing(v, 1.f / 16.f);
+                else
+                    result.positions[v] = mesh.weightOneRing(v, beta(mesh.valence(v)));
+            }
+            else
+            {
+                // Apply boundary rule for even vertex.
+                result.positions[v] = mesh.weightBoundary(v, 1.f / 8.f);
+            }
+            result.startFaces[v] = 4 * startFace + mesh.corner(startFace, v);
+        }
+    );
+
+    // Compute new odd edge vertices.
+    parallelFor(
+        threadPool,
+        halfEdgeCount,
+        [&](uint32_t h)
+        {
+            if (firstHalfEdges[h] != h)
+                return;
+
+            uint32_t face = h / 3;
+            uint32_t v0 = mesh.indices[h];
+            uint32_t v1 = mesh.indices[3 * face + next(h % 3)];
+            uint32_t neighbor = mesh.neighbors[h];
+            uint32_t vert = oddVertices[h];
+            result.regular[vert] = true;
+            result.boundary[vert] = neighbor == kInvalidIndex;
+            result.startFaces[vert] = 4 * face + 3;
+
+            // Apply edge rules to compute new vertex position.
+            float3& p = result.positions[vert];
+            if (result.boundary[vert])
+            {
+                p = 0.5f * mesh.positions[v0];
+                p += 0.5f * mesh.positions[v1];
+            }
+            else
+            {
+                p = 3.f / 8.f * mesh.positions[v0];
+                p += 3.f / 8.f * mesh.positions[v1];
+                p += 1.f / 8.f * mesh.positions[mesh.otherVert(face, v0, v1)];
+                p += 1.f / 8.f * mesh.positions[mesh.otherVert(neighbor, v0, v1)];
+            }
+        }
+    );
+
+    // Update new mesh topology. Child k < 3 of a face is at its vertex k, child 3 is in the center.
+    parallelFor(
+        threadPool,
+        faceCount,
+        [&](uint32_t face)
+        {
+            const uint32_t* v = &mesh.indices[3 * face];
+            const uint32_t* odd = &oddVertices[3 * face];
+            uint32_t* childIndices = &result.indices[12 * face];
+            uint32_t* childNeighbors = &result.neighbors[12 * face];
+            for (uint32_t j = 0; j < 3; ++j)
+            {
+                // Update child vertex indices.
+                childIndices[3 * j + j] = v[j];
+                childIndices[3 * j + next(j)] = odd[j];
+                childIndices[3 * j + prev(j)] = odd[prev(j)];
+                childIndices[9 + j] = odd[j];
+
+                // Update children neighbors for siblings.
+                childNeighbors[9 + j] = 4 * face + next(j);
+                childNeighbors[3 * j + next(j)] = 4 * face + 3;
+
+                // Update children neighbors for neighbor children.
+                uint32_t f2 = mesh.neighbors[3 * face + j];
+                childNeighbors[3 * j + j] = f2 != kInvalidIndex ? 4 * f2 + mesh.corner(f2, v[j]) : kInvalidIndex;
+                f2 = mesh.neighbors[3 * face + prev(j)];
+                childNeighbors[3 * j + prev(j)] = f2 != kInvalidIndex ? 4 * f2 + mesh.corner(f2, v[j]) : kInvalidIndex;
+            }
+        }
+    );
+
+    return result;
+}
+} // namespace
+
+LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+{
+    BS::thread_pool threadPool;
+    SubdivisionMesh mesh = createMesh(threadPool, positions, indices);
+
+    // Refine mesh level by level.
+    for (uint32_t i = 0; i < levels; ++i)
+        mesh = subdivide(threadPool, mesh);
+
+    // Push vertices to limit surface.
+    const uint32_t vertexCount = mesh.getVertexCount();
+    std::vector<float3> pLimit(vertexCount);
+    parallelFor(
+        threadPool,
+        vertexCount,
+        [&](uint32_t v)
+        {
+            if (mesh.startFaces[v] == kInvalidIndex)
+                pLimit[v] = mesh.positions[v];
+            else if (mesh.boundary[v])
+                pLimit[v] = mesh.weightBoundary(v, 1.f / 5.f);
+            else
+                pLimit[v] = mesh.weightOneRing(v, loopGamma(mesh.valence(v)));
+        }
+    );
+    mesh.positions = std::move(pLimit);
+
+    // Compute vertex tangents on limit surface.
+    std::vector<float3> Ns(vertexCount);
+    parallelFor(
+        threadPool,
+        vertexCount,
+        [&](uint32_t v)
+        {
+            if (mesh.startFaces[v] == kInvalidIndex)
+            {
+                Ns[v] = float3(0.f);
+                return;
+            }
+
+            float3 S(0.f);
+            float3 T(0.f);
+            const float3 p = mesh.positions[v];
+            uint32_t valence = mesh.valence(v);
+            if (!mesh.boundary[v])
+            {
+                // Compute tangents of interior face
+                uint32_t j = 0;
+                mesh.forEachRingVertex(
+                    v,
+                    [&](uint32_t r)
+                    {
+                        S += std::cos(2.f * float(M_PI) * j / valence) * mesh.positions[r];
+                        T += std::sin(2.f * float(M_PI) * j / valence) * mesh.positions[r];
+                        ++j;
+                    }
+                );
+            }
+            else
+            {
+                // Compute tangents of boundary face
+                float3 pRing[4];
+                float3 pLast;
+                uint32_t count = 0;
+                mesh.forEachRingVertex(
+                    v,
+                    [&](uint32_t r)
+                    {
+                        if (count < 4)
+                            pRing[count] = mesh.positions[r];
+                        pLast = mesh.positions[r];
+                        ++count;
+                    }
+                );
+
+                S = pLast - pRing[0];
+                if (valence == 2)
+                {
+                    T = float3(pRing[0] + pRing[1] - 2.f * p);
+                }
+                else if (valence == 3)
+                {
+                    T = pRing[1] - p;
+                }
+                else if (valence == 4) // regular
+                {
+                    T = float3(-1.f * pRing[0] + 2.f * pRing[1] + 2.f * pRing[2] + -1.f * pRing[3] + -2.f * p);
+                }
+                else
+                {
+                    float theta = float(M_PI) / float(valence - 1);
+                    T = float3(std::sin(theta) * (pRing[0] + pLast));
+                    uint32_t k = 0;
+                    mesh.forEachRingVertex(
+                        v,
+                        [&](uint32_t r)
+                        {
+                            if (k > 0 && k < valence - 1)
+                            {
+                                float wt = (2 * std::cos(theta) - 2) * std::sin((k)*theta);
+                                T += float3(wt * mesh.positions[r]);
+                            }
+                            ++k;
+                        }
+                    );
+                    T = -T;
+                }
+            }
+            Ns[v] = cross(S, T);
+        }
+    );
+
+    LoopSubdivideResult result;
+    result.positions = std::move(mesh.positions);
+    result.normals = std::move(Ns);
+    result.indices = std::move(mesh.indices);
+    return result;
+}
+} // namespace Falcor
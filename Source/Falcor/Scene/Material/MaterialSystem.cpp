@@ -28,11 +28,16 @@
 #include "MaterialSystem.h"
 #include "StandardMaterial.h"
 #include "Core/API/Device.h"
+#include "Core/API/RenderContext.h"
+#include "Utils/CryptoUtils.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
 #include "MaterialTypeRegistry.h"
 #include "Scene/Lights/LightProfile.h"
+#include <BS_thread_pool/BS_thread_pool.hpp>
+#include <map>
 #include <numeric>
+#include <tuple>
 
 namespace Falcor
 {
@@ -50,6 +55,102 @@ namespace Falcor
         const size_t kMaxTextureCount = 1ull << TextureHandle::kTextureIDBits;
         const size_t kMaxBufferCountPerMaterial = 1; // This is a conservative estimation of how many buffer descriptors to allocate per material. Most materials don't use any auxiliary data buffers.
 
+        // Max amount of texel data read back from the GPU in one batch while searching for duplicate textures.
+        const uint64_t kMaxDeduplicationBytesInFlight = 1ull << 30;
+
+        /** Find textures with identical content.
+            Texel data is read back from the GPU and hashed on worker threads. Only textures that share
+            type, format and dimensions with at least one other texture can be duplicates and are read back.
+            \param[in] pRenderContext Render context used for readback.
+            \param[in] textures List of unique textures.
+            \return For each texture, the index of the first texture with identical content.
+        */
+        std::vector<size_t> findDuplicateTextures(RenderContext* pRenderContext, const std::vector<ref<Texture>>& textures)
+        {
+            std::vector<size_t> duplicateOf(textures.size());
+            std::iota(duplicateOf.begin(), duplicateOf.end(), 0);
+
+            using Layout = std::tuple<Resource::Type, ResourceFormat, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t>;
+            std::map<Layout, std::vector<size_t>> layouts;
+            for (size_t i = 0; i < textures.size(); i++)
+            {
+                const auto& pTexture = textures[i];
+                Layout layout = {
+                    pTexture->getType(), pTexture->getFormat(), pTexture->getWidth(), pTexture->getHeight(),
+                    pTexture->getDepth(), pTexture->getArraySize(), pTexture->getMipCount() };
+                layouts[layout].push_back(i);
+            }
+
+            std::vector<size_t> candidates;
+            for (const auto& [layout, indices] : layouts)
+            {
+                if (indices.size() > 1) candidates.insert(candidates.end(), indices.begin(), indices.end());
+            }
+            if (candidates.empty()) return duplicateOf;
+
+            // Read back all subresources on the calling thread and hash them on worker threads. The readbacks of a batch of
+            // textures are all issued before any of them is collected, so the copies overlap instead of each texture waiting
+            // for its own GPU round trip. The batch size bounds the memory held in staging buffers and read back data.
+            struct Readback
+            {
+                size_t index;
+                std::vector<CopyContext::ReadTextureTask::SharedPtr> tasks;
+            };
+            std::vector<SHA1::MD> digests(textures.size());
+            BS::thread_pool threadPool;
+
+            for (size_t next = 0; next < candidates.size();)
+            {
+                std::vector<Readback> batch;
+                uint64_t batchBytes = 0;
+                while (next < candidates.size() && (batch.empty() || batchBytes < kMaxDeduplicationBytesInFlight))
+                {
+                    const size_t i = candidates[next++];
+                    const Texture* pTexture = textures[i].get();
+                    Readback& readback = batch.emplace_back();
+                    readback.index = i;
+                    for (uint32_t subresource = 0; subresource < pTexture->getSubresourceCount(); subresource++)
+                    {
+                        readback.tasks.push_back(pRenderContext->asyncReadTextureSubresource(pTexture, subresource));
+                    }
+                    batchBytes += pTexture->getTextureSizeInBytes();
+                }
+
+                for (auto& readback : batch)
+                {
+                    auto pData = std::make_shared<std::vector<std::vector<uint8_t>>>();
+                    for (const auto& pTask : readback.tasks) pData->push_back(pTask->getData());
+                    // Release the staging buffers as soon as their data is copied out.
+                    readback.tasks.clear();
+
+                    threadPool.push_task([&digests, i = readback.index, pData]()
+                    {
+                        SHA1 sha1;
+                        for (const auto& data : *pData) sha1.update(data.data(), data.size());
+                        digests[i] = sha1.finalize();
+                    });
+                }
+                threadPool.wait_for_tasks();
+            }
+
+            for (const auto& [layout, indices] : layouts)
+            {
+                for (size_t j = 1; j < indices.size(); j++)
+                {
+                    for (size_t k = 0; k < j; k++)
+                    {
+                        if (duplicateOf[indices[k]] == indices[k] && digests[indices[k]] == digests[indices[j]])
+                        {
+                            duplicateOf[indices[j]] = indices[k];
+                            break;
+                        }
+                    }
+                }
+            }
+
+            return duplicateOf;
+        }
+
         // Helper to check if a material is a standard material using the SpecGloss shading model.
         // We keep track of these as an optimization because most scenes do not use this shading model.
         bool isSpecGloss(const ref<Material>& pMaterial)
@@ -401,19 +502,63 @@ namespace Falcor
 
         if (textures.empty()) return;
 
-        // Analyze the textures.
-        logInfo("Analyzing {} material textures.", textures.size());
-
         RenderContext* pRenderContext = mpDevice->getRenderContext();
 
+        // Build the list of unique texture resources. Textures are often shared between materials.
+        std::vector<ref<Texture>> uniqueTextures;
+        std::vector<size_t> textureIndices(textures.size());
+        {
+            std::map<const Texture*, size_t> textureToIndex;
+            for (size_t i = 0; i < textures.size(); i++)
+            {
+                auto [it, inserted] = textureToIndex.emplace(textures[i].get(), uniqueTextures.size());
+                if (inserted) uniqueTextures.push_back(textures[i]);
+                textureIndices[i] = it->second;
+            }
+        }
+
+        // Merge textures with identical content, e.g. the same image loaded from different files.
+        logInfo("Searching {} material textures for duplicates.", uniqueTextures.size());
+        std::vector<size_t> duplicateOf = findDuplicateTextures(pRenderContext, uniqueTextures);
+
+        size_t mergedCount = 0;
+        uint64_t mergedBytes = 0;
+        for (size_t i = 0; i < uniqueTextures.size(); i++)
+        {
+            if (duplicateOf[i] == i) continue;
+            mergedCount++;
+            mergedBytes += uniqueTextures[i]->getTextureSizeInBytes();
+        }
+        for (size_t i = 0; i < textures.size(); i++)
+        {
+            size_t index = duplicateOf[textureIndices[i]];
+            if (index == textureIndices[i]) continue;
+            const auto& [pMaterial, slot] = materialSlots[i];
+            pMaterial->setTexture(slot, uniqueTextures[index]);
+            textureIndices[i] = index;
+        }
+        if (mergedCount > 0) logInfo("Optimized materials by merging {} duplicate textures ({}).", mergedCount, formatByteSize(mergedBytes));
+
+        // Analyze the remaining textures. Each texture is analyzed once, regardless of the number of materials using it.
+        std::vector<ref<Texture>> analyzedTextures;
+        std::vector<size_t> resultIndices(uniqueTextures.size(), 0);
+        for (size_t i = 0; i < uniqueTextures.size(); i++)
+        {
+            if (duplicateOf[i] != i) continue;
+            resultIndices[i] = analyzedTextures.size();
+            analyzedTextures.push_back(uniqueTextures[i]);
+        }
+
+        logInfo("Analyzing {} material textures.", analyzedTextures.size());
+
         TextureAnalyzer analyzer(mpDevice);
-        auto pResults = mpDevice->createBuffer(textures.size() * TextureAnalyzer::getResultSize(), ResourceBindFlags::UnorderedAccess);
-        analyzer.analyze(pRenderContext, textures, pResults);
+        auto pResults = mpDevice->createBuffer(analyzedTextures.size() * TextureAnalyzer::getResultSize(), ResourceBindFlags::UnorderedAccess);
+        analyzer.analyze(pRenderContext, analyzedTextures, pResults);
 
         // Copy result to staging buffer for readback.
         // This is mostly to avoid a full flush and the associated perf warning.
         // We do not have any other useful GPU work, but unrelated GPU tasks can be in flight.
-        auto pResultsStaging = mpDevice->createBuffer(textures.size() * TextureAnalyzer::getResultSize(), ResourceBindFlags::None, MemoryType::ReadBack);
+        auto pResultsStaging = mpDevice->createBuffer(analyzedTextures.size() * TextureAnalyzer::getResultSize(), ResourceBindFlags::None, MemoryType::ReadBack);
         pRenderContext->copyResource(pResultsStaging.get(), pResults.get());
         pRenderContext->submit(false);
         pRenderContext->signal(mpFence.get());
@@ -425,7 +570,7 @@ namespace Falcor
 
         for (size_t i = 0; i < textures.size(); i++)
         {
-            materialSlots[i].first->optimizeTexture(materialSlots[i].second, results[i], stats);
+            materialSlots[i].first->optimizeTexture(materialSlots[i].second, results[resultIndices[textureIndices[i]]], stats);
         }
 
         pResultsStaging->unmap();
@@ -443,6 +588,29 @@ namespace Falcor
         if (stats.disabledAlpha > 0) logInfo("Optimized materials by disabling alpha test for {} materials.", stats.disabledAlpha);
         if (stats.constantBaseColor > 0) logWarning("Materials have {} base color maps of constant value with non-constant alpha channel.", stats.constantBaseColor);
         if (stats.constantNormalMaps > 0) logWarning("Materials have {} normal maps of constant value. Please update the asset to optimize performance.", stats.constantNormalMaps);
+
+        // Release textures that are no longer referenced by any material, such as merged duplicates and textures
+        // folded into material constants in all materials sharing them (e.g. channel-packed textures).
+        std::set<const Texture*> referencedTextures;
+        for (const auto& [pMaterial, slot] : materialSlots)
+        {
+            if (auto pTexture = pMaterial->getTexture(slot)) referencedTextures.insert(pTexture.get());
+        }
+
+        size_t releasedCount = 0;
+        uint64_t releasedBytes = 0;
+        for (const auto& pTexture : uniqueTextures)
+        {
+            if (referencedTextures.count(pTexture.get()) > 0) continue;
+            releasedCount++;
+            releasedBytes += pTexture->getTextureSizeInBytes();
+            mpTextureManager->removeTexture(pTexture);
+        }
+
+        if (releasedCount > 0)
+        {
+            logInfo("Optimized materials by releasing {} of {} textures ({} saved).", releasedCount, uniqueTextures.size(), formatByteSize(releasedBytes));
+        }
     }
 
     Material::UpdateFlags MaterialSystem::update(bool forceUpdate)
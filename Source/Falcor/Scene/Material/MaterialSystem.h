@@ -240,7 +240,8 @@ namespace Falcor
         size_t removeDuplicateMaterials(std::vector<MaterialID>& idMap);
 
         /** Optimize materials.
-            This function analyzes textures and replaces constant textures by uniform material parameters.
+            This function merges textures with identical content, analyzes textures and replaces constant textures
+            by uniform material parameters. Textures that are no longer referenced are released from the texture manager.
         */
         void optimizeMaterials();
 
@@ -51,6 +51,8 @@ namespace Falcor
         }
 
         bool srgb = mUseSrgb && pMaterial->getTextureSlotInfo(slot).srgb;
+        // Only normal map slots have their mips renormalized, other data textures are filtered as is.
+        Bitmap::ImportFlags importFlags = slot == Material::TextureSlot::Normal ? Bitmap::ImportFlags::NormalMap : Bitmap::ImportFlags::None;
 
         // Request texture to be loaded.
         auto handle = mTextureManager.loadTexture(
@@ -59,7 +61,7 @@ namespace Falcor
             srgb,
             ResourceBindFlags::ShaderResource,
             true /*async*/,
-            Bitmap::ImportFlags::None,
+            importFlags,
             nullptr /*search dirs*/,
             nullptr /*load count*/,
             pMaterial.get()
@@ -0,0 +1,61 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshInstanceTable.h"
+#include "Core/Error.h"
+
+namespace Falcor
+{
+uint32_t MeshInstanceTable::addDefinition(std::string name, std::vector<MeshID> meshIDs, uint64_t triangleCount)
+{
+    uint32_t definitionIndex = uint32_t(mDefinitions.size());
+    mDefinitions.push_back({std::move(name), std::move(meshIDs), triangleCount, {}});
+    return definitionIndex;
+}
+
+void MeshInstanceTable::addInstance(uint32_t definitionIndex, const float4x4& transform)
+{
+    FALCOR_CHECK(definitionIndex < mDefinitions.size(), "'definitionIndex' ({}) is out of range", definitionIndex);
+    mDefinitions[definitionIndex].transforms.emplace_back(transform);
+    mInstanceCount++;
+}
+
+MeshInstanceTable::Stats MeshInstanceTable::getStats() const
+{
+    Stats stats;
+    stats.definitionCount = mDefinitions.size();
+    stats.instanceCount = mInstanceCount;
+    for (const auto& definition : mDefinitions)
+    {
+        stats.meshCount += definition.meshIDs.size();
+        stats.uniqueTriangleCount += definition.triangleCount;
+        stats.instancedTriangleCount += definition.triangleCount * definition.transforms.size();
+        stats.transformMemoryInBytes += definition.transforms.size() * sizeof(float3x4);
+    }
+    return stats;
+}
+} // namespace Falcor
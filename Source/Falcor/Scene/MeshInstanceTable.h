@@ -0,0 +1,94 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SceneIDs.h"
+#include "Core/Macros.h"
+#include "Utils/Math/Matrix.h"
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Compact list of object instances, filled by importers of formats with object instancing
+ * (e.g. PBRT ObjectBegin/ObjectInstance or Mitsuba shapegroup/instance).
+ *
+ * An object definition is a group of meshes that were added to the scene builder in the space of the instances.
+ * Instances only store an affine 3x4 transform in a flat array per definition. SceneBuilder::addMeshInstances() adds one
+ * scene graph node per instance with all meshes of the definition attached. The meshes of a definition thereby share their
+ * instances and end up in a single mesh group (BLAS), and their data is never duplicated by flattening instances.
+ */
+class FALCOR_API MeshInstanceTable
+{
+public:
+    struct Definition
+    {
+        std::string name;                 ///< Name of the definition, used as name of the instance nodes.
+        std::vector<MeshID> meshIDs;      ///< Meshes of the definition.
+        uint64_t triangleCount = 0;       ///< Total number of triangles in the meshes.
+        std::vector<float3x4> transforms; ///< Instance transforms.
+    };
+
+    struct Stats
+    {
+        uint64_t definitionCount = 0;        ///< Number of object definitions.
+        uint64_t meshCount = 0;              ///< Number of meshes in all definitions.
+        uint64_t instanceCount = 0;          ///< Number of instances.
+        uint64_t uniqueTriangleCount = 0;    ///< Number of triangles in all definitions.
+        uint64_t instancedTriangleCount = 0; ///< Number of triangles in all instances.
+        uint64_t transformMemoryInBytes = 0; ///< Memory used to store the instance transforms.
+    };
+
+    /**
+     * Add an object definition.
+     * @param[in] name Name of the definition.
+     * @param[in] meshIDs Meshes of the definition.
+     * @param[in] triangleCount Total number of triangles in the meshes.
+     * @return Returns the index of the definition.
+     */
+    uint32_t addDefinition(std::string name, std::vector<MeshID> meshIDs, uint64_t triangleCount);
+
+    /**
+     * Add an instance of an object definition.
+     * @param[in] definitionIndex Index of the definition returned by addDefinition().
+     * @param[in] transform Instance transform. The transform is expected to be affine, the last row is dropped.
+     */
+    void addInstance(uint32_t definitionIndex, const float4x4& transform);
+
+    const std::vector<Definition>& getDefinitions() const { return mDefinitions; }
+
+    /// Returns true if there are no instances.
+    bool empty() const { return mInstanceCount == 0; }
+
+    Stats getStats() const;
+
+private:
+    std::vector<Definition> mDefinitions;
+    uint64_t mInstanceCount = 0;
+};
+} // namespace Falcor
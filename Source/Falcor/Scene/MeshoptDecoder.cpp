@@ -0,0 +1,450 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshoptDecoder.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Falcor
+{
+
+namespace
+{
+// Bitstream constants, see the EXT_meshopt_compression specification.
+constexpr uint8_t kVertexHeader = 0xa0;
+constexpr uint8_t kIndexHeader = 0xe0;
+constexpr uint8_t kSequenceHeader = 0xd0;
+
+constexpr size_t kByteGroupSize = 16;
+constexpr size_t kVertexBlockSizeBytes = 8192;
+constexpr size_t kVertexBlockMaxSize = 256;
+constexpr size_t kTailMaxSize = 32;
+constexpr size_t kMaxVertexSize = 256;
+
+size_t getVertexBlockSize(size_t vertexSize)
+{
+    size_t result = (kVertexBlockSizeBytes / vertexSize) & ~(kByteGroupSize - 1);
+    return std::min(result, kVertexBlockMaxSize);
+}
+
+uint8_t unzigzag8(uint8_t v)
+{
+    return uint8_t(-(v & 1) ^ (v >> 1));
+}
+
+/// Decode a group of 16 bytes stored with 0, 2, 4 or 8 bits per byte.
+const uint8_t* decodeBytesGroup(const uint8_t* data, const uint8_t* end, uint8_t* out, uint32_t bitslog2)
+{
+    switch (bitslog2)
+    {
+    case 0:
+        std::memset(out, 0, kByteGroupSize);
+        return data;
+    case 1:
+    case 2:
+    {
+        // Values are packed MSB first. The all-ones value is a sentinel for a full byte stored after the packed values.
+        const uint32_t bits = 1u << bitslog2;
+        const size_t packedSize = kByteGroupSize * bits / 8;
+        FALCOR_CHECK(size_t(end - data) >= packedSize, "Vertex data is truncated.");
+        const uint8_t* extra = data + packedSize;
+        const uint32_t sentinel = (1u << bits) - 1;
+        for (uint32_t i = 0; i < kByteGroupSize; i++)
+        {
+            uint32_t bitOffset = i * bits;
+            uint32_t v = (data[bitOffset / 8] >> (8 - bits - bitOffset % 8)) & sentinel;
+            if (v == sentinel)
+            {
+                FALCOR_CHECK(extra < end, "Vertex data is truncated.");
+                v = *extra++;
+            }
+            out[i] = uint8_t(v);
+        }
+        return extra;
+    }
+    default:
+        FALCOR_CHECK(size_t(end - data) >= kByteGroupSize, "Vertex data is truncated.");
+        std::memcpy(out, data, kByteGroupSize);
+        return data + kByteGroupSize;
+    }
+}
+
+/// Decode a run of byte groups preceded by their 2-bit modes.
+const uint8_t* decodeBytes(const uint8_t* data, const uint8_t* end, uint8_t* out, size_t size)
+{
+    const size_t groupCount = size / kByteGroupSize;
+    const size_t headerSize = (groupCount + 3) / 4;
+    FALCOR_CHECK(size_t(end - data) >= headerSize, "Vertex data is truncated.");
+
+    const uint8_t* header = data;
+    data += headerSize;
+    for (size_t group = 0; group < groupCount; group++)
+    {
+        uint32_t bitslog2 = (header[group / 4] >> ((group % 4) * 2)) & 3;
+        data = decodeBytesGroup(data, end, out + group * kByteGroupSize, bitslog2);
+    }
+    return data;
+}
+
+const uint8_t* decodeVertexBlock(
+    const uint8_t* data,
+    const uint8_t* end,
+    uint8_t* dst,
+    size_t count,
+    size_t stride,
+    uint8_t* lastVertex
+)
+{
+    uint8_t buffer[kVertexBlockMaxSize];
+    uint8_t transposed[kVertexBlockSizeBytes];
+    const size_t alignedCount = (count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+    // Each byte of the vertex is stored as a separate stream of deltas against the previous vertex.
+    for (size_t k = 0; k < stride; k++)
+    {
+        data = decodeBytes(data, end, buffer, alignedCount);
+
+        uint8_t p = lastVertex[k];
+        for (size_t i = 0; i < count; i++)
+        {
+            p = uint8_t(unzigzag8(buffer[i]) + p);
+            transposed[i * stride + k] = p;
+        }
+    }
+
+    std::memcpy(dst, transposed, count * stride);
+    std::memcpy(lastVertex, transposed + (count - 1) * stride, stride);
+    return data;
+}
+
+uint32_t decodeVByte(const uint8_t*& data)
+{
+    uint8_t lead = *data++;
+    if (lead < 128)
+        return lead;
+
+    uint32_t result = lead & 127;
+    uint32_t shift = 7;
+    for (int i = 0; i < 4; i++)
+    {
+        uint8_t group = *data++;
+        result |= uint32_t(group & 127) << shift;
+        shift += 7;
+        if (group < 128)
+            break;
+    }
+    return result;
+}
+
+uint32_t decodeIndex(const uint8_t*& data, uint32_t last)
+{
+    uint32_t v = decodeVByte(data);
+    uint32_t d = (v >> 1) ^ -int32_t(v & 1);
+    return last + d;
+}
+
+void writeIndex(void* dst, size_t i, size_t indexSize, uint32_t value)
+{
+    if (indexSize == 2)
+        static_cast<uint16_t*>(dst)[i] = uint16_t(value);
+    else
+        static_cast<uint32_t*>(dst)[i] = value;
+}
+
+template<typename T>
+void decodeOctFilter(T* data, size_t count)
+{
+    const float maxValue = float((1 << (sizeof(T) * 8 - 1)) - 1);
+    for (size_t i = 0; i < count; i++)
+    {
+        // The third component stores the encoding of 1.0, reconstruct z from it.
+        float x = float(data[i * 4 + 0]);
+        float y = float(data[i * 4 + 1]);
+        float z = float(data[i * 4 + 2]) - std::fabs(x) - std::fabs(y);
+
+        // Unfold the lower hemisphere.
+        float t = std::min(z, 0.f);
+        x += x >= 0.f ? t : -t;
+        y += y >= 0.f ? t : -t;
+
+        float s = maxValue / std::sqrt(x * x + y * y + z * z);
+        data[i * 4 + 0] = T(int(x * s + (x >= 0.f ? 0.5f : -0.5f)));
+        data[i * 4 + 1] = T(int(y * s + (y >= 0.f ? 0.5f : -0.5f)));
+        data[i * 4 + 2] = T(int(z * s + (z >= 0.f ? 0.5f : -0.5f)));
+    }
+}
+
+void decodeQuatFilter(int16_t* data, size_t count)
+{
+    const float scale = 1.f / std::sqrt(2.f);
+    for (size_t i = 0; i < count; i++)
+    {
+        // The low two bits of the fourth component store the index of the omitted (largest) component, the rest stores the scale.
+        int sf = data[i * 4 + 3] | 3;
+        float ss = scale / float(sf);
+
+        float x = float(data[i * 4 + 0]) * ss;
+        float y = float(data[i * 4 + 1]) * ss;
+        float z = float(data[i * 4 + 2]) * ss;
+        float w = std::sqrt(std::max(1.f - x * x - y * y - z * z, 0.f));
+
+        int qc = data[i * 4 + 3] & 3;
+        data[i * 4 + ((qc + 1) & 3)] = int16_t(int(x * 32767.f + (x >= 0.f ? 0.5f : -0.5f)));
+        data[i * 4 + ((qc + 2) & 3)] = int16_t(int(y * 32767.f + (y >= 0.f ? 0.5f : -0.5f)));
+        data[i * 4 + ((qc + 3) & 3)] = int16_t(int(z * 32767.f + (z >= 0.f ? 0.5f : -0.5f)));
+        data[i * 4 + ((qc + 0) & 3)] = int16_t(int(w * 32767.f + 0.5f));
+    }
+}
+
+void decodeExpFilter(uint32_t* data, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        // 24-bit signed mantissa and 8-bit signed exponent.
+        uint32_t v = data[i];
+        int32_t m = int32_t(v << 8) >> 8;
+        int32_t e = int32_t(v) >> 24;
+        float f = std::ldexp(float(m), e);
+        std::memcpy(&data[i], &f, sizeof(float));
+    }
+}
+} // namespace
+
+void decodeMeshoptVertexBuffer(void* dst, size_t count, size_t stride, const uint8_t* src, size_t srcSize)
+{
+    FALCOR_CHECK(stride > 0 && stride <= kMaxVertexSize && stride % 4 == 0, "Invalid vertex stride {}.", stride);
+    FALCOR_CHECK(srcSize >= 1 + stride, "Vertex data is truncated.");
+    FALCOR_CHECK((src[0] & 0xf0) == kVertexHeader && (src[0] & 0x0f) == 0, "Invalid vertex data header 0x{:02x}.", src[0]);
+
+    const uint8_t* data = src + 1;
+    const uint8_t* end = src + srcSize;
+
+    // The stream ends with the first vertex, which is the base for the deltas of the first block.
+    uint8_t lastVertex[kMaxVertexSize];
+    std::memcpy(lastVertex, end - stride, stride);
+
+    const size_t blockSize = getVertexBlockSize(stride);
+    for (size_t offset = 0; offset < count; offset += blockSize)
+    {
+        size_t blockCount = std::min(blockSize, count - offset);
+        data = decodeVertexBlock(data, end, static_cast<uint8_t*>(dst) + offset * stride, blockCount, stride, lastVertex);
+    }
+
+    const size_t tailSize = std::max(stride, kTailMaxSize);
+    FALCOR_CHECK(size_t(end - data) == tailSize, "Vertex data size does not match the vertex count.");
+}
+
+void decodeMeshoptIndexBuffer(void* dst, size_t count, size_t indexSize, const uint8_t* src, size_t srcSize)
+{
+    FALCOR_CHECK(count % 3 == 0, "Index count must be a multiple of 3, got {}.", count);
+    FALCOR_CHECK(indexSize == 2 || indexSize == 4, "Invalid index size {}.", indexSize);
+    FALCOR_CHECK(srcSize >= 1 + count / 3 + 16, "Index data is truncated.");
+    FALCOR_CHECK((src[0] & 0xf0) == kIndexHeader && (src[0] & 0x0f) <= 1, "Invalid index data header 0x{:02x}.", src[0]);
+    const uint32_t version = src[0] & 0x0f;
+
+    // Triangles are encoded against a FIFO of recently seen edges and vertices. The FIFO updates below must match the encoder exactly.
+    uint32_t edgeFifo[16][2];
+    uint32_t vertexFifo[16];
+    std::memset(edgeFifo, -1, sizeof(edgeFifo));
+    std::memset(vertexFifo, -1, sizeof(vertexFifo));
+    size_t edgeOffset = 0;
+    size_t vertexOffset = 0;
+
+    auto pushEdge = [&](uint32_t a, uint32_t b)
+    {
+        edgeFifo[edgeOffset][0] = a;
+        edgeFifo[edgeOffset][1] = b;
+        edgeOffset = (edgeOffset + 1) & 15;
+    };
+    auto pushVertex = [&](uint32_t v, bool cond = true)
+    {
+        vertexFifo[vertexOffset] = v;
+        vertexOffset = (vertexOffset + cond) & 15;
+    };
+
+    uint32_t next = 0;
+    uint32_t last = 0;
+    const int fecmax = version >= 1 ? 13 : 15;
+
+    // One code byte per triangle, followed by the variable length data and a 16 byte lookup table at the end.
+    const uint8_t* code = src + 1;
+    const uint8_t* data = code + count / 3;
+    const uint8_t* dataSafeEnd = src + srcSize - 16;
+    const uint8_t* codeauxTable = dataSafeEnd;
+
+    for (size_t i = 0; i < count; i += 3)
+    {
+        // A triangle reads at most 16 bytes of data, which the lookup table guarantees to be readable.
+        FALCOR_CHECK(data <= dataSafeEnd, "Index data is truncated.");
+
+        uint8_t codetri = *code++;
+        uint32_t a, b, c;
+        if (codetri < 0xf0)
+        {
+            // Triangle shares an edge with a recent triangle.
+            int fe = codetri >> 4;
+            a = edgeFifo[(edgeOffset - 1 - fe) & 15][0];
+            b = edgeFifo[(edgeOffset - 1 - fe) & 15][1];
+
+            int fec = codetri & 15;
+            if (fec < fecmax)
+            {
+                c = fec == 0 ? next++ : vertexFifo[(vertexOffset - 1 - fec) & 15];
+                pushVertex(c, fec == 0);
+            }
+            else
+            {
+                // Free vertex, delta encoded against the last free vertex. Codes 13 and 14 decode to -1 and +1.
+                c = last = fec != 15 ? last + (fec - (fec ^ 3)) : decodeIndex(data, last);
+                pushVertex(c);
+            }
+            pushEdge(c, b);
+            pushEdge(a, c);
+        }
+        else
+        {
+            int fea, feb, fec;
+            if (codetri < 0xfe)
+            {
+                // Codes from the lookup table never contain free vertices.
+                uint8_t codeaux = codeauxTable[codetri & 15];
+                fea = 0;
+                feb = codeaux >> 4;
+                fec = codeaux & 15;
+            }
+            else
+            {
+                uint8_t codeaux = *data++;
+                fea = codetri == 0xfe ? 0 : 15;
+                feb = codeaux >> 4;
+                fec = codeaux & 15;
+                // A zero aux code restarts the vertex numbering.
+                if (codeaux == 0)
+                    next = 0;
+            }
+
+            // Note that next is incremented for all three vertices before decoding free indices to match the encoder.
+            a = fea == 0 ? next++ : 0;
+            b = feb == 0 ? next++ : vertexFifo[(vertexOffset - feb) & 15];
+            c = fec == 0 ? next++ : vertexFifo[(vertexOffset - fec) & 15];
+            if (fea == 15)
+                last = a = decodeIndex(data, last);
+            if (feb == 15)
+                last = b = decodeIndex(data, last);
+            if (fec == 15)
+                last = c = decodeIndex(data, last);
+
+            pushVertex(a);
+            pushVertex(b, feb == 0 || feb == 15);
+            pushVertex(c, fec == 0 || fec == 15);
+            pushEdge(b, a);
+            pushEdge(c, b);
+            pushEdge(a, c);
+        }
+
+        writeIndex(dst, i + 0, indexSize, a);
+        writeIndex(dst, i + 1, indexSize, b);
+        writeIndex(dst, i + 2, indexSize, c);
+    }
+
+    // All data must have been consumed up to the lookup table.
+    FALCOR_CHECK(data == dataSafeEnd, "Index data size does not match the index count.");
+}
+
+void decodeMeshoptIndexSequence(void* dst, size_t count, size_t indexSize, const uint8_t* src, size_t srcSize)
+{
+    FALCOR_CHECK(indexSize == 2 || indexSize == 4, "Invalid index size {}.", indexSize);
+    FALCOR_CHECK(srcSize >= 1 + count + 4, "Index data is truncated.");
+    FALCOR_CHECK((src[0] & 0xf0) == kSequenceHeader && (src[0] & 0x0f) <= 1, "Invalid index sequence header 0x{:02x}.", src[0]);
+
+    // Each index is delta encoded against one of two baselines. The 4 byte tail makes it safe to read a full varint.
+    const uint8_t* data = src + 1;
+    const uint8_t* dataSafeEnd = src + srcSize - 4;
+    uint32_t last[2] = {};
+
+    for (size_t i = 0; i < count; i++)
+    {
+        FALCOR_CHECK(data < dataSafeEnd, "Index data is truncated.");
+
+        uint32_t v = decodeVByte(data);
+        uint32_t baseline = v & 1;
+        v >>= 1;
+        uint32_t d = (v >> 1) ^ -int32_t(v & 1);
+        last[baseline] += d;
+        writeIndex(dst, i, indexSize, last[baseline]);
+    }
+
+    FALCOR_CHECK(data == dataSafeEnd, "Index data size does not match the index count.");
+}
+
+void applyMeshoptFilter(MeshoptFilter filter, void* data, size_t count, size_t stride)
+{
+    switch (filter)
+    {
+    case MeshoptFilter::None:
+        return;
+    case MeshoptFilter::Octahedral:
+        FALCOR_CHECK(stride == 4 || stride == 8, "Octahedral filter requires a stride of 4 or 8, got {}.", stride);
+        if (stride == 4)
+            decodeOctFilter(static_cast<int8_t*>(data), count);
+        else
+            decodeOctFilter(static_cast<int16_t*>(data), count);
+        return;
+    case MeshoptFilter::Quaternion:
+        FALCOR_CHECK(stride == 8, "Quaternion filter requires a stride of 8, got {}.", stride);
+        decodeQuatFilter(static_cast<int16_t*>(data), count);
+        return;
+    case MeshoptFilter::Exponential:
+        FALCOR_CHECK(stride % 4 == 0, "Exponential filter requires a stride that is a multiple of 4, got {}.", stride);
+        decodeExpFilter(static_cast<uint32_t*>(data), count * stride / 4);
+        return;
+    }
+    FALCOR_THROW("Invalid meshopt filter.");
+}
+
+void decodeMeshopt(MeshoptMode mode, MeshoptFilter filter, void* dst, size_t count, size_t stride, const uint8_t* src, size_t srcSize)
+{
+    FALCOR_CHECK(mode == MeshoptMode::Attributes || filter == MeshoptFilter::None, "Filters can only be applied to attribute data.");
+    switch (mode)
+    {
+    case MeshoptMode::Attributes:
+        decodeMeshoptVertexBuffer(dst, count, stride, src, srcSize);
+        applyMeshoptFilter(filter, dst, count, stride);
+        return;
+    case MeshoptMode::Triangles:
+        decodeMeshoptIndexBuffer(dst, count, stride, src, srcSize);
+        return;
+    case MeshoptMode::Indices:
+        decodeMeshoptIndexSequence(dst, count, stride, src, srcSize);
+        return;
+    }
+    FALCOR_THROW("Invalid meshopt mode.");
+}
+
+} // namespace Falcor
@@ -0,0 +1,105 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace Falcor
+{
+
+/**
+ * Decoders for the meshoptimizer bitstreams used by the EXT_meshopt_compression glTF extension.
+ * See https://github.com/KhronosGroup/glTF/tree/main/extensions/2.0/Vendor/EXT_meshopt_compression
+ *
+ * All decoders validate the stream against the destination size and throw a RuntimeError on malformed input.
+ * They are stateless and can be called concurrently on different buffers.
+ */
+
+/// Compression mode of a buffer view.
+enum class MeshoptMode
+{
+    Attributes, ///< Vertex attribute data (byte-wise delta encoding).
+    Triangles,  ///< Triangle list indices (edge/vertex FIFO encoding).
+    Indices,    ///< Generic index sequence (delta encoding).
+};
+
+/// Filter applied to attribute data after decoding.
+enum class MeshoptFilter
+{
+    None,
+    Octahedral,  ///< Octahedral encoded unit vectors (4 or 8 byte stride).
+    Quaternion,  ///< Unit quaternions with three components stored (8 byte stride).
+    Exponential, ///< Shared exponent floats (stride multiple of 4).
+};
+
+/**
+ * Decode vertex attribute data.
+ * @param[out] dst Destination buffer of count * stride bytes.
+ * @param[in] count Number of elements.
+ * @param[in] stride Element size in bytes (multiple of 4, at most 256).
+ * @param[in] src Encoded data.
+ * @param[in] srcSize Size of the encoded data in bytes.
+ */
+FALCOR_API void decodeMeshoptVertexBuffer(void* dst, size_t count, size_t stride, const uint8_t* src, size_t srcSize);
+
+/**
+ * Decode triangle list indices.
+ * @param[out] dst Destination buffer of count * indexSize bytes.
+ * @param[in] count Number of indices (multiple of 3).
+ * @param[in] indexSize Index size in bytes (2 or 4).
+ * @param[in] src Encoded data.
+ * @param[in] srcSize Size of the encoded data in bytes.
+ */
+FALCOR_API void decodeMeshoptIndexBuffer(void* dst, size_t count, size_t indexSize, const uint8_t* src, size_t srcSize);
+
+/**
+ * Decode a generic index sequence.
+ * @param[out] dst Destination buffer of count * indexSize bytes.
+ * @param[in] count Number of indices.
+ * @param[in] indexSize Index size in bytes (2 or 4).
+ * @param[in] src Encoded data.
+ * @param[in] srcSize Size of the encoded data in bytes.
+ */
+FALCOR_API void decodeMeshoptIndexSequence(void* dst, size_t count, size_t indexSize, const uint8_t* src, size_t srcSize);
+
+/**
+ * Apply a filter to decoded attribute data in place.
+ * @param[in] filter Filter to apply.
+ * @param[in,out] data Decoded attribute data.
+ * @param[in] count Number of elements.
+ * @param[in] stride Element size in bytes.
+ */
+FALCOR_API void applyMeshoptFilter(MeshoptFilter filter, void* data, size_t count, size_t stride);
+
+/**
+ * Decode a buffer view compressed with EXT_meshopt_compression.
+ */
+FALCOR_API void decodeMeshopt(MeshoptMode mode, MeshoptFilter filter, void* dst, size_t count, size_t stride, const uint8_t* src, size_t srcSize);
+
+} // namespace Falcor
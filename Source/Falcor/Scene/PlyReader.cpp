@@ -0,0 +1,846 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "PlyReader.h"
+#include "Core/Error.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include "Utils/Math/Vector.h"
+
+#include <BS_thread_pool/BS_thread_pool.hpp>
+#include <fast_float/fast_float.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define PLY_READER_SSE2 1
+#endif
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace Falcor
+{
+namespace
+{
+enum class Format
+{
+    Ascii,
+    BinaryLittleEndian,
+    BinaryBigEndian,
+};
+
+enum class Type : uint8_t
+{
+    None,
+    Int8,
+    UInt8,
+    Int16,
+    UInt16,
+    Int32,
+    UInt32,
+    Float32,
+    Float64,
+};
+
+size_t getTypeSize(Type type)
+{
+    switch (type)
+    {
+    case Type::Int8:
+    case Type::UInt8:
+        return 1;
+    case Type::Int16:
+    case Type::UInt16:
+        return 2;
+    case Type::Int32:
+    case Type::UInt32:
+    case Type::Float32:
+        return 4;
+    case Type::Float64:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+Type parseType(std::string_view name)
+{
+    if (name == "char" || name == "int8")
+        return Type::Int8;
+    if (name == "uchar" || name == "uint8")
+        return Type::UInt8;
+    if (name == "short" || name == "int16")
+        return Type::Int16;
+    if (name == "ushort" || name == "uint16")
+        return Type::UInt16;
+    if (name == "int" || name == "int32")
+        return Type::Int32;
+    if (name == "uint" || name == "uint32")
+        return Type::UInt32;
+    if (name == "float" || name == "float32")
+        return Type::Float32;
+    if (name == "double" || name == "float64")
+        return Type::Float64;
+    FALCOR_THROW("Unknown property type '{}'.", name);
+}
+
+struct Property
+{
+    std::string name;
+    Type type = Type::None;      ///< Value type (item type for lists).
+    Type countType = Type::None; ///< Count type for lists, None for scalar properties.
+    size_t offset = 0;           ///< Byte offset within the row (only valid for fixed size rows).
+
+    bool isList() const { return countType != Type::None; }
+};
+
+struct Element
+{
+    std::string name;
+    size_t count = 0;
+    std::vector<Property> properties;
+    size_t stride = 0; ///< Row size in bytes, or 0 if the element has list properties.
+
+    int findProperty(std::initializer_list<std::string_view> names) const
+    {
+        for (size_t i = 0; i < properties.size(); ++i)
+        {
+            if (std::find(names.begin(), names.end(), properties[i].name) != names.end())
+                return int(i);
+        }
+        return -1;
+    }
+};
+
+struct Header
+{
+    Format format = Format::Ascii;
+    std::vector<Element> elements;
+    size_t dataOffset = 0;
+};
+
+std::vector<std::string_view> splitTokens(std::string_view line)
+{
+    std::vector<std::string_view> tokens;
+    size_t pos = 0;
+    while (pos < line.size())
+    {
+        size_t start = line.find_first_not_of(" \t", pos);
+        if (start == std::string_view::npos)
+            break;
+        size_t end = std::min(line.find_first_of(" \t", start), line.size());
+        tokens.push_back(line.substr(start, end - start));
+        pos = end;
+    }
+    return tokens;
+}
+
+Header parseHeader(const char* pData, size_t size)
+{
+    std::string_view text(pData, size);
+    size_t pos = 0;
+    auto nextLine = [&]()
+    {
+        if (pos >= text.size())
+            FALCOR_THROW("Unexpected end of header.");
+        size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos)
+            end = text.size();
+        std::string_view line = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        return line;
+    };
+
+    if (nextLine() != "ply")
+        FALCOR_THROW("Missing 'ply' magic.");
+
+    Header header;
+    bool hasFormat = false;
+    while (true)
+    {
+        auto tokens = splitTokens(nextLine());
+        if (tokens.empty() || tokens[0] == "comment" || tokens[0] == "obj_info")
+            continue;
+
+        if (tokens[0] == "format" && tokens.size() >= 2)
+        {
+            if (tokens[1] == "ascii")
+                header.format = Format::Ascii;
+            else if (tokens[1] == "binary_little_endian")
+                header.format = Format::BinaryLittleEndian;
+            else if (tokens[1] == "binary_big_endian")
+                header.format = Format::BinaryBigEndian;
+            else
+                FALCOR_THROW("Unknown format '{}'.", tokens[1]);
+            hasFormat = true;
+        }
+        else if (tokens[0] == "element" && tokens.size() == 3)
+        {
+            Element element;
+            element.name = tokens[1];
+            auto result = std::from_chars(tokens[2].data(), tokens[2].data() + tokens[2].size(), element.count);
+            if (result.ec != std::errc())
+                FALCOR_THROW("Invalid element count '{}'.", tokens[2]);
+            header.elements.push_back(std::move(element));
+        }
+        else if (tokens[0] == "property" && !header.elements.empty())
+        {
+            Property property;
+            if (tokens.size() == 5 && tokens[1] == "list")
+            {
+                property.countType = parseType(tokens[2]);
+                property.type = parseType(tokens[3]);
+                property.name = tokens[4];
+                if (property.countType == Type::Float32 || property.countType == Type::Float64)
+                    FALCOR_THROW("Invalid list count type '{}'.", tokens[2]);
+            }
+            else if (tokens.size() == 3)
+            {
+                property.type = parseType(tokens[1]);
+                property.name = tokens[2];
+            }
+            else
+            {
+                FALCOR_THROW("Invalid property '{}'.", fmt::join(tokens, " "));
+            }
+            header.elements.back().properties.push_back(std::move(property));
+        }
+        else if (tokens[0] == "end_header")
+        {
+            break;
+        }
+        else
+        {
+            FALCOR_THROW("Invalid header line '{}'.", fmt::join(tokens, " "));
+        }
+    }
+
+    if (!hasFormat)
+        FALCOR_THROW("Missing format.");
+    header.dataOffset = std::min(pos, size);
+
+    for (auto& element : header.elements)
+    {
+        size_t stride = 0;
+        for (auto& property : element.properties)
+        {
+            if (property.isList())
+            {
+                stride = 0;
+                break;
+            }
+            property.offset = stride;
+            stride += getTypeSize(property.type);
+        }
+        element.stride = stride;
+    }
+
+    return header;
+}
+
+template<typename T>
+T loadUnaligned(const uint8_t* p)
+{
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+/// Read a little endian value of the given type.
+template<typename T>
+T readValue(const uint8_t* p, Type type)
+{
+    switch (type)
+    {
+    case Type::Int8:
+        return T(loadUnaligned<int8_t>(p));
+    case Type::UInt8:
+        return T(*p);
+    case Type::Int16:
+        return T(loadUnaligned<int16_t>(p));
+    case Type::UInt16:
+        return T(loadUnaligned<uint16_t>(p));
+    case Type::Int32:
+        return T(loadUnaligned<int32_t>(p));
+    case Type::UInt32:
+        return T(loadUnaligned<uint32_t>(p));
+    case Type::Float32:
+        return T(loadUnaligned<float>(p));
+    case Type::Float64:
+        return T(loadUnaligned<double>(p));
+    default:
+        FALCOR_UNREACHABLE();
+        return T(0);
+    }
+}
+
+inline uint32_t byteSwap32(uint32_t x)
+{
+    return (x >> 24) | ((x >> 8) & 0xff00u) | ((x << 8) & 0xff0000u) | (x << 24);
+}
+
+/// Swap the byte order of an array of 32-bit values in place.
+void byteSwap32(uint32_t* pData, size_t count)
+{
+    size_t i = 0;
+#if PLY_READER_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + i));
+        // Swap the bytes of each 16-bit word, then swap the words of each 32-bit value.
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pData + i), v);
+    }
+#endif
+    for (; i < count; ++i)
+        pData[i] = byteSwap32(pData[i]);
+}
+
+/// Cursor over binary element data. Big endian values are swapped on read.
+struct BinaryCursor
+{
+    const uint8_t* p;
+    const uint8_t* end;
+    bool swap;
+
+    void require(size_t size) const
+    {
+        if (size_t(end - p) < size)
+            FALCOR_THROW("Unexpected end of file.");
+    }
+
+    template<typename T>
+    T read(Type type)
+    {
+        size_t size = getTypeSize(type);
+        require(size);
+        T value;
+        if (swap)
+        {
+            uint8_t swapped[8];
+            std::reverse_copy(p, p + size, swapped);
+            value = readValue<T>(swapped, type);
+        }
+        else
+        {
+            value = readValue<T>(p, type);
+        }
+        p += size;
+        return value;
+    }
+
+    void skipList(Type type, size_t count)
+    {
+        if (count > size_t(end - p) / getTypeSize(type))
+            FALCOR_THROW("Unexpected end of file.");
+        p += getTypeSize(type) * count;
+    }
+};
+
+/// Cursor over ASCII element data. Rows are whitespace separated, line breaks are not significant.
+struct AsciiCursor
+{
+    const char* p;
+    const char* end;
+
+    /// Read a value. Integer properties are parsed as integers, so large indices stay exact and fractions are rejected.
+    template<typename T>
+    T read(Type type)
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+            ++p;
+        if (p == end)
+            FALCOR_THROW("Unexpected end of file.");
+        const char* pNext = nullptr;
+        T value;
+        if (type == Type::Float32 || type == Type::Float64)
+        {
+            double number;
+            auto result = fast_float::from_chars(p, end, number);
+            pNext = result.ec == std::errc() ? result.ptr : nullptr;
+            value = T(number);
+        }
+        else
+        {
+            int64_t number;
+            auto result = std::from_chars(*p == '+' ? p + 1 : p, end, number);
+            pNext = result.ec == std::errc() ? result.ptr : nullptr;
+            value = T(number);
+        }
+        if (!pNext || (pNext < end && *pNext != ' ' && *pNext != '\t' && *pNext != '\r' && *pNext != '\n'))
+            FALCOR_THROW("Invalid number '{}'.", std::string_view(p, std::min<size_t>(end - p, 16)));
+        p = pNext;
+        return value;
+    }
+
+    void skipList(Type type, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            read<double>(type);
+    }
+};
+
+/// Vertex attributes read from the vertex element.
+enum VertexAttribute
+{
+    kPositionX,
+    kPositionY,
+    kPositionZ,
+    kNormalX,
+    kNormalY,
+    kNormalZ,
+    kTexCoordU,
+    kTexCoordV,
+    kVertexAttributeCount,
+};
+
+struct VertexLayout
+{
+    int properties[kVertexAttributeCount]; ///< Property index of each attribute, -1 if missing.
+    bool hasNormals = false;
+    bool hasTexCoords = false;
+
+    explicit VertexLayout(const Element& element)
+    {
+        properties[kPositionX] = element.findProperty({"x"});
+        properties[kPositionY] = element.findProperty({"y"});
+        properties[kPositionZ] = element.findProperty({"z"});
+        properties[kNormalX] = element.findProperty({"nx"});
+        properties[kNormalY] = element.findProperty({"ny"});
+        properties[kNormalZ] = element.findProperty({"nz"});
+        properties[kTexCoordU] = element.findProperty({"u", "s", "texture_u", "texture_s"});
+        properties[kTexCoordV] = element.findProperty({"v", "t", "texture_v", "texture_t"});
+
+        if (properties[kPositionX] < 0 || properties[kPositionY] < 0 || properties[kPositionZ] < 0)
+            FALCOR_THROW("Vertex element is missing positions.");
+        hasNormals = properties[kNormalX] >= 0 && properties[kNormalY] >= 0 && properties[kNormalZ] >= 0;
+        hasTexCoords = properties[kTexCoordU] >= 0 && properties[kTexCoordV] >= 0;
+        for (int index : properties)
+        {
+            if (index >= 0 && element.properties[index].isList())
+                FALCOR_THROW("Vertex attribute '{}' must not be a list.", element.properties[index].name);
+        }
+    }
+
+    void store(const float* values, TriangleMesh::Vertex& vertex) const
+    {
+        vertex.position = float3(values[kPositionX], values[kPositionY], values[kPositionZ]);
+        vertex.normal = hasNormals ? float3(values[kNormalX], values[kNormalY], values[kNormalZ]) : float3(0.f);
+        // Flip vertically to match TriangleMesh::createFromFile() (aiProcess_FlipUVs).
+        vertex.texCoord = hasTexCoords ? float2(values[kTexCoordU], 1.f - values[kTexCoordV]) : float2(0.f);
+    }
+};
+
+/// Read the vertices of an element with list properties (or from ASCII data) one value at a time.
+template<typename Cursor>
+void readVerticesGeneric(Cursor& cursor, const Element& element, const VertexLayout& layout, TriangleMesh::VertexList& vertices)
+{
+    // Map properties to attributes.
+    std::vector<int> attributes(element.properties.size(), -1);
+    for (int a = 0; a < kVertexAttributeCount; ++a)
+    {
+        if (layout.properties[a] >= 0)
+            attributes[layout.properties[a]] = a;
+    }
+
+    float values[kVertexAttributeCount] = {};
+    for (auto& vertex : vertices)
+    {
+        for (size_t i = 0; i < element.properties.size(); ++i)
+        {
+            const auto& property = element.properties[i];
+            if (property.isList())
+                cursor.skipList(property.type, cursor.template read<size_t>(property.countType));
+            else if (attributes[i] >= 0)
+                values[attributes[i]] = cursor.template read<float>(property.type);
+            else
+                cursor.template read<double>(property.type);
+        }
+        layout.store(values, vertex);
+    }
+}
+
+/// Read the vertices of a binary element with fixed size rows. Big endian data is swapped in chunks.
+void readVerticesBinary(BinaryCursor& cursor, const Element& element, const VertexLayout& layout, TriangleMesh::VertexList& vertices)
+{
+    const size_t stride = element.stride;
+    cursor.require(stride * vertices.size());
+
+    Type types[kVertexAttributeCount] = {};
+    size_t offsets[kVertexAttributeCount] = {};
+    for (int a = 0; a < kVertexAttributeCount; ++a)
+    {
+        if (layout.properties[a] >= 0)
+        {
+            types[a] = element.properties[layout.properties[a]].type;
+            offsets[a] = element.properties[layout.properties[a]].offset;
+        }
+    }
+
+    auto decode = [&](const uint8_t* pRows, size_t first, size_t count)
+    {
+        float values[kVertexAttributeCount] = {};
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint8_t* pRow = pRows + i * stride;
+            for (int a = 0; a < kVertexAttributeCount; ++a)
+            {
+                if (types[a] == Type::Float32)
+                    values[a] = loadUnaligned<float>(pRow + offsets[a]);
+                else if (types[a] != Type::None)
+                    values[a] = readValue<float>(pRow + offsets[a], types[a]);
+            }
+            layout.store(values, vertices[first + i]);
+        }
+    };
+
+    if (!cursor.swap)
+    {
+        decode(cursor.p, 0, vertices.size());
+    }
+    else
+    {
+        // Rows made of 32-bit values only (the common case) are swapped with SIMD, other layouts value by value.
+        const bool all32Bit = std::all_of(
+            element.properties.begin(), element.properties.end(), [](const Property& property) { return getTypeSize(property.type) == 4; }
+        );
+        const size_t chunkSize = 4096;
+        std::vector<uint32_t> buffer((chunkSize * stride + 3) / 4);
+        uint8_t* pBuffer = reinterpret_cast<uint8_t*>(buffer.data());
+        for (size_t first = 0; first < vertices.size(); first += chunkSize)
+        {
+            size_t count = std::min(chunkSize, vertices.size() - first);
+            std::memcpy(pBuffer, cursor.p + first * stride, count * stride);
+            if (all32Bit)
+            {
+                byteSwap32(buffer.data(), count * stride / 4);
+            }
+            else
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    for (const auto& property : element.properties)
+                    {
+                        uint8_t* pValue = pBuffer + i * stride + property.offset;
+                        std::reverse(pValue, pValue + getTypeSize(property.type));
+                    }
+                }
+            }
+            decode(pBuffer, first, count);
+        }
+    }
+
+    cursor.p += stride * vertices.size();
+}
+
+/// Read the faces and triangulate them as fans.
+template<typename Cursor>
+void readFaces(Cursor& cursor, const Element& element, TriangleMesh::IndexList& indices)
+{
+    int indexProperty = element.findProperty({"vertex_indices", "vertex_index"});
+    if (indexProperty < 0 || !element.properties[indexProperty].isList())
+        FALCOR_THROW("Face element is missing vertex indices.");
+
+    indices.reserve(indices.size() + element.count * 3);
+    std::vector<uint32_t> polygon;
+    for (size_t f = 0; f < element.count; ++f)
+    {
+        for (size_t i = 0; i < element.properties.size(); ++i)
+        {
+            const auto& property = element.properties[i];
+            if (!property.isList())
+            {
+                cursor.template read<double>(property.type);
+                continue;
+            }
+            int64_t count = cursor.template read<int64_t>(property.countType);
+            if (count < 0)
+                FALCOR_THROW("Invalid list size {}.", count);
+            if (int(i) != indexProperty)
+            {
+                cursor.skipList(property.type, size_t(count));
+                continue;
+            }
+            polygon.resize(size_t(count));
+            for (auto& index : polygon)
+            {
+                int64_t value = cursor.template read<int64_t>(property.type);
+                if (value < 0 || value > std::numeric_limits<uint32_t>::max())
+                    FALCOR_THROW("Invalid vertex index {}.", value);
+                index = uint32_t(value);
+            }
+            for (size_t k = 1; k + 1 < polygon.size(); ++k)
+            {
+                indices.push_back(polygon[0]);
+                indices.push_back(polygon[k]);
+                indices.push_back(polygon[k + 1]);
+            }
+        }
+    }
+}
+
+/// Fast path for binary little endian faces made of a single uchar/uint8 count and (u)int32 index list.
+bool readTriangleFacesBinary(BinaryCursor& cursor, const Element& element, TriangleMesh::IndexList& indices)
+{
+    if (cursor.swap || element.properties.size() != 1)
+        return false;
+    const auto& property = element.properties[0];
+    if (property.countType != Type::UInt8 || (property.type != Type::Int32 && property.type != Type::UInt32))
+        return false;
+
+    // Fall back to the generic path on the first non-triangle.
+    const uint8_t* pStart = cursor.p;
+    const size_t startSize = indices.size();
+    indices.resize(startSize + element.count * 3);
+    uint32_t* pIndices = indices.data() + startSize;
+    for (size_t f = 0; f < element.count; ++f)
+    {
+        cursor.require(13);
+        if (cursor.p[0] != 3)
+        {
+            cursor.p = pStart;
+            indices.resize(startSize);
+            return false;
+        }
+        std::memcpy(pIndices + f * 3, cursor.p + 1, 12);
+        cursor.p += 13;
+    }
+    if (property.type == Type::Int32)
+    {
+        for (size_t i = startSize; i < indices.size(); ++i)
+        {
+            if (int32_t(indices[i]) < 0)
+                FALCOR_THROW("Invalid vertex index {}.", int32_t(indices[i]));
+        }
+    }
+    return true;
+}
+
+template<typename Cursor>
+void skipElement(Cursor& cursor, const Element& element)
+{
+    for (size_t r = 0; r < element.count; ++r)
+    {
+        for (const auto& property : element.properties)
+        {
+            if (property.isList())
+                cursor.skipList(property.type, cursor.template read<size_t>(property.countType));
+            else
+                cursor.template read<double>(property.type);
+        }
+    }
+}
+
+template<typename Cursor>
+void readElements(
+    Cursor& cursor,
+    const Header& header,
+    TriangleMesh::VertexList& vertices,
+    TriangleMesh::IndexList& indices,
+    bool& hasNormals
+)
+{
+    constexpr bool isBinary = std::is_same_v<Cursor, BinaryCursor>;
+    bool hasVertices = false;
+    for (const auto& element : header.elements)
+    {
+        if (element.name == "vertex" && !hasVertices)
+        {
+            VertexLayout layout(element);
+            hasNormals = layout.hasNormals;
+            vertices.resize(element.count);
+            if constexpr (isBinary)
+            {
+                if (element.stride > 0)
+                    readVerticesBinary(cursor, element, layout, vertices);
+                else
+                    readVerticesGeneric(cursor, element, layout, vertices);
+            }
+            else
+            {
+                readVerticesGeneric(cursor, element, layout, vertices);
+            }
+            hasVertices = true;
+        }
+        else if (element.name == "face")
+        {
+            if constexpr (isBinary)
+            {
+                if (readTriangleFacesBinary(cursor, element, indices))
+                    continue;
+            }
+            readFaces(cursor, element, indices);
+        }
+        else
+        {
+            if constexpr (isBinary)
+            {
+                if (element.stride > 0)
+                {
+                    cursor.skipList(Type::UInt8, element.stride * element.count);
+                    continue;
+                }
+            }
+            skipElement(cursor, element);
+        }
+    }
+    if (!hasVertices)
+        FALCOR_THROW("Missing vertex element.");
+}
+
+/// Merge vertices with identical attributes and drop unreferenced vertices.
+void joinIdenticalVertices(TriangleMesh::VertexList& vertices, TriangleMesh::IndexList& indices)
+{
+    struct VertexHash
+    {
+        size_t operator()(const TriangleMesh::Vertex& v) const
+        {
+            return std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char*>(&v), sizeof(v)));
+        }
+    };
+    struct VertexEqual
+    {
+        bool operator()(const TriangleMesh::Vertex& a, const TriangleMesh::Vertex& b) const
+        {
+            return std::memcmp(&a, &b, sizeof(a)) == 0;
+        }
+    };
+
+    TriangleMesh::VertexList joined;
+    std::unordered_map<TriangleMesh::Vertex, uint32_t, VertexHash, VertexEqual> vertexToIndex;
+    vertexToIndex.reserve(vertices.size());
+    std::vector<uint32_t> remap(vertices.size(), uint32_t(-1));
+    for (auto& index : indices)
+    {
+        if (remap[index] == uint32_t(-1))
+        {
+            auto [it, inserted] = vertexToIndex.try_emplace(vertices[index], uint32_t(joined.size()));
+            if (inserted)
+                joined.push_back(vertices[index]);
+            remap[index] = it->second;
+        }
+        index = remap[index];
+    }
+    vertices = std::move(joined);
+}
+
+} // namespace
+
+ref<TriangleMesh> PlyReader::read(const std::filesystem::path& path, ImportFlags flags)
+{
+    try
+    {
+        if (hasExtension(path, "gz"))
+        {
+            if (!std::filesystem::exists(path))
+                FALCOR_THROW("File not found");
+            std::string data = decompressFile(path);
+            return readFromMemory(data.data(), data.size(), flags);
+        }
+
+        MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+        if (!file.isOpen())
+            FALCOR_THROW(std::filesystem::exists(path) ? "Cannot open file" : "File not found");
+        return readFromMemory(file.getData(), file.getSize(), flags);
+    }
+    catch (const RuntimeError& e)
+    {
+        logWarning("Failed to load triangle mesh from '{}': {}", path, e.what());
+        return nullptr;
+    }
+}
+
+ref<TriangleMesh> PlyReader::readFromMemory(const void* pData, size_t size, ImportFlags flags)
+{
+    const Header header = parseHeader(static_cast<const char*>(pData), size);
+    const uint8_t* pBegin = static_cast<const uint8_t*>(pData) + header.dataOffset;
+    const uint8_t* pEnd = static_cast<const uint8_t*>(pData) + size;
+
+    TriangleMesh::VertexList vertices;
+    TriangleMesh::IndexList indices;
+    bool hasNormals = false;
+
+    if (header.format == Format::Ascii)
+    {
+        AsciiCursor cursor{reinterpret_cast<const char*>(pBegin), reinterpret_cast<const char*>(pEnd)};
+        readElements(cursor, header, vertices, indices, hasNormals);
+    }
+    else
+    {
+        BinaryCursor cursor{pBegin, pEnd, header.format == Format::BinaryBigEndian};
+        readElements(cursor, header, vertices, indices, hasNormals);
+    }
+
+    if (indices.empty())
+        FALCOR_THROW("Mesh has no faces.");
+    const uint32_t vertexCount = uint32_t(vertices.size());
+    if (std::any_of(indices.begin(), indices.end(), [vertexCount](uint32_t index) { return index >= vertexCount; }))
+        FALCOR_THROW("Vertex index out of bounds.");
+    if (is_set(flags, ImportFlags::JoinIdenticalVertices))
+        joinIdenticalVertices(vertices, indices);
+
+    auto pMesh = TriangleMesh::create(std::move(vertices), std::move(indices));
+    if (!hasNormals)
+    {
+        if (is_set(flags, ImportFlags::GenSmoothNormals))
+            pMesh->generateSmoothNormals();
+        else
+            pMesh->generateFaceNormals();
+    }
+    return pMesh;
+}
+
+std::vector<ref<TriangleMesh>> PlyReader::readFiles(const std::vector<std::filesystem::path>& paths, ImportFlags flags)
+{
+    std::vector<ref<TriangleMesh>> meshes(paths.size());
+    if (paths.empty())
+        return meshes;
+
+    uint32_t threadCount = std::min<uint32_t>(uint32_t(paths.size()), std::max(std::thread::hardware_concurrency(), 1u));
+    BS::thread_pool threadPool(threadCount);
+    for (size_t i = 0; i < paths.size(); ++i)
+        threadPool.push_task([&meshes, &paths, flags, i]() { meshes[i] = read(paths[i], flags); });
+    threadPool.wait_for_tasks();
+
+    return meshes;
+}
+
+bool PlyReader::isPlyFile(const std::filesystem::path& path)
+{
+    if (hasExtension(path, "gz"))
+        return hasExtension(path.stem(), "ply");
+    return hasExtension(path, "ply");
+}
+} // namespace Falcor
@@ -0,0 +1,80 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "TriangleMesh.h"
+#include "Core/Macros.h"
+#include "Core/Object.h"
+#include <filesystem>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Reader for PLY (polygon file format) meshes, as referenced by pbrt and Mitsuba scenes.
+ *
+ * Files are memory mapped and decoded directly into the vertex and index lists of a TriangleMesh, without going
+ * through Assimp. ASCII, binary little endian and binary big endian files are supported (.ply.gz files are decompressed
+ * first). Vertex positions, normals (nx, ny, nz) and texture coordinates (u/v, s/t, texture_u/texture_v, ...) are read,
+ * polygons are triangulated as fans and all other elements and properties are skipped.
+ *
+ * Texture coordinates are flipped vertically to match TriangleMesh::createFromFile(). Meshes without vertex normals get
+ * smooth normals with ImportFlags::GenSmoothNormals, otherwise every triangle gets its own vertices with the face normal.
+ * ImportFlags::JoinIdenticalVertices merges vertices with bitwise identical attributes before normals are generated.
+ */
+class FALCOR_API PlyReader
+{
+public:
+    using ImportFlags = TriangleMesh::ImportFlags;
+
+    /**
+     * Read a triangle mesh from a PLY file.
+     * @param[in] path File path (.ply or .ply.gz).
+     * @param[in] flags Import flags. GenSmoothNormals and JoinIdenticalVertices are supported.
+     * @return Returns the triangle mesh or nullptr if the mesh failed to load (a warning is logged).
+     */
+    static ref<TriangleMesh> read(const std::filesystem::path& path, ImportFlags flags = ImportFlags::Default);
+
+    /**
+     * Read a triangle mesh from PLY data in memory.
+     * Throws a RuntimeError if the data is invalid.
+     */
+    static ref<TriangleMesh> readFromMemory(const void* pData, size_t size, ImportFlags flags = ImportFlags::Default);
+
+    /**
+     * Read multiple PLY files concurrently.
+     * @return Returns the triangle meshes in the order of the paths. Meshes that failed to load are nullptr.
+     */
+    static std::vector<ref<TriangleMesh>> readFiles(
+        const std::vector<std::filesystem::path>& paths,
+        ImportFlags flags = ImportFlags::Default
+    );
+
+    /// Returns true if the path has a .ply or .ply.gz extension.
+    static bool isPlyFile(const std::filesystem::path& path);
+};
+} // namespace Falcor
@@ -27,11 +27,13 @@
  **************************************************************************/
 #include "SceneBuilder.h"
 #include "SceneCache.h"
+#include "SceneDescFile.h"
 #include "Importer.h"
 #include "Curves/CurveConfig.h"
 #include "Material/StandardMaterial.h"
 #include "Utils/Logger.h"
 #include "Utils/Math/Common.h"
+#include "Utils/Image/ImageBufferPool.h"
 #include "Utils/Image/TextureAnalyzer.h"
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Scripting/ScriptBindings.h"
@@ -42,6 +44,7 @@
 #include <filesystem>
 #include <cmath>
 #include <execution>
+#include <unordered_map>
 
 namespace Falcor
 {
@@ -328,7 +331,7 @@ namespace Falcor
         if (mpScene) return mpScene;
 
         // Finish loading textures. This blocks until all textures are loaded and assigned.
-        mpMaterialTextureLoader.reset();
+        waitForMaterialTextureLoading();
 
         // If no meshes were added, we create a dummy mesh to keep the scene generation working.
         // Scenes with no meshes can be useful for example when using volumes in isolation.
@@ -732,15 +735,48 @@ namespace Falcor
     }
 
     MeshID SceneBuilder::addProcessedMesh(const ProcessedMesh& mesh)
+    {
+        return addProcessedMesh(ProcessedMesh(mesh));
+    }
+
+    MeshID SceneBuilder::addProcessedMesh(ProcessedMesh&& mesh)
+    {
+        const MaterialID materialID = addMaterial(mesh.pMaterial);
+        return addProcessedMesh(std::move(mesh), materialID);
+    }
+
+    MeshID SceneBuilder::addProcessedMeshes(std::vector<ProcessedMesh>&& meshes)
+    {
+        if (mMeshes.size() + meshes.size() > std::numeric_limits<uint32_t>::max())
+        {
+            FALCOR_THROW("Trying to build a scene that exceeds supported number of meshes");
+        }
+
+        const MeshID firstID{ mMeshes.size() };
+        mMeshes.reserve(mMeshes.size() + meshes.size());
+
+        // Adding a material searches all previously added materials, so only do it once per distinct material.
+        std::unordered_map<const Material*, MaterialID> materialIDs;
+        for (auto& mesh : meshes)
+        {
+            auto it = materialIDs.find(mesh.pMaterial.get());
+            if (it == materialIDs.end()) it = materialIDs.emplace(mesh.pMaterial.get(), addMaterial(mesh.pMaterial)).first;
+            addProcessedMesh(std::move(mesh), it->second);
+        }
+
+        return firstID;
+    }
+
+    MeshID SceneBuilder::addProcessedMesh(ProcessedMesh&& mesh, MaterialID materialID)
     {
         const bool isIndexed = !is_set(mFlags, Flags::NonIndexedVertices);
 
         MeshSpec spec;
 
         // Add the mesh to the scene.
-        spec.name = mesh.name;
+        spec.name = std::move(mesh.name);
         spec.topology = mesh.topology;
-        spec.materialId = addMaterial(mesh.pMaterial);
+        spec.materialId = materialID;
         spec.isFrontFaceCW = mesh.isFrontFaceCW;
         spec.isAnimated = mesh.isAnimated;
         spec.skeletonNodeID = mesh.skeletonNodeId;
@@ -766,7 +802,7 @@ namespace Falcor
             spec.prevVertexCount = spec.skinningVertexCount;
         }
 
-        mMeshes.push_back(spec);
+        mMeshes.push_back(std::move(spec));
 
         if (mMeshes.size() > std::numeric_limits<uint32_t>::max())
         {
@@ -866,23 +902,27 @@ namespace Falcor
     }
 
     CurveID SceneBuilder::addProcessedCurve(const ProcessedCurve& curve)
+    {
+        return addProcessedCurve(ProcessedCurve(curve));
+    }
+
+    CurveID SceneBuilder::addProcessedCurve(ProcessedCurve&& curve)
     {
         CurveSpec spec;
 
         // Add the curve to the scene.
-        spec.name = curve.name;
+        spec.name = std::move(curve.name);
         spec.topology = curve.topology;
         spec.materialId = addMaterial(curve.pMaterial);
 
         spec.vertexCount = (uint32_t)curve.staticData.size();
         spec.staticVertexCount = (uint32_t)curve.staticData.size();
+        spec.indexCount = (uint32_t)curve.indexData.size();
 
         spec.indexData = std::move(curve.indexData);
         spec.staticData = std::move(curve.staticData);
 
-        spec.indexCount = (uint32_t)curve.indexData.size();
-
-        mCurves.push_back(spec);
+        mCurves.push_back(std::move(spec));
 
         if (mCurves.size() > std::numeric_limits<uint32_t>::max())
         {
@@ -940,17 +980,17 @@ namespace Falcor
     void SceneBuilder::loadMaterialTexture(const ref<Material>& pMaterial, Material::TextureSlot slot, const std::filesystem::path& path)
     {
         FALCOR_CHECK(pMaterial != nullptr, "'pMaterial' is missing");
-        if (!mpMaterialTextureLoader)
-        {
-            mpMaterialTextureLoader.reset(new MaterialTextureLoader(mSceneData.pMaterials->getTextureManager(), !is_set(mFlags, Flags::AssumeLinearSpaceTextures)));
-        }
         std::filesystem::path resolvedPath = mAssetResolver.resolvePath(path);
-        mpMaterialTextureLoader->loadTexture(pMaterial, slot, resolvedPath);
+        getMaterialTextureLoader().loadTexture(pMaterial, slot, resolvedPath);
     }
 
     void SceneBuilder::waitForMaterialTextureLoading()
     {
+        if (!mpMaterialTextureLoader) return;
         mpMaterialTextureLoader.reset();
+
+        // The decoded image buffers are not needed anymore once all textures are uploaded.
+        ImageBufferPool::getGlobal().trim();
     }
 
     // GridVolumes
@@ -1100,6 +1140,37 @@ namespace Falcor
         mMeshes[meshID.get()].instances.insert(nodeID);
     }
 
+    void SceneBuilder::addMeshInstances(const MeshInstanceTable& instanceTable)
+    {
+        for (const auto& definition : instanceTable.getDefinitions())
+        {
+            if (definition.meshIDs.empty()) continue;
+
+            for (MeshID meshID : definition.meshIDs)
+            {
+                FALCOR_CHECK(meshID.get() < mMeshes.size(), "'meshID' ({}) is out of range", meshID);
+                mMeshes[meshID.get()].keepInstanced = true;
+            }
+
+            mSceneGraph.reserve(mSceneGraph.size() + definition.transforms.size());
+            for (const auto& transform : definition.transforms)
+            {
+                NodeID nodeID = addNode(Node{ definition.name, float4x4(transform), float4x4::identity(), float4x4::identity() });
+                for (MeshID meshID : definition.meshIDs) addMeshInstance(nodeID, meshID);
+            }
+        }
+
+        auto stats = instanceTable.getStats();
+        if (stats.instanceCount > 0)
+        {
+            logInfo(
+                "Added {} instances of {} object definitions ({} meshes): {} unique triangles, {} instanced triangles, {:.1f} MB of instance transforms.",
+                stats.instanceCount, stats.definitionCount, stats.meshCount, stats.uniqueTriangleCount, stats.instancedTriangleCount,
+                stats.transformMemoryInBytes / (1024.0 * 1024.0)
+            );
+        }
+    }
+
     void SceneBuilder::addCurveInstance(NodeID nodeID, CurveID curveID)
     {
         FALCOR_CHECK(nodeID.get() < mSceneGraph.size(), "'nodeID' ({}) is out of range", nodeID);
@@ -1170,6 +1241,16 @@ namespace Falcor
 
     MaterialTextureLoader& SceneBuilder::getMaterialTextureLoader()
     {
+        // The loader is released by waitForMaterialTextureLoading(), create a new one on demand.
+        if (!mpMaterialTextureLoader)
+        {
+            auto& textureManager = mSceneData.pMaterials->getTextureManager();
+            if (is_set(mFlags, Flags::UseBakedTextures) && !textureManager.getBakedTextureCache())
+            {
+                textureManager.setBakedTextureCache(std::make_unique<BakedTextureCache>());
+            }
+            mpMaterialTextureLoader.reset(new MaterialTextureLoader(textureManager, !is_set(mFlags, Flags::AssumeLinearSpaceTextures)));
+        }
         return *mpMaterialTextureLoader;
     }
 
@@ -1479,6 +1560,7 @@ namespace Falcor
         }
 
         size_t flattenedInstanceCount = 0;
+        size_t keptInstancedMeshCount = 0;
         std::vector<MeshSpec> newMeshes;
 
         for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)mMeshes.size(); ++meshID)
@@ -1491,6 +1573,13 @@ namespace Falcor
                 continue;
             }
 
+            // Skip meshes of instanced object definitions, flattening them would duplicate the geometry of every instance.
+            if (mesh.keepInstanced)
+            {
+                keptInstancedMeshCount++;
+                continue;
+            }
+
             FALCOR_ASSERT(!mesh.instances.empty());
             FALCOR_ASSERT(mesh.skinningData.empty() && mesh.skinningVertexCount == 0);
 
@@ -1587,6 +1676,7 @@ namespace Falcor
         }
 
         if (flattenedInstanceCount > 0) logInfo("Flattened {} static instances.", flattenedInstanceCount);
+        if (keptInstancedMeshCount > 0) logInfo("Kept {} meshes of instanced object definitions instanced.", keptInstancedMeshCount);
     }
 
     void SceneBuilder::optimizeSceneGraph()
@@ -2535,8 +2625,8 @@ namespace Falcor
 
     void SceneBuilder::optimizeMaterials()
     {
-        // This passes optimizes the materials by analyzing the material textures
-        // and replacing constant textures by uniform material parameters.
+        // This passes optimizes the materials by merging duplicate textures, analyzing the
+        // material textures and replacing constant textures by uniform material parameters.
         // NOTE: This code has to be updated if the texture usage changes.
 
         if (is_set(mFlags, Flags::DontOptimizeMaterials)) return;
@@ -2964,6 +3054,7 @@ namespace Falcor
         flags.value("TessellateCurvesIntoPolyTubes", SceneBuilder::Flags::TessellateCurvesIntoPolyTubes);
         flags.value("UseCache", SceneBuilder::Flags::UseCache);
         flags.value("RebuildCache", SceneBuilder::Flags::RebuildCache);
+        flags.value("UseBakedTextures", SceneBuilder::Flags::UseBakedTextures);
         ScriptBindings::addEnumBinaryOperators(flags);
 
         pybind11::class_<SceneBuilder> sceneBuilder(m, "SceneBuilder");
@@ -2979,6 +3070,10 @@ namespace Falcor
         sceneBuilder.def_property("selectedCamera", &SceneBuilder::getSelectedCamera, &SceneBuilder::setSelectedCamera);
         sceneBuilder.def_property("cameraSpeed", &SceneBuilder::getCameraSpeed, &SceneBuilder::setCameraSpeed);
         sceneBuilder.def("importScene", &SceneBuilder::import, "path"_a, "dict"_a = pybind11::dict());
+        sceneBuilder.def("exportSceneDesc", [] (SceneBuilder* pSceneBuilder, const std::filesystem::path& path) {
+            FALCOR_CHECK(pSceneBuilder, "'pSceneBuilder' is missing");
+            SceneDescFile::write(*pSceneBuilder, path);
+        }, "path"_a);
         sceneBuilder.def("addTriangleMesh", &SceneBuilder::addTriangleMesh, "triangleMesh"_a, "material"_a, "isAnimated"_a = false);
         sceneBuilder.def("addSDFGrid", &SceneBuilder::addSDFGrid, "sdfGrid"_a, "material"_a);
         sceneBuilder.def("addMaterial", &SceneBuilder::addMaterial, "material"_a);
@@ -29,6 +29,7 @@
 #include "Scene.h"
 #include "SceneCache.h"
 #include "SceneIDs.h"
+#include "MeshInstanceTable.h"
 #include "Transform.h"
 #include "TriangleMesh.h"
 #include "VertexAttrib.slangh"
@@ -80,6 +81,7 @@ namespace Falcor
 
             UseCache                        = 0x10000000, ///< Enable scene caching. This caches the runtime scene representation on disk to reduce load time.
             RebuildCache                    = 0x20000000, ///< Rebuild scene cache.
+            UseBakedTextures                = 0x40000000, ///< Load material textures from the baked texture cache when available. Use the TextureBaker tool to fill the cache.
 
             Default = None
         };
@@ -444,6 +446,19 @@ namespace Falcor
         */
         MeshID addProcessedMesh(const ProcessedMesh& mesh);
 
+        /** Add a pre-processed mesh. The vertex and index data is moved into the scene builder instead of being copied.
+            \param mesh The pre-processed mesh (will be moved from).
+            \return The ID of the mesh in the scene. Note that all of the instances share the same mesh ID.
+        */
+        MeshID addProcessedMesh(ProcessedMesh&& mesh);
+
+        /** Add a list of pre-processed meshes.
+            This is equivalent to adding the meshes one by one in order, but each distinct material is only looked up once.
+            \param meshes The pre-processed meshes (will be moved from).
+            \return The ID of the first mesh. The meshes are assigned consecutive IDs in list order.
+        */
+        MeshID addProcessedMeshes(std::vector<ProcessedMesh>&& meshes);
+
         /** Add mesh vertex cache for animation.
             \param[in] cachedCurves The mesh vertex cache data (will be moved from).
         */
@@ -480,6 +495,12 @@ namespace Falcor
         */
         CurveID addProcessedCurve(const ProcessedCurve& curve);
 
+        /** Add a pre-processed curve. The vertex and index data is moved into the scene builder instead of being copied.
+            \param curve The pre-processed curve (will be moved from).
+            \return The ID of the curve in the scene. Note that all of the instances share the same curve ID.
+        */
+        CurveID addProcessedCurve(ProcessedCurve&& curve);
+
         /** Set curve vertex cache for animation.
             \param[in] cachedCurves The dynamic curve vertex cache data.
         */
@@ -651,6 +672,13 @@ namespace Falcor
         */
         void addMeshInstance(NodeID nodeID, MeshID meshID);
 
+        /** Add the instances of object definitions collected by an importer.
+            One node is added per instance and all meshes of the instanced definition are attached to it, so the meshes of a
+            definition are built into a single BLAS. The meshes are never duplicated, even with Flags::FlattenStaticMeshInstances.
+            \param[in] instanceTable Object definitions and their instances.
+        */
+        void addMeshInstances(const MeshInstanceTable& instanceTable);
+
         /** Add a curve instance to a node.
         */
         void addCurveInstance(NodeID nodeID, CurveID curveID);
@@ -708,6 +736,7 @@ namespace Falcor
             bool isFrontFaceCW = false;             ///< Indicate whether front-facing side has clockwise winding in object space.
             bool isDisplaced = false;               ///< True if mesh has displacement map.
             bool isAnimated = false;                ///< True if the mesh vertices can be modified during rendering (e.g., skinning or inverse rendering).
+            bool keepInstanced = false;             ///< True if the mesh is part of an instanced object definition and must not be flattened. See addMeshInstances().
             AABB boundingBox;                       ///< Mesh bounding-box in object space.
             std::set<NodeID> instances;             ///< IDs of all nodes that instantiate this mesh.
 
@@ -794,6 +823,7 @@ namespace Falcor
         bool mergeNodes(NodeID dstNodeID, NodeID srcNodeID);
         void flipTriangleWinding(MeshSpec& mesh);
         void updateSDFGridID(SdfGridID oldID, SdfGridID newID);
+        MeshID addProcessedMesh(ProcessedMesh&& mesh, MaterialID materialID);
 
         /** Split a mesh by the given axis-aligned splitting plane.
             \return Pair of optional mesh IDs for the meshes on the left and right side, respectively.
@@ -843,6 +873,7 @@ namespace Falcor
 
         friend class SceneCache;
         friend class SceneBuilderDump;
+        friend class SceneDescFile;
     };
 
     FALCOR_ENUM_CLASS_OPERATORS(SceneBuilder::Flags);
@@ -0,0 +1,641 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SceneDescFile.h"
+#include "SceneBuilder.h"
+#include "SceneCache.h"
+#include "Core/Error.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing/TimeReport.h"
+
+#include <BS_thread_pool/BS_thread_pool.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <streambuf>
+#include <type_traits>
+
+namespace Falcor
+{
+namespace
+{
+const char kMagic[8] = {'F', 'a', 'l', 'c', 'o', 'r', 'S', 'D'};
+
+/// Current file format version. This needs to be incremented every time the file format changes!
+const uint32_t kVersion = 1;
+
+/// Alignment of sections in the file, so that the arrays in a mapped file are aligned for their element types.
+const uint64_t kSectionAlignment = 64;
+
+const uint32_t kInvalidIndex = uint32_t(-1);
+
+enum class Section : uint32_t
+{
+    Objects,          ///< Render settings, cameras, lights, environment map, materials, animations and metadata.
+    Strings,          ///< Node and mesh names.
+    Nodes,            ///< NodeRecord array.
+    Meshes,           ///< MeshRecord array.
+    MeshInstances,    ///< Node indices of all mesh instances (uint32_t array).
+    StaticVertexData, ///< StaticVertexData array.
+    IndexData,        ///< Vertex indices in 32-bit words, with 16-bit indices packed tightly.
+    SkinningData,     ///< SkinningVertexData array.
+
+    Count
+};
+
+struct SectionDesc
+{
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+
+struct Header
+{
+    char magic[8] = {};
+    uint32_t version = 0;
+    uint32_t sectionCount = 0;
+    SectionDesc sections[(size_t)Section::Count];
+};
+
+struct NodeRecord
+{
+    float4x4 transform;
+    float4x4 meshBind;
+    float4x4 localToBindPose;
+    uint64_t nameOffset = 0;
+    uint32_t nameLength = 0;
+    uint32_t parent = kInvalidIndex; ///< Index of the parent node, which always precedes the node.
+};
+
+enum class MeshRecordFlags : uint32_t
+{
+    None = 0x0,
+    Use16BitIndices = 0x1,
+    FrontFaceCW = 0x2,
+    Animated = 0x4,
+    KeepInstanced = 0x8,
+};
+FALCOR_ENUM_CLASS_OPERATORS(MeshRecordFlags);
+
+struct MeshRecord
+{
+    uint64_t nameOffset = 0;
+    uint32_t nameLength = 0;
+    uint32_t materialIndex = 0;              ///< Index of the material in the file.
+    uint32_t topology = 0;                   ///< Vao::Topology.
+    uint32_t skeletonNode = kInvalidIndex;   ///< Skeleton node index or kInvalidIndex.
+    MeshRecordFlags flags = MeshRecordFlags::None;
+    uint32_t instanceCount = 0;
+    uint64_t instanceOffset = 0;             ///< Offset into the MeshInstances section in elements.
+    uint64_t indexCount = 0;
+    uint64_t indexOffset = 0;                ///< Offset into the IndexData section in 32-bit words.
+    uint64_t indexWordCount = 0;
+    uint64_t vertexOffset = 0;               ///< Offset into the StaticVertexData section in elements.
+    uint64_t vertexCount = 0;
+    uint64_t skinningOffset = 0;             ///< Offset into the SkinningData section in elements.
+    uint64_t skinningCount = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<Header>);
+static_assert(std::is_trivially_copyable_v<NodeRecord>);
+static_assert(std::is_trivially_copyable_v<MeshRecord>);
+static_assert(std::is_trivially_copyable_v<StaticVertexData>);
+static_assert(std::is_trivially_copyable_v<SkinningVertexData>);
+
+uint64_t alignSection(uint64_t offset)
+{
+    return (offset + kSectionAlignment - 1) / kSectionAlignment * kSectionAlignment;
+}
+
+/// Read-only stream buffer over memory, used to read serialized objects directly from the mapped file.
+class MemoryStreamBuffer : public std::streambuf
+{
+public:
+    MemoryStreamBuffer(const void* pData, size_t size)
+    {
+        char* pBegin = const_cast<char*>(static_cast<const char*>(pData));
+        setg(pBegin, pBegin, pBegin + size);
+    }
+};
+
+/// View of the sections of a scene description in memory.
+class SectionReader
+{
+public:
+    SectionReader(const void* pData, size_t size) : mpData(static_cast<const uint8_t*>(pData)), mSize(size)
+    {
+        if (!SceneDescFile::isSceneDesc(pData, size) || size < sizeof(Header))
+            FALCOR_THROW("Invalid scene description file identifier.");
+        std::memcpy(&mHeader, pData, sizeof(Header));
+        if (mHeader.version != kVersion)
+            FALCOR_THROW("Unsupported scene description version {} (expected {}).", mHeader.version, kVersion);
+        if (mHeader.sectionCount != (uint32_t)Section::Count)
+            FALCOR_THROW("Invalid section count {}.", mHeader.sectionCount);
+        for (const auto& section : mHeader.sections)
+        {
+            if (section.offset > mSize || section.size > mSize - section.offset)
+                FALCOR_THROW("Scene description is truncated.");
+        }
+    }
+
+    std::pair<const uint8_t*, size_t> getBytes(Section section) const
+    {
+        const SectionDesc& desc = mHeader.sections[(size_t)section];
+        return {mpData + desc.offset, (size_t)desc.size};
+    }
+
+    /// Get a section as array of T. The data is not necessarily aligned for T, so elements need to be copied out.
+    template<typename T>
+    std::pair<const uint8_t*, size_t> getArray(Section section) const
+    {
+        auto [pData, size] = getBytes(section);
+        if (size % sizeof(T) != 0)
+            FALCOR_THROW("Invalid size of scene description section {}.", (uint32_t)section);
+        return {pData, size / sizeof(T)};
+    }
+
+    template<typename T>
+    std::vector<T> readArray(Section section) const
+    {
+        auto [pData, count] = getArray<T>(section);
+        std::vector<T> result(count);
+        if (count > 0)
+            std::memcpy(result.data(), pData, count * sizeof(T));
+        return result;
+    }
+
+private:
+    const uint8_t* mpData;
+    size_t mSize;
+    Header mHeader;
+};
+
+std::string readString(const std::pair<const uint8_t*, size_t>& strings, uint64_t offset, uint32_t length)
+{
+    if (offset > strings.second || length > strings.second - offset)
+        FALCOR_THROW("Invalid string in scene description.");
+    return std::string(reinterpret_cast<const char*>(strings.first + offset), length);
+}
+
+bool isRangeValid(uint64_t offset, uint64_t count, size_t size)
+{
+    return offset <= size && count <= size - offset;
+}
+} // namespace
+
+void SceneDescFile::write(SceneBuilder& sceneBuilder, const std::filesystem::path& path)
+{
+    FALCOR_CHECK(sceneBuilder.mpScene == nullptr, "Scene description can only be written before the scene is built.");
+
+    // Textures are referenced by their source path, which is only known after loading.
+    sceneBuilder.waitForMaterialTextureLoading();
+
+    const Scene::SceneData& sceneData = sceneBuilder.mSceneData;
+
+    if (!sceneBuilder.mCurves.empty())
+        logWarning("SceneDescFile: Curves are not supported and are not written to '{}'.", path);
+    if (!sceneData.sdfGrids.empty())
+        logWarning("SceneDescFile: SDF grids are not supported and are not written to '{}'.", path);
+    if (!sceneData.gridVolumes.empty())
+        logWarning("SceneDescFile: Grid volumes are not supported and are not written to '{}'.", path);
+    if (!sceneData.customPrimitiveDesc.empty())
+        logWarning("SceneDescFile: Custom primitives are not supported and are not written to '{}'.", path);
+    if (!sceneData.cachedMeshes.empty() || !sceneData.cachedCurves.empty())
+        logWarning("SceneDescFile: Vertex animations are not supported and are not written to '{}'.", path);
+
+    // Serialize objects with the scene cache serialization.
+    std::ostringstream objectStream(std::ios_base::binary);
+    {
+        SceneCache::OutputStream stream(objectStream);
+
+        SceneCache::writeMarker(stream, "RenderSettings");
+        stream.write(sceneData.renderSettings);
+
+        SceneCache::writeMarker(stream, "Cameras");
+        stream.write((uint32_t)sceneData.cameras.size());
+        for (const auto& pCamera : sceneData.cameras)
+            SceneCache::writeCamera(stream, pCamera);
+        stream.write(sceneData.selectedCamera);
+        stream.write(sceneData.cameraSpeed);
+
+        SceneCache::writeMarker(stream, "Lights");
+        stream.write((uint32_t)sceneData.lights.size());
+        for (const auto& pLight : sceneData.lights)
+            SceneCache::writeLight(stream, pLight);
+
+        SceneCache::writeMarker(stream, "EnvMap");
+        bool hasEnvMap = sceneData.pEnvMap != nullptr;
+        stream.write(hasEnvMap);
+        if (hasEnvMap)
+            SceneCache::writeEnvMap(stream, sceneData.pEnvMap);
+
+        SceneCache::writeMarker(stream, "Materials");
+        SceneCache::writeMaterials(stream, *sceneData.pMaterials);
+
+        SceneCache::writeMarker(stream, "Animations");
+        stream.write((uint32_t)sceneData.animations.size());
+        for (const auto& pAnimation : sceneData.animations)
+            SceneCache::writeAnimation(stream, pAnimation);
+
+        SceneCache::writeMarker(stream, "Metadata");
+        SceneCache::writeMetadata(stream, sceneData.metadata);
+
+        SceneCache::writeMarker(stream, "End");
+    }
+    const std::string objectData = objectStream.str();
+
+    // Build the node and mesh tables.
+    std::string strings;
+    auto addString = [&strings](const std::string& str, uint64_t& offset, uint32_t& length)
+    {
+        offset = strings.size();
+        length = (uint32_t)str.size();
+        strings += str;
+    };
+
+    std::vector<NodeRecord> nodes(sceneBuilder.mSceneGraph.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        const auto& node = sceneBuilder.mSceneGraph[i];
+        NodeRecord& record = nodes[i];
+        record.transform = node.transform;
+        record.meshBind = node.meshBind;
+        record.localToBindPose = node.localToBindPose;
+        record.parent = node.parent.isValid() ? node.parent.get() : kInvalidIndex;
+        addString(node.name, record.nameOffset, record.nameLength);
+    }
+
+    std::vector<MeshRecord> meshes(sceneBuilder.mMeshes.size());
+    std::vector<uint32_t> meshInstances;
+    uint64_t indexWordCount = 0;
+    uint64_t vertexCount = 0;
+    uint64_t skinningCount = 0;
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const auto& mesh = sceneBuilder.mMeshes[i];
+        MeshRecord& record = meshes[i];
+        addString(mesh.name, record.nameOffset, record.nameLength);
+        record.materialIndex = mesh.materialId.get();
+        record.topology = (uint32_t)mesh.topology;
+        record.skeletonNode = mesh.skeletonNodeID.isValid() ? mesh.skeletonNodeID.get() : kInvalidIndex;
+        if (mesh.use16BitIndices)
+            record.flags |= MeshRecordFlags::Use16BitIndices;
+        if (mesh.isFrontFaceCW)
+            record.flags |= MeshRecordFlags::FrontFaceCW;
+        if (mesh.isAnimated)
+            record.flags |= MeshRecordFlags::Animated;
+        if (mesh.keepInstanced)
+            record.flags |= MeshRecordFlags::KeepInstanced;
+
+        record.instanceCount = (uint32_t)mesh.instances.size();
+        record.instanceOffset = meshInstances.size();
+        for (NodeID nodeID : mesh.instances)
+            meshInstances.push_back(nodeID.get());
+
+        record.indexCount = mesh.indexCount;
+        record.indexOffset = indexWordCount;
+        record.indexWordCount = mesh.indexData.size();
+        indexWordCount += mesh.indexData.size();
+
+        record.vertexOffset = vertexCount;
+        record.vertexCount = mesh.staticData.size();
+        vertexCount += mesh.staticData.size();
+
+        record.skinningOffset = skinningCount;
+        record.skinningCount = mesh.skinningData.size();
+        skinningCount += mesh.skinningData.size();
+    }
+
+    // Lay out the sections.
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.sectionCount = (uint32_t)Section::Count;
+
+    auto& sections = header.sections;
+    sections[(size_t)Section::Objects].size = objectData.size();
+    sections[(size_t)Section::Strings].size = strings.size();
+    sections[(size_t)Section::Nodes].size = nodes.size() * sizeof(NodeRecord);
+    sections[(size_t)Section::Meshes].size = meshes.size() * sizeof(MeshRecord);
+    sections[(size_t)Section::MeshInstances].size = meshInstances.size() * sizeof(uint32_t);
+    sections[(size_t)Section::StaticVertexData].size = vertexCount * sizeof(StaticVertexData);
+    sections[(size_t)Section::IndexData].size = indexWordCount * sizeof(uint32_t);
+    sections[(size_t)Section::SkinningData].size = skinningCount * sizeof(SkinningVertexData);
+
+    uint64_t offset = alignSection(sizeof(Header));
+    for (auto& section : sections)
+    {
+        section.offset = offset;
+        offset = alignSection(offset + section.size);
+    }
+
+    // Write the file. Mesh data is streamed directly from the builder.
+    std::ofstream fs(path, std::ios_base::binary);
+    if (!fs)
+        FALCOR_THROW("Failed to create scene description file '{}'.", path);
+
+    fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    auto beginSection = [&](Section section)
+    {
+        static const char kPadding[kSectionAlignment] = {};
+        uint64_t position = (uint64_t)fs.tellp();
+        FALCOR_ASSERT(position <= sections[(size_t)section].offset);
+        fs.write(kPadding, sections[(size_t)section].offset - position);
+    };
+    auto writeData = [&fs](const void* pData, size_t size) { fs.write(static_cast<const char*>(pData), size); };
+
+    beginSection(Section::Objects);
+    writeData(objectData.data(), objectData.size());
+    beginSection(Section::Strings);
+    writeData(strings.data(), strings.size());
+    beginSection(Section::Nodes);
+    writeData(nodes.data(), nodes.size() * sizeof(NodeRecord));
+    beginSection(Section::Meshes);
+    writeData(meshes.data(), meshes.size() * sizeof(MeshRecord));
+    beginSection(Section::MeshInstances);
+    writeData(meshInstances.data(), meshInstances.size() * sizeof(uint32_t));
+    beginSection(Section::StaticVertexData);
+    for (const auto& mesh : sceneBuilder.mMeshes)
+        writeData(mesh.staticData.data(), mesh.staticData.size() * sizeof(StaticVertexData));
+    beginSection(Section::IndexData);
+    for (const auto& mesh : sceneBuilder.mMeshes)
+        writeData(mesh.indexData.data(), mesh.indexData.size() * sizeof(uint32_t));
+    beginSection(Section::SkinningData);
+    for (const auto& mesh : sceneBuilder.mMeshes)
+        writeData(mesh.skinningData.data(), mesh.skinningData.size() * sizeof(SkinningVertexData));
+
+    if (!fs)
+        FALCOR_THROW("Failed to write scene description file '{}'.", path);
+
+    logInfo(
+        "SceneDescFile: Wrote {} nodes, {} meshes, {} mesh instances and {} materials to '{}' ({} MB).",
+        nodes.size(),
+        meshes.size(),
+        meshInstances.size(),
+        sceneData.pMaterials->getMaterialCount(),
+        path,
+        offset / (1024 * 1024)
+    );
+}
+
+void SceneDescFile::read(const std::filesystem::path& path, SceneBuilder& sceneBuilder)
+{
+    MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+    if (!file.isOpen())
+        FALCOR_THROW("Failed to open scene description file '{}'.", path);
+    readFromMemory(file.getData(), file.getMappedSize(), sceneBuilder);
+}
+
+void SceneDescFile::readFromMemory(const void* pData, size_t size, SceneBuilder& sceneBuilder)
+{
+    FALCOR_CHECK(pData != nullptr, "'pData' is missing");
+
+    TimeReport timeReport;
+    SectionReader reader(pData, size);
+
+    // Node indices in the file are relative to the nodes already in the builder.
+    const uint32_t nodeBase = sceneBuilder.getNodeCount();
+    // Scene-wide settings are only taken from the file if it describes the whole scene, they must not override the
+    // settings of content that is already in the builder.
+    const bool isEmpty = nodeBase == 0 && sceneBuilder.mMeshes.empty() && sceneBuilder.getCameras().empty();
+    uint32_t nodeCount = 0;
+    auto getNodeID = [&](uint32_t index)
+    {
+        if (index == kInvalidIndex)
+            return NodeID::Invalid();
+        if (index >= nodeCount)
+            FALCOR_THROW("Invalid node index {} in scene description.", index);
+        return NodeID{nodeBase + index};
+    };
+    auto remapNodeID = [&](NodeID nodeID) { return getNodeID(nodeID.isValid() ? nodeID.get() : kInvalidIndex); };
+
+    // Read the scene graph first, so that objects can be attached to its nodes.
+    const auto strings = reader.getBytes(Section::Strings);
+    const auto nodes = reader.readArray<NodeRecord>(Section::Nodes);
+    nodeCount = (uint32_t)nodes.size();
+    sceneBuilder.mSceneGraph.reserve(sceneBuilder.mSceneGraph.size() + nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        const NodeRecord& record = nodes[i];
+        if (record.parent != kInvalidIndex && record.parent >= i)
+            FALCOR_THROW("Invalid parent of node {} in scene description.", i);
+
+        SceneBuilder::Node node;
+        node.name = readString(strings, record.nameOffset, record.nameLength);
+        node.transform = record.transform;
+        node.meshBind = record.meshBind;
+        node.localToBindPose = record.localToBindPose;
+        node.parent = getNodeID(record.parent);
+        sceneBuilder.addNode(node);
+    }
+    timeReport.measure("Add nodes");
+
+    // Read objects.
+    std::vector<ref<Material>> materials;
+    {
+        const auto objectData = reader.getBytes(Section::Objects);
+        MemoryStreamBuffer buffer(objectData.first, objectData.second);
+        std::istream objectStream(&buffer);
+        SceneCache::InputStream stream(objectStream);
+        const ref<Device>& pDevice = sceneBuilder.getDevice();
+
+        SceneCache::readMarker(stream, "RenderSettings");
+        const auto renderSettings = stream.read<Scene::RenderSettings>();
+        if (isEmpty)
+            sceneBuilder.setRenderSettings(renderSettings);
+
+        SceneCache::readMarker(stream, "Cameras");
+        std::vector<ref<Camera>> cameras(stream.read<uint32_t>());
+        for (auto& pCamera : cameras)
+        {
+            pCamera = SceneCache::readCamera(stream);
+            pCamera->setNodeID(remapNodeID(pCamera->getNodeID()));
+            sceneBuilder.addCamera(pCamera);
+        }
+        uint32_t selectedCamera = stream.read<uint32_t>();
+        float cameraSpeed = stream.read<float>();
+        if (isEmpty)
+        {
+            if (selectedCamera < cameras.size())
+                sceneBuilder.setSelectedCamera(cameras[selectedCamera]);
+            sceneBuilder.setCameraSpeed(cameraSpeed);
+        }
+
+        SceneCache::readMarker(stream, "Lights");
+        uint32_t lightCount = stream.read<uint32_t>();
+        for (uint32_t i = 0; i < lightCount; ++i)
+        {
+            auto pLight = SceneCache::readLight(stream);
+            pLight->setNodeID(remapNodeID(pLight->getNodeID()));
+            sceneBuilder.addLight(pLight);
+        }
+
+        SceneCache::readMarker(stream, "EnvMap");
+        if (stream.read<bool>())
+            sceneBuilder.setEnvMap(SceneCache::readEnvMap(stream, pDevice));
+
+        SceneCache::readMarker(stream, "Materials");
+        materials.resize(stream.read<uint32_t>());
+        for (auto& pMaterial : materials)
+        {
+            pMaterial = SceneCache::readMaterial(stream, sceneBuilder.getMaterialTextureLoader(), pDevice);
+            sceneBuilder.addMaterial(pMaterial);
+        }
+
+        SceneCache::readMarker(stream, "Animations");
+        uint32_t animationCount = stream.read<uint32_t>();
+        for (uint32_t i = 0; i < animationCount; ++i)
+        {
+            auto pAnimation = SceneCache::readAnimation(stream);
+            pAnimation->setNodeID(remapNodeID(pAnimation->getNodeID()));
+            sceneBuilder.addAnimation(pAnimation);
+        }
+
+        SceneCache::readMarker(stream, "Metadata");
+        const auto metadata = SceneCache::readMetadata(stream);
+        if (isEmpty)
+            sceneBuilder.setMetadata(metadata);
+
+        SceneCache::readMarker(stream, "End");
+        if (!objectStream)
+            FALCOR_THROW("Scene description object data is truncated.");
+    }
+    timeReport.measure("Read objects");
+
+    // Validate the mesh table before copying the mesh data in parallel.
+    const auto meshes = reader.readArray<MeshRecord>(Section::Meshes);
+    const auto instances = reader.readArray<uint32_t>(Section::MeshInstances);
+    const auto vertexData = reader.getArray<StaticVertexData>(Section::StaticVertexData);
+    const auto indexData = reader.getArray<uint32_t>(Section::IndexData);
+    const auto skinningData = reader.getArray<SkinningVertexData>(Section::SkinningData);
+    const bool isIndexed = !is_set(sceneBuilder.getFlags(), SceneBuilder::Flags::NonIndexedVertices);
+
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const MeshRecord& record = meshes[i];
+        bool isValid = record.materialIndex < materials.size() &&
+                       isRangeValid(record.instanceOffset, record.instanceCount, instances.size()) &&
+                       isRangeValid(record.indexOffset, record.indexWordCount, indexData.second) &&
+                       isRangeValid(record.vertexOffset, record.vertexCount, vertexData.second) &&
+                       isRangeValid(record.skinningOffset, record.skinningCount, skinningData.second) &&
+                       record.vertexCount <= std::numeric_limits<uint32_t>::max() &&
+                       record.indexCount <= std::numeric_limits<uint32_t>::max();
+        if (!isValid)
+            FALCOR_THROW("Invalid mesh {} in scene description.", i);
+        if (!isIndexed && record.indexCount > 0)
+            FALCOR_THROW("Scene descriptions with indexed meshes can't be loaded with SceneBuilder::Flags::NonIndexedVertices.");
+    }
+
+    std::vector<SceneBuilder::ProcessedMesh> processedMeshes(meshes.size());
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const MeshRecord& record = meshes[i];
+        auto& mesh = processedMeshes[i];
+        mesh.name = readString(strings, record.nameOffset, record.nameLength);
+        mesh.topology = (Vao::Topology)record.topology;
+        mesh.pMaterial = materials[record.materialIndex];
+        mesh.skeletonNodeId = getNodeID(record.skeletonNode);
+        mesh.indexCount = record.indexCount;
+        mesh.use16BitIndices = is_set(record.flags, MeshRecordFlags::Use16BitIndices);
+        mesh.isFrontFaceCW = is_set(record.flags, MeshRecordFlags::FrontFaceCW);
+        mesh.isAnimated = is_set(record.flags, MeshRecordFlags::Animated);
+    }
+
+    BS::thread_pool threadPool;
+    threadPool
+        .parallelize_loop(
+            0,
+            meshes.size(),
+            [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    const MeshRecord& record = meshes[i];
+                    auto& mesh = processedMeshes[i];
+                    mesh.indexData.resize(record.indexWordCount);
+                    std::memcpy(
+                        mesh.indexData.data(),
+                        indexData.first + record.indexOffset * sizeof(uint32_t),
+                        record.indexWordCount * sizeof(uint32_t)
+                    );
+                    mesh.staticData.resize(record.vertexCount);
+                    std::memcpy(
+                        mesh.staticData.data(),
+                        vertexData.first + record.vertexOffset * sizeof(StaticVertexData),
+                        record.vertexCount * sizeof(StaticVertexData)
+                    );
+                    mesh.skinningData.resize(record.skinningCount);
+                    std::memcpy(
+                        mesh.skinningData.data(),
+                        skinningData.first + record.skinningOffset * sizeof(SkinningVertexData),
+                        record.skinningCount * sizeof(SkinningVertexData)
+                    );
+                    // Bone IDs are node IDs.
+                    if (nodeBase > 0)
+                    {
+                        for (auto& vertex : mesh.skinningData)
+                            vertex.boneID += uint4(nodeBase);
+                    }
+                }
+            }
+        )
+        .wait();
+    timeReport.measure("Read meshes");
+
+    const MeshID firstMeshID = sceneBuilder.addProcessedMeshes(std::move(processedMeshes));
+    size_t instanceCount = 0;
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const MeshRecord& record = meshes[i];
+        const MeshID meshID{firstMeshID.get() + i};
+        sceneBuilder.mMeshes[meshID.get()].keepInstanced = is_set(record.flags, MeshRecordFlags::KeepInstanced);
+        for (uint32_t j = 0; j < record.instanceCount; ++j)
+            sceneBuilder.addMeshInstance(getNodeID(instances[record.instanceOffset + j]), meshID);
+        instanceCount += record.instanceCount;
+    }
+    timeReport.measure("Add meshes");
+
+    logInfo(
+        "SceneDescFile: Read {} nodes, {} meshes, {} mesh instances and {} materials.",
+        nodes.size(),
+        meshes.size(),
+        instanceCount,
+        materials.size()
+    );
+    timeReport.printToLog();
+}
+
+bool SceneDescFile::isSceneDesc(const void* pData, size_t size)
+{
+    return pData && size >= sizeof(kMagic) && std::memcmp(pData, kMagic, sizeof(kMagic)) == 0;
+}
+} // namespace Falcor
@@ -0,0 +1,90 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <filesystem>
+
+namespace Falcor
+{
+class SceneBuilder;
+
+/**
+ * Reader and writer for binary scene description files (.fscene).
+ *
+ * A scene description stores the content of a SceneBuilder before the scene is built: scene graph nodes, meshes with
+ * their instances, materials, cameras, lights, animations, the environment map, render settings and metadata. Loading
+ * a scene description drives the SceneBuilder in bulk, which is much faster than running the Python scene script the
+ * builder state was created from, especially for generated scenes with many objects.
+ *
+ * Meshes are stored pre-processed (the vertex and index data of SceneBuilder::ProcessedMesh). The file is memory
+ * mapped on load and the flat node, mesh, vertex and index arrays are copied straight into the builder. Materials,
+ * cameras, lights and animations use the same serialization as the scene cache. Textures are referenced by path.
+ *
+ * Curves, SDF grids, grid volumes, custom primitives and vertex-animated mesh caches are not stored. A warning is
+ * logged when exporting a builder that contains them.
+ */
+class FALCOR_API SceneDescFile
+{
+public:
+    /// File extension of scene description files.
+    static constexpr const char* kExtension = "fscene";
+
+    /**
+     * Write the current content of a scene builder to a scene description file.
+     * Waits for pending material textures to be loaded, as textures are referenced by their source path.
+     * Throws a RuntimeError if the file cannot be written or the builder contains materials that can't be serialized.
+     * @param[in] sceneBuilder Scene builder. Must not have built the scene yet.
+     * @param[in] path File path.
+     */
+    static void write(SceneBuilder& sceneBuilder, const std::filesystem::path& path);
+
+    /**
+     * Read a scene description file and add its content to a scene builder.
+     * Nodes and objects are appended to the content already in the builder. The render settings, metadata, selected
+     * camera and camera speed are only applied if the builder is empty (no nodes, meshes or cameras), otherwise the
+     * builder keeps its own.
+     * Throws a RuntimeError if the file cannot be read or is invalid.
+     * @param[in] path File path.
+     * @param[in] sceneBuilder Scene builder.
+     */
+    static void read(const std::filesystem::path& path, SceneBuilder& sceneBuilder);
+
+    /**
+     * Read a scene description from memory and add its content to a scene builder.
+     * The content is added the same way as with read().
+     * Throws a RuntimeError if the data is invalid.
+     * @param[in] pData Scene description data.
+     * @param[in] size Size of the data in bytes.
+     * @param[in] sceneBuilder Scene builder.
+     */
+    static void readFromMemory(const void* pData, size_t size, SceneBuilder& sceneBuilder);
+
+    /// Returns true if the data starts with the scene description file identifier.
+    static bool isSceneDesc(const void* pData, size_t size);
+};
+} // namespace Falcor
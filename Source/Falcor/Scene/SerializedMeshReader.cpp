@@ -0,0 +1,362 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SerializedMeshReader.h"
+#include "Core/Error.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Utils/Logger.h"
+#include "Utils/Math/Vector.h"
+
+#include <BS_thread_pool/BS_thread_pool.hpp>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace Falcor
+{
+namespace
+{
+const uint16_t kFormatIdentifier = 0x041C;
+const uint16_t kVersionV3 = 3;
+const uint16_t kVersionV4 = 4;
+
+enum MeshFlags : uint32_t
+{
+    HasNormals = 0x0001,
+    HasTexCoords = 0x0002,
+    HasColors = 0x0008,
+    FaceNormals = 0x0010,
+    SinglePrecision = 0x1000,
+    DoublePrecision = 0x2000,
+};
+
+template<typename T>
+T loadUnaligned(const uint8_t* p)
+{
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+struct Cursor
+{
+    const uint8_t* p;
+    const uint8_t* pEnd;
+
+    void require(size_t size) const
+    {
+        if (size_t(pEnd - p) < size)
+            FALCOR_THROW("Unexpected end of mesh data.");
+    }
+
+    template<typename T>
+    T read()
+    {
+        require(sizeof(T));
+        T value = loadUnaligned<T>(p);
+        p += sizeof(T);
+        return value;
+    }
+
+    void skip(size_t size)
+    {
+        require(size);
+        p += size;
+    }
+};
+
+/// Offsets of all meshes in a file, followed by the offset of the offset table itself.
+struct ShapeTable
+{
+    uint16_t version = 0;
+    std::vector<uint64_t> offsets;
+
+    uint32_t getShapeCount() const { return uint32_t(offsets.size() - 1); }
+};
+
+uint16_t readShapeHeader(const uint8_t* p)
+{
+    if (loadUnaligned<uint16_t>(p) != kFormatIdentifier)
+        FALCOR_THROW("Invalid file format identifier.");
+    uint16_t version = loadUnaligned<uint16_t>(p + 2);
+    if (version != kVersionV3 && version != kVersionV4)
+        FALCOR_THROW("Unsupported file format version {}.", version);
+    return version;
+}
+
+ShapeTable readShapeTable(const uint8_t* pData, size_t size)
+{
+    if (size < 8)
+        FALCOR_THROW("File is too small.");
+
+    ShapeTable table;
+    table.version = readShapeHeader(pData);
+
+    // Version 4 files store 64-bit offsets, version 3 files 32-bit offsets.
+    const size_t offsetSize = table.version == kVersionV4 ? sizeof(uint64_t) : sizeof(uint32_t);
+    const uint32_t count = loadUnaligned<uint32_t>(pData + size - sizeof(uint32_t));
+    if (count == 0 || (size - sizeof(uint32_t)) / offsetSize < count)
+        FALCOR_THROW("Invalid mesh count {}.", count);
+
+    const size_t tableOffset = size - sizeof(uint32_t) - count * offsetSize;
+    table.offsets.resize(count + 1);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const uint8_t* p = pData + tableOffset + i * offsetSize;
+        table.offsets[i] = offsetSize == sizeof(uint64_t) ? loadUnaligned<uint64_t>(p) : loadUnaligned<uint32_t>(p);
+    }
+    table.offsets[count] = tableOffset;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (table.offsets[i] > tableOffset || table.offsets[i + 1] < table.offsets[i] + 4)
+            FALCOR_THROW("Invalid offset table.");
+    }
+
+    return table;
+}
+
+std::vector<uint8_t> inflateMeshData(const uint8_t* pData, size_t size)
+{
+    if (size > std::numeric_limits<uInt>::max())
+        FALCOR_THROW("Compressed mesh data is too large.");
+
+    z_stream stream = {};
+    if (inflateInit(&stream) != Z_OK)
+        FALCOR_THROW("Failed to initialize zlib.");
+
+    // Start with a buffer of three times the compressed size and grow it as needed.
+    std::vector<uint8_t> data(std::max<size_t>(size * 3, 4096));
+    size_t outSize = 0;
+    stream.next_in = const_cast<Bytef*>(pData);
+    stream.avail_in = uInt(size);
+
+    int result;
+    while (true)
+    {
+        if (outSize == data.size())
+            data.resize(data.size() * 2);
+        const uInt availOut = uInt(std::min<size_t>(data.size() - outSize, std::numeric_limits<uInt>::max()));
+        stream.next_out = data.data() + outSize;
+        stream.avail_out = availOut;
+        result = inflate(&stream, Z_NO_FLUSH);
+        outSize += availOut - stream.avail_out;
+        if (result != Z_OK)
+            break;
+    }
+    inflateEnd(&stream);
+
+    if (result != Z_STREAM_END)
+        FALCOR_THROW("Failed to decompress mesh data (zlib error {}).", result);
+
+    data.resize(outSize);
+    return data;
+}
+
+/// Read 'count' vectors with N components and pass them to func(index, vector).
+template<int N, typename Func>
+void readVectors(Cursor& cursor, size_t count, bool doublePrecision, Func func)
+{
+    const size_t scalarSize = doublePrecision ? sizeof(double) : sizeof(float);
+    cursor.require(count * N * scalarSize);
+    const uint8_t* p = cursor.p;
+    for (size_t i = 0; i < count; ++i)
+    {
+        math::vector<float, N> value;
+        for (int c = 0; c < N; ++c, p += scalarSize)
+            value[c] = doublePrecision ? float(loadUnaligned<double>(p)) : loadUnaligned<float>(p);
+        func(i, value);
+    }
+    cursor.p = p;
+}
+
+ref<TriangleMesh> decodeMesh(const std::vector<uint8_t>& data, uint16_t version, TriangleMesh::ImportFlags flags)
+{
+    Cursor cursor{data.data(), data.data() + data.size()};
+
+    const uint32_t meshFlags = cursor.read<uint32_t>();
+    if (version == kVersionV4)
+    {
+        // Skip the null-terminated mesh name.
+        const void* pNameEnd = std::memchr(cursor.p, 0, size_t(cursor.pEnd - cursor.p));
+        if (!pNameEnd)
+            FALCOR_THROW("Unexpected end of mesh data.");
+        cursor.p = static_cast<const uint8_t*>(pNameEnd) + 1;
+    }
+
+    const uint64_t vertexCount = cursor.read<uint64_t>();
+    const uint64_t triangleCount = cursor.read<uint64_t>();
+    if (vertexCount == 0 || triangleCount == 0)
+        FALCOR_THROW("Mesh has no faces.");
+    if (vertexCount > std::numeric_limits<uint32_t>::max() || triangleCount > std::numeric_limits<uint32_t>::max() / 3)
+        FALCOR_THROW("Mesh is too large ({} vertices, {} triangles).", vertexCount, triangleCount);
+
+    const bool doublePrecision = (meshFlags & DoublePrecision) != 0;
+    const size_t scalarSize = doublePrecision ? sizeof(double) : sizeof(float);
+
+    // Check the size of all attributes upfront to not allocate memory for truncated data.
+    size_t vertexSize = 3 * scalarSize;
+    if (meshFlags & HasNormals)
+        vertexSize += 3 * scalarSize;
+    if (meshFlags & HasTexCoords)
+        vertexSize += 2 * scalarSize;
+    if (meshFlags & HasColors)
+        vertexSize += 3 * scalarSize;
+    cursor.require(vertexCount * vertexSize + triangleCount * 3 * sizeof(uint32_t));
+
+    TriangleMesh::VertexList vertices(vertexCount);
+    readVectors<3>(cursor, vertexCount, doublePrecision, [&](size_t i, const float3& p) { vertices[i].position = p; });
+    if (meshFlags & HasNormals)
+        readVectors<3>(cursor, vertexCount, doublePrecision, [&](size_t i, const float3& n) { vertices[i].normal = n; });
+    if (meshFlags & HasTexCoords)
+    {
+        auto setTexCoord = [&](size_t i, const float2& uv) { vertices[i].texCoord = float2(uv.x, 1.f - uv.y); };
+        readVectors<2>(cursor, vertexCount, doublePrecision, setTexCoord);
+    }
+    if (meshFlags & HasColors)
+        cursor.skip(vertexCount * 3 * scalarSize);
+
+    TriangleMesh::IndexList indices(triangleCount * 3);
+    cursor.require(indices.size() * sizeof(uint32_t));
+    std::memcpy(indices.data(), cursor.p, indices.size() * sizeof(uint32_t));
+    if (std::any_of(indices.begin(), indices.end(), [vertexCount](uint32_t index) { return index >= vertexCount; }))
+        FALCOR_THROW("Vertex index out of bounds.");
+
+    auto pMesh = TriangleMesh::create(std::move(vertices), std::move(indices));
+    if (!(meshFlags & HasNormals) || (meshFlags & FaceNormals))
+    {
+        if (is_set(flags, TriangleMesh::ImportFlags::GenSmoothNormals) && !(meshFlags & FaceNormals))
+            pMesh->generateSmoothNormals();
+        else
+            pMesh->generateFaceNormals();
+    }
+    return pMesh;
+}
+
+ref<TriangleMesh> readShape(const uint8_t* pData, const ShapeTable& table, uint32_t shapeIndex, TriangleMesh::ImportFlags flags)
+{
+    if (shapeIndex >= table.getShapeCount())
+        FALCOR_THROW("Shape index {} is out of range, the file contains {} meshes.", shapeIndex, table.getShapeCount());
+
+    const uint64_t offset = table.offsets[shapeIndex];
+    const uint64_t size = table.offsets[shapeIndex + 1] - offset;
+    const uint16_t version = readShapeHeader(pData + offset);
+    return decodeMesh(inflateMeshData(pData + offset + 4, size - 4), version, flags);
+}
+
+const uint8_t* mapFile(MemoryMappedFile& file, const std::filesystem::path& path)
+{
+    if (!file.isOpen())
+        FALCOR_THROW(std::filesystem::exists(path) ? "Cannot open file" : "File not found");
+    return static_cast<const uint8_t*>(file.getData());
+}
+} // namespace
+
+ref<TriangleMesh> SerializedMeshReader::read(const std::filesystem::path& path, uint32_t shapeIndex, ImportFlags flags)
+{
+    try
+    {
+        MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::RandomAccess);
+        return readFromMemory(mapFile(file, path), file.getSize(), shapeIndex, flags);
+    }
+    catch (const RuntimeError& e)
+    {
+        logWarning("Failed to load triangle mesh {} from '{}': {}", shapeIndex, path, e.what());
+        return nullptr;
+    }
+}
+
+std::vector<ref<TriangleMesh>> SerializedMeshReader::readShapes(
+    const std::filesystem::path& path,
+    const std::vector<uint32_t>& shapeIndices,
+    ImportFlags flags
+)
+{
+    std::vector<ref<TriangleMesh>> meshes(shapeIndices.size());
+    if (shapeIndices.empty())
+        return meshes;
+
+    try
+    {
+        MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::RandomAccess);
+        const uint8_t* pData = mapFile(file, path);
+        const ShapeTable table = readShapeTable(pData, file.getSize());
+
+        std::vector<uint32_t> uniqueIndices = shapeIndices;
+        std::sort(uniqueIndices.begin(), uniqueIndices.end());
+        uniqueIndices.erase(std::unique(uniqueIndices.begin(), uniqueIndices.end()), uniqueIndices.end());
+
+        // Every mesh is a separate zlib stream, decompress them concurrently.
+        std::vector<ref<TriangleMesh>> uniqueMeshes(uniqueIndices.size());
+        uint32_t threadCount = std::min<uint32_t>(uint32_t(uniqueIndices.size()), std::max(std::thread::hardware_concurrency(), 1u));
+        BS::thread_pool threadPool(threadCount);
+        for (size_t i = 0; i < uniqueIndices.size(); ++i)
+        {
+            threadPool.push_task(
+                [&, i]()
+                {
+                    try
+                    {
+                        uniqueMeshes[i] = readShape(pData, table, uniqueIndices[i], flags);
+                    }
+                    catch (const RuntimeError& e)
+                    {
+                        logWarning("Failed to load triangle mesh {} from '{}': {}", uniqueIndices[i], path, e.what());
+                    }
+                }
+            );
+        }
+        threadPool.wait_for_tasks();
+
+        for (size_t i = 0; i < shapeIndices.size(); ++i)
+        {
+            auto it = std::lower_bound(uniqueIndices.begin(), uniqueIndices.end(), shapeIndices[i]);
+            meshes[i] = uniqueMeshes[it - uniqueIndices.begin()];
+        }
+    }
+    catch (const RuntimeError& e)
+    {
+        logWarning("Failed to load triangle meshes from '{}': {}", path, e.what());
+    }
+
+    return meshes;
+}
+
+ref<TriangleMesh> SerializedMeshReader::readFromMemory(const void* pData, size_t size, uint32_t shapeIndex, ImportFlags flags)
+{
+    const ShapeTable table = readShapeTable(static_cast<const uint8_t*>(pData), size);
+    return readShape(static_cast<const uint8_t*>(pData), table, shapeIndex, flags);
+}
+
+uint32_t SerializedMeshReader::getShapeCount(const void* pData, size_t size)
+{
+    return readShapeTable(static_cast<const uint8_t*>(pData), size).getShapeCount();
+}
+} // namespace Falcor
@@ -0,0 +1,88 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "TriangleMesh.h"
+#include "Core/Macros.h"
+#include "Core/Object.h"
+#include <filesystem>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Reader for Mitsuba serialized meshes (.serialized files).
+ *
+ * A serialized file is a sequence of zlib compressed meshes, followed by a table with the offset of every mesh and the
+ * mesh count. Meshes are selected by their index in the file (the 'shape_index' property in Mitsuba scenes). Files are
+ * memory mapped and every mesh is inflated and decoded directly into the vertex and index lists of a TriangleMesh.
+ * File format versions 3 and 4, single and double precision data are supported, vertex colors are skipped.
+ *
+ * Texture coordinates are flipped vertically to match PlyReader. Meshes flagged with face normals or without vertex
+ * normals get face normals, or smooth normals with ImportFlags::GenSmoothNormals (if not flagged with face normals).
+ */
+class FALCOR_API SerializedMeshReader
+{
+public:
+    using ImportFlags = TriangleMesh::ImportFlags;
+
+    /**
+     * Read a triangle mesh from a serialized file.
+     * @param[in] path File path.
+     * @param[in] shapeIndex Index of the mesh in the file.
+     * @param[in] flags Import flags. Only GenSmoothNormals is used.
+     * @return Returns the triangle mesh or nullptr if the mesh failed to load (a warning is logged).
+     */
+    static ref<TriangleMesh> read(const std::filesystem::path& path, uint32_t shapeIndex, ImportFlags flags = ImportFlags::Default);
+
+    /**
+     * Read multiple meshes from a serialized file.
+     * The file is mapped once and the meshes are decompressed and decoded concurrently.
+     * @param[in] path File path.
+     * @param[in] shapeIndices Indices of the meshes in the file. Meshes referenced multiple times are decoded once.
+     * @param[in] flags Import flags. Only GenSmoothNormals is used.
+     * @return Returns the triangle meshes in the order of the indices. Meshes that failed to load are nullptr.
+     */
+    static std::vector<ref<TriangleMesh>> readShapes(
+        const std::filesystem::path& path,
+        const std::vector<uint32_t>& shapeIndices,
+        ImportFlags flags = ImportFlags::Default
+    );
+
+    /**
+     * Read a triangle mesh from serialized data in memory.
+     * Throws a RuntimeError if the data is invalid.
+     */
+    static ref<TriangleMesh> readFromMemory(const void* pData, size_t size, uint32_t shapeIndex, ImportFlags flags = ImportFlags::Default);
+
+    /**
+     * Get the number of meshes in serialized data in memory.
+     * Throws a RuntimeError if the data is invalid.
+     */
+    static uint32_t getShapeCount(const void* pData, size_t size);
+};
+} // namespace Falcor
@@ -43,9 +43,9 @@ namespace Falcor
         return ref<TriangleMesh>(new TriangleMesh());
     }
 
-    ref<TriangleMesh> TriangleMesh::create(const VertexList& vertices, const IndexList& indices, bool frontFaceCW)
+    ref<TriangleMesh> TriangleMesh::create(VertexList vertices, IndexList indices, bool frontFaceCW)
     {
-        return ref<TriangleMesh>(new TriangleMesh(vertices, indices, frontFaceCW));
+        return ref<TriangleMesh>(new TriangleMesh(std::move(vertices), std::move(indices), frontFaceCW));
     }
 
     ref<TriangleMesh> TriangleMesh::createDummy()
@@ -313,12 +313,54 @@ namespace Falcor
         if (flippedWinding) mFrontFaceCW = !mFrontFaceCW;
     }
 
+    void TriangleMesh::generateSmoothNormals()
+    {
+        for (auto& vertex : mVertices) vertex.normal = float3(0.f);
+
+        for (size_t i = 0; i + 2 < mIndices.size(); i += 3)
+        {
+            auto& v0 = mVertices[mIndices[i]];
+            auto& v1 = mVertices[mIndices[i + 1]];
+            auto& v2 = mVertices[mIndices[i + 2]];
+            float3 n = cross(v1.position - v0.position, v2.position - v0.position);
+            v0.normal += n;
+            v1.normal += n;
+            v2.normal += n;
+        }
+
+        for (auto& vertex : mVertices)
+        {
+            float len = length(vertex.normal);
+            vertex.normal = len > 0.f ? vertex.normal / len : float3(0.f, 0.f, 1.f);
+        }
+    }
+
+    void TriangleMesh::generateFaceNormals()
+    {
+        VertexList vertices(mIndices.size());
+        for (size_t i = 0; i + 2 < mIndices.size(); i += 3)
+        {
+            for (size_t j = 0; j < 3; ++j) vertices[i + j] = mVertices[mIndices[i + j]];
+
+            float3 n = cross(vertices[i + 1].position - vertices[i].position, vertices[i + 2].position - vertices[i].position);
+            float len = length(n);
+            n = len > 0.f ? n / len : float3(0.f, 0.f, 1.f);
+
+            for (size_t j = 0; j < 3; ++j)
+            {
+                vertices[i + j].normal = n;
+                mIndices[i + j] = uint32_t(i + j);
+            }
+        }
+        mVertices = std::move(vertices);
+    }
+
     TriangleMesh::TriangleMesh()
     {}
 
-    TriangleMesh::TriangleMesh(const VertexList& vertices, const IndexList& indices, bool frontFaceCW)
-        : mVertices(vertices)
-        , mIndices(indices)
+    TriangleMesh::TriangleMesh(VertexList vertices, IndexList indices, bool frontFaceCW)
+        : mVertices(std::move(vertices))
+        , mIndices(std::move(indices))
         , mFrontFaceCW(frontFaceCW)
     {}
 
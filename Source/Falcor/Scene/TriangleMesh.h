@@ -71,12 +71,12 @@ namespace Falcor
         static ref<TriangleMesh> create();
 
         /** Creates a triangle mesh.
-            \param[in] vertices Vertex list.
-            \param[in] indices Index list.
+            \param[in] vertices Vertex list. Pass an rvalue to avoid copying.
+            \param[in] indices Index list. Pass an rvalue to avoid copying.
             \param[in] frontFaceCW Triangle winding.
             \return Returns the triangle mesh.
         */
-        static ref<TriangleMesh> create(const VertexList& vertices, const IndexList& indices, bool frontFaceCW = false);
+        static ref<TriangleMesh> create(VertexList vertices, IndexList indices, bool frontFaceCW = false);
 
         /** Creates a dummy mesh (single degenerate triangle).
             \return Returns the triangle mesh.
@@ -186,9 +186,18 @@ namespace Falcor
         */
         void applyTransform(const float4x4& transform);
 
+        /** Replaces the vertex normals by smooth normals, computed as the area weighted average of the adjacent face normals.
+        */
+        void generateSmoothNormals();
+
+        /** Replaces the vertex normals by face normals.
+            Vertices shared between triangles are duplicated, every triangle gets its own three vertices.
+        */
+        void generateFaceNormals();
+
     private:
         TriangleMesh();
-        TriangleMesh(const VertexList& vertices, const IndexList& indices, bool frontFaceCW);
+        TriangleMesh(VertexList vertices, IndexList indices, bool frontFaceCW);
 
         std::string mName;
         std::vector<Vertex> mVertices;
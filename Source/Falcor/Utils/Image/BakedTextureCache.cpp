@@ -0,0 +1,349 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BakedTextureCache.h"
+#include "Bitmap.h"
+#include "MipGenerator.h"
+#include "Core/Error.h"
+#include "Core/Platform/OS.h"
+#include "Utils/CryptoUtils.h"
+#include "Utils/Logger.h"
+#include "Utils/StringFormatters.h"
+#include <BS_thread_pool/BS_thread_pool.hpp>
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+namespace Falcor
+{
+namespace
+{
+/**
+ * Specifies the current cache version.
+ * This needs to be incremented every time the baked output changes for the same input!
+ */
+const uint32_t kVersion = 2;
+
+/// Cache directory (subdirectory in the application data directory).
+const std::string kDirectory = "NVIDIA/Falcor/TextureCache";
+
+const std::string kIndexFilename = "index.json";
+
+const char* kSupportedExtensions[] = {"png", "jpg", "jpeg", "exr", "tga", "bmp", "hdr"};
+
+struct FileStamp
+{
+    uintmax_t fileSize;
+    int64_t modifiedTime;
+};
+
+FileStamp getFileStamp(const std::filesystem::path& path)
+{
+    return {std::filesystem::file_size(path), (int64_t)std::filesystem::last_write_time(path).time_since_epoch().count()};
+}
+} // namespace
+
+BakedTextureCache::BakedTextureCache(const Options& options) : mOptions(options)
+{
+    if (mOptions.directory.empty())
+        mOptions.directory = getDefaultDirectory();
+
+    loadIndex();
+}
+
+BakedTextureCache::~BakedTextureCache()
+{
+    try
+    {
+        saveIndex();
+    }
+    catch (const std::exception& e)
+    {
+        logWarning("Failed to write texture cache index: {}", e.what());
+    }
+}
+
+std::filesystem::path BakedTextureCache::getDefaultDirectory()
+{
+    return getAppDataDirectory() / kDirectory;
+}
+
+bool BakedTextureCache::isSupportedSource(const std::filesystem::path& path)
+{
+    for (const char* ext : kSupportedExtensions)
+    {
+        if (hasExtension(path, ext))
+            return true;
+    }
+    return false;
+}
+
+ImageIO::CompressionMode BakedTextureCache::selectCompressionMode(ResourceFormat format)
+{
+    if (isCompressedFormat(format))
+        return ImageIO::CompressionMode::None;
+
+    const uint32_t channelCount = getFormatChannelCount(format);
+    const uint32_t channelBits = getNumChannelBits(format, 0);
+    switch (getFormatType(format))
+    {
+    case FormatType::Float:
+        // HDR images. BC6H stores RGB only.
+        return channelBits == 16 || channelBits == 32 ? ImageIO::CompressionMode::BC6 : ImageIO::CompressionMode::None;
+    case FormatType::Unorm:
+    case FormatType::UnormSrgb:
+        // The DDS export only handles 8-bit unorm data.
+        if (channelBits != 8)
+            return ImageIO::CompressionMode::None;
+        if (channelCount == 1)
+            return ImageIO::CompressionMode::BC4;
+        if (channelCount == 2)
+            return ImageIO::CompressionMode::BC5;
+        return ImageIO::CompressionMode::BC7;
+    default:
+        return ImageIO::CompressionMode::None;
+    }
+}
+
+std::filesystem::path BakedTextureCache::lookup(const std::filesystem::path& sourcePath, Variant variant)
+{
+    if (!isSupportedSource(sourcePath))
+        return {};
+
+    std::filesystem::path cachePath;
+    try
+    {
+        cachePath = getCachePath(getKey(sourcePath), variant);
+    }
+    catch (const std::exception& e)
+    {
+        logWarning("Failed to look up '{}' in texture cache: {}", sourcePath, e.what());
+        return {};
+    }
+
+    if (std::filesystem::exists(cachePath))
+        return cachePath;
+
+    if (mOptions.bakeOnMiss)
+        return bake(sourcePath, variant).cachePath;
+
+    return {};
+}
+
+BakedTextureCache::BakeResult BakedTextureCache::bake(const std::filesystem::path& sourcePath, Variant variant, bool force)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+
+    BakeResult result;
+    result.sourcePath = sourcePath;
+
+    std::filesystem::path cachePath;
+    try
+    {
+        cachePath = getCachePath(getKey(sourcePath), variant);
+    }
+    catch (const std::exception& e)
+    {
+        logWarning("Failed to bake texture '{}': {}", sourcePath, e.what());
+        return result;
+    }
+
+    if (!force && std::filesystem::exists(cachePath))
+    {
+        result.cachePath = cachePath;
+        result.wasCached = true;
+        return result;
+    }
+
+    auto pBitmap = Bitmap::createFromFile(sourcePath, true /* top-down */);
+    if (!pBitmap)
+        return result;
+
+    result.mode = selectCompressionMode(pBitmap->getFormat());
+    if (result.mode == ImageIO::CompressionMode::None)
+    {
+        logWarning("Not baking texture '{}': Format {} is not supported for compression.", sourcePath, to_string(pBitmap->getFormat()));
+        return result;
+    }
+
+    // Write to a temporary file first so that concurrent bakes and readers never see a partially written entry.
+    const auto tempPath = std::filesystem::path(cachePath).replace_extension(
+        fmt::format("{}.tmp.dds", std::hash<std::thread::id>()(std::this_thread::get_id()))
+    );
+    try
+    {
+        std::filesystem::create_directories(cachePath.parent_path());
+
+        const uint32_t width = pBitmap->getWidth();
+        const uint32_t height = pBitmap->getHeight();
+        const ResourceFormat format = pBitmap->getFormat();
+        // Block compression requires the base level to be a multiple of 4. Other sizes are clamped by the NVTT mip path.
+        if (mOptions.generateMips && MipGenerator::isFormatSupported(format) && width % 4 == 0 && height % 4 == 0)
+        {
+            MipGenerator::Options mipOptions;
+            mipOptions.srgb = variant == Variant::Srgb;
+            mipOptions.normalMap = variant == Variant::NormalMap;
+            mipOptions.threadCount = 1; // Textures are baked in parallel.
+            const auto mips = MipGenerator::generate(pBitmap->getData(), width, height, format, mipOptions);
+            ImageIO::saveToDDS(tempPath, width, height, format, MipGenerator::getMipCount(width, height), mips.data(), result.mode);
+        }
+        else
+        {
+            ImageIO::saveToDDS(tempPath, *pBitmap, result.mode, mOptions.generateMips);
+        }
+        std::filesystem::rename(tempPath, cachePath);
+    }
+    catch (const std::exception& e)
+    {
+        logWarning("Failed to bake texture '{}': {}", sourcePath, e.what());
+        std::error_code ec;
+        std::filesystem::remove(tempPath, ec);
+        return result;
+    }
+
+    result.cachePath = cachePath;
+    result.bakeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    logDebug("Baked texture '{}' to '{}' ({}).", sourcePath, cachePath, enumToString(result.mode));
+    return result;
+}
+
+std::vector<BakedTextureCache::BakeResult> BakedTextureCache::bakeAll(
+    fstd::span<const std::filesystem::path> sourcePaths,
+    Variant variant,
+    size_t threadCount,
+    bool force
+)
+{
+    std::vector<BakeResult> results(sourcePaths.size());
+
+    BS::thread_pool threadPool(threadCount);
+    threadPool
+        .parallelize_loop(
+            0,
+            sourcePaths.size(),
+            [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                    results[i] = bake(sourcePaths[i], variant, force);
+            },
+            sourcePaths.size()
+        )
+        .wait();
+
+    saveIndex();
+    return results;
+}
+
+void BakedTextureCache::saveIndex()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mIndexDirty)
+        return;
+
+    nlohmann::json entries = nlohmann::json::object();
+    for (const auto& [path, entry] : mIndex)
+        entries[path] = {{"size", entry.fileSize}, {"modified", entry.modifiedTime}, {"key", entry.key}};
+    nlohmann::json index = {{"version", kVersion}, {"entries", std::move(entries)}};
+
+    std::filesystem::create_directories(mOptions.directory);
+    const auto indexPath = mOptions.directory / kIndexFilename;
+    std::ofstream ofs(indexPath);
+    if (!ofs)
+        FALCOR_THROW("Failed to open texture cache index '{}' for writing.", indexPath);
+    ofs << index.dump(1);
+    mIndexDirty = false;
+}
+
+std::string BakedTextureCache::getKey(const std::filesystem::path& sourcePath)
+{
+    const std::string pathStr = sourcePath.string();
+    const FileStamp stamp = getFileStamp(sourcePath);
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (auto it = mIndex.find(pathStr); it != mIndex.end())
+        {
+            if (it->second.fileSize == stamp.fileSize && it->second.modifiedTime == stamp.modifiedTime)
+                return it->second.key;
+        }
+    }
+
+    // Hash the file content outside the lock.
+    const std::string content = readFile(sourcePath);
+    SHA1 sha1;
+    sha1.update(kVersion);
+    sha1.update(mOptions.generateMips);
+    sha1.update(content.data(), content.size());
+    std::string key = SHA1::toString(sha1.finalize());
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mIndex[pathStr] = IndexEntry{stamp.fileSize, stamp.modifiedTime, key};
+    mIndexDirty = true;
+    return key;
+}
+
+std::filesystem::path BakedTextureCache::getCachePath(const std::string& key, Variant variant) const
+{
+    switch (variant)
+    {
+    case Variant::Srgb:
+        return mOptions.directory / (key + ".srgb.dds");
+    case Variant::NormalMap:
+        return mOptions.directory / (key + ".normal.dds");
+    default:
+        return mOptions.directory / (key + ".dds");
+    }
+}
+
+void BakedTextureCache::loadIndex()
+{
+    const auto indexPath = mOptions.directory / kIndexFilename;
+    if (!std::filesystem::exists(indexPath))
+        return;
+
+    try
+    {
+        nlohmann::json index = nlohmann::json::parse(readFile(indexPath));
+        if (index.value("version", 0u) != kVersion)
+        {
+            logInfo("Ignoring texture cache index '{}' with different version.", indexPath);
+            return;
+        }
+        for (const auto& [path, entry] : index.at("entries").items())
+        {
+            mIndex[path] = IndexEntry{
+                entry.at("size").get<uintmax_t>(), entry.at("modified").get<int64_t>(), entry.at("key").get<std::string>()};
+        }
+    }
+    catch (const std::exception& e)
+    {
+        logWarning("Failed to read texture cache index '{}': {}", indexPath, e.what());
+        mIndex.clear();
+    }
+}
+} // namespace Falcor
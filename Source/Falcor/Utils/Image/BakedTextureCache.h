@@ -0,0 +1,159 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "ImageIO.h"
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <fstd/span.h>
+
+namespace Falcor
+{
+/**
+ * On-disk cache of block compressed, mipmapped versions of source textures.
+ *
+ * Source images (PNG, JPG, EXR, ...) are converted to DDS files using the ImageIO compression modes:
+ * BC6H for HDR images, BC4 for single channel, BC5 for two channel and BC7 for all other images.
+ * Mips are generated with MipGenerator. Since filtering depends on how the texture is sampled, textures loaded
+ * as sRGB, as linear data and as normal maps have separate entries (see Variant).
+ * Entries are keyed by the SHA-1 hash of the source file content, so renamed or copied files share an entry
+ * and modified files are re-baked. An index file maps source paths with their size and modification time to
+ * keys, so that lookups of unchanged files do not need to read the file.
+ *
+ * The cache is filled offline with the TextureBaker tool and consulted by TextureManager::loadTexture()
+ * before decoding the original file.
+ */
+class FALCOR_API BakedTextureCache
+{
+public:
+    /// How a texture is sampled, which determines how its mips are filtered.
+    enum class Variant
+    {
+        Linear,    ///< Linear data.
+        Srgb,      ///< Color, mips are filtered in linear space.
+        NormalMap, ///< Tangent space normal map, mips are renormalized.
+    };
+
+    struct Options
+    {
+        /// Cache directory. If empty, the default directory is used (see getDefaultDirectory()).
+        std::filesystem::path directory;
+        /// Generate the full mip chain when baking.
+        bool generateMips = true;
+        /// Bake textures that are not in the cache when they are looked up. This is slow and intended for tools.
+        bool bakeOnMiss = false;
+    };
+
+    struct BakeResult
+    {
+        std::filesystem::path sourcePath;
+        std::filesystem::path cachePath;                                ///< Path of the baked DDS file. Empty if baking failed.
+        ImageIO::CompressionMode mode = ImageIO::CompressionMode::None; ///< Compression mode used for baking.
+        bool wasCached = false;                                         ///< True if the texture was already in the cache.
+        double bakeTime = 0.0;                                          ///< Time to decode and compress the texture in seconds.
+    };
+
+    BakedTextureCache() : BakedTextureCache(Options()) {}
+    BakedTextureCache(const Options& options);
+
+    /// Destructor. Writes the index file if it has changed.
+    ~BakedTextureCache();
+
+    /// Get the default cache directory (subdirectory in the application data directory).
+    static std::filesystem::path getDefaultDirectory();
+
+    /// Check if a file can be baked based on its extension.
+    static bool isSupportedSource(const std::filesystem::path& path);
+
+    /**
+     * Select the compression mode for an image of the given format.
+     * @return The compression mode, or CompressionMode::None if the format should not be compressed.
+     */
+    static ImageIO::CompressionMode selectCompressionMode(ResourceFormat format);
+
+    const Options& getOptions() const { return mOptions; }
+
+    /**
+     * Look up the baked version of a source texture.
+     * This is thread-safe.
+     * @param[in] sourcePath Full path of the source texture.
+     * @param[in] variant Variant to look up.
+     * @return Path of the baked DDS file, or an empty path if the texture is not in the cache.
+     */
+    std::filesystem::path lookup(const std::filesystem::path& sourcePath, Variant variant);
+
+    /**
+     * Bake a source texture into the cache. This is thread-safe.
+     * @param[in] sourcePath Full path of the source texture.
+     * @param[in] variant Variant to bake.
+     * @param[in] force Re-bake the texture even if it is already in the cache.
+     * @return Bake result. The cache path is empty if the texture could not be baked.
+     */
+    BakeResult bake(const std::filesystem::path& sourcePath, Variant variant, bool force = false);
+
+    /**
+     * Bake a list of source textures in parallel.
+     * @param[in] sourcePaths Full paths of the source textures.
+     * @param[in] variant Variant to bake.
+     * @param[in] threadCount Number of worker threads. Zero uses the hardware concurrency.
+     * @param[in] force Re-bake textures even if they are already in the cache.
+     * @return Bake results in the order of the source paths.
+     */
+    std::vector<BakeResult> bakeAll(
+        fstd::span<const std::filesystem::path> sourcePaths,
+        Variant variant,
+        size_t threadCount = 0,
+        bool force = false
+    );
+
+    /// Write the index file to the cache directory.
+    void saveIndex();
+
+private:
+    struct IndexEntry
+    {
+        uintmax_t fileSize = 0;
+        int64_t modifiedTime = 0;
+        std::string key; ///< Hexadecimal SHA-1 of the source content and bake settings.
+    };
+
+    std::string getKey(const std::filesystem::path& sourcePath);
+    std::filesystem::path getCachePath(const std::string& key, Variant variant) const;
+    void loadIndex();
+
+    Options mOptions;
+
+    std::mutex mMutex;
+    std::map<std::string, IndexEntry> mIndex; ///< Map from source path to index entry.
+    bool mIndexDirty = false;
+};
+} // namespace Falcor
@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "Bitmap.h"
+#include "FastImageDecoder.h"
 #include "Core/Macros.h"
 #include "Core/API/Texture.h"
 #include "Core/Platform/MemoryMappedFile.h"
@@ -296,6 +297,26 @@ Bitmap::UniqueConstPtr Bitmap::createFromFile(const std::filesystem::path& path,
         return nullptr;
     }
 
+    // Read file using memory mapped access which is much faster than regular file IO.
+    MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+    if (!file.isOpen())
+    {
+        genWarning("Can't open image file {}", path);
+        return nullptr;
+    }
+
+    // Decode natively if the format is supported. Otherwise fall back to FreeImage.
+    if (!is_set(importFlags, ImportFlags::UseFreeImage))
+    {
+        if (auto info = FastImageDecoder::readInfo(file.getData(), file.getSize(), importFlags))
+        {
+            UniqueConstPtr pBmp = UniqueConstPtr(new Bitmap(info->width, info->height, info->format));
+            if (FastImageDecoder::decode(file.getData(), file.getSize(), *info, pBmp->getData(), pBmp->getRowPitch(), isTopDown))
+                return pBmp;
+            logWarning("Failed to decode image file '{}' natively. Trying FreeImage instead.", path);
+        }
+    }
+
     FREE_IMAGE_FORMAT fifFormat = FIF_UNKNOWN;
 
     fifFormat = FreeImage_GetFileType(path.string().c_str(), 0);
@@ -318,14 +339,6 @@ Bitmap::UniqueConstPtr Bitmap::createFromFile(const std::filesystem::path& path,
         return nullptr;
     }
 
-    // Read file using memory mapped access which is much faster than regular file IO.
-    MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
-    if (!file.isOpen())
-    {
-        genWarning("Can't open image file {}", path);
-        return nullptr;
-    }
-
     if (fifFormat == FIF_EXR)
     {
         if (isFloat16Exr(file))
@@ -462,7 +475,7 @@ Bitmap::Bitmap(uint32_t width, uint32_t height, ResourceFormat format)
         mSize = height * size_t(mRowPitch);
     }
 
-    mpData = std::unique_ptr<uint8_t[]>(new uint8_t[mSize]);
+    mpData = ImageBufferPool::getGlobal().allocate(mSize);
 }
 
 Bitmap::Bitmap(uint32_t width, uint32_t height, ResourceFormat format, const uint8_t* pData) : Bitmap(width, height, format)
@@ -29,6 +29,7 @@
 #include "Core/Macros.h"
 #include "Core/Platform/OS.h"
 #include "Core/API/Formats.h"
+#include "ImageBufferPool.h"
 #include <memory>
 #include <filesystem>
 
@@ -55,6 +56,8 @@ public:
     {
         None = 0u,                  ///< Default.
         ConvertToFloat16 = 1u << 0, ///< Convert HDR images to 16-bit float per channel on import.
+        UseFreeImage = 1u << 1,     ///< Always decode with FreeImage instead of the native decoders. See FastImageDecoder.
+        NormalMap = 1u << 2,        ///< The image is a tangent space normal map. Mips generated on load are renormalized.
     };
 
     enum class FileFormat
@@ -162,7 +165,7 @@ protected:
     Bitmap(uint32_t width, uint32_t height, ResourceFormat format);
     Bitmap(uint32_t width, uint32_t height, ResourceFormat format, const uint8_t* pData);
 
-    std::unique_ptr<uint8_t[]> mpData;
+    ImageBufferPool::Buffer mpData;
     uint32_t mWidth = 0;    ///< Width in pixels.
     uint32_t mHeight = 0;   ///< Height in pixels.
     uint32_t mRowPitch = 0; ///< Row pitch in bytes.
@@ -0,0 +1,921 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "FastImageDecoder.h"
+#include "Core/Error.h"
+#include "Utils/Math/Float16.h"
+
+#include <ImfIO.h>
+#include <ImfInputFile.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfHeader.h>
+#include <zlib.h>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FAST_IMAGE_DECODER_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC allows SSSE3 intrinsics without any arch flags.
+#define FAST_IMAGE_DECODER_SSSE3_TARGET
+#else
+#define FAST_IMAGE_DECODER_SSSE3_TARGET __attribute__((target("ssse3")))
+#endif
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+using ImageInfo = FastImageDecoder::ImageInfo;
+
+const uint8_t kPngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+const uint8_t kExrMagic[4] = {0x76, 0x2f, 0x31, 0x01};
+
+uint32_t readBE32(const uint8_t* p)
+{
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+uint16_t readBE16(const uint8_t* p)
+{
+    return uint16_t((p[0] << 8) | p[1]);
+}
+
+constexpr uint32_t makeChunkType(const char (&name)[5])
+{
+    return (uint32_t(name[0]) << 24) | (uint32_t(name[1]) << 16) | (uint32_t(name[2]) << 8) | uint32_t(name[3]);
+}
+
+#if FAST_IMAGE_DECODER_X86
+bool detectSSSE3()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+// The SSSE3 kernels return the number of pixels processed. The remaining pixels are handled by the scalar code.
+
+FAST_IMAGE_DECODER_SSSE3_TARGET size_t expandRGB8ToBGRX8Ssse3(const uint8_t* pSrc, uint8_t* pDst, size_t count)
+{
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    const __m128i alpha = _mm_set1_epi32(int(0xff000000));
+    size_t i = 0;
+    // Each iteration loads 16 bytes but only consumes 12. Stop early to not read past the end of the row.
+    for (; i + 6 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + 3 * i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + 4 * i), _mm_or_si128(_mm_shuffle_epi8(v, shuffle), alpha));
+    }
+    return i;
+}
+
+FAST_IMAGE_DECODER_SSSE3_TARGET size_t swizzleRGBA8ToBGRA8Ssse3(const uint8_t* pSrc, uint8_t* pDst, size_t count)
+{
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + 4 * i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + 4 * i), _mm_shuffle_epi8(v, shuffle));
+    }
+    return i;
+}
+
+FAST_IMAGE_DECODER_SSSE3_TARGET size_t swapBytes16Ssse3(const uint8_t* pSrc, uint8_t* pDst, size_t count)
+{
+    const __m128i shuffle = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + 2 * i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + 2 * i), _mm_shuffle_epi8(v, shuffle));
+    }
+    return i;
+}
+#endif // FAST_IMAGE_DECODER_X86
+
+void expandRGB8ToBGRX8(const uint8_t* pSrc, uint8_t* pDst, size_t count, bool useSimd)
+{
+    size_t i = 0;
+#if FAST_IMAGE_DECODER_X86
+    if (useSimd)
+        i = expandRGB8ToBGRX8Ssse3(pSrc, pDst, count);
+#endif
+    for (; i < count; ++i)
+    {
+        pDst[4 * i + 0] = pSrc[3 * i + 2];
+        pDst[4 * i + 1] = pSrc[3 * i + 1];
+        pDst[4 * i + 2] = pSrc[3 * i + 0];
+        pDst[4 * i + 3] = 0xff;
+    }
+}
+
+void swizzleRGBA8ToBGRA8(const uint8_t* pSrc, uint8_t* pDst, size_t count, bool useSimd)
+{
+    size_t i = 0;
+#if FAST_IMAGE_DECODER_X86
+    if (useSimd)
+        i = swizzleRGBA8ToBGRA8Ssse3(pSrc, pDst, count);
+#endif
+    for (; i < count; ++i)
+    {
+        pDst[4 * i + 0] = pSrc[4 * i + 2];
+        pDst[4 * i + 1] = pSrc[4 * i + 1];
+        pDst[4 * i + 2] = pSrc[4 * i + 0];
+        pDst[4 * i + 3] = pSrc[4 * i + 3];
+    }
+}
+
+/// Converts big-endian 16-bit values to native byte order (assumed little-endian).
+void swapBytes16(const uint8_t* pSrc, uint8_t* pDst, size_t count, bool useSimd)
+{
+    size_t i = 0;
+#if FAST_IMAGE_DECODER_X86
+    if (useSimd)
+        i = swapBytes16Ssse3(pSrc, pDst, count);
+#endif
+    uint16_t* pDst16 = reinterpret_cast<uint16_t*>(pDst);
+    for (; i < count; ++i)
+        pDst16[i] = readBE16(pSrc + 2 * i);
+}
+
+// PNG
+
+enum PngColorType : uint8_t
+{
+    kPngGray = 0,
+    kPngRGB = 2,
+    kPngPalette = 3,
+    kPngGrayAlpha = 4,
+    kPngRGBA = 6,
+};
+
+const uint32_t kPngIHDR = makeChunkType("IHDR");
+const uint32_t kPngPLTE = makeChunkType("PLTE");
+const uint32_t kPngTRNS = makeChunkType("tRNS");
+const uint32_t kPngIDAT = makeChunkType("IDAT");
+
+struct PngChunk
+{
+    uint32_t type = 0;
+    const uint8_t* pData = nullptr;
+    uint32_t size = 0;
+};
+
+/// Iterates over the chunks of a PNG file. CRCs are not validated.
+class PngChunkReader
+{
+public:
+    PngChunkReader(const uint8_t* pData, size_t size) : mpData(pData), mSize(size), mOffset(sizeof(kPngSignature)) {}
+
+    /// Read the next chunk. Returns false at the end of the file or if the chunk is truncated.
+    bool next(PngChunk& chunk)
+    {
+        if (mOffset + 12 > mSize)
+            return false;
+        const uint32_t length = readBE32(mpData + mOffset);
+        if (length > mSize - mOffset - 12)
+            return false;
+        chunk.type = readBE32(mpData + mOffset + 4);
+        chunk.pData = mpData + mOffset + 8;
+        chunk.size = length;
+        mOffset += size_t(length) + 12;
+        return true;
+    }
+
+private:
+    const uint8_t* mpData;
+    size_t mSize;
+    size_t mOffset;
+};
+
+struct PngHeader
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint8_t bitDepth = 0;
+    uint8_t colorType = 0;
+    uint32_t channelCount = 0;
+    std::array<std::array<uint8_t, 4>, 256> palette; ///< Palette in BGRA order.
+    bool grayPalette = false; ///< Palette indices are stored as gray values instead of being expanded (see isFreeImageGrayPalette()).
+};
+
+uint32_t getPngChannelCount(uint8_t colorType, uint8_t bitDepth)
+{
+    const bool isLowBitDepth = bitDepth == 1 || bitDepth == 2 || bitDepth == 4;
+    switch (colorType)
+    {
+    case kPngGray:
+        return (isLowBitDepth || bitDepth == 8 || bitDepth == 16) ? 1 : 0;
+    case kPngRGB:
+        return (bitDepth == 8 || bitDepth == 16) ? 3 : 0;
+    case kPngPalette:
+        return (isLowBitDepth || bitDepth == 8) ? 1 : 0;
+    case kPngGrayAlpha:
+        return (bitDepth == 8 || bitDepth == 16) ? 2 : 0;
+    case kPngRGBA:
+        return (bitDepth == 8 || bitDepth == 16) ? 4 : 0;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * Check if FreeImage classifies an 8-bit palette as greyscale (FIC_MINISBLACK or FIC_MINISWHITE), see FreeImage_GetColorType().
+ * In that case the FreeImage path keeps the palette indices as an R8Unorm image instead of expanding them to BGRA.
+ * Each entry must be gray and equal either its index or its reversed index. FreeImage initializes the entries not
+ * defined by the PLTE chunk to a greyscale ramp, so they always pass.
+ */
+bool isFreeImageGrayPalette(const PngHeader& header, uint32_t paletteSize)
+{
+    for (uint32_t i = 0; i < paletteSize; ++i)
+    {
+        const auto& entry = header.palette[i];
+        if (entry[0] != entry[1] || entry[0] != entry[2])
+            return false;
+        if (entry[0] != i && entry[0] != 255 - i)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Parse the PNG header and the chunks preceding the image data.
+ * Returns an empty optional if the file is invalid or uses features left to FreeImage.
+ */
+std::optional<PngHeader> parsePngHeader(const uint8_t* pData, size_t size)
+{
+    PngChunkReader reader(pData, size);
+    PngChunk chunk;
+    if (!reader.next(chunk) || chunk.type != kPngIHDR || chunk.size != 13)
+        return {};
+
+    PngHeader header;
+    header.width = readBE32(chunk.pData);
+    header.height = readBE32(chunk.pData + 4);
+    header.bitDepth = chunk.pData[8];
+    header.colorType = chunk.pData[9];
+    const uint8_t compression = chunk.pData[10];
+    const uint8_t filter = chunk.pData[11];
+    const uint8_t interlace = chunk.pData[12];
+
+    // Adam7 interlaced images are left to FreeImage.
+    if (compression != 0 || filter != 0 || interlace != 0)
+        return {};
+    if (header.width == 0 || header.height == 0 || header.width > (1u << 24) || header.height > (1u << 24))
+        return {};
+    header.channelCount = getPngChannelCount(header.colorType, header.bitDepth);
+    if (header.channelCount == 0)
+        return {};
+
+    // Palette entries default to opaque black.
+    for (auto& entry : header.palette)
+        entry = {0, 0, 0, 0xff};
+
+    uint32_t paletteSize = 0;
+    while (reader.next(chunk))
+    {
+        if (chunk.type == kPngIDAT)
+        {
+            if (header.colorType == kPngPalette)
+            {
+                if (paletteSize == 0)
+                    return {};
+                // FreeImage keeps 8-bit greyscale palettes as indices. Its handling of gray palettes with lower bit
+                // depths depends on the bit depth, so those images are left to FreeImage.
+                const bool isGray = std::all_of(
+                    header.palette.begin(),
+                    header.palette.begin() + paletteSize,
+                    [](const auto& entry) { return entry[0] == entry[1] && entry[0] == entry[2]; }
+                );
+                if (header.bitDepth == 8)
+                    header.grayPalette = isFreeImageGrayPalette(header, paletteSize);
+                else if (isGray)
+                    return {};
+            }
+            return header;
+        }
+        else if (chunk.type == kPngPLTE)
+        {
+            if (chunk.size % 3 != 0 || chunk.size > 3 * 256)
+                return {};
+            paletteSize = chunk.size / 3;
+            for (uint32_t i = 0; i < paletteSize; ++i)
+            {
+                header.palette[i][0] = chunk.pData[3 * i + 2];
+                header.palette[i][1] = chunk.pData[3 * i + 1];
+                header.palette[i][2] = chunk.pData[3 * i + 0];
+            }
+        }
+        else if (chunk.type == kPngTRNS)
+        {
+            // Color key transparency of gray and RGB images is left to FreeImage.
+            if (header.colorType != kPngPalette || chunk.size > 256)
+                return {};
+            for (uint32_t i = 0; i < chunk.size; ++i)
+                header.palette[i][3] = chunk.pData[i];
+        }
+    }
+
+    // No image data.
+    return {};
+}
+
+ResourceFormat getPngFormat(const PngHeader& header)
+{
+    // These match the formats produced by the FreeImage path in Bitmap::createFromFile().
+    const bool is16Bit = header.bitDepth == 16;
+    switch (header.colorType)
+    {
+    case kPngGray:
+        return is16Bit ? ResourceFormat::R16Unorm : ResourceFormat::R8Unorm;
+    case kPngRGB:
+        return is16Bit ? ResourceFormat::RGBA16Unorm : ResourceFormat::BGRX8Unorm;
+    case kPngPalette:
+        return header.grayPalette ? ResourceFormat::R8Unorm : ResourceFormat::BGRA8Unorm;
+    case kPngGrayAlpha:
+    case kPngRGBA:
+        return is16Bit ? ResourceFormat::RGBA16Unorm : ResourceFormat::BGRA8Unorm;
+    default:
+        FALCOR_UNREACHABLE();
+        return ResourceFormat::Unknown;
+    }
+}
+
+uint8_t paeth(uint8_t a, uint8_t b, uint8_t c)
+{
+    const int pa = std::abs(int(b) - int(c));
+    const int pb = std::abs(int(a) - int(c));
+    const int pc = std::abs(int(a) + int(b) - 2 * int(c));
+    if (pa <= pb && pa <= pc)
+        return a;
+    return pb <= pc ? b : c;
+}
+
+/**
+ * Reverse the PNG filter of a row in place.
+ * @param[in] filter Filter type.
+ * @param[in,out] pRow Row data.
+ * @param[in] pPrev Previous row after unfiltering, or all zeros for the first row.
+ * @param[in] rowBytes Row size in bytes.
+ * @param[in] bpp Bytes per complete pixel, rounded up to one.
+ * @return False if the filter type is invalid.
+ */
+bool unfilterPngRow(uint8_t filter, uint8_t* pRow, const uint8_t* pPrev, size_t rowBytes, size_t bpp)
+{
+    switch (filter)
+    {
+    case 0: // None
+        break;
+    case 1: // Sub
+        for (size_t i = bpp; i < rowBytes; ++i)
+            pRow[i] += pRow[i - bpp];
+        break;
+    case 2: // Up
+        for (size_t i = 0; i < rowBytes; ++i)
+            pRow[i] += pPrev[i];
+        break;
+    case 3: // Average
+        for (size_t i = 0; i < bpp; ++i)
+            pRow[i] += pPrev[i] >> 1;
+        for (size_t i = bpp; i < rowBytes; ++i)
+            pRow[i] += uint8_t((uint32_t(pRow[i - bpp]) + uint32_t(pPrev[i])) >> 1);
+        break;
+    case 4: // Paeth
+        for (size_t i = 0; i < bpp; ++i)
+            pRow[i] += pPrev[i];
+        for (size_t i = bpp; i < rowBytes; ++i)
+            pRow[i] += paeth(pRow[i - bpp], pPrev[i], pPrev[i - bpp]);
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+/// Get a sample of a row with 1, 2 or 4 bits per sample.
+uint8_t getPackedSample(const uint8_t* pRow, size_t index, uint32_t bitDepth)
+{
+    const size_t bit = index * bitDepth;
+    const uint32_t shift = 8 - bitDepth - uint32_t(bit & 7);
+    return uint8_t((pRow[bit >> 3] >> shift) & ((1u << bitDepth) - 1));
+}
+
+/// Convert an unfiltered PNG row to the destination format.
+void convertPngRow(const PngHeader& header, const uint8_t* pSrc, uint8_t* pDst, bool useSimd)
+{
+    const size_t width = header.width;
+    uint16_t* pDst16 = reinterpret_cast<uint16_t*>(pDst);
+
+    switch (header.colorType)
+    {
+    case kPngGray:
+        if (header.bitDepth == 8)
+        {
+            std::memcpy(pDst, pSrc, width);
+        }
+        else if (header.bitDepth == 16)
+        {
+            swapBytes16(pSrc, pDst, width, useSimd);
+        }
+        else
+        {
+            // Expand low bit depths to the full 8-bit range.
+            const uint8_t scale = uint8_t(255 / ((1u << header.bitDepth) - 1));
+            for (size_t i = 0; i < width; ++i)
+                pDst[i] = uint8_t(getPackedSample(pSrc, i, header.bitDepth) * scale);
+        }
+        break;
+    case kPngRGB:
+        if (header.bitDepth == 8)
+        {
+            expandRGB8ToBGRX8(pSrc, pDst, width, useSimd);
+        }
+        else
+        {
+            for (size_t i = 0; i < width; ++i)
+            {
+                pDst16[4 * i + 0] = readBE16(pSrc + 6 * i + 0);
+                pDst16[4 * i + 1] = readBE16(pSrc + 6 * i + 2);
+                pDst16[4 * i + 2] = readBE16(pSrc + 6 * i + 4);
+                pDst16[4 * i + 3] = 0xffff;
+            }
+        }
+        break;
+    case kPngPalette:
+        if (header.grayPalette)
+        {
+            std::memcpy(pDst, pSrc, width);
+        }
+        else if (header.bitDepth == 8)
+        {
+            for (size_t i = 0; i < width; ++i)
+                std::memcpy(pDst + 4 * i, header.palette[pSrc[i]].data(), 4);
+        }
+        else
+        {
+            for (size_t i = 0; i < width; ++i)
+                std::memcpy(pDst + 4 * i, header.palette[getPackedSample(pSrc, i, header.bitDepth)].data(), 4);
+        }
+        break;
+    case kPngGrayAlpha:
+        if (header.bitDepth == 8)
+        {
+            for (size_t i = 0; i < width; ++i)
+            {
+                const uint8_t gray = pSrc[2 * i];
+                pDst[4 * i + 0] = gray;
+                pDst[4 * i + 1] = gray;
+                pDst[4 * i + 2] = gray;
+                pDst[4 * i + 3] = pSrc[2 * i + 1];
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < width; ++i)
+            {
+                const uint16_t gray = readBE16(pSrc + 4 * i);
+                pDst16[4 * i + 0] = gray;
+                pDst16[4 * i + 1] = gray;
+                pDst16[4 * i + 2] = gray;
+                pDst16[4 * i + 3] = readBE16(pSrc + 4 * i + 2);
+            }
+        }
+        break;
+    case kPngRGBA:
+        if (header.bitDepth == 8)
+            swizzleRGBA8ToBGRA8(pSrc, pDst, width, useSimd);
+        else
+            swapBytes16(pSrc, pDst, 4 * width, useSimd);
+        break;
+    default:
+        FALCOR_UNREACHABLE();
+    }
+}
+
+bool decodePng(const uint8_t* pData, size_t size, uint8_t* pDst, size_t rowPitch, bool isTopDown, bool useSimd)
+{
+    auto header = parsePngHeader(pData, size);
+    if (!header)
+        return false;
+
+    const size_t bitsPerPixel = size_t(header->channelCount) * header->bitDepth;
+    const size_t rowBytes = (header->width * bitsPerPixel + 7) / 8;
+    const size_t bpp = std::max<size_t>(1, bitsPerPixel / 8);
+
+    // Rows are inflated one at a time into a double buffer, each row being prefixed by its filter type.
+    // The previous row starts out as zeros, as required by the filters.
+    std::vector<uint8_t> rows(2 * (rowBytes + 1), 0);
+    uint8_t* pRow = rows.data();
+    uint8_t* pPrev = rows.data() + rowBytes + 1;
+
+    PngChunkReader reader(pData, size);
+    PngChunk chunk;
+    while (reader.next(chunk) && chunk.type != kPngIDAT)
+    {
+    }
+    if (chunk.type != kPngIDAT)
+        return false;
+
+    z_stream stream = {};
+    if (inflateInit(&stream) != Z_OK)
+        return false;
+    stream.next_in = const_cast<Bytef*>(chunk.pData);
+    stream.avail_in = chunk.size;
+
+    bool success = true;
+    for (uint32_t y = 0; y < header->height && success; ++y)
+    {
+        stream.next_out = pRow;
+        stream.avail_out = uInt(rowBytes + 1);
+        while (stream.avail_out > 0)
+        {
+            if (stream.avail_in == 0)
+            {
+                // The compressed stream continues in the next IDAT chunk.
+                if (!reader.next(chunk) || chunk.type != kPngIDAT)
+                {
+                    success = false;
+                    break;
+                }
+                stream.next_in = const_cast<Bytef*>(chunk.pData);
+                stream.avail_in = chunk.size;
+                continue;
+            }
+
+            const int result = inflate(&stream, Z_NO_FLUSH);
+            if (result == Z_STREAM_END)
+            {
+                success = stream.avail_out == 0;
+                break;
+            }
+            if (result != Z_OK)
+            {
+                success = false;
+                break;
+            }
+        }
+
+        if (success && !unfilterPngRow(pRow[0], pRow + 1, pPrev + 1, rowBytes, bpp))
+            success = false;
+
+        if (success)
+        {
+            const uint32_t dstRow = isTopDown ? y : header->height - 1 - y;
+            convertPngRow(*header, pRow + 1, pDst + dstRow * rowPitch, useSimd);
+            std::swap(pRow, pPrev);
+        }
+    }
+
+    inflateEnd(&stream);
+    return success;
+}
+
+// PFM
+
+struct PfmHeader
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t channelCount = 0;
+    bool isLittleEndian = false;
+    size_t dataOffset = 0;
+};
+
+std::optional<PfmHeader> parsePfmHeader(const uint8_t* pData, size_t size)
+{
+    if (size < 3 || pData[0] != 'P' || (pData[1] != 'F' && pData[1] != 'f'))
+        return {};
+
+    PfmHeader header;
+    header.channelCount = pData[1] == 'F' ? 3 : 1;
+
+    // The header consists of the width, height and scale separated by whitespace.
+    // A single whitespace character separates the scale from the pixel data.
+    size_t offset = 2;
+    auto readToken = [&]() -> std::string
+    {
+        while (offset < size && std::isspace(pData[offset]))
+            ++offset;
+        const size_t start = offset;
+        while (offset < size && offset - start < 32 && !std::isspace(pData[offset]))
+            ++offset;
+        return std::string(reinterpret_cast<const char*>(pData) + start, offset - start);
+    };
+
+    const std::string width = readToken();
+    const std::string height = readToken();
+    const std::string scale = readToken();
+    if (offset >= size || !std::isspace(pData[offset]))
+        return {};
+    header.dataOffset = offset + 1;
+
+    char* pEnd = nullptr;
+    const unsigned long w = std::strtoul(width.c_str(), &pEnd, 10);
+    if (width.empty() || *pEnd != '\0')
+        return {};
+    const unsigned long h = std::strtoul(height.c_str(), &pEnd, 10);
+    if (height.empty() || *pEnd != '\0')
+        return {};
+    const double s = std::strtod(scale.c_str(), &pEnd);
+    if (scale.empty() || *pEnd != '\0' || s == 0.0)
+        return {};
+
+    if (w == 0 || h == 0 || w > (1u << 24) || h > (1u << 24))
+        return {};
+    header.width = uint32_t(w);
+    header.height = uint32_t(h);
+    header.isLittleEndian = s < 0.0;
+
+    const size_t dataSize = size_t(header.width) * header.height * header.channelCount * sizeof(float);
+    if (size - header.dataOffset < dataSize)
+        return {};
+
+    return header;
+}
+
+ResourceFormat getPfmFormat(const PfmHeader& header, bool convertToFloat16)
+{
+    if (header.channelCount == 3)
+        return convertToFloat16 ? ResourceFormat::RGBA16Float : ResourceFormat::RGBA32Float;
+    return convertToFloat16 ? ResourceFormat::R16Float : ResourceFormat::R32Float;
+}
+
+bool decodePfm(const uint8_t* pData, size_t size, const ImageInfo& info, uint8_t* pDst, size_t rowPitch, bool isTopDown)
+{
+    auto header = parsePfmHeader(pData, size);
+    if (!header)
+        return false;
+
+    const bool isHalf = getNumChannelBits(info.format, 0) == 16;
+    const uint32_t channelCount = header->channelCount;
+    const uint32_t dstChannelCount = getFormatChannelCount(info.format);
+    const uint8_t* pSrc = pData + header->dataOffset;
+
+    // PFM stores the bottom row first.
+    for (uint32_t y = 0; y < header->height; ++y)
+    {
+        const uint32_t dstRow = isTopDown ? header->height - 1 - y : y;
+        uint8_t* pDstRow = pDst + dstRow * rowPitch;
+        for (uint32_t x = 0; x < header->width; ++x)
+        {
+            for (uint32_t c = 0; c < dstChannelCount; ++c)
+            {
+                float value = 1.f;
+                if (c < channelCount)
+                {
+                    uint32_t bits;
+                    std::memcpy(&bits, pSrc, sizeof(bits));
+                    if (!header->isLittleEndian)
+                        bits = readBE32(pSrc);
+                    std::memcpy(&value, &bits, sizeof(value));
+                    pSrc += sizeof(float);
+                }
+
+                const size_t index = size_t(x) * dstChannelCount + c;
+                if (isHalf)
+                    reinterpret_cast<uint16_t*>(pDstRow)[index] = math::float32ToFloat16(value);
+                else
+                    reinterpret_cast<float*>(pDstRow)[index] = value;
+            }
+        }
+    }
+
+    return true;
+}
+
+// EXR
+
+/// Wraps a memory buffer in an OpenEXR stream. Data is read in place without copying.
+class ExrMemoryStream : public Imf::IStream
+{
+public:
+    ExrMemoryStream(const uint8_t* pData, size_t size) : Imf::IStream(""), mpData(pData), mSize(size) {}
+
+    bool isMemoryMapped() const override { return true; }
+
+    char* readMemoryMapped(int n) override
+    {
+        if (n < 0 || mOffset + size_t(n) > mSize)
+            throw std::runtime_error("Unexpected end of EXR file.");
+        char* pData = const_cast<char*>(reinterpret_cast<const char*>(mpData + mOffset));
+        mOffset += n;
+        return pData;
+    }
+
+    bool read(char c[/*n*/], int n) override
+    {
+        if (n < 0 || mOffset + size_t(n) > mSize)
+            throw std::runtime_error("Unexpected end of EXR file.");
+        std::memcpy(c, mpData + mOffset, n);
+        mOffset += n;
+        return mOffset < mSize;
+    }
+
+    uint64_t tellg() override { return mOffset; }
+
+    void seekg(uint64_t pos) override { mOffset = pos; }
+
+    void clear() override {}
+
+private:
+    const uint8_t* mpData;
+    size_t mSize;
+    size_t mOffset = 0;
+};
+
+std::optional<ImageInfo> readExrInfo(const uint8_t* pData, size_t size, bool convertToFloat16)
+{
+    try
+    {
+        ExrMemoryStream stream(pData, size);
+        Imf::InputFile file(stream);
+        const Imf::Header& header = file.header();
+        const Imf::ChannelList& channels = header.channels();
+
+        // Only RGB(A) images are decoded natively, luminance/chroma and other layouts are left to FreeImage.
+        for (const char* name : {"R", "G", "B"})
+        {
+            if (!channels.findChannel(name))
+                return {};
+        }
+
+        // Same as the FreeImage path, images with only half channels are kept at half precision.
+        bool isHalf = true;
+        for (auto it = channels.begin(); it != channels.end(); ++it)
+        {
+            if (it.channel().type == Imf::UINT)
+                return {};
+            isHalf = isHalf && it.channel().type == Imf::HALF;
+        }
+
+        const Imath::Box2i& dataWindow = header.dataWindow();
+        const int64_t width = int64_t(dataWindow.max.x) - dataWindow.min.x + 1;
+        const int64_t height = int64_t(dataWindow.max.y) - dataWindow.min.y + 1;
+        if (width <= 0 || height <= 0 || width > (1 << 24) || height > (1 << 24))
+            return {};
+
+        ImageInfo info;
+        info.fileType = FastImageDecoder::FileType::Exr;
+        info.width = uint32_t(width);
+        info.height = uint32_t(height);
+        info.format = (isHalf || convertToFloat16) ? ResourceFormat::RGBA16Float : ResourceFormat::RGBA32Float;
+        return info;
+    }
+    catch (const std::exception&)
+    {
+        return {};
+    }
+}
+
+bool decodeExr(const uint8_t* pData, size_t size, const ImageInfo& info, uint8_t* pDst, size_t rowPitch, bool isTopDown)
+{
+    try
+    {
+        ExrMemoryStream stream(pData, size);
+        Imf::InputFile file(stream);
+        const Imath::Box2i& dataWindow = file.header().dataWindow();
+
+        // Let OpenEXR convert and write the channels directly into the destination rows.
+        // The slice base pointers are offset such that the data window origin maps to the first pixel.
+        const bool isHalf = info.format == ResourceFormat::RGBA16Float;
+        const Imf::PixelType type = isHalf ? Imf::HALF : Imf::FLOAT;
+        const size_t channelSize = isHalf ? 2 : 4;
+        const ptrdiff_t xStride = ptrdiff_t(4 * channelSize);
+        const ptrdiff_t yStride = isTopDown ? ptrdiff_t(rowPitch) : -ptrdiff_t(rowPitch);
+        char* pFirstRow = reinterpret_cast<char*>(pDst) + (isTopDown ? 0 : ptrdiff_t(info.height - 1) * ptrdiff_t(rowPitch));
+        char* pBase = pFirstRow - ptrdiff_t(dataWindow.min.x) * xStride - ptrdiff_t(dataWindow.min.y) * yStride;
+
+        Imf::FrameBuffer frameBuffer;
+        const char* kChannels[] = {"R", "G", "B", "A"};
+        for (size_t c = 0; c < 4; ++c)
+        {
+            // Missing alpha is filled with one.
+            const double fillValue = c == 3 ? 1.0 : 0.0;
+            frameBuffer.insert(kChannels[c], Imf::Slice(type, pBase + c * channelSize, xStride, yStride, 1, 1, fillValue));
+        }
+
+        file.setFrameBuffer(frameBuffer);
+        file.readPixels(dataWindow.min.y, dataWindow.max.y);
+        return true;
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+}
+} // namespace
+
+FastImageDecoder::FileType FastImageDecoder::getFileType(const void* pData, size_t size)
+{
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+    if (size >= sizeof(kPngSignature) && std::memcmp(pBytes, kPngSignature, sizeof(kPngSignature)) == 0)
+        return FileType::Png;
+    if (size >= sizeof(kExrMagic) && std::memcmp(pBytes, kExrMagic, sizeof(kExrMagic)) == 0)
+        return FileType::Exr;
+    if (size >= 3 && pBytes[0] == 'P' && (pBytes[1] == 'F' || pBytes[1] == 'f') && std::isspace(pBytes[2]))
+        return FileType::Pfm;
+    return FileType::Unknown;
+}
+
+std::optional<FastImageDecoder::ImageInfo> FastImageDecoder::readInfo(const void* pData, size_t size, Bitmap::ImportFlags importFlags)
+{
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+    const bool convertToFloat16 = is_set(importFlags, Bitmap::ImportFlags::ConvertToFloat16);
+
+    switch (getFileType(pData, size))
+    {
+    case FileType::Png:
+        if (auto header = parsePngHeader(pBytes, size))
+            return ImageInfo{FileType::Png, header->width, header->height, getPngFormat(*header)};
+        return {};
+    case FileType::Exr:
+        return readExrInfo(pBytes, size, convertToFloat16);
+    case FileType::Pfm:
+        if (auto header = parsePfmHeader(pBytes, size))
+            return ImageInfo{FileType::Pfm, header->width, header->height, getPfmFormat(*header, convertToFloat16)};
+        return {};
+    default:
+        return {};
+    }
+}
+
+bool FastImageDecoder::decode(
+    const void* pData,
+    size_t size,
+    const ImageInfo& info,
+    uint8_t* pDst,
+    size_t rowPitch,
+    bool isTopDown,
+    bool useSimd
+)
+{
+    FALCOR_CHECK(pDst != nullptr, "Missing destination buffer.");
+    FALCOR_CHECK(rowPitch >= getFormatRowPitch(info.format, info.width), "Row pitch is too small.");
+
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+    useSimd = useSimd && isSimdSupported();
+
+    switch (info.fileType)
+    {
+    case FileType::Png:
+        return decodePng(pBytes, size, pDst, rowPitch, isTopDown, useSimd);
+    case FileType::Exr:
+        return decodeExr(pBytes, size, info, pDst, rowPitch, isTopDown);
+    case FileType::Pfm:
+        return decodePfm(pBytes, size, info, pDst, rowPitch, isTopDown);
+    default:
+        FALCOR_THROW("Invalid file type.");
+    }
+}
+
+bool FastImageDecoder::isSimdSupported()
+{
+#if FAST_IMAGE_DECODER_X86
+    static const bool supported = detectSSSE3();
+    return supported;
+#else
+    return false;
+#endif
+}
+} // namespace Falcor
@@ -0,0 +1,110 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Bitmap.h"
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace Falcor
+{
+/**
+ * Native decoders for common image file formats.
+ *
+ * PNG, EXR and PFM files are decoded straight into the layout of the final bitmap format, without the intermediate
+ * images and per-pixel conversions of the FreeImage path. The resulting formats match what the FreeImage path produces
+ * (e.g. BGRA8Unorm for 8-bit color PNGs, R8Unorm holding the raw indices for 8-bit palette PNGs whose palette is a
+ * greyscale ramp), so callers see no difference. Channel expansion and swizzling of 8-bit images use SSSE3 when the CPU
+ * supports it.
+ *
+ * Bitmap::createFromFile() tries these decoders first. Other formats (e.g. JPEG) and files using features not handled
+ * here (interlaced PNGs, PNGs with color key transparency, greyscale palette PNGs below 8 bits, non-RGB EXRs) fall
+ * back to FreeImage.
+ */
+class FALCOR_API FastImageDecoder
+{
+public:
+    enum class FileType
+    {
+        Unknown,
+        Png,
+        Exr,
+        Pfm,
+    };
+
+    struct ImageInfo
+    {
+        FileType fileType = FileType::Unknown;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        ResourceFormat format = ResourceFormat::Unknown; ///< Format of the decoded image.
+    };
+
+    /**
+     * Detect the file type from the file signature.
+     * @param[in] pData File data.
+     * @param[in] size File size in bytes.
+     */
+    static FileType getFileType(const void* pData, size_t size);
+
+    /**
+     * Read the image header and determine the format the image decodes to.
+     * @param[in] pData File data.
+     * @param[in] size File size in bytes.
+     * @param[in] importFlags Import flags. See Bitmap::ImportFlags.
+     * @return Image info, or an empty optional if the image can't be decoded natively.
+     */
+    static std::optional<ImageInfo> readInfo(const void* pData, size_t size, Bitmap::ImportFlags importFlags);
+
+    /**
+     * Decode an image.
+     * @param[in] pData File data.
+     * @param[in] size File size in bytes.
+     * @param[in] info Image info returned by readInfo().
+     * @param[out] pDst Destination buffer of at least info.height * rowPitch bytes.
+     * @param[in] rowPitch Destination row pitch in bytes.
+     * @param[in] isTopDown If true, the top row is stored first, otherwise the bottom row is stored first.
+     * @param[in] useSimd Use SIMD code paths if supported by the CPU.
+     * @return True if successful, false if the file is corrupt.
+     */
+    static bool decode(
+        const void* pData,
+        size_t size,
+        const ImageInfo& info,
+        uint8_t* pDst,
+        size_t rowPitch,
+        bool isTopDown,
+        bool useSimd = true
+    );
+
+    /// Returns true if the CPU supports the SIMD code paths.
+    static bool isSimdSupported();
+};
+} // namespace Falcor
@@ -0,0 +1,232 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ImageBufferPool.h"
+#include "Core/Error.h"
+#include "Utils/Math/Common.h"
+
+#if FALCOR_WINDOWS
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif FALCOR_LINUX
+#include <sys/mman.h>
+#endif
+
+#include <fstd/bit.h> // TODO C++20: Replace with <bit>
+
+#include <algorithm>
+#include <new>
+
+namespace Falcor
+{
+namespace
+{
+const size_t kHugePageSize = 2 * 1024 * 1024;
+}
+
+void ImageBufferPool::Deleter::operator()(uint8_t* pData) const
+{
+    if (mpPool)
+        mpPool->release(pData, mCapacity);
+    else
+        delete[] pData;
+}
+
+ImageBufferPool::ImageBufferPool() : ImageBufferPool(Options()) {}
+
+ImageBufferPool::ImageBufferPool(const Options& options) : mOptions(options)
+{
+    mOptions.minPooledSize = std::max<size_t>(mOptions.minPooledSize, 4096);
+}
+
+ImageBufferPool::~ImageBufferPool()
+{
+    FALCOR_ASSERT(mStats.bytesInUse == 0);
+    trim();
+}
+
+ImageBufferPool& ImageBufferPool::getGlobal()
+{
+    // Intentionally leaked, bitmaps held by static objects may be released after static destruction.
+    static ImageBufferPool* pPool = new ImageBufferPool();
+    return *pPool;
+}
+
+ImageBufferPool::Buffer ImageBufferPool::allocate(size_t size)
+{
+    if (size < mOptions.minPooledSize)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStats.allocationCount++;
+            mStats.heapAllocationCount++;
+        }
+        return Buffer(new uint8_t[size], Deleter(nullptr, size));
+    }
+
+    const size_t capacity = getCapacity(size);
+    uint8_t* pData = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStats.allocationCount++;
+        mStats.bytesInUse += capacity;
+        mStats.peakBytesInUse = std::max(mStats.peakBytesInUse, mStats.bytesInUse);
+
+        if (auto it = mFreeBlocks.find(capacity); it != mFreeBlocks.end() && !it->second.empty())
+        {
+            pData = it->second.back();
+            it->second.pop_back();
+            mStats.reuseCount++;
+            mStats.bytesCached -= capacity;
+        }
+    }
+
+    // Allocate from the OS outside of the lock.
+    if (!pData)
+    {
+        try
+        {
+            pData = allocateSystem(capacity);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStats.bytesInUse -= capacity;
+            throw;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStats.systemAllocationCount++;
+        if (advisesHugePages(capacity))
+            mStats.hugePageAdvisedBytes += capacity;
+    }
+
+    return Buffer(pData, Deleter(this, capacity));
+}
+
+void ImageBufferPool::release(uint8_t* pData, size_t capacity)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        FALCOR_ASSERT(mStats.bytesInUse >= capacity);
+        mStats.bytesInUse -= capacity;
+        if (mStats.bytesCached + capacity <= mOptions.maxCachedBytes)
+        {
+            mFreeBlocks[capacity].push_back(pData);
+            mStats.bytesCached += capacity;
+            return;
+        }
+        mStats.systemReleaseCount++;
+        if (advisesHugePages(capacity))
+            mStats.hugePageAdvisedBytes -= capacity;
+    }
+
+    releaseSystem(pData, capacity);
+}
+
+void ImageBufferPool::trim()
+{
+    std::map<size_t, std::vector<uint8_t*>> freeBlocks;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::swap(freeBlocks, mFreeBlocks);
+        for (const auto& [capacity, blocks] : freeBlocks)
+        {
+            mStats.systemReleaseCount += blocks.size();
+            if (advisesHugePages(capacity))
+                mStats.hugePageAdvisedBytes -= capacity * blocks.size();
+        }
+        mStats.bytesCached = 0;
+    }
+
+    for (const auto& [capacity, blocks] : freeBlocks)
+    {
+        for (uint8_t* pData : blocks)
+            releaseSystem(pData, capacity);
+    }
+}
+
+size_t ImageBufferPool::getCapacity(size_t size) const
+{
+    if (size < mOptions.minPooledSize)
+        return size;
+
+    // Four size classes per power of two bound the waste to 25%.
+    // All classes above the minimum pooled size are multiples of the 4 KB page size.
+    size_t powerOf2 = fstd::bit_floor(size);
+    size_t step = std::max<size_t>(powerOf2 / 4, 4096);
+    return align_to(step, size);
+}
+
+ImageBufferPool::Stats ImageBufferPool::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
+
+bool ImageBufferPool::advisesHugePages(size_t capacity) const
+{
+#if FALCOR_LINUX
+    return mOptions.useHugePages && capacity >= kHugePageSize;
+#else
+    return false;
+#endif
+}
+
+uint8_t* ImageBufferPool::allocateSystem(size_t capacity)
+{
+#if FALCOR_WINDOWS
+    void* pData = VirtualAlloc(nullptr, capacity, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (!pData)
+        throw std::bad_alloc();
+    return static_cast<uint8_t*>(pData);
+#elif FALCOR_LINUX
+    void* pData = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pData == MAP_FAILED)
+        throw std::bad_alloc();
+    // Huge pages are a hint only. Failure leaves the block backed by regular pages.
+    if (advisesHugePages(capacity))
+        madvise(pData, capacity, MADV_HUGEPAGE);
+    return static_cast<uint8_t*>(pData);
+#else
+    return new uint8_t[capacity];
+#endif
+}
+
+void ImageBufferPool::releaseSystem(uint8_t* pData, size_t capacity)
+{
+#if FALCOR_WINDOWS
+    VirtualFree(pData, 0, MEM_RELEASE);
+#elif FALCOR_LINUX
+    munmap(pData, capacity);
+#else
+    delete[] pData;
+#endif
+}
+} // namespace Falcor
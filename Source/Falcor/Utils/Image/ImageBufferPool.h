@@ -0,0 +1,138 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Pool of large CPU buffers for image data.
+ *
+ * Texture loading and frame capture allocate and free many multi-megabyte buffers of a few recurring sizes.
+ * Serving these from the regular heap fragments it and pays for fresh page faults on every allocation.
+ * The pool rounds requests up to size classes (four per power of two) and keeps freed blocks on per-class
+ * free lists, up to a configurable amount of cached memory. Blocks are allocated from the OS as page-aligned
+ * virtual memory and returned to it when the cache is full or trimmed. On Linux, blocks of 2 MB or more are
+ * backed by transparent huge pages. Small requests are served by the regular heap.
+ *
+ * All operations are thread-safe.
+ */
+class FALCOR_API ImageBufferPool
+{
+public:
+    struct Options
+    {
+        size_t minPooledSize = 64 * 1024;          ///< Smaller requests are served by the regular heap.
+        size_t maxCachedBytes = 512 * 1024 * 1024; ///< Max total capacity of free blocks kept for reuse.
+        bool useHugePages = true;                  ///< Back large blocks by transparent huge pages (Linux only).
+    };
+
+    struct Stats
+    {
+        uint64_t allocationCount = 0;       ///< Total number of allocations.
+        uint64_t heapAllocationCount = 0;   ///< Number of small allocations served by the regular heap.
+        uint64_t reuseCount = 0;            ///< Number of allocations served from the free lists.
+        uint64_t systemAllocationCount = 0; ///< Number of blocks allocated from the OS.
+        uint64_t systemReleaseCount = 0;    ///< Number of blocks returned to the OS.
+        uint64_t bytesInUse = 0;            ///< Total capacity of pooled blocks currently in use.
+        uint64_t peakBytesInUse = 0;        ///< Peak of bytesInUse.
+        uint64_t bytesCached = 0;           ///< Total capacity of free blocks kept for reuse.
+        /// Total capacity of blocks (in use or cached) for which huge pages were requested. This is only advice to the OS,
+        /// the number of bytes actually backed by huge pages may be lower.
+        uint64_t hugePageAdvisedBytes = 0;
+    };
+
+    /// Deleter returning a buffer to its pool.
+    class FALCOR_API Deleter
+    {
+    public:
+        Deleter() = default;
+        Deleter(ImageBufferPool* pPool, size_t capacity) : mpPool(pPool), mCapacity(capacity) {}
+
+        void operator()(uint8_t* pData) const;
+
+        /// Get the usable size of the buffer in bytes.
+        size_t getCapacity() const { return mCapacity; }
+
+    private:
+        ImageBufferPool* mpPool = nullptr; ///< Owning pool, or nullptr if allocated from the regular heap.
+        size_t mCapacity = 0;
+    };
+
+    using Buffer = std::unique_ptr<uint8_t[], Deleter>;
+
+    ImageBufferPool();
+    explicit ImageBufferPool(const Options& options);
+
+    /// Destructor. All buffers must have been released.
+    ~ImageBufferPool();
+
+    ImageBufferPool(const ImageBufferPool&) = delete;
+    ImageBufferPool& operator=(const ImageBufferPool&) = delete;
+
+    /**
+     * Get the global pool used by Bitmap, ImageIO and texture capture.
+     * The global pool is never destroyed, so buffers may outlive static destruction.
+     */
+    static ImageBufferPool& getGlobal();
+
+    /**
+     * Allocate a buffer. The content is uninitialized.
+     * @param[in] size Size in bytes.
+     * @return Buffer of at least the requested size. Destroying it returns the memory to the pool.
+     */
+    Buffer allocate(size_t size);
+
+    /// Return all cached free blocks to the OS.
+    void trim();
+
+    /// Get the capacity of the block used to serve a request of the given size.
+    size_t getCapacity(size_t size) const;
+
+    const Options& getOptions() const { return mOptions; }
+
+    Stats getStats() const;
+
+private:
+    void release(uint8_t* pData, size_t capacity);
+    bool advisesHugePages(size_t capacity) const;
+    uint8_t* allocateSystem(size_t capacity);
+    void releaseSystem(uint8_t* pData, size_t capacity);
+
+    Options mOptions;
+    mutable std::mutex mMutex;
+    std::map<size_t, std::vector<uint8_t*>> mFreeBlocks; ///< Free blocks by capacity.
+    Stats mStats;
+};
+} // namespace Falcor
@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "ImageIO.h"
+#include "ImageBufferPool.h"
 #include "Core/Error.h"
 #include "Core/API/Device.h"
 #include "Core/API/CopyContext.h"
@@ -579,10 +580,10 @@ Bitmap::UniqueConstPtr ImageIO::loadBitmapFromDDS(const std::filesystem::path& p
 
 ref<Texture> ImageIO::loadTextureFromDDS(ref<Device> pDevice, const std::filesystem::path& path, bool loadAsSrgb)
 {
-    ImportData data;
+    DDSImage image;
     try
     {
-        loadDDS(path, loadAsSrgb, data);
+        image = loadDDSImage(path, loadAsSrgb);
     }
     catch (const RuntimeError& e)
     {
@@ -590,33 +591,52 @@ ref<Texture> ImageIO::loadTextureFromDDS(ref<Device> pDevice, const std::filesys
         return nullptr;
     }
 
-    ref<Texture> pTex;
+    ref<Texture> pTex = createTextureFromDDSImage(pDevice, image);
+    if (pTex != nullptr)
+    {
+        pTex->setSourcePath(path);
+    }
+    else
+    {
+        logWarning("Failed to load DDS image from '{}': Unrecognized texture type.", path);
+    }
+
+    return pTex;
+}
+
+ImageIO::DDSImage ImageIO::loadDDSImage(const std::filesystem::path& path, bool loadAsSrgb)
+{
+    ImportData data;
+    loadDDS(path, loadAsSrgb, data);
+
+    DDSImage image;
+    image.type = data.type;
+    image.format = data.format;
+    image.width = data.width;
+    image.height = data.height;
+    image.depth = data.depth;
+    image.arraySize = data.arraySize;
+    image.mipLevels = data.mipLevels;
+    image.data = std::move(data.imageData);
+    return image;
+}
+
+ref<Texture> ImageIO::createTextureFromDDSImage(ref<Device> pDevice, const DDSImage& image)
+{
     // TODO: Automatic mip generation
-    switch (data.type)
+    switch (image.type)
     {
     case Resource::Type::Texture1D:
-        pTex = pDevice->createTexture1D(data.width, data.format, data.arraySize, data.mipLevels, data.imageData.data());
-        break;
+        return pDevice->createTexture1D(image.width, image.format, image.arraySize, image.mipLevels, image.data.data());
     case Resource::Type::Texture2D:
-        pTex = pDevice->createTexture2D(data.width, data.height, data.format, data.arraySize, data.mipLevels, data.imageData.data());
-        break;
+        return pDevice->createTexture2D(image.width, image.height, image.format, image.arraySize, image.mipLevels, image.data.data());
     case Resource::Type::TextureCube:
-        pTex = pDevice->createTextureCube(data.width, data.height, data.format, data.arraySize / 6, data.mipLevels, data.imageData.data());
-        break;
+        return pDevice->createTextureCube(image.width, image.height, image.format, image.arraySize / 6, image.mipLevels, image.data.data());
     case Resource::Type::Texture3D:
-        pTex = pDevice->createTexture3D(data.width, data.height, data.depth, data.format, data.mipLevels, data.imageData.data());
-        break;
+        return pDevice->createTexture3D(image.width, image.height, image.depth, image.format, image.mipLevels, image.data.data());
     default:
-        logWarning("Failed to load DDS image from '{}': Unrecognized texture type.", path);
         return nullptr;
     }
-
-    if (pTex != nullptr)
-    {
-        pTex->setSourcePath(path);
-    }
-
-    return pTex;
 }
 
 void ImageIO::saveToDDS(const std::filesystem::path& path, const Bitmap& bitmap, CompressionMode mode, bool generateMips)
@@ -695,6 +715,86 @@ void ImageIO::saveToDDS(const std::filesystem::path& path, const Bitmap& bitmap,
     }
 }
 
+void ImageIO::saveToDDS(
+    const std::filesystem::path& path,
+    uint32_t width,
+    uint32_t height,
+    ResourceFormat format,
+    uint32_t mipCount,
+    const void* pData,
+    CompressionMode mode
+)
+{
+    if (!hasExtension(path, "dds"))
+    {
+        logWarning("Saving DDS image to '{}' which does not have 'dds' file extension.", path);
+    }
+
+    try
+    {
+        ExportData image;
+        image.type = nvtt::TextureType::TextureType_2D;
+        image.width = width;
+        image.height = height;
+        image.depth = 1;
+        image.format = format;
+        image.faceCount = 1;
+        image.mipLevels = mipCount;
+
+        if (isCompressedFormat(format))
+        {
+            FALCOR_THROW("Saving precomputed mips of compressed formats is not supported.");
+        }
+        if (getFormatChannelCount(format) == 2 && mode != CompressionMode::BC5)
+        {
+            FALCOR_THROW("Only BC5 compression is supported for two channel images.");
+        }
+        if (mode != CompressionMode::None && (width % 4 != 0 || height % 4 != 0))
+        {
+            FALCOR_THROW("Image dimensions must be a multiple of 4 for block compression.");
+        }
+
+        const uint8_t* pMipData = static_cast<const uint8_t*>(pData);
+        for (uint32_t mip = 0; mip < mipCount; ++mip)
+        {
+            ExportData mipImage = image;
+            mipImage.width = std::max(1u, width >> mip);
+            mipImage.height = std::max(1u, height >> mip);
+
+            nvtt::Surface surface;
+            FormatType type = getFormatType(format);
+            if (type == FormatType::Sint || type == FormatType::Snorm)
+            {
+                setImage<int8_t>(pMipData, surface, mipImage, mipImage.width, mipImage.height, 1);
+            }
+            else if (type == FormatType::Uint || type == FormatType::Unorm || type == FormatType::UnormSrgb)
+            {
+                setImage<uint8_t>(pMipData, surface, mipImage, mipImage.width, mipImage.height, 1);
+            }
+            else if (type == FormatType::Float)
+            {
+                if (getNumChannelBits(format, 0) == 16)
+                {
+                    setImage<float16_t>(pMipData, surface, mipImage, mipImage.width, mipImage.height, 1);
+                }
+                else if (getNumChannelBits(format, 0) == 32)
+                {
+                    setImage<float>(pMipData, surface, mipImage, mipImage.width, mipImage.height, 1);
+                }
+            }
+            image.images.push_back(surface);
+
+            pMipData += (size_t)mipImage.width * mipImage.height * getFormatBytesPerBlock(format);
+        }
+
+        exportDDS(path, image, mode, false);
+    }
+    catch (const RuntimeError& e)
+    {
+        FALCOR_THROW("Failed to save DDS image to '{}': {}", path, e.what());
+    }
+}
+
 void ImageIO::saveToDDS(
     CopyContext* pContext,
     const std::filesystem::path& path,
@@ -756,7 +856,10 @@ void ImageIO::saveToDDS(
             for (uint32_t m = 0; m < image.mipLevels; ++m)
             {
                 uint32_t subresource = pTexture->getSubresourceIndex(f, m);
-                std::vector<uint8_t> subresourceData = pContext->readTextureSubresource(pTexture.get(), subresource);
+                // Read back into a pooled buffer, consecutive faces and textures reuse the same blocks.
+                auto pReadTask = pContext->asyncReadTextureSubresource(pTexture.get(), subresource);
+                ImageBufferPool::Buffer subresourceData = ImageBufferPool::getGlobal().allocate(pReadTask->getDataSize());
+                pReadTask->getData(subresourceData.get(), pReadTask->getDataSize());
 
                 nvtt::Surface surface;
                 FormatType type = getFormatType(image.format);
@@ -766,21 +869,21 @@ void ImageIO::saveToDDS(
 
                 if (type == FormatType::Sint || type == FormatType::Snorm)
                 {
-                    setImage<int8_t>(subresourceData.data(), surface, image, width, height, depth);
+                    setImage<int8_t>(subresourceData.get(), surface, image, width, height, depth);
                 }
                 else if (type == FormatType::Uint || type == FormatType::Unorm || type == FormatType::UnormSrgb)
                 {
-                    setImage<uint8_t>(subresourceData.data(), surface, image, width, height, depth);
+                    setImage<uint8_t>(subresourceData.get(), surface, image, width, height, depth);
                 }
                 else if (type == FormatType::Float)
                 {
                     if (getNumChannelBits(image.format, 0) == 16)
                     {
-                        setImage<float16_t>(subresourceData.data(), surface, image, width, height, depth);
+                        setImage<float16_t>(subresourceData.get(), surface, image, width, height, depth);
                     }
                     else if (getNumChannelBits(image.format, 0) == 32)
                     {
-                        setImage<float>(subresourceData.data(), surface, image, width, height, depth);
+                        setImage<float>(subresourceData.get(), surface, image, width, height, depth);
                     }
                 }
 
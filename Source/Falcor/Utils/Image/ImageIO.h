@@ -28,8 +28,10 @@
 #pragma once
 #include "Bitmap.h"
 #include "Core/Macros.h"
+#include "Core/Enum.h"
 #include "Core/API/Texture.h"
 #include <filesystem>
+#include <vector>
 
 namespace Falcor
 {
@@ -72,6 +74,20 @@ public:
         None
     };
 
+    FALCOR_ENUM_INFO(
+        CompressionMode,
+        {
+            {CompressionMode::BC1, "BC1"},
+            {CompressionMode::BC2, "BC2"},
+            {CompressionMode::BC3, "BC3"},
+            {CompressionMode::BC4, "BC4"},
+            {CompressionMode::BC5, "BC5"},
+            {CompressionMode::BC6, "BC6"},
+            {CompressionMode::BC7, "BC7"},
+            {CompressionMode::None, "None"},
+        }
+    );
+
     /**
      * Load a DDS file to a Bitmap. If the file contains an image array and/or mips, only the first image will be loaded.
      * Throws an exception if the DDS file is malformed.
@@ -90,6 +106,36 @@ public:
      */
     static ref<Texture> loadTextureFromDDS(ref<Device> pDevice, const std::filesystem::path& path, bool loadAsSrgb);
 
+    /// Image data and layout of a DDS file.
+    struct DDSImage
+    {
+        Resource::Type type = Resource::Type::Texture2D;
+        ResourceFormat format = ResourceFormat::Unknown;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t depth = 1;
+        uint32_t arraySize = 1;
+        uint32_t mipLevels = 1;
+        std::vector<uint8_t> data; ///< Image data of all subresources, tightly packed.
+    };
+
+    /**
+     * Load a DDS file to CPU memory without creating any GPU resources. This is safe to call from worker threads.
+     * Throws an exception if the DDS file cannot be opened or is malformed.
+     * @param[in] path Path of file to load.
+     * @param[in] loadAsSrgb If true, convert the image format property to a corresponding sRGB format if available.
+     * @return Image data and layout.
+     */
+    static DDSImage loadDDSImage(const std::filesystem::path& path, bool loadAsSrgb);
+
+    /**
+     * Create a texture from a DDS image previously loaded with loadDDSImage().
+     * @param[in] pDevice GPU device.
+     * @param[in] image DDS image.
+     * @return Texture object if the resource type is supported. Otherwise, nullptr.
+     */
+    static ref<Texture> createTextureFromDDSImage(ref<Device> pDevice, const DDSImage& image);
+
     /**
      * Saves a bitmap to a DDS file.
      * Throws an exception if path is invalid or the image cannot be saved.
@@ -105,6 +151,27 @@ public:
         bool generateMips = false
     );
 
+    /**
+     * Saves a 2D image with a precomputed mip chain to a DDS file.
+     * Throws an exception if path is invalid or the image cannot be saved.
+     * @param[in] path Path to save to.
+     * @param[in] width Width of mip 0.
+     * @param[in] height Height of mip 0. Width and height must be multiples of 4 when compressing.
+     * @param[in] format Format of the data.
+     * @param[in] mipCount Number of mip levels in the data.
+     * @param[in] pData Data of all mip levels starting with mip 0, tightly packed (see MipGenerator::generate()).
+     * @param[in] mode Block compression mode.
+     */
+    static void saveToDDS(
+        const std::filesystem::path& path,
+        uint32_t width,
+        uint32_t height,
+        ResourceFormat format,
+        uint32_t mipCount,
+        const void* pData,
+        CompressionMode mode = CompressionMode::None
+    );
+
     /**
      * Saves a Texture to a DDS file. All mips and array images are saved.
      * Throws an exception if the path is invalid or the image cannot be saved.
@@ -125,4 +192,6 @@ public:
         bool generateMips = false
     );
 };
+
+FALCOR_ENUM_REGISTER(ImageIO::CompressionMode);
 } // namespace Falcor
@@ -0,0 +1,702 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MipGenerator.h"
+#include "Core/Error.h"
+#include "Utils/Math/Float16.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MIP_GENERATOR_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC allows AVX2 intrinsics without /arch:AVX2.
+#define MIP_GENERATOR_AVX2_TARGET
+#else
+#define MIP_GENERATOR_AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+namespace Falcor
+{
+namespace
+{
+constexpr double kPi = 3.14159265358979323846;
+
+// Output rows per parallel work item.
+constexpr uint32_t kBlockRows = 16;
+
+// Kaiser filter parameters (same defaults as NVTT).
+constexpr double kKaiserWidth = 3.0;
+constexpr double kKaiserAlpha = 4.0;
+constexpr double kLanczosWidth = 3.0;
+
+enum class ComponentType
+{
+    Unorm8,
+    Unorm16,
+    Float16,
+    Float32,
+};
+
+struct FormatInfo
+{
+    ComponentType componentType = ComponentType::Unorm8;
+    uint32_t channelCount = 0;
+    uint32_t bytesPerPixel = 0;
+    bool srgb = false;
+    bool bgr = false;
+};
+
+bool getFormatInfo(ResourceFormat format, FormatInfo& info)
+{
+    if (format == ResourceFormat::Unknown || isCompressedFormat(format) || isDepthFormat(format))
+        return false;
+
+    const uint32_t channelCount = getFormatChannelCount(format);
+    const uint32_t bits = getNumChannelBits(format, 0);
+    if (channelCount == 0 || channelCount > 4)
+        return false;
+    for (uint32_t c = 1; c < channelCount; ++c)
+    {
+        if (getNumChannelBits(format, c) != bits)
+            return false;
+    }
+    if (getFormatBytesPerBlock(format) * 8 != channelCount * bits)
+        return false;
+
+    const FormatType type = getFormatType(format);
+    if ((type == FormatType::Unorm || type == FormatType::UnormSrgb) && bits == 8)
+        info.componentType = ComponentType::Unorm8;
+    else if (type == FormatType::Unorm && bits == 16)
+        info.componentType = ComponentType::Unorm16;
+    else if (type == FormatType::Float && bits == 16)
+        info.componentType = ComponentType::Float16;
+    else if (type == FormatType::Float && bits == 32)
+        info.componentType = ComponentType::Float32;
+    else
+        return false;
+
+    info.channelCount = channelCount;
+    info.bytesPerPixel = getFormatBytesPerBlock(format);
+    info.srgb = isSrgbFormat(format);
+    info.bgr = format == ResourceFormat::BGRA8Unorm || format == ResourceFormat::BGRA8UnormSrgb || format == ResourceFormat::BGRX8Unorm ||
+               format == ResourceFormat::BGRX8UnormSrgb;
+    return true;
+}
+
+float srgbToLinear(float v)
+{
+    return v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSrgb(float v)
+{
+    return v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.f / 2.4f) - 0.055f;
+}
+
+struct SrgbTables
+{
+    /// Linear value of each 8-bit sRGB code.
+    std::array<float, 256> toLinear;
+    /// Linear value at the midpoint between consecutive 8-bit sRGB codes. Encoding against these rounds in sRGB space.
+    std::array<float, 255> thresholds;
+    /// Code of the lower end of each bucket of linear values, used as the starting point of the search.
+    std::array<uint8_t, 4096> encodeStart;
+
+    SrgbTables()
+    {
+        for (uint32_t i = 0; i < 256; ++i)
+            toLinear[i] = srgbToLinear(i / 255.f);
+        for (uint32_t i = 0; i < 255; ++i)
+            thresholds[i] = srgbToLinear((i + 0.5f) / 255.f);
+        for (uint32_t i = 0; i < encodeStart.size(); ++i)
+        {
+            const float v = (float)i / (encodeStart.size() - 1);
+            encodeStart[i] = (uint8_t)(std::upper_bound(thresholds.begin(), thresholds.end(), v) - thresholds.begin());
+        }
+    }
+
+    /// Encode a linear value in [0,1] to the nearest 8-bit sRGB code.
+    uint8_t encode(float v) const
+    {
+        uint32_t code = encodeStart[(uint32_t)(v * (encodeStart.size() - 1))];
+        while (code < 255 && v >= thresholds[code])
+            ++code;
+        return (uint8_t)code;
+    }
+};
+
+const SrgbTables& getSrgbTables()
+{
+    static const SrgbTables tables;
+    return tables;
+}
+
+double sinc(double x)
+{
+    x *= kPi;
+    return std::abs(x) < 1e-8 ? 1.0 : std::sin(x) / x;
+}
+
+/// Modified Bessel function of the first kind of order zero.
+double bessel0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 64 && term > 1e-12 * sum; ++k)
+    {
+        const double t = x / (2.0 * k);
+        term *= t * t;
+        sum += term;
+    }
+    return sum;
+}
+
+double evaluateFilter(MipGenerator::Filter filter, double x)
+{
+    x = std::abs(x);
+    switch (filter)
+    {
+    case MipGenerator::Filter::Box:
+        return x <= 0.5 ? 1.0 : 0.0;
+    case MipGenerator::Filter::Kaiser:
+        if (x >= kKaiserWidth)
+            return 0.0;
+        return sinc(x) * bessel0(kKaiserAlpha * std::sqrt(1.0 - (x / kKaiserWidth) * (x / kKaiserWidth))) / bessel0(kKaiserAlpha);
+    case MipGenerator::Filter::Lanczos:
+        return x < kLanczosWidth ? sinc(x) * sinc(x / kLanczosWidth) : 0.0;
+    default:
+        FALCOR_UNREACHABLE();
+        return 0.0;
+    }
+}
+
+/**
+ * Weights of a 2:1 downsampling kernel.
+ * Output pixel x reads input pixels 2 * x + k - offset for k in [0, taps).
+ */
+struct Kernel
+{
+    uint32_t taps = 1;
+    int32_t offset = 0;
+    std::vector<float> weights = {1.f};
+};
+
+Kernel createKernel(MipGenerator::Filter filter)
+{
+    // Filter support in output pixels. Each output pixel covers two input pixels.
+    const double radius = filter == MipGenerator::Filter::Box ? 0.5 : 3.0;
+
+    Kernel kernel;
+    kernel.taps = (uint32_t)(4.0 * radius);
+    kernel.offset = (int32_t)kernel.taps / 2 - 1;
+    kernel.weights.resize(kernel.taps);
+
+    double sum = 0.0;
+    std::vector<double> weights(kernel.taps);
+    for (uint32_t k = 0; k < kernel.taps; ++k)
+    {
+        // Distance from the input pixel center to the output pixel center, in output pixels.
+        const double t = ((double)k - 0.5 * kernel.taps + 0.5) / 2.0;
+        weights[k] = evaluateFilter(filter, t);
+        sum += weights[k];
+    }
+    for (uint32_t k = 0; k < kernel.taps; ++k)
+        kernel.weights[k] = (float)(weights[k] / sum);
+    return kernel;
+}
+
+int32_t resolveIndex(int32_t i, int32_t n, MipGenerator::AddressMode mode)
+{
+    if (i >= 0 && i < n)
+        return i;
+    switch (mode)
+    {
+    case MipGenerator::AddressMode::Clamp:
+        return std::clamp(i, 0, n - 1);
+    case MipGenerator::AddressMode::Wrap:
+        return ((i % n) + n) % n;
+    case MipGenerator::AddressMode::Mirror:
+    {
+        const int32_t period = 2 * n;
+        const int32_t m = ((i % period) + period) % period;
+        return m < n ? m : period - 1 - m;
+    }
+    default:
+        FALCOR_UNREACHABLE();
+        return 0;
+    }
+}
+
+using WeightedSumFunc = void (*)(float* dst, const float* const* srcs, const float* weights, uint32_t taps, size_t n);
+
+/// dst[i] = sum_k weights[k] * srcs[k][i] for i in [0, n).
+void weightedSumScalar(float* dst, const float* const* srcs, const float* weights, uint32_t taps, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        float sum = weights[0] * srcs[0][i];
+        for (uint32_t k = 1; k < taps; ++k)
+            sum += weights[k] * srcs[k][i];
+        dst[i] = sum;
+    }
+}
+
+#if defined(MIP_GENERATOR_X86)
+MIP_GENERATOR_AVX2_TARGET void weightedSumAVX2(float* dst, const float* const* srcs, const float* weights, uint32_t taps, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m256 w0 = _mm256_set1_ps(weights[0]);
+        __m256 sum0 = _mm256_mul_ps(w0, _mm256_loadu_ps(srcs[0] + i));
+        __m256 sum1 = _mm256_mul_ps(w0, _mm256_loadu_ps(srcs[0] + i + 8));
+        for (uint32_t k = 1; k < taps; ++k)
+        {
+            const __m256 w = _mm256_set1_ps(weights[k]);
+            sum0 = _mm256_fmadd_ps(w, _mm256_loadu_ps(srcs[k] + i), sum0);
+            sum1 = _mm256_fmadd_ps(w, _mm256_loadu_ps(srcs[k] + i + 8), sum1);
+        }
+        _mm256_storeu_ps(dst + i, sum0);
+        _mm256_storeu_ps(dst + i + 8, sum1);
+    }
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 sum = _mm256_mul_ps(_mm256_set1_ps(weights[0]), _mm256_loadu_ps(srcs[0] + i));
+        for (uint32_t k = 1; k < taps; ++k)
+            sum = _mm256_fmadd_ps(_mm256_set1_ps(weights[k]), _mm256_loadu_ps(srcs[k] + i), sum);
+        _mm256_storeu_ps(dst + i, sum);
+    }
+    for (; i < n; ++i)
+    {
+        float sum = weights[0] * srcs[0][i];
+        for (uint32_t k = 1; k < taps; ++k)
+            sum += weights[k] * srcs[k][i];
+        dst[i] = sum;
+    }
+}
+
+bool detectAVX2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    const bool hasFMA = (info[2] & (1 << 12)) != 0;
+    const bool hasOSXSAVE = (info[2] & (1 << 27)) != 0;
+    if (!hasFMA || !hasOSXSAVE || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+#endif // MIP_GENERATOR_X86
+
+void parallelFor(uint32_t count, uint32_t threadCount, const std::function<void(uint32_t)>& func)
+{
+    threadCount = std::min(threadCount, count);
+    if (threadCount <= 1)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+            func(i);
+        return;
+    }
+
+    std::atomic<uint32_t> next{0};
+    auto worker = [&]()
+    {
+        for (uint32_t i = next++; i < count; i = next++)
+            func(i);
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (uint32_t i = 1; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+}
+
+/// Mip level stored as planar float data.
+struct Level
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<float> data;
+
+    size_t getPlaneSize() const { return (size_t)width * height; }
+};
+
+class Generator
+{
+public:
+    Generator(const FormatInfo& info, const MipGenerator::Options& options) : mInfo(info), mOptions(options), mSrgb(getSrgbTables())
+    {
+        mUseSrgb = (options.srgb || info.srgb) && info.componentType == ComponentType::Unorm8;
+        mNormalMap = options.normalMap && info.channelCount >= 2;
+
+        // Two-channel normal maps store xy only, z is reconstructed into an extra plane.
+        mPlaneCount = info.channelCount + (mNormalMap && info.channelCount == 2 ? 1 : 0);
+        if (info.bgr)
+            mNormalPlanes = {2, 1, 0};
+
+        mKernel = createKernel(options.filter);
+        mWeightedSum = weightedSumScalar;
+#if defined(MIP_GENERATOR_X86)
+        if (options.useSimd && MipGenerator::isSimdSupported())
+            mWeightedSum = weightedSumAVX2;
+#endif
+        mThreadCount = options.threadCount > 0 ? options.threadCount : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<uint8_t> run(const uint8_t* pData, uint32_t width, uint32_t height, uint32_t mipCount)
+    {
+        size_t totalSize = 0;
+        for (uint32_t mip = 0; mip < mipCount; ++mip)
+            totalSize += (size_t)std::max(1u, width >> mip) * std::max(1u, height >> mip) * mInfo.bytesPerPixel;
+
+        std::vector<uint8_t> result(totalSize);
+        size_t offset = (size_t)width * height * mInfo.bytesPerPixel;
+        std::memcpy(result.data(), pData, offset);
+
+        Level src;
+        src.width = width;
+        src.height = height;
+        for (uint32_t mip = 1; mip < mipCount; ++mip)
+        {
+            Level dst;
+            dst.width = std::max(1u, src.width / 2);
+            dst.height = std::max(1u, src.height / 2);
+
+            // The last level is encoded directly, all others are kept in float precision as the source of the next level.
+            const bool isLast = mip + 1 == mipCount;
+            if (!isLast)
+                dst.data.resize(dst.getPlaneSize() * mPlaneCount);
+
+            uint8_t* pDst = result.data() + offset;
+            const uint32_t blockCount = (dst.height + kBlockRows - 1) / kBlockRows;
+            parallelFor(
+                blockCount,
+                mThreadCount,
+                [&](uint32_t block)
+                {
+                    const uint32_t y0 = block * kBlockRows;
+                    const uint32_t y1 = std::min(dst.height, y0 + kBlockRows);
+                    downsampleRows(mip == 1 ? pData : nullptr, src, dst, pDst, y0, y1);
+                }
+            );
+
+            offset += dst.getPlaneSize() * mInfo.bytesPerPixel;
+            src = std::move(dst);
+        }
+        FALCOR_ASSERT(offset == totalSize);
+        return result;
+    }
+
+private:
+    /**
+     * Filter output rows [y0, y1) of a level.
+     * @param[in] pSrcData Encoded source data if the source is mip 0, nullptr otherwise.
+     * @param[in] src Source level. Only holds float data if pSrcData is nullptr.
+     * @param[in] dst Destination level. Float data is written if allocated.
+     * @param[in] pDst Encoded destination data.
+     */
+    void downsampleRows(const uint8_t* pSrcData, const Level& src, Level& dst, uint8_t* pDst, uint32_t y0, uint32_t y1) const
+    {
+        const int32_t srcWidth = (int32_t)src.width;
+        const int32_t srcHeight = (int32_t)src.height;
+
+        // Dimensions of size one are passed through unfiltered.
+        static const Kernel kIdentity;
+        const Kernel& kernelX = srcWidth > 1 ? mKernel : kIdentity;
+        const Kernel& kernelY = srcHeight > 1 ? mKernel : kIdentity;
+
+        auto getSrcRow = [&](uint32_t y, uint32_t k)
+        { return resolveIndex(2 * (int32_t)y + (int32_t)k - kernelY.offset, srcHeight, mOptions.addressMode); };
+
+        // Rows of mip 0 are decoded to float once per block.
+        std::vector<int32_t> decodedRows;
+        std::vector<float> decoded;
+        if (pSrcData)
+        {
+            for (uint32_t y = y0; y < y1; ++y)
+            {
+                for (uint32_t k = 0; k < kernelY.taps; ++k)
+                    decodedRows.push_back(getSrcRow(y, k));
+            }
+            std::sort(decodedRows.begin(), decodedRows.end());
+            decodedRows.erase(std::unique(decodedRows.begin(), decodedRows.end()), decodedRows.end());
+
+            decoded.resize(decodedRows.size() * mPlaneCount * src.width);
+            for (size_t i = 0; i < decodedRows.size(); ++i)
+            {
+                const uint8_t* pRow = pSrcData + (size_t)decodedRows[i] * src.width * mInfo.bytesPerPixel;
+                decodeRow(pRow, src.width, decoded.data() + i * mPlaneCount * src.width, src.width);
+            }
+        }
+        const size_t srcPlaneStride = pSrcData ? src.width : src.getPlaneSize();
+        auto getRowData = [&](int32_t row) -> const float*
+        {
+            if (!pSrcData)
+                return src.data.data() + (size_t)row * src.width;
+            const size_t i = std::lower_bound(decodedRows.begin(), decodedRows.end(), row) - decodedRows.begin();
+            return decoded.data() + i * mPlaneCount * src.width;
+        };
+
+        // Horizontal taps read from the even and odd pixels of the padded row, so that all taps are contiguous.
+        const uint32_t splitWidth = dst.width + kernelX.taps / 2;
+        std::vector<float> column(src.width);
+        std::vector<float> even(splitWidth);
+        std::vector<float> odd(splitWidth);
+        std::vector<float> rowScratch(dst.data.empty() ? mPlaneCount * dst.width : 0);
+        std::vector<const float*> rows(kernelY.taps);
+        std::vector<const float*> srcs(std::max(kernelX.taps, kernelY.taps));
+        std::vector<float*> dstPlanes(mPlaneCount);
+
+        for (uint32_t y = y0; y < y1; ++y)
+        {
+            for (uint32_t k = 0; k < kernelY.taps; ++k)
+                rows[k] = getRowData(getSrcRow(y, k));
+
+            for (uint32_t p = 0; p < mPlaneCount; ++p)
+            {
+                float* pDstRow = dst.data.empty() ? rowScratch.data() + p * dst.width
+                                                  : dst.data.data() + p * dst.getPlaneSize() + (size_t)y * dst.width;
+                dstPlanes[p] = pDstRow;
+
+                // Vertical pass.
+                for (uint32_t k = 0; k < kernelY.taps; ++k)
+                    srcs[k] = rows[k] + p * srcPlaneStride;
+                mWeightedSum(column.data(), srcs.data(), kernelY.weights.data(), kernelY.taps, src.width);
+
+                // Horizontal pass.
+                if (srcWidth == 1)
+                {
+                    pDstRow[0] = column[0];
+                    continue;
+                }
+                for (uint32_t j = 0; j < splitWidth; ++j)
+                {
+                    even[j] = column[resolveIndex(2 * (int32_t)j - kernelX.offset, srcWidth, mOptions.addressMode)];
+                    odd[j] = column[resolveIndex(2 * (int32_t)j + 1 - kernelX.offset, srcWidth, mOptions.addressMode)];
+                }
+                for (uint32_t k = 0; k < kernelX.taps; ++k)
+                    srcs[k] = (k % 2 == 0 ? even.data() : odd.data()) + k / 2;
+                mWeightedSum(pDstRow, srcs.data(), kernelX.weights.data(), kernelX.taps, dst.width);
+            }
+
+            if (mNormalMap)
+                normalizeRow(dstPlanes.data(), dst.width);
+            encodeRow(dstPlanes.data(), dst.width, pDst + (size_t)y * dst.width * mInfo.bytesPerPixel);
+        }
+    }
+
+    /// Decode a row of mip 0 to planar float data. Color channels are converted to linear and normals are unpacked.
+    void decodeRow(const uint8_t* pSrc, uint32_t width, float* pDst, size_t planeStride) const
+    {
+        const uint32_t channelCount = mInfo.channelCount;
+        for (uint32_t c = 0; c < channelCount; ++c)
+        {
+            float* pPlane = pDst + c * planeStride;
+            const bool isColor = c < 3;
+            switch (mInfo.componentType)
+            {
+            case ComponentType::Unorm8:
+                for (uint32_t x = 0; x < width; ++x)
+                {
+                    const uint8_t v = pSrc[x * channelCount + c];
+                    pPlane[x] = (mUseSrgb && isColor) ? mSrgb.toLinear[v] : v * (1.f / 255.f);
+                }
+                break;
+            case ComponentType::Unorm16:
+                for (uint32_t x = 0; x < width; ++x)
+                    pPlane[x] = reinterpret_cast<const uint16_t*>(pSrc)[x * channelCount + c] * (1.f / 65535.f);
+                break;
+            case ComponentType::Float16:
+                for (uint32_t x = 0; x < width; ++x)
+                    pPlane[x] = math::float16ToFloat32(reinterpret_cast<const uint16_t*>(pSrc)[x * channelCount + c]);
+                break;
+            case ComponentType::Float32:
+                for (uint32_t x = 0; x < width; ++x)
+                    pPlane[x] = reinterpret_cast<const float*>(pSrc)[x * channelCount + c];
+                break;
+            }
+        }
+
+        if (mNormalMap)
+        {
+            const bool isUnorm = mInfo.componentType == ComponentType::Unorm8 || mInfo.componentType == ComponentType::Unorm16;
+            float* planes[3] = {
+                pDst + mNormalPlanes[0] * planeStride, pDst + mNormalPlanes[1] * planeStride, pDst + mNormalPlanes[2] * planeStride};
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                if (isUnorm)
+                {
+                    planes[0][x] = planes[0][x] * 2.f - 1.f;
+                    planes[1][x] = planes[1][x] * 2.f - 1.f;
+                    if (channelCount > 2)
+                        planes[2][x] = planes[2][x] * 2.f - 1.f;
+                }
+                if (channelCount == 2)
+                    planes[2][x] = std::sqrt(std::max(0.f, 1.f - planes[0][x] * planes[0][x] - planes[1][x] * planes[1][x]));
+            }
+        }
+    }
+
+    void normalizeRow(float* const* planes, uint32_t width) const
+    {
+        float* px = planes[mNormalPlanes[0]];
+        float* py = planes[mNormalPlanes[1]];
+        float* pz = planes[mNormalPlanes[2]];
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            const float lengthSq = px[x] * px[x] + py[x] * py[x] + pz[x] * pz[x];
+            if (lengthSq > 1e-12f)
+            {
+                const float scale = 1.f / std::sqrt(lengthSq);
+                px[x] *= scale;
+                py[x] *= scale;
+                pz[x] *= scale;
+            }
+            else
+            {
+                px[x] = 0.f;
+                py[x] = 0.f;
+                pz[x] = 1.f;
+            }
+        }
+    }
+
+    /// Encode a row of planar float data to the output format.
+    void encodeRow(float* const* planes, uint32_t width, uint8_t* pDst) const
+    {
+        const uint32_t channelCount = mInfo.channelCount;
+        const bool isUnorm = mInfo.componentType == ComponentType::Unorm8 || mInfo.componentType == ComponentType::Unorm16;
+        for (uint32_t c = 0; c < channelCount; ++c)
+        {
+            const float* pPlane = planes[c];
+            const bool isColor = c < 3;
+            const bool isNormal = mNormalMap && isUnorm && (isColor || channelCount == 2);
+            auto toUnorm = [&](float v) { return std::clamp(isNormal ? v * 0.5f + 0.5f : v, 0.f, 1.f); };
+            switch (mInfo.componentType)
+            {
+            case ComponentType::Unorm8:
+                for (uint32_t x = 0; x < width; ++x)
+                {
+                    const float v = toUnorm(pPlane[x]);
+                    pDst[x * channelCount + c] = (mUseSrgb && isColor) ? mSrgb.encode(v) : (uint8_t)(v * 255.f + 0.5f);
+                }
+                break;
+            case ComponentType::Unorm16:
+                for (uint32_t x = 0; x < width; ++x)
+                    reinterpret_cast<uint16_t*>(pDst)[x * channelCount + c] = (uint16_t)(toUnorm(pPlane[x]) * 65535.f + 0.5f);
+                break;
+            case ComponentType::Float16:
+                for (uint32_t x = 0; x < width; ++x)
+                    reinterpret_cast<uint16_t*>(pDst)[x * channelCount + c] = math::float32ToFloat16(pPlane[x]);
+                break;
+            case ComponentType::Float32:
+                for (uint32_t x = 0; x < width; ++x)
+                    reinterpret_cast<float*>(pDst)[x * channelCount + c] = pPlane[x];
+                break;
+            }
+        }
+    }
+
+    FormatInfo mInfo;
+    MipGenerator::Options mOptions;
+    const SrgbTables& mSrgb;
+    bool mUseSrgb = false;
+    bool mNormalMap = false;
+    uint32_t mPlaneCount = 0;
+    std::array<uint32_t, 3> mNormalPlanes = {0, 1, 2}; ///< Planes holding the normal xyz.
+    Kernel mKernel;
+    WeightedSumFunc mWeightedSum = nullptr;
+    uint32_t mThreadCount = 1;
+};
+} // namespace
+
+bool MipGenerator::isFormatSupported(ResourceFormat format)
+{
+    FormatInfo info;
+    return getFormatInfo(format, info);
+}
+
+uint32_t MipGenerator::getMipCount(uint32_t width, uint32_t height)
+{
+    uint32_t count = 1;
+    for (uint32_t size = std::max(width, height); size > 1; size /= 2)
+        ++count;
+    return count;
+}
+
+bool MipGenerator::isSimdSupported()
+{
+#if defined(MIP_GENERATOR_X86)
+    static const bool supported = detectAVX2();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+std::vector<uint8_t> MipGenerator::generate(
+    const void* pData,
+    uint32_t width,
+    uint32_t height,
+    ResourceFormat format,
+    const Options& options,
+    uint32_t mipCount
+)
+{
+    FormatInfo info;
+    if (!getFormatInfo(format, info))
+        FALCOR_THROW("MipGenerator does not support format {}.", to_string(format));
+    FALCOR_CHECK(pData != nullptr, "'pData' must not be null.");
+    FALCOR_CHECK(width > 0 && height > 0, "Image dimensions must be non-zero.");
+
+    const uint32_t maxMipCount = getMipCount(width, height);
+    mipCount = mipCount == 0 ? maxMipCount : std::min(mipCount, maxMipCount);
+
+    Generator generator(info, options);
+    return generator.run(static_cast<const uint8_t*>(pData), width, height, mipCount);
+}
+} // namespace Falcor
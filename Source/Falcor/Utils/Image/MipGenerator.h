@@ -0,0 +1,135 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Enum.h"
+#include "Core/API/Formats.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Generates mip chains on the CPU.
+ *
+ * Unlike Texture::generateMips(), which downsamples with a bilinear blit on the GPU, the generator uses a wide
+ * windowed-sinc kernel, filters sRGB data in linear space and renormalizes normal maps at every level.
+ * Levels are produced by a cascade of separable 2:1 downsampling passes. Rows are filtered in parallel
+ * and the inner loops use AVX2/FMA when the CPU supports it.
+ */
+class FALCOR_API MipGenerator
+{
+public:
+    /// Downsampling filter.
+    enum class Filter
+    {
+        Box,     ///< 2x2 box filter. Same result as a bilinear blit.
+        Kaiser,  ///< Kaiser-windowed sinc (width 3, alpha 4).
+        Lanczos, ///< Lanczos-windowed sinc (width 3).
+    };
+
+    FALCOR_ENUM_INFO(
+        Filter,
+        {
+            {Filter::Box, "Box"},
+            {Filter::Kaiser, "Kaiser"},
+            {Filter::Lanczos, "Lanczos"},
+        }
+    );
+
+    /// Handling of filter taps outside of the image.
+    enum class AddressMode
+    {
+        Clamp,
+        Wrap,
+        Mirror,
+    };
+
+    FALCOR_ENUM_INFO(
+        AddressMode,
+        {
+            {AddressMode::Clamp, "Clamp"},
+            {AddressMode::Wrap, "Wrap"},
+            {AddressMode::Mirror, "Mirror"},
+        }
+    );
+
+    struct Options
+    {
+        Filter filter = Filter::Kaiser;
+        AddressMode addressMode = AddressMode::Mirror;
+        /// Treat the color channels as sRGB encoded. Always enabled for sRGB formats.
+        bool srgb = false;
+        /// Treat the data as a tangent space normal map (xyz in the color channels, unorm data mapped from [-1,1]).
+        bool normalMap = false;
+        /// Number of threads. Zero uses the hardware concurrency, one runs on the calling thread only.
+        uint32_t threadCount = 0;
+        /// Use the SIMD code path if supported by the CPU. The scalar path serves as the reference implementation.
+        bool useSimd = true;
+    };
+
+    /**
+     * Check if mips can be generated for a format.
+     * Supported are uncompressed formats with 1-4 channels of 8/16-bit unorm, 16-bit float or 32-bit float.
+     */
+    static bool isFormatSupported(ResourceFormat format);
+
+    /**
+     * Get the number of levels in a full mip chain.
+     */
+    static uint32_t getMipCount(uint32_t width, uint32_t height);
+
+    /**
+     * Check if the SIMD code path is available on this CPU.
+     */
+    static bool isSimdSupported();
+
+    /**
+     * Generate a mip chain.
+     * Throws an exception if the format is not supported.
+     * @param[in] pData Data of mip 0, tightly packed.
+     * @param[in] width Width of mip 0.
+     * @param[in] height Height of mip 0.
+     * @param[in] format Format of the data.
+     * @param[in] options Options.
+     * @param[in] mipCount Number of levels to generate including mip 0, or zero for the full chain.
+     * @return Data of all levels starting with a copy of mip 0, tightly packed in the order expected by Device::createTexture2D().
+     */
+    static std::vector<uint8_t> generate(
+        const void* pData,
+        uint32_t width,
+        uint32_t height,
+        ResourceFormat format,
+        const Options& options,
+        uint32_t mipCount = 0
+    );
+};
+
+FALCOR_ENUM_REGISTER(MipGenerator::Filter);
+FALCOR_ENUM_REGISTER(MipGenerator::AddressMode);
+} // namespace Falcor
@@ -0,0 +1,601 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "StreamingImageWriter.h"
+#include "Core/API/Device.h"
+#include "Core/API/RenderContext.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include "Utils/StringFormatters.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Math/Float16.h"
+
+#include <ImfChannelList.h>
+#include <ImfCompression.h>
+#include <ImfFrameBuffer.h>
+#include <ImfHeader.h>
+#include <ImfMultiPartOutputFile.h>
+#include <ImfOutputFile.h>
+#include <ImfOutputPart.h>
+#include <ImfPartType.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+// Buffer offsets for texture copies must be aligned to the D3D12 texture data placement alignment.
+constexpr uint64_t kPartAlignment = 512;
+
+bool isBGRFormat(ResourceFormat format)
+{
+    switch (format)
+    {
+    case ResourceFormat::BGRA4Unorm:
+    case ResourceFormat::BGRA8Unorm:
+    case ResourceFormat::BGRA8UnormSrgb:
+    case ResourceFormat::BGRX8Unorm:
+    case ResourceFormat::BGRX8UnormSrgb:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// Returns the number of bits per channel if all channels have the same size, 0 otherwise.
+uint32_t getUniformChannelBits(ResourceFormat format)
+{
+    if (isCompressedFormat(format) || isDepthStencilFormat(format) || isBGRFormat(format))
+        return 0;
+    uint32_t channelCount = getFormatChannelCount(format);
+    uint32_t bits = getNumChannelBits(format, 0);
+    for (uint32_t i = 1; i < channelCount; ++i)
+        if (getNumChannelBits(format, i) != bits)
+            return 0;
+    if (bits != 8 && bits != 16 && bits != 32)
+        return 0;
+    if (getFormatBytesPerBlock(format) * 8 != channelCount * bits)
+        return 0;
+    return bits;
+}
+
+/// Convert one row of texels to float. Normalized formats are mapped to [0,1] or [-1,1].
+void convertRowToFloat(const uint8_t* pSrc, float* pDst, uint32_t valueCount, FormatType type, uint32_t bits)
+{
+    for (uint32_t i = 0; i < valueCount; ++i)
+    {
+        float value = 0.f;
+        switch (type)
+        {
+        case FormatType::Float:
+            value = bits == 16 ? math::float16ToFloat32(reinterpret_cast<const uint16_t*>(pSrc)[i]) : reinterpret_cast<const float*>(pSrc)[i];
+            break;
+        case FormatType::Unorm:
+        case FormatType::UnormSrgb:
+            value = bits == 8 ? pSrc[i] / 255.f : reinterpret_cast<const uint16_t*>(pSrc)[i] / 65535.f;
+            break;
+        case FormatType::Snorm:
+            value = bits == 8 ? std::max(reinterpret_cast<const int8_t*>(pSrc)[i] / 127.f, -1.f)
+                              : std::max(reinterpret_cast<const int16_t*>(pSrc)[i] / 32767.f, -1.f);
+            break;
+        case FormatType::Uint:
+            value = bits == 8 ? float(pSrc[i]) : bits == 16 ? float(reinterpret_cast<const uint16_t*>(pSrc)[i]) : float(reinterpret_cast<const uint32_t*>(pSrc)[i]);
+            break;
+        case FormatType::Sint:
+            value = bits == 8    ? float(reinterpret_cast<const int8_t*>(pSrc)[i])
+                    : bits == 16 ? float(reinterpret_cast<const int16_t*>(pSrc)[i])
+                                 : float(reinterpret_cast<const int32_t*>(pSrc)[i]);
+            break;
+        default:
+            break;
+        }
+        pDst[i] = value;
+    }
+}
+
+Imf::Compression getImfCompression(StreamingImageWriter::ExrCompression compression)
+{
+    switch (compression)
+    {
+    case StreamingImageWriter::ExrCompression::None:
+        return Imf::NO_COMPRESSION;
+    case StreamingImageWriter::ExrCompression::Rle:
+        return Imf::RLE_COMPRESSION;
+    case StreamingImageWriter::ExrCompression::Zips:
+        return Imf::ZIPS_COMPRESSION;
+    case StreamingImageWriter::ExrCompression::Zip:
+        return Imf::ZIP_COMPRESSION;
+    case StreamingImageWriter::ExrCompression::Piz:
+        return Imf::PIZ_COMPRESSION;
+    }
+    FALCOR_UNREACHABLE();
+}
+
+const char* getNpyDescr(FormatType type, uint32_t bits)
+{
+    switch (type)
+    {
+    case FormatType::Float:
+        return bits == 16 ? "<f2" : "<f4";
+    case FormatType::Unorm:
+    case FormatType::UnormSrgb:
+    case FormatType::Uint:
+        return bits == 8 ? "|u1" : bits == 16 ? "<u2" : "<u4";
+    case FormatType::Snorm:
+    case FormatType::Sint:
+        return bits == 8 ? "|i1" : bits == 16 ? "<i2" : "<i4";
+    default:
+        return nullptr;
+    }
+}
+/// Location and format of a part inside a staging buffer.
+struct PartLayout
+{
+    std::string name;
+    ResourceFormat format;
+    uint32_t width;
+    uint32_t height;
+    uint64_t offset;
+    bool exportAlpha;
+    CopyContext::TextureReadbackLayout layout;
+
+    const uint8_t* getRow(const uint8_t* pData, uint32_t y) const { return pData + offset + uint64_t(y) * layout.rowPitch; }
+};
+
+void writePfm(const std::filesystem::path& path, const uint8_t* pData, const PartLayout& part)
+{
+    const uint32_t channelCount = getFormatChannelCount(part.format);
+    const uint32_t bits = getUniformChannelBits(part.format);
+    const FormatType type = getFormatType(part.format);
+    const uint32_t outputChannelCount = channelCount == 1 ? 1 : 3;
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        FALCOR_THROW("Failed to open '{}' for writing.", path);
+
+    // Negative scale denotes little endian data. Rows are stored bottom-to-top.
+    file << (outputChannelCount == 1 ? "Pf" : "PF") << "\n" << part.width << " " << part.height << "\n-1.0\n";
+
+    std::vector<float> srcRow(size_t(part.width) * channelCount);
+    std::vector<float> dstRow(size_t(part.width) * outputChannelCount, 0.f);
+    for (uint32_t y = part.height; y-- > 0;)
+    {
+        const uint8_t* pRow = part.getRow(pData, y);
+        const float* pSrc = srcRow.data();
+        if (type == FormatType::Float && bits == 32 && channelCount == outputChannelCount)
+        {
+            pSrc = reinterpret_cast<const float*>(pRow);
+        }
+        else
+        {
+            convertRowToFloat(pRow, srcRow.data(), part.width * channelCount, type, bits);
+        }
+
+        if (channelCount == outputChannelCount)
+        {
+            file.write(reinterpret_cast<const char*>(pSrc), part.width * outputChannelCount * sizeof(float));
+            continue;
+        }
+        for (uint32_t x = 0; x < part.width; ++x)
+            for (uint32_t c = 0; c < std::min(channelCount, outputChannelCount); ++c)
+                dstRow[x * outputChannelCount + c] = pSrc[x * channelCount + c];
+        file.write(reinterpret_cast<const char*>(dstRow.data()), dstRow.size() * sizeof(float));
+    }
+
+    if (!file)
+        FALCOR_THROW("Failed to write '{}'.", path);
+}
+
+void writeNpy(const std::filesystem::path& path, const uint8_t* pData, const PartLayout& part)
+{
+    const uint32_t channelCount = getFormatChannelCount(part.format);
+    const char* descr = getNpyDescr(getFormatType(part.format), getUniformChannelBits(part.format));
+    FALCOR_ASSERT(descr);
+
+    std::string shape = channelCount == 1 ? fmt::format("({}, {})", part.height, part.width)
+                                          : fmt::format("({}, {}, {})", part.height, part.width, channelCount);
+    std::string header = fmt::format("{{'descr': '{}', 'fortran_order': False, 'shape': {}, }}", descr, shape);
+    // Version 1.0 header: magic (6), version (2), header length (2), header padded with spaces and a newline to a multiple of 64.
+    size_t totalSize = 10 + header.size() + 1;
+    header.append((64 - totalSize % 64) % 64, ' ');
+    header.push_back('\n');
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        FALCOR_THROW("Failed to open '{}' for writing.", path);
+    const uint16_t headerSize = uint16_t(header.size());
+    file.write("\x93NUMPY\x01\x00", 8);
+    file.put(char(headerSize & 0xff));
+    file.put(char(headerSize >> 8));
+    file.write(header.data(), header.size());
+
+    // Texel data is written straight from the readback buffer.
+    for (uint32_t y = 0; y < part.height; ++y)
+        file.write(reinterpret_cast<const char*>(part.getRow(pData, y)), part.layout.rowSize);
+
+    if (!file)
+        FALCOR_THROW("Failed to write '{}'.", path);
+}
+
+void writeExr(
+    const std::filesystem::path& path,
+    const uint8_t* pData,
+    const std::vector<PartLayout>& parts,
+    StreamingImageWriter::ExrCompression compression
+)
+{
+    static const char* kChannelNames[4][4] = {{"Y"}, {"R", "G"}, {"R", "G", "B"}, {"R", "G", "B", "A"}};
+
+    std::vector<Imf::Header> headers;
+    std::vector<Imf::FrameBuffer> frameBuffers;
+    // Storage for parts that need to be converted to float.
+    std::vector<std::vector<float>> convertedData;
+
+    for (const auto& part : parts)
+    {
+        const uint32_t channelCount = getFormatChannelCount(part.format);
+        const uint32_t bits = getUniformChannelBits(part.format);
+        const FormatType type = getFormatType(part.format);
+
+        Imf::Header header(int(part.width), int(part.height));
+        header.compression() = getImfCompression(compression);
+        if (parts.size() > 1)
+        {
+            header.setName(part.name);
+            header.setType(Imf::SCANLINEIMAGE);
+        }
+
+        // Half, float and uint data is referenced in place, everything else is converted to float.
+        Imf::PixelType pixelType = Imf::FLOAT;
+        const char* pBase = reinterpret_cast<const char*>(part.getRow(pData, 0));
+        size_t xStride = getFormatBytesPerBlock(part.format);
+        size_t yStride = part.layout.rowPitch;
+        if (type == FormatType::Float && bits == 16)
+        {
+            pixelType = Imf::HALF;
+        }
+        else if (type == FormatType::Uint && bits == 32)
+        {
+            pixelType = Imf::UINT;
+        }
+        else if (!(type == FormatType::Float && bits == 32))
+        {
+            auto& converted = convertedData.emplace_back(size_t(part.width) * part.height * channelCount);
+            for (uint32_t y = 0; y < part.height; ++y)
+                convertRowToFloat(
+                    part.getRow(pData, y), converted.data() + size_t(y) * part.width * channelCount, part.width * channelCount, type, bits
+                );
+            pBase = reinterpret_cast<const char*>(converted.data());
+            xStride = channelCount * sizeof(float);
+            yStride = xStride * part.width;
+        }
+
+        Imf::FrameBuffer frameBuffer;
+        const size_t channelSize = pixelType == Imf::HALF ? 2 : 4;
+        const uint32_t outputChannelCount = channelCount == 4 && !part.exportAlpha ? 3 : channelCount;
+        for (uint32_t c = 0; c < outputChannelCount; ++c)
+        {
+            const char* name = kChannelNames[channelCount - 1][c];
+            header.channels().insert(name, Imf::Channel(pixelType));
+            frameBuffer.insert(name, Imf::Slice(pixelType, const_cast<char*>(pBase + c * channelSize), xStride, yStride));
+        }
+        headers.push_back(std::move(header));
+        frameBuffers.push_back(std::move(frameBuffer));
+    }
+
+    const std::string pathStr = path.string();
+    if (parts.size() == 1)
+    {
+        Imf::OutputFile file(pathStr.c_str(), headers[0]);
+        file.setFrameBuffer(frameBuffers[0]);
+        file.writePixels(int(parts[0].height));
+    }
+    else
+    {
+        Imf::MultiPartOutputFile file(pathStr.c_str(), headers.data(), int(headers.size()));
+        for (size_t i = 0; i < parts.size(); ++i)
+        {
+            Imf::OutputPart outputPart(file, int(i));
+            outputPart.setFrameBuffer(frameBuffers[i]);
+            outputPart.writePixels(int(parts[i].height));
+        }
+    }
+}
+} // namespace
+
+StreamingImageWriter::StreamingImageWriter(ref<Device> pDevice, const Options& options)
+    : mpDevice(pDevice)
+    , mOptions(options)
+    , mEncoderPool(options.encoderThreadCount)
+{
+    FALCOR_CHECK(mOptions.stagingBufferCount > 0, "'stagingBufferCount' must be at least 1.");
+    mStagingBuffers.resize(mOptions.stagingBufferCount);
+    for (auto& stagingBuffer : mStagingBuffers)
+        stagingBuffer.pFence = mpDevice->createFence();
+}
+
+StreamingImageWriter::~StreamingImageWriter()
+{
+    flush();
+}
+
+std::optional<StreamingImageWriter::FileFormat> StreamingImageWriter::getFileFormatFromPath(const std::filesystem::path& path)
+{
+    if (hasExtension(path, "exr"))
+        return FileFormat::Exr;
+    if (hasExtension(path, "pfm"))
+        return FileFormat::Pfm;
+    if (hasExtension(path, "npy"))
+        return FileFormat::Npy;
+    return {};
+}
+
+bool StreamingImageWriter::isFormatSupported(ResourceFormat format, FileFormat fileFormat)
+{
+    const uint32_t bits = getUniformChannelBits(format);
+    if (bits == 0)
+        return false;
+    switch (fileFormat)
+    {
+    case FileFormat::Exr:
+    case FileFormat::Pfm:
+        return getFormatType(format) != FormatType::Unknown;
+    case FileFormat::Npy:
+        return getNpyDescr(getFormatType(format), bits) != nullptr;
+    }
+    return false;
+}
+
+void StreamingImageWriter::write(
+    RenderContext* pRenderContext,
+    const ref<Texture>& pTexture,
+    const std::filesystem::path& path,
+    uint32_t mipLevel,
+    uint32_t arraySlice
+)
+{
+    write(pRenderContext, Part{"", pTexture, mipLevel, arraySlice}, path);
+}
+
+void StreamingImageWriter::write(RenderContext* pRenderContext, const Part& part, const std::filesystem::path& path)
+{
+    auto fileFormat = getFileFormatFromPath(path);
+    if (!fileFormat)
+        FALCOR_THROW("Unsupported file extension for streaming image output '{}'.", path);
+    enqueue(pRenderContext, {part}, path, *fileFormat);
+}
+
+void StreamingImageWriter::writeMultiPart(RenderContext* pRenderContext, const std::vector<Part>& parts, const std::filesystem::path& path)
+{
+    FALCOR_CHECK(!parts.empty(), "Multi-part file '{}' has no parts.", path);
+    FALCOR_CHECK(getFileFormatFromPath(path) == FileFormat::Exr, "Multi-part files must be OpenEXR files ('{}').", path);
+    enqueue(pRenderContext, parts, path, FileFormat::Exr);
+}
+
+void StreamingImageWriter::enqueue(
+    RenderContext* pRenderContext,
+    const std::vector<Part>& parts,
+    const std::filesystem::path& path,
+    FileFormat fileFormat
+)
+{
+    // Lay out all parts in a single staging buffer.
+    std::vector<PartLayout> layouts;
+    uint64_t totalSize = 0;
+    uint64_t byteCount = 0;
+    for (const auto& part : parts)
+    {
+        const Texture* pTexture = part.pTexture.get();
+        FALCOR_CHECK(pTexture, "Missing texture for '{}'.", path);
+        FALCOR_CHECK(pTexture->getType() == Texture::Type::Texture2D, "Only 2D textures can be written to '{}'.", path);
+        FALCOR_CHECK(
+            isFormatSupported(pTexture->getFormat(), fileFormat),
+            "Format {} cannot be written to '{}'.",
+            to_string(pTexture->getFormat()),
+            path
+        );
+
+        PartLayout layout;
+        layout.name = part.name;
+        layout.format = pTexture->getFormat();
+        layout.width = pTexture->getWidth(part.mipLevel);
+        layout.height = pTexture->getHeight(part.mipLevel);
+        layout.offset = align_to(kPartAlignment, totalSize);
+        layout.exportAlpha = part.exportAlpha;
+        layout.layout = pRenderContext->getTextureReadbackLayout(pTexture, pTexture->getSubresourceIndex(part.arraySlice, part.mipLevel));
+        FALCOR_CHECK(
+            layouts.empty() || (layout.width == layouts[0].width && layout.height == layouts[0].height),
+            "All parts of '{}' must have the same resolution.",
+            path
+        );
+        totalSize = layout.offset + layout.layout.getTotalSize();
+        byteCount += uint64_t(layout.layout.rowSize) * layout.layout.rowCount;
+        layouts.push_back(std::move(layout));
+    }
+
+    uint32_t index = acquireStagingBuffer(totalSize);
+    StagingBuffer& stagingBuffer = mStagingBuffers[index];
+
+    // The buffer is marked busy until the encoder releases it, so return it if anything fails before the encoder is queued.
+    try
+    {
+        // Record the copies and signal the buffer's fence once they are done.
+        for (size_t i = 0; i < parts.size(); ++i)
+        {
+            const Texture* pTexture = parts[i].pTexture.get();
+            pRenderContext->copyTextureSubresourceToBuffer(
+                pTexture,
+                pTexture->getSubresourceIndex(parts[i].arraySlice, parts[i].mipLevel),
+                stagingBuffer.pBuffer.get(),
+                layouts[i].offset
+            );
+        }
+        pRenderContext->submit(false);
+        uint64_t fenceValue = pRenderContext->signal(stagingBuffer.pFence.get());
+
+        auto encode = [this, index, fenceValue, layouts = std::move(layouts), path, fileFormat, byteCount]()
+        {
+            const StagingBuffer& stagingBuffer = mStagingBuffers[index];
+            stagingBuffer.pFence->wait(fenceValue);
+
+            auto startTime = std::chrono::steady_clock::now();
+            bool success = true;
+            try
+            {
+                switch (fileFormat)
+                {
+                case FileFormat::Exr:
+                    writeExr(path, stagingBuffer.pData, layouts, mOptions.exrCompression);
+                    break;
+                case FileFormat::Pfm:
+                    writePfm(path, stagingBuffer.pData, layouts[0]);
+                    break;
+                case FileFormat::Npy:
+                    writeNpy(path, stagingBuffer.pData, layouts[0]);
+                    break;
+                }
+            }
+            catch (const std::exception& e)
+            {
+                logError("Failed to write image '{}': {}", path, e.what());
+                success = false;
+            }
+            double encodeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            releaseStagingBuffer(index, success, byteCount, encodeTime);
+        };
+        mEncoderPool.push_task(std::move(encode));
+    }
+    catch (...)
+    {
+        releaseStagingBuffer(index);
+        throw;
+    }
+}
+
+uint32_t StreamingImageWriter::acquireStagingBuffer(uint64_t size)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    auto startTime = std::chrono::steady_clock::now();
+    if (!mStartTime)
+        mStartTime = startTime;
+
+    // Back-pressure: wait until an encoder returns a buffer.
+    auto isFree = [](const StagingBuffer& stagingBuffer) { return !stagingBuffer.busy; };
+    mCondition.wait(lock, [&]() { return std::any_of(mStagingBuffers.begin(), mStagingBuffers.end(), isFree); });
+    mStats.stallTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    // Prefer a free buffer that is already large enough.
+    uint32_t index = uint32_t(-1);
+    for (uint32_t i = 0; i < mStagingBuffers.size(); ++i)
+    {
+        const auto& stagingBuffer = mStagingBuffers[i];
+        if (stagingBuffer.busy)
+            continue;
+        if (index == uint32_t(-1) || (stagingBuffer.pBuffer && stagingBuffer.pBuffer->getSize() >= size))
+            index = i;
+    }
+
+    StagingBuffer& stagingBuffer = mStagingBuffers[index];
+    stagingBuffer.busy = true;
+    lock.unlock();
+
+    if (!stagingBuffer.pBuffer || stagingBuffer.pBuffer->getSize() < size)
+    {
+        if (stagingBuffer.pBuffer)
+            stagingBuffer.pBuffer->unmap();
+        stagingBuffer.pBuffer = nullptr;
+        stagingBuffer.pData = nullptr;
+        try
+        {
+            stagingBuffer.pBuffer = mpDevice->createBuffer(size, ResourceBindFlags::None, MemoryType::ReadBack, nullptr);
+            // Readback buffers stay mapped for their whole lifetime.
+            stagingBuffer.pData = static_cast<const uint8_t*>(stagingBuffer.pBuffer->map());
+        }
+        catch (...)
+        {
+            stagingBuffer.pBuffer = nullptr;
+            releaseStagingBuffer(index);
+            throw;
+        }
+    }
+
+    return index;
+}
+
+void StreamingImageWriter::releaseStagingBuffer(uint32_t index, bool success, uint64_t byteCount, double encodeTime)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStagingBuffers[index].busy = false;
+        if (success)
+        {
+            mStats.fileCount++;
+            mStats.byteCount += byteCount;
+        }
+        else
+        {
+            mStats.failedCount++;
+        }
+        mStats.encodeTime += encodeTime;
+        if (mStartTime)
+            mStats.elapsedTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - *mStartTime).count();
+    }
+    mCondition.notify_all();
+}
+
+void StreamingImageWriter::releaseStagingBuffer(uint32_t index)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStagingBuffers[index].busy = false;
+    }
+    mCondition.notify_all();
+}
+
+void StreamingImageWriter::flush()
+{
+    mEncoderPool.wait_for_tasks();
+}
+
+StreamingImageWriter::Stats StreamingImageWriter::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
+
+void StreamingImageWriter::resetStats()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStats = {};
+    mStartTime.reset();
+}
+} // namespace Falcor
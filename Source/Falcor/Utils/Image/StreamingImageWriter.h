@@ -0,0 +1,192 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Object.h"
+#include "Core/API/Formats.h"
+#include "Core/API/Texture.h"
+#include "Core/API/Buffer.h"
+#include "Core/API/Fence.h"
+
+#include <BS_thread_pool/BS_thread_pool.hpp>
+
+#include <condition_variable>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+class RenderContext;
+
+/**
+ * Writes textures to image files without stalling the render thread.
+ *
+ * Each write records a copy of the texture into one of a ring of persistent readback buffers and returns immediately.
+ * Encoder threads wait for the copy to complete and encode directly from the mapped readback memory, so no intermediate
+ * copy of the image data is made. The number of readback buffers bounds the number of frames in flight; a write blocks
+ * only if all buffers are still waiting to be encoded.
+ *
+ * Supported file formats:
+ * - OpenEXR (.exr): half/float/uint channels, optionally multi-part, compressed in scanline blocks.
+ * - Portable float map (.pfm): 1 or 3 float channels.
+ * - NumPy array (.npy): raw texel data with shape (height, width[, channels]).
+ */
+class FALCOR_API StreamingImageWriter
+{
+public:
+    enum class FileFormat
+    {
+        Exr,
+        Pfm,
+        Npy,
+    };
+
+    /// OpenEXR compression, see Imf::Compression.
+    enum class ExrCompression
+    {
+        None, ///< Uncompressed.
+        Rle,  ///< Run length encoding.
+        Zips, ///< Zlib, one scanline per block.
+        Zip,  ///< Zlib, 16 scanlines per block.
+        Piz,  ///< Wavelet, 32 scanlines per block.
+    };
+
+    struct Options
+    {
+        /// Number of persistent readback buffers, i.e. the maximum number of frames in flight.
+        uint32_t stagingBufferCount = 4;
+        /// Number of encoder threads (0 = number of hardware threads).
+        uint32_t encoderThreadCount = 0;
+        /// Compression used for OpenEXR files.
+        ExrCompression exrCompression = ExrCompression::Zip;
+    };
+
+    /// A named texture subresource. The name is used for multi-part OpenEXR files.
+    struct Part
+    {
+        std::string name;
+        ref<Texture> pTexture;
+        uint32_t mipLevel = 0;
+        uint32_t arraySlice = 0;
+        bool exportAlpha = true; ///< Write the alpha channel of RGBA formats to OpenEXR files. PFM files never contain alpha.
+    };
+
+    struct Stats
+    {
+        uint64_t fileCount = 0;    ///< Number of files written.
+        uint64_t byteCount = 0;    ///< Number of texel bytes read back.
+        uint64_t failedCount = 0;  ///< Number of files that failed to encode.
+        double stallTime = 0.0;    ///< Time the caller spent waiting for a free readback buffer in seconds.
+        double encodeTime = 0.0;   ///< Accumulated encode time of all encoder threads in seconds.
+        double elapsedTime = 0.0;  ///< Time from the first write to the last completed file in seconds.
+
+        double getFilesPerSecond() const { return elapsedTime > 0.0 ? fileCount / elapsedTime : 0.0; }
+    };
+
+    StreamingImageWriter(ref<Device> pDevice) : StreamingImageWriter(pDevice, Options()) {}
+    StreamingImageWriter(ref<Device> pDevice, const Options& options);
+    ~StreamingImageWriter();
+
+    /**
+     * Get the file format from the extension of a path.
+     * @return The file format or an empty optional if the extension is not supported.
+     */
+    static std::optional<FileFormat> getFileFormatFromPath(const std::filesystem::path& path);
+
+    /**
+     * Check if a resource format can be written to the given file format.
+     */
+    static bool isFormatSupported(ResourceFormat format, FileFormat fileFormat);
+
+    /**
+     * Queue a texture subresource for writing. The file format is determined by the file extension.
+     * Blocks if all readback buffers are in use. Throws if the format is not supported.
+     */
+    void write(
+        RenderContext* pRenderContext,
+        const ref<Texture>& pTexture,
+        const std::filesystem::path& path,
+        uint32_t mipLevel = 0,
+        uint32_t arraySlice = 0
+    );
+
+    /**
+     * Queue a texture subresource for writing. The file format is determined by the file extension.
+     * Blocks if all readback buffers are in use. Throws if the format is not supported.
+     */
+    void write(RenderContext* pRenderContext, const Part& part, const std::filesystem::path& path);
+
+    /**
+     * Queue a multi-part OpenEXR file with one part per texture subresource. All parts must have the same resolution.
+     * Blocks if all readback buffers are in use. Throws if a format is not supported.
+     */
+    void writeMultiPart(RenderContext* pRenderContext, const std::vector<Part>& parts, const std::filesystem::path& path);
+
+    /**
+     * Block until all queued files have been written.
+     */
+    void flush();
+
+    Stats getStats() const;
+    void resetStats();
+
+    const Options& getOptions() const { return mOptions; }
+
+private:
+    struct StagingBuffer
+    {
+        ref<Buffer> pBuffer;
+        ref<Fence> pFence;
+        const uint8_t* pData = nullptr;
+        bool busy = false;
+    };
+
+    void enqueue(RenderContext* pRenderContext, const std::vector<Part>& parts, const std::filesystem::path& path, FileFormat fileFormat);
+    uint32_t acquireStagingBuffer(uint64_t size);
+    void releaseStagingBuffer(uint32_t index, bool success, uint64_t byteCount, double encodeTime);
+    /// Returns a staging buffer that was acquired but never handed to an encoder (e.g. because recording the copies failed).
+    void releaseStagingBuffer(uint32_t index);
+
+    ref<Device> mpDevice;
+    Options mOptions;
+
+    std::vector<StagingBuffer> mStagingBuffers;
+    mutable std::mutex mMutex;
+    std::condition_variable mCondition;
+
+    Stats mStats;
+    std::optional<std::chrono::steady_clock::time_point> mStartTime;
+
+    BS::thread_pool mEncoderPool;
+};
+} // namespace Falcor
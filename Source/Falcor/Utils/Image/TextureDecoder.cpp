@@ -0,0 +1,417 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TextureDecoder.h"
+#include "MipGenerator.h"
+#include "ImageIO.h"
+#include "Core/Error.h"
+#include "Core/API/Device.h"
+#include "Core/API/Fence.h"
+#include "Core/API/RenderContext.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+
+namespace Falcor
+{
+namespace
+{
+constexpr bool kTopDown = true; // Memory layout when loading from file
+
+double secondsSince(std::chrono::steady_clock::time_point startTime)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+std::unique_ptr<DecodedTexture> decodeSingle(const TextureDecoder::Request& request)
+{
+    const auto& path = request.paths[0];
+    if (!std::filesystem::exists(path))
+    {
+        logWarning("Error when loading image file. File '{}' does not exist.", path);
+        return nullptr;
+    }
+
+    auto pDecoded = std::make_unique<DecodedTexture>();
+    pDecoded->sourcePath = path;
+    pDecoded->importFlags = request.importFlags;
+
+    if (hasExtension(path, "dds"))
+    {
+        ImageIO::DDSImage image;
+        try
+        {
+            image = ImageIO::loadDDSImage(path, request.loadAsSRGB);
+        }
+        catch (const std::exception& e)
+        {
+            logWarning("Error loading '{}': {}", path, e.what());
+            return nullptr;
+        }
+
+        // TODO: Automatic mip generation
+        pDecoded->type = image.type;
+        pDecoded->format = image.format;
+        pDecoded->width = image.width;
+        pDecoded->height = image.height;
+        pDecoded->depth = image.depth;
+        pDecoded->arraySize = image.arraySize;
+        pDecoded->mipLevels = image.mipLevels;
+        pDecoded->data = std::move(image.data);
+    }
+    else
+    {
+        pDecoded->pBitmap = Bitmap::createFromFile(path, kTopDown, request.importFlags);
+        if (!pDecoded->pBitmap)
+            return nullptr;
+
+        ResourceFormat format = pDecoded->pBitmap->getFormat();
+        pDecoded->format = request.loadAsSRGB ? linearToSrgbFormat(format) : format;
+        pDecoded->width = pDecoded->pBitmap->getWidth();
+        pDecoded->height = pDecoded->pBitmap->getHeight();
+        pDecoded->mipLevels = request.generateMipLevels ? Texture::kMaxPossible : 1;
+
+        // Generate mips on the worker thread where possible, which filters sRGB data and normal maps correctly.
+        // Otherwise they are generated after upload by Texture::generateMips().
+        if (request.generateMipLevels && MipGenerator::isFormatSupported(format))
+        {
+            const uint8_t* pData = pDecoded->pBitmap->getData();
+            MipGenerator::Options mipOptions;
+            mipOptions.srgb = request.loadAsSRGB;
+            mipOptions.normalMap = !request.loadAsSRGB && is_set(request.importFlags, Bitmap::ImportFlags::NormalMap);
+            mipOptions.threadCount = 1; // Textures are decoded in parallel.
+            pDecoded->data = MipGenerator::generate(pData, pDecoded->width, pDecoded->height, format, mipOptions);
+            pDecoded->mipLevels = MipGenerator::getMipCount(pDecoded->width, pDecoded->height);
+            pDecoded->pBitmap.reset();
+        }
+    }
+
+    return pDecoded;
+}
+
+std::unique_ptr<DecodedTexture> decodeMipped(const TextureDecoder::Request& request)
+{
+    std::vector<Bitmap::UniqueConstPtr> mips;
+    mips.reserve(request.paths.size());
+    size_t combinedSize = 0;
+
+    for (const auto& path : request.paths)
+    {
+        Bitmap::UniqueConstPtr pBitmap;
+        if (hasExtension(path, "dds"))
+        {
+            pBitmap = ImageIO::loadBitmapFromDDS(path);
+        }
+        else
+        {
+            pBitmap = Bitmap::createFromFile(path, kTopDown, request.importFlags);
+        }
+        if (!pBitmap)
+        {
+            logWarning("Error loading mip {}. Loading failed for image file '{}'.", mips.size(), path);
+            break;
+        }
+
+        if (!mips.empty())
+        {
+            if (mips.back()->getFormat() != pBitmap->getFormat())
+            {
+                logWarning("Error loading mip {} from file {}. Texture format of all mip levels must match.", mips.size(), path);
+                break;
+            }
+            if (std::max(mips.back()->getWidth() / 2, 1u) != pBitmap->getWidth() ||
+                std::max(mips.back()->getHeight() / 2, 1u) != pBitmap->getHeight())
+            {
+                logWarning(
+                    "Error loading mip {} from file {}. Image resolution must decrease by half. ({}, {}) != ({}, {})/2",
+                    mips.size(),
+                    path,
+                    pBitmap->getWidth(),
+                    pBitmap->getHeight(),
+                    mips.back()->getWidth(),
+                    mips.back()->getHeight()
+                );
+                break;
+            }
+        }
+        combinedSize += pBitmap->getSize();
+        mips.emplace_back(std::move(pBitmap));
+    }
+
+    if (mips.empty())
+        return nullptr;
+
+    auto pDecoded = std::make_unique<DecodedTexture>();
+    pDecoded->sourcePath = request.paths[0];
+    pDecoded->importFlags = request.importFlags;
+    pDecoded->format = request.loadAsSRGB ? linearToSrgbFormat(mips[0]->getFormat()) : mips[0]->getFormat();
+    pDecoded->width = mips[0]->getWidth();
+    pDecoded->height = mips[0]->getHeight();
+    pDecoded->mipLevels = (uint32_t)mips.size();
+
+    // Combine all the mip data into a single buffer.
+    pDecoded->data.resize(combinedSize);
+    size_t copyDst = 0;
+    for (auto& mip : mips)
+    {
+        std::memcpy(pDecoded->data.data() + copyDst, mip->getData(), mip->getSize());
+        copyDst += mip->getSize();
+    }
+
+    return pDecoded;
+}
+} // namespace
+
+TextureDecoder::TextureDecoder(const Options& options) : mOptions(options) {}
+
+std::unique_ptr<DecodedTexture> TextureDecoder::decode(const Request& request)
+{
+    return request.paths.size() == 1 ? decodeSingle(request) : decodeMipped(request);
+}
+
+void TextureDecoder::decodeAll(fstd::span<const Request> requests, const Consumer& consumer)
+{
+    if (requests.empty())
+        return;
+
+    const auto startTime = std::chrono::steady_clock::now();
+    const size_t requestCount = requests.size();
+    size_t threadCount = mOptions.threadCount > 0 ? mOptions.threadCount : std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min(threadCount, requestCount);
+
+    struct Slot
+    {
+        std::unique_ptr<DecodedTexture> pDecoded;
+        size_t size = 0;
+        bool ready = false;
+    };
+
+    std::vector<Slot> slots(requestCount);
+    std::mutex mutex;
+    std::condition_variable workerCondition;   ///< Signaled when decoded data has been consumed.
+    std::condition_variable consumerCondition; ///< Signaled when a slot becomes ready.
+
+    // Shared state. Do not access outside of critical section.
+    size_t nextRequest = 0; ///< Index of the next request to decode.
+    size_t nextConsume = 0; ///< Index of the next request to hand to the consumer.
+    uint64_t bytesInFlight = 0;
+    bool cancel = false;
+    Stats stats;
+
+    auto runWorker = [&]()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            // Wait for the byte budget. The request the consumer is waiting on is always admitted, which guarantees
+            // progress: everything decoded ahead of it is released as soon as it completes.
+            const auto waitStartTime = std::chrono::steady_clock::now();
+            workerCondition.wait(
+                lock,
+                [&]()
+                {
+                    return cancel || nextRequest == requestCount || nextRequest == nextConsume ||
+                           bytesInFlight < mOptions.maxBytesInFlight;
+                }
+            );
+            stats.throttleTime += secondsSince(waitStartTime);
+
+            if (cancel || nextRequest == requestCount)
+                break;
+
+            const size_t index = nextRequest++;
+            lock.unlock();
+
+            const auto decodeStartTime = std::chrono::steady_clock::now();
+            std::unique_ptr<DecodedTexture> pDecoded;
+            try
+            {
+                pDecoded = decode(requests[index]);
+            }
+            catch (const std::exception& e)
+            {
+                logWarning("Error decoding texture {}: {}", index, e.what());
+            }
+            const double decodeTime = secondsSince(decodeStartTime);
+
+            lock.lock();
+            auto& slot = slots[index];
+            slot.size = pDecoded ? pDecoded->getSize() : 0;
+            slot.pDecoded = std::move(pDecoded);
+            slot.ready = true;
+            bytesInFlight += slot.size;
+            stats.peakBytesInFlight = std::max(stats.peakBytesInFlight, bytesInFlight);
+            stats.decodeTime += decodeTime;
+            stats.decodedBytes += slot.size;
+            if (slot.pDecoded)
+                stats.decodedCount++;
+            else
+                stats.failedCount++;
+            if (index == nextConsume)
+                consumerCondition.notify_one();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+        threads.emplace_back(runWorker);
+
+    auto joinWorkers = [&]()
+    {
+        for (auto& thread : threads)
+            thread.join();
+    };
+
+    try
+    {
+        for (size_t i = 0; i < requestCount; ++i)
+        {
+            std::unique_ptr<DecodedTexture> pDecoded;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                const auto waitStartTime = std::chrono::steady_clock::now();
+                consumerCondition.wait(lock, [&]() { return slots[i].ready; });
+                stats.consumeWaitTime += secondsSince(waitStartTime);
+
+                pDecoded = std::move(slots[i].pDecoded);
+                bytesInFlight -= slots[i].size;
+                nextConsume = i + 1;
+            }
+            workerCondition.notify_all();
+
+            consumer(i, std::move(pDecoded));
+        }
+    }
+    catch (...)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cancel = true;
+        }
+        workerCondition.notify_all();
+        joinWorkers();
+        throw;
+    }
+
+    joinWorkers();
+
+    mStats.decodedCount += stats.decodedCount;
+    mStats.failedCount += stats.failedCount;
+    mStats.decodedBytes += stats.decodedBytes;
+    mStats.peakBytesInFlight = std::max(mStats.peakBytesInFlight, stats.peakBytesInFlight);
+    mStats.decodeTime += stats.decodeTime;
+    mStats.throttleTime += stats.throttleTime;
+    mStats.consumeWaitTime += stats.consumeWaitTime;
+    mStats.elapsedTime += secondsSince(startTime);
+}
+
+TextureUploader::TextureUploader(ref<Device> pDevice, const Options& options) : mpDevice(pDevice), mOptions(options)
+{
+    FALCOR_CHECK(mOptions.batchSize > 0, "'batchSize' must be greater than zero.");
+    FALCOR_CHECK(mOptions.ringSize > 0, "'ringSize' must be greater than zero.");
+}
+
+ref<Texture> TextureUploader::upload(const DecodedTexture& decoded, ResourceBindFlags bindFlags)
+{
+    const uint8_t* pData = decoded.getData();
+
+    ref<Texture> pTex;
+    switch (decoded.type)
+    {
+    case Resource::Type::Texture1D:
+        pTex = mpDevice->createTexture1D(decoded.width, decoded.format, decoded.arraySize, decoded.mipLevels, pData, bindFlags);
+        break;
+    case Resource::Type::Texture2D:
+        pTex = mpDevice->createTexture2D(
+            decoded.width, decoded.height, decoded.format, decoded.arraySize, decoded.mipLevels, pData, bindFlags
+        );
+        break;
+    case Resource::Type::TextureCube:
+        pTex = mpDevice->createTextureCube(
+            decoded.width, decoded.height, decoded.format, decoded.arraySize / 6, decoded.mipLevels, pData, bindFlags
+        );
+        break;
+    case Resource::Type::Texture3D:
+        pTex = mpDevice->createTexture3D(
+            decoded.width, decoded.height, decoded.depth, decoded.format, decoded.mipLevels, pData, bindFlags
+        );
+        break;
+    default:
+        logWarning("Failed to upload texture '{}': Unsupported texture type {}.", decoded.sourcePath, to_string(decoded.type));
+        return nullptr;
+    }
+
+    if (pTex == nullptr)
+        return nullptr;
+
+    pTex->setSourcePath(decoded.sourcePath);
+    pTex->setImportFlags(decoded.importFlags);
+
+    mStats.textureCount++;
+    mStats.uploadedBytes += decoded.getSize();
+    mBatchBytes += decoded.getSize();
+    if (mBatchBytes >= mOptions.batchSize)
+        submitBatch();
+
+    return pTex;
+}
+
+void TextureUploader::flush()
+{
+    if (mBatchBytes > 0)
+        submitBatch();
+
+    const auto startTime = std::chrono::steady_clock::now();
+    mpDevice->wait();
+    mBatchFences.clear();
+    mStats.stallTime += secondsSince(startTime);
+}
+
+void TextureUploader::submitBatch()
+{
+    RenderContext* pRenderContext = mpDevice->getRenderContext();
+    const ref<Fence>& pFence = pRenderContext->getLowLevelData()->getFence();
+
+    // Make room in the ring by waiting for the oldest batch.
+    if (mBatchFences.size() >= mOptions.ringSize)
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+        pFence->wait(mBatchFences.front());
+        mBatchFences.pop_front();
+        mStats.stallTime += secondsSince(startTime);
+    }
+
+    pRenderContext->submit(false);
+    mBatchFences.push_back(pFence->getSignaledValue());
+    mBatchBytes = 0;
+    mStats.batchCount++;
+}
+} // namespace Falcor
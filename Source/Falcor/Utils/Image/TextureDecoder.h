@@ -0,0 +1,193 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Bitmap.h"
+#include "Core/Macros.h"
+#include "Core/API/fwd.h"
+#include "Core/API/Resource.h"
+#include "Core/API/Texture.h"
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <fstd/span.h>
+
+namespace Falcor
+{
+/**
+ * CPU-side image data of a texture, decoded from one or more files and ready for upload.
+ * Subresource data is tightly packed in the order expected by Device::createTexture*().
+ */
+struct FALCOR_API DecodedTexture
+{
+    Resource::Type type = Resource::Type::Texture2D;
+    ResourceFormat format = ResourceFormat::Unknown;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t depth = 1;
+    uint32_t arraySize = 1;
+    uint32_t mipLevels = 1;      ///< Number of mip levels stored in the data, or Texture::kMaxPossible to generate mips after upload.
+    Bitmap::ImportFlags importFlags = Bitmap::ImportFlags::None;
+    std::filesystem::path sourcePath; ///< Path of the file the texture was decoded from (mip0 for mipped textures).
+
+    Bitmap::UniqueConstPtr pBitmap; ///< Decoded bitmap (single file images). Avoids copying the pixels out of the bitmap.
+    std::vector<uint8_t> data;      ///< Decoded data (DDS images and textures with mips from individual files).
+
+    const uint8_t* getData() const { return pBitmap ? pBitmap->getData() : data.data(); }
+    size_t getSize() const { return pBitmap ? pBitmap->getSize() : data.size(); }
+};
+
+/**
+ * Decodes texture files on a bounded pool of worker threads.
+ *
+ * Decoding (Bitmap::createFromFile(), DDS parsing) does not touch the GPU and scales with the number of cores.
+ * To bound peak memory when decoding thousands of files, workers stop picking up new files while the decoded
+ * data that has not yet been handed to the consumer exceeds a byte budget. Decoded textures are always handed
+ * to the consumer on the calling thread and in request order, so that results are deterministic regardless of
+ * the thread count.
+ */
+class FALCOR_API TextureDecoder
+{
+public:
+    struct Options
+    {
+        /// Number of worker threads. Zero uses the hardware concurrency.
+        size_t threadCount = 0;
+        /// Budget for decoded data not yet consumed. The next texture in request order is always admitted,
+        /// so the budget may be exceeded by up to one decoded texture per worker thread.
+        size_t maxBytesInFlight = size_t(1) << 30;
+    };
+
+    struct Request
+    {
+        std::vector<std::filesystem::path> paths; ///< Full path of the texture, or paths of all mips starting from mip0.
+        bool generateMipLevels = false;           ///< Request the full mip chain (single file only). See MipGenerator.
+        bool loadAsSRGB = false;                  ///< Use the sRGB variant of the format if available.
+        Bitmap::ImportFlags importFlags = Bitmap::ImportFlags::None;
+    };
+
+    struct Stats
+    {
+        size_t decodedCount = 0;       ///< Number of textures decoded successfully.
+        size_t failedCount = 0;        ///< Number of textures that failed to decode.
+        uint64_t decodedBytes = 0;     ///< Total size of decoded data.
+        uint64_t peakBytesInFlight = 0; ///< Peak size of decoded data waiting to be consumed.
+        double decodeTime = 0.0;       ///< Accumulated decode time over all workers in seconds.
+        double throttleTime = 0.0;     ///< Accumulated time workers waited for the byte budget in seconds.
+        double consumeWaitTime = 0.0;  ///< Time the calling thread waited for decoded data in seconds.
+        double elapsedTime = 0.0;      ///< Wall clock time of decodeAll() in seconds.
+    };
+
+    /**
+     * Function called for each request. The decoded texture is nullptr if decoding failed.
+     */
+    using Consumer = std::function<void(size_t index, std::unique_ptr<DecodedTexture> pDecoded)>;
+
+    TextureDecoder() : TextureDecoder(Options()) {}
+    TextureDecoder(const Options& options);
+
+    /**
+     * Decode a single texture on the calling thread.
+     * If more than one path is given, the files are loaded as mip levels. All mips must have the same format and halve in size.
+     * @param[in] request Decode request.
+     * @return Decoded texture, or nullptr if decoding failed (a warning is logged).
+     */
+    static std::unique_ptr<DecodedTexture> decode(const Request& request);
+
+    /**
+     * Decode a list of textures in parallel.
+     * Blocks until all requests have been consumed. The consumer is called on the calling thread in request order.
+     * If the consumer throws, outstanding work is cancelled and the exception is rethrown.
+     * @param[in] requests Decode requests.
+     * @param[in] consumer Function called for each request in order.
+     */
+    void decodeAll(fstd::span<const Request> requests, const Consumer& consumer);
+
+    /// Get statistics accumulated over all decodeAll() calls.
+    const Stats& getStats() const { return mStats; }
+
+    /// Reset statistics.
+    void resetStats() { mStats = {}; }
+
+private:
+    Options mOptions;
+    Stats mStats;
+};
+
+/**
+ * Creates textures from decoded data on the calling thread, throttling uploads through a ring of in-flight batches.
+ *
+ * Texture data is staged and copied on the render context. Once the staged bytes of the current batch exceed
+ * the batch size, the batch is submitted without waiting. The CPU only waits when the ring of in-flight batches
+ * is full, and then only for the oldest batch, which bounds staging memory to roughly ringSize * batchSize.
+ */
+class FALCOR_API TextureUploader
+{
+public:
+    struct Options
+    {
+        size_t batchSize = size_t(64) << 20; ///< Staged bytes per submitted batch.
+        size_t ringSize = 4;                 ///< Maximum number of batches in flight.
+    };
+
+    struct Stats
+    {
+        size_t textureCount = 0;  ///< Number of textures created.
+        uint64_t uploadedBytes = 0; ///< Total size of uploaded data.
+        size_t batchCount = 0;    ///< Number of submitted batches.
+        double stallTime = 0.0;   ///< Time spent waiting for in-flight batches in seconds.
+    };
+
+    TextureUploader(ref<Device> pDevice) : TextureUploader(pDevice, Options()) {}
+    TextureUploader(ref<Device> pDevice, const Options& options);
+
+    /**
+     * Create a texture and upload the decoded data.
+     * @param[in] decoded Decoded texture.
+     * @param[in] bindFlags The bind flags for the texture resource.
+     * @return The new texture, or nullptr if the texture type is not supported.
+     */
+    ref<Texture> upload(const DecodedTexture& decoded, ResourceBindFlags bindFlags = ResourceBindFlags::ShaderResource);
+
+    /// Submit the current batch and wait for all batches in flight.
+    void flush();
+
+    const Stats& getStats() const { return mStats; }
+
+private:
+    void submitBatch();
+
+    ref<Device> mpDevice;
+    Options mOptions;
+    Stats mStats;
+    size_t mBatchBytes = 0;             ///< Bytes staged in the current batch.
+    std::deque<uint64_t> mBatchFences;  ///< Fence values of batches in flight, oldest first.
+};
+} // namespace Falcor
@@ -26,12 +26,10 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "TextureManager.h"
+#include "ImageBufferPool.h"
 #include "Core/AssetResolver.h"
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
-#include "Utils/NumericRange.h"
-
-#include <execution>
 
 // Temporarily disable asynchronous texture loader until Falcor supports parallel GPU work submission.
 // Until then `TextureManager` should only called from the main thread.
@@ -46,7 +44,10 @@ static_assert(TextureManager::CpuTextureHandle::kInvalidID >= kMaxTextureHandleC
 } // namespace
 
 TextureManager::TextureManager(ref<Device> pDevice, size_t maxTextureCount, size_t threadCount)
-    : mpDevice(pDevice), mAsyncTextureLoader(pDevice, threadCount), mMaxTextureCount(std::min(maxTextureCount, kMaxTextureHandleCount))
+    : mpDevice(pDevice)
+    , mAsyncTextureLoader(pDevice, threadCount)
+    , mDecodeThreadCount(threadCount)
+    , mMaxTextureCount(std::min(maxTextureCount, kMaxTextureHandleCount))
 {}
 
 TextureManager::~TextureManager() {}
@@ -299,6 +300,10 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
         {
             std::unique_lock<std::mutex> lock(mMutex);
 
+            // Report the original file as the source also if the texture was loaded from the baked texture cache.
+            if (pTexture)
+                pTexture->setSourcePath(paths[0]);
+
             // Mark texture as loaded.
             auto& desc = getDesc(handle);
             desc.state = TextureState::Loaded;
@@ -313,25 +318,29 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
         };
 
         // Issue load request to texture loader.
-        if (paths.size() > 1)
+        const auto loadPaths = getLoadPaths(textureKey);
+        if (loadPaths.size() > 1)
         {
-            mAsyncTextureLoader.loadMippedFromFiles(paths, loadAsSRGB, bindFlags, importFlags, callback);
+            mAsyncTextureLoader.loadMippedFromFiles(loadPaths, loadAsSRGB, bindFlags, importFlags, callback);
         }
         else
         {
-            mAsyncTextureLoader.loadFromFile(paths[0], generateMipLevels, loadAsSRGB, bindFlags, importFlags, callback);
+            mAsyncTextureLoader.loadFromFile(loadPaths[0], generateMipLevels, loadAsSRGB, bindFlags, importFlags, callback);
         }
 #else
         // Load texture from main thread.
         ref<Texture> pTexture;
-        if (paths.size() > 1)
+        const auto loadPaths = getLoadPaths(textureKey);
+        if (loadPaths.size() > 1)
         {
-            pTexture = Texture::createMippedFromFiles(mpDevice, paths, loadAsSRGB, bindFlags, importFlags);
+            pTexture = Texture::createMippedFromFiles(mpDevice, loadPaths, loadAsSRGB, bindFlags, importFlags);
         }
         else
         {
-            pTexture = Texture::createFromFile(mpDevice, paths[0], generateMipLevels, loadAsSRGB, bindFlags, importFlags);
+            pTexture = Texture::createFromFile(mpDevice, loadPaths[0], generateMipLevels, loadAsSRGB, bindFlags, importFlags);
         }
+        if (pTexture)
+            pTexture->setSourcePath(paths[0]);
 
         // Add new texture desc.
         TextureDesc desc = {TextureState::Loaded, pTexture};
@@ -407,47 +416,68 @@ void TextureManager::endDeferredLoading()
     if (jobs.empty())
         return;
 
-    // Load textures in parallel.
-    std::atomic<size_t> texturesLoaded;
-    NumericRange<size_t> jobRange(0, jobs.size());
-    std::for_each(
-        std::execution::par_unseq,
-        jobRange.begin(),
-        jobRange.end(),
-        [&](size_t i)
+    // Decode textures on worker threads and create them on this thread in job order. Decoding is throttled by the
+    // decoded bytes waiting for upload, and uploads are submitted in batches through a ring of in-flight batches.
+    // This bounds both CPU and staging memory without stalling the GPU at fixed intervals.
+    std::vector<TextureDecoder::Request> requests;
+    requests.reserve(jobs.size());
+    for (const auto& job : jobs)
+    {
+        requests.push_back(
+            TextureDecoder::Request{getLoadPaths(job.key), job.key.generateMipLevels, job.key.loadAsSRGB, job.key.importFlags}
+        );
+    }
+
+    TextureDecoder::Options decoderOptions;
+    decoderOptions.threadCount = mDecodeThreadCount;
+    TextureDecoder decoder(decoderOptions);
+    TextureUploader uploader(mpDevice);
+
+    decoder.decodeAll(
+        requests,
+        [&](size_t index, std::unique_ptr<DecodedTexture> pDecoded)
         {
-            const auto& job = jobs[i];
+            const auto& job = jobs[index];
+            if (!pDecoded)
+                return;
+
+            // Report the original file as the source also if the texture was loaded from the baked texture cache.
+            pDecoded->sourcePath = job.key.fullPaths[0];
+
             auto& desc = getDesc(job.handle);
-            if (job.key.fullPaths.size() == 1)
-            {
-                desc.pTexture = Texture::createFromFile(
-                    mpDevice, job.key.fullPaths[0], job.key.generateMipLevels, job.key.loadAsSRGB, job.key.bindFlags, job.key.importFlags
-                );
-                logDebug("Loading texture from '{}'", job.key.fullPaths[0]);
-            }
-            else
-            {
-                desc.pTexture =
-                    Texture::createMippedFromFiles(mpDevice, job.key.fullPaths, job.key.loadAsSRGB, job.key.bindFlags, job.key.importFlags);
-                logDebug("Loading mipped texture from '{}'", job.key.fullPaths[0]);
-            }
-            if (texturesLoaded.fetch_add(1) % 10 == 9)
-            {
-                logDebug("Flush");
-                std::lock_guard<std::mutex> lock(mpDevice->getGlobalGfxMutex());
-                mpDevice->wait();
-            }
+            desc.pTexture = uploader.upload(*pDecoded, job.key.bindFlags);
+            logDebug("Loaded texture from '{}'", job.key.fullPaths[0]);
         }
     );
-    mpDevice->wait();
+    uploader.flush();
+
+    const auto& decodeStats = decoder.getStats();
+    const auto& uploadStats = uploader.getStats();
+    logDebug(
+        "Loaded {} textures ({} failed) in {:.2f} s. Decode: {:.2f} s on {} threads, peak {:.1f} MB in flight. Upload: {:.1f} MB in {} "
+        "batches, stalled {:.2f} s.",
+        uploadStats.textureCount,
+        jobs.size() - uploadStats.textureCount,
+        decodeStats.elapsedTime,
+        decodeStats.decodeTime,
+        mDecodeThreadCount,
+        decodeStats.peakBytesInFlight / double(1 << 20),
+        uploadStats.uploadedBytes / double(1 << 20),
+        uploadStats.batchCount,
+        uploadStats.stallTime
+    );
 
     // Mark loaded textures and add them to lookup table.
     for (const auto& job : jobs)
     {
         auto& desc = getDesc(job.handle);
         desc.state = desc.pTexture ? TextureState::Loaded : TextureState::Invalid;
-        mTextureToHandle[desc.pTexture.get()] = job.handle;
+        if (desc.pTexture)
+            mTextureToHandle[desc.pTexture.get()] = job.handle;
     }
+
+    // Return the cached decode buffers to the OS, the next batch of deferred loads is typically much later.
+    ImageBufferPool::getGlobal().trim();
 }
 
 void TextureManager::removeTexture(const CpuTextureHandle& handle)
@@ -463,6 +493,36 @@ void TextureManager::removeTexture(const CpuTextureHandle& handle)
     removeTextureInternal(handle);
 }
 
+bool TextureManager::removeTexture(const ref<Texture>& pTexture)
+{
+    if (!pTexture)
+        return false;
+
+    waitForAllTexturesLoading();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mTextureToHandle.find(pTexture.get());
+    if (it == mTextureToHandle.end())
+        return false;
+    const CpuTextureHandle handle = it->second;
+
+    // Release the texture from all objects that loaded it.
+    if (auto objects = mHandleToObjects.find(handle); objects != mHandleToObjects.end())
+    {
+        for (const Object* object : objects->second)
+        {
+            auto handles = mObjectToHandles.find(object);
+            FALCOR_ASSERT(handles != mObjectToHandles.end());
+            handles->second.erase(handle);
+            if (handles->second.empty())
+                mObjectToHandles.erase(handles);
+        }
+    }
+
+    removeTextureInternal(handle);
+    return true;
+}
+
 void TextureManager::removeTextureInternal(const CpuTextureHandle& handle)
 {
     if (handle.isUdim())
@@ -645,6 +705,23 @@ TextureManager::Stats TextureManager::getStats() const
     return s;
 }
 
+std::vector<std::filesystem::path> TextureManager::getLoadPaths(const TextureKey& key) const
+{
+    // Baked textures have a full mip chain, so only use them for single file textures that request mips.
+    if (mpBakedTextureCache && key.fullPaths.size() == 1 && key.generateMipLevels == mpBakedTextureCache->getOptions().generateMips)
+    {
+        auto variant = is_set(key.importFlags, Bitmap::ImportFlags::NormalMap) ? BakedTextureCache::Variant::NormalMap
+                       : key.loadAsSRGB                                       ? BakedTextureCache::Variant::Srgb
+                                                                              : BakedTextureCache::Variant::Linear;
+        if (auto bakedPath = mpBakedTextureCache->lookup(key.fullPaths[0], variant); !bakedPath.empty())
+        {
+            logDebug("Loading texture '{}' from baked texture cache '{}'.", key.fullPaths[0], bakedPath);
+            return {bakedPath};
+        }
+    }
+    return key.fullPaths;
+}
+
 TextureManager::CpuTextureHandle TextureManager::addDesc(const TextureDesc& desc)
 {
     CpuTextureHandle handle;
@@ -27,6 +27,8 @@
  **************************************************************************/
 #pragma once
 #include "AsyncTextureLoader.h"
+#include "BakedTextureCache.h"
+#include "TextureDecoder.h"
 #include "Core/Macros.h"
 #include "Core/API/fwd.h"
 #include "Core/API/Resource.h"
@@ -142,12 +144,22 @@ public:
      * Constructor.
      * @param[in] pDevice GPU device.
      * @param[in] maxTextureCount Maximum number of textures that can be simultaneously managed.
-     * @param[in] threadCount Number of worker threads.
+     * @param[in] threadCount Number of worker threads used for loading and decoding textures.
      */
     TextureManager(ref<Device> pDevice, size_t maxTextureCount, size_t threadCount = std::thread::hardware_concurrency());
 
     ~TextureManager();
 
+    /**
+     * Set a cache of baked textures to consult before loading source textures from disk.
+     * Textures found in the cache are loaded from their block compressed DDS version instead of the original file.
+     * @param[in] pCache Baked texture cache, or nullptr to always load the original files.
+     */
+    void setBakedTextureCache(std::unique_ptr<BakedTextureCache> pCache) { mpBakedTextureCache = std::move(pCache); }
+
+    /// Get the baked texture cache, or nullptr if not set.
+    BakedTextureCache* getBakedTextureCache() const { return mpBakedTextureCache.get(); }
+
     /**
      * Add a texture to the manager.
      * If the texture is already managed, its existing handle is returned.
@@ -203,6 +215,12 @@ public:
      * from the main thread when it is guaranteed to not be interleaved with any other thread.
      */
     void beginDeferredLoading();
+
+    /**
+     * Loads all textures queued up since beginDeferredLoading().
+     * Files are decoded on worker threads, throttled by the amount of decoded data in flight. Textures are created
+     * and uploaded on the calling thread in a deterministic order, in batches throttled by the upload ring.
+     */
     void endDeferredLoading();
 
     /**
@@ -211,6 +229,15 @@ public:
      */
     void removeTexture(const CpuTextureHandle& handle);
 
+    /**
+     * Remove a texture given its resource.
+     * Unlike removeTexture(const CpuTextureHandle&), the texture is removed even if it was loaded on behalf of objects.
+     * This is used to release textures that their owners no longer reference, for example after material optimization.
+     * @param[in] pTexture Texture resource.
+     * @return True if the texture was managed and has been removed.
+     */
+    bool removeTexture(const ref<Texture>& pTexture);
+
     /**
      * Remove all textures loaded by the given object.
      * @param[in] object The object for which to remove textures.
@@ -339,6 +366,8 @@ private:
         }
     };
 
+    std::vector<std::filesystem::path> getLoadPaths(const TextureKey& key) const;
+
     CpuTextureHandle addDesc(const TextureDesc& desc);
     TextureDesc& getDesc(const CpuTextureHandle& handle);
     void registerOwner(const CpuTextureHandle& handle, const Object* owner);
@@ -371,6 +400,8 @@ private:
     bool mUseDeferredLoading = false;
 
     AsyncTextureLoader mAsyncTextureLoader; ///< Utility for asynchronous texture loading.
+    size_t mDecodeThreadCount;              ///< Number of worker threads for decoding deferred textures.
+    std::unique_ptr<BakedTextureCache> mpBakedTextureCache; ///< Optional cache of baked textures.
     size_t mLoadRequestsInProgress = 0;     ///< Number of load requests currently in progress.
 
     const size_t mMaxTextureCount; ///< Maximum number of textures that can be simultaneously managed.
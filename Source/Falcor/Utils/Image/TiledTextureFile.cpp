@@ -0,0 +1,210 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TiledTextureFile.h"
+#include "Core/Error.h"
+#include "Utils/StringFormatters.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+const char kMagic[4] = {'F', 'T', 'T', 'F'};
+
+/**
+ * Specifies the current file version.
+ * This needs to be incremented every time the file layout changes!
+ */
+const uint32_t kVersion = 1;
+
+/// Tile data starts at this offset.
+const size_t kDataOffset = 64;
+
+struct Header
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t mipCount;
+    uint32_t tileSize;
+    uint32_t borderSize;
+};
+static_assert(sizeof(Header) <= kDataOffset);
+
+uint32_t computeTileCount(uint32_t size, uint32_t mip, uint32_t tileSize)
+{
+    const uint32_t mipSize = std::max(1u, size >> mip);
+    return (mipSize + tileSize - 1) / tileSize;
+}
+
+void validateDesc(const TiledTextureFile::Desc& desc)
+{
+    FALCOR_CHECK(desc.format != ResourceFormat::Unknown && !isCompressedFormat(desc.format), "Format must be uncompressed.");
+    FALCOR_CHECK(desc.width > 0 && desc.height > 0, "Texture dimensions must be non-zero.");
+    FALCOR_CHECK(desc.tileSize > 0, "Tile size must be non-zero.");
+    FALCOR_CHECK(desc.borderSize <= desc.tileSize, "Border size must not exceed the tile size.");
+    uint32_t maxMipCount = 1;
+    for (uint32_t size = std::max(desc.width, desc.height); size > 1; size /= 2)
+        ++maxMipCount;
+    FALCOR_CHECK(desc.mipCount > 0 && desc.mipCount <= maxMipCount, "Invalid mip count {}.", desc.mipCount);
+}
+} // namespace
+
+TiledTextureFile::TiledTextureFile(const std::filesystem::path& path) : mPath(path)
+{
+    if (!mFile.open(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::RandomAccess))
+        FALCOR_THROW("Failed to open tiled texture file '{}'.", path);
+
+    if (mFile.getSize() < kDataOffset)
+        FALCOR_THROW("Tiled texture file '{}' is truncated.", path);
+    Header header;
+    std::memcpy(&header, mFile.getData(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+        FALCOR_THROW("'{}' is not a tiled texture file.", path);
+    if (header.version != kVersion)
+        FALCOR_THROW("Tiled texture file '{}' has version {}, expected {}.", path, header.version, kVersion);
+    if (header.format >= (uint32_t)ResourceFormat::Count)
+        FALCOR_THROW("Tiled texture file '{}' has an invalid format.", path);
+
+    mDesc.format = (ResourceFormat)header.format;
+    mDesc.width = header.width;
+    mDesc.height = header.height;
+    mDesc.mipCount = header.mipCount;
+    mDesc.tileSize = header.tileSize;
+    mDesc.borderSize = header.borderSize;
+    try
+    {
+        validateDesc(mDesc);
+    }
+    catch (const std::exception& e)
+    {
+        FALCOR_THROW("Tiled texture file '{}' is invalid: {}", path, e.what());
+    }
+
+    size_t tileCount = 0;
+    for (uint32_t mip = 0; mip < mDesc.mipCount; ++mip)
+    {
+        mMipTileOffsets.push_back(tileCount);
+        tileCount += (size_t)getTileCountX(mip) * getTileCountY(mip);
+    }
+    if (mFile.getSize() < kDataOffset + tileCount * getTileDataSize())
+        FALCOR_THROW("Tiled texture file '{}' is truncated.", path);
+}
+
+void TiledTextureFile::write(const std::filesystem::path& path, const Desc& desc, const void* pMipData)
+{
+    validateDesc(desc);
+    FALCOR_CHECK(pMipData != nullptr, "'pMipData' must not be null.");
+
+    std::ofstream ofs(path, std::ios::binary);
+    if (!ofs)
+        FALCOR_THROW("Failed to open '{}' for writing.", path);
+
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.format = (uint32_t)desc.format;
+    header.width = desc.width;
+    header.height = desc.height;
+    header.mipCount = desc.mipCount;
+    header.tileSize = desc.tileSize;
+    header.borderSize = desc.borderSize;
+    char headerData[kDataOffset] = {};
+    std::memcpy(headerData, &header, sizeof(header));
+    ofs.write(headerData, kDataOffset);
+
+    const size_t bytesPerTexel = getFormatBytesPerBlock(desc.format);
+    const uint32_t paddedSize = desc.tileSize + 2 * desc.borderSize;
+    const size_t paddedRowSize = paddedSize * bytesPerTexel;
+    std::vector<uint8_t> tile(paddedRowSize * paddedSize);
+
+    const uint8_t* pMip = static_cast<const uint8_t*>(pMipData);
+    for (uint32_t mip = 0; mip < desc.mipCount; ++mip)
+    {
+        const int32_t mipWidth = (int32_t)std::max(1u, desc.width >> mip);
+        const int32_t mipHeight = (int32_t)std::max(1u, desc.height >> mip);
+        const uint32_t tileCountX = computeTileCount(desc.width, mip, desc.tileSize);
+        const uint32_t tileCountY = computeTileCount(desc.height, mip, desc.tileSize);
+
+        for (uint32_t ty = 0; ty < tileCountY; ++ty)
+        {
+            for (uint32_t tx = 0; tx < tileCountX; ++tx)
+            {
+                // Copy the tile and its border, clamping to the mip edges.
+                const int32_t x0 = (int32_t)(tx * desc.tileSize) - (int32_t)desc.borderSize;
+                const int32_t y0 = (int32_t)(ty * desc.tileSize) - (int32_t)desc.borderSize;
+                for (uint32_t y = 0; y < paddedSize; ++y)
+                {
+                    const int32_t srcY = std::clamp(y0 + (int32_t)y, 0, mipHeight - 1);
+                    const uint8_t* pSrcRow = pMip + (size_t)srcY * mipWidth * bytesPerTexel;
+                    uint8_t* pDstRow = tile.data() + y * paddedRowSize;
+                    for (uint32_t x = 0; x < paddedSize; ++x)
+                    {
+                        const int32_t srcX = std::clamp(x0 + (int32_t)x, 0, mipWidth - 1);
+                        std::memcpy(pDstRow + x * bytesPerTexel, pSrcRow + srcX * bytesPerTexel, bytesPerTexel);
+                    }
+                }
+                ofs.write(reinterpret_cast<const char*>(tile.data()), tile.size());
+            }
+        }
+
+        pMip += (size_t)mipWidth * mipHeight * bytesPerTexel;
+    }
+
+    if (!ofs)
+        FALCOR_THROW("Failed to write '{}'.", path);
+}
+
+size_t TiledTextureFile::getTileDataSize() const
+{
+    const size_t paddedSize = getPaddedTileSize();
+    return paddedSize * paddedSize * getFormatBytesPerBlock(mDesc.format);
+}
+
+void TiledTextureFile::readTile(uint32_t mip, uint32_t x, uint32_t y, void* pDst) const
+{
+    FALCOR_CHECK(mip < mDesc.mipCount, "Mip level {} is out of range.", mip);
+    FALCOR_CHECK(x < getTileCountX(mip) && y < getTileCountY(mip), "Tile ({}, {}) is out of range at mip level {}.", x, y, mip);
+    std::memcpy(pDst, static_cast<const uint8_t*>(mFile.getData()) + getTileOffset(mip, x, y), getTileDataSize());
+}
+
+uint32_t TiledTextureFile::getTileCount(uint32_t size, uint32_t mip) const
+{
+    return computeTileCount(size, mip, mDesc.tileSize);
+}
+
+size_t TiledTextureFile::getTileOffset(uint32_t mip, uint32_t x, uint32_t y) const
+{
+    const size_t tileIndex = mMipTileOffsets[mip] + (size_t)y * getTileCountX(mip) + x;
+    return kDataOffset + tileIndex * getTileDataSize();
+}
+} // namespace Falcor
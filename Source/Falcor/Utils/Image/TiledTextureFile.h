@@ -0,0 +1,106 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include <cstdint>
+#include <filesystem>
+
+namespace Falcor
+{
+/**
+ * Pre-tiled texture file used for streaming virtual textures.
+ *
+ * The file stores all mip levels of a 2D texture cut into square tiles of tileSize x tileSize texels. Each tile is
+ * surrounded by a border of borderSize texels copied from the neighboring tiles (clamped at the texture edges),
+ * so that tiles can be filtered independently once placed in the physical tile texture. Tiles are stored
+ * uncompressed at a fixed size, mip 0 first and row-major within a mip, which allows reading any tile with
+ * a single copy from the memory mapped file.
+ */
+class FALCOR_API TiledTextureFile
+{
+public:
+    struct Desc
+    {
+        ResourceFormat format = ResourceFormat::Unknown;
+        uint32_t width = 0;      ///< Width of mip 0 in texels.
+        uint32_t height = 0;     ///< Height of mip 0 in texels.
+        uint32_t mipCount = 0;   ///< Number of mip levels.
+        uint32_t tileSize = 0;   ///< Tile size in texels, excluding the border.
+        uint32_t borderSize = 0; ///< Border size in texels on each side of a tile.
+    };
+
+    /**
+     * Open a tiled texture file for reading.
+     * Throws an exception if the file cannot be opened or is invalid.
+     * @param[in] path File path.
+     */
+    TiledTextureFile(const std::filesystem::path& path);
+
+    /**
+     * Write a tiled texture file.
+     * Throws an exception if the file cannot be written or the format is not supported.
+     * @param[in] path File path.
+     * @param[in] desc Texture description. The format must be uncompressed.
+     * @param[in] pMipData Data of all mip levels starting with mip 0, tightly packed (see MipGenerator::generate()).
+     */
+    static void write(const std::filesystem::path& path, const Desc& desc, const void* pMipData);
+
+    const std::filesystem::path& getPath() const { return mPath; }
+    const Desc& getDesc() const { return mDesc; }
+
+    /// Get the number of tiles in x direction at a mip level.
+    uint32_t getTileCountX(uint32_t mip) const { return getTileCount(mDesc.width, mip); }
+    /// Get the number of tiles in y direction at a mip level.
+    uint32_t getTileCountY(uint32_t mip) const { return getTileCount(mDesc.height, mip); }
+
+    /// Get the size of a tile including its border in texels.
+    uint32_t getPaddedTileSize() const { return mDesc.tileSize + 2 * mDesc.borderSize; }
+    /// Get the size of the data of a tile in bytes.
+    size_t getTileDataSize() const;
+
+    /**
+     * Read a tile. This is thread-safe.
+     * @param[in] mip Mip level.
+     * @param[in] x Tile x coordinate.
+     * @param[in] y Tile y coordinate.
+     * @param[out] pDst Destination, getTileDataSize() bytes. Rows are tightly packed.
+     */
+    void readTile(uint32_t mip, uint32_t x, uint32_t y, void* pDst) const;
+
+private:
+    uint32_t getTileCount(uint32_t size, uint32_t mip) const;
+    size_t getTileOffset(uint32_t mip, uint32_t x, uint32_t y) const;
+
+    std::filesystem::path mPath;
+    Desc mDesc;
+    std::vector<size_t> mMipTileOffsets; ///< Index of the first tile of each mip level.
+    MemoryMappedFile mFile;
+};
+} // namespace Falcor
@@ -0,0 +1,506 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "VirtualTexture.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include "Utils/StringFormatters.h"
+#include <algorithm>
+
+namespace Falcor
+{
+// PageTable
+
+PageTable::PageTable(const TiledTextureFile::Desc& desc)
+{
+    FALCOR_CHECK(desc.tileSize > 0, "Tile size must be non-zero.");
+    size_t tileCount = 0;
+    for (uint32_t mip = 0; mip < desc.mipCount; ++mip)
+    {
+        const uint32_t width = std::max(1u, desc.width >> mip);
+        const uint32_t height = std::max(1u, desc.height >> mip);
+        mTileCounts.push_back({(width + desc.tileSize - 1) / desc.tileSize, (height + desc.tileSize - 1) / desc.tileSize});
+        mMipOffsets.push_back(tileCount);
+        tileCount += (size_t)mTileCounts.back().x * mTileCounts.back().y;
+    }
+    mSlots.resize(tileCount, kNotResident);
+    mEntries.resize(tileCount, kNotResident);
+}
+
+bool PageTable::isValid(uint32_t mip, uint32_t x, uint32_t y) const
+{
+    return mip < getMipCount() && x < mTileCounts[mip].x && y < mTileCounts[mip].y;
+}
+
+void PageTable::getParent(uint32_t& mip, uint32_t& x, uint32_t& y) const
+{
+    FALCOR_ASSERT(mip + 1 < getMipCount());
+    ++mip;
+    // Rounding down the mip size can make the last tile of a level map outside of the next level.
+    x = std::min(x / 2, mTileCounts[mip].x - 1);
+    y = std::min(y / 2, mTileCounts[mip].y - 1);
+}
+
+void PageTable::map(uint32_t mip, uint32_t x, uint32_t y, uint32_t slot)
+{
+    FALCOR_CHECK(isValid(mip, x, y), "Tile ({}, {}) at mip level {} is out of range.", x, y, mip);
+    FALCOR_CHECK(slot < (1u << kSlotBits), "Slot {} is out of range.", slot);
+    uint32_t& entry = mSlots[getIndex(mip, x, y)];
+    if (entry == kNotResident)
+        ++mResidentCount;
+    entry = slot;
+    mDirty = true;
+}
+
+void PageTable::unmap(uint32_t mip, uint32_t x, uint32_t y)
+{
+    FALCOR_CHECK(isValid(mip, x, y), "Tile ({}, {}) at mip level {} is out of range.", x, y, mip);
+    uint32_t& entry = mSlots[getIndex(mip, x, y)];
+    if (entry != kNotResident)
+    {
+        --mResidentCount;
+        entry = kNotResident;
+        mDirty = true;
+    }
+}
+
+void PageTable::update()
+{
+    if (!mDirty)
+        return;
+
+    // Coarse to fine, so that the parent entry is final when a tile falls back to it.
+    for (uint32_t mip = getMipCount(); mip-- > 0;)
+    {
+        for (uint32_t y = 0; y < mTileCounts[mip].y; ++y)
+        {
+            for (uint32_t x = 0; x < mTileCounts[mip].x; ++x)
+            {
+                const size_t index = getIndex(mip, x, y);
+                if (mSlots[index] != kNotResident)
+                {
+                    mEntries[index] = packEntry(mSlots[index], mip);
+                }
+                else if (mip + 1 < getMipCount())
+                {
+                    uint32_t parentMip = mip, parentX = x, parentY = y;
+                    getParent(parentMip, parentX, parentY);
+                    mEntries[index] = mEntries[getIndex(parentMip, parentX, parentY)];
+                }
+                else
+                {
+                    mEntries[index] = kNotResident;
+                }
+            }
+        }
+    }
+    mDirty = false;
+}
+
+// TileCache
+
+TileCache::TileCache(uint32_t slotCount) : mSlots(slotCount)
+{
+    FALCOR_CHECK(slotCount > 0, "Slot count must be non-zero.");
+    mFreeSlots.reserve(slotCount);
+    for (uint32_t slot = slotCount; slot-- > 0;)
+        mFreeSlots.push_back(slot);
+}
+
+std::optional<uint32_t> TileCache::find(uint32_t tile) const
+{
+    if (auto it = mTileToSlot.find(tile); it != mTileToSlot.end())
+        return it->second;
+    return {};
+}
+
+bool TileCache::touch(uint32_t tile, uint64_t frame)
+{
+    auto it = mTileToSlot.find(tile);
+    if (it == mTileToSlot.end())
+        return false;
+
+    Slot& slot = mSlots[it->second];
+    slot.lastUsedFrame = frame;
+    if (!slot.locked)
+        mLru.splice(mLru.end(), mLru, slot.lruIt);
+    return true;
+}
+
+std::optional<TileCache::Allocation> TileCache::allocate(uint32_t tile, uint64_t frame)
+{
+    FALCOR_CHECK(mTileToSlot.count(tile) == 0, "Tile is already resident.");
+
+    Allocation allocation = {0, kNoTile};
+    if (!mFreeSlots.empty())
+    {
+        allocation.slot = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    }
+    else
+    {
+        // The LRU list is ordered by last use, so if the least recently used tile is in use, all are.
+        if (mLru.empty() || mSlots[mLru.front()].lastUsedFrame >= frame)
+            return {};
+        allocation.slot = mLru.front();
+        allocation.evictedTile = mSlots[allocation.slot].tile;
+        mLru.pop_front();
+        mTileToSlot.erase(allocation.evictedTile);
+    }
+
+    Slot& slot = mSlots[allocation.slot];
+    slot.tile = tile;
+    slot.lastUsedFrame = frame;
+    slot.locked = false;
+    slot.lruIt = mLru.insert(mLru.end(), allocation.slot);
+    mTileToSlot[tile] = allocation.slot;
+    return allocation;
+}
+
+uint32_t TileCache::getAvailableCount(uint64_t frame) const
+{
+    uint32_t count = (uint32_t)mFreeSlots.size();
+    for (uint32_t slot : mLru)
+    {
+        if (mSlots[slot].lastUsedFrame >= frame)
+            break;
+        ++count;
+    }
+    return count;
+}
+
+void TileCache::lock(uint32_t tile)
+{
+    auto it = mTileToSlot.find(tile);
+    FALCOR_CHECK(it != mTileToSlot.end(), "Tile is not resident.");
+    Slot& slot = mSlots[it->second];
+    if (!slot.locked)
+    {
+        mLru.erase(slot.lruIt);
+        slot.locked = true;
+    }
+}
+
+void TileCache::release(uint32_t tile)
+{
+    auto it = mTileToSlot.find(tile);
+    if (it == mTileToSlot.end())
+        return;
+    Slot& slot = mSlots[it->second];
+    if (!slot.locked)
+        mLru.erase(slot.lruIt);
+    slot = Slot();
+    mFreeSlots.push_back(it->second);
+    mTileToSlot.erase(it);
+}
+
+// VirtualTextureStreamer
+
+VirtualTextureStreamer::VirtualTextureStreamer(const Options& options) : mOptions(options), mCache(options.physicalTileCount)
+{
+    for (uint32_t i = 0; i < mOptions.threadCount; ++i)
+        mThreads.emplace_back([this]() { runWorker(); });
+}
+
+VirtualTextureStreamer::~VirtualTextureStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mJobCondition.notify_all();
+    for (auto& thread : mThreads)
+        thread.join();
+}
+
+uint32_t VirtualTextureStreamer::addTexture(std::shared_ptr<const TiledTextureFile> pFile)
+{
+    FALCOR_CHECK(pFile != nullptr, "'pFile' must not be null.");
+    const auto& desc = pFile->getDesc();
+    FALCOR_CHECK(mTextures.size() < TileId::kMaxTextureCount, "Too many virtual textures.");
+    FALCOR_CHECK(desc.mipCount <= TileId::kMaxMipCount, "Virtual texture '{}' has too many mip levels.", pFile->getPath());
+    FALCOR_CHECK(
+        pFile->getTileCountX(0) <= TileId::kMaxTileCount && pFile->getTileCountY(0) <= TileId::kMaxTileCount,
+        "Virtual texture '{}' has too many tiles.",
+        pFile->getPath()
+    );
+
+    const uint32_t textureId = (uint32_t)mTextures.size();
+    mTextures.push_back(std::make_unique<Texture>(Texture{pFile, PageTable(desc)}));
+    Texture& texture = *mTextures.back();
+
+    // The coarsest mip is the fallback for all tiles and is kept resident.
+    const uint32_t mip = desc.mipCount - 1;
+    for (uint32_t y = 0; y < pFile->getTileCountY(mip); ++y)
+    {
+        for (uint32_t x = 0; x < pFile->getTileCountX(mip); ++x)
+        {
+            const TileId tile{textureId, mip, x, y};
+            auto allocation = mCache.allocate(tile.pack(), mFrame);
+            if (!allocation || allocation->evictedTile != TileCache::kNoTile)
+                FALCOR_THROW("Tile cache is too small to hold the coarsest mip levels of all virtual textures.");
+            mCache.lock(tile.pack());
+            texture.pageTable.map(mip, x, y, allocation->slot);
+
+            TileUpload upload{tile, allocation->slot, std::vector<uint8_t>(pFile->getTileDataSize())};
+            pFile->readTile(mip, x, y, upload.data.data());
+            mInitialUploads.push_back(std::move(upload));
+        }
+    }
+    texture.pageTable.update();
+
+    return textureId;
+}
+
+bool VirtualTextureStreamer::isValidTile(const TileId& tile) const
+{
+    return tile.textureId < mTextures.size() && mTextures[tile.textureId]->pageTable.isValid(tile.mip, tile.x, tile.y);
+}
+
+void VirtualTextureStreamer::addRequest(const TileId& tile, uint32_t count, bool speculative)
+{
+    Request& request = mRequests[tile.pack()];
+    request.count += count;
+    request.speculative = request.count == 0 && (speculative || request.speculative);
+}
+
+void VirtualTextureStreamer::processFeedback(fstd::span<const uint32_t> feedback)
+{
+    for (uint32_t packed : feedback)
+    {
+        if (packed == TileId::kInvalid)
+            continue;
+        if (auto it = mRequests.find(packed); it != mRequests.end() && !it->second.speculative)
+        {
+            // Fast path for repeated entries.
+            ++it->second.count;
+            continue;
+        }
+        const TileId tile = TileId::unpack(packed);
+        if (!isValidTile(tile))
+        {
+            ++mStats.invalidFeedback;
+            continue;
+        }
+        addRequest(tile, 1, false);
+    }
+}
+
+std::vector<VirtualTextureStreamer::TileUpload> VirtualTextureStreamer::update()
+{
+    ++mFrame;
+    ++mStats.frameCount;
+
+    // Expand the requests according to the prefetch policy.
+    if (mOptions.prefetchParents || mOptions.prefetchNeighbors)
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> requested;
+        for (const auto& [packed, request] : mRequests)
+        {
+            if (!request.speculative)
+                requested.emplace_back(packed, request.count);
+        }
+        for (const auto& [packed, count] : requested)
+        {
+            const TileId tile = TileId::unpack(packed);
+            const PageTable& pageTable = mTextures[tile.textureId]->pageTable;
+            if (mOptions.prefetchParents)
+            {
+                TileId parent = tile;
+                while (parent.mip + 1 < pageTable.getMipCount())
+                {
+                    pageTable.getParent(parent.mip, parent.x, parent.y);
+                    addRequest(parent, count, false);
+                }
+            }
+            if (mOptions.prefetchNeighbors)
+            {
+                const int32_t offsets[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+                for (const auto& offset : offsets)
+                {
+                    const TileId neighbor{tile.textureId, tile.mip, tile.x + offset[0], tile.y + offset[1]};
+                    if (pageTable.isValid(neighbor.mip, neighbor.x, neighbor.y))
+                        addRequest(neighbor, 0, true);
+                }
+            }
+        }
+    }
+
+    // Mark resident tiles as used before anything is evicted.
+    std::vector<std::pair<uint32_t, Request>> missing;
+    for (const auto& [packed, request] : mRequests)
+    {
+        if (!request.speculative)
+            ++mStats.requestedTiles;
+        if (mCache.find(packed))
+        {
+            if (!request.speculative)
+            {
+                mCache.touch(packed, mFrame);
+                ++mStats.cacheHits;
+            }
+        }
+        else if (mPendingLoads.count(packed) == 0)
+        {
+            missing.emplace_back(packed, request);
+        }
+    }
+    mRequests.clear();
+
+    // Prioritize tiles seen in the feedback over speculative ones, then coarse to fine, then by how often they were requested.
+    std::sort(
+        missing.begin(),
+        missing.end(),
+        [](const auto& a, const auto& b)
+        {
+            const TileId tileA = TileId::unpack(a.first), tileB = TileId::unpack(b.first);
+            if (a.second.speculative != b.second.speculative)
+                return !a.second.speculative;
+            if (tileA.mip != tileB.mip)
+                return tileA.mip > tileB.mip;
+            if (a.second.count != b.second.count)
+                return a.second.count > b.second.count;
+            return a.first < b.first;
+        }
+    );
+
+    // Loads in flight will take up slots as well.
+    const size_t pendingBudget = mOptions.maxPendingLoads - std::min<size_t>(mOptions.maxPendingLoads, mPendingLoads.size());
+    const size_t availableSlots = mCache.getAvailableCount(mFrame);
+    const size_t cacheBudget = availableSlots - std::min(availableSlots, mPendingLoads.size());
+    const size_t loadCount = std::min<size_t>({missing.size(), mOptions.maxLoadsPerFrame, pendingBudget, cacheBudget});
+    mStats.deferredLoads += missing.size() - loadCount;
+
+    std::vector<LoadJob> jobs;
+    for (size_t i = 0; i < loadCount; ++i)
+    {
+        const uint32_t packed = missing[i].first;
+        jobs.push_back({packed, mTextures[TileId::unpack(packed).textureId]->pFile.get()});
+        mPendingLoads.insert(packed);
+    }
+    mStats.issuedLoads += jobs.size();
+
+    // Queue the loads, or run them on the calling thread if there are no loader threads.
+    std::deque<LoadResult> results;
+    if (mThreads.empty())
+    {
+        for (const auto& job : jobs)
+            mResults.push_back(load(job));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mThreads.empty())
+            mJobs.insert(mJobs.end(), jobs.begin(), jobs.end());
+        const size_t resultCount = std::min<size_t>(mResults.size(), mOptions.maxUploadsPerFrame);
+        std::move(mResults.begin(), mResults.begin() + resultCount, std::back_inserter(results));
+        mResults.erase(mResults.begin(), mResults.begin() + resultCount);
+    }
+    if (!jobs.empty())
+        mJobCondition.notify_all();
+
+    // Place loaded tiles into the cache.
+    std::vector<TileUpload> uploads = std::move(mInitialUploads);
+    mInitialUploads.clear();
+    for (auto& result : results)
+    {
+        mPendingLoads.erase(result.tile);
+        const TileId tile = TileId::unpack(result.tile);
+        if (result.failed)
+        {
+            ++mStats.failedLoads;
+            continue;
+        }
+
+        auto allocation = mCache.allocate(result.tile, mFrame);
+        if (!allocation)
+        {
+            ++mStats.droppedLoads;
+            continue;
+        }
+        if (allocation->evictedTile != TileCache::kNoTile)
+        {
+            const TileId evicted = TileId::unpack(allocation->evictedTile);
+            mTextures[evicted.textureId]->pageTable.unmap(evicted.mip, evicted.x, evicted.y);
+            ++mStats.evictedTiles;
+        }
+        mTextures[tile.textureId]->pageTable.map(tile.mip, tile.x, tile.y, allocation->slot);
+        uploads.push_back({tile, allocation->slot, std::move(result.data)});
+        ++mStats.completedLoads;
+    }
+
+    for (auto& pTexture : mTextures)
+        pTexture->pageTable.update();
+
+    return uploads;
+}
+
+void VirtualTextureStreamer::waitForLoads()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mResultCondition.wait(lock, [&]() { return mJobs.empty() && mActiveJobCount == 0; });
+}
+
+VirtualTextureStreamer::LoadResult VirtualTextureStreamer::load(const LoadJob& job)
+{
+    const TileId tile = TileId::unpack(job.tile);
+    LoadResult result{job.tile, std::vector<uint8_t>(job.pFile->getTileDataSize())};
+    try
+    {
+        job.pFile->readTile(tile.mip, tile.x, tile.y, result.data.data());
+    }
+    catch (const std::exception& e)
+    {
+        logWarning("Failed to load tile ({}, {}) at mip level {} of '{}': {}", tile.x, tile.y, tile.mip, job.pFile->getPath(), e.what());
+        result.data.clear();
+        result.failed = true;
+    }
+    return result;
+}
+
+void VirtualTextureStreamer::runWorker()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        mJobCondition.wait(lock, [&]() { return mStop || !mJobs.empty(); });
+        if (mStop)
+            break;
+
+        const LoadJob job = mJobs.front();
+        mJobs.pop_front();
+        ++mActiveJobCount;
+        lock.unlock();
+
+        LoadResult result = load(job);
+
+        lock.lock();
+        mResults.push_back(std::move(result));
+        --mActiveJobCount;
+        mResultCondition.notify_all();
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,369 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "TiledTextureFile.h"
+#include "Core/Macros.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <fstd/span.h>
+
+namespace Falcor
+{
+/**
+ * Identifies a tile of a virtual texture.
+ * Tiles are packed into 32 bits in the GPU feedback buffer, see VirtualTexture.slang.
+ */
+struct TileId
+{
+    static constexpr uint32_t kTextureBits = 10;
+    static constexpr uint32_t kMipBits = 4;
+    static constexpr uint32_t kCoordBits = 9;
+
+    static constexpr uint32_t kMaxTextureCount = (1u << kTextureBits) - 1; ///< The last texture ID is reserved for kInvalid.
+    static constexpr uint32_t kMaxMipCount = 1u << kMipBits;
+    static constexpr uint32_t kMaxTileCount = 1u << kCoordBits; ///< Maximum number of tiles per dimension.
+    static constexpr uint32_t kInvalid = 0xffffffff;            ///< Packed value of an empty feedback entry.
+
+    uint32_t textureId = 0;
+    uint32_t mip = 0;
+    uint32_t x = 0;
+    uint32_t y = 0;
+
+    uint32_t pack() const
+    {
+        return (textureId << (kMipBits + 2 * kCoordBits)) | (mip << (2 * kCoordBits)) | (y << kCoordBits) | x;
+    }
+
+    static TileId unpack(uint32_t packed)
+    {
+        const uint32_t coordMask = (1u << kCoordBits) - 1;
+        return TileId{
+            packed >> (kMipBits + 2 * kCoordBits),
+            (packed >> (2 * kCoordBits)) & ((1u << kMipBits) - 1),
+            packed & coordMask,
+            (packed >> kCoordBits) & coordMask,
+        };
+    }
+
+    bool operator==(const TileId& other) const { return pack() == other.pack(); }
+    bool operator!=(const TileId& other) const { return pack() != other.pack(); }
+};
+
+/**
+ * Page table of a virtual texture.
+ *
+ * Tracks which tiles are resident in the physical tile cache. After update(), the entry of every tile refers to
+ * the finest resident tile covering it, so that shaders fall back to a coarser mip while a tile is streamed in.
+ * Entries are stored for all mip levels (mip 0 first, row-major) and can be uploaded to the GPU as-is.
+ */
+class FALCOR_API PageTable
+{
+public:
+    static constexpr uint32_t kNotResident = 0xffffffff;
+    static constexpr uint32_t kSlotBits = 24;
+
+    /**
+     * Create a page table with no resident tiles.
+     * @param[in] desc Description of the tiled texture.
+     */
+    PageTable(const TiledTextureFile::Desc& desc);
+
+    uint32_t getMipCount() const { return (uint32_t)mTileCounts.size(); }
+    uint32_t getTileCountX(uint32_t mip) const { return mTileCounts[mip].x; }
+    uint32_t getTileCountY(uint32_t mip) const { return mTileCounts[mip].y; }
+
+    /// Check if a tile is within the bounds of the page table.
+    bool isValid(uint32_t mip, uint32_t x, uint32_t y) const;
+
+    /// Get the tile covering a tile at the next coarser mip level.
+    void getParent(uint32_t& mip, uint32_t& x, uint32_t& y) const;
+
+    /// Mark a tile as resident in a physical slot.
+    void map(uint32_t mip, uint32_t x, uint32_t y, uint32_t slot);
+    /// Mark a tile as not resident.
+    void unmap(uint32_t mip, uint32_t x, uint32_t y);
+
+    /// Get the physical slot of a tile, or kNotResident.
+    uint32_t getSlot(uint32_t mip, uint32_t x, uint32_t y) const { return mSlots[getIndex(mip, x, y)]; }
+    bool isResident(uint32_t mip, uint32_t x, uint32_t y) const { return getSlot(mip, x, y) != kNotResident; }
+    uint32_t getResidentCount() const { return mResidentCount; }
+
+    /// Propagate resident tiles to the entries of their descendants. Only does work if tiles were mapped or unmapped.
+    void update();
+    bool isDirty() const { return mDirty; }
+
+    /// Get the entry of a tile (see packEntry()), or kNotResident if no covering tile is resident.
+    uint32_t getEntry(uint32_t mip, uint32_t x, uint32_t y) const { return mEntries[getIndex(mip, x, y)]; }
+    /// Get the entries of all tiles.
+    const std::vector<uint32_t>& getEntries() const { return mEntries; }
+    /// Get the index of the first entry of a mip level.
+    size_t getMipOffset(uint32_t mip) const { return mMipOffsets[mip]; }
+
+    static uint32_t packEntry(uint32_t slot, uint32_t mip) { return (mip << kSlotBits) | slot; }
+    static uint32_t getEntrySlot(uint32_t entry) { return entry & ((1u << kSlotBits) - 1); }
+    static uint32_t getEntryMip(uint32_t entry) { return entry >> kSlotBits; }
+
+private:
+    struct TileCount
+    {
+        uint32_t x;
+        uint32_t y;
+    };
+
+    size_t getIndex(uint32_t mip, uint32_t x, uint32_t y) const { return mMipOffsets[mip] + (size_t)y * mTileCounts[mip].x + x; }
+
+    std::vector<TileCount> mTileCounts;
+    std::vector<size_t> mMipOffsets;
+    std::vector<uint32_t> mSlots;   ///< Physical slot of each tile.
+    std::vector<uint32_t> mEntries; ///< Entry of each tile including fallbacks.
+    uint32_t mResidentCount = 0;
+    bool mDirty = true;
+};
+
+/**
+ * Least recently used cache of physical tile slots.
+ *
+ * Tiles used in the current frame are never evicted, so that a frame cannot evict tiles it samples.
+ * Locked tiles (e.g. the coarsest mip of each texture, which is the fallback of last resort) are never evicted.
+ */
+class FALCOR_API TileCache
+{
+public:
+    static constexpr uint32_t kNoTile = TileId::kInvalid;
+
+    struct Allocation
+    {
+        uint32_t slot;
+        uint32_t evictedTile; ///< Packed ID of the evicted tile, or kNoTile if the slot was free.
+    };
+
+    TileCache(uint32_t slotCount);
+
+    uint32_t getSlotCount() const { return (uint32_t)mSlots.size(); }
+    uint32_t getResidentCount() const { return (uint32_t)mTileToSlot.size(); }
+
+    /// Get the slot of a resident tile.
+    std::optional<uint32_t> find(uint32_t tile) const;
+
+    /**
+     * Mark a resident tile as used in a frame.
+     * @return True if the tile is resident.
+     */
+    bool touch(uint32_t tile, uint64_t frame);
+
+    /**
+     * Allocate a slot for a tile and mark it as used in a frame.
+     * Evicts the least recently used unlocked tile if there is no free slot.
+     * @return The allocation, or an empty optional if all slots hold locked tiles or tiles used in this frame.
+     */
+    std::optional<Allocation> allocate(uint32_t tile, uint64_t frame);
+
+    /// Get the number of slots that can be allocated in a frame without evicting tiles used in it.
+    uint32_t getAvailableCount(uint64_t frame) const;
+
+    /// Exclude a resident tile from eviction.
+    void lock(uint32_t tile);
+
+    /// Release the slot of a resident tile.
+    void release(uint32_t tile);
+
+private:
+    struct Slot
+    {
+        uint32_t tile = kNoTile;
+        uint64_t lastUsedFrame = 0;
+        bool locked = false;
+        std::list<uint32_t>::iterator lruIt; ///< Position in the LRU list (unlocked tiles only).
+    };
+
+    std::vector<Slot> mSlots;
+    std::vector<uint32_t> mFreeSlots;
+    std::list<uint32_t> mLru; ///< Slots of unlocked tiles, least recently used first.
+    std::unordered_map<uint32_t, uint32_t> mTileToSlot;
+};
+
+/**
+ * Streams tiles of virtual textures into a fixed size physical tile cache.
+ *
+ * Each frame, the renderer writes the tiles it would like to sample to a feedback buffer (packed TileIds, see
+ * VirtualTexture.slang) and passes the read back buffer to processFeedback(). update() then
+ * - marks resident tiles as used,
+ * - issues asynchronous loads for missing tiles according to the prefetch policy and per-frame budgets,
+ * - places loaded tiles into the LRU tile cache, evicting tiles not used recently, and updates the page tables.
+ * It returns the tiles that need to be copied into the physical tile texture. The streamer itself does not touch the GPU.
+ *
+ * Requests are prioritized coarse to fine, so that a usable fallback is always streamed in before the finer tiles,
+ * and by how often a tile appears in the feedback. Loads are only issued while the cache has slots that are not
+ * used in the current frame. Requests exceeding the budgets are dropped and re-requested by the feedback of later frames.
+ */
+class FALCOR_API VirtualTextureStreamer
+{
+public:
+    struct Options
+    {
+        /// Number of tiles in the physical tile cache.
+        uint32_t physicalTileCount = 1024;
+        /// Maximum number of tile loads issued per frame.
+        uint32_t maxLoadsPerFrame = 64;
+        /// Maximum number of tile loads in flight.
+        uint32_t maxPendingLoads = 256;
+        /// Maximum number of loaded tiles returned by update() per frame (upload budget).
+        uint32_t maxUploadsPerFrame = 64;
+        /// Number of loader threads. Zero loads tiles synchronously in update().
+        uint32_t threadCount = 2;
+        /// Request all coarser tiles covering a requested tile.
+        bool prefetchParents = true;
+        /// Speculatively request the neighbors of requested tiles when the budget allows.
+        bool prefetchNeighbors = false;
+    };
+
+    /// Loaded tile to be copied into the physical tile texture.
+    struct TileUpload
+    {
+        TileId tile;
+        uint32_t slot;
+        std::vector<uint8_t> data; ///< Tile data including the border, see TiledTextureFile::readTile().
+    };
+
+    struct Stats
+    {
+        uint64_t frameCount = 0;      ///< Number of calls to update().
+        uint64_t requestedTiles = 0;  ///< Unique tiles requested (including prefetching), summed over frames.
+        uint64_t cacheHits = 0;       ///< Requested tiles that were resident.
+        uint64_t issuedLoads = 0;     ///< Tile loads issued.
+        uint64_t deferredLoads = 0;   ///< Missing tiles not issued due to the load budget.
+        uint64_t completedLoads = 0;  ///< Tile loads placed into the cache.
+        uint64_t droppedLoads = 0;    ///< Loaded tiles discarded because no slot could be evicted.
+        uint64_t failedLoads = 0;     ///< Tile loads that failed.
+        uint64_t evictedTiles = 0;    ///< Tiles evicted from the cache.
+        uint64_t invalidFeedback = 0; ///< Feedback entries referring to unknown textures or tiles.
+    };
+
+    VirtualTextureStreamer() : VirtualTextureStreamer(Options()) {}
+    VirtualTextureStreamer(const Options& options);
+    ~VirtualTextureStreamer();
+
+    VirtualTextureStreamer(const VirtualTextureStreamer&) = delete;
+    VirtualTextureStreamer& operator=(const VirtualTextureStreamer&) = delete;
+
+    /**
+     * Add a virtual texture.
+     * The tiles of the coarsest mip level are loaded immediately and locked in the cache. They are returned by the next update().
+     * Throws an exception if the texture exceeds the limits of TileId or the cache has no room for the coarsest mip.
+     * @param[in] pFile Tiled texture file.
+     * @return Texture ID used in TileIds.
+     */
+    uint32_t addTexture(std::shared_ptr<const TiledTextureFile> pFile);
+
+    uint32_t getTextureCount() const { return (uint32_t)mTextures.size(); }
+    const TiledTextureFile& getTexture(uint32_t textureId) const { return *mTextures[textureId]->pFile; }
+    const PageTable& getPageTable(uint32_t textureId) const { return mTextures[textureId]->pageTable; }
+    const TileCache& getTileCache() const { return mCache; }
+
+    /**
+     * Add requests from a feedback buffer. Can be called multiple times per frame.
+     * @param[in] feedback Packed TileIds. Entries equal to TileId::kInvalid are ignored.
+     */
+    void processFeedback(fstd::span<const uint32_t> feedback);
+
+    /**
+     * Finish the frame: issue loads for the requested tiles and place loaded tiles into the cache.
+     * @return Tiles to copy into the physical tile texture.
+     */
+    std::vector<TileUpload> update();
+
+    /// Wait until all issued loads are completed. The tiles are placed into the cache by the next update().
+    void waitForLoads();
+
+    uint32_t getPendingLoadCount() const { return (uint32_t)mPendingLoads.size(); }
+    const Stats& getStats() const { return mStats; }
+
+private:
+    struct Texture
+    {
+        std::shared_ptr<const TiledTextureFile> pFile;
+        PageTable pageTable;
+    };
+
+    struct Request
+    {
+        uint32_t count = 0;       ///< Number of feedback entries requesting the tile.
+        bool speculative = false; ///< Requested by neighbor prefetching only.
+    };
+
+    struct LoadJob
+    {
+        uint32_t tile;
+        const TiledTextureFile* pFile;
+    };
+
+    struct LoadResult
+    {
+        uint32_t tile;
+        std::vector<uint8_t> data;
+        bool failed = false;
+    };
+
+    bool isValidTile(const TileId& tile) const;
+    void addRequest(const TileId& tile, uint32_t count, bool speculative);
+    void issueLoads();
+    static LoadResult load(const LoadJob& job);
+    void runWorker();
+
+    Options mOptions;
+    std::vector<std::unique_ptr<Texture>> mTextures;
+    TileCache mCache;
+    uint64_t mFrame = 0;
+    Stats mStats;
+
+    std::map<uint32_t, Request> mRequests;       ///< Tiles requested in the current frame.
+    std::unordered_set<uint32_t> mPendingLoads;  ///< Tiles issued but not yet placed into the cache.
+    std::vector<TileUpload> mInitialUploads;     ///< Coarsest mips of added textures.
+
+    // Loader state shared with the worker threads.
+    std::mutex mMutex;
+    std::condition_variable mJobCondition;    ///< Signaled when jobs are queued or the streamer shuts down.
+    std::condition_variable mResultCondition; ///< Signaled when a job completes.
+    std::deque<LoadJob> mJobs;
+    std::deque<LoadResult> mResults;
+    uint32_t mActiveJobCount = 0;
+    bool mStop = false;
+    std::vector<std::thread> mThreads;
+};
+} // namespace Falcor
@@ -63,6 +63,7 @@ namespace Mogwai
         : CaptureTrigger(pRenderer, "Frame Capture")
     {
         mpImageProcessing = std::make_unique<ImageProcessing>(pRenderer->getDevice());
+        mpImageWriter = std::make_unique<StreamingImageWriter>(pRenderer->getDevice());
     }
 
     void FrameCapture::renderUI(Gui* pGui)
@@ -76,6 +77,19 @@ namespace Mogwai
             w.checkbox("Capture All Outputs", mCaptureAllOutputs);
             w.tooltip("Capture all available outputs instead of the marked ones only.");
 
+            w.checkbox("Streaming Writer", mUseStreamingWriter);
+            w.tooltip("Write EXR/PFM outputs asynchronously through a ring of readback buffers and parallel encoders.");
+            if (mUseStreamingWriter)
+            {
+                w.checkbox("Multi-Part EXR", mMultiPartExr);
+                w.tooltip("Write all EXR outputs of a frame into a single multi-part EXR file.");
+
+                const auto stats = mpImageWriter->getStats();
+                w.text(fmt::format("Written: {} files ({:.1f} MB), {} failed", stats.fileCount, stats.byteCount / (1024.0 * 1024.0), stats.failedCount));
+                w.text(fmt::format("Throughput: {:.2f} files/s, stalled {:.2f} s", stats.getFilesPerSecond(), stats.stallTime));
+                if (w.button("Reset Stats")) mpImageWriter->resetStats();
+            }
+
             if (w.button("Capture Current Frame")) capture();
         }
     }
@@ -111,6 +125,13 @@ namespace Mogwai
         frameCapture.def_property("captureAllOutputs",
             [](FrameCapture* pFC){ return pFC->mCaptureAllOutputs;},
             [](FrameCapture* pFC, bool all){ pFC->mCaptureAllOutputs = all; });
+        frameCapture.def_property("streamingWriter",
+            [](FrameCapture* pFC){ return pFC->mUseStreamingWriter;},
+            [](FrameCapture* pFC, bool enable){ pFC->mUseStreamingWriter = enable; });
+        frameCapture.def_property("multiPartExr",
+            [](FrameCapture* pFC){ return pFC->mMultiPartExr;},
+            [](FrameCapture* pFC, bool enable){ pFC->mMultiPartExr = enable; });
+        frameCapture.def("flush", [](FrameCapture* pFC) { pFC->mpImageWriter->flush(); });
     }
 
     std::string FrameCapture::getScriptVar() const
@@ -148,6 +169,7 @@ namespace Mogwai
         {
             captureOutput(pRenderContext, pGraph, i);
         }
+        writeMultiPartExr(pRenderContext);
 
         if (mCaptureAllOutputs && !unmarkedOutputs.empty())
         {
@@ -248,8 +270,41 @@ namespace Mogwai
             Bitmap::ExportFlags flags = Bitmap::ExportFlags::None;
             if (mask == TextureChannelFlags::RGBA) flags |= Bitmap::ExportFlags::ExportAlpha;
 
+            writeImage(pRenderContext, pTex, filename, outputName + suffix, fileformat, flags);
+        }
+    }
+
+    void FrameCapture::writeImage(RenderContext* pRenderContext, const ref<Texture>& pTex, const std::string& filename, const std::string& partName, Bitmap::FileFormat fileformat, Bitmap::ExportFlags flags)
+    {
+        auto streamingFormat = StreamingImageWriter::getFileFormatFromPath(filename);
+        if (!mUseStreamingWriter || !streamingFormat || !StreamingImageWriter::isFormatSupported(pTex->getFormat(), *streamingFormat))
+        {
             pTex->captureToFile(0, 0, filename, fileformat, flags);
+            return;
         }
+
+        // Multi-part files require all parts to have the same resolution, other outputs are written to separate files.
+        bool samePartSize = mPendingParts.empty() || (mPendingParts[0].pTexture->getWidth() == pTex->getWidth() && mPendingParts[0].pTexture->getHeight() == pTex->getHeight());
+        // Like captureToFile(), RGBA outputs are written as RGB unless alpha is requested.
+        StreamingImageWriter::Part part{partName, pTex};
+        part.exportAlpha = is_set(flags, Bitmap::ExportFlags::ExportAlpha);
+        if (mMultiPartExr && *streamingFormat == StreamingImageWriter::FileFormat::Exr && samePartSize)
+        {
+            mPendingParts.push_back(std::move(part));
+        }
+        else
+        {
+            mpImageWriter->write(pRenderContext, part, filename);
+        }
+    }
+
+    void FrameCapture::writeMultiPartExr(RenderContext* pRenderContext)
+    {
+        if (mPendingParts.empty()) return;
+
+        auto path = getOutputPath() / (getBaseFilename() + "." + std::to_string(mpRenderer->getGlobalClock().getFrame()) + ".exr");
+        mpImageWriter->writeMultiPart(pRenderContext, mPendingParts, path);
+        mPendingParts.clear();
     }
 
     void FrameCapture::addFrames(const RenderGraph* pGraph, const uint64_vec& frames)
@@ -29,6 +29,7 @@
 #include "../../Mogwai.h"
 #include "CaptureTrigger.h"
 #include "Utils/Image/ImageProcessing.h"
+#include "Utils/Image/StreamingImageWriter.h"
 
 namespace Mogwai
 {
@@ -51,8 +52,14 @@ namespace Mogwai
         void addFrames(const std::string& graphName, const uint64_vec& frames);
         std::string graphFramesStr(const RenderGraph* pGraph);
         void captureOutput(RenderContext* pRenderContext, RenderGraph* pGraph, const uint32_t outputIndex);
+        void writeImage(RenderContext* pRenderContext, const ref<Texture>& pTex, const std::string& filename, const std::string& partName, Bitmap::FileFormat fileformat, Bitmap::ExportFlags flags);
+        void writeMultiPartExr(RenderContext* pRenderContext);
 
         bool mCaptureAllOutputs = false;
+        bool mUseStreamingWriter = true;    ///< Write EXR/PFM outputs through the streaming writer instead of Texture::captureToFile().
+        bool mMultiPartExr = false;         ///< Combine all EXR outputs of a frame into one multi-part EXR file.
         std::unique_ptr<ImageProcessing> mpImageProcessing;
+        std::unique_ptr<StreamingImageWriter> mpImageWriter;
+        std::vector<StreamingImageWriter::Part> mPendingParts;  ///< Parts of the multi-part EXR file for the current frame.
     };
 }
@@ -224,6 +224,7 @@ namespace Mogwai
             g.text("Program compilation:\n");
 
             const auto& s = mpRenderer->getDevice()->getProgramManager()->getCompilationStats();
+            const auto cacheStats = mpRenderer->getDevice()->getProgramManager()->getVariantCache().getStats();
             double totalTime, downstreamTime;
             mpRenderer->getDevice()->getSlangGlobalSession()->getCompilerElapsedTime(&totalTime, &downstreamTime);
             std::ostringstream oss;
@@ -234,11 +235,17 @@ namespace Mogwai
                 << "Program version time (max): " << s.programVersionMaxTime << " s" << std::endl
                 << "Program kernels time (max): " << s.programKernelsMaxTime << " s" << std::endl
                 << "Total shader code-gen time: " << totalTime << " s" << std::endl
-                << "Downstream compilation time: " << downstreamTime << " s" << std::endl;
+                << "Downstream compilation time: " << downstreamTime << " s" << std::endl
+                << "Variant cache hits (memory/disk): " << cacheStats.memoryHitCount << "/" << cacheStats.diskHitCount << std::endl
+                << "Variant cache misses (new/stale): " << cacheStats.missCount << "/" << cacheStats.staleCount << std::endl
+                << "Variants precompiled: " << cacheStats.precompiledCount << std::endl;
             g.text(oss.str());
 
             if (g.button("Reset"))
+            {
                 mpRenderer->getDevice()->getProgramManager()->resetCompilationStats();
+                mpRenderer->getDevice()->getProgramManager()->getVariantCache().resetStats();
+            }
         }
 
         // Scene UI
@@ -101,7 +101,7 @@ void SVAO::compile(RenderContext* pRenderContext, const CompileData& compileData
         defines.add("SD_JITTER", mUseCameraJitter ? "1" : "0");
 
         ProgramDesc computeShaderDesc;
-        mpComputePass = ComputePass::create(pRenderContext->getDevice(), Shaders::kSVAOPass, "main", defines);
+        mpComputePass = CreateComputePass(Shaders::kSVAOPass, defines);
     }
 }
 void SVAO::execute(RenderContext* pRenderContext, const RenderData& renderData)
@@ -124,7 +124,7 @@ void VAO::compile(RenderContext* pRenderContext, const CompileData& compileData)
         defines.add("PREPASS_SAMPLING_MODE", std::to_string(static_cast<uint32_t>(mPrepassSamplingMode)));
 
         ProgramDesc computeShaderDesc;
-        mpComputePass = ComputePass::create(pRenderContext->getDevice(), Shaders::kVAOPass, "main", defines);
+        mpComputePass = CreateComputePass(Shaders::kVAOPass, defines);
     }
 }
 
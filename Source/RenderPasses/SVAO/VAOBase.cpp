@@ -19,6 +19,19 @@ namespace
         const std::string kUseAdaptiveSampling = "useAdaptiveSampling";
         const std::string kAdaptiveSamplingDistances = "adaptiveSamplingDistances";
     }
+
+    // Defines controlled by UI options, variants differing only in these are precompiled.
+    const std::vector<std::string> kVariantDefines = {
+        "NUM_DIRECTIONS",
+        "LOG2_NUM_DIRECTIONS",
+        "ADAPTIVE_SAMPLING",
+        "USE_DITHER_TEX",
+        "SD_JITTER",
+        "USE_RAY_INTERVAL",
+        "USE_PREPASS",
+        "DEBUG_PREPASS",
+        "PREPASS_SAMPLING_MODE",
+    };
 }
 
 
@@ -60,8 +73,6 @@ DefineList VAOBase::GetCommonDefines(const CompileData& compileData)
     DefineList defines;
 
     defines.add(mpScene->getSceneDefines());
-    auto rayConeSpread = mpScene->getCamera()->computeScreenSpacePixelSpreadAngle(compileData.defaultTexDims.y);
-    defines.add("RAY_CONE_SPREAD", std::to_string(rayConeSpread));
     defines.add("NUM_DIRECTIONS", std::to_string(mSampleCount));
     defines.add("LOG2_NUM_DIRECTIONS", std::to_string(static_cast<uint>(log2(mSampleCount))));
     defines.add("ADAPTIVE_SAMPLING", mEnableAdaptiveSampling ? "1" : "0");
@@ -84,6 +95,17 @@ void VAOBase::SetCommonVars(ShaderVar& vars, Scene* pScene)
     vars["PerFrameCB"]["frameIndex"] = mFrameIndex;
     vars["PerFrameCB"]["guardBand"] = getExtraGuardBand();
 }
+ref<ComputePass> VAOBase::CreateComputePass(const std::string& path, const DefineList& defines)
+{
+    ProgramDesc desc;
+    desc.addShaderLibrary(path).csEntry("main");
+
+    ref<ComputePass> pPass = ComputePass::create(mpDevice, desc, defines);
+    mpDevice->getProgramManager()->precompileKnownVariants(desc, defines, kVariantDefines);
+
+    return pPass;
+}
+
 void VAOBase::compile(RenderContext* pRenderContext, const CompileData& compileData)
 {
     RenderPass::compile(pRenderContext, compileData);
@@ -28,6 +28,7 @@
 #pragma once
 
 #include "RenderGraph/RenderPass.h"
+#include "Core/Pass/ComputePass.h"
 #include "VAOData.slang"
 
 using namespace Falcor;
@@ -41,6 +42,13 @@ protected:
 
     void SetCommonVars(ShaderVar& vars, Scene* pScene);
 
+    /**
+     * Create the compute pass for the given shader and defines.
+     * Variants of the same shader used in previous runs that only differ in options exposed in the UI
+     * are precompiled in the background, so that changing these options does not stall.
+     */
+    ref<ComputePass> CreateComputePass(const std::string& path, const DefineList& defines);
+
 public:
     void compile(RenderContext* pRenderContext, const CompileData& compileData) override;
     void execute(RenderContext* pRenderContext, const RenderData& renderData) override;
@@ -106,7 +106,7 @@ void VAOPrepass::compile(RenderContext* pRenderContext, const CompileData& compi
         defines["NUM_DIRECTIONS"] = "8";
 
         ProgramDesc computeShaderDesc;
-        mpComputePass = ComputePass::create(pRenderContext->getDevice(), Shaders::kVAOPass, "main", defines);
+        mpComputePass = CreateComputePass(Shaders::kVAOPass, defines);
     }
 }
 
@@ -0,0 +1,317 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Image.h"
+#include "ImageAnalysis.h"
+#include "FrameTimeAnalysis.h"
+#include "Report.h"
+
+#include <args.hxx>
+#include <nlohmann/json.hpp>
+#include <BS_thread_pool/BS_thread_pool.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Headless analysis of ambient occlusion results.
+ *
+ * Compares AO images against a reference (error and SSIM heat maps, error statistics, histograms) and computes frame
+ * time statistics of profiler captures. All inputs are processed in parallel and the results are written to a JSON
+ * summary and a self-contained HTML report. This replaces the scripts in ThesisTools.
+ */
+
+namespace fs = std::filesystem;
+
+struct ImagePair
+{
+    std::string name;
+    fs::path reference;
+    fs::path result;
+};
+
+static bool isImageFile(const fs::path& path)
+{
+    static const std::vector<std::string> kExtensions = {".png", ".jpg", ".jpeg", ".bmp", ".tga", ".exr", ".pfm", ".hdr"};
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+    return std::find(kExtensions.begin(), kExtensions.end(), ext) != kExtensions.end();
+}
+
+/// List the files of a directory (sorted) or return the path itself if it is a file.
+static std::vector<fs::path> listFiles(const fs::path& path, bool (*filter)(const fs::path&))
+{
+    std::vector<fs::path> files;
+    if (fs::is_directory(path))
+    {
+        for (const auto& entry : fs::directory_iterator(path))
+        {
+            if (entry.is_regular_file() && filter(entry.path()))
+                files.push_back(entry.path());
+        }
+        std::sort(files.begin(), files.end());
+    }
+    else
+    {
+        files.push_back(path);
+    }
+    return files;
+}
+
+/**
+ * Pair result images with reference images.
+ * If the reference is a file, all result images are compared against it. If it is a directory, result images are
+ * compared against the reference image with the same file name.
+ */
+static std::vector<ImagePair> collectImagePairs(const fs::path& reference, const std::vector<std::string>& results)
+{
+    std::vector<ImagePair> pairs;
+    for (const auto& resultArg : results)
+    {
+        const fs::path resultPath(resultArg);
+        const bool isDirectory = fs::is_directory(resultPath);
+        const std::string dirName = (resultPath / ".").parent_path().filename().string();
+        for (const auto& file : listFiles(resultPath, isImageFile))
+        {
+            ImagePair pair;
+            pair.name = isDirectory ? dirName + "/" + file.filename().string() : file.filename().string();
+            pair.result = file;
+            if (fs::is_directory(reference))
+            {
+                pair.reference = reference / file.filename();
+                if (!fs::exists(pair.reference))
+                {
+                    std::cerr << "No reference image for '" << file.string() << "', skipping." << std::endl;
+                    continue;
+                }
+            }
+            else
+            {
+                pair.reference = reference;
+                if (fs::exists(file) && fs::equivalent(file, reference))
+                    continue;
+            }
+            pairs.push_back(std::move(pair));
+        }
+    }
+    return pairs;
+}
+
+/// Make a file name from a pair name.
+static std::string toFileName(std::string name)
+{
+    std::replace_if(name.begin(), name.end(), [](char c) { return c == '/' || c == '\\' || c == ':' || c == ' '; }, '_');
+    auto dot = name.rfind('.');
+    return dot != std::string::npos ? name.substr(0, dot) : name;
+}
+
+static nlohmann::json analyzeImagePair(
+    const ImagePair& pair,
+    const ImageAnalysis::Options& options,
+    const fs::path& outputDir,
+    bool writeColorHeatMaps
+)
+{
+    nlohmann::json json;
+    json["name"] = pair.name;
+    json["reference"] = pair.reference.string();
+    json["result"] = pair.result.string();
+    try
+    {
+        auto reference = Image::loadFromFile(pair.reference);
+        auto result = Image::loadFromFile(pair.result);
+        auto analysis = ImageAnalysis::analyze(*reference, *result, options);
+        json["metrics"] = ImageAnalysis::toJson(analysis, options);
+
+        // Heat maps are written next to the report, file paths in the summary are relative to it.
+        const std::string baseName = toFileName(pair.name);
+        nlohmann::json files = nlohmann::json::object();
+        auto save = [&](const std::string& kind, const Image& image, const std::string& suffix)
+        {
+            auto fileName = "heatmaps/" + baseName + suffix;
+            image.saveToFile(outputDir / fileName, false);
+            files[kind] = fileName;
+        };
+        save("error", *analysis.errorMap, "_error.exr");
+        save("ssim", *analysis.ssimMap, "_ssim.exr");
+        if (writeColorHeatMaps)
+            save("heatmap", *ImageAnalysis::colorize(*analysis.deltaMap), "_heatmap.png");
+        json["files"] = std::move(files);
+    }
+    catch (const std::exception& e)
+    {
+        json["error"] = e.what();
+    }
+    return json;
+}
+
+int main(int argc, char** argv)
+{
+    args::ArgumentParser parser("Utility to analyze ambient occlusion images and profiler captures.");
+    parser.helpParams.programName = "AOAnalysis";
+    args::HelpFlag helpFlag(parser, "help", "Display this help menu.", {'h', "help"});
+    args::ValueFlag<std::string> referenceFlag(parser, "path", "The reference image or directory of reference images.", {'r', "reference"});
+    args::ValueFlagList<std::string> captureFlag(parser, "path", "Profiler capture (JSON) or directory of captures.", {'c', "capture"});
+    args::ValueFlagList<std::string> eventFlag(
+        parser, "name", "Analyze profiler events containing this string (default: all GPU times).", {'e', "event"}
+    );
+    args::Flag totalFlag(parser, "", "Add the per-frame sum of the selected events.", {"total"});
+    args::Flag colorFlag(parser, "", "Also write color heat maps (PNG) of the signed error.", {"color"});
+    args::ValueFlag<uint32_t> binsFlag(parser, "count", "Number of error histogram bins (default: 64).", {"bins"});
+    args::ValueFlag<float> histogramMaxFlag(parser, "value", "Upper bound of the error histogram (default: 1).", {"histogram-max"});
+    args::ValueFlag<std::string> outputFlag(parser, "directory", "Output directory (default: AOAnalysis).", {'o', "output"});
+    args::ValueFlag<uint32_t> threadsFlag(parser, "count", "Number of worker threads (default: all cores).", {'j', "threads"});
+    args::PositionalList<std::string> resultsFlag(parser, "results", "Result images or directories of result images.");
+    args::CompletionFlag completionFlag(parser, {"complete"});
+
+    try
+    {
+        parser.ParseCLI(argc, argv);
+    }
+    catch (const args::Completion& e)
+    {
+        std::cout << e.what();
+        return 0;
+    }
+    catch (const args::Help&)
+    {
+        std::cout << parser;
+        return 0;
+    }
+    catch (const args::ParseError& e)
+    {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    if (!resultsFlag && !captureFlag)
+    {
+        std::cerr << "Result images or profiler captures are required." << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+    if (resultsFlag && !referenceFlag)
+    {
+        std::cerr << "A reference is required to analyze result images." << std::endl;
+        return 1;
+    }
+
+    const fs::path outputDir = outputFlag ? args::get(outputFlag) : "AOAnalysis";
+    std::error_code ec;
+    fs::create_directories(outputDir / "heatmaps", ec);
+    if (ec)
+    {
+        std::cerr << "Cannot create output directory '" << outputDir.string() << "' (Error: " << ec.message() << ")." << std::endl;
+        return 1;
+    }
+
+    ImageAnalysis::Options imageOptions;
+    if (binsFlag)
+        imageOptions.histogramBins = args::get(binsFlag);
+    if (histogramMaxFlag)
+        imageOptions.histogramMax = args::get(histogramMaxFlag);
+
+    FrameTimeAnalysis::Options frameTimeOptions;
+    frameTimeOptions.eventFilters = args::get(eventFlag);
+    frameTimeOptions.addTotal = args::get(totalFlag);
+
+    std::vector<ImagePair> pairs;
+    if (resultsFlag)
+        pairs = collectImagePairs(args::get(referenceFlag), args::get(resultsFlag));
+    std::vector<fs::path> capturePaths;
+    for (const auto& capture : args::get(captureFlag))
+    {
+        auto files = listFiles(capture, [](const fs::path& path) { return path.extension() == ".json"; });
+        capturePaths.insert(capturePaths.end(), files.begin(), files.end());
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Parallelism is over inputs, each task decodes and analyzes one image pair or capture.
+    BS::thread_pool pool(threadsFlag ? args::get(threadsFlag) : 0);
+    std::vector<nlohmann::json> images(pairs.size());
+    std::vector<nlohmann::json> captures(capturePaths.size());
+    for (size_t i = 0; i < pairs.size(); ++i)
+        pool.push_task([&, i]() { images[i] = analyzeImagePair(pairs[i], imageOptions, outputDir, args::get(colorFlag)); });
+    for (size_t i = 0; i < capturePaths.size(); ++i)
+    {
+        pool.push_task(
+            [&, i]()
+            {
+                try
+                {
+                    captures[i] = FrameTimeAnalysis::toJson(FrameTimeAnalysis::analyze(capturePaths[i], frameTimeOptions));
+                }
+                catch (const std::exception& e)
+                {
+                    captures[i] = {{"name", capturePaths[i].stem().string()}, {"error", e.what()}};
+                }
+                captures[i]["path"] = capturePaths[i].string();
+            }
+        );
+    }
+    pool.wait_for_tasks();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    auto hasError = [](const nlohmann::json& json) { return json.contains("error"); };
+    size_t failedCount = std::count_if(images.begin(), images.end(), hasError) + std::count_if(captures.begin(), captures.end(), hasError);
+
+    nlohmann::json summary;
+    if (referenceFlag)
+        summary["reference"] = args::get(referenceFlag);
+    summary["images"] = std::move(images);
+    summary["captures"] = std::move(captures);
+    summary["failedCount"] = failedCount;
+    summary["seconds"] = seconds;
+
+    try
+    {
+        const auto jsonPath = outputDir / "summary.json";
+        std::ofstream stream(jsonPath);
+        if (!stream)
+            throw std::runtime_error("Cannot write summary to '" + jsonPath.string() + "'");
+        stream << summary.dump(4) << std::endl;
+        Report::writeHtml(summary, outputDir / "summary.html");
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cerr << "Analyzed " << pairs.size() << " images and " << capturePaths.size() << " captures in " << seconds << "s, " << failedCount
+              << " failed." << std::endl;
+    return failedCount == 0 ? 0 : 1;
+}
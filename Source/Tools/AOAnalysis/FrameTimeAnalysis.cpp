@@ -0,0 +1,199 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "FrameTimeAnalysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+
+namespace FrameTimeAnalysis
+{
+namespace
+{
+bool isSelected(const std::string& name, const Options& options)
+{
+    if (options.eventFilters.empty())
+        return name.size() >= 9 && name.compare(name.size() - 9, 9, "/gpu_time") == 0;
+    return std::any_of(
+        options.eventFilters.begin(),
+        options.eventFilters.end(),
+        [&name](const std::string& filter) { return name.find(filter) != std::string::npos; }
+    );
+}
+
+/**
+ * Exponential moving average with bias correction, see
+ * https://github.com/tensorflow/tensorboard/blob/34877f15153e1a2087316b9952c931807a122aa7/tensorboard/components/vz_line_chart2/line-chart.ts#L699
+ */
+std::vector<double> smooth(const std::vector<double>& values, double weight)
+{
+    std::vector<double> result(values.size());
+    double last = 0.0;
+    double debias = 1.0;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        last = last * weight + (1.0 - weight) * values[i];
+        debias *= weight;
+        result[i] = weight != 1.0 ? last / (1.0 - debias) : last;
+    }
+    return result;
+}
+
+/// Indices of the chart points, evenly distributed over the frames.
+std::vector<size_t> getChartIndices(size_t frameCount, uint32_t pointCount)
+{
+    std::vector<size_t> indices;
+    if (frameCount == 0 || pointCount == 0)
+        return indices;
+    size_t count = std::min<size_t>(frameCount, std::max(pointCount, 2u));
+    indices.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        indices.push_back(count > 1 ? i * (frameCount - 1) / (count - 1) : 0);
+    return indices;
+}
+
+Series computeSeries(
+    const std::string& name,
+    const std::vector<double>& records,
+    const std::vector<size_t>& chartIndices,
+    double smoothWeight
+)
+{
+    Series series;
+    series.name = name;
+    if (records.empty())
+        return series;
+
+    const size_t count = records.size();
+    series.mean = std::accumulate(records.begin(), records.end(), 0.0) / count;
+    double variance = 0.0;
+    for (double value : records)
+        variance += (value - series.mean) * (value - series.mean);
+    series.stdDev = std::sqrt(variance / count);
+
+    std::vector<double> sorted = records;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted, count](double p) { return sorted[std::clamp<size_t>(size_t(std::ceil(p / 100.0 * count)), 1, count) - 1]; };
+    series.min = sorted.front();
+    series.max = sorted.back();
+    series.median = percentile(50.0);
+    series.p95 = percentile(95.0);
+    series.p99 = percentile(99.0);
+
+    auto smoothed = smooth(records, smoothWeight);
+    series.chart.reserve(chartIndices.size());
+    for (size_t i : chartIndices)
+        series.chart.push_back(float(smoothed[i]));
+    return series;
+}
+} // namespace
+
+Capture analyze(const std::filesystem::path& path, const Options& options)
+{
+    std::ifstream stream(path);
+    if (!stream)
+        throw std::runtime_error("Cannot open capture '" + path.string() + "'");
+    nlohmann::json json = nlohmann::json::parse(stream);
+
+    Capture capture;
+    capture.name = path.stem().string();
+    capture.frameCount = json.at("frame_count").get<uint32_t>();
+    const nlohmann::json& events = json.at("events");
+
+    auto getRecords = [&](const nlohmann::json& event)
+    {
+        auto records = event.at("records").get<std::vector<double>>();
+        if (records.size() < capture.frameCount)
+            throw std::runtime_error("Event has fewer records than the capture has frames");
+        records.resize(capture.frameCount);
+        return records;
+    };
+
+    auto chartIndices = getChartIndices(capture.frameCount, options.chartPointCount);
+
+    // The time axis is the accumulated GPU frame time, as in the thesis charts.
+    if (auto it = events.find(kFrameTimeEvent); it != events.end())
+    {
+        auto frameTimes = getRecords(*it);
+        std::vector<double> times(frameTimes.size());
+        std::partial_sum(frameTimes.begin(), frameTimes.end(), times.begin());
+        capture.duration = times.empty() ? 0.0 : times.back() * 1e-3;
+        for (size_t i : chartIndices)
+            capture.chartTimes.push_back(float(times[i] * 1e-3));
+    }
+    else
+    {
+        for (size_t i : chartIndices)
+            capture.chartTimes.push_back(float(i));
+    }
+
+    std::vector<double> total(capture.frameCount, 0.0);
+    for (const auto& [name, event] : events.items())
+    {
+        if (!isSelected(name, options))
+            continue;
+        auto records = getRecords(event);
+        if (options.addTotal)
+            std::transform(total.begin(), total.end(), records.begin(), total.begin(), std::plus<double>());
+        capture.series.push_back(computeSeries(name, records, chartIndices, options.smoothWeight));
+    }
+    if (options.addTotal && !capture.series.empty())
+        capture.series.push_back(computeSeries("total", total, chartIndices, options.smoothWeight));
+
+    return capture;
+}
+
+nlohmann::json toJson(const Capture& capture)
+{
+    nlohmann::json json;
+    json["name"] = capture.name;
+    json["frameCount"] = capture.frameCount;
+    json["duration"] = capture.duration;
+    json["chartTimes"] = capture.chartTimes;
+    json["series"] = nlohmann::json::array();
+    for (const auto& series : capture.series)
+    {
+        json["series"].push_back({
+            {"name", series.name},
+            {"mean", series.mean},
+            {"stdDev", series.stdDev},
+            {"min", series.min},
+            {"max", series.max},
+            {"median", series.median},
+            {"p95", series.p95},
+            {"p99", series.p99},
+            {"chart", series.chart},
+        });
+    }
+    return json;
+}
+
+} // namespace FrameTimeAnalysis
@@ -0,0 +1,87 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * Frame time statistics of profiler captures.
+ *
+ * A capture is the JSON serialization of the dictionary returned by Profiler.end_capture() in Python:
+ * {"frame_count": N, "events": {"<name>": {"records": [N times in ms], ...}, ...}}.
+ */
+namespace FrameTimeAnalysis
+{
+/// Event holding the total GPU frame time, used to compute the capture duration.
+constexpr const char* kFrameTimeEvent = "/onFrameRender/gpu_time";
+
+struct Options
+{
+    /// Events whose name contains any of these substrings are analyzed. If empty, all GPU time events are analyzed.
+    std::vector<std::string> eventFilters;
+    /// Add a series holding the per-frame sum of all selected events.
+    bool addTotal = false;
+    /// Weight of the exponential moving average used for the chart series (same as the thesis charts).
+    double smoothWeight = 0.98;
+    /// Maximum number of points of the chart series.
+    uint32_t chartPointCount = 512;
+};
+
+struct Series
+{
+    std::string name;
+    double mean = 0.0;
+    double stdDev = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double median = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    std::vector<float> chart; ///< Smoothed and downsampled records in ms.
+};
+
+struct Capture
+{
+    std::string name;
+    uint32_t frameCount = 0;
+    double duration = 0.0;         ///< Total GPU frame time in seconds, or 0 if the frame time event is missing.
+    std::vector<float> chartTimes; ///< Time in seconds (or frame index if the duration is unknown) of the chart points.
+    std::vector<Series> series;
+};
+
+/// Load and analyze a capture. Throws on invalid files.
+Capture analyze(const std::filesystem::path& path, const Options& options);
+
+/// Convert the capture statistics and chart series to JSON.
+nlohmann::json toJson(const Capture& capture);
+
+} // namespace FrameTimeAnalysis
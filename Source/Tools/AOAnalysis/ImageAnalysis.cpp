@@ -0,0 +1,244 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ImageAnalysis.h"
+#include "ImageMetrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace ImageAnalysis
+{
+namespace
+{
+/// JSON cannot represent non-finite numbers, they are written as strings.
+nlohmann::json toJson(double value)
+{
+    if (std::isnan(value))
+        return "nan";
+    if (std::isinf(value))
+        return value > 0.0 ? "inf" : "-inf";
+    return value;
+}
+
+/// Run func(first, last) over the row range, on the thread pool if one is provided.
+template<typename Func>
+void forEachRow(uint32_t height, BS::thread_pool* pThreadPool, Func&& func)
+{
+    if (pThreadPool)
+        pThreadPool->parallelize_loop(0u, height, func).wait();
+    else
+        func(0u, height);
+}
+} // namespace
+
+std::shared_ptr<Image> toGrayscale(const Image& image)
+{
+    auto gray = Image::create(image.getWidth(), image.getHeight());
+    gray->setLinear(image.isLinear());
+    const float* src = image.getData();
+    float* dst = gray->getData();
+    for (size_t i = 0; i < size_t(image.getWidth()) * image.getHeight(); ++i)
+    {
+        float value = 0.2125f * src[0] + 0.7154f * src[1] + 0.0721f * src[2];
+        dst[0] = dst[1] = dst[2] = value;
+        dst[3] = 1.f;
+        src += 4;
+        dst += 4;
+    }
+    return gray;
+}
+
+Result analyze(const Image& reference, const Image& result, const Options& options)
+{
+    if (reference.getWidth() != result.getWidth() || reference.getHeight() != result.getHeight())
+        throw std::runtime_error("Cannot compare images with different resolutions");
+
+    const uint32_t width = reference.getWidth();
+    const uint32_t height = reference.getHeight();
+    const size_t pixelCount = size_t(width) * height;
+    const uint32_t binCount = std::max(options.histogramBins, 1u);
+
+    auto refGray = toGrayscale(reference);
+    auto resultGray = toGrayscale(result);
+
+    Result r;
+    r.width = width;
+    r.height = height;
+    r.errorMap = Image::create(width, height);
+    r.deltaMap = Image::create(width, height);
+    r.ssimMap = Image::create(width, height);
+
+    // Per-pixel signed error. Row sums are reduced in order to keep the results deterministic.
+    std::vector<float> absErrors(pixelCount);
+    std::vector<double> rowBias(height), rowAbs(height), rowSquared(height);
+    std::vector<float> rowMax(height);
+    forEachRow(
+        height,
+        options.pThreadPool,
+        [&](uint32_t first, uint32_t last)
+        {
+            for (uint32_t y = first; y < last; ++y)
+            {
+                double bias = 0.0, absSum = 0.0, squared = 0.0;
+                float maxError = 0.f;
+                for (uint32_t x = 0; x < width; ++x)
+                {
+                    size_t i = size_t(y) * width + x;
+                    float delta = resultGray->getData()[i * 4] - refGray->getData()[i * 4];
+                    float absError = std::fabs(delta);
+                    absErrors[i] = absError;
+                    r.deltaMap->getData()[i * 4] = delta;
+                    float* pError = r.errorMap->getData() + i * 4;
+                    pError[0] = pError[1] = pError[2] = absError;
+                    pError[3] = 1.f;
+                    bias += delta;
+                    absSum += absError;
+                    squared += double(delta) * delta;
+                    maxError = std::max(maxError, absError);
+                }
+                rowBias[y] = bias;
+                rowAbs[y] = absSum;
+                rowSquared[y] = squared;
+                rowMax[y] = maxError;
+            }
+        }
+    );
+
+    r.bias = std::accumulate(rowBias.begin(), rowBias.end(), 0.0) / pixelCount;
+    r.mae = std::accumulate(rowAbs.begin(), rowAbs.end(), 0.0) / pixelCount;
+    r.mse = std::accumulate(rowSquared.begin(), rowSquared.end(), 0.0) / pixelCount;
+    r.rmse = std::sqrt(r.mse);
+    r.psnr = r.mse > 0.0 ? -10.0 * std::log10(r.mse) : std::numeric_limits<double>::infinity();
+    r.maxError = pixelCount > 0 ? *std::max_element(rowMax.begin(), rowMax.end()) : 0.f;
+
+    // Remove the bias from the signed error, this is what the heat map visualizes.
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        float* pDelta = r.deltaMap->getData() + i * 4;
+        pDelta[0] -= float(r.bias);
+        pDelta[1] = pDelta[2] = pDelta[0];
+        pDelta[3] = 1.f;
+    }
+
+    // Histogram of the absolute error.
+    r.histogram.assign(binCount, 0);
+    const float binScale = binCount / std::max(options.histogramMax, 1e-6f);
+    for (float absError : absErrors)
+        r.histogram[std::min(uint32_t(absError * binScale), binCount - 1)]++;
+
+    // Nearest-rank percentiles. Selecting in increasing order lets each selection only partition the remaining range.
+    auto begin = absErrors.begin();
+    for (size_t p = 0; p < kPercentiles.size() && pixelCount > 0; ++p)
+    {
+        size_t rank = size_t(std::ceil(kPercentiles[p] / 100.0 * pixelCount));
+        auto nth = absErrors.begin() + (std::clamp<size_t>(rank, 1, pixelCount) - 1);
+        std::nth_element(begin, nth, absErrors.end());
+        r.percentiles[p] = *nth;
+        begin = nth;
+    }
+
+    // SSIM on the luminance channel. The metric returns 1 - SSIM in the error map.
+    std::vector<float> ssimError(pixelCount);
+    ImageMetrics::Options metricOptions;
+    metricOptions.channelCount = 1;
+    metricOptions.errorMap = ssimError.data();
+    metricOptions.pThreadPool = options.pThreadPool;
+    r.ssim = ImageMetrics::computeSSIM(*refGray, *resultGray, metricOptions);
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        float* pSSIM = r.ssimMap->getData() + i * 4;
+        pSSIM[0] = pSSIM[1] = pSSIM[2] = 1.f - ssimError[i];
+        pSSIM[3] = 1.f;
+    }
+
+    return r;
+}
+
+nlohmann::json toJson(const Result& result, const Options& options)
+{
+    nlohmann::json json;
+    json["width"] = result.width;
+    json["height"] = result.height;
+    json["bias"] = toJson(result.bias);
+    json["mae"] = toJson(result.mae);
+    json["mse"] = toJson(result.mse);
+    json["rmse"] = toJson(result.rmse);
+    json["psnr"] = toJson(result.psnr);
+    json["ssim"] = toJson(result.ssim);
+    json["maxError"] = toJson(result.maxError);
+    nlohmann::json percentiles = nlohmann::json::object();
+    for (size_t p = 0; p < kPercentiles.size(); ++p)
+    {
+        char key[16];
+        std::snprintf(key, sizeof(key), "p%g", kPercentiles[p]);
+        percentiles[key] = toJson(result.percentiles[p]);
+    }
+    json["percentiles"] = std::move(percentiles);
+    json["histogram"] = {{"max", options.histogramMax}, {"bins", result.histogram}};
+    return json;
+}
+
+std::shared_ptr<Image> colorize(const Image& image)
+{
+    static const float colors[5][3] = {
+        {0.f, 0.f, 1.f}, // blue
+        {0.f, 1.f, 1.f}, // teal
+        {0.f, 1.f, 0.f}, // green
+        {1.f, 1.f, 0.f}, // yellow
+        {1.f, 0.f, 0.f}, // red
+    };
+
+    const size_t pixelCount = size_t(image.getWidth()) * image.getHeight();
+    float minValue = std::numeric_limits<float>::max();
+    float maxValue = std::numeric_limits<float>::lowest();
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        minValue = std::min(minValue, image.getData()[i * 4]);
+        maxValue = std::max(maxValue, image.getData()[i * 4]);
+    }
+    const float range = std::max(1e-5f, maxValue - minValue);
+
+    auto colored = Image::create(image.getWidth(), image.getHeight());
+    colored->setLinear(false);
+    float* dst = colored->getData();
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        float t = clamp((image.getData()[i * 4] - minValue) / range, 0.f, 1.f);
+        int c = clamp(int(std::floor(t * 4.f)), 0, 3);
+        for (size_t j = 0; j < 3; ++j)
+            *dst++ = lerp(colors[c][j], colors[c + 1][j], t * 4.f - c);
+        *dst++ = 1.f;
+    }
+    return colored;
+}
+
+} // namespace ImageAnalysis
@@ -0,0 +1,96 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Image.h"
+
+#include <BS_thread_pool/BS_thread_pool.hpp>
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Per-pixel analysis of an ambient occlusion image against a reference.
+ *
+ * Images are converted to grayscale first (AO outputs are grayscale, colored debug views are reduced to luminance).
+ * The analysis produces an absolute error map, an SSIM map, error statistics and a histogram of the absolute error.
+ */
+namespace ImageAnalysis
+{
+/// Percentiles of the absolute error reported by analyze().
+constexpr std::array<double, 5> kPercentiles = {50.0, 90.0, 95.0, 99.0, 99.9};
+
+struct Options
+{
+    /// Number of histogram bins.
+    uint32_t histogramBins = 64;
+    /// Upper bound of the histogram range [0, histogramMax]. Larger errors are counted in the last bin.
+    float histogramMax = 1.f;
+    /// Optional thread pool used to process bands in parallel.
+    BS::thread_pool* pThreadPool = nullptr;
+};
+
+struct Result
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    double bias = 0.0; ///< Mean signed error (result - reference).
+    double mae = 0.0;  ///< Mean absolute error.
+    double mse = 0.0;  ///< Mean squared error.
+    double rmse = 0.0; ///< Root mean squared error.
+    double psnr = 0.0; ///< Peak signal-to-noise ratio in dB assuming a peak value of 1.
+    double ssim = 0.0; ///< Structural similarity index, see ImageMetrics::computeSSIM().
+    double maxError = 0.0;
+    std::array<double, kPercentiles.size()> percentiles = {}; ///< Absolute error at kPercentiles.
+    std::vector<uint64_t> histogram;                          ///< Absolute error histogram over [0, histogramMax].
+    std::shared_ptr<Image> errorMap;                          ///< Absolute error (grayscale).
+    std::shared_ptr<Image> deltaMap;                          ///< Signed error with the bias removed (single channel).
+    std::shared_ptr<Image> ssimMap;                           ///< Per-pixel SSIM (grayscale).
+};
+
+/**
+ * Convert an image to grayscale using the Rec. 709 luma weights, matching skimage.color.rgb2gray.
+ * The value is stored in the RGB channels, alpha is set to one.
+ */
+std::shared_ptr<Image> toGrayscale(const Image& image);
+
+/// Analyze an image against a reference. Both images must have the same resolution.
+Result analyze(const Image& reference, const Image& result, const Options& options);
+
+/// Convert the scalar results and the histogram to JSON. Error maps are not included.
+nlohmann::json toJson(const Result& result, const Options& options);
+
+/**
+ * Map a single channel image to a blue-teal-green-yellow-red color ramp over its value range,
+ * matching the heat maps of ImageCompare.
+ */
+std::shared_ptr<Image> colorize(const Image& image);
+
+} // namespace ImageAnalysis
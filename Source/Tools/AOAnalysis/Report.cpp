@@ -0,0 +1,236 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Report.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace Report
+{
+namespace
+{
+const char* kColors[] = {"#d62728", "#1f77b4", "#2ca02c", "#17becf", "#9467bd", "#ff7f0e", "#8c564b", "#e377c2", "#7f7f7f", "#bcbd22"};
+
+const char* kStyle = R"(
+body { font-family: sans-serif; margin: 2em; }
+table { border-collapse: collapse; margin-bottom: 2em; }
+th, td { border: 1px solid #ccc; padding: 4px 8px; text-align: right; }
+th { background: #eee; }
+td.name { text-align: left; }
+.error { color: #c00; text-align: left; }
+svg { background: #fafafa; }
+)";
+
+std::string escape(const std::string& str)
+{
+    std::string result;
+    result.reserve(str.size());
+    for (char c : str)
+    {
+        switch (c)
+        {
+        case '&':
+            result += "&amp;";
+            break;
+        case '<':
+            result += "&lt;";
+            break;
+        case '>':
+            result += "&gt;";
+            break;
+        case '"':
+            result += "&quot;";
+            break;
+        default:
+            result += c;
+        }
+    }
+    return result;
+}
+
+/// Format a number. Non-finite values are stored as strings in the summary.
+std::string format(const nlohmann::json& value, const char* fmt = "%.4g")
+{
+    if (value.is_string())
+        return escape(value.get<std::string>());
+    if (!value.is_number())
+        return "-";
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), fmt, value.get<double>());
+    return buf;
+}
+
+/// Bar chart of a histogram.
+void writeHistogram(std::ostream& out, const nlohmann::json& histogram)
+{
+    const auto bins = histogram.at("bins").get<std::vector<uint64_t>>();
+    if (bins.empty())
+        return;
+    const uint64_t maxCount = std::max<uint64_t>(*std::max_element(bins.begin(), bins.end()), 1);
+    const int width = 192, height = 32;
+    const double barWidth = double(width) / bins.size();
+    out << "<svg width=\"" << width << "\" height=\"" << height << "\">";
+    for (size_t i = 0; i < bins.size(); ++i)
+    {
+        // Counts are shown on a log scale, most pixels usually fall into the first bins.
+        double h = height * std::log1p(double(bins[i])) / std::log1p(double(maxCount));
+        out << "<rect x=\"" << i * barWidth << "\" y=\"" << height - h << "\" width=\"" << barWidth << "\" height=\"" << h
+            << "\" fill=\"#1f77b4\"/>";
+    }
+    out << "</svg>";
+}
+
+/// Line chart of the smoothed frame time series of a capture.
+void writeChart(std::ostream& out, const nlohmann::json& capture)
+{
+    const auto times = capture.at("chartTimes").get<std::vector<float>>();
+    const auto& series = capture.at("series");
+    if (times.size() < 2 || series.empty())
+        return;
+
+    float maxValue = 0.f;
+    for (const auto& s : series)
+    {
+        for (float v : s.at("chart").get<std::vector<float>>())
+            maxValue = std::max(maxValue, v);
+    }
+    maxValue = std::max(maxValue * 1.1f, 1e-3f);
+    const float minTime = times.front(), maxTime = std::max(times.back(), times.front() + 1e-3f);
+
+    const int width = 800, height = 300, margin = 40;
+    auto px = [&](float t) { return margin + (t - minTime) / (maxTime - minTime) * (width - 2 * margin); };
+    auto py = [&](float v) { return height - margin - v / maxValue * (height - 2 * margin); };
+
+    out << "<svg width=\"" << width << "\" height=\"" << height << "\">\n";
+    out << "<line x1=\"" << margin << "\" y1=\"" << height - margin << "\" x2=\"" << width - margin << "\" y2=\"" << height - margin
+        << "\" stroke=\"#000\"/>";
+    out << "<line x1=\"" << margin << "\" y1=\"" << margin << "\" x2=\"" << margin << "\" y2=\"" << height - margin
+        << "\" stroke=\"#000\"/>\n";
+    out << "<text x=\"" << margin << "\" y=\"" << margin - 8 << "\" font-size=\"12\">" << format(maxValue / 1.1f, "%.3g") << " ms</text>";
+    out << "<text x=\"" << width - margin << "\" y=\"" << height - margin + 16 << "\" font-size=\"12\" text-anchor=\"end\">"
+        << format(maxTime, "%.3g") << (capture.at("duration").get<double>() > 0.0 ? " s" : " frames") << "</text>\n";
+
+    for (size_t i = 0; i < series.size(); ++i)
+    {
+        const auto values = series[i].at("chart").get<std::vector<float>>();
+        out << "<polyline fill=\"none\" stroke=\"" << kColors[i % std::size(kColors)] << "\" points=\"";
+        for (size_t j = 0; j < values.size() && j < times.size(); ++j)
+            out << px(times[j]) << "," << py(values[j]) << " ";
+        out << "\"/>\n";
+    }
+    out << "</svg>\n";
+}
+
+void writeImages(std::ostream& out, const nlohmann::json& images)
+{
+    out << "<h2>Images</h2>\n<table>\n<tr><th>Name</th><th>Size</th><th>Bias</th><th>MAE</th><th>RMSE</th><th>PSNR [dB]</th><th>SSIM</th>"
+        << "<th>p95</th><th>p99</th><th>Max</th><th>Abs. error histogram</th><th>Maps</th></tr>\n";
+    for (const auto& image : images)
+    {
+        out << "<tr><td class=\"name\">" << escape(image.at("name").get<std::string>()) << "</td>";
+        if (image.contains("error"))
+        {
+            out << "<td class=\"error\" colspan=\"11\">" << escape(image.at("error").get<std::string>()) << "</td></tr>\n";
+            continue;
+        }
+        const auto& m = image.at("metrics");
+        const auto& p = m.at("percentiles");
+        out << "<td>" << m.at("width") << "x" << m.at("height") << "</td>";
+        out << "<td>" << format(m.at("bias")) << "</td><td>" << format(m.at("mae")) << "</td><td>" << format(m.at("rmse")) << "</td>";
+        out << "<td>" << format(m.at("psnr"), "%.2f") << "</td><td>" << format(m.at("ssim")) << "</td>";
+        out << "<td>" << format(p.value("p95", nlohmann::json())) << "</td><td>" << format(p.value("p99", nlohmann::json())) << "</td>";
+        out << "<td>" << format(m.at("maxError")) << "</td><td>";
+        writeHistogram(out, m.at("histogram"));
+        out << "</td><td class=\"name\">";
+        const auto files = image.value("files", nlohmann::json::object());
+        for (const auto& [kind, file] : files.items())
+            out << "<a href=\"" << escape(file.get<std::string>()) << "\">" << escape(kind) << "</a> ";
+        out << "</td></tr>\n";
+    }
+    out << "</table>\n";
+}
+
+void writeCaptures(std::ostream& out, const nlohmann::json& captures)
+{
+    out << "<h2>Frame times</h2>\n";
+    for (const auto& capture : captures)
+    {
+        out << "<h3>" << escape(capture.at("name").get<std::string>()) << "</h3>\n";
+        if (capture.contains("error"))
+        {
+            out << "<p class=\"error\">" << escape(capture.at("error").get<std::string>()) << "</p>\n";
+            continue;
+        }
+        out << "<p>" << capture.at("frameCount") << " frames";
+        if (capture.at("duration").get<double>() > 0.0)
+            out << ", " << format(capture.at("duration"), "%.2f") << " s";
+        out << "</p>\n";
+        writeChart(out, capture);
+        out << "<table>\n<tr><th></th><th>Event</th><th>Mean [ms]</th><th>Std. dev.</th><th>Min</th><th>Median</th><th>p95</th>"
+            << "<th>p99</th><th>Max</th></tr>\n";
+        const auto& series = capture.at("series");
+        for (size_t i = 0; i < series.size(); ++i)
+        {
+            const auto& s = series[i];
+            out << "<tr><td style=\"background:" << kColors[i % std::size(kColors)] << "\"></td>";
+            out << "<td class=\"name\">" << escape(s.at("name").get<std::string>()) << "</td>";
+            for (const char* key : {"mean", "stdDev", "min", "median", "p95", "p99", "max"})
+                out << "<td>" << format(s.at(key), "%.3f") << "</td>";
+            out << "</tr>\n";
+        }
+        out << "</table>\n";
+    }
+}
+} // namespace
+
+void writeHtml(const nlohmann::json& summary, const std::filesystem::path& path)
+{
+    std::ostringstream out;
+    out << "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n<title>AO analysis</title>\n<style>" << kStyle
+        << "</style>\n</head>\n<body>\n<h1>AO analysis</h1>\n";
+    if (summary.contains("reference"))
+        out << "<p>Reference: " << escape(summary.at("reference").get<std::string>()) << "</p>\n";
+    if (summary.contains("images") && !summary.at("images").empty())
+        writeImages(out, summary.at("images"));
+    if (summary.contains("captures") && !summary.at("captures").empty())
+        writeCaptures(out, summary.at("captures"));
+    out << "</body>\n</html>\n";
+
+    std::ofstream stream(path);
+    if (!stream)
+        throw std::runtime_error("Cannot write report to '" + path.string() + "'");
+    stream << out.str();
+}
+
+} // namespace Report
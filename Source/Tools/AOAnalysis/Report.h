@@ -1,5 +1,5 @@
 /***************************************************************************
- # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
  #
  # Redistribution and use in source and binary forms, with or without
  # modification, are permitted provided that the following conditions
@@ -25,27 +25,19 @@
  # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
-
-// This code is based on pbrt:
-// pbrt is Copyright(c) 1998-2020 Matt Pharr, Wenzel Jakob, and Greg Humphreys.
-// The pbrt source code is licensed under the Apache License, Version 2.0.
-// SPDX: Apache-2.0
-
 #pragma once
-#include "Utils/Math/Vector.h"
-#include <fstd/span.h> // TODO C++20: Replace with <span>
-#include <vector>
+#include <nlohmann/json.hpp>
 
-namespace Falcor::pbrt
-{
+#include <filesystem>
 
-struct LoopSubdivideResult
+/**
+ * HTML report of an analysis summary.
+ * The report is a single self-contained file with result tables, inline SVG histograms and frame time charts,
+ * and links to the heat maps. Paths in the summary are expected to be relative to the report.
+ */
+namespace Report
 {
-    std::vector<float3> positions;
-    std::vector<float3> normals;
-    std::vector<uint32_t> indices;
-};
-
-LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> vertices);
+/// Write the HTML report of a summary as produced by AOAnalysis. Throws on failure.
+void writeHtml(const nlohmann::json& summary, const std::filesystem::path& path);
 
-} // namespace Falcor::pbrt
+} // namespace Report
@@ -0,0 +1,203 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Program/ProgramVariantCache.h"
+#include "Core/Platform/OS.h"
+
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+ProgramDesc createDesc(const std::string& source)
+{
+    ProgramDesc desc;
+    desc.addShaderModule().addString(source, "test.cs.slang");
+    desc.csEntry("main");
+    desc.setShaderModel(ShaderModel::SM6_5);
+    desc.finalize();
+    return desc;
+}
+
+void writeTextFile(const std::filesystem::path& path, const std::string& text)
+{
+    std::ofstream stream(path, std::ios::trunc);
+    stream << text;
+}
+
+/// Temporary directory that is removed when going out of scope.
+struct TempDirectory
+{
+    std::filesystem::path path;
+    TempDirectory() : path(getTempFilePath()) { std::filesystem::create_directories(path); }
+    ~TempDirectory() { std::filesystem::remove_all(path); }
+};
+} // namespace
+
+CPU_TEST(ProgramVariantCache_Key)
+{
+    const ProgramDesc desc = createDesc("[numthreads(1, 1, 1)] void main() {}");
+
+    DefineList a;
+    a.add("NUM_DIRECTIONS", "8");
+    a.add("ADAPTIVE_SAMPLING", "1");
+    DefineList b;
+    b.add("ADAPTIVE_SAMPLING", "1");
+    b.add("NUM_DIRECTIONS", "8");
+
+    const std::string key = ProgramVariantCache::computeKey(desc, a);
+    EXPECT_EQ(key.size(), 40);
+    EXPECT_EQ(key, ProgramVariantCache::computeKey(desc, b));
+
+    // Changing a define value, adding a define or changing global compiler state changes the key.
+    DefineList c = a;
+    c["NUM_DIRECTIONS"] = "16";
+    EXPECT_NE(key, ProgramVariantCache::computeKey(desc, c));
+    DefineList d = a;
+    d.add("USE_DITHER_TEX", "0");
+    EXPECT_NE(key, ProgramVariantCache::computeKey(desc, d));
+    EXPECT_NE(key, ProgramVariantCache::computeKey(desc, a, {"-DFOO=1"}));
+
+    // Define names and values are delimited, so moving characters between them changes the key.
+    EXPECT_NE(ProgramVariantCache::computeKey(desc, {{"AB", "C"}}), ProgramVariantCache::computeKey(desc, {{"A", "BC"}}));
+
+    // Changing the source, entry point or shader model changes the key.
+    EXPECT_NE(key, ProgramVariantCache::computeKey(createDesc("[numthreads(2, 1, 1)] void main() {}"), a));
+    ProgramDesc otherEntry;
+    otherEntry.addShaderModule().addString("[numthreads(1, 1, 1)] void main() {}", "test.cs.slang");
+    otherEntry.csEntry("main2");
+    otherEntry.setShaderModel(ShaderModel::SM6_5);
+    otherEntry.finalize();
+    EXPECT_NE(key, ProgramVariantCache::computeKey(otherEntry, a));
+    ProgramDesc otherModel = desc;
+    otherModel.setShaderModel(ShaderModel::SM6_6);
+    EXPECT_NE(key, ProgramVariantCache::computeKey(otherModel, a));
+}
+
+CPU_TEST(ProgramVariantCache_Lookup)
+{
+    TempDirectory dir;
+    const std::filesystem::path depPath = dir.path / "dep.slang";
+    writeTextFile(depPath, "float foo() { return 1.f; }");
+
+    const ProgramDesc desc = createDesc("[numthreads(1, 1, 1)] void main() {}");
+    const DefineList defines = {{"NUM_DIRECTIONS", "8"}};
+    const std::string key = ProgramVariantCache::computeKey(desc, defines);
+
+    ProgramVariantCache::Artifacts artifacts;
+    artifacts.dependencies = {depPath.string()};
+
+    {
+        ProgramVariantCache cache(dir.path);
+        EXPECT(cache.lookup(key) == ProgramVariantCache::LookupResult::Miss);
+        EXPECT(!cache.hasArtifacts(key));
+        cache.insert(key, desc, defines, artifacts);
+        EXPECT(cache.hasArtifacts(key));
+        EXPECT(cache.lookup(key) == ProgramVariantCache::LookupResult::MemoryHit);
+
+        // Manifest writes are batched.
+        EXPECT(!std::filesystem::exists(cache.getManifestPath()));
+        cache.flush();
+        EXPECT(std::filesystem::exists(cache.getManifestPath()));
+
+        auto stats = cache.getStats();
+        EXPECT_EQ(stats.missCount, 1);
+        EXPECT_EQ(stats.memoryHitCount, 1);
+    }
+
+    // A new cache knows the variant from the manifest, but has no compilation artifacts.
+    {
+        ProgramVariantCache cache(dir.path);
+        EXPECT(!cache.hasArtifacts(key));
+        EXPECT(cache.lookup(key) == ProgramVariantCache::LookupResult::DiskHit);
+
+        auto entries = cache.getEntries(ProgramVariantCache::getDescription(desc));
+        ASSERT_EQ(entries.size(), 1);
+        EXPECT_EQ(entries[0].key, key);
+        EXPECT(entries[0].defines == defines);
+        EXPECT_EQ(entries[0].dependencies.size(), 1);
+        EXPECT_EQ(cache.getEntries("unknown").size(), 0);
+
+        // Rewriting a dependency with the same content keeps the variant valid.
+        writeTextFile(depPath, "float foo() { return 1.f; }");
+        EXPECT(cache.lookup(key) == ProgramVariantCache::LookupResult::DiskHit);
+    }
+
+    // Changing the content of a dependency invalidates the variant.
+    {
+        ProgramVariantCache cache(dir.path);
+        writeTextFile(depPath, "float foo() { return 2.f; }");
+        EXPECT(cache.lookup(key) == ProgramVariantCache::LookupResult::Stale);
+        EXPECT(cache.lookup(key) == ProgramVariantCache::LookupResult::Miss);
+
+        auto stats = cache.getStats();
+        EXPECT_EQ(stats.staleCount, 1);
+        EXPECT_EQ(stats.missCount, 1);
+    }
+}
+
+CPU_TEST(ProgramVariantCache_MemoryLimit)
+{
+    ProgramVariantCache cache({}, 2);
+    const ProgramDesc desc = createDesc("[numthreads(1, 1, 1)] void main() {}");
+
+    std::vector<std::string> keys;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        DefineList defines = {{"INDEX", std::to_string(i)}};
+        keys.push_back(ProgramVariantCache::computeKey(desc, defines));
+        cache.insert(keys.back(), desc, defines, {}, true);
+    }
+
+    // The oldest variant lost its artifacts but is still known.
+    EXPECT(cache.lookup(keys[0]) == ProgramVariantCache::LookupResult::DiskHit);
+    EXPECT(cache.lookup(keys[1]) == ProgramVariantCache::LookupResult::MemoryHit);
+    EXPECT(cache.lookup(keys[2]) == ProgramVariantCache::LookupResult::MemoryHit);
+    EXPECT_EQ(cache.getStats().precompiledCount, 3);
+    EXPECT_EQ(cache.getEntries().size(), 3);
+}
+
+CPU_TEST(ProgramVariantCache_DefineMatrix)
+{
+    const DefineList base = {{"SECONDARY_DEPTH_MODE", "1"}};
+    auto variants = ProgramVariantCache::expandDefineMatrix(base, {{"NUM_DIRECTIONS", {"8", "16", "32"}}, {"USE_DITHER_TEX", {"0", "1"}}});
+    ASSERT_EQ(variants.size(), 6);
+
+    std::set<DefineList> unique(variants.begin(), variants.end());
+    EXPECT_EQ(unique.size(), 6);
+    for (const auto& variant : variants)
+    {
+        EXPECT_EQ(variant.size(), 3);
+        EXPECT_EQ(variant.at("SECONDARY_DEPTH_MODE"), "1");
+    }
+
+    EXPECT_EQ(ProgramVariantCache::expandDefineMatrix(base, {}).size(), 1);
+    EXPECT_THROW(ProgramVariantCache::expandDefineMatrix(base, {{"NUM_DIRECTIONS", {}}}));
+}
+} // namespace Falcor
@@ -0,0 +1,138 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "RenderGraph/RenderGraph.h"
+
+namespace Falcor
+{
+namespace
+{
+class TestPass : public RenderPass
+{
+public:
+    FALCOR_PLUGIN_CLASS(TestPass, "TestPass", "Render pass for testing incremental compilation.");
+
+    TestPass(ref<Device> pDevice, bool hasInput) : RenderPass(pDevice), mHasInput(hasInput) {}
+
+    RenderPassReflection reflect(const CompileData& compileData) override
+    {
+        RenderPassReflection r;
+        if (mHasInput)
+            r.addInput("src", "Input");
+        r.addOutput("dst", "Output").format(mFormat);
+        return r;
+    }
+
+    void compile(RenderContext* pRenderContext, const CompileData& compileData) override { mCompileCount++; }
+
+    void execute(RenderContext* pRenderContext, const RenderData& renderData) override {}
+
+    /// Change state that only affects compilation.
+    void setOption() { requestRecompile(); }
+
+    /// Change the output format, which affects the reflection.
+    void setFormat(ResourceFormat format)
+    {
+        mFormat = format;
+        requestRecompile();
+    }
+
+    uint32_t getCompileCount() const { return mCompileCount; }
+
+private:
+    bool mHasInput;
+    ResourceFormat mFormat = ResourceFormat::RGBA32Float;
+    uint32_t mCompileCount = 0;
+};
+} // namespace
+
+GPU_TEST(RenderGraphIncrementalCompile)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+
+    // A -> B is a chain, C is independent.
+    auto pA = make_ref<TestPass>(pDevice, false);
+    auto pB = make_ref<TestPass>(pDevice, true);
+    auto pC = make_ref<TestPass>(pDevice, false);
+
+    ref<RenderGraph> pGraph = RenderGraph::create(pDevice, "Incremental");
+    pGraph->addPass(pA, "A");
+    pGraph->addPass(pB, "B");
+    pGraph->addPass(pC, "C");
+    pGraph->addEdge("A.dst", "B.src");
+    pGraph->markOutput("B.dst");
+    pGraph->markOutput("C.dst");
+
+    ref<Fbo> pTargetFbo = Fbo::create2D(pDevice, 16, 16, ResourceFormat::RGBA8UnormSrgb);
+    pGraph->onResize(pTargetFbo.get());
+    ASSERT(pGraph->compile(pRenderContext));
+
+    const auto& stats = pGraph->getCompileStats();
+    EXPECT(!stats.incremental);
+    EXPECT_EQ(stats.passCount, 3);
+    EXPECT_EQ(stats.compiledPassCount, 3);
+    EXPECT_EQ(stats.allocatedResourceCount, 3);
+
+    ref<Resource> pB0 = pGraph->getOutput("B.dst");
+    ref<Resource> pC0 = pGraph->getOutput("C.dst");
+
+    // Compile-only change: only A is recompiled, resources are untouched.
+    pA->setOption();
+    ASSERT(pGraph->compile(pRenderContext));
+    EXPECT(stats.incremental);
+    EXPECT_EQ(stats.compiledPassCount, 1);
+    EXPECT_EQ(pA->getCompileCount(), 2);
+    EXPECT_EQ(pB->getCompileCount(), 1);
+    EXPECT_EQ(pC->getCompileCount(), 1);
+    EXPECT(pGraph->getOutput("B.dst") == pB0);
+    EXPECT(pGraph->getOutput("C.dst") == pC0);
+
+    // Reflection change: A and its consumer B are recompiled, C and the unchanged resources are kept.
+    pA->setFormat(ResourceFormat::RGBA16Float);
+    ASSERT(pGraph->compile(pRenderContext));
+    EXPECT(stats.incremental);
+    EXPECT_EQ(stats.compiledPassCount, 2);
+    EXPECT_EQ(stats.allocatedResourceCount, 1);
+    EXPECT_EQ(stats.reusedResourceCount, 2);
+    EXPECT_EQ(pA->getCompileCount(), 3);
+    EXPECT_EQ(pB->getCompileCount(), 2);
+    EXPECT_EQ(pC->getCompileCount(), 1);
+    EXPECT(pGraph->getOutput("B.dst") == pB0);
+    EXPECT(pGraph->getOutput("C.dst") == pC0);
+
+    // Graph changes always trigger a full compile.
+    pTargetFbo = Fbo::create2D(pDevice, 32, 32, ResourceFormat::RGBA8UnormSrgb);
+    pGraph->onResize(pTargetFbo.get());
+    ASSERT(pGraph->compile(pRenderContext));
+    EXPECT(!stats.incremental);
+    EXPECT_EQ(stats.compiledPassCount, 3);
+    EXPECT_EQ(pC->getCompileCount(), 2);
+    EXPECT(pGraph->getOutput("C.dst") != pC0);
+}
+} // namespace Falcor
@@ -0,0 +1,161 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "RenderGraph/RenderGraphMemoryReport.h"
+#include <nlohmann/json.hpp>
+
+namespace Falcor
+{
+namespace
+{
+const ResourceCache::DefaultProperties kDefaultProps = {uint2(100, 100), ResourceFormat::RGBA8Unorm};
+
+void registerOutput(
+    ResourceCache& cache,
+    RenderGraphMemoryReport::PassDesc& pass,
+    const std::string& name,
+    ResourceFormat format,
+    uint32_t timePoint
+)
+{
+    auto& field = pass.reflector.addOutput(name, "").format(format);
+    cache.registerField(pass.name + "." + name, field, timePoint);
+}
+} // namespace
+
+CPU_TEST(RenderGraphMemoryReport_FieldSize)
+{
+    using Field = RenderPassReflection::Field;
+
+    Field f = Field("f", "", Field::Visibility::Output);
+    EXPECT_EQ(RenderGraphMemoryReport::estimateFieldSize(f, kDefaultProps), 100ull * 100 * 4);
+
+    f.format(ResourceFormat::RGBA32Float).texture2D(1920, 1080);
+    EXPECT_EQ(RenderGraphMemoryReport::estimateFieldSize(f, kDefaultProps), 1920ull * 1080 * 16);
+
+    // Full mip chain: 4x4 + 2x2 + 1x1.
+    f.format(ResourceFormat::R8Unorm).texture2D(4, 4, 1, Field::kMaxMipLevels);
+    EXPECT_EQ(RenderGraphMemoryReport::estimateFieldSize(f, kDefaultProps), 21ull);
+
+    // Block compressed: 8x8 texels are 2x2 blocks of 8 bytes.
+    f.format(ResourceFormat::BC1Unorm).texture2D(8, 8);
+    EXPECT_EQ(RenderGraphMemoryReport::estimateFieldSize(f, kDefaultProps), 32ull);
+
+    f.format(ResourceFormat::RGBA8Unorm).textureCube(16, 16);
+    EXPECT_EQ(RenderGraphMemoryReport::estimateFieldSize(f, kDefaultProps), 16ull * 16 * 4 * 6);
+
+    f.format(ResourceFormat::R32Float).texture3D(8, 8, 8);
+    EXPECT_EQ(RenderGraphMemoryReport::estimateFieldSize(f, kDefaultProps), 8ull * 8 * 8 * 4);
+
+    f.format(ResourceFormat::RGBA8Unorm).texture2D(0, 0, 4);
+    EXPECT_EQ(RenderGraphMemoryReport::estimateFieldSize(f, kDefaultProps), 100ull * 100 * 4 * 4);
+
+    f.rawBuffer(1000);
+    EXPECT_EQ(RenderGraphMemoryReport::estimateFieldSize(f, kDefaultProps), 1000ull);
+}
+
+CPU_TEST(RenderGraphMemoryReport_LinearGraph)
+{
+    // A.out -> B.in, B.out -> C.in, C.out is a graph output. B has an internal scratch resource.
+    ResourceCache cache;
+    std::vector<RenderGraphMemoryReport::PassDesc> passes(3);
+    passes[0].name = "A";
+    passes[1].name = "B";
+    passes[2].name = "C";
+
+    registerOutput(cache, passes[0], "out", ResourceFormat::RGBA32Float, 0);
+
+    auto& bIn = passes[1].reflector.addInput("in", "");
+    cache.registerField("B.in", bIn, 1, "A.out");
+    registerOutput(cache, passes[1], "out", ResourceFormat::R32Float, 1);
+    auto& scratch = passes[1].reflector.addInternal("scratch", "").format(ResourceFormat::R8Unorm);
+    cache.registerField("B.scratch", scratch, 1);
+
+    auto& cIn = passes[2].reflector.addInput("in", "");
+    cache.registerField("C.in", cIn, 2, "B.out");
+    registerOutput(cache, passes[2], "out", ResourceFormat::Unknown, uint32_t(-1));
+
+    // An optional input that isn't connected is ignored.
+    passes[2].reflector.addInput("unused", "").flags(RenderPassReflection::Field::Flags::Optional);
+
+    auto report = RenderGraphMemoryReport::generate(passes, cache, kDefaultProps);
+
+    const auto& resources = report.getResources();
+    ASSERT_EQ(resources.size(), 4u);
+
+    EXPECT_EQ(resources[0].name, "A.out");
+    EXPECT(resources[0].aliases == std::vector<std::string>({"A.out", "B.in"}));
+    EXPECT_EQ(resources[0].sizeInBytes, 160000ull);
+    EXPECT_EQ(resources[0].firstPass, 0u);
+    EXPECT_EQ(resources[0].lastPass, 1u);
+
+    EXPECT_EQ(resources[1].name, "B.out");
+    EXPECT_EQ(resources[1].sizeInBytes, 40000ull);
+    EXPECT_EQ(resources[1].firstPass, 1u);
+    EXPECT_EQ(resources[1].lastPass, 2u);
+
+    EXPECT_EQ(resources[2].name, "B.scratch");
+    EXPECT_EQ(resources[2].sizeInBytes, 10000ull);
+    EXPECT_EQ(resources[2].firstPass, 1u);
+    EXPECT_EQ(resources[2].lastPass, 1u);
+
+    EXPECT_EQ(resources[3].name, "C.out");
+    EXPECT(resources[3].format == ResourceFormat::RGBA8Unorm);
+    EXPECT_EQ(resources[3].sizeInBytes, 40000ull);
+    EXPECT(resources[3].graphOutput);
+    EXPECT_EQ(resources[3].firstPass, 2u);
+    EXPECT_EQ(resources[3].lastPass, 2u);
+
+    const auto& reportPasses = report.getPasses();
+    ASSERT_EQ(reportPasses.size(), 3u);
+
+    EXPECT_EQ(reportPasses[0].bytesRead, 0ull);
+    EXPECT_EQ(reportPasses[0].bytesWritten, 160000ull);
+    EXPECT_EQ(reportPasses[0].bytesAlive, 160000ull);
+
+    EXPECT_EQ(reportPasses[1].bytesRead, 170000ull);
+    EXPECT_EQ(reportPasses[1].bytesWritten, 50000ull);
+    EXPECT_EQ(reportPasses[1].bytesAlive, 210000ull);
+
+    EXPECT_EQ(reportPasses[2].bytesRead, 40000ull);
+    EXPECT_EQ(reportPasses[2].bytesWritten, 40000ull);
+    EXPECT_EQ(reportPasses[2].bytesAlive, 80000ull);
+
+    // A.out and B.out are the only transient resources, both are alive during B so nothing can be aliased.
+    EXPECT_EQ(report.getPeakBytesBeforeAliasing(), 250000ull);
+    EXPECT_EQ(report.getPeakBytesAfterAliasing(), 250000ull);
+    EXPECT_EQ(report.getMinPeakBytes(), 210000ull);
+
+    auto j = nlohmann::json::parse(report.toJson());
+    EXPECT_EQ(j["peakBytesBeforeAliasing"].get<uint64_t>(), 250000ull);
+    EXPECT_EQ(j["peakBytesAfterAliasing"].get<uint64_t>(), 250000ull);
+    EXPECT_EQ(j["minPeakBytes"].get<uint64_t>(), 210000ull);
+    EXPECT_EQ(j["resources"].size(), 4u);
+    EXPECT_EQ(j["passes"][1]["name"].get<std::string>(), "B");
+}
+} // namespace Falcor
@@ -0,0 +1,197 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "RenderGraph/RenderGraphScheduler.h"
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+DirectedGraph makeGraph(uint32_t nodeCount, const std::vector<std::pair<uint32_t, uint32_t>>& edges)
+{
+    DirectedGraph graph;
+    for (uint32_t i = 0; i < nodeCount; i++)
+        graph.addNode();
+    for (const auto& [src, dst] : edges)
+        graph.addEdge(src, dst);
+    return graph;
+}
+
+void validateSchedule(
+    CPUUnitTestContext& ctx,
+    const std::vector<std::pair<uint32_t, uint32_t>>& edges,
+    const std::vector<double>& times,
+    uint32_t queueCount,
+    const RenderGraphScheduler::Schedule& schedule
+)
+{
+    ASSERT_EQ(schedule.passes.size(), times.size());
+    ASSERT_EQ(schedule.queues.size(), queueCount);
+
+    // Every pass is on exactly one queue and passes on a queue don't overlap.
+    size_t count = 0;
+    for (uint32_t q = 0; q < queueCount; q++)
+    {
+        for (size_t i = 0; i < schedule.queues[q].size(); i++)
+        {
+            uint32_t p = schedule.queues[q][i];
+            EXPECT_EQ(schedule.passes[p].queue, q);
+            if (i > 0)
+                EXPECT_LE(schedule.passes[schedule.queues[q][i - 1]].end, schedule.passes[p].start);
+        }
+        count += schedule.queues[q].size();
+    }
+    EXPECT_EQ(count, times.size());
+
+    // Dependencies are respected.
+    for (const auto& [src, dst] : edges)
+        EXPECT_LE(schedule.passes[src].end, schedule.passes[dst].start);
+
+    // Every cross-queue dependency is covered by a chain of queue order and barriers.
+    std::vector<std::vector<uint32_t>> queueSuccessors(times.size());
+    for (const auto& queue : schedule.queues)
+        for (size_t i = 1; i < queue.size(); i++)
+            queueSuccessors[queue[i - 1]].push_back(queue[i]);
+    for (const auto& b : schedule.barriers)
+    {
+        EXPECT_NE(schedule.passes[b.srcPass].queue, schedule.passes[b.dstPass].queue);
+        queueSuccessors[b.srcPass].push_back(b.dstPass);
+    }
+    for (const auto& [src, dst] : edges)
+    {
+        std::vector<bool> visited(times.size(), false);
+        std::vector<uint32_t> stack = {src};
+        while (!stack.empty())
+        {
+            uint32_t p = stack.back();
+            stack.pop_back();
+            if (visited[p])
+                continue;
+            visited[p] = true;
+            for (uint32_t s : queueSuccessors[p])
+                stack.push_back(s);
+        }
+        EXPECT(visited[dst]) << fmt::format("Dependency {} -> {} is not synchronized", src, dst);
+    }
+}
+} // namespace
+
+CPU_TEST(RenderGraphScheduler_SingleQueue)
+{
+    std::vector<std::pair<uint32_t, uint32_t>> edges = {{0, 1}, {0, 2}, {1, 3}, {2, 3}};
+    std::vector<double> times = {1.0, 2.0, 3.0, 1.0};
+    auto schedule = RenderGraphScheduler::schedule(makeGraph(4, edges), times, 1);
+
+    validateSchedule(ctx, edges, times, 1, schedule);
+    EXPECT_EQ(schedule.makespan, 7.0);
+    EXPECT_EQ(schedule.serialTime, 7.0);
+    EXPECT(schedule.barriers.empty());
+}
+
+CPU_TEST(RenderGraphScheduler_ForkJoin)
+{
+    // Similar to the SVAO++ graph: G-buffer, then two independent AO branches, then a composite.
+    // 0: GBuffer, 1: SVAO, 2: SVAO2 (depends on 1), 3: Denoise (independent of AO), 4: Composite.
+    std::vector<std::pair<uint32_t, uint32_t>> edges = {{0, 1}, {1, 2}, {0, 3}, {2, 4}, {3, 4}};
+    std::vector<double> times = {2.0, 3.0, 2.0, 4.0, 1.0};
+    auto schedule = RenderGraphScheduler::schedule(makeGraph(5, edges), times, 2);
+
+    validateSchedule(ctx, edges, times, 2, schedule);
+    EXPECT_EQ(schedule.serialTime, 12.0);
+    EXPECT_EQ(schedule.makespan, 8.0);
+    EXPECT_NE(schedule.passes[1].queue, schedule.passes[3].queue);
+    EXPECT_EQ(schedule.passes[1].queue, schedule.passes[2].queue);
+
+    // One barrier to fork and one to join.
+    EXPECT_EQ(schedule.barriers.size(), 2);
+}
+
+CPU_TEST(RenderGraphScheduler_MinimalBarriers)
+{
+    // Pass 3 runs after the long pass 2 and also depends on 0 and 1, which run in order on the other queue.
+    // Only a wait on 1 is needed.
+    std::vector<std::pair<uint32_t, uint32_t>> edges = {{0, 1}, {0, 3}, {1, 3}, {2, 3}};
+    std::vector<double> times = {1.0, 1.0, 5.0, 1.0};
+    auto schedule = RenderGraphScheduler::schedule(makeGraph(4, edges), times, 2);
+
+    validateSchedule(ctx, edges, times, 2, schedule);
+    EXPECT_EQ(schedule.passes[0].queue, schedule.passes[1].queue);
+    EXPECT_EQ(schedule.passes[2].queue, schedule.passes[3].queue);
+    uint32_t barriersToPass3 = 0;
+    for (const auto& b : schedule.barriers)
+    {
+        if (b.dstPass == 3)
+        {
+            barriersToPass3++;
+            EXPECT_NE(b.srcPass, 0);
+        }
+    }
+    EXPECT_EQ(barriersToPass3, 1);
+}
+
+CPU_TEST(RenderGraphScheduler_Random)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> timeDist(0.1, 5.0);
+    std::uniform_int_distribution<uint32_t> edgeDist(0, 3);
+
+    for (uint32_t iteration = 0; iteration < 50; iteration++)
+    {
+        const uint32_t nodeCount = 20;
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        std::vector<double> times(nodeCount);
+        for (uint32_t i = 0; i < nodeCount; i++)
+        {
+            times[i] = timeDist(rng);
+            for (uint32_t j = 0; j < i; j++)
+                if (edgeDist(rng) == 0)
+                    edges.push_back({j, i});
+        }
+        auto graph = makeGraph(nodeCount, edges);
+
+        for (uint32_t queueCount = 1; queueCount <= 3; queueCount++)
+        {
+            auto schedule = RenderGraphScheduler::schedule(graph, times, queueCount);
+            validateSchedule(ctx, edges, times, queueCount, schedule);
+            EXPECT_LE(schedule.makespan, schedule.serialTime + 1e-9);
+
+            // Scheduling is deterministic.
+            auto schedule2 = RenderGraphScheduler::schedule(graph, times, queueCount);
+            EXPECT_EQ(schedule.makespan, schedule2.makespan);
+            EXPECT(schedule.queues == schedule2.queues);
+        }
+    }
+}
+
+CPU_TEST(RenderGraphScheduler_Cycle)
+{
+    auto graph = makeGraph(2, {{0, 1}, {1, 0}});
+    EXPECT_THROW(RenderGraphScheduler::schedule(graph, {1.0, 1.0}, 2));
+}
+} // namespace Falcor
@@ -0,0 +1,201 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "RenderGraph/ResourceAliasingPlanner.h"
+#include "RenderGraph/ResourceCache.h"
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+using Request = ResourceAliasingPlanner::Request;
+
+Request makeRequest(uint64_t size, uint32_t first, uint32_t last, uint32_t compatibilityClass = 0, bool aliasable = true)
+{
+    Request r;
+    r.size = size;
+    r.firstUse = first;
+    r.lastUse = last;
+    r.compatibilityClass = compatibilityClass;
+    r.aliasable = aliasable;
+    return r;
+}
+
+void validatePlan(CPUUnitTestContext& ctx, const std::vector<Request>& requests, const ResourceAliasingPlanner::Plan& plan)
+{
+    ASSERT_EQ(plan.slotOfRequest.size(), requests.size());
+
+    uint64_t unaliasedBytes = 0;
+    uint64_t aliasedBytes = 0;
+    for (uint32_t i = 0; i < requests.size(); i++)
+    {
+        ASSERT_LT(plan.slotOfRequest[i], plan.slots.size());
+        unaliasedBytes += requests[i].size;
+    }
+
+    for (const auto& slot : plan.slots)
+    {
+        aliasedBytes += slot.size;
+        for (size_t a = 0; a < slot.requests.size(); a++)
+        {
+            const auto& ra = requests[slot.requests[a]];
+            EXPECT_EQ(ra.compatibilityClass, slot.compatibilityClass);
+            EXPECT_LE(ra.size, slot.size);
+            if (slot.requests.size() > 1)
+                EXPECT(ra.aliasable);
+            for (size_t b = a + 1; b < slot.requests.size(); b++)
+            {
+                const auto& rb = requests[slot.requests[b]];
+                bool overlap = ra.firstUse <= rb.lastUse && rb.firstUse <= ra.lastUse;
+                EXPECT(!overlap) << fmt::format("Requests {} and {} overlap", slot.requests[a], slot.requests[b]);
+            }
+        }
+    }
+
+    EXPECT_EQ(plan.unaliasedBytes, unaliasedBytes);
+    EXPECT_EQ(plan.aliasedBytes, aliasedBytes);
+    EXPECT_LE(plan.aliasedBytes, plan.unaliasedBytes);
+}
+} // namespace
+
+CPU_TEST(ResourceAliasingPlanner_Basic)
+{
+    // Disjoint lifetimes share a slot.
+    {
+        std::vector<Request> requests = {makeRequest(100, 0, 1), makeRequest(100, 2, 3)};
+        auto plan = ResourceAliasingPlanner::plan(requests);
+        validatePlan(ctx, requests, plan);
+        EXPECT_EQ(plan.slots.size(), 1u);
+        EXPECT_EQ(plan.aliasedBytes, 100ull);
+    }
+
+    // Lifetimes touching at the same pass overlap.
+    {
+        std::vector<Request> requests = {makeRequest(100, 0, 1), makeRequest(100, 1, 2)};
+        auto plan = ResourceAliasingPlanner::plan(requests);
+        validatePlan(ctx, requests, plan);
+        EXPECT_EQ(plan.slots.size(), 2u);
+    }
+
+    // Different compatibility classes never share.
+    {
+        std::vector<Request> requests = {makeRequest(100, 0, 0, 0), makeRequest(100, 1, 1, 1)};
+        auto plan = ResourceAliasingPlanner::plan(requests);
+        validatePlan(ctx, requests, plan);
+        EXPECT_EQ(plan.slots.size(), 2u);
+    }
+
+    // Non-aliasable resources get a dedicated slot.
+    {
+        std::vector<Request> requests = {makeRequest(100, 0, 0), makeRequest(100, 1, 1, 0, false), makeRequest(100, 2, 2)};
+        auto plan = ResourceAliasingPlanner::plan(requests);
+        validatePlan(ctx, requests, plan);
+        EXPECT_EQ(plan.slots.size(), 2u);
+        EXPECT_EQ(plan.slotOfRequest[0], plan.slotOfRequest[2]);
+        EXPECT_NE(plan.slotOfRequest[0], plan.slotOfRequest[1]);
+    }
+
+    // Smaller resources fill in the gaps of larger ones.
+    {
+        std::vector<Request> requests = {makeRequest(10, 0, 0), makeRequest(1000, 1, 4), makeRequest(20, 5, 5), makeRequest(30, 0, 5)};
+        auto plan = ResourceAliasingPlanner::plan(requests);
+        validatePlan(ctx, requests, plan);
+        EXPECT_EQ(plan.slots.size(), 2u);
+        EXPECT_EQ(plan.aliasedBytes, 1030ull);
+    }
+}
+
+CPU_TEST(ResourceAliasingPlanner_Randomized)
+{
+    std::mt19937 rng(1234);
+    for (uint32_t run = 0; run < 50; run++)
+    {
+        const uint32_t passCount = 1 + rng() % 32;
+        std::vector<Request> requests(rng() % 64);
+        for (auto& r : requests)
+        {
+            uint32_t a = rng() % passCount;
+            uint32_t b = rng() % passCount;
+            r = makeRequest(1 + rng() % 4096, std::min(a, b), std::max(a, b), rng() % 3, rng() % 8 != 0);
+        }
+
+        auto plan = ResourceAliasingPlanner::plan(requests);
+        validatePlan(ctx, requests, plan);
+
+        // Planning is deterministic.
+        auto plan2 = ResourceAliasingPlanner::plan(requests);
+        EXPECT(plan.slotOfRequest == plan2.slotOfRequest);
+    }
+}
+
+CPU_TEST(ResourceAliasingPlanner_ResourceCache)
+{
+    // Chain A -> B -> C -> D, all outputs have the same desc. D.out is a graph output.
+    ResourceCache cache;
+    const ResourceCache::DefaultProperties defaultProps = {uint2(64, 64), ResourceFormat::RGBA16Float};
+    const char* kPasses[] = {"A", "B", "C", "D"};
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        std::string pass = kPasses[i];
+        if (i > 0)
+        {
+            RenderPassReflection::Field in("in", "", RenderPassReflection::Field::Visibility::Input);
+            cache.registerField(pass + ".in", in, i, std::string(kPasses[i - 1]) + ".out");
+        }
+        RenderPassReflection::Field out("out", "", RenderPassReflection::Field::Visibility::Output);
+        cache.registerField(pass + ".out", out, i == 3 ? uint32_t(-1) : i);
+    }
+
+    // Internal and persistent resources are never aliased.
+    RenderPassReflection::Field scratch("scratch", "", RenderPassReflection::Field::Visibility::Internal);
+    cache.registerField("C.scratch", scratch, 2);
+    RenderPassReflection::Field history("history", "", RenderPassReflection::Field::Visibility::Output);
+    history.flags(RenderPassReflection::Field::Flags::Persistent);
+    cache.registerField("A.history", history, 0);
+
+    auto plan = cache.planAliasing(defaultProps);
+    ASSERT_EQ(plan.slotOfRequest.size(), 6u);
+
+    // Registration order: A.out, B.out, C.out, D.out, C.scratch, A.history.
+    const auto& slots = plan.slotOfRequest;
+    EXPECT_EQ(slots[0], slots[2]);
+    EXPECT_NE(slots[0], slots[1]);
+    EXPECT_NE(slots[1], slots[3]);
+    EXPECT_NE(slots[0], slots[3]);
+    EXPECT_NE(slots[4], slots[0]);
+    EXPECT_NE(slots[4], slots[1]);
+    EXPECT_NE(slots[5], slots[1]);
+    EXPECT_NE(slots[5], slots[2]);
+
+    const uint64_t kSize = 64ull * 64 * 8;
+    EXPECT_EQ(plan.unaliasedBytes, 6 * kSize);
+    EXPECT_EQ(plan.aliasedBytes, 5 * kSize);
+}
+} // namespace Falcor
@@ -0,0 +1,221 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Plugin.h"
+#include "Scene/ImporterError.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Scene.h"
+#include "Scene/SceneBuilderDump.h"
+#include <algorithm>
+#include <fstream>
+#include <set>
+
+namespace Falcor
+{
+namespace
+{
+bool loadImporter(const std::string& name)
+{
+    try
+    {
+        PluginManager::instance().loadPluginByName(name);
+        return true;
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+}
+
+void writeFile(const std::filesystem::path& path, const std::string& text)
+{
+    std::ofstream(path) << text;
+}
+
+template<typename T>
+void writeBinaryFile(const std::filesystem::path& path, const std::vector<T>& data)
+{
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+}
+
+/// Get the material names of all meshes from the debug content of a scene builder.
+std::multiset<std::string> getMeshMaterials(const SceneBuilder& builder)
+{
+    std::multiset<std::string> materials;
+    const std::string prefix = "   material: ";
+    for (const auto& [key, content] : SceneBuilderDump::getDebugContent(builder))
+    {
+        size_t pos = 0;
+        while ((pos = content.find(prefix, pos)) != std::string::npos)
+        {
+            pos += prefix.size();
+            materials.insert(content.substr(pos, content.find('\n', pos) - pos));
+        }
+    }
+    return materials;
+}
+} // namespace
+
+GPU_TEST(PBRTImporter_ImportInheritsMaterial)
+{
+    if (!loadImporter("PBRTImporter"))
+        ctx.skip("PBRTImporter plugin is not available");
+
+    // The imported file uses the unnamed material set before the Import directive, then defines its own.
+    const auto dir = getRuntimeDirectory() / "test_pbrt_import";
+    std::filesystem::create_directories(dir);
+    writeFile(
+        dir / "main.pbrt",
+        "WorldBegin\n"
+        "Material \"diffuse\" \"rgb reflectance\" [0.8 0.1 0.1]\n"
+        "Material \"diffuse\" \"rgb reflectance\" [0.1 0.8 0.1]\n"
+        "Import \"shapes.pbrt\"\n"
+    );
+    writeFile(
+        dir / "shapes.pbrt",
+        "Shape \"trianglemesh\" \"point3 P\" [0 0 0 1 0 0 0 1 0] \"integer indices\" [0 1 2]\n"
+        "Material \"diffuse\" \"rgb reflectance\" [0.1 0.1 0.8]\n"
+        "Shape \"trianglemesh\" \"point3 P\" [0 0 1 1 0 1 0 1 1] \"integer indices\" [0 1 2]\n"
+    );
+
+    SceneBuilder builder(ctx.getDevice(), dir / "main.pbrt", Settings());
+    EXPECT(getMeshMaterials(builder) == std::multiset<std::string>({"Unnamed1", "Unnamed2"}));
+
+    std::filesystem::remove_all(dir);
+}
+
+GPU_TEST(GltfImporter_TexCoords)
+{
+    if (!loadImporter("GltfImporter"))
+        ctx.skip("GltfImporter plugin is not available");
+
+    ref<Device> pDevice = ctx.getDevice();
+
+    // Single triangle, texture coordinates must be imported as stored in the file.
+    const auto dir = getRuntimeDirectory() / "test_gltf_texcoords";
+    std::filesystem::create_directories(dir);
+    const std::vector<float> positions = {0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f};
+    const std::vector<float> texCrds = {0.f, 0.f, 1.f, 0.f, 0.25f, 0.75f};
+    std::vector<float> bufferData = positions;
+    bufferData.insert(bufferData.end(), texCrds.begin(), texCrds.end());
+    writeBinaryFile(dir / "triangle.bin", bufferData);
+    writeFile(
+        dir / "triangle.gltf",
+        R"({
+            "asset": { "version": "2.0" },
+            "scene": 0,
+            "scenes": [{ "nodes": [0] }],
+            "nodes": [{ "mesh": 0 }],
+            "meshes": [{ "primitives": [{ "attributes": { "POSITION": 0, "TEXCOORD_0": 1 } }] }],
+            "buffers": [{ "uri": "triangle.bin", "byteLength": 60 }],
+            "bufferViews": [
+                { "buffer": 0, "byteOffset": 0, "byteLength": 36 },
+                { "buffer": 0, "byteOffset": 36, "byteLength": 24 }
+            ],
+            "accessors": [
+                { "bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3", "min": [0, 0, 0], "max": [1, 1, 0] },
+                { "bufferView": 1, "componentType": 5126, "count": 3, "type": "VEC2" }
+            ]
+        })"
+    );
+
+    ref<Scene> pScene;
+    {
+        SceneBuilder builder(pDevice, dir / "triangle.gltf", Settings());
+        pScene = builder.getScene();
+    }
+    ASSERT(pScene);
+    ASSERT_EQ(pScene->getMeshCount(), 1u);
+
+    const auto& meshDesc = pScene->getMesh(MeshID{0});
+    ASSERT_EQ(meshDesc.vertexCount, 3u);
+    std::map<std::string, ref<Buffer>> buffers = {
+        {"positions", pDevice->createStructuredBuffer(sizeof(float3), meshDesc.vertexCount)},
+        {"texcrds", pDevice->createStructuredBuffer(sizeof(float3), meshDesc.vertexCount)},
+        {"triangleIndices", pDevice->createStructuredBuffer(sizeof(uint3), meshDesc.getTriangleCount())},
+    };
+    pScene->getMeshVerticesAndIndices(MeshID{0}, buffers);
+
+    // The scene builder may reorder vertices, match them by position.
+    std::vector<float3> resultPositions = buffers["positions"]->getElements<float3>();
+    std::vector<float3> resultTexCrds = buffers["texcrds"]->getElements<float3>();
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        const float3 position(positions[i * 3 + 0], positions[i * 3 + 1], positions[i * 3 + 2]);
+        const float2 texCrd(texCrds[i * 2 + 0], texCrds[i * 2 + 1]);
+        auto it = std::find_if(resultPositions.begin(), resultPositions.end(), [&](const float3& p) { return all(p == position); });
+        ASSERT(it != resultPositions.end()) << "i = " << i;
+        const float3 result = resultTexCrds[it - resultPositions.begin()];
+        EXPECT_EQ(result.x, texCrd.x) << "i = " << i;
+        EXPECT_EQ(result.y, texCrd.y) << "i = " << i;
+    }
+
+    pScene.reset();
+    std::filesystem::remove_all(dir);
+}
+
+GPU_TEST(GltfImporter_SparseAccessorOutOfRange)
+{
+    if (!loadImporter("GltfImporter"))
+        ctx.skip("GltfImporter plugin is not available");
+
+    ref<Device> pDevice = ctx.getDevice();
+
+    // Sparse accessor whose index data starts past the end of its buffer view.
+    const auto dir = getRuntimeDirectory() / "test_gltf_sparse";
+    std::filesystem::create_directories(dir);
+    const std::vector<float> positions = {0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f};
+    writeBinaryFile(dir / "triangle.bin", positions);
+    writeFile(
+        dir / "triangle.gltf",
+        R"({
+            "asset": { "version": "2.0" },
+            "scene": 0,
+            "scenes": [{ "nodes": [0] }],
+            "nodes": [{ "mesh": 0 }],
+            "meshes": [{ "primitives": [{ "attributes": { "POSITION": 0 } }] }],
+            "buffers": [{ "uri": "triangle.bin", "byteLength": 36 }],
+            "bufferViews": [{ "buffer": 0, "byteOffset": 0, "byteLength": 36 }],
+            "accessors": [
+                {
+                    "bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3", "min": [0, 0, 0], "max": [1, 1, 0],
+                    "sparse": {
+                        "count": 1,
+                        "indices": { "bufferView": 0, "byteOffset": 1000000, "componentType": 5125 },
+                        "values": { "bufferView": 0 }
+                    }
+                }
+            ]
+        })"
+    );
+
+    EXPECT_THROW_AS(SceneBuilder(pDevice, dir / "triangle.gltf", Settings()), ImporterError);
+
+    std::filesystem::remove_all(dir);
+}
+} // namespace Falcor
@@ -0,0 +1,205 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Platform/OS.h"
+#include "Scene/LoopSubdivide.h"
+#include "Utils/Logger.h"
+#include "Utils/Math/FNVHash.h"
+#include <chrono>
+#include <cmath>
+
+namespace Falcor
+{
+namespace
+{
+struct Mesh
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+};
+
+Mesh createIcosahedron()
+{
+    const float t = (1.f + std::sqrt(5.f)) / 2.f;
+    Mesh mesh;
+    mesh.positions = {
+        {-1, t, 0}, {1, t, 0}, {-1, -t, 0}, {1, -t, 0}, {0, -1, t}, {0, 1, t},
+        {0, -1, -t}, {0, 1, -t}, {t, 0, -1}, {t, 0, 1}, {-t, 0, -1}, {-t, 0, 1},
+    };
+    mesh.indices = {
+        0, 11, 5,  0, 5,  1, 0, 1, 7, 0, 7,  10, 0, 10, 11, 1, 5, 9, 5, 11, 4,  11, 10, 2, 10, 7, 6, 7, 1, 8,
+        3, 9,  4,  3, 4,  2, 3, 2, 6, 3, 6,  8,  3, 8,  9,  4, 9, 5, 2, 4,  11, 6,  2,  10, 8,  6, 7, 9, 8, 1,
+    };
+    return mesh;
+}
+
+/// Create a flat grid of n x n quads with alternating diagonals. With holes enabled, some quads are left out.
+Mesh createGrid(uint32_t n, bool holes)
+{
+    Mesh mesh;
+    std::vector<uint32_t> vertexIndices((n + 1) * (n + 1), uint32_t(-1));
+    auto vertex = [&](uint32_t x, uint32_t y)
+    {
+        uint32_t& index = vertexIndices[y * (n + 1) + x];
+        if (index == uint32_t(-1))
+        {
+            index = uint32_t(mesh.positions.size());
+            mesh.positions.push_back(float3(float(x), float(y), 0.f));
+        }
+        return index;
+    };
+    for (uint32_t y = 0; y < n; ++y)
+    {
+        for (uint32_t x = 0; x < n; ++x)
+        {
+            if (holes && (x * 7 + y * 13) % 11 == 0)
+                continue;
+            uint32_t a = vertex(x, y), b = vertex(x + 1, y), c = vertex(x, y + 1), d = vertex(x + 1, y + 1);
+            if ((x + y) % 2 == 0)
+                mesh.indices.insert(mesh.indices.end(), {a, b, d, a, d, c});
+            else
+                mesh.indices.insert(mesh.indices.end(), {a, b, c, b, d, c});
+        }
+    }
+    return mesh;
+}
+
+uint64_t hashIndices(const std::vector<uint32_t>& indices)
+{
+    FNVHash<uint64_t> hash;
+    hash.insert(indices.data(), indices.size() * sizeof(uint32_t));
+    return hash.get();
+}
+} // namespace
+
+CPU_TEST(LoopSubdivide_Triangle)
+{
+    std::vector<float3> positions = {float3(0.f, 0.f, 0.f), float3(1.f, 0.f, 0.f), float3(0.f, 1.f, 0.f)};
+    std::vector<uint32_t> indices = {0, 1, 2};
+    auto result = loopSubdivide(1, positions, indices);
+
+    // Even vertices come first, followed by the edge vertices. The center child is last.
+    std::vector<uint32_t> expectedIndices = {0, 3, 5, 3, 1, 4, 5, 4, 2, 3, 4, 5};
+    EXPECT(result.indices == expectedIndices);
+    ASSERT_EQ(result.positions.size(), 6);
+    ASSERT_EQ(result.normals.size(), 6);
+
+    const float3 expectedPositions[] = {{0.175f, 0.175f, 0.f}, {0.65f, 0.175f, 0.f}, {0.175f, 0.65f, 0.f},
+                                        {0.475f, 0.05f, 0.f},  {0.475f, 0.475f, 0.f}, {0.05f, 0.475f, 0.f}};
+    for (size_t i = 0; i < 6; ++i)
+    {
+        EXPECT_LE(length(result.positions[i] - expectedPositions[i]), 1e-6f) << "i = " << i;
+        EXPECT_LT(result.normals[i].z, 0.f) << "i = " << i;
+        EXPECT_EQ(result.normals[i].x, 0.f) << "i = " << i;
+        EXPECT_EQ(result.normals[i].y, 0.f) << "i = " << i;
+    }
+}
+
+CPU_TEST(LoopSubdivide_Topology)
+{
+    // Reference hashes of the index lists generated by the previous implementation based on pbrt's SDVertex/SDFace structures.
+    struct TestCase
+    {
+        const char* name;
+        Mesh mesh;
+        uint32_t levels;
+        size_t vertexCount;
+        size_t triangleCount;
+        uint64_t hash;
+    };
+    TestCase testCases[] = {
+        {"icosahedron", createIcosahedron(), 1, 42, 80, 0x150bd070b58f66c5ull},
+        {"icosahedron", createIcosahedron(), 3, 642, 1280, 0xf99d60241f543ab1ull},
+        {"grid", createGrid(8, false), 1, 289, 512, 0x0193cec1190ffc56ull},
+        {"grid", createGrid(8, false), 3, 4225, 8192, 0xcf8254b80fe5097dull},
+        {"holes", createGrid(12, true), 1, 599, 1040, 0x572d101e2ae92bb2ull},
+        {"holes", createGrid(12, true), 2, 2247, 4160, 0xa9d567fbe1750d74ull},
+        {"holes", createGrid(12, true), 3, 8663, 16640, 0xc81320c50f1fcbd5ull},
+    };
+
+    for (const auto& testCase : testCases)
+    {
+        auto result = loopSubdivide(testCase.levels, testCase.mesh.positions, testCase.mesh.indices);
+        EXPECT_EQ(result.positions.size(), testCase.vertexCount) << testCase.name << " levels = " << testCase.levels;
+        EXPECT_EQ(result.normals.size(), testCase.vertexCount) << testCase.name << " levels = " << testCase.levels;
+        EXPECT_EQ(result.indices.size(), testCase.triangleCount * 3) << testCase.name << " levels = " << testCase.levels;
+        EXPECT(hashIndices(result.indices) == testCase.hash) << testCase.name << " levels = " << testCase.levels;
+    }
+}
+
+CPU_TEST(LoopSubdivide_Surface)
+{
+    // The limit surface of a flat grid stays flat.
+    Mesh grid = createGrid(12, true);
+    auto result = loopSubdivide(2, grid.positions, grid.indices);
+    for (size_t i = 0; i < result.positions.size(); ++i)
+    {
+        EXPECT_EQ(result.positions[i].z, 0.f) << "i = " << i;
+        EXPECT_EQ(result.normals[i].x, 0.f) << "i = " << i;
+        EXPECT_EQ(result.normals[i].y, 0.f) << "i = " << i;
+    }
+
+    // The limit surface of a closed mesh is smooth and all normals are on the same side.
+    Mesh icosahedron = createIcosahedron();
+    result = loopSubdivide(2, icosahedron.positions, icosahedron.indices);
+    for (size_t i = 0; i < result.positions.size(); ++i)
+        EXPECT_LT(dot(result.normals[i], result.positions[i]), 0.f) << "i = " << i;
+
+    // Unreferenced vertices are passed through.
+    icosahedron.positions.push_back(float3(10.f));
+    result = loopSubdivide(2, icosahedron.positions, icosahedron.indices);
+    EXPECT(all(result.positions[12] == float3(10.f)));
+
+    // Out of range vertex indices are an error.
+    icosahedron.indices.insert(icosahedron.indices.end(), {0, 1, 13});
+    EXPECT_THROW(loopSubdivide(1, icosahedron.positions, icosahedron.indices));
+}
+
+CPU_TEST(LoopSubdivide_Benchmark)
+{
+    // Benchmark, only runs when FALCOR_RUN_BENCHMARKS is set.
+    if (!getEnvironmentVariable("FALCOR_RUN_BENCHMARKS"))
+        ctx.skip("FALCOR_RUN_BENCHMARKS is not set");
+
+    Mesh grid = createGrid(32, true);
+    for (uint32_t levels = 1; levels <= 5; ++levels)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        auto result = loopSubdivide(levels, grid.positions, grid.indices);
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        EXPECT_EQ(result.indices.size(), grid.indices.size() << (2 * levels));
+        logInfo(
+            "LoopSubdivide: level {}, {} triangles, {} vertices, {:.1f} ms",
+            levels,
+            result.indices.size() / 3,
+            result.positions.size(),
+            time * 1000.0
+        );
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,82 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Material/MaterialSystem.h"
+#include "Scene/Material/StandardMaterial.h"
+#include <random>
+
+namespace Falcor
+{
+GPU_TEST(MaterialSystem_OptimizeTextures)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    const uint32_t kSize = 16;
+    std::vector<uint8_t> noise(kSize * kSize * 4);
+    std::mt19937 rng(1);
+    for (auto& v : noise)
+        v = uint8_t(rng());
+    std::vector<uint8_t> constant(kSize * kSize * 4, 128);
+
+    // Two separate textures with identical content, and a constant texture.
+    auto pNoiseA = pDevice->createTexture2D(kSize, kSize, ResourceFormat::RGBA8Unorm, 1, 1, noise.data());
+    auto pNoiseB = pDevice->createTexture2D(kSize, kSize, ResourceFormat::RGBA8Unorm, 1, 1, noise.data());
+    auto pConstant = pDevice->createTexture2D(kSize, kSize, ResourceFormat::RGBA8Unorm, 1, 1, constant.data());
+
+    MaterialSystem materials(pDevice);
+    auto pMaterialA = StandardMaterial::create(pDevice, "A");
+    pMaterialA->setBaseColorTexture(pNoiseA);
+    pMaterialA->setSpecularTexture(pConstant);
+    auto pMaterialB = StandardMaterial::create(pDevice, "B");
+    pMaterialB->setBaseColorTexture(pNoiseB);
+    pMaterialB->setSpecularTexture(pNoiseB);
+    materials.addMaterial(pMaterialA);
+    materials.addMaterial(pMaterialB);
+
+    auto& textureManager = materials.getTextureManager();
+    auto noiseHandle = textureManager.addTexture(pNoiseB);
+    auto constantHandle = textureManager.addTexture(pConstant);
+
+    materials.optimizeMaterials();
+
+    // Duplicates are merged into the first texture.
+    EXPECT(pMaterialA->getBaseColorTexture() == pNoiseA);
+    EXPECT(pMaterialB->getBaseColorTexture() == pNoiseA);
+    EXPECT(pMaterialB->getSpecularTexture() == pNoiseA);
+
+    // Constant textures are folded into material parameters.
+    EXPECT(pMaterialA->getSpecularTexture() == nullptr);
+    float4 specular = pMaterialA->getSpecularParams();
+    EXPECT_LE(std::abs(specular.y - 128.f / 255.f), 1e-6f);
+    EXPECT_LE(std::abs(specular.z - 128.f / 255.f), 1e-6f);
+
+    // Textures no longer referenced are released from the texture manager.
+    EXPECT(!textureManager.getTextureDesc(noiseHandle).isValid());
+    EXPECT(!textureManager.getTextureDesc(constantHandle).isValid());
+}
+} // namespace Falcor
@@ -0,0 +1,84 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/MeshInstanceTable.h"
+
+namespace Falcor
+{
+namespace
+{
+float4x4 getInstanceTransform(uint32_t i)
+{
+    // Forest-like placement on a grid with varying rotation and scale.
+    float3 translation(float(i % 316) * 4.f, 0.f, float(i / 316) * 4.f);
+    float4x4 transform = math::matrixFromTranslation(translation);
+    transform = mul(transform, math::matrixFromRotationY(float(i) * 0.1f));
+    return mul(transform, math::matrixFromScaling(float3(1.f + float(i % 7) * 0.1f)));
+}
+} // namespace
+
+CPU_TEST(MeshInstanceTable_Instances)
+{
+    const uint32_t kInstanceCount = 100000;
+
+    // A tree made of three meshes and a rock made of one mesh.
+    MeshInstanceTable table;
+    const std::vector<MeshID> treeMeshIDs = {MeshID(0), MeshID(1), MeshID(2)};
+    const uint64_t treeTriangleCount = 20000 + 5000 + 120;
+    uint32_t tree = table.addDefinition("tree", treeMeshIDs, treeTriangleCount);
+    uint32_t rock = table.addDefinition("rock", {MeshID(3)}, 800);
+    EXPECT(table.empty());
+
+    for (uint32_t i = 0; i < kInstanceCount; ++i)
+        table.addInstance(i % 10 == 0 ? rock : tree, getInstanceTransform(i));
+
+    // The meshes of each definition are referenced once, instances only add a transform.
+    const auto& definitions = table.getDefinitions();
+    ASSERT_EQ(definitions.size(), 2);
+    EXPECT(definitions[tree].meshIDs == treeMeshIDs);
+    EXPECT_EQ(definitions[rock].meshIDs.size(), 1);
+    EXPECT_EQ(definitions[tree].transforms.size(), kInstanceCount / 10 * 9);
+    EXPECT_EQ(definitions[rock].transforms.size(), kInstanceCount / 10);
+    EXPECT(definitions[tree].name == "tree");
+
+    // Transforms are stored as 3x4 matrices and restore the original affine transform.
+    EXPECT(float4x4(definitions[tree].transforms[0]) == getInstanceTransform(1));
+    EXPECT(float4x4(definitions[rock].transforms.back()) == getInstanceTransform(kInstanceCount - 10));
+
+    auto stats = table.getStats();
+    EXPECT_EQ(stats.definitionCount, 2);
+    EXPECT_EQ(stats.meshCount, 4);
+    EXPECT_EQ(stats.instanceCount, kInstanceCount);
+    EXPECT_EQ(stats.uniqueTriangleCount, treeTriangleCount + 800);
+    EXPECT_EQ(stats.instancedTriangleCount, treeTriangleCount * (kInstanceCount / 10 * 9) + 800 * (kInstanceCount / 10));
+    EXPECT_EQ(stats.transformMemoryInBytes, kInstanceCount * sizeof(float3x4));
+    EXPECT(!table.empty());
+
+    EXPECT_THROW(table.addInstance(2, float4x4::identity()));
+}
+} // namespace Falcor
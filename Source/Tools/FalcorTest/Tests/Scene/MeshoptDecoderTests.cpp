@@ -0,0 +1,191 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/MeshoptDecoder.h"
+#include <cstring>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+// Reference streams from the meshoptimizer test suite.
+const uint8_t kIndexDataV0[] = {
+    0xe0, 0xf0, 0x10, 0xfe, 0xff, 0xf0, 0x0c, 0xff, 0x02, 0x02, 0x02, 0x00, 0x76, 0x87,
+    0x56, 0x67, 0x78, 0xa9, 0x86, 0x65, 0x89, 0x68, 0x98, 0x01, 0x69, 0x00, 0x00,
+};
+
+const uint32_t kIndexBuffer[] = {0, 1, 2, 2, 1, 3, 4, 6, 5, 7, 8, 9};
+
+const uint8_t kIndexSequenceData[] = {0xd1, 0x00, 0x04, 0xcd, 0x01, 0x04, 0x07, 0x98, 0x1f, 0x00, 0x00, 0x00, 0x00};
+
+const uint32_t kIndexSequence[] = {0, 1, 51, 2, 49, 1000};
+
+const uint8_t kVertexDataV0[] = {
+    0xa0, 0x01, 0x3f, 0x00, 0x00, 0x00, 0x58, 0x57, 0x58, 0x01, 0x26, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x00,
+    0x00, 0x00, 0x58, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x3f, 0x00, 0x00, 0x00,
+    0x17, 0x18, 0x17, 0x01, 0x26, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x00, 0x00, 0x00, 0x17, 0x01, 0x08, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// Version 1 stream where the last triangle uses the +1 delta code for its free vertex (0x1e) instead of an explicit varint.
+const uint8_t kIndexDataV1[] = {
+    0xe1, 0xf0, 0x10, 0xfe, 0x1e, 0xf0, 0x0c, 0x00, 0x76, 0x87, 0x56, 0x67,
+    0x78, 0xa9, 0x86, 0x65, 0x89, 0x68, 0x98, 0x01, 0x69, 0x00, 0x00,
+};
+
+const uint32_t kIndexBufferV1[] = {0, 1, 2, 2, 1, 3, 4, 6, 5, 5, 6, 7};
+
+struct PackedVertex
+{
+    uint16_t pos[3];
+    uint8_t normal[2];
+    uint16_t texCoord[2];
+};
+static_assert(sizeof(PackedVertex) == 12);
+
+const PackedVertex kVertexBuffer[] = {
+    {{0, 0, 0}, {0, 0}, {0, 0}},
+    {{300, 0, 0}, {0, 0}, {500, 0}},
+    {{0, 300, 0}, {0, 0}, {0, 500}},
+    {{300, 300, 0}, {0, 0}, {500, 500}},
+};
+
+template<typename T, size_t N>
+void expectEqual(CPUUnitTestContext& ctx, const std::vector<T>& result, const T (&expected)[N])
+{
+    ASSERT_EQ(result.size(), N);
+    for (size_t i = 0; i < N; i++)
+        EXPECT_EQ(result[i], expected[i]) << "i = " << i;
+}
+} // namespace
+
+CPU_TEST(MeshoptDecoder_IndexBuffer)
+{
+    std::vector<uint32_t> indices(std::size(kIndexBuffer));
+    decodeMeshoptIndexBuffer(indices.data(), indices.size(), sizeof(uint32_t), kIndexDataV0, sizeof(kIndexDataV0));
+    expectEqual(ctx, indices, kIndexBuffer);
+
+    std::vector<uint16_t> indices16(std::size(kIndexBuffer));
+    decodeMeshopt(
+        MeshoptMode::Triangles, MeshoptFilter::None, indices16.data(), indices16.size(), sizeof(uint16_t), kIndexDataV0, sizeof(kIndexDataV0)
+    );
+    for (size_t i = 0; i < indices16.size(); i++)
+        EXPECT_EQ(indices16[i], kIndexBuffer[i]) << "i = " << i;
+
+    decodeMeshoptIndexBuffer(indices.data(), indices.size(), sizeof(uint32_t), kIndexDataV1, sizeof(kIndexDataV1));
+    expectEqual(ctx, indices, kIndexBufferV1);
+}
+
+CPU_TEST(MeshoptDecoder_IndexSequence)
+{
+    std::vector<uint32_t> indices(std::size(kIndexSequence));
+    decodeMeshopt(
+        MeshoptMode::Indices, MeshoptFilter::None, indices.data(), indices.size(), sizeof(uint32_t), kIndexSequenceData, sizeof(kIndexSequenceData)
+    );
+    expectEqual(ctx, indices, kIndexSequence);
+}
+
+CPU_TEST(MeshoptDecoder_VertexBuffer)
+{
+    std::vector<PackedVertex> vertices(std::size(kVertexBuffer));
+    decodeMeshopt(
+        MeshoptMode::Attributes, MeshoptFilter::None, vertices.data(), vertices.size(), sizeof(PackedVertex), kVertexDataV0, sizeof(kVertexDataV0)
+    );
+    EXPECT_EQ(std::memcmp(vertices.data(), kVertexBuffer, sizeof(kVertexBuffer)), 0);
+}
+
+CPU_TEST(MeshoptDecoder_FilterOctahedral)
+{
+    std::vector<int8_t> data8 = {0, 1, 127, 0, 0, -69, 127, 1, -1, 1, 127, 0, 14, -126, 127, 1};
+    const int8_t expected8[] = {0, 1, 127, 0, 0, -97, 82, 1, -1, 1, 127, 0, 1, -126, -15, 1};
+    applyMeshoptFilter(MeshoptFilter::Octahedral, data8.data(), 4, 4);
+    expectEqual(ctx, data8, expected8);
+
+    std::vector<int16_t> data16 = {0, 1, 2047, 0, 0, 1870, 2047, 1, 2017, 1, 2047, 0, 14, 1300, 2047, 1};
+    const int16_t expected16[] = {0, 16, 32767, 0, 0, 32621, 3088, 1, 32764, 16, 471, 0, 307, 28541, 16093, 1};
+    applyMeshoptFilter(MeshoptFilter::Octahedral, data16.data(), 4, 8);
+    expectEqual(ctx, data16, expected16);
+}
+
+CPU_TEST(MeshoptDecoder_FilterQuaternion)
+{
+    std::vector<int16_t> data = {0, 1, 0, 0x7fc, 0, 1870, 0, 0x7fd, 2017, 1, 0, 0x7fe, 14, 1300, 0, 0x7ff};
+    const int16_t expected[] = {32767, 0, 11, 0, 0, 25013, 0, 21166, 11, 0, 23504, 22830, 158, 14715, 0, 29277};
+    applyMeshoptFilter(MeshoptFilter::Quaternion, data.data(), 4, 8);
+    expectEqual(ctx, data, expected);
+}
+
+CPU_TEST(MeshoptDecoder_FilterExponential)
+{
+    std::vector<uint32_t> data = {0, 0xff000003, 0x02fffff7, 0xfe7fffff};
+    const float expected[] = {0.f, 1.5f, -36.f, 2097151.75f};
+    applyMeshoptFilter(MeshoptFilter::Exponential, data.data(), 4, 4);
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        float value;
+        std::memcpy(&value, &data[i], sizeof(float));
+        EXPECT_EQ(value, expected[i]) << "i = " << i;
+    }
+}
+
+CPU_TEST(MeshoptDecoder_Invalid)
+{
+    std::vector<uint32_t> indices(std::size(kIndexBuffer));
+    std::vector<PackedVertex> vertices(std::size(kVertexBuffer));
+
+    // Truncated streams.
+    for (size_t size = 0; size < sizeof(kIndexDataV0); size++)
+        EXPECT_THROW(decodeMeshoptIndexBuffer(indices.data(), indices.size(), sizeof(uint32_t), kIndexDataV0, size));
+    for (size_t size = 0; size < sizeof(kIndexSequenceData); size++)
+        EXPECT_THROW(decodeMeshoptIndexSequence(indices.data(), std::size(kIndexSequence), sizeof(uint32_t), kIndexSequenceData, size));
+    for (size_t size = 0; size < sizeof(kVertexDataV0); size++)
+        EXPECT_THROW(decodeMeshoptVertexBuffer(vertices.data(), vertices.size(), sizeof(PackedVertex), kVertexDataV0, size));
+
+    // Invalid headers.
+    std::vector<uint8_t> data(std::begin(kIndexDataV0), std::end(kIndexDataV0));
+    data[0] = 0xe2;
+    EXPECT_THROW(decodeMeshoptIndexBuffer(indices.data(), indices.size(), sizeof(uint32_t), data.data(), data.size()));
+    EXPECT_THROW(decodeMeshoptVertexBuffer(vertices.data(), vertices.size(), sizeof(PackedVertex), kIndexDataV0, sizeof(kIndexDataV0)));
+
+    // Stream does not match the element count.
+    EXPECT_THROW(decodeMeshoptIndexBuffer(indices.data(), 9, sizeof(uint32_t), kIndexDataV0, sizeof(kIndexDataV0)));
+    vertices.resize(300);
+    EXPECT_THROW(decodeMeshoptVertexBuffer(vertices.data(), vertices.size(), sizeof(PackedVertex), kVertexDataV0, sizeof(kVertexDataV0)));
+
+    // Invalid parameters.
+    EXPECT_THROW(decodeMeshoptIndexBuffer(indices.data(), 11, sizeof(uint32_t), kIndexDataV0, sizeof(kIndexDataV0)));
+    EXPECT_THROW(decodeMeshoptIndexBuffer(indices.data(), indices.size(), 1, kIndexDataV0, sizeof(kIndexDataV0)));
+    EXPECT_THROW(decodeMeshoptVertexBuffer(vertices.data(), vertices.size(), 6, kVertexDataV0, sizeof(kVertexDataV0)));
+    EXPECT_THROW(applyMeshoptFilter(MeshoptFilter::Quaternion, vertices.data(), 4, 4));
+    EXPECT_THROW(decodeMeshopt(
+        MeshoptMode::Triangles, MeshoptFilter::Octahedral, indices.data(), indices.size(), sizeof(uint32_t), kIndexDataV0, sizeof(kIndexDataV0)
+    ));
+}
+} // namespace Falcor
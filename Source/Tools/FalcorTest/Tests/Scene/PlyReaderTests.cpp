@@ -0,0 +1,308 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Platform/OS.h"
+#include "Scene/PlyReader.h"
+#include "Utils/Logger.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+const char kQuadAscii[] =
+    "ply\n"
+    "format ascii 1.0\n"
+    "comment unit quad\n"
+    "element vertex 4\n"
+    "property float x\n"
+    "property float y\n"
+    "property float z\n"
+    "property float u\n"
+    "property float v\n"
+    "element face 1\n"
+    "property list uchar int vertex_indices\n"
+    "end_header\n"
+    "0 0 0 0 0\n"
+    "1 0 0 1 0\n"
+    "1 1 0 1 1\n"
+    "0 1 0 0 1\n"
+    "4 0 1 2 3\n";
+
+template<typename T>
+void append(std::string& data, T value, bool bigEndian)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    if (bigEndian)
+        std::reverse(bytes, bytes + sizeof(T));
+    data.append(bytes, sizeof(T));
+}
+
+/// Create a binary PLY grid of (n + 1)^2 vertices with normals and n^2 * 2 triangles.
+std::string createGrid(uint32_t n, bool bigEndian)
+{
+    const uint32_t vertexCount = (n + 1) * (n + 1);
+    std::string data = fmt::format(
+        "ply\n"
+        "format {} 1.0\n"
+        "element vertex {}\n"
+        "property float x\nproperty float y\nproperty float z\n"
+        "property float nx\nproperty float ny\nproperty float nz\n"
+        "element face {}\n"
+        "property list uchar int vertex_indices\n"
+        "end_header\n",
+        bigEndian ? "binary_big_endian" : "binary_little_endian",
+        vertexCount,
+        n * n * 2
+    );
+    for (uint32_t y = 0; y <= n; ++y)
+    {
+        for (uint32_t x = 0; x <= n; ++x)
+        {
+            for (float value : {float(x), float(y), 0.f, 0.f, 0.f, 1.f})
+                append(data, value, bigEndian);
+        }
+    }
+    for (uint32_t y = 0; y < n; ++y)
+    {
+        for (uint32_t x = 0; x < n; ++x)
+        {
+            const int32_t i = int32_t(y * (n + 1) + x);
+            const int32_t triangles[2][3] = {{i, i + 1, i + int32_t(n) + 2}, {i, i + int32_t(n) + 2, i + int32_t(n) + 1}};
+            for (const auto& triangle : triangles)
+            {
+                append(data, uint8_t(3), bigEndian);
+                for (int32_t index : triangle)
+                    append(data, index, bigEndian);
+            }
+        }
+    }
+    return data;
+}
+
+ref<TriangleMesh> readString(const std::string& data, TriangleMesh::ImportFlags flags = TriangleMesh::ImportFlags::Default)
+{
+    return PlyReader::readFromMemory(data.data(), data.size(), flags);
+}
+
+void writeFile(const std::filesystem::path& path, const std::string& data)
+{
+    std::ofstream(path, std::ios::binary).write(data.data(), data.size());
+}
+} // namespace
+
+CPU_TEST(PlyReader_Ascii)
+{
+    auto pMesh = readString(kQuadAscii);
+    ASSERT(pMesh);
+
+    // The quad is triangulated as a fan. No normals in the file, so face normals are generated on unshared vertices.
+    const auto& vertices = pMesh->getVertices();
+    const auto& indices = pMesh->getIndices();
+    ASSERT_EQ(indices.size(), 6);
+    ASSERT_EQ(vertices.size(), 6);
+    for (const auto& vertex : vertices)
+        EXPECT(all(vertex.normal == float3(0.f, 0.f, 1.f)));
+    EXPECT(all(vertices[indices[2]].position == float3(1.f, 1.f, 0.f)));
+    EXPECT(all(vertices[indices[5]].position == float3(0.f, 1.f, 0.f)));
+
+    // Texture coordinates are flipped vertically like in TriangleMesh::createFromFile().
+    EXPECT(all(vertices[indices[1]].texCoord == float2(1.f, 1.f)));
+    EXPECT(all(vertices[indices[2]].texCoord == float2(1.f, 0.f)));
+
+    // Smooth normals keep the vertices shared.
+    pMesh = readString(kQuadAscii, TriangleMesh::ImportFlags::GenSmoothNormals);
+    ASSERT(pMesh);
+    EXPECT_EQ(pMesh->getVertices().size(), 4);
+    EXPECT(all(pMesh->getVertices()[3].normal == float3(0.f, 0.f, 1.f)));
+}
+
+CPU_TEST(PlyReader_JoinIdenticalVertices)
+{
+    // Two triangles of a quad stored with unshared vertices, plus an unreferenced vertex.
+    const std::string data =
+        "ply\n"
+        "format ascii 1.0\n"
+        "element vertex 7\n"
+        "property float x\nproperty float y\nproperty float z\n"
+        "element face 2\n"
+        "property list uchar int vertex_indices\n"
+        "end_header\n"
+        "0 0 0\n1 0 0\n1 1 0\n"
+        "0 0 0\n1 1 0\n0 1 0\n"
+        "5 5 5\n"
+        "3 0 1 2\n"
+        "3 3 4 5\n";
+
+    auto pMesh = readString(data, TriangleMesh::ImportFlags::GenSmoothNormals);
+    ASSERT(pMesh);
+    EXPECT_EQ(pMesh->getVertices().size(), 7);
+
+    pMesh = readString(data, TriangleMesh::ImportFlags::GenSmoothNormals | TriangleMesh::ImportFlags::JoinIdenticalVertices);
+    ASSERT(pMesh);
+    const auto& vertices = pMesh->getVertices();
+    const auto& indices = pMesh->getIndices();
+    ASSERT_EQ(vertices.size(), 4);
+    ASSERT_EQ(indices.size(), 6);
+    EXPECT_EQ(indices[3], indices[0]);
+    EXPECT_EQ(indices[4], indices[2]);
+    EXPECT(all(vertices[indices[5]].position == float3(0.f, 1.f, 0.f)));
+    for (const auto& vertex : vertices)
+        EXPECT(all(vertex.normal == float3(0.f, 0.f, 1.f)));
+}
+
+CPU_TEST(PlyReader_Binary)
+{
+    for (bool bigEndian : {false, true})
+    {
+        auto pMesh = readString(createGrid(70, bigEndian));
+        ASSERT(pMesh);
+        const auto& vertices = pMesh->getVertices();
+        const auto& indices = pMesh->getIndices();
+        ASSERT_EQ(vertices.size(), 71 * 71);
+        ASSERT_EQ(indices.size(), 70 * 70 * 6);
+        EXPECT(all(vertices[71 * 3 + 5].position == float3(5.f, 3.f, 0.f)));
+        EXPECT(all(vertices[1234].normal == float3(0.f, 0.f, 1.f)));
+        EXPECT_EQ(indices[6 * 71 + 2], 72 + 72); // Cell (1, 1).
+        EXPECT_EQ(indices.back(), 70 * 71 + 69);
+    }
+}
+
+CPU_TEST(PlyReader_BinaryMixedTypes)
+{
+    // Double positions, an ignored uchar property and a non-triangle face in big endian.
+    std::string data =
+        "ply\n"
+        "format binary_big_endian 1.0\n"
+        "element vertex 4\n"
+        "property double x\nproperty double y\nproperty double z\nproperty uchar red\n"
+        "element face 1\n"
+        "property list uchar uint vertex_indices\n"
+        "element material 1\n"
+        "property float roughness\n"
+        "end_header\n";
+    const double positions[4][3] = {{0, 0, 0}, {2, 0, 0}, {2, 2, 0}, {0, 2, 0}};
+    for (const auto& p : positions)
+    {
+        for (double value : p)
+            append(data, value, true);
+        append(data, uint8_t(255), true);
+    }
+    append(data, uint8_t(4), true);
+    for (uint32_t index : {0u, 1u, 2u, 3u})
+        append(data, index, true);
+    append(data, 0.5f, true);
+
+    auto pMesh = readString(data, TriangleMesh::ImportFlags::GenSmoothNormals);
+    ASSERT(pMesh);
+    ASSERT_EQ(pMesh->getVertices().size(), 4);
+    ASSERT_EQ(pMesh->getIndices().size(), 6);
+    EXPECT(all(pMesh->getVertices()[2].position == float3(2.f, 2.f, 0.f)));
+    EXPECT(all(pMesh->getVertices()[2].normal == float3(0.f, 0.f, 1.f)));
+}
+
+CPU_TEST(PlyReader_Invalid)
+{
+    const std::string valid = createGrid(2, false);
+    EXPECT_THROW(readString(""));
+    EXPECT_THROW(readString("ply\nformat binary_little_endian 1.0\nelement vertex 1\n"));
+    EXPECT_THROW(readString("ply\nformat xml 1.0\nend_header\n"));
+    EXPECT_THROW(readString("ply\nformat ascii 1.0\nelement vertex 1\nproperty float x\nend_header\n0\n"));
+
+    // Integer properties in ASCII files must be integers.
+    std::string ascii = kQuadAscii;
+    ascii.replace(ascii.rfind("4 0 1 2 3"), 9, "4.5 0 1 2 3");
+    EXPECT_THROW(readString(ascii));
+    EXPECT_THROW(readString(valid.substr(0, valid.size() - 1)));
+
+    // Out of bounds index.
+    std::string data = valid;
+    data[data.size() - 4] = 100;
+    EXPECT_THROW(readString(data));
+
+    // File errors are reported as nullptr.
+    EXPECT(PlyReader::read(getRuntimeDirectory() / "missing.ply") == nullptr);
+    EXPECT(PlyReader::isPlyFile("mesh.PLY"));
+    EXPECT(PlyReader::isPlyFile("mesh.ply.gz"));
+    EXPECT(!PlyReader::isPlyFile("mesh.obj"));
+}
+
+CPU_TEST(PlyReader_Benchmark)
+{
+    // Compare against the Assimp based loader on a batch of files, similar to the mesh files of large PBRT scenes.
+    // Only runs when FALCOR_RUN_BENCHMARKS is set.
+    if (!getEnvironmentVariable("FALCOR_RUN_BENCHMARKS"))
+        ctx.skip("FALCOR_RUN_BENCHMARKS is not set");
+
+    const auto dir = getRuntimeDirectory() / "test_ply_reader";
+    std::filesystem::create_directories(dir);
+    std::vector<std::filesystem::path> paths;
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        paths.push_back(dir / fmt::format("mesh{}.ply", i));
+        writeFile(paths.back(), createGrid(256 + i, i % 2 == 1));
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    size_t assimpTriangles = 0;
+    for (const auto& path : paths)
+    {
+        if (auto pMesh = TriangleMesh::createFromFile(path))
+            assimpTriangles += pMesh->getIndices().size() / 3;
+    }
+    double assimpTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    startTime = std::chrono::steady_clock::now();
+    auto meshes = PlyReader::readFiles(paths);
+    double plyTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    size_t plyTriangles = 0;
+    for (uint32_t i = 0; i < meshes.size(); ++i)
+    {
+        ASSERT(meshes[i]);
+        EXPECT_EQ(meshes[i]->getIndices().size(), size_t(256 + i) * (256 + i) * 6);
+        plyTriangles += meshes[i]->getIndices().size() / 3;
+    }
+    EXPECT(assimpTriangles == 0 || assimpTriangles == plyTriangles);
+
+    logInfo(
+        "PlyReader: {} files, {} triangles, Assimp {:.1f} ms, PlyReader {:.1f} ms, speedup {:.1f}x",
+        paths.size(),
+        plyTriangles,
+        assimpTime * 1000.0,
+        plyTime * 1000.0,
+        assimpTime / plyTime
+    );
+
+    meshes.clear();
+    std::filesystem::remove_all(dir);
+}
+} // namespace Falcor
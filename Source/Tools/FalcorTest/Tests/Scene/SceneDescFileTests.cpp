@@ -0,0 +1,201 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Platform/OS.h"
+#include "Core/Plugin.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/SceneBuilderDump.h"
+#include "Scene/SceneDescFile.h"
+#include "Scene/TriangleMesh.h"
+#include "Scene/Lights/Light.h"
+#include "Scene/Material/StandardMaterial.h"
+#include <chrono>
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+float4x4 getObjectTransform(uint32_t i)
+{
+    return math::matrixFromTranslation(float3(float(i % 100) * 2.f, float(i / 10000) * 2.f, float((i / 100) % 100) * 2.f));
+}
+
+void addTestContent(SceneBuilder& builder)
+{
+    ref<TriangleMesh> pCube = TriangleMesh::createCube();
+    ref<TriangleMesh> pSphere = TriangleMesh::createSphere(0.5f, 16, 8);
+
+    std::vector<MeshID> meshIDs;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        ref<StandardMaterial> pMaterial = StandardMaterial::create(builder.getDevice(), fmt::format("Material{}", i));
+        pMaterial->setBaseColor(float4(0.2f * i, 0.5f, 0.8f, 1.f));
+        pMaterial->setRoughness(0.25f * i);
+        meshIDs.push_back(builder.addTriangleMesh(i % 2 == 0 ? pCube : pSphere, pMaterial));
+    }
+
+    SceneBuilder::Node root;
+    root.name = "Root";
+    NodeID rootID = builder.addNode(root);
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        SceneBuilder::Node node;
+        node.name = fmt::format("Object{}", i);
+        node.transform = getObjectTransform(i);
+        node.parent = rootID;
+        builder.addMeshInstance(builder.addNode(node), meshIDs[i % meshIDs.size()]);
+    }
+
+    ref<Camera> pCamera = Camera::create("Camera");
+    pCamera->setPosition(float3(10.f, 5.f, 10.f));
+    builder.addCamera(pCamera);
+
+    ref<PointLight> pLight = PointLight::create("Light");
+    pLight->setIntensity(float3(10.f));
+    pLight->setNodeID(rootID);
+    builder.addLight(pLight);
+}
+} // namespace
+
+GPU_TEST(SceneDescFile_RoundTrip)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    const auto path = getRuntimeDirectory() / "test_scene_desc.fscene";
+
+    SceneBuilder builder(pDevice, Settings());
+    addTestContent(builder);
+    builder.getMetadata().samplesPerPixel = 16;
+    builder.setCameraSpeed(2.f);
+    SceneDescFile::write(builder, path);
+
+    // Read into an empty builder.
+    SceneBuilder loaded(pDevice, Settings());
+    SceneDescFile::read(path, loaded);
+    EXPECT_EQ(loaded.getNodeCount(), builder.getNodeCount());
+    EXPECT_EQ(loaded.getMaterials().size(), builder.getMaterials().size());
+    EXPECT_EQ(loaded.getCameras().size(), 1u);
+    ASSERT_EQ(loaded.getLights().size(), 1u);
+    EXPECT(loaded.getLights()[0]->getNodeID() == NodeID(0));
+    EXPECT(loaded.getMetadata().samplesPerPixel == 16u);
+    EXPECT_EQ(loaded.getCameraSpeed(), 2.f);
+    EXPECT(SceneBuilderDump::getDebugContent(loaded) == SceneBuilderDump::getDebugContent(builder));
+
+    // Read into a builder with existing content, node references are offset and the scene-wide settings are kept.
+    SceneBuilder appended(pDevice, Settings());
+    addTestContent(appended);
+    appended.getMetadata().samplesPerPixel = 4;
+    const uint32_t nodeBase = appended.getNodeCount();
+    SceneDescFile::read(path, appended);
+    EXPECT_EQ(appended.getNodeCount(), 2 * nodeBase);
+    ASSERT_EQ(appended.getLights().size(), 2u);
+    EXPECT(appended.getLights()[1]->getNodeID() == NodeID(nodeBase));
+    ASSERT_EQ(appended.getCameras().size(), 2u);
+    EXPECT(appended.getSelectedCamera() == appended.getCameras()[0]);
+    EXPECT(appended.getMetadata().samplesPerPixel == 4u);
+    EXPECT_EQ(appended.getCameraSpeed(), 1.f);
+
+    // Invalid data is rejected.
+    std::vector<uint8_t> data(256, 0);
+    EXPECT(!SceneDescFile::isSceneDesc(data.data(), data.size()));
+    EXPECT_THROW(SceneDescFile::readFromMemory(data.data(), data.size(), loaded));
+
+    std::filesystem::remove(path);
+}
+
+GPU_TEST(SceneDescFile_Benchmark)
+{
+    // Compare against importing the equivalent Python scene script, which adds the objects one at a time.
+    // Only runs when FALCOR_RUN_BENCHMARKS is set.
+    if (!getEnvironmentVariable("FALCOR_RUN_BENCHMARKS"))
+        ctx.skip("FALCOR_RUN_BENCHMARKS is not set");
+
+    try
+    {
+        PluginManager::instance().loadPluginByName("PythonImporter");
+    }
+    catch (const std::exception&)
+    {
+        ctx.skip("PythonImporter plugin is not available");
+    }
+
+    const uint32_t kObjectCount = 10000;
+    const uint32_t kMaterialCount = 256;
+
+    ref<Device> pDevice = ctx.getDevice();
+    const auto dir = getRuntimeDirectory() / "test_scene_desc";
+    std::filesystem::create_directories(dir);
+    const auto scriptPath = dir / "objects.pyscene";
+    const auto descPath = dir / "objects.fscene";
+
+    {
+        std::ofstream script(scriptPath);
+        script << "cube = TriangleMesh.createCube()\n"
+               << "sphere = TriangleMesh.createSphere(0.5, 16, 8)\n"
+               << "meshIDs = []\n"
+               << "for i in range(" << kMaterialCount << "):\n"
+               << "    material = StandardMaterial(f'Material{i}')\n"
+               << "    material.baseColor = float4(i / " << kMaterialCount << ", 0.5, 0.8, 1.0)\n"
+               << "    material.roughness = 0.5\n"
+               << "    meshIDs.append(sceneBuilder.addTriangleMesh(cube if i % 2 == 0 else sphere, material))\n"
+               << "for i in range(" << kObjectCount << "):\n"
+               << "    translation = float3((i % 100) * 2.0, (i // 10000) * 2.0, ((i // 100) % 100) * 2.0)\n"
+               << "    nodeID = sceneBuilder.addNode(f'Object{i}', Transform(translation=translation))\n"
+               << "    sceneBuilder.addMeshInstance(nodeID, meshIDs[i % " << kMaterialCount << "])\n"
+               << "camera = Camera('Camera')\n"
+               << "camera.position = float3(100, 50, 100)\n"
+               << "sceneBuilder.addCamera(camera)\n";
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    SceneBuilder scriptBuilder(pDevice, scriptPath, Settings());
+    double scriptTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    SceneDescFile::write(scriptBuilder, descPath);
+
+    startTime = std::chrono::steady_clock::now();
+    SceneBuilder descBuilder(pDevice, Settings());
+    SceneDescFile::read(descPath, descBuilder);
+    double descTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    EXPECT_EQ(descBuilder.getNodeCount(), scriptBuilder.getNodeCount());
+    EXPECT_EQ(descBuilder.getMaterials().size(), kMaterialCount);
+    EXPECT(SceneBuilderDump::getDebugContent(descBuilder) == SceneBuilderDump::getDebugContent(scriptBuilder));
+
+    logInfo(
+        "SceneDescFile: {} objects, pyscene {:.1f} ms, fscene {:.1f} ms ({} MB), speedup {:.1f}x",
+        kObjectCount,
+        scriptTime * 1000.0,
+        descTime * 1000.0,
+        std::filesystem::file_size(descPath) / (1024 * 1024),
+        scriptTime / descTime
+    );
+
+    std::filesystem::remove_all(dir);
+}
+} // namespace Falcor
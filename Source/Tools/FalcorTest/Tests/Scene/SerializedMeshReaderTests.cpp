@@ -0,0 +1,271 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SerializedMeshReader.h"
+#include <cstring>
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+template<typename T>
+void append(std::string& data, T value)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    data.append(bytes, sizeof(T));
+}
+
+/// Wrap data in a zlib stream made of uncompressed (stored) deflate blocks.
+std::string zlibStore(const std::string& data)
+{
+    std::string stream = {char(0x78), char(0x01)};
+    size_t pos = 0;
+    do
+    {
+        const uint16_t size = uint16_t(std::min<size_t>(data.size() - pos, 0xffff));
+        append(stream, uint8_t(pos + size == data.size() ? 1 : 0));
+        append(stream, size);
+        append(stream, uint16_t(~size));
+        stream.append(data, pos, size);
+        pos += size;
+    } while (pos < data.size());
+
+    uint32_t a = 1, b = 0;
+    for (char c : data)
+    {
+        a = (a + uint8_t(c)) % 65521;
+        b = (b + a) % 65521;
+    }
+    const uint32_t adler = (b << 16) | a;
+    for (int shift = 24; shift >= 0; shift -= 8)
+        append(stream, uint8_t(adler >> shift));
+    return stream;
+}
+
+struct GridDesc
+{
+    uint32_t n;           ///< Grid of (n + 1)^2 vertices and n^2 * 2 triangles in the xy-plane.
+    uint32_t flags;       ///< Mesh flags.
+    bool doublePrecision; ///< Store double precision data.
+};
+
+const uint32_t kHasNormals = 0x0001;
+const uint32_t kHasTexCoords = 0x0002;
+const uint32_t kHasColors = 0x0008;
+const uint32_t kFaceNormals = 0x0010;
+
+std::string createMeshData(const GridDesc& desc, uint16_t version)
+{
+    std::string data;
+    const uint32_t n = desc.n;
+    append(data, desc.flags | (desc.doublePrecision ? 0x2000u : 0x1000u));
+    if (version == 4)
+        data.append(fmt::format("grid{}", n)).push_back('\0');
+    append(data, uint64_t(n + 1) * (n + 1));
+    append(data, uint64_t(n) * n * 2);
+
+    auto appendAttribute = [&](uint32_t components, auto func)
+    {
+        for (uint32_t y = 0; y <= n; ++y)
+        {
+            for (uint32_t x = 0; x <= n; ++x)
+            {
+                for (uint32_t c = 0; c < components; ++c)
+                {
+                    const float value = func(x, y, c);
+                    if (desc.doublePrecision)
+                        append(data, double(value));
+                    else
+                        append(data, value);
+                }
+            }
+        }
+    };
+    appendAttribute(3, [](uint32_t x, uint32_t y, uint32_t c) { return c == 0 ? float(x) : c == 1 ? float(y) : 0.f; });
+    if (desc.flags & kHasNormals)
+        appendAttribute(3, [](uint32_t, uint32_t, uint32_t c) { return c == 2 ? 1.f : 0.f; });
+    if (desc.flags & kHasTexCoords)
+        appendAttribute(2, [](uint32_t x, uint32_t y, uint32_t c) { return c == 0 ? x * 0.125f : y * 0.125f; });
+    if (desc.flags & kHasColors)
+        appendAttribute(3, [](uint32_t, uint32_t, uint32_t) { return 0.5f; });
+
+    for (uint32_t y = 0; y < n; ++y)
+    {
+        for (uint32_t x = 0; x < n; ++x)
+        {
+            const uint32_t i = y * (n + 1) + x;
+            for (uint32_t index : {i, i + 1, i + n + 2, i, i + n + 2, i + n + 1})
+                append(data, index);
+        }
+    }
+    return data;
+}
+
+/// Create a serialized file with one mesh per grid.
+std::string createSerialized(const std::vector<GridDesc>& grids, uint16_t version)
+{
+    std::string data;
+    std::vector<uint64_t> offsets;
+    for (const auto& grid : grids)
+    {
+        offsets.push_back(data.size());
+        append(data, uint16_t(0x041C));
+        append(data, version);
+        data += zlibStore(createMeshData(grid, version));
+    }
+    for (uint64_t offset : offsets)
+    {
+        if (version == 4)
+            append(data, offset);
+        else
+            append(data, uint32_t(offset));
+    }
+    append(data, uint32_t(grids.size()));
+    return data;
+}
+
+ref<TriangleMesh> readString(
+    const std::string& data,
+    uint32_t shapeIndex,
+    TriangleMesh::ImportFlags flags = TriangleMesh::ImportFlags::Default
+)
+{
+    return SerializedMeshReader::readFromMemory(data.data(), data.size(), shapeIndex, flags);
+}
+} // namespace
+
+CPU_TEST(SerializedMeshReader_Decode)
+{
+    const std::vector<GridDesc> grids = {
+        {4, kHasNormals | kHasTexCoords, false},
+        {3, kHasTexCoords | kHasColors, true},
+        {2, kHasNormals | kFaceNormals, false},
+    };
+
+    for (uint16_t version : {3, 4})
+    {
+        const std::string data = createSerialized(grids, version);
+        EXPECT_EQ(SerializedMeshReader::getShapeCount(data.data(), data.size()), 3);
+
+        // Stored normals and texture coordinates, flipped vertically like in PlyReader.
+        auto pMesh = readString(data, 0);
+        ASSERT(pMesh);
+        const auto& vertices = pMesh->getVertices();
+        ASSERT_EQ(vertices.size(), 25);
+        ASSERT_EQ(pMesh->getIndices().size(), 4 * 4 * 6);
+        EXPECT(all(vertices[5 * 2 + 3].position == float3(3.f, 2.f, 0.f)));
+        EXPECT(all(vertices[5 * 2 + 3].normal == float3(0.f, 0.f, 1.f)));
+        EXPECT(all(vertices[5 * 2 + 3].texCoord == float2(0.375f, 0.75f)));
+        EXPECT_EQ(pMesh->getIndices()[8], 1 + 5 + 1); // First triangle of cell (1, 0).
+
+        // Double precision data without normals. Face normals duplicate the vertices, smooth normals keep them shared.
+        pMesh = readString(data, 1);
+        ASSERT(pMesh);
+        EXPECT_EQ(pMesh->getVertices().size(), 3 * 3 * 6);
+        EXPECT(all(pMesh->getVertices()[7].normal == float3(0.f, 0.f, 1.f)));
+        pMesh = readString(data, 1, TriangleMesh::ImportFlags::GenSmoothNormals);
+        ASSERT(pMesh);
+        EXPECT_EQ(pMesh->getVertices().size(), 16);
+        EXPECT(all(pMesh->getVertices()[15].position == float3(3.f, 3.f, 0.f)));
+        EXPECT(all(pMesh->getVertices()[15].normal == float3(0.f, 0.f, 1.f)));
+
+        // Meshes flagged with face normals ignore the stored normals.
+        pMesh = readString(data, 2, TriangleMesh::ImportFlags::GenSmoothNormals);
+        ASSERT(pMesh);
+        EXPECT_EQ(pMesh->getVertices().size(), 2 * 2 * 6);
+    }
+}
+
+CPU_TEST(SerializedMeshReader_ReadShapes)
+{
+    std::vector<GridDesc> grids;
+    for (uint32_t i = 0; i < 16; ++i)
+        grids.push_back({16 + i, kHasNormals, i % 2 == 1});
+    const std::string data = createSerialized(grids, 4);
+
+    const auto path = getRuntimeDirectory() / "test_serialized_mesh_reader.serialized";
+    std::ofstream(path, std::ios::binary).write(data.data(), data.size());
+
+    // Meshes referenced multiple times are shared, invalid indices give nullptr.
+    const std::vector<uint32_t> shapeIndices = {15, 3, 3, 0, 7, 16};
+    auto meshes = SerializedMeshReader::readShapes(path, shapeIndices);
+    ASSERT_EQ(meshes.size(), shapeIndices.size());
+    for (size_t i = 0; i + 1 < shapeIndices.size(); ++i)
+    {
+        ASSERT(meshes[i]);
+        const uint32_t n = 16 + shapeIndices[i];
+        EXPECT_EQ(meshes[i]->getVertices().size(), (n + 1) * (n + 1));
+        EXPECT_EQ(meshes[i]->getIndices().size(), n * n * 6);
+    }
+    EXPECT(meshes[1] == meshes[2]);
+    EXPECT(meshes.back() == nullptr);
+
+    auto pMesh = SerializedMeshReader::read(path, 7);
+    ASSERT(pMesh);
+    EXPECT(pMesh != meshes[4]);
+    EXPECT(pMesh->getIndices() == meshes[4]->getIndices());
+    EXPECT(all(pMesh->getVertices().back().position == meshes[4]->getVertices().back().position));
+
+    meshes.clear();
+    std::filesystem::remove(path);
+}
+
+CPU_TEST(SerializedMeshReader_Invalid)
+{
+    const std::string valid = createSerialized({{2, kHasNormals, false}}, 4);
+    EXPECT_THROW(readString("", 0));
+    EXPECT_THROW(readString(valid, 1));
+    EXPECT_THROW(readString(valid.substr(0, valid.size() - 4) + std::string(4, '\x7f'), 0));
+
+    // Wrong format identifier and version.
+    std::string data = valid;
+    data[0] = 0;
+    EXPECT_THROW(readString(data, 0));
+    data = valid;
+    data[2] = 5;
+    EXPECT_THROW(readString(data, 0));
+
+    // Corrupt zlib stream and truncated mesh data.
+    data = valid;
+    data[4] = 0;
+    EXPECT_THROW(readString(data, 0));
+    std::string meshData = createMeshData({2, kHasNormals, false}, 4);
+    meshData.resize(meshData.size() - 4);
+    data = std::string("\x1c\x04\x04\x00", 4) + zlibStore(meshData);
+    append(data, uint64_t(0));
+    append(data, uint32_t(1));
+    EXPECT_THROW(readString(data, 0));
+
+    // File errors are reported as nullptr.
+    EXPECT(SerializedMeshReader::read(getRuntimeDirectory() / "missing.serialized", 0) == nullptr);
+    auto meshes = SerializedMeshReader::readShapes(getRuntimeDirectory() / "missing.serialized", {0, 1});
+    EXPECT(meshes.size() == 2 && meshes[0] == nullptr && meshes[1] == nullptr);
+}
+} // namespace Falcor
@@ -0,0 +1,135 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/BakedTextureCache.h"
+
+namespace Falcor
+{
+namespace
+{
+void writeTestImage(const std::filesystem::path& path, uint32_t width, uint32_t height, uint8_t seed)
+{
+    std::vector<uint8_t> data(width * height * 4);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = uint8_t(seed + i * 13);
+    Bitmap::saveImage(
+        path, width, height, Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::ExportAlpha, ResourceFormat::RGBA8Unorm, true, data.data()
+    );
+}
+} // namespace
+
+CPU_TEST(BakedTextureCache_SelectCompressionMode)
+{
+    EXPECT(BakedTextureCache::selectCompressionMode(ResourceFormat::BGRA8Unorm) == ImageIO::CompressionMode::BC7);
+    EXPECT(BakedTextureCache::selectCompressionMode(ResourceFormat::RGBA8UnormSrgb) == ImageIO::CompressionMode::BC7);
+    EXPECT(BakedTextureCache::selectCompressionMode(ResourceFormat::RG8Unorm) == ImageIO::CompressionMode::BC5);
+    EXPECT(BakedTextureCache::selectCompressionMode(ResourceFormat::R8Unorm) == ImageIO::CompressionMode::BC4);
+    EXPECT(BakedTextureCache::selectCompressionMode(ResourceFormat::RGBA16Float) == ImageIO::CompressionMode::BC6);
+    EXPECT(BakedTextureCache::selectCompressionMode(ResourceFormat::RGBA32Float) == ImageIO::CompressionMode::BC6);
+    EXPECT(BakedTextureCache::selectCompressionMode(ResourceFormat::RGBA16Unorm) == ImageIO::CompressionMode::None);
+    EXPECT(BakedTextureCache::selectCompressionMode(ResourceFormat::R32Uint) == ImageIO::CompressionMode::None);
+    EXPECT(BakedTextureCache::selectCompressionMode(ResourceFormat::BC7Unorm) == ImageIO::CompressionMode::None);
+
+    EXPECT(BakedTextureCache::isSupportedSource("foo.png"));
+    EXPECT(BakedTextureCache::isSupportedSource("foo.JPG"));
+    EXPECT(BakedTextureCache::isSupportedSource("foo.exr"));
+    EXPECT(!BakedTextureCache::isSupportedSource("foo.dds"));
+}
+
+CPU_TEST(BakedTextureCache_BakeAndLookup)
+{
+    const auto dir = getRuntimeDirectory() / "test_baked_texture_cache";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir / "src");
+
+    const auto pathA = dir / "src/a.png";
+    const auto pathB = dir / "src/b.png";
+    const auto pathCopy = dir / "src/a_copy.png";
+    writeTestImage(pathA, 64, 32, 0);
+    writeTestImage(pathB, 16, 16, 1);
+    std::filesystem::copy_file(pathA, pathCopy);
+
+    BakedTextureCache::Options options;
+    options.directory = dir / "cache";
+    {
+        BakedTextureCache cache(options);
+        EXPECT(cache.lookup(pathA, BakedTextureCache::Variant::Srgb).empty());
+
+        std::vector<std::filesystem::path> sources = {pathA, pathB, pathCopy};
+        auto results = cache.bakeAll(sources, BakedTextureCache::Variant::Srgb, 2);
+        ASSERT_EQ(results.size(), 3);
+        EXPECT(!results[0].cachePath.empty());
+        EXPECT(!results[1].cachePath.empty());
+        EXPECT(results[0].mode == ImageIO::CompressionMode::BC7);
+
+        // Identical content shares the cache entry.
+        EXPECT(results[2].cachePath == results[0].cachePath);
+        EXPECT(results[0].cachePath != results[1].cachePath);
+
+        auto image = ImageIO::loadDDSImage(results[0].cachePath, true);
+        EXPECT(image.format == ResourceFormat::BC7UnormSrgb);
+        EXPECT_EQ(image.width, 64);
+        EXPECT_EQ(image.height, 32);
+        EXPECT_EQ(image.mipLevels, 7);
+
+        // Baking again is a cache hit.
+        auto result = cache.bake(pathA, BakedTextureCache::Variant::Srgb);
+        EXPECT(result.wasCached);
+        EXPECT(result.cachePath == results[0].cachePath);
+
+        // Textures loaded as linear data have separate entries.
+        EXPECT(cache.lookup(pathA, BakedTextureCache::Variant::Linear).empty());
+        result = cache.bake(pathA, BakedTextureCache::Variant::Linear);
+        EXPECT(!result.wasCached);
+        EXPECT(!result.cachePath.empty());
+        EXPECT(result.cachePath != results[0].cachePath);
+
+        // So do normal maps.
+        auto normalResult = cache.bake(pathA, BakedTextureCache::Variant::NormalMap);
+        EXPECT(!normalResult.cachePath.empty());
+        EXPECT(normalResult.cachePath != result.cachePath);
+        EXPECT(normalResult.cachePath != results[0].cachePath);
+    }
+
+    // A new cache instance finds the entries through the index.
+    {
+        BakedTextureCache cache(options);
+        EXPECT(!cache.lookup(pathA, BakedTextureCache::Variant::Srgb).empty());
+        EXPECT(!cache.lookup(pathA, BakedTextureCache::Variant::Linear).empty());
+        EXPECT(!cache.lookup(pathB, BakedTextureCache::Variant::Srgb).empty());
+        EXPECT(cache.lookup(dir / "src/missing.png", BakedTextureCache::Variant::Srgb).empty());
+
+        // Modified content is a cache miss.
+        writeTestImage(pathB, 16, 16, 2);
+        std::filesystem::last_write_time(pathB, std::filesystem::last_write_time(pathB) + std::chrono::seconds(1));
+        EXPECT(cache.lookup(pathB, BakedTextureCache::Variant::Srgb).empty());
+    }
+
+    std::filesystem::remove_all(dir);
+}
+} // namespace Falcor
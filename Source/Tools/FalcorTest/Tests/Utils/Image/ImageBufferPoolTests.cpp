@@ -0,0 +1,221 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Image/ImageBufferPool.h"
+#include "Utils/Logger.h"
+#include "Utils/StringUtils.h"
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <thread>
+
+namespace Falcor
+{
+CPU_TEST(ImageBufferPool_SizeClasses)
+{
+    ImageBufferPool pool;
+    const size_t minSize = pool.getOptions().minPooledSize;
+
+    // Small requests are not rounded.
+    EXPECT_EQ(pool.getCapacity(100), 100);
+
+    std::mt19937 rng(1);
+    for (uint32_t i = 0; i < 10000; ++i)
+    {
+        size_t size = minSize + rng() % (256 * 1024 * 1024);
+        size_t capacity = pool.getCapacity(size);
+        EXPECT_GE(capacity, size);
+        EXPECT_LE(capacity, size + size / 4);
+        EXPECT_EQ(capacity % 4096, 0);
+        EXPECT_EQ(pool.getCapacity(capacity), capacity);
+    }
+
+    // Four classes per power of two.
+    EXPECT_EQ(pool.getCapacity(1024 * 1024 + 1), 1280 * 1024);
+    EXPECT_EQ(pool.getCapacity(1536 * 1024), 1536 * 1024);
+    EXPECT_EQ(pool.getCapacity(1536 * 1024 + 1), 1792 * 1024);
+}
+
+CPU_TEST(ImageBufferPool_Reuse)
+{
+    ImageBufferPool pool;
+
+    {
+        auto buffer = pool.allocate(100);
+        EXPECT(buffer != nullptr);
+        EXPECT_EQ(buffer.get_deleter().getCapacity(), 100);
+        std::memset(buffer.get(), 0xab, 100);
+    }
+    EXPECT_EQ(pool.getStats().heapAllocationCount, 1);
+
+    const size_t size = 4 * 1024 * 1024 + 1;
+    uint8_t* pFirst = nullptr;
+    {
+        auto buffer = pool.allocate(size);
+        pFirst = buffer.get();
+        EXPECT_EQ(buffer.get_deleter().getCapacity(), pool.getCapacity(size));
+        std::memset(buffer.get(), 0xcd, size);
+        EXPECT_EQ(pool.getStats().bytesInUse, pool.getCapacity(size));
+    }
+    EXPECT_EQ(pool.getStats().bytesInUse, 0);
+    EXPECT_EQ(pool.getStats().bytesCached, pool.getCapacity(size));
+
+    // Any request in the same size class reuses the cached block.
+    {
+        auto buffer = pool.allocate(size + 1000);
+        EXPECT(buffer.get() == pFirst);
+        EXPECT_EQ(pool.getStats().reuseCount, 1);
+        EXPECT_EQ(pool.getStats().bytesCached, 0);
+    }
+
+    auto stats = pool.getStats();
+    EXPECT_EQ(stats.allocationCount, 3);
+    EXPECT_EQ(stats.systemAllocationCount, 1);
+    EXPECT_EQ(stats.peakBytesInUse, pool.getCapacity(size));
+}
+
+CPU_TEST(ImageBufferPool_CacheLimit)
+{
+    ImageBufferPool::Options options;
+    options.maxCachedBytes = 8 * 1024 * 1024;
+    ImageBufferPool pool(options);
+
+    {
+        std::vector<ImageBufferPool::Buffer> buffers;
+        for (uint32_t i = 0; i < 4; ++i)
+            buffers.push_back(pool.allocate(3 * 1024 * 1024));
+        EXPECT_EQ(pool.getStats().bytesInUse, 12 * 1024 * 1024);
+    }
+
+    // Only two blocks fit in the cache, the rest is returned to the OS.
+    auto stats = pool.getStats();
+    EXPECT_EQ(stats.bytesCached, 6 * 1024 * 1024);
+    EXPECT_EQ(stats.systemReleaseCount, 2);
+
+    pool.trim();
+    stats = pool.getStats();
+    EXPECT_EQ(stats.bytesCached, 0);
+    EXPECT_EQ(stats.systemReleaseCount, 4);
+    EXPECT_EQ(stats.hugePageAdvisedBytes, 0);
+}
+
+CPU_TEST(ImageBufferPool_Multithreaded)
+{
+    ImageBufferPool pool;
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 8; ++t)
+    {
+        threads.emplace_back(
+            [&pool, t]()
+            {
+                std::mt19937 rng(t);
+                for (uint32_t i = 0; i < 200; ++i)
+                {
+                    size_t size = 1024 + rng() % (8 * 1024 * 1024);
+                    auto buffer = pool.allocate(size);
+                    std::memset(buffer.get(), int(t), size);
+                }
+            }
+        );
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    auto stats = pool.getStats();
+    EXPECT_EQ(stats.allocationCount, 8 * 200);
+    EXPECT_EQ(stats.bytesInUse, 0);
+    EXPECT_LE(stats.bytesCached, pool.getOptions().maxCachedBytes);
+}
+
+CPU_TEST(ImageBufferPool_Benchmark)
+{
+    // Simulates a batch texture workload: many buffers of a few recurring sizes (1k to 4k RGBA8/RGBA16F and their mips),
+    // each written once. Compares the pool against the regular heap. Set FALCOR_RUN_BENCHMARKS to run it.
+    if (!getEnvironmentVariable("FALCOR_RUN_BENCHMARKS"))
+        ctx.skip("FALCOR_RUN_BENCHMARKS is not set");
+
+    const std::vector<size_t> sizes = {
+        1024 * 1024 * 4, 2048 * 2048 * 4, 4096 * 4096 * 4, 2048 * 2048 * 8, 512 * 512 * 4, 1365 * 1024 * 4,
+    };
+    const uint32_t iterations = 200;
+
+    auto run = [&](auto&& allocateAndTouch)
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+        std::mt19937 rng(7);
+        for (uint32_t i = 0; i < iterations; ++i)
+            allocateAndTouch(sizes[rng() % sizes.size()]);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    };
+
+    uint64_t rssBefore = getCurrentRSS();
+    double heapTime = run(
+        [](size_t size)
+        {
+            std::unique_ptr<uint8_t[]> pData(new uint8_t[size]);
+            std::memset(pData.get(), 1, size);
+        }
+    );
+    uint64_t rssHeap = getCurrentRSS();
+
+    ImageBufferPool pool;
+    double poolTime = run(
+        [&pool](size_t size)
+        {
+            auto buffer = pool.allocate(size);
+            std::memset(buffer.get(), 1, size);
+        }
+    );
+    uint64_t rssPool = getCurrentRSS();
+    auto stats = pool.getStats();
+
+    logInfo(
+        "ImageBufferPool: {} allocations, heap {:.1f} ms (RSS +{}), pool {:.1f} ms (RSS +{}), speedup {:.2f}x",
+        iterations,
+        heapTime * 1000.0,
+        formatByteSize(rssHeap > rssBefore ? rssHeap - rssBefore : 0),
+        poolTime * 1000.0,
+        formatByteSize(rssPool > rssHeap ? rssPool - rssHeap : 0),
+        heapTime / poolTime
+    );
+    logInfo(
+        "ImageBufferPool: {} reused, {} system allocations, peak {}, cached {}, huge pages advised {}, peak RSS {}",
+        stats.reuseCount,
+        stats.systemAllocationCount,
+        formatByteSize(stats.peakBytesInUse),
+        formatByteSize(stats.bytesCached),
+        formatByteSize(stats.hugePageAdvisedBytes),
+        formatByteSize(getPeakRSS())
+    );
+
+    EXPECT_EQ(stats.allocationCount, iterations);
+    EXPECT_LE(stats.systemAllocationCount, sizes.size());
+}
+} // namespace Falcor
@@ -0,0 +1,265 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Image/MipGenerator.h"
+#include "Utils/Math/Float16.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+
+namespace Falcor
+{
+namespace
+{
+std::vector<uint8_t> createRandomImage(uint32_t width, uint32_t height, uint32_t bytesPerPixel, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> data((size_t)width * height * bytesPerPixel);
+    for (auto& v : data)
+        v = (uint8_t)rng();
+    return data;
+}
+
+/// Decode a unorm normal from the first three channels of a pixel.
+float3 decodeNormal(const uint8_t* pPixel)
+{
+    return float3(pPixel[0], pPixel[1], pPixel[2]) / 127.5f - 1.f;
+}
+} // namespace
+
+CPU_TEST(MipGenerator_MipCount)
+{
+    EXPECT_EQ(MipGenerator::getMipCount(1, 1), 1);
+    EXPECT_EQ(MipGenerator::getMipCount(2, 1), 2);
+    EXPECT_EQ(MipGenerator::getMipCount(64, 32), 7);
+    EXPECT_EQ(MipGenerator::getMipCount(37, 21), 6);
+
+    EXPECT(MipGenerator::isFormatSupported(ResourceFormat::RGBA8UnormSrgb));
+    EXPECT(MipGenerator::isFormatSupported(ResourceFormat::BGRX8Unorm));
+    EXPECT(MipGenerator::isFormatSupported(ResourceFormat::RG8Unorm));
+    EXPECT(MipGenerator::isFormatSupported(ResourceFormat::R16Unorm));
+    EXPECT(MipGenerator::isFormatSupported(ResourceFormat::RGBA16Float));
+    EXPECT(MipGenerator::isFormatSupported(ResourceFormat::RGB32Float));
+    EXPECT(!MipGenerator::isFormatSupported(ResourceFormat::BC7Unorm));
+    EXPECT(!MipGenerator::isFormatSupported(ResourceFormat::RGB10A2Unorm));
+    EXPECT(!MipGenerator::isFormatSupported(ResourceFormat::D32Float));
+}
+
+CPU_TEST(MipGenerator_Constant)
+{
+    // Constant images stay constant at all levels for all filters and address modes, including odd sizes.
+    const uint32_t width = 37, height = 21;
+    std::vector<uint8_t> data(width * height * 4, 77);
+    for (auto filter : {MipGenerator::Filter::Box, MipGenerator::Filter::Kaiser, MipGenerator::Filter::Lanczos})
+    {
+        for (auto addressMode : {MipGenerator::AddressMode::Clamp, MipGenerator::AddressMode::Wrap, MipGenerator::AddressMode::Mirror})
+        {
+            MipGenerator::Options options;
+            options.filter = filter;
+            options.addressMode = addressMode;
+            options.threadCount = 2;
+            auto mips = MipGenerator::generate(data.data(), width, height, ResourceFormat::RGBA8UnormSrgb, options);
+
+            size_t expectedSize = 0;
+            for (uint32_t mip = 0; mip < MipGenerator::getMipCount(width, height); ++mip)
+                expectedSize += std::max(1u, width >> mip) * std::max(1u, height >> mip) * 4;
+            ASSERT_EQ(mips.size(), expectedSize);
+            EXPECT(std::all_of(mips.begin(), mips.end(), [](uint8_t v) { return v == 77; }));
+        }
+    }
+
+    // One pixel wide images are only filtered vertically.
+    std::vector<uint8_t> column(1 * 9 * 2, 100);
+    auto mips = MipGenerator::generate(column.data(), 1, 9, ResourceFormat::RG8Unorm, MipGenerator::Options());
+    EXPECT_EQ(mips.size(), (9 + 4 + 2 + 1) * 2);
+    EXPECT(std::all_of(mips.begin(), mips.end(), [](uint8_t v) { return v == 100; }));
+}
+
+CPU_TEST(MipGenerator_Srgb)
+{
+    // A black and white checkerboard averages to 0.5 in linear space, which is 188 in sRGB.
+    const uint32_t size = 16;
+    std::vector<uint8_t> data(size * size * 4);
+    for (uint32_t y = 0; y < size; ++y)
+    {
+        for (uint32_t x = 0; x < size; ++x)
+        {
+            const uint8_t v = (x + y) % 2 ? 255 : 0;
+            uint8_t* pPixel = &data[(y * size + x) * 4];
+            pPixel[0] = pPixel[1] = pPixel[2] = v;
+            pPixel[3] = v; // Alpha is always linear.
+        }
+    }
+
+    MipGenerator::Options options;
+    options.addressMode = MipGenerator::AddressMode::Wrap;
+    for (auto filter : {MipGenerator::Filter::Box, MipGenerator::Filter::Kaiser, MipGenerator::Filter::Lanczos})
+    {
+        options.filter = filter;
+        auto mips = MipGenerator::generate(data.data(), size, size, ResourceFormat::RGBA8UnormSrgb, options, 2);
+        const uint8_t* pMip1 = mips.data() + size * size * 4;
+        for (uint32_t i = 0; i < (size / 2) * (size / 2); ++i)
+        {
+            EXPECT_LE(std::abs(pMip1[i * 4 + 0] - 188), 1);
+            EXPECT_LE(std::abs(pMip1[i * 4 + 3] - 128), 1);
+        }
+    }
+
+    // Without sRGB the average is taken on the encoded values.
+    options.filter = MipGenerator::Filter::Box;
+    auto mips = MipGenerator::generate(data.data(), size, size, ResourceFormat::RGBA8Unorm, options, 2);
+    EXPECT_LE(std::abs(mips[size * size * 4] - 128), 1);
+}
+
+CPU_TEST(MipGenerator_NormalMap)
+{
+    // Random normals in the upper hemisphere.
+    const uint32_t width = 64, height = 32;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-0.7f, 0.7f);
+    std::vector<uint8_t> data(width * height * 4);
+    for (uint32_t i = 0; i < width * height; ++i)
+    {
+        const float x = dist(rng), y = dist(rng);
+        const float3 n(x, y, std::sqrt(std::max(0.f, 1.f - x * x - y * y)));
+        for (uint32_t c = 0; c < 3; ++c)
+            data[i * 4 + c] = (uint8_t)((n[c] * 0.5f + 0.5f) * 255.f + 0.5f);
+        data[i * 4 + 3] = 255;
+    }
+
+    MipGenerator::Options options;
+    options.normalMap = true;
+    auto mips = MipGenerator::generate(data.data(), width, height, ResourceFormat::RGBA8Unorm, options);
+    for (size_t i = width * height * 4; i < mips.size(); i += 4)
+        EXPECT_LE(std::abs(length(decodeNormal(&mips[i])) - 1.f), 0.02f);
+
+    // Without renormalization, averaged normals get shorter.
+    options.normalMap = false;
+    mips = MipGenerator::generate(data.data(), width, height, ResourceFormat::RGBA8Unorm, options);
+    const uint8_t* pLastMip = mips.data() + mips.size() - 4;
+    EXPECT_LE(length(decodeNormal(pLastMip)), 0.98f);
+}
+
+CPU_TEST(MipGenerator_SimdMatchesScalar)
+{
+    if (!MipGenerator::isSimdSupported())
+        ctx.skip("SIMD code path is not supported on this CPU");
+
+    const uint32_t width = 131, height = 67;
+    for (auto format : {ResourceFormat::RGBA8UnormSrgb, ResourceFormat::RG8Unorm, ResourceFormat::RGBA32Float, ResourceFormat::R16Float})
+    {
+        const uint32_t bytesPerPixel = getFormatBytesPerBlock(format);
+        auto data = createRandomImage(width, height, bytesPerPixel, 3);
+        if (format == ResourceFormat::RGBA32Float)
+        {
+            float* pData = reinterpret_cast<float*>(data.data());
+            for (size_t i = 0; i < data.size() / 4; ++i)
+                pData[i] = (i * 7919 % 1000) / 1000.f;
+        }
+        else if (format == ResourceFormat::R16Float)
+        {
+            uint16_t* pData = reinterpret_cast<uint16_t*>(data.data());
+            for (size_t i = 0; i < data.size() / 2; ++i)
+                pData[i] = math::float32ToFloat16((i * 7919 % 1000) / 100.f);
+        }
+
+        MipGenerator::Options options;
+        options.useSimd = true;
+        auto simd = MipGenerator::generate(data.data(), width, height, format, options);
+        options.useSimd = false;
+        auto scalar = MipGenerator::generate(data.data(), width, height, format, options);
+        ASSERT_EQ(simd.size(), scalar.size());
+
+        // FMA rounding differs from the scalar path, results may differ by one unorm step or a few ulps.
+        if (format == ResourceFormat::RGBA8UnormSrgb || format == ResourceFormat::RG8Unorm)
+        {
+            for (size_t i = 0; i < simd.size(); ++i)
+                EXPECT_LE(std::abs(simd[i] - scalar[i]), 1);
+        }
+        else if (format == ResourceFormat::RGBA32Float)
+        {
+            const float* pSimd = reinterpret_cast<const float*>(simd.data());
+            const float* pScalar = reinterpret_cast<const float*>(scalar.data());
+            for (size_t i = 0; i < simd.size() / 4; ++i)
+                EXPECT_LE(std::abs(pSimd[i] - pScalar[i]), 1e-5f);
+        }
+        else
+        {
+            const uint16_t* pSimd = reinterpret_cast<const uint16_t*>(simd.data());
+            const uint16_t* pScalar = reinterpret_cast<const uint16_t*>(scalar.data());
+            for (size_t i = 0; i < simd.size() / 2; ++i)
+                EXPECT_LE(std::abs(math::float16ToFloat32(pSimd[i]) - math::float16ToFloat32(pScalar[i])), 1e-2f);
+        }
+    }
+}
+
+CPU_TEST(MipGenerator_Benchmark)
+{
+    // Compares the SIMD path against the scalar reference on a 2k sRGB texture. Set FALCOR_RUN_BENCHMARKS to run it.
+    if (!getEnvironmentVariable("FALCOR_RUN_BENCHMARKS"))
+        ctx.skip("FALCOR_RUN_BENCHMARKS is not set");
+
+    const uint32_t size = 2048;
+    auto data = createRandomImage(size, size, 4, 4);
+
+    const size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (auto filter : {MipGenerator::Filter::Box, MipGenerator::Filter::Kaiser})
+    {
+        for (uint32_t threadCount : {1u, (uint32_t)hardwareThreads})
+        {
+            MipGenerator::Options options;
+            options.filter = filter;
+            options.threadCount = threadCount;
+
+            double times[2] = {};
+            for (bool useSimd : {false, true})
+            {
+                options.useSimd = useSimd;
+                const auto startTime = std::chrono::steady_clock::now();
+                auto mips = MipGenerator::generate(data.data(), size, size, ResourceFormat::RGBA8UnormSrgb, options);
+                times[useSimd] = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+                EXPECT(!mips.empty());
+            }
+
+            logInfo(
+                "MipGenerator {}x{} {} on {} threads: scalar {:.1f} ms, SIMD {:.1f} ms, speedup {:.2f}x",
+                size,
+                size,
+                enumToString(filter),
+                threadCount,
+                times[0] * 1000.0,
+                times[1] * 1000.0,
+                times[0] / times[1]
+            );
+        }
+    }
+}
+} // namespace Falcor
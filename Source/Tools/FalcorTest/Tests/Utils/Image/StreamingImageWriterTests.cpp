@@ -0,0 +1,196 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/Bitmap.h"
+#include "Utils/Image/StreamingImageWriter.h"
+#include "Utils/Math/Float16.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace Falcor
+{
+namespace
+{
+std::vector<float> createRamp(uint32_t width, uint32_t height, uint32_t channelCount)
+{
+    std::vector<float> data(size_t(width) * height * channelCount);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = float(i % 1021) / 1021.f;
+    return data;
+}
+} // namespace
+
+GPU_TEST(StreamingImageWriter_Pfm)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    const uint32_t width = 67, height = 13;
+    auto data = createRamp(width, height, 1);
+    auto pTex = pDevice->createTexture2D(width, height, ResourceFormat::R32Float, 1, 1, data.data());
+
+    const auto path = getRuntimeDirectory() / "test_streaming_writer.pfm";
+    {
+        StreamingImageWriter writer(pDevice);
+        writer.write(ctx.getRenderContext(), pTex, path);
+        writer.flush();
+        EXPECT_EQ(writer.getStats().fileCount, 1);
+        EXPECT_EQ(writer.getStats().failedCount, 0);
+    }
+
+    // Header followed by rows stored bottom-to-top.
+    auto file = readFile(path);
+    const std::string header = "Pf\n67 13\n-1.0\n";
+    ASSERT_EQ(file.size(), header.size() + data.size() * sizeof(float));
+    EXPECT(std::string(file.data(), header.size()) == header);
+    const float* pixels = reinterpret_cast<const float*>(file.data() + header.size());
+    for (uint32_t y = 0; y < height; ++y)
+        for (uint32_t x = 0; x < width; ++x)
+            EXPECT_EQ(pixels[(height - 1 - y) * width + x], data[y * width + x]);
+
+    std::filesystem::remove(path);
+}
+
+GPU_TEST(StreamingImageWriter_Npy)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    const uint32_t width = 33, height = 7;
+    std::vector<uint16_t> data(width * height * 4);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = math::float32ToFloat16(float(i) * 0.25f);
+    auto pTex = pDevice->createTexture2D(width, height, ResourceFormat::RGBA16Float, 1, 1, data.data());
+
+    const auto path = getRuntimeDirectory() / "test_streaming_writer.npy";
+    {
+        StreamingImageWriter writer(pDevice);
+        writer.write(ctx.getRenderContext(), pTex, path);
+    }
+
+    // The header is padded to a multiple of 64 bytes and followed by the raw texels.
+    auto file = readFile(path);
+    ASSERT_GE(file.size(), data.size() * sizeof(uint16_t));
+    const size_t headerSize = file.size() - data.size() * sizeof(uint16_t);
+    EXPECT_EQ(headerSize % 64, 0);
+    const std::string header(file.data(), headerSize);
+    EXPECT(header.find("'descr': '<f2'") != std::string::npos);
+    EXPECT(header.find("'shape': (7, 33, 4)") != std::string::npos);
+    EXPECT(std::memcmp(file.data() + headerSize, data.data(), data.size() * sizeof(uint16_t)) == 0);
+
+    std::filesystem::remove(path);
+}
+
+GPU_TEST(StreamingImageWriter_Exr)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    const uint32_t width = 64, height = 32;
+    auto ao = createRamp(width, height, 1);
+    auto color = createRamp(width, height, 4);
+    auto pAO = pDevice->createTexture2D(width, height, ResourceFormat::R32Float, 1, 1, ao.data());
+    auto pColor = pDevice->createTexture2D(width, height, ResourceFormat::RGBA32Float, 1, 1, color.data());
+
+    const auto singlePath = getRuntimeDirectory() / "test_streaming_writer.exr";
+    const auto multiPath = getRuntimeDirectory() / "test_streaming_writer_multi.exr";
+    const auto rgbPath = getRuntimeDirectory() / "test_streaming_writer_rgb.exr";
+    {
+        StreamingImageWriter writer(pDevice);
+        writer.write(ctx.getRenderContext(), pColor, singlePath);
+        writer.writeMultiPart(ctx.getRenderContext(), {{"ao", pAO}, {"color", pColor}}, multiPath);
+        StreamingImageWriter::Part rgbPart{"", pColor};
+        rgbPart.exportAlpha = false;
+        writer.write(ctx.getRenderContext(), rgbPart, rgbPath);
+        writer.flush();
+        EXPECT_EQ(writer.getStats().fileCount, 3);
+        EXPECT_EQ(writer.getStats().failedCount, 0);
+
+        // Parts with mismatching resolutions and unsupported extensions are rejected.
+        auto pSmall = pDevice->createTexture2D(width / 2, height, ResourceFormat::R32Float, 1, 1, ao.data());
+        EXPECT_THROW(writer.writeMultiPart(ctx.getRenderContext(), {{"ao", pAO}, {"small", pSmall}}, multiPath));
+        EXPECT_THROW(writer.write(ctx.getRenderContext(), pAO, getRuntimeDirectory() / "test_streaming_writer.png"));
+    }
+
+    // The multi-part file starts with the OpenEXR magic number and has the multi-part flag (bit 12) set.
+    auto file = readFile(multiPath);
+    ASSERT_GE(file.size(), 8);
+    EXPECT_EQ(*reinterpret_cast<const uint32_t*>(file.data()), 20000630u);
+    EXPECT((file[5] & 0x10) != 0);
+
+    auto bitmap = Bitmap::createFromFile(singlePath, true);
+    ASSERT(bitmap != nullptr);
+    EXPECT_EQ(bitmap->getWidth(), width);
+    EXPECT_EQ(bitmap->getHeight(), height);
+    ASSERT_EQ(bitmap->getFormat(), ResourceFormat::RGBA32Float);
+    EXPECT_EQ(reinterpret_cast<const float*>(bitmap->getData())[3], color[3]);
+
+    // Without alpha, RGBA textures are written as RGB like Texture::captureToFile() does. RGB files load with an alpha of one.
+    auto rgbBitmap = Bitmap::createFromFile(rgbPath, true);
+    ASSERT(rgbBitmap != nullptr);
+    ASSERT_EQ(rgbBitmap->getFormat(), ResourceFormat::RGBA32Float);
+    EXPECT_EQ(reinterpret_cast<const float*>(rgbBitmap->getData())[0], color[0]);
+    EXPECT_EQ(reinterpret_cast<const float*>(rgbBitmap->getData())[3], 1.f);
+
+    std::filesystem::remove(singlePath);
+    std::filesystem::remove(multiPath);
+    std::filesystem::remove(rgbPath);
+}
+
+GPU_TEST(StreamingImageWriter_Throughput4K)
+{
+    // Measures the frame rate for writing 4K single-channel AO output.
+    ref<Device> pDevice = ctx.getDevice();
+    const uint32_t width = 3840, height = 2160;
+    const uint32_t frameCount = 8;
+    auto data = createRamp(width, height, 1);
+    auto pTex = pDevice->createTexture2D(width, height, ResourceFormat::R32Float, 1, 1, data.data());
+
+    for (const char* ext : {"exr", "npy"})
+    {
+        std::vector<std::filesystem::path> paths;
+        StreamingImageWriter writer(pDevice);
+        auto startTime = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < frameCount; ++i)
+        {
+            paths.push_back(getRuntimeDirectory() / fmt::format("test_streaming_writer_4k_{}.{}", i, ext));
+            writer.write(ctx.getRenderContext(), pTex, paths.back());
+        }
+        double submitTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        writer.flush();
+
+        const auto stats = writer.getStats();
+        EXPECT_EQ(stats.fileCount, frameCount);
+        logInfo(
+            "StreamingImageWriter 4K R32Float .{}: {:.1f} frames/s, submit {:.1f} ms/frame, stalled {:.1f} ms",
+            ext,
+            stats.getFilesPerSecond(),
+            submitTime * 1000.0 / frameCount,
+            stats.stallTime * 1000.0
+        );
+
+        for (const auto& path : paths)
+            std::filesystem::remove(path);
+    }
+}
+} // namespace Falcor
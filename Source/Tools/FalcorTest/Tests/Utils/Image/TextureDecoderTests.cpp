@@ -0,0 +1,252 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/TextureDecoder.h"
+#include "Core/Platform/OS.h"
+#include <chrono>
+
+namespace Falcor
+{
+namespace
+{
+std::vector<std::filesystem::path> writeTestImages(const std::filesystem::path& dir, uint32_t count)
+{
+    std::filesystem::create_directories(dir);
+    std::vector<std::filesystem::path> paths;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const uint32_t width = 8 + 4 * i;
+        const uint32_t height = 4 + 2 * (i % 5);
+        std::vector<uint8_t> data(width * height * 4);
+        for (size_t j = 0; j < data.size(); ++j)
+            data[j] = uint8_t(i * 31 + j * 7);
+
+        paths.push_back(dir / fmt::format("image_{}.png", i));
+        Bitmap::saveImage(
+            paths.back(),
+            width,
+            height,
+            Bitmap::FileFormat::PngFile,
+            Bitmap::ExportFlags::ExportAlpha,
+            ResourceFormat::RGBA8Unorm,
+            true /* top-down */,
+            data.data()
+        );
+    }
+    return paths;
+}
+} // namespace
+
+CPU_TEST(TextureDecoder_DecodeAll)
+{
+    const auto dir = getRuntimeDirectory() / "test_texture_decoder";
+    auto paths = writeTestImages(dir, 24);
+    paths.insert(paths.begin() + 5, dir / "does_not_exist.png");
+
+    std::vector<TextureDecoder::Request> requests;
+    for (const auto& path : paths)
+        requests.push_back(TextureDecoder::Request{{path}, false, true, Bitmap::ImportFlags::None});
+
+    // Use a tiny budget so that the workers are throttled constantly.
+    TextureDecoder::Options options;
+    options.threadCount = 4;
+    options.maxBytesInFlight = 1;
+    TextureDecoder decoder(options);
+
+    size_t expectedIndex = 0;
+    decoder.decodeAll(
+        requests,
+        [&](size_t index, std::unique_ptr<DecodedTexture> pDecoded)
+        {
+            // Results are delivered in request order and match a serial decode.
+            EXPECT_EQ(index, expectedIndex++);
+            auto pReference = Bitmap::createFromFile(paths[index], true /* top-down */);
+            if (!pReference)
+            {
+                EXPECT(pDecoded == nullptr);
+                return;
+            }
+            ASSERT(pDecoded != nullptr);
+            EXPECT(pDecoded->type == Resource::Type::Texture2D);
+            EXPECT(pDecoded->format == linearToSrgbFormat(pReference->getFormat()));
+            EXPECT_EQ(pDecoded->width, pReference->getWidth());
+            EXPECT_EQ(pDecoded->height, pReference->getHeight());
+            EXPECT_EQ(pDecoded->mipLevels, 1);
+            EXPECT(pDecoded->sourcePath == paths[index]);
+            ASSERT_EQ(pDecoded->getSize(), pReference->getSize());
+            EXPECT(std::memcmp(pDecoded->getData(), pReference->getData(), pReference->getSize()) == 0);
+        }
+    );
+    EXPECT_EQ(expectedIndex, paths.size());
+
+    // With a budget below a single image, at most one decoded image per worker is in flight.
+    const auto& stats = decoder.getStats();
+    EXPECT_EQ(stats.decodedCount, 24);
+    EXPECT_EQ(stats.failedCount, 1);
+    size_t maxImageSize = 0;
+    for (uint32_t i = 0; i < 24; ++i)
+        maxImageSize = std::max<size_t>(maxImageSize, (8 + 4 * i) * (4 + 2 * (i % 5)) * 4);
+    EXPECT_LE(stats.peakBytesInFlight, options.threadCount * maxImageSize);
+
+    std::filesystem::remove_all(dir);
+}
+
+CPU_TEST(TextureDecoder_ConsumerThrows)
+{
+    const auto dir = getRuntimeDirectory() / "test_texture_decoder_throw";
+    const auto paths = writeTestImages(dir, 8);
+
+    std::vector<TextureDecoder::Request> requests;
+    for (const auto& path : paths)
+        requests.push_back(TextureDecoder::Request{{path}});
+
+    TextureDecoder decoder;
+    size_t consumedCount = 0;
+    auto consumer = [&](size_t index, std::unique_ptr<DecodedTexture> pDecoded)
+    {
+        if (index == 3)
+            FALCOR_THROW("Stop");
+        consumedCount++;
+    };
+
+    // Outstanding decodes are cancelled and the exception is propagated to the caller.
+    EXPECT_THROW(decoder.decodeAll(requests, consumer));
+    EXPECT_EQ(consumedCount, 3);
+
+    std::filesystem::remove_all(dir);
+}
+
+CPU_TEST(TextureDecoder_Mipped)
+{
+    std::vector<std::filesystem::path> paths;
+    for (uint32_t i = 0; i < 3; ++i)
+        paths.push_back(getRuntimeDirectory() / fmt::format("data/tests/tiny_mip{}.png", i));
+
+    auto pDecoded = TextureDecoder::decode(TextureDecoder::Request{paths});
+    ASSERT(pDecoded != nullptr);
+    EXPECT_EQ(pDecoded->width, 4);
+    EXPECT_EQ(pDecoded->height, 4);
+    EXPECT_EQ(pDecoded->mipLevels, 3);
+    EXPECT(pDecoded->sourcePath == paths[0]);
+
+    size_t expectedSize = 0;
+    for (const auto& path : paths)
+        expectedSize += Bitmap::createFromFile(path, true /* top-down */)->getSize();
+    EXPECT_EQ(pDecoded->getSize(), expectedSize);
+}
+
+CPU_TEST(TextureDecoder_NormalMap)
+{
+    // Columns alternate between two unit normals tilted in opposite directions. They average to (0, 0, 0.8).
+    const uint32_t size = 4;
+    std::vector<uint8_t> data(size * size * 4);
+    for (uint32_t i = 0; i < size * size; ++i)
+    {
+        const float3 n((i % 2) ? 0.6f : -0.6f, 0.f, 0.8f);
+        for (uint32_t c = 0; c < 3; ++c)
+            data[i * 4 + c] = uint8_t((n[c] * 0.5f + 0.5f) * 255.f + 0.5f);
+        data[i * 4 + 3] = 255;
+    }
+    const auto path = getRuntimeDirectory() / "test_texture_decoder_normal.png";
+    Bitmap::saveImage(
+        path, size, size, Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::ExportAlpha, ResourceFormat::RGBA8Unorm, true, data.data()
+    );
+
+    // Only textures marked as normal maps have their mips renormalized.
+    auto getLastMipZ = [&](Bitmap::ImportFlags importFlags)
+    {
+        auto pDecoded = TextureDecoder::decode(TextureDecoder::Request{{path}, true, false, importFlags});
+        FALCOR_CHECK(pDecoded && pDecoded->mipLevels == 3, "Failed to decode '{}' with mips.", path);
+        const uint8_t* pLastMip = pDecoded->getData() + pDecoded->getSize() - 4;
+        return pDecoded->format == ResourceFormat::BGRA8Unorm ? pLastMip[0] : pLastMip[2];
+    };
+    EXPECT_GE(getLastMipZ(Bitmap::ImportFlags::NormalMap), 253);
+    EXPECT_LE(getLastMipZ(Bitmap::ImportFlags::None), 232);
+
+    std::filesystem::remove(path);
+}
+
+CPU_TEST(TextureDecoder_Benchmark)
+{
+    // Measures decode throughput over a folder of PNG/JPG/EXR files. Set FALCOR_TEXTURE_DECODE_BENCHMARK_DIR to a folder
+    // with a few thousand textures to run it.
+    auto dir = getEnvironmentVariable("FALCOR_TEXTURE_DECODE_BENCHMARK_DIR");
+    if (!dir)
+        ctx.skip("FALCOR_TEXTURE_DECODE_BENCHMARK_DIR is not set");
+
+    std::vector<TextureDecoder::Request> requests;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(*dir))
+    {
+        const auto& path = entry.path();
+        if (entry.is_regular_file() &&
+            (hasExtension(path, "png") || hasExtension(path, "jpg") || hasExtension(path, "jpeg") || hasExtension(path, "exr")))
+            requests.push_back(TextureDecoder::Request{{path}});
+    }
+    std::sort(requests.begin(), requests.end(), [](const auto& a, const auto& b) { return a.paths[0] < b.paths[0]; });
+    if (requests.empty())
+        ctx.skip("No PNG/JPG/EXR files found");
+
+    const size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    double serialFilesPerSecond = 0.0;
+    for (size_t threadCount : {size_t(1), hardwareThreads})
+    {
+        TextureDecoder::Options options;
+        options.threadCount = threadCount;
+        options.maxBytesInFlight = size_t(256) << 20;
+        TextureDecoder decoder(options);
+
+        uint64_t checksum = 0;
+        decoder.decodeAll(
+            requests,
+            [&](size_t index, std::unique_ptr<DecodedTexture> pDecoded)
+            {
+                if (pDecoded)
+                    checksum += pDecoded->getSize();
+            }
+        );
+
+        const auto& stats = decoder.getStats();
+        EXPECT_EQ(stats.decodedBytes, checksum);
+        const double filesPerSecond = requests.size() / stats.elapsedTime;
+        if (threadCount == 1)
+            serialFilesPerSecond = filesPerSecond;
+        logInfo(
+            "TextureDecoder {} files on {} threads: {:.1f} files/s, {:.1f} MB/s, speedup {:.2f}x, peak {:.1f} MB in flight, "
+            "throttled {:.2f} s, {} failed",
+            requests.size(),
+            threadCount,
+            filesPerSecond,
+            stats.decodedBytes / double(1 << 20) / stats.elapsedTime,
+            filesPerSecond / serialFilesPerSecond,
+            stats.peakBytesInFlight / double(1 << 20),
+            stats.throttleTime,
+            stats.failedCount
+        );
+    }
+}
+} // namespace Falcor
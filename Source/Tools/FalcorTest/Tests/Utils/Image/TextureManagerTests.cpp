@@ -51,4 +51,38 @@ GPU_TEST(TextureManager_LoadMips)
     EXPECT_EQ(tex->getMipCount(), 3);
     EXPECT_EQ(tex->getArraySize(), 1);
 }
+
+GPU_TEST(TextureManager_DeferredLoading)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    TextureManager textureManager(pDevice, 10, 2);
+
+    std::filesystem::path mippedPath = getRuntimeDirectory() / "data/tests/tiny_<MIP>.png";
+    std::filesystem::path singlePath = getRuntimeDirectory() / "data/tests/tiny_mip1.png";
+
+    textureManager.beginDeferredLoading();
+    auto mippedHandle = textureManager.loadTexture(mippedPath, false, false, ResourceBindFlags::ShaderResource, false);
+    auto singleHandle = textureManager.loadTexture(singlePath, true, true, ResourceBindFlags::ShaderResource, false);
+    auto missingHandle = textureManager.loadTexture(
+        getRuntimeDirectory() / "data/tests/does_not_exist.png", false, false, ResourceBindFlags::ShaderResource, false
+    );
+    EXPECT(mippedHandle.isValid());
+    EXPECT(singleHandle.isValid());
+    EXPECT(!missingHandle.isValid());
+    EXPECT(textureManager.getTexture(mippedHandle) == nullptr);
+    textureManager.endDeferredLoading();
+
+    auto mippedTex = textureManager.getTexture(mippedHandle);
+    ASSERT(mippedTex != nullptr);
+    EXPECT_EQ(mippedTex->getWidth(), 4);
+    EXPECT_EQ(mippedTex->getMipCount(), 3);
+
+    auto singleTex = textureManager.getTexture(singleHandle);
+    ASSERT(singleTex != nullptr);
+    EXPECT_EQ(singleTex->getWidth(), 2);
+    EXPECT_EQ(singleTex->getMipCount(), 2);
+    EXPECT(isSrgbFormat(singleTex->getFormat()));
+    EXPECT(singleTex->getSourcePath() == singlePath);
+}
 } // namespace Falcor
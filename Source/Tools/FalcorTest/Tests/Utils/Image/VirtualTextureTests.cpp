@@ -0,0 +1,378 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/MipGenerator.h"
+#include "Utils/Image/VirtualTexture.h"
+#include <random>
+#include <set>
+
+namespace Falcor
+{
+namespace
+{
+/// Write a tiled RGBA8 texture where each texel encodes its coordinates: (x, y, mip, 255).
+std::shared_ptr<TiledTextureFile> createTiledTexture(
+    const std::filesystem::path& path,
+    uint32_t width,
+    uint32_t height,
+    uint32_t tileSize,
+    uint32_t borderSize
+)
+{
+    TiledTextureFile::Desc desc;
+    desc.format = ResourceFormat::RGBA8Unorm;
+    desc.width = width;
+    desc.height = height;
+    desc.mipCount = MipGenerator::getMipCount(width, height);
+    desc.tileSize = tileSize;
+    desc.borderSize = borderSize;
+
+    std::vector<uint8_t> data;
+    for (uint32_t mip = 0; mip < desc.mipCount; ++mip)
+    {
+        const uint32_t mipWidth = std::max(1u, width >> mip);
+        const uint32_t mipHeight = std::max(1u, height >> mip);
+        for (uint32_t y = 0; y < mipHeight; ++y)
+        {
+            for (uint32_t x = 0; x < mipWidth; ++x)
+            {
+                data.push_back(uint8_t(x));
+                data.push_back(uint8_t(y));
+                data.push_back(uint8_t(mip));
+                data.push_back(255);
+            }
+        }
+    }
+
+    std::filesystem::create_directories(path.parent_path());
+    TiledTextureFile::write(path, desc, data.data());
+    return std::make_shared<TiledTextureFile>(path);
+}
+
+/// Feedback of a view covering a rectangle of tiles at a mip level, with each tile written multiple times.
+std::vector<uint32_t> createFeedback(uint32_t textureId, uint32_t mip, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1)
+{
+    std::vector<uint32_t> feedback;
+    for (uint32_t y = y0; y < y1; ++y)
+    {
+        for (uint32_t x = x0; x < x1; ++x)
+        {
+            for (uint32_t i = 0; i < 4; ++i)
+                feedback.push_back(TileId{textureId, mip, x, y}.pack());
+        }
+    }
+    feedback.push_back(TileId::kInvalid);
+    return feedback;
+}
+} // namespace
+
+CPU_TEST(VirtualTexture_TileId)
+{
+    const TileId tile{1022, 15, 511, 300};
+    const TileId unpacked = TileId::unpack(tile.pack());
+    EXPECT_EQ(unpacked.textureId, 1022);
+    EXPECT_EQ(unpacked.mip, 15);
+    EXPECT_EQ(unpacked.x, 511);
+    EXPECT_EQ(unpacked.y, 300);
+    const TileId lastTile{TileId::kMaxTextureCount - 1, TileId::kMaxMipCount - 1, TileId::kMaxTileCount - 1, TileId::kMaxTileCount - 1};
+    EXPECT(lastTile.pack() != TileId::kInvalid);
+}
+
+CPU_TEST(VirtualTexture_TiledTextureFile)
+{
+    const auto path = getRuntimeDirectory() / "test_virtual_texture/file.fttf";
+    auto pFile = createTiledTexture(path, 300, 200, 64, 2);
+
+    const auto& desc = pFile->getDesc();
+    EXPECT(desc.format == ResourceFormat::RGBA8Unorm);
+    EXPECT_EQ(desc.width, 300);
+    EXPECT_EQ(desc.height, 200);
+    EXPECT_EQ(desc.mipCount, 9);
+    EXPECT_EQ(pFile->getTileCountX(0), 5);
+    EXPECT_EQ(pFile->getTileCountY(0), 4);
+    EXPECT_EQ(pFile->getTileCountX(2), 2);
+    EXPECT_EQ(pFile->getTileCountY(8), 1);
+    EXPECT_EQ(pFile->getPaddedTileSize(), 68);
+    EXPECT_EQ(pFile->getTileDataSize(), 68 * 68 * 4);
+
+    // Check texels of a few tiles, including the borders clamped at the texture edges.
+    std::vector<uint8_t> tile(pFile->getTileDataSize());
+    for (auto [mip, tx, ty] : {std::array<uint32_t, 3>{0, 0, 0}, {0, 4, 3}, {1, 1, 0}, {8, 0, 0}})
+    {
+        pFile->readTile(mip, tx, ty, tile.data());
+        const int32_t mipWidth = std::max(1, 300 >> mip);
+        const int32_t mipHeight = std::max(1, 200 >> mip);
+        for (uint32_t y = 0; y < 68; ++y)
+        {
+            for (uint32_t x = 0; x < 68; ++x)
+            {
+                const int32_t srcX = std::clamp((int32_t)(tx * 64 + x) - 2, 0, mipWidth - 1);
+                const int32_t srcY = std::clamp((int32_t)(ty * 64 + y) - 2, 0, mipHeight - 1);
+                const uint8_t* pTexel = &tile[(y * 68 + x) * 4];
+                EXPECT_EQ(pTexel[0], uint8_t(srcX));
+                EXPECT_EQ(pTexel[1], uint8_t(srcY));
+                EXPECT_EQ(pTexel[2], mip);
+            }
+        }
+    }
+
+    EXPECT_THROW(pFile->readTile(0, 5, 0, tile.data()));
+    EXPECT_THROW(TiledTextureFile(getRuntimeDirectory() / "test_virtual_texture/missing.fttf"));
+
+    pFile.reset();
+    std::filesystem::remove_all(path.parent_path());
+}
+
+CPU_TEST(VirtualTexture_PageTable)
+{
+    TiledTextureFile::Desc desc;
+    desc.width = 1024;
+    desc.height = 512;
+    desc.mipCount = 11;
+    desc.tileSize = 128;
+    PageTable pageTable(desc);
+
+    EXPECT_EQ(pageTable.getTileCountX(0), 8);
+    EXPECT_EQ(pageTable.getTileCountY(0), 4);
+    EXPECT_EQ(pageTable.getTileCountX(3), 1);
+    EXPECT_EQ(pageTable.getEntries().size(), 8 * 4 + 4 * 2 + 2 * 1 + 8);
+
+    pageTable.update();
+    EXPECT_EQ(pageTable.getEntry(0, 5, 3), PageTable::kNotResident);
+
+    // All tiles fall back to the coarsest resident tile.
+    pageTable.map(10, 0, 0, 7);
+    pageTable.update();
+    EXPECT_EQ(pageTable.getEntry(0, 5, 3), PageTable::packEntry(7, 10));
+    EXPECT_EQ(pageTable.getEntry(4, 0, 0), PageTable::packEntry(7, 10));
+
+    // Finer tiles take over their descendants only.
+    pageTable.map(1, 2, 1, 3);
+    pageTable.update();
+    EXPECT_EQ(pageTable.getEntry(1, 2, 1), PageTable::packEntry(3, 1));
+    EXPECT_EQ(pageTable.getEntry(0, 5, 3), PageTable::packEntry(3, 1));
+    EXPECT_EQ(pageTable.getEntry(0, 4, 2), PageTable::packEntry(3, 1));
+    EXPECT_EQ(pageTable.getEntry(0, 3, 3), PageTable::packEntry(7, 10));
+    EXPECT_EQ(PageTable::getEntrySlot(pageTable.getEntry(0, 5, 3)), 3);
+    EXPECT_EQ(PageTable::getEntryMip(pageTable.getEntry(0, 5, 3)), 1);
+    EXPECT_EQ(pageTable.getResidentCount(), 2);
+
+    pageTable.unmap(1, 2, 1);
+    EXPECT(pageTable.isDirty());
+    pageTable.update();
+    EXPECT_EQ(pageTable.getEntry(0, 5, 3), PageTable::packEntry(7, 10));
+    EXPECT_EQ(pageTable.getResidentCount(), 1);
+
+    // The last tile of a level with an odd tile count maps to the last tile of the next level.
+    desc.width = 384;
+    desc.height = 128;
+    desc.mipCount = 9;
+    PageTable oddPageTable(desc);
+    EXPECT_EQ(oddPageTable.getTileCountX(0), 3);
+    EXPECT_EQ(oddPageTable.getTileCountX(1), 2);
+    uint32_t mip = 0, x = 2, y = 0;
+    oddPageTable.getParent(mip, x, y);
+    EXPECT_EQ(mip, 1);
+    EXPECT_EQ(x, 1);
+}
+
+CPU_TEST(VirtualTexture_TileCache)
+{
+    TileCache cache(3);
+
+    auto a = cache.allocate(1, 1);
+    auto b = cache.allocate(2, 1);
+    auto c = cache.allocate(3, 2);
+    ASSERT(a && b && c);
+    EXPECT_EQ(a->evictedTile, TileCache::kNoTile);
+    EXPECT_EQ(cache.getResidentCount(), 3);
+
+    // Tiles used in the current frame are not evicted.
+    EXPECT(cache.touch(1, 3));
+    EXPECT(cache.touch(2, 3));
+    EXPECT(cache.touch(3, 3));
+    EXPECT(!cache.allocate(4, 3));
+
+    // The least recently used tile is evicted.
+    EXPECT(cache.touch(1, 4));
+    auto d = cache.allocate(4, 5);
+    ASSERT(d);
+    EXPECT_EQ(d->evictedTile, 2);
+    EXPECT_EQ(d->slot, b->slot);
+    EXPECT(!cache.find(2));
+    EXPECT(!cache.touch(2, 5));
+
+    // Locked tiles are never evicted.
+    cache.lock(1);
+    auto e = cache.allocate(5, 10);
+    ASSERT(e);
+    EXPECT_EQ(e->evictedTile, 3);
+    auto f = cache.allocate(6, 11);
+    ASSERT(f);
+    EXPECT_EQ(f->evictedTile, 4);
+    EXPECT(cache.find(1));
+
+    cache.release(5);
+    EXPECT_EQ(cache.getResidentCount(), 2);
+    auto g = cache.allocate(7, 11);
+    ASSERT(g);
+    EXPECT_EQ(g->evictedTile, TileCache::kNoTile);
+    EXPECT_EQ(g->slot, e->slot);
+}
+
+CPU_TEST(VirtualTexture_Streaming)
+{
+    const auto dir = getRuntimeDirectory() / "test_virtual_texture";
+    auto pFile = createTiledTexture(dir / "streaming.fttf", 1024, 1024, 128, 4);
+
+    VirtualTextureStreamer::Options options;
+    options.physicalTileCount = 16;
+    options.maxLoadsPerFrame = 8;
+    options.threadCount = 0;
+    VirtualTextureStreamer streamer(options);
+
+    const uint32_t textureId = streamer.addTexture(pFile);
+    const PageTable& pageTable = streamer.getPageTable(textureId);
+
+    // The coarsest mip is resident right away and uploaded by the first update.
+    EXPECT_EQ(pageTable.getEntry(0, 7, 7), PageTable::packEntry(0, 10));
+    auto uploads = streamer.update();
+    ASSERT_EQ(uploads.size(), 1);
+    EXPECT_EQ(uploads[0].tile.mip, 10);
+    EXPECT_EQ(uploads[0].data.size(), pFile->getTileDataSize());
+
+    // Request a single mip 0 tile. The parents are streamed in first.
+    auto feedback = createFeedback(textureId, 0, 3, 5, 4, 6);
+    streamer.processFeedback(feedback);
+    uploads = streamer.update();
+    ASSERT_EQ(uploads.size(), 8);
+    EXPECT_EQ(uploads.front().tile.mip, 9);
+    EXPECT_EQ(uploads.back().tile.mip, 2);
+    EXPECT_EQ(PageTable::getEntryMip(pageTable.getEntry(0, 3, 5)), 2);
+
+    streamer.processFeedback(feedback);
+    uploads = streamer.update();
+    ASSERT_EQ(uploads.size(), 2);
+    EXPECT(pageTable.isResident(0, 3, 5));
+    EXPECT_EQ(pageTable.getEntry(0, 3, 5), PageTable::packEntry(uploads.back().slot, 0));
+
+    // Check the uploaded tile data.
+    const uint8_t* pTexel = &uploads.back().data[(4 * pFile->getPaddedTileSize() + 4) * 4];
+    EXPECT_EQ(pTexel[0], uint8_t(3 * 128));
+    EXPECT_EQ(pTexel[1], uint8_t(5 * 128));
+
+    // Everything is resident now.
+    streamer.processFeedback(feedback);
+    EXPECT(streamer.update().empty());
+    EXPECT_EQ(streamer.getStats().completedLoads, 10);
+    EXPECT_EQ(streamer.getStats().cacheHits, 1 + 9 + 11);
+
+    // Pan over the texture. Visible tiles are never evicted and the cache never exceeds its capacity.
+    for (uint32_t frame = 0; frame < 40; ++frame)
+    {
+        const uint32_t x0 = (frame / 4) % 7;
+        feedback = createFeedback(textureId, 0, x0, 2, x0 + 2, 3);
+        streamer.processFeedback(feedback);
+        streamer.update();
+        EXPECT_LE(streamer.getTileCache().getResidentCount(), options.physicalTileCount);
+
+        // The missing tiles of a view position fit into the load budget, so they are resident right away.
+        EXPECT(pageTable.isResident(0, x0, 2));
+        EXPECT(pageTable.isResident(0, x0 + 1, 2));
+    }
+    EXPECT(streamer.getStats().evictedTiles > 0);
+    EXPECT_EQ(streamer.getStats().droppedLoads, 0);
+    EXPECT(pageTable.isResident(10, 0, 0));
+
+    // Requests beyond the cache capacity are deferred instead of evicting visible tiles.
+    feedback = createFeedback(textureId, 0, 0, 0, 8, 8);
+    for (uint32_t frame = 0; frame < 8; ++frame)
+    {
+        streamer.processFeedback(feedback);
+        streamer.update();
+    }
+    EXPECT_EQ(streamer.getTileCache().getResidentCount(), options.physicalTileCount);
+    EXPECT_EQ(streamer.getStats().droppedLoads, 0);
+    EXPECT(streamer.getStats().deferredLoads > 0);
+
+    // Invalid feedback is ignored.
+    const uint32_t invalid[] = {TileId{textureId + 1, 0, 0, 0}.pack(), TileId{textureId, 0, 8, 0}.pack()};
+    streamer.processFeedback(invalid);
+    EXPECT_EQ(streamer.getStats().invalidFeedback, 2);
+
+    pFile.reset();
+    std::filesystem::remove_all(dir);
+}
+
+CPU_TEST(VirtualTexture_StreamingAsync)
+{
+    const auto dir = getRuntimeDirectory() / "test_virtual_texture_async";
+    auto pFile = createTiledTexture(dir / "streaming.fttf", 2048, 1024, 64, 2);
+
+    VirtualTextureStreamer::Options options;
+    options.physicalTileCount = 256;
+    options.maxLoadsPerFrame = 32;
+    options.threadCount = 4;
+    options.prefetchNeighbors = true;
+    VirtualTextureStreamer streamer(options);
+    const uint32_t textureId = streamer.addTexture(pFile);
+    const PageTable& pageTable = streamer.getPageTable(textureId);
+
+    // Random synthetic feedback of a view at mip 1, until all requested tiles are resident.
+    std::mt19937 rng(1);
+    std::vector<uint32_t> feedback;
+    for (uint32_t i = 0; i < 1000; ++i)
+        feedback.push_back(TileId{textureId, 1, uint32_t(rng() % 8), uint32_t(rng() % 8)}.pack());
+
+    std::set<uint32_t> uploadedSlots;
+    for (uint32_t frame = 0; frame < 100; ++frame)
+    {
+        streamer.processFeedback(feedback);
+        for (const auto& upload : streamer.update())
+        {
+            EXPECT_EQ(upload.data.size(), pFile->getTileDataSize());
+            EXPECT_EQ(upload.data[2], upload.tile.mip);
+            uploadedSlots.insert(upload.slot);
+        }
+        streamer.waitForLoads();
+    }
+
+    for (uint32_t packed : feedback)
+    {
+        const TileId tile = TileId::unpack(packed);
+        EXPECT(pageTable.isResident(tile.mip, tile.x, tile.y));
+    }
+    EXPECT_EQ(streamer.getPendingLoadCount(), 0);
+    EXPECT_EQ(uploadedSlots.size(), streamer.getTileCache().getResidentCount());
+    // Neighbors were prefetched.
+    EXPECT(pageTable.isResident(1, 8, 0));
+
+    pFile.reset();
+    std::filesystem::remove_all(dir);
+}
+} // namespace Falcor
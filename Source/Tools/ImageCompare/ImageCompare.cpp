@@ -25,9 +25,17 @@
  # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
-#include <FreeImage.h>
+#include "Image.h"
+#include "ImageMetrics.h"
+
 #include <args.hxx>
+#include <nlohmann/json.hpp>
+#include <BS_thread_pool/BS_thread_pool.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -40,154 +48,6 @@
 #include <cmath>
 #include <cstring>
 
-template<typename T>
-T sqr(T x)
-{
-    return x * x;
-}
-
-template<typename T>
-T lerp(T a, T b, T t)
-{
-    return a + t * (b - a);
-}
-
-template<typename T>
-T clamp(T x, T lo, T hi)
-{
-    return std::max(lo, std::min(hi, x));
-}
-
-class Image
-{
-public:
-    Image(uint32_t width, uint32_t height) : mWidth(width), mHeight(height), mData(std::make_unique<float[]>(width * height * 4)) {}
-
-    uint32_t getWidth() const { return mWidth; }
-    uint32_t getHeight() const { return mHeight; }
-    const float* getData() const { return mData.get(); }
-    float* getData() { return mData.get(); }
-
-    static std::shared_ptr<Image> create(uint32_t width, uint32_t height) { return std::make_shared<Image>(width, height); }
-
-    static std::shared_ptr<Image> loadFromFile(const std::filesystem::path& path)
-    {
-        FREE_IMAGE_FORMAT fifFormat = FIF_UNKNOWN;
-
-        auto pathStr = path.string();
-
-        // Determine file format.
-        fifFormat = FreeImage_GetFileType(pathStr.c_str(), 0);
-        if (fifFormat == FIF_UNKNOWN)
-            fifFormat = FreeImage_GetFIFFromFilename(pathStr.c_str());
-        if (fifFormat == FIF_UNKNOWN)
-            throw std::runtime_error("Unknown image format");
-        if (!FreeImage_FIFSupportsReading(fifFormat))
-            throw std::runtime_error("Unsupported image format");
-
-        // Read image.
-        FIBITMAP* srcBitmap = FreeImage_Load(fifFormat, pathStr.c_str());
-        if (!srcBitmap)
-            throw std::runtime_error("Cannot read image");
-
-        // Convert to RGBA32F.
-        FIBITMAP* floatBitmap = FreeImage_ConvertToRGBAF(srcBitmap);
-        FreeImage_Unload(srcBitmap);
-        if (!floatBitmap)
-            throw std::runtime_error("Cannot convert to RGBA float format");
-
-        // Create image.
-        auto image = create(FreeImage_GetWidth(floatBitmap), FreeImage_GetHeight(floatBitmap));
-        int bytesPerPixel = 4 * sizeof(float);
-        FreeImage_ConvertToRawBits(
-            reinterpret_cast<BYTE*>(image->getData()),
-            floatBitmap,
-            bytesPerPixel * image->getWidth(),
-            bytesPerPixel * 8,
-            FI_RGBA_RED_MASK,
-            FI_RGBA_GREEN_MASK,
-            FI_RGBA_BLUE_MASK,
-            true
-        );
-        FreeImage_Unload(floatBitmap);
-
-        return image;
-    }
-
-    void saveToFile(const std::filesystem::path& path, bool writeAlpha = true) const
-    {
-        FREE_IMAGE_FORMAT fifFormat = FIF_UNKNOWN;
-
-        auto pathStr = path.string();
-
-        // Determine file format.
-        fifFormat = FreeImage_GetFIFFromFilename(pathStr.c_str());
-        if (fifFormat == FIF_UNKNOWN)
-            throw std::runtime_error("Unknown image format");
-        if (!FreeImage_FIFSupportsWriting(fifFormat))
-            throw std::runtime_error("Unsupported image format");
-
-        bool writeFloat = fifFormat == FIF_EXR || fifFormat == FIF_PFM || fifFormat == FIF_HDR;
-        if (fifFormat != FIF_EXR && fifFormat != FIF_PNG)
-            writeAlpha = false;
-
-        // Create bitmap.
-        FIBITMAP* bitmap;
-        const float* src = getData();
-        if (writeFloat)
-        {
-            bitmap = FreeImage_AllocateT(writeAlpha ? FIT_RGBAF : FIT_RGBF, mWidth, mHeight);
-            for (uint32_t y = 0; y < mHeight; y++)
-            {
-                float* dst = reinterpret_cast<float*>(FreeImage_GetScanLine(bitmap, mHeight - y - 1));
-                if (writeAlpha)
-                {
-                    std::memcpy(dst, src, mWidth * 4 * sizeof(float));
-                    src += mWidth * 4;
-                }
-                else
-                {
-                    for (uint32_t x = 0; x < mWidth; ++x)
-                    {
-                        dst[0] = src[0];
-                        dst[1] = src[1];
-                        dst[2] = src[2];
-                        dst += 3;
-                        src += 4;
-                    }
-                }
-            }
-        }
-        else
-        {
-            bitmap = FreeImage_Allocate(mWidth, mHeight, writeAlpha ? 32 : 24);
-            for (uint32_t y = 0; y < mHeight; y++)
-            {
-                uint8_t* dst = reinterpret_cast<uint8_t*>(FreeImage_GetScanLine(bitmap, mHeight - y - 1));
-                for (uint32_t x = 0; x < mWidth; ++x)
-                {
-                    dst[2] = clamp(int(src[0] * 255.f), 0, 255);
-                    dst[1] = clamp(int(src[1] * 255.f), 0, 255);
-                    dst[0] = clamp(int(src[2] * 255.f), 0, 255);
-                    if (writeAlpha)
-                        dst[3] = clamp(int(src[3] * 255.f), 0, 255);
-                    dst += writeAlpha ? 4 : 3;
-                    src += 4;
-                }
-            }
-        }
-
-        // Write image.
-        FreeImage_Save(fifFormat, bitmap, pathStr.c_str());
-        FreeImage_Unload(bitmap);
-    }
-
-private:
-    uint32_t mWidth;
-    uint32_t mHeight;
-    std::unique_ptr<float[]> mData;
-};
-
 struct MSE
 {
     double operator()(const float* a, const float* b, size_t count) const
@@ -233,39 +93,86 @@ struct MAPE
 };
 
 template<typename Metric>
-double compare(const Image& imageA, const Image& imageB, bool alpha, float* errorMap)
+double compare(const Image& imageA, const Image& imageB, const ImageMetrics::Options& options)
 {
-    Metric metric;
-    double sum = 0.0;
-    const float* a = imageA.getData();
-    const float* b = imageB.getData();
-    size_t count = imageA.getWidth() * imageA.getHeight();
-    for (size_t i = 0; i < count; ++i)
+    const uint32_t width = imageA.getWidth();
+    const uint32_t height = imageA.getHeight();
+
+    // Rows are processed in parallel, per-row sums are reduced in order to keep the result deterministic.
+    std::vector<double> rowSums(height, 0.0);
+    auto loop = [&](uint32_t first, uint32_t last)
     {
-        double error = metric(a, b, alpha ? 4 : 3);
-        if (errorMap)
-            *errorMap++ = float(error);
-        sum += error;
-        a += 4;
-        b += 4;
-    }
-    return sum / count;
+        Metric metric;
+        for (uint32_t y = first; y < last; ++y)
+        {
+            const float* a = imageA.getData() + size_t(y) * width * 4;
+            const float* b = imageB.getData() + size_t(y) * width * 4;
+            float* errorMap = options.errorMap ? options.errorMap + size_t(y) * width : nullptr;
+            double sum = 0.0;
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                double error = metric(a, b, options.channelCount);
+                if (errorMap)
+                    *errorMap++ = float(error);
+                sum += error;
+                a += 4;
+                b += 4;
+            }
+            rowSums[y] = sum;
+        }
+    };
+    if (options.pThreadPool)
+        options.pThreadPool->parallelize_loop(0u, height, loop).get();
+    else
+        loop(0, height);
+
+    double sum = 0.0;
+    for (double rowSum : rowSums)
+        sum += rowSum;
+    return sum / (double(width) * height);
 }
 
 struct ErrorMetric
 {
     std::string name;
     std::string desc;
-    std::function<double(const Image& imageA, const Image& imageB, bool alpha, float* errorMap)> compare;
+    bool higherIsBetter; ///< True for similarity metrics (SSIM, PSNR), false for error metrics.
+    double bestValue;    ///< Value for identical images, used as the default threshold.
+    std::function<double(const Image& imageA, const Image& imageB, const ImageMetrics::Options& options)> compare;
 };
 
+static const double kInf = std::numeric_limits<double>::infinity();
+
 static const std::vector<ErrorMetric> errorMetrics = {
-    {"mse", "Mean Squared Error", compare<MSE>},
-    {"rmse", "Relative Mean Squared Error", compare<RMSE>},
-    {"mae", "Mean Absolute Error", compare<MAE>},
-    {"mape", "Mean Absolute Percentage Error", compare<MAPE>},
+    {"mse", "Mean Squared Error", false, 0.0, compare<MSE>},
+    {"rmse", "Relative Mean Squared Error", false, 0.0, compare<RMSE>},
+    {"mae", "Mean Absolute Error", false, 0.0, compare<MAE>},
+    {"mape", "Mean Absolute Percentage Error", false, 0.0, compare<MAPE>},
+    {"psnr", "Peak Signal-to-Noise Ratio in dB (higher is better)", true, kInf, ImageMetrics::computePSNR},
+    {"ssim", "Structural Similarity Index (higher is better)", true, 1.0, ImageMetrics::computeSSIM},
+    {"msssim", "Multi-Scale Structural Similarity Index (higher is better)", true, 1.0, ImageMetrics::computeMSSSIM},
+    {"flip", "LDR-FLIP (image1 is the reference)", false, 0.0,
+     [](const Image& a, const Image& b, const ImageMetrics::Options& options) { return ImageMetrics::computeFLIP(a, b, false, options); }},
+    {"hdrflip", "HDR-FLIP (image1 is the reference)", false, 0.0,
+     [](const Image& a, const Image& b, const ImageMetrics::Options& options) { return ImageMetrics::computeFLIP(a, b, true, options); }},
 };
 
+static const ErrorMetric* findMetric(const std::string& name)
+{
+    auto it = std::find_if(errorMetrics.begin(), errorMetrics.end(), [&name](const ErrorMetric& metric) { return metric.name == name; });
+    return it != errorMetrics.end() ? &(*it) : nullptr;
+}
+
+/// Returns true if the metric value passes the threshold. NaNs always fail, infinities only pass for similarity metrics.
+static bool checkThreshold(const ErrorMetric& metric, double value, double threshold)
+{
+    if (std::isnan(value))
+        return false;
+    if (metric.higherIsBetter)
+        return value >= threshold;
+    return !std::isinf(value) && value <= threshold;
+}
+
 static std::shared_ptr<Image> generateHeatMap(uint32_t width, uint32_t height, const float* errorMap)
 {
     auto writeColor = [](float t, float* dst)
@@ -301,9 +208,9 @@ static std::shared_ptr<Image> generateHeatMap(uint32_t width, uint32_t height, c
 static bool compareImages(
     const std::filesystem::path& pathA,
     const std::filesystem::path& pathB,
-    ErrorMetric metric,
-    float threshold,
-    bool alpha,
+    const ErrorMetric& metric,
+    double threshold,
+    ImageMetrics::Options options,
     const std::filesystem::path& heatMapPath
 )
 {
@@ -332,12 +239,11 @@ static bool compareImages(
         }
     };
 
-    // Load images.
-    auto imageA = loadImage(pathA);
-    if (!imageA)
-        return false;
+    // Load images, decoding both in parallel.
+    auto futureA = options.pThreadPool->submit(loadImage, pathA);
     auto imageB = loadImage(pathB);
-    if (!imageB)
+    auto imageA = futureA.get();
+    if (!imageA || !imageB)
         return false;
 
     // Check resolution.
@@ -351,8 +257,9 @@ static bool compareImages(
     uint32_t height = imageB->getHeight();
 
     // Compare images.
-    std::unique_ptr<float[]> errorMap = heatMapPath.empty() ? nullptr : std::make_unique<float[]>(width * height);
-    double error = metric.compare(*imageA, *imageB, alpha, errorMap.get());
+    std::unique_ptr<float[]> errorMap = heatMapPath.empty() ? nullptr : std::make_unique<float[]>(size_t(width) * height);
+    options.errorMap = errorMap.get();
+    double error = metric.compare(*imageA, *imageB, options);
 
     // Generate heat map.
     if (errorMap)
@@ -363,11 +270,176 @@ static bool compareImages(
 
     std::cout << error << std::endl;
 
-    // Treat nans and infs as errors.
-    if (std::isnan(error) || std::isinf(error))
+    return checkThreshold(metric, error, threshold);
+}
+
+/// JSON cannot represent non-finite numbers, they are written as strings.
+static nlohmann::json toJson(double value)
+{
+    if (std::isnan(value))
+        return "nan";
+    if (std::isinf(value))
+        return value > 0.0 ? "inf" : "-inf";
+    return value;
+}
+
+struct BatchPair
+{
+    std::string name;
+    std::filesystem::path pathA;
+    std::filesystem::path pathB;
+};
+
+/**
+ * Load a batch manifest. The manifest is a JSON array (or an object with a "pairs" array) where each entry is either
+ * an array [image1, image2] or an object {"name": ..., "image1": ..., "image2": ...}. Relative paths are resolved
+ * against the directory of the manifest.
+ */
+static std::vector<BatchPair> loadManifest(const std::filesystem::path& path)
+{
+    std::ifstream stream(path);
+    if (!stream)
+        throw std::runtime_error("Cannot open manifest '" + path.string() + "'");
+    nlohmann::json manifest = nlohmann::json::parse(stream);
+    const nlohmann::json& entries = manifest.is_object() ? manifest.at("pairs") : manifest;
+    if (!entries.is_array())
+        throw std::runtime_error("Manifest must contain an array of image pairs");
+
+    const auto baseDir = path.parent_path();
+    auto resolve = [&baseDir](const std::string& str)
+    {
+        std::filesystem::path p(str);
+        return p.is_absolute() ? p : baseDir / p;
+    };
+
+    std::vector<BatchPair> pairs;
+    pairs.reserve(entries.size());
+    for (const auto& entry : entries)
+    {
+        BatchPair pair;
+        if (entry.is_array() && entry.size() == 2)
+        {
+            pair.pathA = resolve(entry[0].get<std::string>());
+            pair.pathB = resolve(entry[1].get<std::string>());
+        }
+        else if (entry.is_object())
+        {
+            pair.pathA = resolve(entry.at("image1").get<std::string>());
+            pair.pathB = resolve(entry.at("image2").get<std::string>());
+            pair.name = entry.value("name", "");
+        }
+        else
+        {
+            throw std::runtime_error("Invalid manifest entry '" + entry.dump() + "'");
+        }
+        if (pair.name.empty())
+            pair.name = pair.pathB.filename().string();
+        pairs.push_back(std::move(pair));
+    }
+    return pairs;
+}
+
+/**
+ * Compare all image pairs of a manifest and write the results as JSON.
+ * Pairs are distributed over the thread pool, each task decodes and compares one pair.
+ * The threshold applies to the first metric.
+ */
+static bool compareBatch(
+    const std::filesystem::path& manifestPath,
+    const std::vector<const ErrorMetric*>& metrics,
+    double threshold,
+    ImageMetrics::Options options,
+    const std::filesystem::path& outputPath
+)
+{
+    std::vector<BatchPair> pairs;
+    try
+    {
+        pairs = loadManifest(manifestPath);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Cannot load manifest (Error: " << e.what() << ")." << std::endl;
         return false;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    BS::thread_pool& pool = *options.pThreadPool;
+    // Parallelism is over pairs, the metrics themselves run single threaded.
+    options.pThreadPool = nullptr;
+
+    std::vector<nlohmann::json> results(pairs.size());
+    std::vector<char> passed(pairs.size(), 0);
+    pool.parallelize_loop(
+            size_t(0),
+            pairs.size(),
+            [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    const auto& pair = pairs[i];
+                    nlohmann::json& result = results[i];
+                    result["name"] = pair.name;
+                    result["image1"] = pair.pathA.string();
+                    result["image2"] = pair.pathB.string();
+                    try
+                    {
+                        auto imageA = Image::loadFromFile(pair.pathA);
+                        auto imageB = Image::loadFromFile(pair.pathB);
+                        if (imageA->getWidth() != imageB->getWidth() || imageA->getHeight() != imageB->getHeight())
+                            throw std::runtime_error("Cannot compare images with different resolutions");
+                        nlohmann::json values = nlohmann::json::object();
+                        for (size_t m = 0; m < metrics.size(); ++m)
+                        {
+                            double value = metrics[m]->compare(*imageA, *imageB, options);
+                            values[metrics[m]->name] = toJson(value);
+                            if (m == 0)
+                                passed[i] = checkThreshold(*metrics[m], value, threshold);
+                        }
+                        result["metrics"] = std::move(values);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        result["error"] = e.what();
+                    }
+                    result["passed"] = bool(passed[i]);
+                }
+            },
+            pairs.size()
+        )
+        .get();
+
+    size_t failedCount = std::count(passed.begin(), passed.end(), 0);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    nlohmann::json output;
+    output["metrics"] = nlohmann::json::array();
+    for (const auto& metric : metrics)
+        output["metrics"].push_back(metric->name);
+    output["threshold"] = toJson(threshold);
+    output["pairCount"] = pairs.size();
+    output["failedCount"] = failedCount;
+    output["seconds"] = seconds;
+    output["results"] = std::move(results);
+
+    if (outputPath.empty())
+    {
+        std::cout << output.dump(4) << std::endl;
+    }
+    else
+    {
+        std::ofstream stream(outputPath);
+        if (!stream)
+        {
+            std::cerr << "Cannot write results to '" << outputPath.string() << "'." << std::endl;
+            return false;
+        }
+        stream << output.dump(4) << std::endl;
+        std::cerr << "Compared " << pairs.size() << " image pairs in " << seconds << "s, " << failedCount << " failed." << std::endl;
+    }
 
-    return error <= threshold;
+    return failedCount == 0;
 }
 
 static void printMetrics(std::ostream& stream = std::cout)
@@ -385,12 +457,16 @@ int main(int argc, char** argv)
     parser.helpParams.programName = "ImageCompare";
     args::HelpFlag helpFlag(parser, "help", "Display this help menu.", {'h', "help"});
     args::Flag listMetricsFlag(parser, "", "List available error metrics.", {'l'});
-    args::ValueFlag<std::string> metricFlag(parser, "metric", "The error metric.", {'m'});
-    args::ValueFlag<float> thresholdFlag(parser, "threshold", "The error threshold.", {'t'});
+    args::ValueFlag<std::string> metricFlag(parser, "metric", "The error metric (comma separated list in batch mode).", {'m'});
+    args::ValueFlag<double> thresholdFlag(parser, "threshold", "The error threshold (lower bound for similarity metrics).", {'t'});
     args::Flag alphaFlag(parser, "", "Include alpha channel.", {'a'});
     args::ValueFlag<std::string> heatMapFlag(parser, "filename", "Generate error heat map.", {'e'});
-    args::Positional<std::string> image1(parser, "image1", "The first image.", args::Options::Required);
-    args::Positional<std::string> image2(parser, "image2", "The second image.", args::Options::Required);
+    args::ValueFlag<std::string> batchFlag(parser, "manifest", "Compare all image pairs listed in a JSON manifest.", {'b', "batch"});
+    args::ValueFlag<std::string> outputFlag(parser, "filename", "Write batch results to a JSON file instead of stdout.", {'o', "output"});
+    args::ValueFlag<uint32_t> threadsFlag(parser, "count", "Number of worker threads (default: all cores).", {'j', "threads"});
+    args::ValueFlag<float> ppdFlag(parser, "ppd", "Pixels per degree for FLIP (default: 67.02).", {"ppd"});
+    args::Positional<std::string> image1(parser, "image1", "The first (reference) image.");
+    args::Positional<std::string> image2(parser, "image2", "The second (test) image.");
     args::CompletionFlag completionFlag(parser, {"complete"});
 
     try
@@ -426,28 +502,55 @@ int main(int argc, char** argv)
         return 0;
     }
 
-    ErrorMetric metric = errorMetrics.front();
+    if (!batchFlag && (!image1 || !image2))
+    {
+        std::cerr << "Two images or a batch manifest are required." << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    std::vector<const ErrorMetric*> metrics;
     if (metricFlag)
     {
-        auto name = args::get(metricFlag);
-        auto it =
-            std::find_if(errorMetrics.begin(), errorMetrics.end(), [&name](const ErrorMetric& metric) { return metric.name == name; });
-        if (it == errorMetrics.end())
+        std::string names = args::get(metricFlag);
+        for (size_t start = 0; start <= names.size();)
         {
-            std::cerr << "Unknown error metric '" << args::get(metricFlag) << "'." << std::endl;
-            printMetrics(std::cerr);
+            size_t end = std::min(names.find(',', start), names.size());
+            auto name = names.substr(start, end - start);
+            const ErrorMetric* metric = findMetric(name);
+            if (!metric)
+            {
+                std::cerr << "Unknown error metric '" << name << "'." << std::endl;
+                printMetrics(std::cerr);
+                return 1;
+            }
+            metrics.push_back(metric);
+            start = end + 1;
+        }
+        if (!batchFlag && metrics.size() > 1)
+        {
+            std::cerr << "Multiple error metrics are only supported in batch mode." << std::endl;
             return 1;
         }
-        metric = *it;
     }
+    else
+    {
+        metrics.push_back(&errorMetrics.front());
+    }
+
+    BS::thread_pool threadPool(threadsFlag ? args::get(threadsFlag) : 0);
+    ImageMetrics::Options options;
+    options.channelCount = alphaFlag ? 4 : 3;
+    options.pThreadPool = &threadPool;
+    if (ppdFlag)
+        options.pixelsPerDegree = args::get(ppdFlag);
+
+    double threshold = thresholdFlag ? args::get(thresholdFlag) : metrics.front()->bestValue;
 
-    bool success = compareImages(
-        args::get(image1),
-        args::get(image2),
-        metric,
-        thresholdFlag ? args::get(thresholdFlag) : 0.f,
-        alphaFlag ? args::get(alphaFlag) : false,
-        heatMapFlag ? args::get(heatMapFlag) : ""
-    );
+    bool success = false;
+    if (batchFlag)
+        success = compareBatch(args::get(batchFlag), metrics, threshold, options, outputFlag ? args::get(outputFlag) : "");
+    else
+        success = compareImages(args::get(image1), args::get(image2), *metrics.front(), threshold, options, heatMapFlag ? args::get(heatMapFlag) : "");
     return success ? 0 : 1;
 }
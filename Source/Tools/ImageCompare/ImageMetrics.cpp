@@ -0,0 +1,795 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ImageMetrics.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define IMAGE_METRICS_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define IMAGE_METRICS_SSE 1
+#endif
+
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace ImageMetrics
+{
+namespace
+{
+constexpr double kPi = 3.14159265358979323846;
+
+// Rows are filtered in bands of this many rows (plus the filter halo) to keep the working set in cache.
+constexpr uint32_t kBandHeight = 64;
+
+// SSIM parameters (Wang et al. 2004).
+constexpr int kSSIMRadius = 5;
+constexpr float kSSIMSigma = 1.5f;
+constexpr float kSSIMC1 = 0.01f * 0.01f;
+constexpr float kSSIMC2 = 0.03f * 0.03f;
+
+// MS-SSIM scale weights (Wang et al. 2003).
+constexpr std::array<double, 5> kMSSSIMWeights = {0.0448, 0.2856, 0.3001, 0.2363, 0.1333};
+
+// FLIP parameters, see FLIPPass.cs.slang.
+constexpr float kFLIPqc = 0.7f;
+constexpr float kFLIPpc = 0.4f;
+constexpr float kFLIPpt = 0.95f;
+constexpr float kFLIPw = 0.082f;
+constexpr float kFLIPqf = 0.5f;
+
+/// dst[i] += w * src[i] for i in [0, n).
+inline void axpy(float* dst, const float* src, float w, size_t n)
+{
+    size_t i = 0;
+#if defined(IMAGE_METRICS_AVX)
+    const __m256 vw = _mm256_set1_ps(w);
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(vw, _mm256_loadu_ps(src + i))));
+#elif defined(IMAGE_METRICS_SSE)
+    const __m128 vw = _mm_set1_ps(w);
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(vw, _mm_loadu_ps(src + i))));
+#endif
+    for (; i < n; ++i)
+        dst[i] += w * src[i];
+}
+
+/// A separable filter applied to one of the input planes of filterSeparable().
+struct SeparableFilter
+{
+    uint32_t input;                 ///< Index of the input row.
+    const std::vector<float>* pH;   ///< Horizontal kernel of size 2 * radius + 1.
+    const std::vector<float>* pV;   ///< Vertical kernel of size 2 * radius + 1.
+};
+
+/// Writes the planar input rows for image row y. Each row has room for width values.
+using RowInputFunc = std::function<void(uint32_t y, float* const* rows)>;
+/// Consumes the filtered rows (one per filter) for image row y.
+using RowOutputFunc = std::function<void(uint32_t y, const float* const* rows)>;
+
+/**
+ * Apply a set of separable filters to planar input rows. Borders are handled by clamping to the edge.
+ * The image is processed in horizontal bands, each band first filters its rows (including the halo) horizontally
+ * and then produces the output rows with the vertical kernels. Bands are independent and run on the thread pool.
+ * The output callback is invoked concurrently for different rows.
+ */
+void filterSeparable(
+    uint32_t width,
+    uint32_t height,
+    uint32_t inputCount,
+    int radius,
+    const std::vector<SeparableFilter>& filters,
+    const RowInputFunc& input,
+    const RowOutputFunc& output,
+    BS::thread_pool* pThreadPool
+)
+{
+    const size_t taps = 2 * radius + 1;
+    for (const auto& filter : filters)
+    {
+        if (filter.input >= inputCount || filter.pH->size() != taps || filter.pV->size() != taps)
+            throw std::runtime_error("Invalid separable filter");
+    }
+
+    const uint32_t bandCount = (height + kBandHeight - 1) / kBandHeight;
+    const size_t paddedWidth = width + 2 * radius;
+
+    auto processBands = [&](uint32_t firstBand, uint32_t lastBand)
+    {
+        const size_t haloHeight = kBandHeight + 2 * radius;
+        std::vector<float> inputStorage(inputCount * paddedWidth);
+        std::vector<float> horizontalStorage(filters.size() * haloHeight * width);
+        std::vector<float> outputStorage(filters.size() * width);
+        std::vector<float*> inputRows(inputCount);
+        std::vector<const float*> outputRows(filters.size());
+        for (uint32_t i = 0; i < inputCount; ++i)
+            inputRows[i] = inputStorage.data() + i * paddedWidth + radius;
+        for (size_t f = 0; f < filters.size(); ++f)
+            outputRows[f] = outputStorage.data() + f * width;
+
+        for (uint32_t band = firstBand; band < lastBand; ++band)
+        {
+            const int y0 = int(band * kBandHeight);
+            const int y1 = std::min(int(height), y0 + int(kBandHeight));
+
+            // Horizontal pass over the band and its halo.
+            for (int j = y0 - radius; j < y1 + radius; ++j)
+            {
+                input(uint32_t(std::clamp(j, 0, int(height) - 1)), inputRows.data());
+                for (uint32_t i = 0; i < inputCount; ++i)
+                {
+                    float* row = inputRows[i];
+                    std::fill(row - radius, row, row[0]);
+                    std::fill(row + width, row + width + radius, row[width - 1]);
+                }
+                for (size_t f = 0; f < filters.size(); ++f)
+                {
+                    float* dst = horizontalStorage.data() + (f * haloHeight + (j - y0 + radius)) * width;
+                    const float* src = inputRows[filters[f].input] - radius;
+                    const auto& kernel = *filters[f].pH;
+                    std::fill(dst, dst + width, 0.f);
+                    for (size_t k = 0; k < taps; ++k)
+                        if (kernel[k] != 0.f)
+                            axpy(dst, src + k, kernel[k], width);
+                }
+            }
+
+            // Vertical pass.
+            for (int y = y0; y < y1; ++y)
+            {
+                for (size_t f = 0; f < filters.size(); ++f)
+                {
+                    float* dst = outputStorage.data() + f * width;
+                    const float* src = horizontalStorage.data() + (f * haloHeight + (y - y0)) * width;
+                    const auto& kernel = *filters[f].pV;
+                    std::fill(dst, dst + width, 0.f);
+                    for (size_t k = 0; k < taps; ++k)
+                        if (kernel[k] != 0.f)
+                            axpy(dst, src + k * width, kernel[k], width);
+                }
+                output(uint32_t(y), outputRows.data());
+            }
+        }
+    };
+
+    if (pThreadPool && bandCount > 1)
+        pThreadPool->parallelize_loop(0u, bandCount, processBands, bandCount).get();
+    else
+        processBands(0, bandCount);
+}
+
+/// Run func(y) for all rows, in parallel if a thread pool is given.
+void forEachRow(uint32_t height, BS::thread_pool* pThreadPool, const std::function<void(uint32_t y)>& func)
+{
+    auto loop = [&](uint32_t first, uint32_t last)
+    {
+        for (uint32_t y = first; y < last; ++y)
+            func(y);
+    };
+    if (pThreadPool && height > 1)
+        pThreadPool->parallelize_loop(0u, height, loop).get();
+    else
+        loop(0, height);
+}
+
+std::vector<float> createGaussianKernel(int radius, float sigma)
+{
+    std::vector<float> kernel(2 * radius + 1);
+    for (int i = -radius; i <= radius; ++i)
+        kernel[i + radius] = std::exp(-float(i * i) / (2.f * sigma * sigma));
+    float sum = std::accumulate(kernel.begin(), kernel.end(), 0.f);
+    for (auto& w : kernel)
+        w /= sum;
+    return kernel;
+}
+
+void checkResolution(const Image& imageA, const Image& imageB)
+{
+    if (imageA.getWidth() != imageB.getWidth() || imageA.getHeight() != imageB.getHeight())
+        throw std::runtime_error("Cannot compare images with different resolutions");
+}
+
+/// Planar single precision image used for the multi-scale metrics.
+struct Planes
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t channelCount = 0;
+    std::vector<float> data; ///< channelCount planes of width * height values.
+
+    float* plane(uint32_t c) { return data.data() + size_t(c) * width * height; }
+    const float* plane(uint32_t c) const { return data.data() + size_t(c) * width * height; }
+
+    static Planes fromImage(const Image& image, uint32_t channelCount)
+    {
+        Planes planes{image.getWidth(), image.getHeight(), channelCount, {}};
+        planes.data.resize(size_t(channelCount) * planes.width * planes.height);
+        const float* src = image.getData();
+        for (size_t i = 0; i < size_t(planes.width) * planes.height; ++i)
+            for (uint32_t c = 0; c < channelCount; ++c)
+                planes.data[c * size_t(planes.width) * planes.height + i] = src[4 * i + c];
+        return planes;
+    }
+
+    /// Downsample by averaging 2x2 blocks (odd rows/columns are dropped).
+    Planes downsample() const
+    {
+        Planes result{width / 2, height / 2, channelCount, {}};
+        result.data.resize(size_t(channelCount) * result.width * result.height);
+        for (uint32_t c = 0; c < channelCount; ++c)
+        {
+            const float* src = plane(c);
+            float* dst = result.plane(c);
+            for (uint32_t y = 0; y < result.height; ++y)
+            {
+                const float* row0 = src + size_t(2 * y) * width;
+                const float* row1 = row0 + width;
+                for (uint32_t x = 0; x < result.width; ++x)
+                    dst[size_t(y) * result.width + x] = 0.25f * (row0[2 * x] + row0[2 * x + 1] + row1[2 * x] + row1[2 * x + 1]);
+            }
+        }
+        return result;
+    }
+};
+
+struct SSIMResult
+{
+    double ssim; ///< Mean SSIM.
+    double cs;   ///< Mean contrast-structure term.
+};
+
+/**
+ * Compute mean SSIM and mean contrast-structure of two planar images.
+ * The means are taken over pixels whose window lies fully inside the image (all pixels for images smaller than the window).
+ */
+SSIMResult computeSSIMPlanes(const Planes& a, const Planes& b, float* ssimMap, BS::thread_pool* pThreadPool)
+{
+    const uint32_t width = a.width;
+    const uint32_t height = a.height;
+    const uint32_t channelCount = a.channelCount;
+    static const std::vector<float> kGaussian = createGaussianKernel(kSSIMRadius, kSSIMSigma);
+
+    // Per channel inputs: a, b, a^2, b^2, a*b.
+    std::vector<SeparableFilter> filters;
+    for (uint32_t i = 0; i < 5 * channelCount; ++i)
+        filters.push_back({i, &kGaussian, &kGaussian});
+
+    auto input = [&](uint32_t y, float* const* rows)
+    {
+        for (uint32_t c = 0; c < channelCount; ++c)
+        {
+            const float* srcA = a.plane(c) + size_t(y) * width;
+            const float* srcB = b.plane(c) + size_t(y) * width;
+            float* const* dst = rows + 5 * c;
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                dst[0][x] = srcA[x];
+                dst[1][x] = srcB[x];
+                dst[2][x] = srcA[x] * srcA[x];
+                dst[3][x] = srcB[x] * srcB[x];
+                dst[4][x] = srcA[x] * srcB[x];
+            }
+        }
+    };
+
+    // Only pixels with the window fully inside the image contribute to the mean (like skimage).
+    const bool crop = width > 2 * kSSIMRadius && height > 2 * kSSIMRadius;
+    const uint32_t x0 = crop ? kSSIMRadius : 0;
+    const uint32_t x1 = crop ? width - kSSIMRadius : width;
+    const uint32_t y0 = crop ? kSSIMRadius : 0;
+    const uint32_t y1 = crop ? height - kSSIMRadius : height;
+
+    // Per-row sums are reduced in order afterwards to keep the result independent of the thread count.
+    std::vector<double> rowSSIM(height, 0.0);
+    std::vector<double> rowCS(height, 0.0);
+
+    auto output = [&](uint32_t y, const float* const* rows)
+    {
+        const bool inside = y >= y0 && y < y1;
+        double sumSSIM = 0.0;
+        double sumCS = 0.0;
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            float ssim = 0.f;
+            float cs = 0.f;
+            for (uint32_t c = 0; c < channelCount; ++c)
+            {
+                const float* const* m = rows + 5 * c;
+                float muA = m[0][x];
+                float muB = m[1][x];
+                float varA = m[2][x] - muA * muA;
+                float varB = m[3][x] - muB * muB;
+                float cov = m[4][x] - muA * muB;
+                float l = (2.f * muA * muB + kSSIMC1) / (muA * muA + muB * muB + kSSIMC1);
+                float s = (2.f * cov + kSSIMC2) / (varA + varB + kSSIMC2);
+                ssim += l * s;
+                cs += s;
+            }
+            ssim /= channelCount;
+            cs /= channelCount;
+            if (ssimMap)
+                ssimMap[size_t(y) * width + x] = ssim;
+            if (inside && x >= x0 && x < x1)
+            {
+                sumSSIM += ssim;
+                sumCS += cs;
+            }
+        }
+        rowSSIM[y] = sumSSIM;
+        rowCS[y] = sumCS;
+    };
+
+    filterSeparable(width, height, 5 * channelCount, kSSIMRadius, filters, input, output, pThreadPool);
+
+    const double count = double(x1 - x0) * double(y1 - y0);
+    return {
+        std::accumulate(rowSSIM.begin(), rowSSIM.end(), 0.0) / count,
+        std::accumulate(rowCS.begin(), rowCS.end(), 0.0) / count,
+    };
+}
+
+// FLIP color space helpers, see Utils/Color/ColorHelpers.slang.
+
+using float3 = std::array<float, 3>;
+
+constexpr float3 kD65 = {0.950428545f, 1.000000000f, 1.088900371f};
+constexpr float3 kInvD65 = {1.052156925f, 1.000000000f, 0.918357670f};
+
+float sRGBToLinear(float srgb)
+{
+    return srgb <= 0.04045f ? srgb * (1.0f / 12.92f) : std::pow((srgb + 0.055f) * (1.0f / 1.055f), 2.4f);
+}
+
+float3 linearRGBToXYZ(const float3& c)
+{
+    return {
+        (10135552.0f / 24577794.0f) * c[0] + (8788810.0f / 24577794.0f) * c[1] + (4435075.0f / 24577794.0f) * c[2],
+        (2613072.0f / 12288897.0f) * c[0] + (8788810.0f / 12288897.0f) * c[1] + (887015.0f / 12288897.0f) * c[2],
+        (1425312.0f / 73733382.0f) * c[0] + (8788810.0f / 73733382.0f) * c[1] + (70074185.0f / 73733382.0f) * c[2],
+    };
+}
+
+float3 XYZToLinearRGB(const float3& c)
+{
+    return {
+        3.241003275f * c[0] - 1.537398934f * c[1] - 0.498615861f * c[2],
+        -0.969224334f * c[0] + 1.875930071f * c[1] + 0.041554224f * c[2],
+        0.055639423f * c[0] - 0.204011202f * c[1] + 1.057148933f * c[2],
+    };
+}
+
+float3 linearRGBToYCxCz(const float3& c)
+{
+    float3 xyz = linearRGBToXYZ(c);
+    float X = xyz[0] * kInvD65[0];
+    float Y = xyz[1] * kInvD65[1];
+    float Z = xyz[2] * kInvD65[2];
+    return {116.0f * Y - 16.0f, 500.0f * (X - Y), 200.0f * (Y - Z)};
+}
+
+float3 YCxCzToLinearRGB(const float3& c)
+{
+    float Y = (c[0] + 16.0f) / 116.0f;
+    float X = c[1] / 500.0f + Y;
+    float Z = Y - c[2] / 200.0f;
+    return XYZToLinearRGB({X * kD65[0], Y * kD65[1], Z * kD65[2]});
+}
+
+float3 linearRGBToCIELab(const float3& c)
+{
+    float3 xyz = linearRGBToXYZ(c);
+    const float delta = 6.0f / 29.0f;
+    const float deltaCube = delta * delta * delta;
+    const float factor = 1.0f / (3.0f * delta * delta);
+    const float term = 4.0f / 29.0f;
+    float3 t;
+    for (int i = 0; i < 3; ++i)
+    {
+        float v = xyz[i] * kInvD65[i];
+        t[i] = v > deltaCube ? std::cbrt(v) : factor * v + term;
+    }
+    return {116.0f * t[1] - 16.0f, 500.0f * (t[0] - t[1]), 200.0f * (t[1] - t[2])};
+}
+
+float3 hunt(const float3& c)
+{
+    float h = 0.01f * c[0];
+    return {c[0], h * c[1], h * c[2]};
+}
+
+float hyAB(const float3& a, const float3& b)
+{
+    return std::fabs(a[0] - b[0]) + std::sqrt(sqr(a[1] - b[1]) + sqr(a[2] - b[2]));
+}
+
+float3 toneMapACES(const float3& c)
+{
+    // ACES approximation with pre-exposure cancellation, see RenderPasses/FLIPPass/ToneMappers.slang.
+    const float k0 = 0.6f * 0.6f * 2.51f;
+    const float k1 = 0.6f * 0.03f;
+    const float k3 = 0.6f * 0.6f * 2.43f;
+    const float k4 = 0.6f * 0.59f;
+    const float k5 = 0.14f;
+    float3 result;
+    for (int i = 0; i < 3; ++i)
+    {
+        float nom = k0 * c[i] * c[i] + k1 * c[i];
+        float denom = k3 * c[i] * c[i] + k4 * c[i] + k5;
+        if (std::isinf(denom))
+            denom = 1.f;
+        result[i] = clamp(nom / denom, 0.f, 1.f);
+    }
+    return result;
+}
+
+/// Exposure range for HDR-FLIP, see FLIPPass::computeExposureParameters().
+struct ExposureRange
+{
+    float start;
+    float delta;
+    uint32_t count;
+};
+
+ExposureRange computeExposureRange(const Image& reference)
+{
+    const size_t pixelCount = size_t(reference.getWidth()) * reference.getHeight();
+    std::vector<float> luminance(pixelCount);
+    const float* src = reference.getData();
+    for (size_t i = 0; i < pixelCount; ++i)
+        luminance[i] = 0.2126f * src[4 * i] + 0.7152f * src[4 * i + 1] + 0.0722f * src[4 * i + 2];
+
+    // Median and maximum luminance.
+    std::sort(luminance.begin(), luminance.end());
+    float median = (pixelCount & 1) ? luminance[pixelCount / 2] : 0.5f * (luminance[pixelCount / 2 - 1] + luminance[pixelCount / 2]);
+    float max = luminance.back();
+
+    // Find the input value that the ACES tone mapper maps to t = 0.85.
+    const float t = 0.85f;
+    const float a = 0.6f * 0.6f * 2.51f - t * 0.6f * 0.6f * 2.43f;
+    const float b = 0.6f * 0.03f - t * 0.6f * 0.59f;
+    const float c = -t * 0.14f;
+    float d1 = -0.5f * (b / a);
+    float xMax = d1 + std::sqrt(d1 * d1 - c / a);
+
+    float start = std::log2(xMax / max);
+    float stop = std::log2(xMax / median);
+    uint32_t count = uint32_t(std::max(2.0f, std::ceil(stop - start)));
+    return {start, (stop - start) / (count - 1.0f), count};
+}
+
+/// Precomputed FLIP filter kernels for a given number of pixels per degree.
+struct FLIPKernels
+{
+    int radius;
+    std::vector<float> csfA;       ///< Normalized achromatic CSF.
+    std::vector<float> csfRG;      ///< Normalized red-green CSF.
+    std::vector<float> csfBY1;     ///< First (unnormalized) Gaussian of the blue-yellow CSF.
+    std::vector<float> csfBY2;     ///< Second (unnormalized) Gaussian of the blue-yellow CSF.
+    float weightBY1;               ///< Scale of the first blue-yellow Gaussian including normalization.
+    float weightBY2;               ///< Scale of the second blue-yellow Gaussian including normalization.
+    std::vector<float> gaussian;   ///< Normalized feature Gaussian.
+    std::vector<float> point;      ///< Point (second derivative) kernel, positive and negative lobes normalized separately.
+    std::vector<float> edge;       ///< Edge (first derivative) kernel, positive lobe normalized.
+    float maxDistance;
+
+    explicit FLIPKernels(float pixelsPerDegree)
+    {
+        // Same radius for all filters, see FLIPPass.cs.slang.
+        radius = int(std::ceil(3.0f * std::sqrt(0.04f / (2.0f * float(kPi * kPi))) * pixelsPerDegree));
+        const float dx = 1.0f / pixelsPerDegree;
+        const size_t taps = 2 * radius + 1;
+
+        // The CSF weights a * sqrt(pi / b) * exp(-pi^2 d^2 / b) factor into x and y Gaussians.
+        auto gaussian1D = [&](float b)
+        {
+            std::vector<float> kernel(taps);
+            for (int i = -radius; i <= radius; ++i)
+                kernel[i + radius] = std::exp(-float(kPi * kPi) * sqr(i * dx) / b);
+            return kernel;
+        };
+        auto normalized = [](std::vector<float> kernel)
+        {
+            float sum = std::accumulate(kernel.begin(), kernel.end(), 0.f);
+            for (auto& w : kernel)
+                w /= sum;
+            return kernel;
+        };
+        csfA = normalized(gaussian1D(0.0047f));
+        csfRG = normalized(gaussian1D(0.0053f));
+        csfBY1 = gaussian1D(0.04f);
+        csfBY2 = gaussian1D(0.025f);
+        float scale1 = 34.1f * std::sqrt(float(kPi) / 0.04f);
+        float scale2 = 13.5f * std::sqrt(float(kPi) / 0.025f);
+        float sum1 = std::accumulate(csfBY1.begin(), csfBY1.end(), 0.f);
+        float sum2 = std::accumulate(csfBY2.begin(), csfBY2.end(), 0.f);
+        float norm = scale1 * sum1 * sum1 + scale2 * sum2 * sum2;
+        weightBY1 = scale1 / norm;
+        weightBY2 = scale2 / norm;
+
+        // Feature kernels. The 2D normalization of the FLIPPass shader factors into the 1D normalizations.
+        const float sigma = 0.5f * kFLIPw * pixelsPerDegree;
+        const float sigmaSquared = sigma * sigma;
+        std::vector<float> g(taps);
+        point.resize(taps);
+        edge.resize(taps);
+        for (int i = -radius; i <= radius; ++i)
+        {
+            g[i + radius] = std::exp(-float(i * i) / (2.0f * sigmaSquared));
+            point[i + radius] = (float(i * i) / sigmaSquared - 1.f) * g[i + radius];
+            edge[i + radius] = -float(i) * g[i + radius];
+        }
+        float positiveSum = 0.f, negativeSum = 0.f, edgeSum = 0.f;
+        for (size_t i = 0; i < taps; ++i)
+        {
+            (point[i] >= 0.f ? positiveSum : negativeSum) += std::fabs(point[i]);
+            edgeSum += std::max(edge[i], 0.f);
+        }
+        for (size_t i = 0; i < taps; ++i)
+        {
+            point[i] /= point[i] >= 0.f ? positiveSum : negativeSum;
+            edge[i] /= edgeSum;
+        }
+        gaussian = normalized(g);
+
+        maxDistance =
+            std::pow(hyAB(hunt(linearRGBToCIELab({0.0f, 1.0f, 0.0f})), hunt(linearRGBToCIELab({0.0f, 0.0f, 1.0f}))), kFLIPqc);
+    }
+
+    float redistributeErrors(float colorDifference, float featureDifference) const
+    {
+        float error = std::pow(colorDifference, kFLIPqc);
+        float perceptualCutoff = kFLIPpc * maxDistance;
+        if (error < perceptualCutoff)
+            error *= kFLIPpt / perceptualCutoff;
+        else
+            error = kFLIPpt + ((error - perceptualCutoff) / (maxDistance - perceptualCutoff)) * (1.0f - kFLIPpt);
+        return std::pow(error, 1.0f - featureDifference);
+    }
+};
+
+/**
+ * Compute the LDR-FLIP error map for one exposure.
+ * The callback receives each row of FLIP values.
+ */
+void computeLDRFLIP(
+    const FLIPKernels& kernels,
+    const Image& reference,
+    const Image& test,
+    bool hdr,
+    float exposure,
+    const std::function<void(uint32_t y, const float* values)>& output,
+    BS::thread_pool* pThreadPool
+)
+{
+    const uint32_t width = reference.getWidth();
+    const uint32_t height = reference.getHeight();
+    const float exposureScale = std::exp2(exposure);
+
+    // Inputs per image: Y, Cx, Cz and normalized luminance.
+    auto input = [&](uint32_t y, float* const* rows)
+    {
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            const Image& image = i == 0 ? reference : test;
+            const float* src = image.getData() + size_t(y) * width * 4;
+            const bool linearize = !image.isLinear();
+            float* const* dst = rows + 4 * i;
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                float3 color = {src[4 * x], src[4 * x + 1], src[4 * x + 2]};
+                for (auto& v : color)
+                {
+                    if (linearize)
+                        v = sRGBToLinear(v);
+                    v = hdr ? std::max(v, 0.f) * exposureScale : clamp(v, 0.f, 1.f);
+                }
+                if (hdr)
+                    color = toneMapACES(color);
+                float3 ycxcz = linearRGBToYCxCz(color);
+                dst[0][x] = ycxcz[0];
+                dst[1][x] = ycxcz[1];
+                dst[2][x] = ycxcz[2];
+                dst[3][x] = (ycxcz[0] + 16.0f) / 116.0f;
+            }
+        }
+    };
+
+    // Filters per image: 4 CSF filters followed by point x/y and edge x/y.
+    std::vector<SeparableFilter> filters;
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        uint32_t base = 4 * i;
+        filters.push_back({base + 0, &kernels.csfA, &kernels.csfA});
+        filters.push_back({base + 1, &kernels.csfRG, &kernels.csfRG});
+        filters.push_back({base + 2, &kernels.csfBY1, &kernels.csfBY1});
+        filters.push_back({base + 2, &kernels.csfBY2, &kernels.csfBY2});
+        filters.push_back({base + 3, &kernels.point, &kernels.gaussian});
+        filters.push_back({base + 3, &kernels.gaussian, &kernels.point});
+        filters.push_back({base + 3, &kernels.edge, &kernels.gaussian});
+        filters.push_back({base + 3, &kernels.gaussian, &kernels.edge});
+    }
+
+    auto outputRows = [&](uint32_t y, const float* const* rows)
+    {
+        std::vector<float> values(width);
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            float3 lab[2];
+            float pointGradient[2], edgeGradient[2];
+            for (uint32_t i = 0; i < 2; ++i)
+            {
+                const float* const* r = rows + 8 * i;
+                float3 filtered = {r[0][x], r[1][x], kernels.weightBY1 * r[2][x] + kernels.weightBY2 * r[3][x]};
+                float3 rgb = YCxCzToLinearRGB(filtered);
+                for (auto& v : rgb)
+                    v = clamp(v, 0.f, 1.f);
+                lab[i] = hunt(linearRGBToCIELab(rgb));
+                pointGradient[i] = std::sqrt(sqr(r[4][x]) + sqr(r[5][x]));
+                edgeGradient[i] = std::sqrt(sqr(r[6][x]) + sqr(r[7][x]));
+            }
+            float colorDiff = hyAB(lab[0], lab[1]);
+            float edgeDifference = std::fabs(edgeGradient[0] - edgeGradient[1]);
+            float pointDifference = std::fabs(pointGradient[0] - pointGradient[1]);
+            float featureDiff = std::pow(std::max(pointDifference, edgeDifference) * float(std::sqrt(0.5)), kFLIPqf);
+            float value = kernels.redistributeErrors(colorDiff, featureDiff);
+            values[x] = std::isfinite(value) ? value : 1.f;
+        }
+        output(y, values.data());
+    };
+
+    filterSeparable(width, height, 8, kernels.radius, filters, input, outputRows, pThreadPool);
+}
+
+} // namespace
+
+double computePSNR(const Image& imageA, const Image& imageB, const Options& options)
+{
+    checkResolution(imageA, imageB);
+    const uint32_t width = imageA.getWidth();
+    const uint32_t height = imageA.getHeight();
+    const uint32_t channelCount = options.channelCount;
+
+    std::vector<double> rowSums(height, 0.0);
+    forEachRow(
+        height,
+        options.pThreadPool,
+        [&](uint32_t y)
+        {
+            const float* a = imageA.getData() + size_t(y) * width * 4;
+            const float* b = imageB.getData() + size_t(y) * width * 4;
+            double sum = 0.0;
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                float error = 0.f;
+                for (uint32_t c = 0; c < channelCount; ++c)
+                    error += sqr(a[4 * x + c] - b[4 * x + c]);
+                error /= channelCount;
+                if (options.errorMap)
+                    options.errorMap[size_t(y) * width + x] = error;
+                sum += error;
+            }
+            rowSums[y] = sum;
+        }
+    );
+
+    double mse = std::accumulate(rowSums.begin(), rowSums.end(), 0.0) / (double(width) * height);
+    return mse > 0.0 ? -10.0 * std::log10(mse) : std::numeric_limits<double>::infinity();
+}
+
+double computeSSIM(const Image& imageA, const Image& imageB, const Options& options)
+{
+    checkResolution(imageA, imageB);
+    std::vector<float> ssimMap(options.errorMap ? size_t(imageA.getWidth()) * imageA.getHeight() : 0);
+    auto result = computeSSIMPlanes(
+        Planes::fromImage(imageA, options.channelCount),
+        Planes::fromImage(imageB, options.channelCount),
+        options.errorMap ? ssimMap.data() : nullptr,
+        options.pThreadPool
+    );
+    for (size_t i = 0; i < ssimMap.size(); ++i)
+        options.errorMap[i] = 1.f - ssimMap[i];
+    return result.ssim;
+}
+
+double computeMSSSIM(const Image& imageA, const Image& imageB, const Options& options)
+{
+    checkResolution(imageA, imageB);
+
+    // Drop scales that would be smaller than the SSIM window.
+    const uint32_t minSize = 2 * kSSIMRadius + 1;
+    uint32_t scaleCount = 1;
+    for (uint32_t size = std::min(imageA.getWidth(), imageA.getHeight()) / 2; scaleCount < kMSSSIMWeights.size() && size >= minSize; size /= 2)
+        ++scaleCount;
+    const double weightSum = std::accumulate(kMSSSIMWeights.begin(), kMSSSIMWeights.begin() + scaleCount, 0.0);
+
+    Planes a = Planes::fromImage(imageA, options.channelCount);
+    Planes b = Planes::fromImage(imageB, options.channelCount);
+    std::vector<float> ssimMap(options.errorMap ? size_t(a.width) * a.height : 0);
+
+    double result = 1.0;
+    for (uint32_t scale = 0; scale < scaleCount; ++scale)
+    {
+        auto ssim = computeSSIMPlanes(a, b, scale == 0 && options.errorMap ? ssimMap.data() : nullptr, options.pThreadPool);
+        // Negative contrast-structure values are clamped to keep the product well defined.
+        double value = scale + 1 == scaleCount ? ssim.ssim : ssim.cs;
+        result *= std::pow(std::max(value, 0.0), kMSSSIMWeights[scale] / weightSum);
+        if (scale + 1 < scaleCount)
+        {
+            a = a.downsample();
+            b = b.downsample();
+        }
+    }
+
+    for (size_t i = 0; i < ssimMap.size(); ++i)
+        options.errorMap[i] = 1.f - ssimMap[i];
+    return result;
+}
+
+double computeFLIP(const Image& reference, const Image& test, bool hdr, const Options& options)
+{
+    checkResolution(reference, test);
+    const uint32_t width = reference.getWidth();
+    const uint32_t height = reference.getHeight();
+    const FLIPKernels kernels(options.pixelsPerDegree);
+
+    // LDR-FLIP is a single pass with exposure 0, HDR-FLIP is the per-pixel maximum over the exposure range.
+    ExposureRange exposures = hdr ? computeExposureRange(reference) : ExposureRange{0.f, 0.f, 1};
+    std::vector<float> flipMap(size_t(width) * height, 0.f);
+    for (uint32_t i = 0; i < exposures.count; ++i)
+    {
+        computeLDRFLIP(
+            kernels,
+            reference,
+            test,
+            hdr,
+            exposures.start + i * exposures.delta,
+            [&](uint32_t y, const float* values)
+            {
+                float* dst = flipMap.data() + size_t(y) * width;
+                for (uint32_t x = 0; x < width; ++x)
+                    dst[x] = std::max(dst[x], values[x]);
+            },
+            options.pThreadPool
+        );
+    }
+
+    if (options.errorMap)
+        std::copy(flipMap.begin(), flipMap.end(), options.errorMap);
+
+    double sum = 0.0;
+    for (float value : flipMap)
+        sum += value;
+    return sum / flipMap.size();
+}
+
+} // namespace ImageMetrics
@@ -0,0 +1,86 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Image.h"
+
+#include <BS_thread_pool/BS_thread_pool.hpp>
+
+#include <cstdint>
+
+/**
+ * Perceptual and signal based image metrics.
+ *
+ * All metrics operate on the RGB(A) float data of an Image and are implemented with separable filters that run on
+ * planar rows in horizontal bands. The inner loops are vectorized with SSE/AVX when available and bands are
+ * distributed over a thread pool if one is provided.
+ */
+namespace ImageMetrics
+{
+struct Options
+{
+    /// Number of channels to compare (3 = RGB, 4 = RGBA). Only used by the signal metrics (PSNR, SSIM, MS-SSIM).
+    uint32_t channelCount = 3;
+    /// Optional per-pixel error map of size width * height.
+    float* errorMap = nullptr;
+    /// Optional thread pool used to process bands in parallel.
+    BS::thread_pool* pThreadPool = nullptr;
+    /// Pixels per degree of visual angle used by FLIP. The default matches the FLIPPass defaults
+    /// (3840 pixels on a 0.7 m wide monitor viewed from 0.7 m).
+    float pixelsPerDegree = 67.0206f;
+};
+
+/**
+ * Compute the peak signal-to-noise ratio in dB assuming a peak value of 1.
+ * The error map contains the per-pixel squared error. Returns infinity for identical images.
+ */
+double computePSNR(const Image& imageA, const Image& imageB, const Options& options);
+
+/**
+ * Compute the structural similarity index (Wang et al. 2004) using a 11x11 Gaussian window with sigma 1.5,
+ * K1 = 0.01, K2 = 0.03 and a dynamic range of 1. The result is averaged over channels and over all pixels whose window
+ * lies inside the image, which matches skimage.metrics.structural_similarity(gaussian_weights=True,
+ * use_sample_covariance=False, data_range=1). The error map contains 1 - SSIM.
+ */
+double computeSSIM(const Image& imageA, const Image& imageB, const Options& options);
+
+/**
+ * Compute the multi-scale structural similarity index (Wang et al. 2003) over up to 5 scales with 2x2 box downsampling.
+ * Scales that are smaller than the SSIM window are dropped and the remaining weights are renormalized.
+ * The error map contains 1 - SSIM at the finest scale.
+ */
+double computeMSSSIM(const Image& imageA, const Image& imageB, const Options& options);
+
+/**
+ * Compute the mean FLIP error (Andersson et al. 2020) of a test image against a reference image.
+ * This is a CPU port of the FLIPPass shaders. 8-bit images are converted from sRGB to linear first.
+ * @param[in] hdr Use HDR-FLIP (ACES tone mapping over the exposure range of the reference) instead of LDR-FLIP.
+ * The error map contains the per-pixel FLIP value.
+ */
+double computeFLIP(const Image& reference, const Image& test, bool hdr, const Options& options);
+
+} // namespace ImageMetrics
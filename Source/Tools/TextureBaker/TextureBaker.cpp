@@ -0,0 +1,322 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Core/Error.h"
+#include "Core/API/Formats.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Image/BakedTextureCache.h"
+#include "Utils/Image/Bitmap.h"
+#include "Utils/Image/ImageIO.h"
+#include "Utils/Image/MipGenerator.h"
+#include "Utils/Logger.h"
+#include "Utils/StringFormatters.h"
+
+#include <args.hxx>
+#include <nlohmann/json.hpp>
+#include <BS_thread_pool/BS_thread_pool.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Falcor;
+
+namespace
+{
+struct TextureReport
+{
+    uint64_t sourceMemorySize = 0; ///< GPU memory of the uncompressed texture in bytes.
+    uint64_t bakedMemorySize = 0;  ///< GPU memory of the baked texture in bytes.
+    double sourceLoadTime = 0.0;   ///< Time to decode the source file in seconds.
+    double bakedLoadTime = 0.0;    ///< Time to load the baked DDS file in seconds.
+};
+
+double secondsSince(std::chrono::steady_clock::time_point startTime)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+uint64_t getTextureMemorySize(ResourceFormat format, uint32_t width, uint32_t height, uint32_t mipLevels)
+{
+    uint64_t size = 0;
+    for (uint32_t mip = 0; mip < mipLevels; ++mip)
+    {
+        uint32_t w = std::max(width >> mip, 1u);
+        uint32_t h = std::max(height >> mip, 1u);
+        uint32_t rows = (h + getFormatHeightCompressionRatio(format) - 1) / getFormatHeightCompressionRatio(format);
+        size += uint64_t(getFormatRowPitch(format, w)) * rows;
+    }
+    return size;
+}
+
+/// Measure load time and GPU memory of a source texture and its baked version.
+TextureReport measure(const BakedTextureCache::BakeResult& result, bool generateMips)
+{
+    TextureReport report;
+
+    auto startTime = std::chrono::steady_clock::now();
+    auto pBitmap = Bitmap::createFromFile(result.sourcePath, true /* top-down */);
+    report.sourceLoadTime = secondsSince(startTime);
+    if (pBitmap)
+    {
+        uint32_t mipLevels = generateMips ? MipGenerator::getMipCount(pBitmap->getWidth(), pBitmap->getHeight()) : 1;
+        report.sourceMemorySize = getTextureMemorySize(pBitmap->getFormat(), pBitmap->getWidth(), pBitmap->getHeight(), mipLevels);
+    }
+
+    startTime = std::chrono::steady_clock::now();
+    auto image = ImageIO::loadDDSImage(result.cachePath, false);
+    report.bakedLoadTime = secondsSince(startTime);
+    report.bakedMemorySize = image.data.size();
+
+    return report;
+}
+
+void collectSources(const std::filesystem::path& path, std::vector<std::filesystem::path>& sources)
+{
+    if (std::filesystem::is_directory(path))
+    {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(path))
+        {
+            if (entry.is_regular_file() && BakedTextureCache::isSupportedSource(entry.path()))
+                sources.push_back(std::filesystem::absolute(entry.path()));
+        }
+    }
+    else if (std::filesystem::is_regular_file(path))
+    {
+        sources.push_back(std::filesystem::absolute(path));
+    }
+    else
+    {
+        logWarning("Input '{}' does not exist.", path);
+    }
+}
+} // namespace
+
+int runMain(int argc, char** argv)
+{
+    args::ArgumentParser parser("Bakes textures to block compressed, mipmapped DDS files in the baked texture cache.");
+    parser.helpParams.programName = "TextureBaker";
+    args::HelpFlag helpFlag(parser, "help", "Display this help menu.", {'h', "help"});
+    args::ValueFlag<std::string> outputFlag(parser, "dir", "Cache directory (default: application data directory).", {'o', "output"});
+    args::ValueFlag<uint32_t> threadsFlag(parser, "count", "Number of worker threads (default: all cores).", {'j', "threads"});
+    args::Flag forceFlag(parser, "", "Re-bake textures that are already in the cache.", {'f', "force"});
+    args::Flag noMipsFlag(parser, "", "Do not generate mip levels.", {"no-mips"});
+    args::ValueFlag<std::string> colorSpaceFlag(
+        parser,
+        "space",
+        "Bake mips filtered for 'srgb' (color), 'linear' (data) or 'normal' (normal map) textures, or 'both' srgb and linear (default).",
+        {"color-space"}
+    );
+    args::ValueFlag<std::string> reportFlag(parser, "filename", "Write a per-texture JSON report.", {'r', "report"});
+    args::Flag verboseFlag(parser, "", "Print per-texture results.", {'v', "verbose"});
+    args::PositionalList<std::string> inputsFlag(parser, "inputs", "Texture files or directories to bake (searched recursively).");
+    args::CompletionFlag completionFlag(parser, {"complete"});
+
+    try
+    {
+        parser.ParseCLI(argc, argv);
+    }
+    catch (const args::Completion& e)
+    {
+        std::cout << e.what();
+        return 0;
+    }
+    catch (const args::Help&)
+    {
+        std::cout << parser;
+        return 0;
+    }
+    catch (const args::ParseError& e)
+    {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+    catch (const args::RequiredError& e)
+    {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    if (!inputsFlag)
+    {
+        std::cerr << parser;
+        return 1;
+    }
+
+    std::vector<std::filesystem::path> sources;
+    for (const auto& input : args::get(inputsFlag))
+        collectSources(input, sources);
+    std::sort(sources.begin(), sources.end());
+    sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+    if (sources.empty())
+    {
+        std::cerr << "No textures to bake." << std::endl;
+        return 1;
+    }
+
+    // Textures are looked up by how they are sampled, as it determines how mips are filtered.
+    // Normal maps cannot be told apart from other data, so they are only baked on request.
+    const std::string colorSpace = colorSpaceFlag ? args::get(colorSpaceFlag) : "both";
+    std::vector<BakedTextureCache::Variant> variants;
+    if (colorSpace == "srgb" || colorSpace == "both")
+        variants.push_back(BakedTextureCache::Variant::Srgb);
+    if (colorSpace == "linear" || colorSpace == "both")
+        variants.push_back(BakedTextureCache::Variant::Linear);
+    if (colorSpace == "normal")
+        variants.push_back(BakedTextureCache::Variant::NormalMap);
+    if (variants.empty())
+    {
+        std::cerr << "Invalid color space '" << colorSpace << "'." << std::endl;
+        return 1;
+    }
+
+    OSServices::start();
+
+    BakedTextureCache::Options options;
+    if (outputFlag)
+        options.directory = args::get(outputFlag);
+    options.generateMips = !noMipsFlag;
+    BakedTextureCache cache(options);
+
+    const size_t threadCount = threadsFlag ? args::get(threadsFlag) : 0;
+    fmt::print("Baking {} textures to '{}'.\n", sources.size(), cache.getOptions().directory);
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<BakedTextureCache::BakeResult> results;
+    for (auto variant : variants)
+    {
+        auto variantResults = cache.bakeAll(sources, variant, threadCount, bool(forceFlag));
+        results.insert(results.end(), variantResults.begin(), variantResults.end());
+    }
+    const double bakeTime = secondsSince(startTime);
+
+    // Measure load time and GPU memory before and after baking.
+    std::vector<TextureReport> reports(results.size());
+    BS::thread_pool threadPool(threadCount);
+    threadPool
+        .parallelize_loop(
+            0,
+            results.size(),
+            [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    if (results[i].cachePath.empty())
+                        continue;
+                    try
+                    {
+                        reports[i] = measure(results[i], options.generateMips);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        logWarning("Failed to measure '{}': {}", results[i].cachePath, e.what());
+                    }
+                }
+            },
+            results.size()
+        )
+        .wait();
+
+    size_t bakedCount = 0, cachedCount = 0, failedCount = 0;
+    TextureReport total;
+    nlohmann::json jsonReport = nlohmann::json::array();
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto& result = results[i];
+        const auto& report = reports[i];
+        if (result.cachePath.empty())
+        {
+            failedCount++;
+            continue;
+        }
+        (result.wasCached ? cachedCount : bakedCount)++;
+        total.sourceMemorySize += report.sourceMemorySize;
+        total.bakedMemorySize += report.bakedMemorySize;
+        total.sourceLoadTime += report.sourceLoadTime;
+        total.bakedLoadTime += report.bakedLoadTime;
+
+        if (verboseFlag)
+        {
+            fmt::print(
+                "{} {}: {:.1f} -> {:.1f} MB, {:.1f} -> {:.1f} ms\n",
+                result.wasCached ? "cached" : fmt::format("{:6}", enumToString(result.mode)),
+                result.sourcePath,
+                report.sourceMemorySize / double(1 << 20),
+                report.bakedMemorySize / double(1 << 20),
+                report.sourceLoadTime * 1000.0,
+                report.bakedLoadTime * 1000.0
+            );
+        }
+
+        nlohmann::json entry = {
+            {"source", result.sourcePath.string()},
+            {"baked", result.cachePath.string()},
+            {"cached", result.wasCached},
+            {"mode", result.wasCached ? std::string() : enumToString(result.mode)},
+            {"bakeTime", result.bakeTime},
+            {"sourceMemorySize", report.sourceMemorySize},
+            {"bakedMemorySize", report.bakedMemorySize},
+            {"sourceLoadTime", report.sourceLoadTime},
+            {"bakedLoadTime", report.bakedLoadTime},
+        };
+        jsonReport.push_back(entry);
+    }
+
+    fmt::print("Baked {} textures, {} already cached, {} failed in {:.2f} s.\n", bakedCount, cachedCount, failedCount, bakeTime);
+    fmt::print(
+        "VRAM: {:.1f} MB -> {:.1f} MB ({:.2f}x smaller)\n",
+        total.sourceMemorySize / double(1 << 20),
+        total.bakedMemorySize / double(1 << 20),
+        total.bakedMemorySize > 0 ? double(total.sourceMemorySize) / total.bakedMemorySize : 0.0
+    );
+    fmt::print(
+        "Load time (single thread): {:.2f} s -> {:.2f} s ({:.2f}x faster)\n",
+        total.sourceLoadTime,
+        total.bakedLoadTime,
+        total.bakedLoadTime > 0.0 ? total.sourceLoadTime / total.bakedLoadTime : 0.0
+    );
+
+    if (reportFlag)
+    {
+        std::ofstream ofs(args::get(reportFlag));
+        ofs << jsonReport.dump(4) << std::endl;
+    }
+
+    OSServices::stop();
+
+    return failedCount > 0 ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+    return catchAndReportAllExceptions([&]() { return runMain(argc, argv); });
+}
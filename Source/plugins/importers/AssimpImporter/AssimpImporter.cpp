@@ -30,7 +30,6 @@
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
-#include "Utils/NumericRange.h"
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Math/FalcorMath.h"
@@ -46,8 +45,10 @@
 
 #include <pybind11/pybind11.h>
 
-#include <execution>
+#include <BS_thread_pool/BS_thread_pool.hpp>
+
 #include <fstream>
+#include <future>
 
 namespace Falcor
 {
@@ -143,6 +144,13 @@ static const std::vector<TextureMapping> kTextureMappings[3] = {
 class ImporterData
 {
 public:
+    struct TextureRequest
+    {
+        ref<Material> pMaterial;
+        Material::TextureSlot slot;
+        std::filesystem::path path;
+    };
+
     ImporterData(const std::filesystem::path& path, const aiScene* pAiScene, SceneBuilder& sceneBuilder)
         : path(path), pScene(pAiScene), builder(sceneBuilder)
     {}
@@ -153,6 +161,7 @@ public:
     std::map<uint32_t, ref<Material>> materialMap;
     std::vector<MeshID> meshMap; // Assimp mesh index to Falcor mesh ID
     std::map<std::string, float4x4> localToBindPoseMatrices;
+    std::vector<TextureRequest> textureRequests; // Material textures, requested while the meshes are converted
 
     NodeID getFalcorNodeID(const aiNode* pNode) const { return mAiToFalcorNodeID.at(pNode); }
 
@@ -562,12 +571,73 @@ void loadBones(const aiMesh* pAiMesh, const ImporterData& data, std::vector<floa
     }
 }
 
-void createMeshes(ImporterData& data)
+SceneBuilder::ProcessedMesh convertMesh(const ImporterData& data, const aiMesh* pAiMesh, bool loadTangents)
+{
+    SceneBuilder::Mesh mesh;
+    mesh.name = pAiMesh->mName.C_Str();
+    mesh.faceCount = pAiMesh->mNumFaces;
+
+    // Temporary memory for the vertex and index data.
+    std::vector<uint32_t> indexList;
+    std::vector<float2> texCrds;
+    std::vector<float4> tangents;
+    std::vector<uint4> boneIds;
+    std::vector<float4> boneWeights;
+
+    // Indices
+    createIndexList(pAiMesh, indexList);
+    FALCOR_ASSERT(indexList.size() <= std::numeric_limits<uint32_t>::max());
+    mesh.indexCount = (uint32_t)indexList.size();
+    mesh.pIndices = indexList.data();
+    mesh.topology = Vao::Topology::TriangleList;
+
+    // Vertices
+    FALCOR_ASSERT(pAiMesh->mVertices);
+    mesh.vertexCount = pAiMesh->mNumVertices;
+    static_assert(sizeof(pAiMesh->mVertices[0]) == sizeof(mesh.positions.pData[0]));
+    static_assert(sizeof(pAiMesh->mNormals[0]) == sizeof(mesh.normals.pData[0]));
+    mesh.positions.pData = reinterpret_cast<float3*>(pAiMesh->mVertices);
+    mesh.positions.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+    mesh.normals.pData = reinterpret_cast<float3*>(pAiMesh->mNormals);
+    mesh.normals.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+
+    if (pAiMesh->HasTextureCoords(0))
+    {
+        createTexCrdList(pAiMesh->mTextureCoords[0], pAiMesh->mNumVertices, texCrds);
+        FALCOR_ASSERT(!texCrds.empty());
+        mesh.texCrds.pData = texCrds.data();
+        mesh.texCrds.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+    }
+
+    if (loadTangents && pAiMesh->HasTangentsAndBitangents())
+    {
+        createTangentList(pAiMesh->mTangents, pAiMesh->mBitangents, pAiMesh->mNormals, pAiMesh->mNumVertices, tangents);
+        FALCOR_ASSERT(!tangents.empty());
+        mesh.tangents.pData = tangents.data();
+        mesh.tangents.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+    }
+
+    if (pAiMesh->HasBones())
+    {
+        loadBones(pAiMesh, data, boneWeights, boneIds);
+        mesh.boneIDs.pData = boneIds.data();
+        mesh.boneIDs.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+        mesh.boneWeights.pData = boneWeights.data();
+        mesh.boneWeights.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+    }
+
+    mesh.pMaterial = data.materialMap.at(pAiMesh->mMaterialIndex);
+
+    return data.builder.processMesh(mesh);
+}
+
+void createMeshes(ImporterData& data, TimeReport& timeReport)
 {
     const aiScene* pScene = data.pScene;
     const bool loadTangents = is_set(data.builder.getFlags(), SceneBuilder::Flags::UseOriginalTangentSpace);
 
     std::vector<const aiMesh*> meshes;
+    std::vector<size_t> meshOrder;
     for (uint32_t i = 0; i < pScene->mNumMeshes; ++i)
     {
         const aiMesh* pMesh = pScene->mMeshes[i];
@@ -584,80 +654,56 @@ void createMeshes(ImporterData& data)
             continue;
         }
         meshes.push_back(pMesh);
+        meshOrder.push_back(i);
     }
 
-    // Pre-process meshes.
-    std::vector<SceneBuilder::ProcessedMesh> processedMeshes(meshes.size());
-    auto range = NumericRange<size_t>(0, meshes.size());
-    std::for_each(
-        std::execution::par,
-        range.begin(),
-        range.end(),
-        [&](size_t i)
-        {
-            const aiMesh* pAiMesh = meshes[i];
-            if (!pAiMesh)
-                return;
-            const uint32_t perFaceIndexCount = pAiMesh->mFaces[0].mNumIndices;
-
-            SceneBuilder::Mesh mesh;
-            mesh.name = pAiMesh->mName.C_Str();
-            mesh.faceCount = pAiMesh->mNumFaces;
-
-            // Temporary memory for the vertex and index data.
-            std::vector<uint32_t> indexList;
-            std::vector<float2> texCrds;
-            std::vector<float4> tangents;
-            std::vector<uint4> boneIds;
-            std::vector<float4> boneWeights;
-
-            // Indices
-            createIndexList(pAiMesh, indexList);
-            FALCOR_ASSERT(indexList.size() <= std::numeric_limits<uint32_t>::max());
-            mesh.indexCount = (uint32_t)indexList.size();
-            mesh.pIndices = indexList.data();
-            mesh.topology = Vao::Topology::TriangleList;
-
-            // Vertices
-            FALCOR_ASSERT(pAiMesh->mVertices);
-            mesh.vertexCount = pAiMesh->mNumVertices;
-            static_assert(sizeof(pAiMesh->mVertices[0]) == sizeof(mesh.positions.pData[0]));
-            static_assert(sizeof(pAiMesh->mNormals[0]) == sizeof(mesh.normals.pData[0]));
-            mesh.positions.pData = reinterpret_cast<float3*>(pAiMesh->mVertices);
-            mesh.positions.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
-            mesh.normals.pData = reinterpret_cast<float3*>(pAiMesh->mNormals);
-            mesh.normals.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
-
-            if (pAiMesh->HasTextureCoords(0))
-            {
-                createTexCrdList(pAiMesh->mTextureCoords[0], pAiMesh->mNumVertices, texCrds);
-                FALCOR_ASSERT(!texCrds.empty());
-                mesh.texCrds.pData = texCrds.data();
-                mesh.texCrds.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
-            }
-
-            if (loadTangents && pAiMesh->HasTangentsAndBitangents())
-            {
-                createTangentList(pAiMesh->mTangents, pAiMesh->mBitangents, pAiMesh->mNormals, pAiMesh->mNumVertices, tangents);
-                FALCOR_ASSERT(!tangents.empty());
-                mesh.tangents.pData = tangents.data();
-                mesh.tangents.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
-            }
+    // Convert the largest meshes first so that they don't end up last on a single thread.
+    std::stable_sort(
+        meshOrder.begin(), meshOrder.end(), [&](size_t a, size_t b) { return meshes[a]->mNumFaces > meshes[b]->mNumFaces; }
+    );
 
-            if (pAiMesh->HasBones())
+    // Pre-process meshes in parallel. The material textures are requested on one of the threads at the same time,
+    // which overlaps the file lookups of the texture manager with the mesh conversion.
+    std::vector<SceneBuilder::ProcessedMesh> processedMeshes(meshes.size());
+    uint64_t triangleCount = 0;
+    {
+        BS::thread_pool threadPool;
+        auto texturesRequested = threadPool.submit(
+            [&data]()
             {
-                loadBones(pAiMesh, data, boneWeights, boneIds);
-                mesh.boneIDs.pData = boneIds.data();
-                mesh.boneIDs.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
-                mesh.boneWeights.pData = boneWeights.data();
-                mesh.boneWeights.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+                for (const auto& request : data.textureRequests)
+                    data.builder.loadMaterialTexture(request.pMaterial, request.slot, request.path);
             }
+        );
 
-            mesh.pMaterial = data.materialMap.at(pAiMesh->mMaterialIndex);
-
-            processedMeshes[i] = data.builder.processMesh(mesh);
+        std::vector<std::future<void>> meshesConverted;
+        meshesConverted.reserve(meshOrder.size());
+        for (size_t i : meshOrder)
+        {
+            meshesConverted.push_back(threadPool.submit(
+                [&data, &meshes, &processedMeshes, loadTangents, i]()
+                { processedMeshes[i] = convertMesh(data, meshes[i], loadTangents); }
+            ));
+            triangleCount += meshes[i]->mNumFaces;
         }
-    );
+
+        // Wait for all tasks before rethrowing errors, they reference the local data.
+        threadPool.wait_for_tasks();
+        for (auto& meshConverted : meshesConverted)
+            meshConverted.get();
+        timeReport.measure("Converting meshes");
+
+        texturesRequested.get();
+        timeReport.measure("Requesting textures");
+
+        logInfo(
+            "AssimpImporter: Converted {} meshes with {} triangles and requested {} textures using {} threads.",
+            meshOrder.size(),
+            triangleCount,
+            data.textureRequests.size(),
+            threadPool.get_thread_count()
+        );
+    }
 
     // Add meshes to the scene.
     // We retain a deterministic order of the meshes in the global scene buffer by adding
@@ -668,7 +714,7 @@ void createMeshes(ImporterData& data)
     {
         if (!meshes[i])
             continue;
-        data.meshMap[i] = data.builder.addProcessedMesh(processedMeshes[i]);
+        data.meshMap[i] = data.builder.addProcessedMesh(std::move(processedMeshes[i]));
     }
 }
 
@@ -786,7 +832,7 @@ void addMeshInstances(ImporterData& data, aiNode* pNode)
         addMeshInstances(data, pNode->mChildren[i]);
 }
 
-void loadTextures(
+void addTextureRequests(
     ImporterData& data,
     const aiMaterial* pAiMaterial,
     const std::filesystem::path& searchPath,
@@ -817,9 +863,8 @@ void loadTextures(
             continue;
         }
 
-        // Load the texture
-        auto fullPath = searchPath / path;
-        data.builder.loadMaterialTexture(pMaterial, source.targetType, fullPath);
+        // Request the texture, it is loaded by createMeshes()
+        data.textureRequests.push_back({pMaterial, source.targetType, searchPath / path});
     }
 }
 
@@ -858,8 +903,8 @@ ref<Material> createMaterial(
     // Create an instance of the standard material. All materials are assumed to be of this type.
     ref<StandardMaterial> pMaterial = StandardMaterial::create(data.builder.getDevice(), nameStr, shadingModel);
 
-    // Load textures. Note that loading is affected by the current shading model.
-    loadTextures(data, pAiMaterial, searchPath, pMaterial, importMode);
+    // Request textures. Note that loading is affected by the current shading model.
+    addTextureRequests(data, pAiMaterial, searchPath, pMaterial, importMode);
 
     // Opacity
     float opacity = 1.f;
@@ -1139,18 +1184,25 @@ void importInternal(const void* buffer, size_t byteSize, const std::filesystem::
         FALCOR_ASSERT(buffer == nullptr && byteSize == 0);
         if (!path.is_absolute())
             throw ImporterError(path, "Expected absolute path.");
-        pScene = importer.ReadFile(path.string().c_str(), assimpFlags);
+        pScene = importer.ReadFile(path.string().c_str(), 0);
     }
     else
     {
         FALCOR_ASSERT(buffer != nullptr && byteSize != 0);
-        pScene = importer.ReadFileFromMemory(buffer, byteSize, assimpFlags);
+        pScene = importer.ReadFileFromMemory(buffer, byteSize, 0);
     }
     if (!pScene)
         throw ImporterError(path, "Failed to open scene: {}", importer.GetErrorString());
 
     timeReport.measure("Loading asset file");
 
+    // Run the post-processing steps separately to report their time. This is equivalent to passing the flags to ReadFile().
+    pScene = importer.ApplyPostProcessing(assimpFlags);
+    if (!pScene)
+        throw ImporterError(path, "Failed to post-process scene: {}", importer.GetErrorString());
+
+    timeReport.measure("Post-processing asset file");
+
     ImporterData data(path, pScene, builder);
 
     validateScene(data);
@@ -1174,9 +1226,9 @@ void importInternal(const void* buffer, size_t byteSize, const std::filesystem::
     createSceneGraph(data);
     timeReport.measure("Creating scene graph");
 
-    createMeshes(data);
+    createMeshes(data, timeReport);
     addMeshInstances(data, data.pScene->mRootNode);
-    timeReport.measure("Creating meshes");
+    timeReport.measure("Adding meshes");
 
     createAnimations(data, importMode);
     timeReport.measure("Creating animations");
@@ -0,0 +1,1542 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "GltfImporter.h"
+#include "Core/Error.h"
+#include "Core/API/Device.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include "Utils/StringUtils.h"
+#include "Utils/Timing/TimeReport.h"
+#include "Utils/Math/FalcorMath.h"
+#include "Scene/Importer.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Animation/Animation.h"
+#include "Scene/Camera/Camera.h"
+#include "Scene/Lights/Light.h"
+#include "Scene/Material/StandardMaterial.h"
+#include "Scene/MeshoptDecoder.h"
+
+#include <fstd/span.h> // TODO C++20: Replace with <span>
+#include <BS_thread_pool/BS_thread_pool.hpp>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <map>
+#include <numeric>
+#include <set>
+
+namespace Falcor
+{
+
+namespace
+{
+using json = nlohmann::json;
+
+const std::string kMeshoptCompression = "EXT_meshopt_compression";
+const std::string kDracoMeshCompression = "KHR_draco_mesh_compression";
+const std::string kMeshQuantization = "KHR_mesh_quantization";
+const std::string kLightsPunctual = "KHR_lights_punctual";
+const std::string kMaterialsEmissiveStrength = "KHR_materials_emissive_strength";
+const std::string kMaterialsIor = "KHR_materials_ior";
+const std::string kMaterialsTransmission = "KHR_materials_transmission";
+
+/// Extensions interpreted by the importer. Assets that require any other extension are rejected.
+const std::set<std::string> kSupportedExtensions = {
+    kMeshoptCompression,
+    kMeshQuantization,
+    kLightsPunctual,
+    kMaterialsEmissiveStrength,
+    kMaterialsIor,
+    kMaterialsTransmission,
+};
+
+// GLB container, see https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#binary-gltf-layout
+const uint32_t kGlbMagic = 0x46546c67;     // "glTF"
+const uint32_t kGlbChunkJson = 0x4e4f534a; // "JSON"
+const uint32_t kGlbChunkBin = 0x004e4942;  // "BIN\0"
+const size_t kGlbHeaderSize = 12;
+const size_t kGlbChunkHeaderSize = 8;
+
+// Accessor component types.
+const uint32_t kByte = 5120;
+const uint32_t kUnsignedByte = 5121;
+const uint32_t kShort = 5122;
+const uint32_t kUnsignedShort = 5123;
+const uint32_t kUnsignedInt = 5125;
+const uint32_t kFloat = 5126;
+
+// Primitive modes.
+const uint32_t kModeTriangles = 4;
+const uint32_t kModeTriangleStrip = 5;
+const uint32_t kModeTriangleFan = 6;
+
+const json& getArray(const json& object, const char* key)
+{
+    static const json kEmpty = json::array();
+    auto it = object.find(key);
+    return it != object.end() && it->is_array() ? *it : kEmpty;
+}
+
+const json* findExtension(const json& object, const std::string& name)
+{
+    auto extensions = object.find("extensions");
+    if (extensions == object.end())
+        return nullptr;
+    auto it = extensions->find(name);
+    return it != extensions->end() ? &*it : nullptr;
+}
+
+template<typename VecT>
+VecT getVector(const json& object, const char* key, VecT defaultValue)
+{
+    auto it = object.find(key);
+    if (it == object.end())
+        return defaultValue;
+    if (!it->is_array() || it->size() != size_t(VecT::length()))
+        FALCOR_THROW("Expected '{}' to be an array of {} numbers.", key, VecT::length());
+    VecT v;
+    for (int i = 0; i < VecT::length(); i++)
+        v[i] = (*it)[i].template get<typename VecT::value_type>();
+    return v;
+}
+
+quatf getQuat(const json& object, const char* key)
+{
+    float4 q = getVector(object, key, float4(0.f, 0.f, 0.f, 1.f));
+    return quatf(q.x, q.y, q.z, q.w);
+}
+
+float4x4 composeTransform(const float3& translation, const quatf& rotation, const float3& scaling)
+{
+    return mul(mul(matrixFromTranslation(translation), float4x4(matrixFromQuat(rotation))), matrixFromScaling(scaling));
+}
+
+/// glTF matrices are stored in column-major order.
+float4x4 matrixFromColumnMajor(const float* m)
+{
+    float4x4 result;
+    for (int col = 0; col < 4; col++)
+        for (int row = 0; row < 4; row++)
+            result[row][col] = m[col * 4 + row];
+    return result;
+}
+
+size_t getComponentSize(uint32_t componentType)
+{
+    switch (componentType)
+    {
+    case kByte:
+    case kUnsignedByte:
+        return 1;
+    case kShort:
+    case kUnsignedShort:
+        return 2;
+    case kUnsignedInt:
+    case kFloat:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+uint32_t getComponentCount(const std::string& type)
+{
+    if (type == "SCALAR")
+        return 1;
+    if (type == "VEC2")
+        return 2;
+    if (type == "VEC3")
+        return 3;
+    if (type == "VEC4" || type == "MAT2")
+        return 4;
+    if (type == "MAT3")
+        return 9;
+    if (type == "MAT4")
+        return 16;
+    return 0;
+}
+
+template<typename T>
+T load(const uint8_t* p)
+{
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+void readComponent(const uint8_t* p, uint32_t componentType, bool normalized, float& out)
+{
+    // Normalized integers are mapped to [0,1] or [-1,1], see the glTF specification on animation samplers.
+    switch (componentType)
+    {
+    case kByte:
+        out = normalized ? std::max(load<int8_t>(p) / 127.f, -1.f) : float(load<int8_t>(p));
+        break;
+    case kUnsignedByte:
+        out = normalized ? load<uint8_t>(p) / 255.f : float(load<uint8_t>(p));
+        break;
+    case kShort:
+        out = normalized ? std::max(load<int16_t>(p) / 32767.f, -1.f) : float(load<int16_t>(p));
+        break;
+    case kUnsignedShort:
+        out = normalized ? load<uint16_t>(p) / 65535.f : float(load<uint16_t>(p));
+        break;
+    case kUnsignedInt:
+        out = float(load<uint32_t>(p));
+        break;
+    default:
+        out = load<float>(p);
+        break;
+    }
+}
+
+void readComponent(const uint8_t* p, uint32_t componentType, bool normalized, uint32_t& out)
+{
+    switch (componentType)
+    {
+    case kByte:
+    case kUnsignedByte:
+        out = load<uint8_t>(p);
+        break;
+    case kShort:
+    case kUnsignedShort:
+        out = load<uint16_t>(p);
+        break;
+    case kFloat:
+        out = uint32_t(load<float>(p));
+        break;
+    default:
+        out = load<uint32_t>(p);
+        break;
+    }
+}
+
+template<typename T>
+struct ElementTraits
+{
+    using Component = T;
+    static constexpr int kCount = 1;
+    static Component* components(T& v) { return &v; }
+};
+
+template<typename T, int N>
+struct ElementTraits<math::vector<T, N>>
+{
+    using Component = T;
+    static constexpr int kCount = N;
+    static Component* components(math::vector<T, N>& v) { return &v[0]; }
+};
+
+/// Resolved accessor.
+struct Accessor
+{
+    const uint8_t* pData = nullptr; ///< First element, nullptr if the accessor has no buffer view (initialized to zeros).
+    size_t count = 0;               ///< Number of elements.
+    size_t stride = 0;              ///< Distance between elements in bytes.
+    uint32_t componentType = kFloat;
+    uint32_t componentCount = 1;
+    bool normalized = false;
+    const json* pSparse = nullptr; ///< Sparse substitution, nullptr if the accessor is dense.
+
+    size_t getComponentSize() const { return Falcor::getComponentSize(componentType); }
+    size_t getElementSize() const { return getComponentSize() * componentCount; }
+
+    template<typename T>
+    void readElement(const uint8_t* p, T& out) const
+    {
+        using Traits = ElementTraits<T>;
+        auto* components = Traits::components(out);
+        const int count = std::min<int>(Traits::kCount, componentCount);
+        for (int i = 0; i < count; i++)
+            readComponent(p + i * getComponentSize(), componentType, normalized, components[i]);
+    }
+
+    /**
+     * Get the accessor data as an array of T without copying.
+     * @return Pointer to the elements or nullptr if the data is not tightly packed, sparse or of a different type.
+     */
+    template<typename T>
+    const T* getDirect(uint32_t expectedComponentType) const
+    {
+        if (!pData || pSparse || normalized || componentType != expectedComponentType)
+            return nullptr;
+        if (componentCount != ElementTraits<T>::kCount || stride != sizeof(T))
+            return nullptr;
+        if (reinterpret_cast<uintptr_t>(pData) % alignof(T) != 0)
+            return nullptr;
+        return reinterpret_cast<const T*>(pData);
+    }
+};
+
+/// Resolved buffer view.
+struct BufferView
+{
+    fstd::span<const uint8_t> data;
+    size_t stride = 0; ///< Byte stride of vertex attributes, 0 if tightly packed.
+};
+
+struct TextureRequest
+{
+    ref<Material> pMaterial;
+    Material::TextureSlot slot;
+    uint32_t image;
+};
+
+class ImporterData
+{
+public:
+    ImporterData(const std::filesystem::path& path, SceneBuilder& builder) : path(path), builder(builder) {}
+
+    ~ImporterData()
+    {
+        // The extracted images are only needed until the material textures are loaded.
+        if (!embeddedImageDirectory.empty())
+        {
+            builder.waitForMaterialTextureLoading();
+            std::error_code ec;
+            std::filesystem::remove_all(embeddedImageDirectory, ec);
+        }
+    }
+
+    std::filesystem::path path; ///< Asset path. Empty when importing from memory.
+    SceneBuilder& builder;
+    json document;
+
+    std::unique_ptr<MemoryMappedFile> pFile; ///< Mapped GLB file.
+    fstd::span<const uint8_t> glbBinary;     ///< Binary chunk of the GLB container.
+
+    std::vector<std::unique_ptr<MemoryMappedFile>> bufferFiles;
+    std::vector<std::vector<uint8_t>> bufferStorage;
+    std::vector<fstd::span<const uint8_t>> buffers;
+    std::vector<std::vector<uint8_t>> decodedBufferViews;
+    std::vector<BufferView> bufferViews;
+
+    std::vector<ref<Material>> materials;
+    ref<Material> pDefaultMaterial;
+    std::vector<TextureRequest> textureRequests;
+    std::filesystem::path embeddedImageDirectory; ///< Temporary directory for images extracted from GLB files and data URIs.
+
+    std::vector<NodeID> nodeIDs;       ///< Falcor node per glTF node, invalid if the node is not part of the scene.
+    std::vector<float4x4> worldMatrices;
+    std::vector<int> meshSkins;        ///< Skin used by each mesh, -1 if not skinned.
+    std::vector<std::vector<MeshID>> meshIDs;
+
+    const json& getElement(const char* key, size_t index) const
+    {
+        const json& array = getArray(document, key);
+        if (index >= array.size())
+            throw ImporterError(path, "Reference to {}[{}] is out of range.", key, index);
+        return array[index];
+    }
+
+    const BufferView& getBufferView(size_t index) const
+    {
+        if (index >= bufferViews.size())
+            throw ImporterError(path, "Reference to bufferViews[{}] is out of range.", index);
+        return bufferViews[index];
+    }
+
+    Accessor getAccessor(size_t index) const
+    {
+        const json& object = getElement("accessors", index);
+
+        Accessor accessor;
+        accessor.count = object.at("count").get<size_t>();
+        accessor.componentType = object.at("componentType").get<uint32_t>();
+        accessor.componentCount = getComponentCount(object.at("type").get<std::string>());
+        accessor.normalized = object.value("normalized", false);
+        if (accessor.getComponentSize() == 0 || accessor.componentCount == 0)
+            throw ImporterError(path, "Accessor {} has an invalid type.", index);
+
+        const size_t elementSize = accessor.getElementSize();
+        accessor.stride = elementSize;
+        if (auto it = object.find("bufferView"); it != object.end())
+        {
+            const BufferView& bufferView = getBufferView(it->get<size_t>());
+            const size_t offset = object.value("byteOffset", size_t(0));
+            if (bufferView.stride != 0)
+                accessor.stride = bufferView.stride;
+            if (offset > bufferView.data.size() ||
+                (accessor.count > 0 && offset + (accessor.count - 1) * accessor.stride + elementSize > bufferView.data.size()))
+                throw ImporterError(path, "Accessor {} exceeds its buffer view.", index);
+            accessor.pData = bufferView.data.data() + offset;
+        }
+        if (auto it = object.find("sparse"); it != object.end())
+            accessor.pSparse = &*it;
+
+        return accessor;
+    }
+
+    /// Read all accessor elements, converting them to T. Missing components are zero.
+    template<typename T>
+    std::vector<T> readAccessor(const Accessor& accessor) const
+    {
+        std::vector<T> elements(accessor.count, T{});
+        if (accessor.pData)
+        {
+            for (size_t i = 0; i < accessor.count; i++)
+                accessor.readElement(accessor.pData + i * accessor.stride, elements[i]);
+        }
+
+        if (accessor.pSparse)
+        {
+            const json& sparse = *accessor.pSparse;
+            const size_t count = sparse.at("count").get<size_t>();
+            const json& indices = sparse.at("indices");
+            const json& values = sparse.at("values");
+
+            const uint32_t indexType = indices.at("componentType").get<uint32_t>();
+            const size_t indexSize = getComponentSize(indexType);
+            const size_t elementSize = accessor.getElementSize();
+            auto getData = [&](const json& object)
+            {
+                auto data = getBufferView(object.at("bufferView").get<size_t>()).data;
+                const size_t offset = object.value("byteOffset", size_t(0));
+                if (offset > data.size())
+                    throw ImporterError(path, "Sparse accessor exceeds its buffer views.");
+                return data.subspan(offset);
+            };
+            auto indexData = getData(indices);
+            auto valueData = getData(values);
+            if (indexSize == 0 || indexData.size() < count * indexSize || valueData.size() < count * elementSize)
+                throw ImporterError(path, "Sparse accessor exceeds its buffer views.");
+
+            for (size_t i = 0; i < count; i++)
+            {
+                uint32_t index;
+                readComponent(indexData.data() + i * indexSize, indexType, false, index);
+                if (index >= accessor.count)
+                    throw ImporterError(path, "Sparse accessor index {} is out of range.", index);
+                accessor.readElement(valueData.data() + i * elementSize, elements[index]);
+            }
+        }
+
+        return elements;
+    }
+
+    template<typename T>
+    std::vector<T> readAccessor(size_t index) const
+    {
+        return readAccessor<T>(getAccessor(index));
+    }
+
+    std::vector<float4x4> readMatrices(size_t index) const
+    {
+        Accessor accessor = getAccessor(index);
+        if (accessor.componentType != kFloat || accessor.componentCount != 16 || !accessor.pData || accessor.pSparse)
+            throw ImporterError(path, "Accessor {} is not a dense array of float matrices.", index);
+        std::vector<float4x4> matrices(accessor.count);
+        for (size_t i = 0; i < accessor.count; i++)
+        {
+            float m[16];
+            std::memcpy(m, accessor.pData + i * accessor.stride, sizeof(m));
+            matrices[i] = matrixFromColumnMajor(m);
+        }
+        return matrices;
+    }
+
+    /// Directory used to resolve relative URIs.
+    std::filesystem::path getSearchPath() const { return path.parent_path(); }
+};
+
+std::vector<uint8_t> decodeDataURI(const std::filesystem::path& path, const std::string& uri, std::string* pMimeType = nullptr)
+{
+    // data:[<mediatype>][;base64],<data>
+    const size_t comma = uri.find(',');
+    const std::string header = uri.substr(0, comma);
+    if (comma == std::string::npos || !hasSuffix(header, ";base64"))
+        throw ImporterError(path, "Only base64 encoded data URIs are supported.");
+    if (pMimeType)
+        *pMimeType = header.substr(5, header.size() - 5 - 7);
+    return decodeBase64(uri.substr(comma + 1));
+}
+
+bool isDataURI(const std::string& uri)
+{
+    return hasPrefix(uri, "data:");
+}
+
+void parseAsset(ImporterData& data, const void* buffer, size_t byteSize)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(buffer);
+    if (byteSize >= kGlbHeaderSize && load<uint32_t>(bytes) == kGlbMagic)
+    {
+        // Binary container: a JSON chunk optionally followed by a binary chunk, which is used in place.
+        const uint32_t version = load<uint32_t>(bytes + 4);
+        const size_t length = std::min<size_t>(load<uint32_t>(bytes + 8), byteSize);
+        if (version != 2)
+            throw ImporterError(data.path, "Unsupported GLB version {}.", version);
+
+        size_t offset = kGlbHeaderSize;
+        bool hasJson = false;
+        while (offset + kGlbChunkHeaderSize <= length)
+        {
+            const size_t chunkLength = load<uint32_t>(bytes + offset);
+            const uint32_t chunkType = load<uint32_t>(bytes + offset + 4);
+            const uint8_t* chunkData = bytes + offset + kGlbChunkHeaderSize;
+            if (chunkLength > length - offset - kGlbChunkHeaderSize)
+                throw ImporterError(data.path, "GLB chunk exceeds the file size.");
+
+            if (chunkType == kGlbChunkJson && !hasJson)
+            {
+                data.document = json::parse(chunkData, chunkData + chunkLength);
+                hasJson = true;
+            }
+            else if (chunkType == kGlbChunkBin && data.glbBinary.empty())
+            {
+                data.glbBinary = fstd::span<const uint8_t>(chunkData, chunkLength);
+            }
+            offset += kGlbChunkHeaderSize + ((chunkLength + 3) & ~size_t(3));
+        }
+        if (!hasJson)
+            throw ImporterError(data.path, "GLB file has no JSON chunk.");
+    }
+    else
+    {
+        const char* text = static_cast<const char*>(buffer);
+        data.document = json::parse(text, text + byteSize);
+    }
+
+    const json& asset = data.document.at("asset");
+    const std::string version = asset.at("version").get<std::string>();
+    if (!hasPrefix(version, "2."))
+        throw ImporterError(data.path, "Unsupported glTF version '{}'.", version);
+
+    for (const auto& extension : getArray(data.document, "extensionsRequired"))
+    {
+        const std::string name = extension.get<std::string>();
+        if (name == kDracoMeshCompression)
+            throw ImporterError(
+                data.path,
+                "Asset requires '{}', which is not supported. Re-export it without Draco compression or with EXT_meshopt_compression.",
+                name
+            );
+        if (kSupportedExtensions.count(name) == 0)
+            throw ImporterError(data.path, "Asset requires unsupported extension '{}'.", name);
+    }
+    for (const auto& extension : getArray(data.document, "extensionsUsed"))
+    {
+        const std::string name = extension.get<std::string>();
+        if (kSupportedExtensions.count(name) == 0)
+            logWarning("GltfImporter: Extension '{}' is not supported, ignoring.", name);
+    }
+}
+
+void loadBuffers(ImporterData& data, BS::thread_pool& threadPool)
+{
+    const json& buffers = getArray(data.document, "buffers");
+    data.buffers.resize(buffers.size());
+    data.bufferStorage.resize(buffers.size());
+    data.bufferFiles.resize(buffers.size());
+
+    // Memory map external files and decode data URIs concurrently. Mapped data is paged in by the threads that read it later.
+    std::vector<std::future<void>> buffersLoaded;
+    for (size_t i = 0; i < buffers.size(); i++)
+    {
+        buffersLoaded.push_back(threadPool.submit(
+            [&data, &buffers, i]()
+            {
+                const json& buffer = buffers[i];
+                const size_t byteLength = buffer.at("byteLength").get<size_t>();
+                const std::string uri = buffer.value("uri", std::string());
+                fstd::span<const uint8_t> bytes;
+
+                if (uri.empty())
+                {
+                    // The first buffer without URI refers to the GLB binary chunk.
+                    // Fallback buffers of EXT_meshopt_compression have no data and must not be referenced by uncompressed views.
+                    if (i == 0 && !data.glbBinary.empty())
+                        bytes = data.glbBinary;
+                    else if (const json* pMeshopt = findExtension(buffer, kMeshoptCompression);
+                             pMeshopt && pMeshopt->value("fallback", false))
+                        return;
+                    else
+                        throw ImporterError(data.path, "Buffer {} has no data.", i);
+                }
+                else if (isDataURI(uri))
+                {
+                    data.bufferStorage[i] = decodeDataURI(data.path, uri);
+                    bytes = data.bufferStorage[i];
+                }
+                else
+                {
+                    if (data.path.empty())
+                        throw ImporterError(data.path, "Cannot resolve external buffer '{}' when importing from memory.", uri);
+                    const auto bufferPath = data.getSearchPath() / decodeURI(uri);
+                    auto pFile = std::make_unique<MemoryMappedFile>(
+                        bufferPath, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::RandomAccess
+                    );
+                    if (!pFile->isOpen())
+                        throw ImporterError(data.path, "Failed to open buffer '{}'.", bufferPath);
+                    bytes = fstd::span<const uint8_t>(static_cast<const uint8_t*>(pFile->getData()), pFile->getMappedSize());
+                    data.bufferFiles[i] = std::move(pFile);
+                }
+
+                if (bytes.size() < byteLength)
+                    throw ImporterError(data.path, "Buffer {} has {} bytes, expected {}.", i, bytes.size(), byteLength);
+                data.buffers[i] = bytes.first(byteLength);
+            }
+        ));
+    }
+
+    // Wait for all tasks before rethrowing errors, they reference the local data.
+    threadPool.wait_for_tasks();
+    for (auto& bufferLoaded : buffersLoaded)
+        bufferLoaded.get();
+}
+
+/**
+ * Resolve all buffer views. Views compressed with EXT_meshopt_compression are decoded on the thread pool.
+ * @return Futures for the decoding tasks.
+ */
+std::vector<std::future<void>> decodeBufferViews(ImporterData& data, BS::thread_pool& threadPool)
+{
+    const json& bufferViews = getArray(data.document, "bufferViews");
+    data.bufferViews.resize(bufferViews.size());
+    data.decodedBufferViews.resize(bufferViews.size());
+
+    auto getBufferRange = [&data](const json& object, size_t viewIndex)
+    {
+        const size_t buffer = object.at("buffer").get<size_t>();
+        const size_t offset = object.value("byteOffset", size_t(0));
+        const size_t length = object.at("byteLength").get<size_t>();
+        if (buffer >= data.buffers.size())
+            throw ImporterError(data.path, "Buffer view {} references buffer {}, which does not exist.", viewIndex, buffer);
+        // Views into fallback buffers are left empty. They fail the bounds check when an accessor uses them.
+        const auto& bytes = data.buffers[buffer];
+        if (bytes.empty())
+            return fstd::span<const uint8_t>();
+        if (offset > bytes.size() || length > bytes.size() - offset)
+            throw ImporterError(data.path, "Buffer view {} exceeds buffer {}.", viewIndex, buffer);
+        return bytes.subspan(offset, length);
+    };
+
+    // Submit the largest views first so that they don't end up last on a single thread.
+    std::vector<size_t> compressedViews;
+    for (size_t i = 0; i < bufferViews.size(); i++)
+    {
+        const json& view = bufferViews[i];
+        data.bufferViews[i].stride = view.value("byteStride", size_t(0));
+        if (findExtension(view, kMeshoptCompression))
+            compressedViews.push_back(i);
+        else
+            data.bufferViews[i].data = getBufferRange(view, i);
+    }
+    std::stable_sort(
+        compressedViews.begin(),
+        compressedViews.end(),
+        [&](size_t a, size_t b) { return bufferViews[a].at("byteLength") > bufferViews[b].at("byteLength"); }
+    );
+
+    std::vector<std::future<void>> viewsDecoded;
+    for (size_t i : compressedViews)
+    {
+        const json& extension = *findExtension(bufferViews[i], kMeshoptCompression);
+        const auto source = getBufferRange(extension, i);
+        const size_t count = extension.at("count").get<size_t>();
+        const size_t stride = extension.at("byteStride").get<size_t>();
+
+        const std::string modeName = extension.at("mode").get<std::string>();
+        MeshoptMode mode = MeshoptMode::Attributes;
+        if (modeName == "TRIANGLES")
+            mode = MeshoptMode::Triangles;
+        else if (modeName == "INDICES")
+            mode = MeshoptMode::Indices;
+        else if (modeName != "ATTRIBUTES")
+            throw ImporterError(data.path, "Buffer view {} has unknown compression mode '{}'.", i, modeName);
+
+        const std::string filterName = extension.value("filter", std::string("NONE"));
+        MeshoptFilter filter = MeshoptFilter::None;
+        if (filterName == "OCTAHEDRAL")
+            filter = MeshoptFilter::Octahedral;
+        else if (filterName == "QUATERNION")
+            filter = MeshoptFilter::Quaternion;
+        else if (filterName == "EXPONENTIAL")
+            filter = MeshoptFilter::Exponential;
+        else if (filterName != "NONE")
+            throw ImporterError(data.path, "Buffer view {} has unknown compression filter '{}'.", i, filterName);
+
+        data.decodedBufferViews[i].resize(count * stride);
+        data.bufferViews[i].data = data.decodedBufferViews[i];
+
+        viewsDecoded.push_back(threadPool.submit(
+            [&data, i, mode, filter, count, stride, source]()
+            {
+                try
+                {
+                    decodeMeshopt(mode, filter, data.decodedBufferViews[i].data(), count, stride, source.data(), source.size());
+                }
+                catch (const RuntimeError& e)
+                {
+                    throw ImporterError(data.path, "Failed to decode compressed buffer view {}: {}", i, e.what());
+                }
+            }
+        ));
+    }
+
+    return viewsDecoded;
+}
+
+void addTextureRequest(ImporterData& data, const ref<Material>& pMaterial, Material::TextureSlot slot, const json& object, const char* key)
+{
+    auto it = object.find(key);
+    if (it == object.end())
+        return;
+
+    const json& texture = data.getElement("textures", it->at("index").get<size_t>());
+    if (it->value("texCoord", 0) != 0)
+        logWarning(
+            "GltfImporter: Material '{}' uses a texture coordinate set other than TEXCOORD_0, which is not supported.", pMaterial->getName()
+        );
+    if (auto source = texture.find("source"); source != texture.end())
+        data.textureRequests.push_back({pMaterial, slot, source->get<uint32_t>()});
+}
+
+ref<Material> createMaterial(ImporterData& data, const json& object, size_t index)
+{
+    std::string name = object.value("name", std::string());
+    if (name.empty())
+        name = fmt::format("material{}", index);
+
+    // glTF materials use the metallic-roughness model. The metallic-roughness texture has the same layout as the
+    // specular texture of the MetalRough shading model: roughness in green, metallic in blue.
+    ref<StandardMaterial> pMaterial = StandardMaterial::create(data.builder.getDevice(), name, ShadingModel::MetalRough);
+
+    const json& pbr = object.contains("pbrMetallicRoughness") ? object.at("pbrMetallicRoughness") : json::object();
+    pMaterial->setBaseColor(getVector(pbr, "baseColorFactor", float4(1.f)));
+    float4 specularParams = pMaterial->getSpecularParams();
+    specularParams.g = pbr.value("roughnessFactor", 1.f);
+    specularParams.b = pbr.value("metallicFactor", 1.f);
+    pMaterial->setSpecularParams(specularParams);
+    addTextureRequest(data, pMaterial, Material::TextureSlot::BaseColor, pbr, "baseColorTexture");
+    addTextureRequest(data, pMaterial, Material::TextureSlot::Specular, pbr, "metallicRoughnessTexture");
+
+    addTextureRequest(data, pMaterial, Material::TextureSlot::Normal, object, "normalTexture");
+    addTextureRequest(data, pMaterial, Material::TextureSlot::Emissive, object, "emissiveTexture");
+    pMaterial->setEmissiveColor(getVector(object, "emissiveFactor", float3(0.f)));
+    if (const json* pExtension = findExtension(object, kMaterialsEmissiveStrength))
+        pMaterial->setEmissiveFactor(pExtension->value("emissiveStrength", 1.f));
+
+    pMaterial->setDoubleSided(object.value("doubleSided", false));
+
+    // The alpha test is derived from the threshold. A zero threshold disables it for opaque materials.
+    // Falcor has no alpha blending, blended materials are alpha tested instead.
+    const std::string alphaMode = object.value("alphaMode", std::string("OPAQUE"));
+    if (alphaMode == "MASK")
+        pMaterial->setAlphaThreshold(object.value("alphaCutoff", 0.5f));
+    else if (alphaMode == "BLEND")
+        logWarning("GltfImporter: Material '{}' uses alpha blending, which is not supported. Using alpha testing instead.", name);
+    else
+        pMaterial->setAlphaThreshold(0.f);
+
+    if (const json* pExtension = findExtension(object, kMaterialsIor))
+        pMaterial->setIndexOfRefraction(pExtension->value("ior", 1.5f));
+    if (const json* pExtension = findExtension(object, kMaterialsTransmission))
+        pMaterial->setSpecularTransmission(pExtension->value("transmissionFactor", 0.f));
+
+    return pMaterial;
+}
+
+void createMaterials(ImporterData& data)
+{
+    const json& materials = getArray(data.document, "materials");
+    data.materials.reserve(materials.size());
+    for (size_t i = 0; i < materials.size(); i++)
+        data.materials.push_back(createMaterial(data, materials[i], i));
+
+    // Primitives without a material use the glTF default material.
+    data.pDefaultMaterial = createMaterial(data, json::object(), materials.size());
+    data.pDefaultMaterial->setName("default");
+}
+
+/**
+ * Write an embedded image to a file so that it can be loaded by the texture manager.
+ * The files are written to a temporary directory per import, which is removed at the end of the import.
+ */
+std::filesystem::path writeEmbeddedImage(ImporterData& data, size_t index, fstd::span<const uint8_t> bytes, const std::string& mimeType)
+{
+    std::string extension = "bin";
+    if (mimeType == "image/png")
+        extension = "png";
+    else if (mimeType == "image/jpeg")
+        extension = "jpg";
+
+    if (data.embeddedImageDirectory.empty())
+    {
+        data.embeddedImageDirectory = getTempFilePath();
+        std::filesystem::create_directories(data.embeddedImageDirectory);
+    }
+    const auto path = data.embeddedImageDirectory / fmt::format("image{}.{}", index, extension);
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    if (!file)
+        throw ImporterError(data.path, "Failed to write embedded image {} to '{}'.", index, path);
+    return path;
+}
+
+std::filesystem::path resolveImage(ImporterData& data, size_t index)
+{
+    const json& image = data.getElement("images", index);
+    const std::string mimeType = image.value("mimeType", std::string());
+
+    if (auto bufferView = image.find("bufferView"); bufferView != image.end())
+        return writeEmbeddedImage(data, index, data.getBufferView(bufferView->get<size_t>()).data, mimeType);
+
+    const std::string uri = image.value("uri", std::string());
+    if (isDataURI(uri))
+    {
+        std::string uriMimeType;
+        std::vector<uint8_t> bytes = decodeDataURI(data.path, uri, &uriMimeType);
+        return writeEmbeddedImage(data, index, bytes, uriMimeType);
+    }
+    if (uri.empty() || data.path.empty())
+        return {};
+    return data.getSearchPath() / decodeURI(uri);
+}
+
+void requestTextures(ImporterData& data)
+{
+    std::map<uint32_t, std::filesystem::path> imagePaths;
+    for (const auto& request : data.textureRequests)
+    {
+        auto it = imagePaths.find(request.image);
+        if (it == imagePaths.end())
+            it = imagePaths.emplace(request.image, resolveImage(data, request.image)).first;
+        if (it->second.empty())
+        {
+            logWarning("GltfImporter: Image {} cannot be resolved, ignoring.", request.image);
+            continue;
+        }
+        data.builder.loadMaterialTexture(request.pMaterial, request.slot, it->second);
+    }
+}
+
+void createSceneGraph(ImporterData& data)
+{
+    const json& nodes = getArray(data.document, "nodes");
+    data.nodeIDs.assign(nodes.size(), NodeID::Invalid());
+    data.worldMatrices.assign(nodes.size(), float4x4::identity());
+
+    // Skin joints are bones. Their inverse bind matrix takes vertices from mesh space to the local space of the bone.
+    std::vector<float4x4> localToBindPose(nodes.size(), float4x4::identity());
+    for (const auto& skin : getArray(data.document, "skins"))
+    {
+        const json& joints = skin.at("joints");
+        std::vector<float4x4> inverseBindMatrices;
+        if (auto it = skin.find("inverseBindMatrices"); it != skin.end())
+            inverseBindMatrices = data.readMatrices(it->get<size_t>());
+        if (!inverseBindMatrices.empty() && inverseBindMatrices.size() != joints.size())
+            throw ImporterError(data.path, "Skin has {} joints but {} inverse bind matrices.", joints.size(), inverseBindMatrices.size());
+        for (size_t j = 0; j < joints.size(); j++)
+        {
+            const size_t node = joints[j].get<size_t>();
+            if (node >= nodes.size())
+                throw ImporterError(data.path, "Skin joint {} does not exist.", node);
+            if (!inverseBindMatrices.empty())
+                localToBindPose[node] = inverseBindMatrices[j];
+        }
+    }
+
+    // Nodes are added depth first. The parent is passed as glTF node index, kInvalidNode for root nodes.
+    const size_t kInvalidNode = nodes.size();
+    std::function<void(size_t, size_t)> addNode = [&](size_t index, size_t parent)
+    {
+        if (index >= nodes.size())
+            throw ImporterError(data.path, "Node {} does not exist.", index);
+        if (data.nodeIDs[index] != NodeID::Invalid())
+            throw ImporterError(data.path, "Node {} appears more than once in the scene hierarchy.", index);
+
+        const json& node = nodes[index];
+        SceneBuilder::Node n;
+        n.name = node.value("name", fmt::format("node{}", index));
+        n.parent = parent != kInvalidNode ? data.nodeIDs[parent] : NodeID::Invalid();
+        if (auto matrix = node.find("matrix"); matrix != node.end())
+        {
+            std::vector<float> m = matrix->get<std::vector<float>>();
+            if (m.size() != 16)
+                throw ImporterError(data.path, "Node {} has an invalid matrix.", index);
+            n.transform = matrixFromColumnMajor(m.data());
+        }
+        else
+        {
+            n.transform = composeTransform(
+                getVector(node, "translation", float3(0.f)), getQuat(node, "rotation"), getVector(node, "scale", float3(1.f))
+            );
+        }
+        n.localToBindPose = localToBindPose[index];
+
+        data.nodeIDs[index] = data.builder.addNode(n);
+        data.worldMatrices[index] = parent != kInvalidNode ? mul(data.worldMatrices[parent], n.transform) : n.transform;
+
+        for (const auto& child : getArray(node, "children"))
+            addNode(child.get<size_t>(), index);
+    };
+
+    const json& scenes = getArray(data.document, "scenes");
+    if (!scenes.empty())
+    {
+        const json& scene = data.getElement("scenes", data.document.value("scene", size_t(0)));
+        for (const auto& root : getArray(scene, "nodes"))
+            addNode(root.get<size_t>(), kInvalidNode);
+    }
+    else
+    {
+        // Without scenes, all root nodes are imported.
+        std::vector<bool> isChild(nodes.size(), false);
+        for (const auto& node : nodes)
+            for (const auto& child : getArray(node, "children"))
+                if (child.get<size_t>() < nodes.size())
+                    isChild[child.get<size_t>()] = true;
+        for (size_t i = 0; i < nodes.size(); i++)
+            if (!isChild[i])
+                addNode(i, kInvalidNode);
+    }
+
+    // Determine the skin used for each mesh. Meshes are processed once, so a mesh can only be bound to a single skin.
+    data.meshSkins.assign(getArray(data.document, "meshes").size(), -1);
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        const json& node = nodes[i];
+        if (!node.contains("mesh") || !node.contains("skin") || data.nodeIDs[i] == NodeID::Invalid())
+            continue;
+        const size_t mesh = node.at("mesh").get<size_t>();
+        const int skin = node.at("skin").get<int>();
+        if (mesh >= data.meshSkins.size())
+            throw ImporterError(data.path, "Node {} references mesh {}, which does not exist.", i, mesh);
+        if (data.meshSkins[mesh] >= 0 && data.meshSkins[mesh] != skin)
+            logWarning(
+                "GltfImporter: Mesh {} is used with multiple skins, which is not supported. Using skin {}.", mesh, data.meshSkins[mesh]
+            );
+        else
+            data.meshSkins[mesh] = skin;
+    }
+}
+
+/// Animation channel of a single node property, sampled at the keyframe times of the node.
+struct AnimationTrack
+{
+    std::string path;
+    std::vector<float> times;
+    std::vector<float4> values;
+    bool step = false;
+
+    float4 sample(float time) const
+    {
+        auto it = std::upper_bound(times.begin(), times.end(), time);
+        if (it == times.begin())
+            return values.front();
+        if (it == times.end())
+            return values.back();
+
+        const size_t i1 = it - times.begin();
+        const size_t i0 = i1 - 1;
+        if (step)
+            return values[i0];
+
+        const float t = (time - times[i0]) / (times[i1] - times[i0]);
+        if (path == "rotation")
+        {
+            const quatf q0(values[i0].x, values[i0].y, values[i0].z, values[i0].w);
+            const quatf q1(values[i1].x, values[i1].y, values[i1].z, values[i1].w);
+            quatf q = slerp(q0, q1, t);
+            return float4(q.x, q.y, q.z, q.w);
+        }
+        return values[i0] + (values[i1] - values[i0]) * t;
+    }
+};
+
+void createAnimations(ImporterData& data)
+{
+    const json& nodes = getArray(data.document, "nodes");
+    const json& animations = getArray(data.document, "animations");
+    bool hasMorphTargets = false;
+
+    for (size_t a = 0; a < animations.size(); a++)
+    {
+        const json& animation = animations[a];
+        const std::string animationName = animation.value("name", fmt::format("animation{}", a));
+        const json& samplers = getArray(animation, "samplers");
+
+        // Falcor animates nodes, so the channels are grouped by their target node.
+        std::map<size_t, std::vector<AnimationTrack>> nodeTracks;
+        double duration = 0.0;
+        for (const auto& channel : getArray(animation, "channels"))
+        {
+            const json& target = channel.at("target");
+            const std::string path = target.at("path").get<std::string>();
+            if (path == "weights")
+            {
+                hasMorphTargets = true;
+                continue;
+            }
+            const size_t node = target.value("node", nodes.size());
+            if (node >= nodes.size() || data.nodeIDs[node] == NodeID::Invalid())
+                continue;
+
+            const size_t samplerIndex = channel.at("sampler").get<size_t>();
+            if (samplerIndex >= samplers.size())
+                throw ImporterError(data.path, "Animation '{}' references sampler {}, which does not exist.", animationName, samplerIndex);
+            const json& sampler = samplers[samplerIndex];
+
+            AnimationTrack track;
+            track.path = path;
+            track.times = data.readAccessor<float>(sampler.at("input").get<size_t>());
+            track.values = data.readAccessor<float4>(sampler.at("output").get<size_t>());
+
+            const std::string interpolation = sampler.value("interpolation", std::string("LINEAR"));
+            track.step = interpolation == "STEP";
+            if (interpolation == "CUBICSPLINE" && track.values.size() == 3 * track.times.size())
+            {
+                // Elements are stored as (in-tangent, value, out-tangent). The tangents are dropped and the values interpolated linearly.
+                for (size_t i = 0; i < track.times.size(); i++)
+                    track.values[i] = track.values[3 * i + 1];
+                track.values.resize(track.times.size());
+            }
+            if (track.times.empty() || track.values.size() != track.times.size())
+                throw ImporterError(data.path, "Animation '{}' has a sampler with mismatching input and output.", animationName);
+
+            duration = std::max(duration, double(track.times.back()));
+            nodeTracks[node].push_back(std::move(track));
+        }
+
+        for (const auto& [node, tracks] : nodeTracks)
+        {
+            // Keyframes are created at the union of the channel times. Properties without channel keep the rest transform of the node.
+            std::vector<float> times;
+            for (const auto& track : tracks)
+                times.insert(times.end(), track.times.begin(), track.times.end());
+            std::sort(times.begin(), times.end());
+            times.erase(std::unique(times.begin(), times.end()), times.end());
+
+            Animation::Keyframe rest;
+            rest.translation = getVector(nodes[node], "translation", float3(0.f));
+            rest.rotation = getQuat(nodes[node], "rotation");
+            rest.scaling = getVector(nodes[node], "scale", float3(1.f));
+
+            const NodeID nodeID = data.nodeIDs[node];
+            ref<Animation> pAnimation = Animation::create(animationName + "." + data.builder.getNode(nodeID).name, nodeID, duration);
+            for (float time : times)
+            {
+                Animation::Keyframe keyframe = rest;
+                keyframe.time = time;
+                for (const auto& track : tracks)
+                {
+                    float4 value = track.sample(time);
+                    if (track.path == "translation")
+                        keyframe.translation = value.xyz();
+                    else if (track.path == "rotation")
+                        keyframe.rotation = normalize(quatf(value.x, value.y, value.z, value.w));
+                    else if (track.path == "scale")
+                        keyframe.scaling = value.xyz();
+                }
+                pAnimation->addKeyframe(keyframe);
+            }
+            data.builder.addAnimation(pAnimation);
+        }
+    }
+
+    if (hasMorphTargets)
+        logWarning("GltfImporter: Morph target animations are not supported, ignoring.");
+}
+
+void createCameras(ImporterData& data)
+{
+    const json& nodes = getArray(data.document, "nodes");
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        auto it = nodes[i].find("camera");
+        if (it == nodes[i].end() || data.nodeIDs[i] == NodeID::Invalid())
+            continue;
+
+        const json& camera = data.getElement("cameras", it->get<size_t>());
+        const std::string name = camera.value("name", data.builder.getNode(data.nodeIDs[i]).name);
+        if (camera.value("type", std::string()) != "perspective")
+        {
+            logWarning("GltfImporter: Camera '{}' is not a perspective camera, ignoring.", name);
+            continue;
+        }
+
+        const json& perspective = camera.at("perspective");
+        ref<Camera> pCamera = Camera::create(name);
+        pCamera->setAspectRatio(perspective.value("aspectRatio", pCamera->getAspectRatio()));
+        pCamera->setFocalLength(fovYToFocalLength(perspective.at("yfov").get<float>(), pCamera->getFrameHeight()));
+        pCamera->setDepthRange(perspective.value("znear", pCamera->getNearPlane()), perspective.value("zfar", pCamera->getFarPlane()));
+
+        // glTF cameras look along -Z of their node, which is the convention used when updating from the node transform.
+        pCamera->setNodeID(data.nodeIDs[i]);
+        pCamera->updateFromAnimation(data.worldMatrices[i]);
+        if (data.builder.isNodeAnimated(data.nodeIDs[i]))
+            pCamera->setHasAnimation(true);
+
+        data.builder.addCamera(pCamera);
+    }
+}
+
+void createLights(ImporterData& data)
+{
+    const json* pLights = findExtension(data.document, kLightsPunctual);
+    if (!pLights)
+        return;
+
+    const json& lights = getArray(*pLights, "lights");
+    const json& nodes = getArray(data.document, "nodes");
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        const json* pNodeLight = findExtension(nodes[i], kLightsPunctual);
+        if (!pNodeLight || data.nodeIDs[i] == NodeID::Invalid())
+            continue;
+
+        const size_t index = pNodeLight->at("light").get<size_t>();
+        if (index >= lights.size())
+            throw ImporterError(data.path, "Node {} references light {}, which does not exist.", i, index);
+        const json& light = lights[index];
+        const std::string name = light.value("name", data.builder.getNode(data.nodeIDs[i]).name);
+        const std::string type = light.at("type").get<std::string>();
+
+        // Lights point along -Z of their node.
+        ref<Light> pLight;
+        if (type == "directional")
+        {
+            ref<DirectionalLight> pDirLight = DirectionalLight::create(name);
+            pDirLight->setWorldDirection(float3(0.f, 0.f, -1.f));
+            pLight = pDirLight;
+        }
+        else if (type == "point" || type == "spot")
+        {
+            ref<PointLight> pPointLight = PointLight::create(name);
+            pPointLight->setWorldPosition(float3(0.f));
+            pPointLight->setWorldDirection(float3(0.f, 0.f, -1.f));
+            if (type == "spot")
+            {
+                const json& spot = light.at("spot");
+                const float outerConeAngle = spot.value("outerConeAngle", float(M_PI) / 4.f);
+                const float innerConeAngle = spot.value("innerConeAngle", 0.f);
+                pPointLight->setOpeningAngle(outerConeAngle);
+                pPointLight->setPenumbraAngle(outerConeAngle - innerConeAngle);
+            }
+            pLight = pPointLight;
+        }
+        else
+        {
+            logWarning("GltfImporter: Light '{}' has unsupported type '{}', ignoring.", name, type);
+            continue;
+        }
+
+        pLight->setIntensity(getVector(light, "color", float3(1.f)) * light.value("intensity", 1.f));
+        pLight->setNodeID(data.nodeIDs[i]);
+        pLight->setHasAnimation(true);
+        pLight->updateFromAnimation(data.worldMatrices[i]);
+        data.builder.addLight(pLight);
+    }
+}
+
+/// Get vertex attribute data in place if it is stored as tightly packed floats, otherwise convert it into the storage.
+template<typename T>
+const T* getAttributeData(const ImporterData& data, const Accessor& accessor, size_t vertexCount, std::vector<T>& storage)
+{
+    if (accessor.count != vertexCount)
+        throw ImporterError(data.path, "Vertex attribute has {} elements, expected {}.", accessor.count, vertexCount);
+    if (const T* pData = accessor.getDirect<T>(kFloat))
+        return pData;
+    storage = data.readAccessor<T>(accessor);
+    return storage.data();
+}
+
+SceneBuilder::ProcessedMesh convertPrimitive(const ImporterData& data, size_t meshIndex, size_t primitiveIndex)
+{
+    const json& mesh = data.getElement("meshes", meshIndex);
+    const json& primitive = mesh.at("primitives").at(primitiveIndex);
+    const json& attributes = primitive.at("attributes");
+
+    SceneBuilder::Mesh falcorMesh;
+    falcorMesh.name = mesh.value("name", fmt::format("mesh{}", meshIndex));
+    falcorMesh.topology = Vao::Topology::TriangleList;
+    falcorMesh.pMaterial = data.pDefaultMaterial;
+    if (auto it = primitive.find("material"); it != primitive.end())
+    {
+        const size_t material = it->get<size_t>();
+        if (material >= data.materials.size())
+            throw ImporterError(data.path, "Mesh '{}' references material {}, which does not exist.", falcorMesh.name, material);
+        falcorMesh.pMaterial = data.materials[material];
+    }
+
+    // Attributes stored as tightly packed floats are passed to the scene builder in place. Others are converted.
+    const Accessor positions = data.getAccessor(attributes.at("POSITION").get<size_t>());
+    const size_t vertexCount = positions.count;
+    std::vector<float3> positionStorage;
+    falcorMesh.positions = {
+        getAttributeData(data, positions, vertexCount, positionStorage), SceneBuilder::Mesh::AttributeFrequency::Vertex};
+
+    std::vector<uint32_t> indexStorage;
+    const uint32_t* pIndices = nullptr;
+    size_t indexCount = vertexCount;
+    if (auto it = primitive.find("indices"); it != primitive.end())
+    {
+        const Accessor indices = data.getAccessor(it->get<size_t>());
+        indexCount = indices.count;
+        pIndices = indices.getDirect<uint32_t>(kUnsignedInt);
+        if (!pIndices)
+        {
+            indexStorage = data.readAccessor<uint32_t>(indices);
+            pIndices = indexStorage.data();
+        }
+    }
+    else
+    {
+        indexStorage.resize(vertexCount);
+        std::iota(indexStorage.begin(), indexStorage.end(), 0u);
+        pIndices = indexStorage.data();
+    }
+
+    // Triangle strips and fans are converted to lists.
+    const uint32_t mode = primitive.value("mode", kModeTriangles);
+    if ((mode == kModeTriangleStrip || mode == kModeTriangleFan) && indexCount >= 3)
+    {
+        std::vector<uint32_t> triangles;
+        triangles.reserve((indexCount - 2) * 3);
+        for (size_t i = 0; i + 2 < indexCount; i++)
+        {
+            if (mode == kModeTriangleStrip)
+                triangles.insert(triangles.end(), {pIndices[i], pIndices[i + 1 + i % 2], pIndices[i + 2 - i % 2]});
+            else
+                triangles.insert(triangles.end(), {pIndices[i + 1], pIndices[i + 2], pIndices[0]});
+        }
+        indexStorage = std::move(triangles);
+        pIndices = indexStorage.data();
+        indexCount = indexStorage.size();
+    }
+
+    if (indexCount % 3 != 0)
+        throw ImporterError(data.path, "Mesh '{}' has {} indices, which is not a multiple of 3.", falcorMesh.name, indexCount);
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        if (pIndices[i] >= vertexCount)
+            throw ImporterError(data.path, "Mesh '{}' has index {} out of range.", falcorMesh.name, pIndices[i]);
+    }
+
+    falcorMesh.indexCount = uint32_t(indexCount);
+    falcorMesh.faceCount = uint32_t(indexCount / 3);
+    falcorMesh.vertexCount = uint32_t(vertexCount);
+    falcorMesh.pIndices = pIndices;
+
+    std::vector<float3> normalStorage;
+    if (auto it = attributes.find("NORMAL"); it != attributes.end())
+    {
+        falcorMesh.normals = {
+            getAttributeData(data, data.getAccessor(it->get<size_t>()), vertexCount, normalStorage),
+            SceneBuilder::Mesh::AttributeFrequency::Vertex};
+    }
+    else
+    {
+        // The specification requires flat normals if none are given.
+        normalStorage.resize(falcorMesh.faceCount);
+        for (uint32_t face = 0; face < falcorMesh.faceCount; face++)
+        {
+            const float3 p0 = falcorMesh.getPosition(face, 0);
+            const float3 n = cross(falcorMesh.getPosition(face, 1) - p0, falcorMesh.getPosition(face, 2) - p0);
+            normalStorage[face] = length(n) > 0.f ? normalize(n) : float3(0.f, 0.f, 1.f);
+        }
+        falcorMesh.normals = {normalStorage.data(), SceneBuilder::Mesh::AttributeFrequency::Uniform};
+    }
+
+    std::vector<float4> tangentStorage;
+    if (auto it = attributes.find("TANGENT");
+        it != attributes.end() && is_set(data.builder.getFlags(), SceneBuilder::Flags::UseOriginalTangentSpace))
+    {
+        // The w component is the bitangent sign, the same convention as used by the scene builder.
+        falcorMesh.tangents = {
+            getAttributeData(data, data.getAccessor(it->get<size_t>()), vertexCount, tangentStorage),
+            SceneBuilder::Mesh::AttributeFrequency::Vertex};
+    }
+
+    std::vector<float2> texCrds;
+    if (auto it = attributes.find("TEXCOORD_0"); it != attributes.end())
+    {
+        const Accessor accessor = data.getAccessor(it->get<size_t>());
+        if (accessor.count != vertexCount)
+            throw ImporterError(
+                data.path, "Mesh '{}' has {} texture coordinates, expected {}.", falcorMesh.name, accessor.count, vertexCount
+            );
+        texCrds = data.readAccessor<float2>(accessor);
+        falcorMesh.texCrds = {texCrds.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex};
+    }
+
+    std::vector<uint4> boneIDs;
+    std::vector<float4> boneWeights;
+    const int skin = data.meshSkins[meshIndex];
+    auto joints = attributes.find("JOINTS_0");
+    auto weights = attributes.find("WEIGHTS_0");
+    if (skin >= 0 && joints != attributes.end() && weights != attributes.end())
+    {
+        // Joint indices refer to the joint list of the skin. Unused influences have zero weight and get an invalid bone.
+        const json& skinJoints = data.getElement("skins", skin).at("joints");
+        boneIDs = data.readAccessor<uint4>(joints->get<size_t>());
+        boneWeights = data.readAccessor<float4>(weights->get<size_t>());
+        if (boneIDs.size() != vertexCount || boneWeights.size() != vertexCount)
+            throw ImporterError(data.path, "Mesh '{}' has skinning attributes that don't match the vertex count.", falcorMesh.name);
+        for (size_t v = 0; v < vertexCount; v++)
+        {
+            for (int k = 0; k < 4; k++)
+            {
+                if (boneWeights[v][k] == 0.f)
+                {
+                    boneIDs[v][k] = NodeID::kInvalidID;
+                    continue;
+                }
+                if (boneIDs[v][k] >= skinJoints.size())
+                    throw ImporterError(data.path, "Mesh '{}' references joint {}, which does not exist.", falcorMesh.name, boneIDs[v][k]);
+                boneIDs[v][k] = data.nodeIDs[skinJoints[boneIDs[v][k]].get<size_t>()].getSlang();
+            }
+        }
+        falcorMesh.boneIDs = {boneIDs.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex};
+        falcorMesh.boneWeights = {boneWeights.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex};
+    }
+
+    return data.builder.processMesh(falcorMesh);
+}
+
+void createMeshes(ImporterData& data, BS::thread_pool& threadPool, TimeReport& timeReport)
+{
+    const json& meshes = getArray(data.document, "meshes");
+    data.meshIDs.assign(meshes.size(), {});
+
+    struct PrimitiveRef
+    {
+        size_t mesh;
+        size_t primitive;
+        size_t size;
+    };
+
+    std::vector<PrimitiveRef> primitives;
+    bool usesDraco = false;
+    for (size_t m = 0; m < meshes.size(); m++)
+    {
+        const json& mesh = meshes[m];
+        const json& meshPrimitives = mesh.at("primitives");
+        for (size_t p = 0; p < meshPrimitives.size(); p++)
+        {
+            const json& primitive = meshPrimitives[p];
+            const uint32_t mode = primitive.value("mode", kModeTriangles);
+            if (mode != kModeTriangles && mode != kModeTriangleStrip && mode != kModeTriangleFan)
+            {
+                logWarning("GltfImporter: Mesh '{}' has a primitive that is not made of triangles, ignoring.", mesh.value("name", ""));
+                continue;
+            }
+            const json& attributes = primitive.at("attributes");
+            if (!attributes.contains("POSITION"))
+            {
+                logWarning("GltfImporter: Mesh '{}' has a primitive without positions, ignoring.", mesh.value("name", ""));
+                continue;
+            }
+            // Draco is only accepted as an optional extension (checked in parseAsset), so uncompressed data is present.
+            usesDraco |= findExtension(primitive, kDracoMeshCompression) != nullptr;
+
+            const size_t accessor =
+                primitive.contains("indices") ? primitive.at("indices").get<size_t>() : attributes.at("POSITION").get<size_t>();
+            primitives.push_back({m, p, data.getElement("accessors", accessor).value("count", size_t(0))});
+        }
+    }
+    if (usesDraco)
+        logWarning("GltfImporter: Draco compressed primitives are not supported. Using the uncompressed fallback data.");
+
+    // Convert the largest primitives first so that they don't end up last on a single thread.
+    std::vector<size_t> order(primitives.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return primitives[a].size > primitives[b].size; });
+
+    // Pre-process primitives in parallel. The material textures are requested on one of the threads at the same time.
+    std::vector<SceneBuilder::ProcessedMesh> processedMeshes(primitives.size());
+    {
+        auto texturesRequested = threadPool.submit([&data]() { requestTextures(data); });
+
+        std::vector<std::future<void>> primitivesConverted;
+        primitivesConverted.reserve(order.size());
+        for (size_t i : order)
+        {
+            primitivesConverted.push_back(threadPool.submit(
+                [&data, &primitives, &processedMeshes, i]()
+                { processedMeshes[i] = convertPrimitive(data, primitives[i].mesh, primitives[i].primitive); }
+            ));
+        }
+
+        // Wait for all tasks before rethrowing errors, they reference the local data.
+        threadPool.wait_for_tasks();
+        for (auto& primitiveConverted : primitivesConverted)
+            primitiveConverted.get();
+        timeReport.measure("Converting meshes");
+
+        texturesRequested.get();
+        timeReport.measure("Requesting textures");
+    }
+
+    uint64_t triangleCount = 0;
+    for (const auto& processedMesh : processedMeshes)
+        triangleCount += processedMesh.indexCount / 3;
+    logInfo(
+        "GltfImporter: Converted {} primitives with {} triangles and requested {} textures using {} threads.",
+        primitives.size(),
+        triangleCount,
+        data.textureRequests.size(),
+        threadPool.get_thread_count()
+    );
+
+    // Add meshes in document order so the scene does not depend on thread scheduling.
+    for (size_t i = 0; i < primitives.size(); i++)
+        data.meshIDs[primitives[i].mesh].push_back(data.builder.addProcessedMesh(std::move(processedMeshes[i])));
+}
+
+void addMeshInstances(ImporterData& data)
+{
+    const json& nodes = getArray(data.document, "nodes");
+    std::vector<bool> isSkinnedMeshInstanced(data.meshIDs.size(), false);
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        auto it = nodes[i].find("mesh");
+        if (it == nodes[i].end() || data.nodeIDs[i] == NodeID::Invalid())
+            continue;
+
+        const size_t mesh = it->get<size_t>();
+        if (mesh >= data.meshIDs.size())
+            throw ImporterError(data.path, "Node {} references mesh {}, which does not exist.", i, mesh);
+
+        // Skinned vertices are computed in world space by the skeleton, a skinned mesh can only be instanced once.
+        if (data.meshSkins[mesh] >= 0)
+        {
+            if (isSkinnedMeshInstanced[mesh])
+            {
+                logWarning("GltfImporter: Skinned mesh {} is instanced multiple times, ignoring instance at node {}.", mesh, i);
+                continue;
+            }
+            isSkinnedMeshInstanced[mesh] = true;
+        }
+
+        for (MeshID meshID : data.meshIDs[mesh])
+            data.builder.addMeshInstance(data.nodeIDs[i], meshID);
+    }
+}
+
+void importInternal(const void* buffer, size_t byteSize, const std::filesystem::path& path, SceneBuilder& builder)
+{
+    TimeReport timeReport;
+
+    try
+    {
+        ImporterData data(path, builder);
+
+        if (!path.empty())
+        {
+            FALCOR_ASSERT(buffer == nullptr && byteSize == 0);
+            if (!path.is_absolute())
+                throw ImporterError(path, "Expected absolute path.");
+            // The file stays mapped during the import. The GLB binary chunk is used in place.
+            data.pFile = std::make_unique<MemoryMappedFile>(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::RandomAccess);
+            if (!data.pFile->isOpen())
+                throw ImporterError(path, "Failed to open file.");
+            parseAsset(data, data.pFile->getData(), data.pFile->getMappedSize());
+        }
+        else
+        {
+            FALCOR_ASSERT(buffer != nullptr && byteSize != 0);
+            parseAsset(data, buffer, byteSize);
+        }
+        timeReport.measure("Loading asset file");
+
+        // The thread pool is destroyed before the importer data, which waits for any task that is still running.
+        BS::thread_pool threadPool;
+
+        loadBuffers(data, threadPool);
+        timeReport.measure("Loading buffers");
+
+        // Decode compressed buffer views while creating the materials.
+        auto viewsDecoded = decodeBufferViews(data, threadPool);
+        createMaterials(data);
+        threadPool.wait_for_tasks();
+        for (auto& viewDecoded : viewsDecoded)
+            viewDecoded.get();
+        timeReport.measure("Creating materials and decoding buffers");
+
+        createSceneGraph(data);
+        timeReport.measure("Creating scene graph");
+
+        createAnimations(data);
+        timeReport.measure("Creating animations");
+
+        createCameras(data);
+        createLights(data);
+        timeReport.measure("Creating cameras and lights");
+
+        createMeshes(data, threadPool, timeReport);
+        addMeshInstances(data);
+        timeReport.measure("Adding meshes");
+    }
+    catch (const json::exception& e)
+    {
+        throw ImporterError(path, "Invalid glTF document: {}", e.what());
+    }
+
+    timeReport.printToLog();
+}
+
+} // namespace
+
+std::unique_ptr<Importer> GltfImporter::create()
+{
+    return std::make_unique<GltfImporter>();
+}
+
+void GltfImporter::importScene(
+    const std::filesystem::path& path,
+    SceneBuilder& builder,
+    const std::map<std::string, std::string>& materialToShortName
+)
+{
+    importInternal(nullptr, 0, path, builder);
+}
+
+void GltfImporter::importSceneFromMemory(
+    const void* buffer,
+    size_t byteSize,
+    std::string_view extension,
+    SceneBuilder& builder,
+    const std::map<std::string, std::string>& materialToShortName
+)
+{
+    importInternal(buffer, byteSize, {}, builder);
+}
+
+extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
+{
+    registry.registerClass<Importer, GltfImporter>();
+}
+
+} // namespace Falcor
@@ -0,0 +1,62 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Scene/Importer.h"
+#include "Scene/SceneBuilder.h"
+#include <filesystem>
+#include <memory>
+
+namespace Falcor
+{
+
+/**
+ * Scene importer for glTF 2.0 assets (.gltf and .glb).
+ */
+class GltfImporter : public Importer
+{
+public:
+    FALCOR_PLUGIN_CLASS(GltfImporter, "GltfImporter", PluginInfo({"Importer for glTF 2.0 assets", {"gltf", "glb"}}));
+
+    static std::unique_ptr<Importer> create();
+
+    void importScene(
+        const std::filesystem::path& path,
+        SceneBuilder& builder,
+        const std::map<std::string, std::string>& materialToShortName
+    ) override;
+
+    void importSceneFromMemory(
+        const void* buffer,
+        size_t byteSize,
+        std::string_view extension,
+        SceneBuilder& builder,
+        const std::map<std::string, std::string>& materialToShortName
+    ) override;
+};
+
+} // namespace Falcor
@@ -34,9 +34,13 @@
 #include "Scene/Material/PBRT/PBRTDiffuseMaterial.h"
 #include "Scene/Material/PBRT/PBRTDielectricMaterial.h"
 #include "Scene/Material/PBRT/PBRTConductorMaterial.h"
+#include "Scene/MeshInstanceTable.h"
+#include "Scene/PlyReader.h"
+#include "Scene/SerializedMeshReader.h"
 
 #include <pybind11/pybind11.h>
 
+#include <map>
 #include <unordered_map>
 
 namespace Falcor
@@ -83,6 +87,9 @@ struct BuilderContext
     SceneBuilder& builder;
     std::unordered_map<std::string, XMLObject>& instances;
     std::unordered_set<std::string> warnings;
+    std::unordered_map<std::string, ref<TriangleMesh>> meshes; ///< Meshes loaded by prefetchMeshes() by shape id.
+    std::unordered_map<std::string, uint32_t> shapeGroups;     ///< Instance table definitions of shape groups by shape group id.
+    MeshInstanceTable instanceTable;
 
     void forEachReference(const XMLObject& inst, Class cls, std::function<void(const XMLObject&)> func)
     {
@@ -465,7 +472,7 @@ ShapeInfo buildShape(BuilderContext& ctx, const XMLObject& inst)
 
     ShapeInfo shape;
 
-    if (inst.type == "obj" || inst.type == "ply")
+    if (inst.type == "obj" || inst.type == "ply" || inst.type == "serialized")
     {
         auto filename = props.getString("filename");
         auto faceNormals = props.getBool("face_normals", false);
@@ -485,7 +492,23 @@ ShapeInfo buildShape(BuilderContext& ctx, const XMLObject& inst)
             flags = TriangleMesh::ImportFlags::GenSmoothNormals | TriangleMesh::ImportFlags::JoinIdenticalVertices;
         }
 
-        shape.pMesh = TriangleMesh::createFromFile(filename, flags);
+        if (auto it = ctx.meshes.find(inst.id); it != ctx.meshes.end())
+        {
+            shape.pMesh = std::move(it->second);
+            ctx.meshes.erase(it);
+        }
+        else if (inst.type == "serialized")
+        {
+            shape.pMesh = SerializedMeshReader::read(filename, (uint32_t)props.getInt("shape_index", 0), flags);
+        }
+        else if (inst.type == "ply")
+        {
+            shape.pMesh = PlyReader::read(filename, flags);
+        }
+        else
+        {
+            shape.pMesh = TriangleMesh::createFromFile(filename, flags);
+        }
         if (shape.pMesh)
             shape.pMesh->setName(inst.id);
         shape.transform = toWorld;
@@ -723,12 +746,127 @@ EmitterInfo buildEmitter(BuilderContext& ctx, const XMLObject& inst)
     return emitter;
 }
 
+/**
+ * Load the meshes of all 'ply' and 'serialized' shapes of the scene concurrently.
+ * Serialized files are opened once for all shapes referencing them. The meshes are stored in the context and taken
+ * over by buildShape().
+ */
+void prefetchMeshes(BuilderContext& ctx, const XMLObject& inst)
+{
+    // Group the shapes by import flags, see buildShape().
+    std::vector<std::string> plyIDs[2];
+    std::vector<std::filesystem::path> plyPaths[2];
+    std::map<std::pair<std::string, size_t>, std::pair<std::vector<std::string>, std::vector<uint32_t>>> serializedShapes;
+    std::function<void(const XMLObject&)> collectShapes = [&](const XMLObject& parent)
+    {
+        for (const auto& [name, id] : parent.props.getNamedReferences())
+        {
+            const auto& child = ctx.instances[id];
+            if (child.cls == Class::Shape && child.type == "shapegroup")
+            {
+                collectShapes(child);
+                continue;
+            }
+            if (child.cls != Class::Shape || (child.type != "ply" && child.type != "serialized") || !child.props.hasString("filename"))
+                continue;
+            size_t group = child.props.getBool("face_normals", false) ? 0 : 1;
+            if (child.type == "ply")
+            {
+                plyIDs[group].push_back(child.id);
+                plyPaths[group].push_back(child.props.getString("filename"));
+            }
+            else
+            {
+                auto& [ids, shapeIndices] = serializedShapes[{child.props.getString("filename"), group}];
+                ids.push_back(child.id);
+                shapeIndices.push_back((uint32_t)child.props.getInt("shape_index", 0));
+            }
+        }
+    };
+    collectShapes(inst);
+
+    auto getFlags = [](size_t group) { return group == 0 ? TriangleMesh::ImportFlags::None : TriangleMesh::ImportFlags::GenSmoothNormals; };
+
+    for (size_t group = 0; group < 2; ++group)
+    {
+        auto meshes = PlyReader::readFiles(plyPaths[group], getFlags(group));
+        for (size_t i = 0; i < meshes.size(); ++i)
+            ctx.meshes[plyIDs[group][i]] = std::move(meshes[i]);
+    }
+
+    for (const auto& [key, shapes] : serializedShapes)
+    {
+        const auto& [ids, shapeIndices] = shapes;
+        auto meshes = SerializedMeshReader::readShapes(key.first, shapeIndices, getFlags(key.second));
+        for (size_t i = 0; i < meshes.size(); ++i)
+            ctx.meshes[ids[i]] = std::move(meshes[i]);
+    }
+}
+
+/**
+ * Add an instance of a shape group.
+ * The shapes of the group are created on first use and transformed to the space of the instances, so all meshes of the
+ * group share the instance transforms, see MeshInstanceTable.
+ */
+void buildInstance(BuilderContext& ctx, const XMLObject& inst)
+{
+    FALCOR_ASSERT(inst.cls == Class::Shape && inst.type == "instance");
+
+    const XMLObject* pShapeGroup = nullptr;
+    for (const auto& [name, id] : inst.props.getNamedReferences())
+    {
+        const auto& child = ctx.instances[id];
+        if (child.cls == Class::Shape && child.type == "shapegroup")
+            pShapeGroup = &child;
+    }
+    if (!pShapeGroup)
+        FALCOR_THROW("Instance '{}' does not reference a shape group.", inst.id);
+
+    auto it = ctx.shapeGroups.find(pShapeGroup->id);
+    if (it == ctx.shapeGroups.end())
+    {
+        std::vector<MeshID> meshIDs;
+        uint64_t triangleCount = 0;
+        for (const auto& [name, id] : pShapeGroup->props.getNamedReferences())
+        {
+            const auto& child = ctx.instances[id];
+            if (child.cls != Class::Shape)
+                continue;
+            if (child.type == "shapegroup" || child.type == "instance")
+                FALCOR_THROW("Shape group '{}' cannot contain nested shape groups or instances.", pShapeGroup->id);
+
+            auto shape = buildShape(ctx, child);
+            if (!shape.pMesh || !shape.pMaterial)
+                continue;
+            if (shape.transform != float4x4::identity())
+            {
+                // Meshes decoded once for multiple shapes are shared, transform a copy.
+                if (shape.pMesh->refCount() > 1)
+                {
+                    auto pMesh = TriangleMesh::create(shape.pMesh->getVertices(), shape.pMesh->getIndices(), shape.pMesh->getFrontFaceCW());
+                    pMesh->setName(shape.pMesh->getName());
+                    shape.pMesh = pMesh;
+                }
+                shape.pMesh->applyTransform(shape.transform);
+            }
+            triangleCount += shape.pMesh->getIndices().size() / 3;
+            meshIDs.push_back(ctx.builder.addTriangleMesh(shape.pMesh, shape.pMaterial));
+        }
+        uint32_t definitionIndex = ctx.instanceTable.addDefinition(pShapeGroup->id, std::move(meshIDs), triangleCount);
+        it = ctx.shapeGroups.emplace(pShapeGroup->id, definitionIndex).first;
+    }
+
+    ctx.instanceTable.addInstance(it->second, inst.props.getTransform("to_world", float4x4::identity()));
+}
+
 void buildScene(BuilderContext& ctx, const XMLObject& inst)
 {
     FALCOR_ASSERT(inst.cls == Class::Scene);
 
     const auto& props = inst.props;
 
+    prefetchMeshes(ctx, inst);
+
     for (const auto& [name, id] : props.getNamedReferences())
     {
         const auto& child = ctx.instances[id];
@@ -771,6 +909,15 @@ void buildScene(BuilderContext& ctx, const XMLObject& inst)
 
         case Class::Shape:
         {
+            // Shape groups are only created when instanced.
+            if (child.type == "shapegroup")
+                break;
+            if (child.type == "instance")
+            {
+                buildInstance(ctx, child);
+                break;
+            }
+
             auto shape = buildShape(ctx, child);
 
             if (shape.pMesh && shape.pMaterial)
@@ -784,6 +931,8 @@ void buildScene(BuilderContext& ctx, const XMLObject& inst)
         break;
         }
     }
+
+    ctx.builder.addMeshInstances(ctx.instanceTable);
 }
 
 } // namespace Mitsuba
@@ -55,7 +55,9 @@ std::string to_string(const MaterialRef& materialRef)
     }
 }
 
-BasicScene::BasicScene(const std::filesystem::path& searchPath) : mSearchPath(searchPath) {}
+BasicScene::BasicScene(const std::filesystem::path& searchPath, uint32_t materialIndexBase)
+    : mSearchPath(searchPath), mMaterialIndexBase(materialIndexBase)
+{}
 
 void BasicScene::setOptions(
     SceneEntity filter,
@@ -82,7 +84,7 @@ void BasicScene::addNamedMaterial(std::string name, MaterialSceneEntity material
 uint32_t BasicScene::addMaterial(MaterialSceneEntity material)
 {
     mMaterials.push_back(material);
-    return (uint32_t)(mMaterials.size() - 1);
+    return getNextMaterialIndex() - 1;
 }
 
 void BasicScene::addMedium(MediumSceneEntity medium)
@@ -114,6 +116,7 @@ uint32_t BasicScene::addAreaLight(SceneEntity light)
 void BasicScene::addShapes(std::vector<ShapeSceneEntity>& shapes)
 {
     std::move(shapes.begin(), shapes.end(), std::back_inserter(mShapes));
+    shapes.clear();
 }
 
 void BasicScene::addInstanceDefinition(InstanceDefinitionSceneEntity instanceDefinition)
@@ -124,14 +127,56 @@ void BasicScene::addInstanceDefinition(InstanceDefinitionSceneEntity instanceDef
 void BasicScene::addInstances(std::vector<InstanceSceneEntity>& instances)
 {
     std::move(instances.begin(), instances.end(), std::back_inserter(mInstances));
+    instances.clear();
+}
+
+void BasicScene::merge(BasicScene&& other)
+{
+    const uint32_t materialIndexBase = other.mMaterialIndexBase;
+    const uint32_t materialOffset = getNextMaterialIndex();
+    const int areaLightOffset = (int)mAreaLights.size();
+
+    auto remapShapes = [&](std::vector<ShapeSceneEntity>& shapes)
+    {
+        for (auto& shape : shapes)
+        {
+            // Indices below the base were inherited from the importing file and already refer to our materials.
+            uint32_t* pIndex = std::get_if<uint32_t>(&shape.materialRef);
+            if (pIndex && *pIndex >= materialIndexBase)
+                *pIndex = *pIndex - materialIndexBase + materialOffset;
+            if (shape.lightIndex >= 0)
+                shape.lightIndex += areaLightOffset;
+        }
+    };
+
+    // Unnamed materials are named after their index.
+    for (auto& material : other.mMaterials)
+    {
+        material.name = fmt::format("Unnamed{}", getNextMaterialIndex());
+        mMaterials.push_back(std::move(material));
+    }
+    std::move(other.mAreaLights.begin(), other.mAreaLights.end(), std::back_inserter(mAreaLights));
+    std::move(other.mMedia.begin(), other.mMedia.end(), std::back_inserter(mMedia));
+    std::move(other.mLights.begin(), other.mLights.end(), std::back_inserter(mLights));
+    mNamedMaterials.merge(other.mNamedMaterials);
+    mFloatTextures.merge(other.mFloatTextures);
+    mSpectrumTextures.merge(other.mSpectrumTextures);
+
+    remapShapes(other.mShapes);
+    addShapes(other.mShapes);
+
+    for (auto& [name, instanceDefinition] : other.mInstanceDefinitions)
+        remapShapes(instanceDefinition.shapes);
+    mInstanceDefinitions.merge(other.mInstanceDefinitions);
+    addInstances(other.mInstances);
 }
 
 const MaterialSceneEntity& BasicScene::getMaterial(const MaterialRef& materialRef) const
 {
     if (const uint32_t* pIndex = std::get_if<uint32_t>(&materialRef))
     {
-        FALCOR_ASSERT(*pIndex >= 0 && *pIndex <= mMaterials.size());
-        return mMaterials[*pIndex];
+        FALCOR_ASSERT(*pIndex >= mMaterialIndexBase && *pIndex < getNextMaterialIndex());
+        return mMaterials[*pIndex - mMaterialIndexBase];
     }
     else if (const std::string* pName = std::get_if<std::string>(&materialRef))
     {
@@ -479,6 +524,64 @@ void BasicSceneBuilder::onEndOfFiles()
     mScene.addInstances(mInstances);
 }
 
+std::unique_ptr<ParserTarget> BasicSceneBuilder::createImportTarget(FileLoc loc)
+{
+    VERIFY_WORLD("Import");
+
+    if (mpActiveInstanceDefinition)
+    {
+        throwError(loc, "Import can't be called inside instance definition.");
+    }
+
+    // The import target collects entities in its own scene, which is merged into ours by mergeImport().
+    // Its materials are numbered after ours, so an unnamed material inherited through the graphics state keeps its index.
+    auto pScene = std::make_unique<BasicScene>(mScene.getSearchPath(), mScene.getNextMaterialIndex());
+    auto pBuilder = std::make_unique<BasicSceneBuilder>(*pScene);
+    pBuilder->mpImportScene = std::move(pScene);
+    pBuilder->mCurrentBlock = BlockState::WorldBlock;
+    pBuilder->mGraphicsState = mGraphicsState;
+    pBuilder->mNamedCoordinateSystems = mNamedCoordinateSystems;
+    return pBuilder;
+}
+
+void BasicSceneBuilder::mergeImport(std::unique_ptr<ParserTarget> pImportTarget, FileLoc loc)
+{
+    auto& imported = static_cast<BasicSceneBuilder&>(*pImportTarget);
+    FALCOR_ASSERT(imported.mpImportScene);
+
+    if (imported.mpActiveInstanceDefinition)
+    {
+        throwError(imported.mpActiveInstanceDefinition->entity.loc, "Missing ObjectEnd in imported file.");
+    }
+    if (!imported.mStack.empty())
+    {
+        throwError(imported.mStack.back().loc, "Missing end to AttributeBegin in imported file.");
+    }
+
+    auto mergeNames = [&](std::set<std::string>& names, std::set<std::string>& importedNames, const std::string_view type)
+    {
+        for (const auto& name : importedNames)
+        {
+            if (!names.insert(name).second)
+            {
+                throwError(loc, "Imported file redefines {} '{}'.", type, name);
+            }
+        }
+    };
+    mergeNames(mNamedMaterialNames, imported.mNamedMaterialNames, "named material");
+    mergeNames(mMediumNames, imported.mMediumNames, "named medium");
+    mergeNames(mFloatTextureNames, imported.mFloatTextureNames, "texture");
+    mergeNames(mSpectrumTextureNames, imported.mSpectrumTextureNames, "texture");
+    mergeNames(mInstanceNames, imported.mInstanceNames, "object instance");
+
+    // Imported shapes and instances follow the ones of the importing file.
+    mScene.addShapes(mShapes);
+    mScene.addInstances(mInstances);
+    imported.mScene.addShapes(imported.mShapes);
+    imported.mScene.addInstances(imported.mInstances);
+    mScene.merge(std::move(*imported.mpImportScene));
+}
+
 void BasicSceneBuilder::onOption(const std::string& name, const std::string& value, FileLoc loc)
 {
     // Options:
@@ -619,7 +722,7 @@ void BasicSceneBuilder::onMaterial(const std::string& name, ParsedParameterVecto
     ParameterDictionary dict(std::move(params), mGraphicsState.materialAttributes, mGraphicsState.pColorSpace);
 
     mGraphicsState.currentMaterial =
-        mScene.addMaterial(MaterialSceneEntity(fmt::format("Unnamed{}", mUnamedMaterialIndex++), name, std::move(dict), loc));
+        mScene.addMaterial(MaterialSceneEntity(fmt::format("Unnamed{}", mScene.getNextMaterialIndex()), name, std::move(dict), loc));
 }
 
 void BasicSceneBuilder::onMakeNamedMaterial(const std::string& name, ParsedParameterVector params, FileLoc loc)
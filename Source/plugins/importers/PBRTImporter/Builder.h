@@ -230,7 +230,14 @@ struct InstanceSceneEntity
 class BasicScene
 {
 public:
-    BasicScene(const std::filesystem::path& searchPath);
+    /**
+     * Constructor.
+     * @param[in] searchPath Search path for resolving relative file paths.
+     * @param[in] materialIndexBase Index of the first material added to this scene. Scenes collecting an imported file
+     * number their materials after the ones of the importing scene, so that material indices inherited through the
+     * graphics state stay valid and are not remapped by merge().
+     */
+    BasicScene(const std::filesystem::path& searchPath, uint32_t materialIndexBase = 0);
 
     void setOptions(
         SceneEntity filter,
@@ -252,10 +259,19 @@ public:
     void addInstanceDefinition(InstanceDefinitionSceneEntity instanceDefinition);
     void addInstances(std::vector<InstanceSceneEntity>& instances);
 
+    /**
+     * Move all world entities of another scene (parsed from an imported file) into this scene.
+     * Material and area light indices of the merged shapes are remapped. Material indices below the material index base
+     * of the other scene refer to materials of this scene and are kept.
+     */
+    void merge(BasicScene&& other);
+
     const CameraSceneEntity& getCamera() const { return mCamera; }
 
     const std::map<std::string, MaterialSceneEntity>& getNamedMaterials() const { return mNamedMaterials; }
     const std::vector<MaterialSceneEntity>& getMaterials() const { return mMaterials; }
+    /// Get the index the next added material will get.
+    uint32_t getNextMaterialIndex() const { return mMaterialIndexBase + (uint32_t)mMaterials.size(); }
     const std::vector<MediumSceneEntity>& getMedia() const { return mMedia; }
     const std::map<std::string, TextureSceneEntity>& getFloatTextures() const { return mFloatTextures; }
     const std::map<std::string, TextureSceneEntity>& getSpectrumTextures() const { return mSpectrumTextures; }
@@ -273,6 +289,8 @@ public:
 
     std::filesystem::path resolvePath(const std::filesystem::path& path) const;
 
+    const std::filesystem::path& getSearchPath() const { return mSearchPath; }
+
     std::string toString() const;
 
 private:
@@ -287,6 +305,7 @@ private:
 
     std::map<std::string, MaterialSceneEntity> mNamedMaterials;
     std::vector<MaterialSceneEntity> mMaterials;
+    uint32_t mMaterialIndexBase = 0; ///< Index of mMaterials[0].
     std::vector<MediumSceneEntity> mMedia;
     std::map<std::string, TextureSceneEntity> mFloatTextures;
     std::map<std::string, TextureSceneEntity> mSpectrumTextures;
@@ -387,6 +406,9 @@ public:
 
     void onEndOfFiles() override;
 
+    std::unique_ptr<ParserTarget> createImportTarget(FileLoc loc) override;
+    void mergeImport(std::unique_ptr<ParserTarget> pImportTarget, FileLoc loc) override;
+
 private:
     float4x4 getTransform() const { return mGraphicsState.ctm[0]; }
 
@@ -427,6 +449,7 @@ private:
     };
 
     BasicScene& mScene;
+    std::unique_ptr<BasicScene> mpImportScene; ///< Scene owned by targets created with createImportTarget().
 
     enum class BlockState
     {
@@ -458,7 +481,6 @@ private:
     };
     std::unique_ptr<ActiveInstanceDefinition> mpActiveInstanceDefinition;
 
-    uint32_t mUnamedMaterialIndex = 0;
     std::set<std::string> mNamedMaterialNames;
     std::set<std::string> mMediumNames;
     std::set<std::string> mFloatTextureNames;
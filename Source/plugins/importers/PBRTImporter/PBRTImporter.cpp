@@ -62,7 +62,6 @@
 #include "Parser.h"
 #include "Builder.h"
 #include "Helpers.h"
-#include "LoopSubdivide.h"
 #include "EnvMapConverter.h"
 #include "Core/Error.h"
 #include "Core/API/Device.h"
@@ -72,6 +71,9 @@
 #include "Utils/Math/FalcorMath.h"
 #include "Utils/Math/FNVHash.h"
 #include "Scene/Importer.h"
+#include "Scene/LoopSubdivide.h"
+#include "Scene/MeshInstanceTable.h"
+#include "Scene/PlyReader.h"
 #include "Scene/Material/Material.h"
 #include "Scene/Material/StandardMaterial.h"
 #include "Scene/Material/RGLMaterial.h"
@@ -203,8 +205,9 @@ struct CurveAggregate
 
 struct InstanceDefinition
 {
-    std::vector<std::pair<MeshID, float4x4>> meshes;  // List of meshID + transform
-    std::vector<std::pair<CurveID, float4x4>> curves; // List of curveID + transfrom
+    uint32_t tableIndex = 0;                              // Index of the definition holding the shapes in the instance table
+    std::vector<std::pair<MeshID, float4x4>> curveMeshes; // List of meshID + transform of tessellated curves
+    std::vector<std::pair<CurveID, float4x4>> curves;     // List of curveID + transfrom
 };
 
 struct BuilderContext
@@ -225,6 +228,9 @@ struct BuilderContext
     std::unordered_map<CurveAggregate::Key, CurveAggregate, CurveAggregate::KeyHash> curveAggregates;
 
     std::map<std::string, InstanceDefinition> instanceDefinitions;
+    Falcor::MeshInstanceTable instanceTable;
+
+    std::map<std::filesystem::path, Falcor::ref<Falcor::TriangleMesh>> plyMeshes; ///< Meshes loaded by prefetchPlyMeshes().
 
     size_t curveCount = 0;
 
@@ -1593,7 +1599,20 @@ Shape createShape(BuilderContext& ctx, const ShapeSceneEntity& entity)
         auto filename = params.getString("filename", "");
         auto path = ctx.resolver(filename);
 
-        shape.pTriangleMesh = Falcor::TriangleMesh::createFromFile(path.string());
+        if (auto it = ctx.plyMeshes.find(path); it != ctx.plyMeshes.end())
+        {
+            // Take over the prefetched mesh. Shapes referencing the same file again load their own copy below.
+            shape.pTriangleMesh = std::move(it->second);
+            ctx.plyMeshes.erase(it);
+        }
+        else if (Falcor::PlyReader::isPlyFile(path))
+        {
+            shape.pTriangleMesh = Falcor::PlyReader::read(path);
+        }
+        else
+        {
+            shape.pTriangleMesh = Falcor::TriangleMesh::createFromFile(path);
+        }
         if (shape.pTriangleMesh)
             shape.pTriangleMesh->setName(filename);
         shape.transform = entity.transform;
@@ -1754,18 +1773,47 @@ std::variant<Falcor::MeshID, Falcor::CurveID> createCurveGeometry(BuilderContext
     }
 }
 
+/**
+ * Load the PLY files referenced by 'plymesh' shapes concurrently.
+ * The meshes are stored in the context and taken over by createShape().
+ */
+void prefetchPlyMeshes(BuilderContext& ctx, fstd::span<const ShapeSceneEntity> entities)
+{
+    std::vector<std::filesystem::path> paths;
+    for (const auto& entity : entities)
+    {
+        if (entity.name != "plymesh")
+            continue;
+        auto path = ctx.resolver(entity.params.getString("filename", ""));
+        if (Falcor::PlyReader::isPlyFile(path) && ctx.plyMeshes.emplace(path, nullptr).second)
+            paths.push_back(path);
+    }
+
+    auto meshes = Falcor::PlyReader::readFiles(paths);
+    for (size_t i = 0; i < paths.size(); ++i)
+        ctx.plyMeshes[paths[i]] = std::move(meshes[i]);
+}
+
 InstanceDefinition createInstanceDefinition(BuilderContext& ctx, const InstanceDefinitionSceneEntity& entity)
 {
     InstanceDefinition instanceDefinition;
+    std::vector<MeshID> meshIDs;
+    uint64_t triangleCount = 0;
+
+    prefetchPlyMeshes(ctx, entity.shapes);
 
     for (const auto& shapeEntity : entity.shapes)
     {
         // Process shapes and create meshes.
+        // The meshes are transformed to the space of the instances, so that all meshes of the definition share the same
+        // instance transforms and are built into a single BLAS.
         auto shape = createShape(ctx, shapeEntity);
         if (shape.pTriangleMesh)
         {
-            auto meshID = ctx.builder.addTriangleMesh(shape.pTriangleMesh, shape.pMaterial);
-            instanceDefinition.meshes.emplace_back(meshID, shape.transform);
+            if (shape.transform != float4x4::identity())
+                shape.pTriangleMesh->applyTransform(shape.transform);
+            triangleCount += shape.pTriangleMesh->getIndices().size() / 3;
+            meshIDs.push_back(ctx.builder.addTriangleMesh(shape.pTriangleMesh, shape.pMaterial));
         }
 
         // Create curves from curve aggregates assembled during the processing step above.
@@ -1774,7 +1822,7 @@ InstanceDefinition createInstanceDefinition(BuilderContext& ctx, const InstanceD
             auto meshOrCurveID = createCurveGeometry(ctx, curveAggregate);
             if (auto meshID = std::get_if<Falcor::MeshID>(&meshOrCurveID))
             {
-                instanceDefinition.meshes.emplace_back(*meshID, curveAggregate.transform);
+                instanceDefinition.curveMeshes.emplace_back(*meshID, curveAggregate.transform);
             }
             else if (auto curveID = std::get_if<Falcor::CurveID>(&meshOrCurveID))
             {
@@ -1787,6 +1835,9 @@ InstanceDefinition createInstanceDefinition(BuilderContext& ctx, const InstanceD
         }
         ctx.curveAggregates.clear();
     }
+    ctx.plyMeshes.clear();
+
+    instanceDefinition.tableIndex = ctx.instanceTable.addDefinition(entity.name, std::move(meshIDs), triangleCount);
 
     return instanceDefinition;
 }
@@ -1843,15 +1894,26 @@ void buildScene(BuilderContext& ctx)
     }
 
     // Process shapes and create meshes.
-    for (const auto& entity : ctx.scene.getShapes())
+    // PLY files are loaded in parallel ahead of each batch of shapes, batching bounds the memory held by loaded meshes.
+    const size_t kShapeBatchSize = 1024;
+    const auto& shapes = ctx.scene.getShapes();
+    for (size_t batchStart = 0; batchStart < shapes.size(); batchStart += kShapeBatchSize)
     {
-        auto shape = createShape(ctx, entity);
-        if (shape.pTriangleMesh)
+        const size_t batchSize = std::min(kShapeBatchSize, shapes.size() - batchStart);
+        prefetchPlyMeshes(ctx, fstd::span<const ShapeSceneEntity>(shapes.data() + batchStart, batchSize));
+
+        for (size_t i = batchStart; i < batchStart + batchSize; ++i)
         {
-            auto nodeID = ctx.builder.addNode({entity.name, shape.transform});
-            auto meshID = ctx.builder.addTriangleMesh(shape.pTriangleMesh, shape.pMaterial);
-            ctx.builder.addMeshInstance(nodeID, meshID);
+            const auto& entity = shapes[i];
+            auto shape = createShape(ctx, entity);
+            if (shape.pTriangleMesh)
+            {
+                auto nodeID = ctx.builder.addNode({entity.name, shape.transform});
+                auto meshID = ctx.builder.addTriangleMesh(shape.pTriangleMesh, shape.pMaterial);
+                ctx.builder.addMeshInstance(nodeID, meshID);
+            }
         }
+        ctx.plyMeshes.clear();
     }
 
     // Create curves from curve aggregates assembled during the processing step above.
@@ -1874,7 +1936,7 @@ void buildScene(BuilderContext& ctx)
     }
     ctx.curveAggregates.clear();
 
-    auto getInstanceDefinition = [&ctx](const InstanceSceneEntity& entity)
+    auto getInstanceDefinition = [&ctx](const InstanceSceneEntity& entity) -> const InstanceDefinition&
     {
         auto it = ctx.instanceDefinitions.find(entity.name);
         if (it == ctx.instanceDefinitions.end())
@@ -1895,13 +1957,16 @@ void buildScene(BuilderContext& ctx)
         const auto& instanceDefinition = getInstanceDefinition(entity);
         auto instanceTransform = entity.transform;
 
-        // Instantiate meshes.
-        for (const auto& [meshID, transform] : instanceDefinition.meshes)
+        // Instantiate meshes. Shapes only store the instance transform, nodes are created by the scene builder below.
+        ctx.instanceTable.addInstance(instanceDefinition.tableIndex, instanceTransform);
+        for (const auto& [meshID, transform] : instanceDefinition.curveMeshes)
         {
             auto nodeID = ctx.builder.addNode({"instance", mul(instanceTransform, transform)});
             ctx.builder.addMeshInstance(nodeID, meshID);
         }
     }
+
+    ctx.builder.addMeshInstances(ctx.instanceTable);
 }
 
 } // namespace pbrt
@@ -193,13 +193,13 @@ struct ParameterTypeTraits<ParameterType::Normal>
 // --------------------------------------------------------------------
 
 ParameterDictionary::ParameterDictionary(ParsedParameterVector params, const RGBColorSpace* pColorSpace)
-    : mParams(params), mpColorSpace(pColorSpace)
+    : mParams(std::move(params)), mpColorSpace(pColorSpace)
 {}
 
 ParameterDictionary::ParameterDictionary(ParsedParameterVector params1, ParsedParameterVector params2, const RGBColorSpace* pColorSpace)
-    : mParams(params1), mpColorSpace(pColorSpace)
+    : mParams(std::move(params1)), mpColorSpace(pColorSpace)
 {
-    mParams.insert(mParams.end(), params2.begin(), params2.end());
+    mParams.insert(mParams.end(), std::make_move_iterator(params2.begin()), std::make_move_iterator(params2.end()));
 }
 
 FileLoc ParameterDictionary::getParameterLoc(const std::string& name) const
@@ -36,12 +36,16 @@
 #include "Core/Error.h"
 #include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
+#include "Utils/Timing/CpuTimer.h"
 
 #include <fast_float/fast_float.h>
 
 #include <atomic>
+#include <future>
+#include <thread>
 #include <utility>
 #include <charconv>
+#include <cstring>
 
 namespace Falcor::pbrt
 {
@@ -95,6 +99,10 @@ std::unique_ptr<Tokenizer> Tokenizer::createFromFile(const std::filesystem::path
     }
     else
     {
+        // Tokens point directly into the mapped file. Empty files cannot be mapped and are read instead.
+        auto pFile = std::make_unique<MemoryMappedFile>(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+        if (pFile->isOpen())
+            return std::make_unique<Tokenizer>(std::move(pFile), path);
         std::string str = readFile(path);
         return std::make_unique<Tokenizer>(std::move(str), path);
     }
@@ -107,13 +115,27 @@ std::unique_ptr<Tokenizer> Tokenizer::createFromString(std::string str)
 
 Tokenizer::Tokenizer(std::string str, const std::filesystem::path& path) : mPath(path), mContents(std::move(str))
 {
-    auto pFilename = std::make_unique<std::string>(path.string());
+    init(mContents.data(), mContents.size());
+}
+
+Tokenizer::Tokenizer(std::unique_ptr<MemoryMappedFile> pFile, const std::filesystem::path& path) : mPath(path), mpFile(std::move(pFile))
+{
+    init(static_cast<const char*>(mpFile->getData()), mpFile->getSize());
+}
+
+void Tokenizer::init(const char* pData, size_t size)
+{
+    auto pFilename = std::make_unique<std::string>(mPath.string());
     mLoc = FileLoc(*pFilename);
-    getFilenames().push_back(std::move(pFilename));
+    {
+        std::lock_guard<std::mutex> lock(getFilenamesMutex());
+        getFilenames().push_back(std::move(pFilename));
+    }
 
-    mPos = mContents.data();
-    mEnd = mPos + mContents.size();
-    if (isUTF16(mContents.data(), mContents.size()))
+    mBegin = pData;
+    mPos = pData;
+    mEnd = pData + size;
+    if (isUTF16(pData, size))
         throwError("File is encoded with UTF-16, which is not currently supported.");
 }
 
@@ -276,11 +298,110 @@ static std::string_view dequoteString(const Token& t)
     return str;
 }
 
+static void parseNumber(const Token& t, Float& value)
+{
+    value = parseFloat(t);
+}
+
+static void parseNumber(const Token& t, int& value)
+{
+    value = parseInt(t);
+}
+
+template<typename T>
+bool Tokenizer::readNumberArray(std::vector<T>& values)
+{
+    auto isSpace = [](char ch) { return ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r'; };
+
+    // Lists of strings or Booleans (and lists with comments) are left to the regular token path.
+    const char* pClose = static_cast<const char*>(std::memchr(mPos, ']', size_t(mEnd - mPos)));
+    if (!pClose || std::memchr(mPos, '"', size_t(pClose - mPos)) || std::memchr(mPos, '#', size_t(pClose - mPos)))
+        return false;
+    const char* pFirst = mPos;
+    while (isSpace(*pFirst))
+        ++pFirst;
+    if (pFirst != pClose && !((*pFirst >= '0' && *pFirst <= '9') || *pFirst == '-' || *pFirst == '+' || *pFirst == '.'))
+        return false;
+
+    const char* pos = mPos;
+    while (true)
+    {
+        // Skip whitespace, keeping track of the location for error messages.
+        for (; isSpace(*pos); ++pos)
+        {
+            if (*pos == '\n')
+            {
+                ++mLoc.line;
+                mLoc.column = 0;
+            }
+            else
+            {
+                ++mLoc.column;
+            }
+        }
+        if (pos == pClose)
+            break;
+
+        const char* valueStart = *pos == '+' ? pos + 1 : pos;
+        T value;
+        const char* valueEnd;
+        bool valid;
+        if constexpr (std::is_same_v<T, int>)
+        {
+            int64_t value64;
+            auto result = std::from_chars(valueStart, pClose, value64);
+            valueEnd = result.ptr;
+            valid = result.ec == std::errc() && value64 >= std::numeric_limits<int32_t>::lowest() &&
+                    value64 <= std::numeric_limits<int32_t>::max();
+            value = (int)value64;
+        }
+        else
+        {
+            auto result = fast_float::from_chars(valueStart, pClose, value);
+            valueEnd = result.ptr;
+            valid = result.ec == std::errc();
+        }
+
+        if (!valid || !(isSpace(*valueEnd) || valueEnd == pClose))
+        {
+            // Let the regular conversion report the error. Token locations point past the first character.
+            valueEnd = pos;
+            while (valueEnd < pClose && !isSpace(*valueEnd))
+                ++valueEnd;
+            FileLoc loc = mLoc;
+            ++loc.column;
+            Token t({pos, size_t(valueEnd - pos)}, loc);
+            if (t.token == "true" || t.token == "false")
+                throwError(t.loc, "'{}': Expected {} value", t.token, std::is_same_v<T, int> ? "integer" : "floating-point");
+            parseNumber(t, value);
+        }
+
+        values.push_back(value);
+        mLoc.column += uint32_t(valueEnd - pos);
+        pos = valueEnd;
+    }
+
+    // Consume the closing ']'.
+    mPos = pClose + 1;
+    ++mLoc.column;
+    return true;
+}
+
+bool Tokenizer::readFloatArray(std::vector<Float>& values)
+{
+    return readNumberArray(values);
+}
+
+bool Tokenizer::readIntArray(std::vector<int>& values)
+{
+    return readNumberArray(values);
+}
+
 constexpr uint32_t TokenOptional = 0;
 constexpr uint32_t TokenRequired = 1;
 
-template<typename Next, typename Unget>
-static ParsedParameterVector parseParameters(Next nextToken, Unget ungetToken)
+template<typename Next, typename Unget, typename ReadNumberArray>
+static ParsedParameterVector parseParameters(Next nextToken, Unget ungetToken, ReadNumberArray readNumberArray)
 {
     ParsedParameterVector parameterVector;
 
@@ -429,12 +550,16 @@ static ParsedParameterVector parseParameters(Next nextToken, Unget ungetToken)
 
         if (val.token == "[")
         {
-            while (true)
+            // Lists of numbers are read directly from the file contents, all other lists token by token.
+            if (!readNumberArray(param))
             {
-                val = *nextToken(TokenRequired);
-                if (val.token == "]")
-                    break;
-                addVal(val);
+                while (true)
+                {
+                    val = *nextToken(TokenRequired);
+                    if (val.token == "]")
+                        break;
+                    addVal(val);
+                }
             }
         }
         else
@@ -442,61 +567,104 @@ static ParsedParameterVector parseParameters(Next nextToken, Unget ungetToken)
             addVal(val);
         }
 
-        parameterVector.push_back(param);
+        parameterVector.push_back(std::move(param));
     }
 
     return parameterVector;
 }
 
+/**
+ * Run the parsing of an imported file.
+ * Imports get their own thread as long as there are fewer import threads than cores, otherwise they are parsed on the
+ * calling thread. Errors are reported through the returned future in both cases.
+ */
+static std::future<void> runImport(std::function<void()> func)
+{
+    static std::atomic<uint32_t> importThreadCount{0};
+    static const uint32_t maxImportThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    if (importThreadCount.fetch_add(1) < maxImportThreads)
+    {
+        return std::async(
+            std::launch::async,
+            [func = std::move(func)]()
+            {
+                struct Guard
+                {
+                    ~Guard() { importThreadCount.fetch_sub(1); }
+                } guard;
+                func();
+            }
+        );
+    }
+    importThreadCount.fetch_sub(1);
+
+    std::promise<void> promise;
+    try
+    {
+        func();
+        promise.set_value();
+    }
+    catch (...)
+    {
+        promise.set_exception(std::current_exception());
+    }
+    return promise.get_future();
+}
+
 void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
 {
     static std::atomic<bool> warnedTransformBeginEndDeprecated{false};
 
     logInfo("PBRTImporter: Started parsing '{}'.", tokenizer->getPath().string());
 
-    auto searchPath = tokenizer->getPath().parent_path();
+    const auto startTime = CpuTimer::getCurrentTimePoint();
+    const auto path = tokenizer->getPath();
+    auto searchPath = path.parent_path();
+    size_t parsedBytes = tokenizer->getSize();
 
     std::vector<std::unique_ptr<Tokenizer>> fileStack;
     fileStack.push_back(std::move(tokenizer));
 
     std::optional<Token> ungetToken;
 
+    struct Import
+    {
+        std::unique_ptr<ParserTarget> pTarget;
+        std::future<void> result;
+        FileLoc loc;
+    };
+    std::vector<Import> imports;
+
     /**
      * Helper function that handles the file stack, returning the next token from
      * the file until reaching EOF, at which point it switches to the next file (if any).
      */
-    std::function<std::optional<Token>(uint32_t flags)> nextToken;
-    nextToken = [&](uint32_t flags) -> std::optional<Token>
+    auto nextToken = [&](uint32_t flags) -> std::optional<Token>
     {
         if (ungetToken.has_value())
             return std::exchange(ungetToken, {});
 
-        if (fileStack.empty())
+        while (!fileStack.empty())
         {
-            if ((flags & TokenRequired) != 0)
-                throwError("Premature end of file.");
-            return {};
-        }
+            std::optional<Token> tok = fileStack.back()->next();
 
-        std::optional<Token> tok = fileStack.back()->next();
-
-        if (!tok)
-        {
-            // We've reached EOF in the current file. Anything more to parse?
-            logInfo("PBRTImporter: Finished parsing '{}'.", fileStack.back()->getPath().string());
-            fileStack.pop_back();
-            return nextToken(flags);
-        }
-        else if (tok->token[0] == '#')
-        {
-            // Swallow comments.
-            return nextToken(flags);
-        }
-        else
-        {
-            // Regular token.
-            return tok;
+            if (!tok)
+            {
+                // We've reached EOF in the current file. Anything more to parse?
+                logInfo("PBRTImporter: Finished parsing '{}'.", fileStack.back()->getPath().string());
+                fileStack.pop_back();
+            }
+            else if (tok->token[0] != '#')
+            {
+                // Regular token, comments are swallowed.
+                return tok;
+            }
         }
+
+        if ((flags & TokenRequired) != 0)
+            throwError("Premature end of file.");
+        return {};
     };
 
     auto unget = [&](Token t)
@@ -505,6 +673,15 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
         ungetToken = t;
     };
 
+    auto readNumberArray = [&](ParsedParameter& param)
+    {
+        if (ungetToken.has_value() || fileStack.empty())
+            return false;
+        if (param.type == "integer")
+            return fileStack.back()->readIntArray(param.ints);
+        return fileStack.back()->readFloatArray(param.floats);
+    };
+
     /**
      * Helper function for pbrt API entrypoints that take a single string
      * parameter and a ParameterVector (e.g. onShape()).
@@ -514,7 +691,7 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
         Token t = *nextToken(TokenRequired);
         std::string_view dequoted = dequoteString(t);
         std::string n = toString(dequoted);
-        ParsedParameterVector parameterVector = parseParameters(nextToken, unget);
+        ParsedParameterVector parameterVector = parseParameters(nextToken, unget, readNumberArray);
         (target.*apiFunc)(n, std::move(parameterVector), loc);
     };
 
@@ -635,11 +812,17 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
                 auto path = searchPath / filename;
                 std::unique_ptr<Tokenizer> includeTokenizer = Tokenizer::createFromFile(path);
                 logInfo("PBRTImporter: Started parsing '{}'.", includeTokenizer->getPath().string());
+                parsedBytes += includeTokenizer->getSize();
                 fileStack.push_back(std::move(includeTokenizer));
             }
             else if (tok->token == "Import")
             {
-                throwError(tok->loc, "'Import' directive not supported yet.");
+                Token filenameToken = *nextToken(TokenRequired);
+                std::string filename = toString(dequoteString(filenameToken));
+                auto path = searchPath / filename;
+                auto pImportTarget = target.createImportTarget(tok->loc);
+                auto result = runImport([pTarget = pImportTarget.get(), path]() { parse(*pTarget, Tokenizer::createFromFile(path)); });
+                imports.push_back({std::move(pImportTarget), std::move(result), tok->loc});
             }
             else if (tok->token == "Identity")
             {
@@ -850,7 +1033,7 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
                 Token t = *nextToken(TokenRequired);
                 std::string_view dequoted = dequoteString(t);
                 std::string texName = toString(dequoted);
-                ParsedParameterVector params = parseParameters(nextToken, unget);
+                ParsedParameterVector params = parseParameters(nextToken, unget, readNumberArray);
                 target.onTexture(name, type, texName, std::move(params), tok->loc);
             }
             else
@@ -874,6 +1057,23 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
             syntaxError(*tok);
         }
     }
+
+    // Parser throughput, not including the imported files.
+    const double seconds = CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint()) * 1e-3;
+    logInfo(
+        "PBRTImporter: Parsed '{}' ({:.1f} MB in {:.2f} s, {:.1f} MB/s).",
+        path.string(),
+        parsedBytes * 1e-6,
+        seconds,
+        seconds > 0.0 ? parsedBytes * 1e-6 / seconds : 0.0
+    );
+
+    // Merge imports in a deterministic order, independent of which file finished parsing first.
+    for (auto& import : imports)
+    {
+        import.result.get();
+        target.mergeImport(std::move(import.pTarget), import.loc);
+    }
 }
 
 void parseFile(ParserTarget& target, const std::filesystem::path& path)
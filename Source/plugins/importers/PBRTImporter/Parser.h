@@ -35,9 +35,11 @@
 
 #include "Types.h"
 #include "Parameters.h"
+#include "Core/Platform/MemoryMappedFile.h"
 #include <functional>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 
@@ -99,6 +101,19 @@ public:
     virtual void onObjectInstance(const std::string& name, FileLoc loc) = 0;
 
     virtual void onEndOfFiles() = 0;
+
+    /**
+     * Create a target for a file referenced by an 'Import' directive.
+     * Imported files are parsed concurrently, each into its own target that starts with the current graphics state.
+     * Graphics state changes in an imported file are not visible outside of it.
+     */
+    virtual std::unique_ptr<ParserTarget> createImportTarget(FileLoc loc) = 0;
+
+    /**
+     * Merge a target created by createImportTarget() after its file has been parsed.
+     * Imports are merged in the order of their 'Import' directives once the importing file has been parsed.
+     */
+    virtual void mergeImport(std::unique_ptr<ParserTarget> pImportTarget, FileLoc loc) = 0;
 };
 
 void parseFile(ParserTarget& target, const std::filesystem::path& path);
@@ -117,6 +132,7 @@ class Tokenizer
 {
 public:
     Tokenizer(std::string str, const std::filesystem::path& path);
+    Tokenizer(std::unique_ptr<MemoryMappedFile> pFile, const std::filesystem::path& path);
 
     static std::unique_ptr<Tokenizer> createFromFile(const std::filesystem::path& path);
     static std::unique_ptr<Tokenizer> createFromString(std::string str);
@@ -127,8 +143,21 @@ public:
      */
     std::optional<Token> next();
 
+    /**
+     * Read a list of numbers directly from the contents, after next() returned the opening '['.
+     * The values are converted in place with fast_float/from_chars, without going through a token per value.
+     * If the list does not contain numbers (e.g. strings), nothing is consumed and false is returned.
+     * @param[out] values Array to store the values in.
+     * @return True if the list including the closing ']' has been consumed.
+     */
+    bool readFloatArray(std::vector<Float>& values);
+    bool readIntArray(std::vector<int>& values);
+
     const std::filesystem::path& getPath() const { return mPath; }
 
+    /// Get the size of the contents in bytes.
+    size_t getSize() const { return size_t(mEnd - mBegin); }
+
 private:
     /**
      * Static list of filenames to allow file locations (FileLoc::filename) to be valid
@@ -140,6 +169,18 @@ private:
         return filenames;
     }
 
+    /// Mutex for getFilenames(), tokenizers of imported files are created concurrently.
+    static std::mutex& getFilenamesMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    void init(const char* pData, size_t size);
+
+    template<typename T>
+    bool readNumberArray(std::vector<T>& values);
+
     bool isUTF16(const void* ptr, size_t len) const;
 
     int getChar()
@@ -170,12 +211,14 @@ private:
         }
     }
 
-    std::filesystem::path mPath; ///< File path we're reading from.
-    FileLoc mLoc;                ///< File location.
-    std::string mContents;       ///< File contents we're parsing.
+    std::filesystem::path mPath;              ///< File path we're reading from.
+    FileLoc mLoc;                             ///< File location.
+    std::string mContents;                    ///< File contents we're parsing (if not memory mapped).
+    std::unique_ptr<MemoryMappedFile> mpFile; ///< Memory mapped file we're parsing.
 
-    const char* mPos; ///< Current position in the file.
-    const char* mEnd; ///< End of the file (one past).
+    const char* mBegin; ///< Start of the file.
+    const char* mPos;   ///< Current position in the file.
+    const char* mEnd;   ///< End of the file (one past).
 
     std::string mEscaped; ///< Temporary storage for escaped tokens.
 };
@@ -0,0 +1,86 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SceneDescImporter.h"
+#include "Scene/Importer.h"
+#include "Scene/SceneDescFile.h"
+
+namespace Falcor
+{
+
+std::unique_ptr<Importer> SceneDescImporter::create()
+{
+    return std::make_unique<SceneDescImporter>();
+}
+
+void SceneDescImporter::importScene(
+    const std::filesystem::path& path,
+    SceneBuilder& builder,
+    const std::map<std::string, std::string>& materialToShortName
+)
+{
+    if (!path.is_absolute())
+        throw ImporterError(path, "Expected absolute path.");
+
+    try
+    {
+        SceneDescFile::read(path, builder);
+    }
+    catch (const std::exception& e)
+    {
+        throw ImporterError(path, "Failed to read scene description: {}", e.what());
+    }
+}
+
+void SceneDescImporter::importSceneFromMemory(
+    const void* buffer,
+    size_t byteSize,
+    std::string_view extension,
+    SceneBuilder& builder,
+    const std::map<std::string, std::string>& materialToShortName
+)
+{
+    FALCOR_CHECK(extension == SceneDescFile::kExtension, "Unexpected format.");
+    FALCOR_CHECK(buffer != nullptr, "Missing buffer.");
+    FALCOR_CHECK(byteSize > 0, "Empty buffer.");
+
+    try
+    {
+        SceneDescFile::readFromMemory(buffer, byteSize, builder);
+    }
+    catch (const std::exception& e)
+    {
+        throw ImporterError("", "Failed to read scene description: {}", e.what());
+    }
+}
+
+extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
+{
+    registry.registerClass<Importer, SceneDescImporter>();
+}
+
+} // namespace Falcor
@@ -41,6 +41,8 @@
 
 #include <tbb/parallel_for.h>
 
+#include <unordered_set>
+
 BEGIN_DISABLE_USD_WARNINGS
 #include <pxr/usd/usd/primRange.h>
 #include <pxr/usd/usd/stage.h>
@@ -938,7 +940,7 @@ namespace Falcor
 
                 auto& indices = mesh.attributeIndices[i];
 
-                if (!(mesh.processedMeshes[i].staticData.size() == indices.size()))
+                if (!(mesh.vertexCounts[i] == indices.size()))
                 {
                     throw ImporterError(ctx.stagePath, "Keyframe {} for mesh '{}' does not match vertex count of original mesh.", sampleIdx, mesh.prim.GetName().GetString());
                 }
@@ -1083,6 +1085,51 @@ namespace Falcor
             }
         }
 
+        void convertMaterials(ImporterContext& ctx, TimeReport& timeReport)
+        {
+            // Gather the materials bound to the meshes, their geom subsets and the curves.
+            std::vector<std::vector<UsdShadeMaterial>> boundMaterials(ctx.meshes.size() + ctx.curves.size());
+            tbb::parallel_for<size_t>(0, boundMaterials.size(),
+                [&](size_t i)
+                {
+                    if (i < ctx.meshes.size())
+                    {
+                        if (!ctx.meshes[i].prim.IsA<UsdGeomMesh>()) return;
+                        UsdGeomMesh usdMesh(ctx.meshes[i].prim);
+                        boundMaterials[i].push_back(ctx.getBoundMaterial(usdMesh));
+                        for (const auto& subset : UsdGeomSubset::GetAllGeomSubsets(usdMesh))
+                        {
+                            boundMaterials[i].push_back(ctx.getBoundMaterial(subset));
+                        }
+                    }
+                    else
+                    {
+                        boundMaterials[i].push_back(ctx.getBoundMaterial(UsdGeomBasisCurves(ctx.curves[i - ctx.meshes.size()].curvePrim)));
+                    }
+                }
+            );
+
+            // Convert each distinct material once, in parallel. Converted materials are cached by the converter, both by shader and
+            // by the parameters of the shader network, so the meshes processed next only look up the converted materials.
+            std::vector<UsdShadeMaterial> materials;
+            std::unordered_set<UsdPrim, UsdObjHash> materialPrims;
+            for (const auto& list : boundMaterials)
+            {
+                for (const auto& material : list)
+                {
+                    if (material && materialPrims.insert(material.GetPrim()).second) materials.push_back(material);
+                }
+            }
+
+            RenderContext* pRenderContext = ctx.builder.getDevice()->getRenderContext();
+            tbb::parallel_for<size_t>(0, materials.size(),
+                [&](size_t i) { ctx.mpPreviewSurfaceConverter->convert(materials[i], pRenderContext); }
+            );
+
+            logInfo("USDImporter: Converted {} materials.", materials.size());
+            timeReport.measure("Convert materials");
+        }
+
         void addMeshesToSceneBuilder(ImporterContext& ctx, TimeReport& timeReport)
         {
             // Process collected mesh tasks.
@@ -1094,16 +1141,44 @@ namespace Falcor
                 }
             );
 
-            // Add processed meshes to scene builder.
-            // This is done sequentially after being processed in parallel to ensure a deterministic ordering.
-            for (auto& mesh : ctx.meshes)
+            timeReport.measure("Process meshes");
+
+            // Add processed meshes to scene builder in mesh order to ensure a deterministic ordering.
+            // The offset of each mesh's processed meshes is computed by a prefix sum, so that the processed meshes can be
+            // moved into a single list in parallel and added to the scene builder at once without copying their data.
+            std::vector<size_t> offsets(ctx.meshes.size() + 1, 0);
+            for (size_t i = 0; i < ctx.meshes.size(); ++i)
             {
-                FALCOR_ASSERT(mesh.meshIDs.empty());
-                for (auto& m : mesh.processedMeshes)
+                offsets[i + 1] = offsets[i] + ctx.meshes[i].processedMeshes.size();
+            }
+
+            std::vector<SceneBuilder::ProcessedMesh> processedMeshes(offsets.back());
+            tbb::parallel_for<size_t>(0, ctx.meshes.size(),
+                [&](size_t i)
                 {
-                    mesh.meshIDs.push_back(ctx.builder.addProcessedMesh(m));
+                    auto& mesh = ctx.meshes[i];
+                    FALCOR_ASSERT(mesh.meshIDs.empty());
+                    for (size_t j = 0; j < mesh.processedMeshes.size(); ++j)
+                    {
+                        mesh.vertexCounts.push_back(mesh.processedMeshes[j].staticData.size());
+                        processedMeshes[offsets[i] + j] = std::move(mesh.processedMeshes[j]);
+                    }
                 }
-            }
+            );
+
+            const MeshID firstMeshID = ctx.builder.addProcessedMeshes(std::move(processedMeshes));
+            tbb::parallel_for<size_t>(0, ctx.meshes.size(),
+                [&](size_t i)
+                {
+                    auto& mesh = ctx.meshes[i];
+                    for (size_t j = 0; j < mesh.processedMeshes.size(); ++j)
+                    {
+                        mesh.meshIDs.push_back(MeshID{ firstMeshID.get() + offsets[i] + j });
+                    }
+                }
+            );
+
+            timeReport.measure("Add meshes");
 
             if (ctx.builder.getSettings().getOption("usdImporter:loadMeshVertexAnimations", kLoadMeshVertexAnimations))
             {
@@ -1131,9 +1206,9 @@ namespace Falcor
 
                 for (auto& m : ctx.meshes)
                     ctx.builder.addCachedMeshes(std::move(m.cachedMeshes));
-            }
 
-            timeReport.measure("Process meshes");
+                timeReport.measure("Process mesh keyframes");
+            }
         }
 
         void addInstancesToSceneBuilder(ImporterContext& ctx, TimeReport& timeReport)
@@ -1267,18 +1342,39 @@ namespace Falcor
                 [&](size_t i) { processCurve(ctx.curves[i], ctx); }
             );
 
-            // Add processed curves or meshes (of the first keyframe) to scene builder.
-            // This is done sequentially after being processed in parallel to ensure a deterministic ordering.
-            for (auto& curve : ctx.curves)
+            timeReport.measure("Process curves");
+
+            // Add processed curves or meshes (of the first keyframe) to scene builder in curve order to ensure a deterministic ordering.
+            // Curves tessellated into meshes are added at once, with mesh IDs computed by a prefix sum over the tessellation modes.
+            std::vector<size_t> meshOffsets(ctx.curves.size(), 0);
+            std::vector<SceneBuilder::ProcessedMesh> processedMeshes;
+            for (size_t i = 0; i < ctx.curves.size(); ++i)
             {
+                auto& curve = ctx.curves[i];
                 if (curve.tessellationMode == CurveTessellationMode::LinearSweptSphere)
                 {
+                    // The first keyframe is still needed below to create the vertex cache of animated curves.
                     FALCOR_ASSERT(!curve.processedCurves.empty());
-                    curve.geometryID = CurveOrMeshID{ ctx.builder.addProcessedCurve(curve.processedCurves[0]) };
+                    auto& processedCurve = curve.processedCurves[0];
+                    curve.geometryID = CurveOrMeshID{ curve.timeSamples.size() > 1 ? ctx.builder.addProcessedCurve(processedCurve)
+                                                                                    : ctx.builder.addProcessedCurve(std::move(processedCurve)) };
                 }
                 else
                 {
-                    curve.geometryID = CurveOrMeshID{ ctx.builder.addProcessedMesh(curve.processedMesh) };
+                    meshOffsets[i] = processedMeshes.size();
+                    processedMeshes.push_back(std::move(curve.processedMesh));
+                }
+            }
+
+            if (!processedMeshes.empty())
+            {
+                const MeshID firstMeshID = ctx.builder.addProcessedMeshes(std::move(processedMeshes));
+                for (size_t i = 0; i < ctx.curves.size(); ++i)
+                {
+                    if (ctx.curves[i].tessellationMode != CurveTessellationMode::LinearSweptSphere)
+                    {
+                        ctx.curves[i].geometryID = CurveOrMeshID{ firstMeshID.get() + meshOffsets[i] };
+                    }
                 }
             }
 
@@ -1286,7 +1382,7 @@ namespace Falcor
             for (auto& curve : ctx.curves) ctx.addCachedCurve(curve);
             ctx.builder.addCachedCurves(std::move(ctx.cachedCurves));
 
-            timeReport.measure("Process curves");
+            timeReport.measure("Add curves");
 
             // Add instances to scene builder.
             for (const auto& instance : ctx.curveInstances)
@@ -1896,23 +1992,37 @@ namespace Falcor
 
 
     void ImporterContext::addMesh(const UsdPrim& prim)
+    {
+        if (geomMap.find(prim) == geomMap.end())
+        {
+            addMesh(prim, getMeshTimeSamples(prim));
+        }
+    }
+
+    std::vector<double> ImporterContext::getMeshTimeSamples(const UsdPrim& prim) const
+    {
+        // Get time samples from the points attribute
+        std::vector<double> timeSamples;
+        UsdGeomPointBased geomPointBased(prim);
+        geomPointBased.GetPointsAttr().GetTimeSamples(&timeSamples);
+
+        if (!builder.getSettings().getAttribute(prim.GetPath().GetString(), "usdImporter:enableMotion", true))
+            timeSamples.clear();
+
+        return timeSamples;
+    }
+
+    void ImporterContext::addMesh(const UsdPrim& prim, std::vector<double> timeSamples)
     {
         // It's possible that the same mesh gprim may be appear both as a regular Mesh and as part of a prototype.
         // Make sure to only add it once to meshes and meshMap.
         if (geomMap.find(prim) == geomMap.end())
         {
-            Mesh mesh{ prim };
+            Mesh mesh{ prim, std::move(timeSamples) };
 
             // Mesh will be added at the next index
             size_t index = meshes.size();
 
-            // Get time samples from the points attribute
-            UsdGeomPointBased geomPointBased(prim);
-            geomPointBased.GetPointsAttr().GetTimeSamples(&mesh.timeSamples);
-
-            if (!builder.getSettings().getAttribute(prim.GetPath().GetString(), "usdImporter:enableMotion", true))
-                mesh.timeSamples.clear();
-
             if (mesh.timeSamples.size() == 0)
             {
                 mesh.timeSamples.push_back(0.0);
@@ -2379,9 +2489,14 @@ namespace Falcor
     }
 
     void ImporterContext::pushNode(const UsdGeomXformable& prim)
+    {
+        pushNode(prim, getLocalXform(prim));
+    }
+
+    void ImporterContext::pushNode(const UsdGeomXformable& prim, const LocalXform& localXform)
     {
         NodeID nodeID;
-        if (prim.TransformMightBeTimeVarying())
+        if (localXform.isTimeVarying)
         {
             nodeID = createAnimation(prim);
         }
@@ -2389,17 +2504,26 @@ namespace Falcor
         {
             // The node stack should at least contain the root node.
             FALCOR_ASSERT(nodeStack.size() > 0);
-            float4x4 localTransform;
-            bool resets = getLocalTransform(prim, localTransform);
             SceneBuilder::Node node;
             node.name = prim.GetPath().GetString();
-            node.transform = localTransform;
-            node.parent = resets ? getRootNodeID() : nodeStack.back();
+            node.transform = localXform.transform;
+            node.parent = localXform.resetsXformStack ? getRootNodeID() : nodeStack.back();
             nodeID = builder.addNode(node);
         }
         nodeStack.push_back(nodeID);
     }
 
+    LocalXform ImporterContext::getLocalXform(const UsdGeomXformable& prim)
+    {
+        LocalXform localXform;
+        localXform.isTimeVarying = prim.TransformMightBeTimeVarying();
+        if (!localXform.isTimeVarying)
+        {
+            localXform.resetsXformStack = getLocalTransform(prim, localXform.transform);
+        }
+        return localXform;
+    }
+
     float4x4 ImporterContext::getGeomBindTransform(const UsdPrim& usdPrim) const
     {
         GfMatrix4d bindXform(1.0);
@@ -2460,6 +2584,7 @@ namespace Falcor
     void ImporterContext::finalize()
     {
         addSkeletonsToSceneBuilder(*this, timeReport);
+        convertMaterials(*this, timeReport);
         addMeshesToSceneBuilder(*this, timeReport);
         addCurvesToSceneBuilder(*this, timeReport);
         addInstancesToSceneBuilder(*this, timeReport);
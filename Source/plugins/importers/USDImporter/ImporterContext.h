@@ -87,6 +87,16 @@ namespace Falcor
         std::vector<Animation::Keyframe> keyframes;     ///< Keyframes for animated instance transformation, if any.
     };
 
+    /** Local transform of an xformable prim.
+        Queried ahead of adding the prim to the scene graph, so that prims can be inspected on worker threads.
+    */
+    struct LocalXform
+    {
+        bool isTimeVarying = false;                     ///< True if the transform might be time-varying. An animation is created instead.
+        bool resetsXformStack = false;                  ///< True if the prim does not inherit the transform of its parent.
+        float4x4 transform = float4x4::identity();      ///< Local transform at the earliest time code.
+    };
+
     /** Mesh processing task parameters
     */
     struct MeshProcessingTask
@@ -113,6 +123,7 @@ namespace Falcor
         ProcessedMeshList processedMeshes;          ///< Temporary list of pre-processed meshes
         std::vector<CachedMesh> cachedMeshes;       ///< Keyframe data for vertex-animated meshes per processed mesh
         std::vector<MeshID> meshIDs;                ///< List of scene builder mesh IDs.
+        std::vector<size_t> vertexCounts;           ///< Vertex count per processed mesh, kept after the processed data is moved to the scene builder.
         MeshAttributeIndicesList attributeIndices;  ///< For time-sampled meshes, list of attribute indices describing how mesh was processed
     };
 
@@ -255,6 +266,8 @@ namespace Falcor
 
         // Meshes
         void addMesh(const UsdPrim& prim);
+        void addMesh(const UsdPrim& prim, std::vector<double> timeSamples);
+        std::vector<double> getMeshTimeSamples(const UsdPrim& prim) const;
         const Mesh& getMesh(const UsdPrim& meshPrim) { return meshes[geomMap.at(meshPrim)]; }
         void addGeomInstance(const std::string& name, const UsdPrim& prim, const float4x4& xform, const float4x4& bindxform);
 
@@ -312,6 +325,8 @@ namespace Falcor
         float4x4 getLocalToWorldXform(const UsdGeomXformable& prim, UsdTimeCode time = UsdTimeCode::EarliestTime());
         size_t getNodeStackDepth() const { return nodeStack.size(); }
         void pushNode(const UsdGeomXformable& prim);
+        void pushNode(const UsdGeomXformable& prim, const LocalXform& localXform);
+        static LocalXform getLocalXform(const UsdGeomXformable& prim);
         void popNode() { nodeStack.pop_back(); }
         NodeID getRootNodeID() const { return nodeStack[nodeStackStartDepth.back()]; }
         float4x4 getGeomBindTransform(const UsdPrim& usdPrim) const;
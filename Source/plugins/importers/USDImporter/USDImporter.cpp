@@ -37,6 +37,9 @@
 
 #include <pybind11/pybind11.h>
 
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 BEGIN_DISABLE_USD_WARNINGS
 #include <pxr/usd/usd/primRange.h>
 #include <pxr/usd/ar/resolver.h>
@@ -57,6 +60,63 @@ END_DISABLE_USD_WARNINGS
 
 namespace Falcor
 {
+    namespace
+    {
+        // Minimum number of traversal segments per worker thread. Subtrees differ a lot in size, so there should be more segments than workers.
+        const size_t kTraversalSegmentsPerThread = 4;
+        // Maximum depth below the stage root at which grouping prims are split into separate traversal segments.
+        const uint32_t kMaxTraversalSplitDepth = 8;
+
+        /** Type of a prim, determining how it is added to the importer context.
+        */
+        enum class PrimType
+        {
+            Other,
+            Instance,
+            PointInstancer,
+            Mesh,
+            Curve,
+            SkelRoot,
+            DistantLight,
+            RectLight,
+            SphereLight,
+            DiskLight,
+            DomeLight,
+            Camera,
+        };
+
+        /** Pre- or post-visit of a prim during stage traversal.
+            Holds everything about the prim that can be queried on a worker thread without modifying the importer context.
+        */
+        struct PrimVisit
+        {
+            UsdPrim prim;
+            PrimType type = PrimType::Other;
+            bool isPostVisit = false;
+            bool isXformable = false;
+            LocalXform localXform;                      ///< Local transform, for pre-visits of xformable prims.
+            std::vector<double> timeSamples;            ///< Time samples, for meshes.
+            float4x4 bindXform = float4x4::identity();  ///< Geometry bind transform, for meshes.
+        };
+
+        /** Part of the stage traversal that is gathered by a single task.
+            This is either the subtree rooted at a prim, or the pre- or post-visit of a prim whose children are split into separate segments.
+        */
+        struct TraversalSegment
+        {
+            enum class Kind
+            {
+                Subtree,
+                PreVisit,
+                PostVisit,
+            };
+
+            UsdPrim prim;
+            Kind kind = Kind::Subtree;
+            std::vector<PrimVisit> visits;  ///< Visits in traversal order.
+        };
+    }
+
     bool checkPrim(const UsdPrim& prim, const Settings& settings)
     {
         std::string primName = prim.GetPath().GetString();
@@ -66,8 +126,7 @@ namespace Falcor
         return true;
     }
 
-    // Traverse scene graph, converting supported prims from USD to Falcor equivalents
-    void traversePrims(const UsdPrim& rootPrim, ImporterContext& ctx)
+    Usd_PrimFlagsPredicate getTraversalPredicate(const ImporterContext& ctx)
     {
         Usd_PrimFlagsPredicate pred = UsdPrimDefaultPredicate;
         if (ctx.useInstanceProxies)
@@ -75,158 +134,327 @@ namespace Falcor
             // Treat instances as if they were unique prims (primarily for debugging)
             pred.TraverseInstanceProxies(true);
         }
+        return pred;
+    }
+
+    // Apply variant selections specified in the scene settings.
+    // This modifies the stage, so it is done in a separate pass before prims are inspected in parallel.
+    void applyVariantOverrides(const UsdPrim& rootPrim, ImporterContext& ctx)
+    {
+        for (UsdPrim prim : UsdPrimRange(rootPrim, getTraversalPredicate(ctx)))
+        {
+            if (prim.HasVariantSets())
+            {
+                ctx.applyVariantOverrides(prim, ctx.builder.getSettings());
+            }
+        }
+    }
+
+    // Inspect a prim on its pre-visit. Returns true if the children of the prim should not be traversed.
+    bool visitPrim(const UsdPrim& prim, const ImporterContext& ctx, PrimVisit& visit)
+    {
+        std::string primName = prim.GetPath().GetString();
+        const Settings& settings = ctx.builder.getSettings();
+
+        visit.prim = prim;
+
+        // If this prim has an xform associated with it, it is pushed onto the xform stack
+        if (prim.IsA<UsdGeomXformable>())
+        {
+            visit.isXformable = true;
+            visit.localXform = ImporterContext::getLocalXform(UsdGeomXformable(prim));
+        }
+
+        if (prim.IsA<UsdGeomImageable>() && !isRenderable(UsdGeomImageable(prim)))
+        {
+            logDebug("Pruning non-renderable prim '{}'.", primName);
+            return true;
+        }
+
+        if (prim.IsInstance() && !ctx.useInstanceProxies)
+        {
+            if (!checkPrim(prim, settings)) return false;
+
+            if (!prim.GetPrototype().IsValid())
+            {
+                logError("No valid prototype prim for instance '{}'.", primName);
+                return true;
+            }
+            visit.type = PrimType::Instance;
+        }
+        else if (prim.IsA<UsdGeomPointInstancer>())
+        {
+            if (!checkPrim(prim, settings)) return false;
+
+            visit.type = PrimType::PointInstancer;
+            return true;
+        }
+        else if (prim.IsA<UsdGeomMesh>())
+        {
+            if (!checkPrim(prim, settings)) return false;
 
+            visit.type = PrimType::Mesh;
+            visit.timeSamples = ctx.getMeshTimeSamples(prim);
+            visit.bindXform = ctx.getGeomBindTransform(prim);
+        }
+        else if (prim.IsA<UsdGeomBasisCurves>())
+        {
+            if (!checkPrim(prim, settings)) return false;
 
-        UsdPrimRange range = UsdPrimRange::PreAndPostVisit(rootPrim, pred);
+            visit.type = PrimType::Curve;
+        }
+        else if (prim.IsA<UsdSkelRoot>())
+        {
+            visit.type = PrimType::SkelRoot;
+        }
+        else if (prim.IsA<UsdLuxDistantLight>())
+        {
+            visit.type = PrimType::DistantLight;
+        }
+        else if (prim.IsA<UsdLuxRectLight>())
+        {
+            visit.type = PrimType::RectLight;
+        }
+        else if (prim.IsA<UsdLuxSphereLight>())
+        {
+            visit.type = PrimType::SphereLight;
+        }
+        else if (prim.IsA<UsdLuxDiskLight>())
+        {
+            visit.type = PrimType::DiskLight;
+        }
+        else if (prim.IsA<UsdLuxDomeLight>())
+        {
+            visit.type = PrimType::DomeLight;
+        }
+        else if (prim.IsA<UsdGeomCamera>())
+        {
+            visit.type = PrimType::Camera;
+        }
+        else if (prim.IsA<UsdGeomXform>())
+        {
+            // Processing of this UsdGeomXformable is performed when the node is pushed
+        }
+        else if (prim.IsA<UsdShadeMaterial>() ||
+            prim.IsA<UsdShadeShader>() ||
+            prim.IsA<UsdGeomSubset>())
+        {
+            // No processing to do; ignore without issuing a warning.
+            return true;
+        }
+        else if (prim.IsA<UsdGeomScope>())
+        {
+            // Nothing to do besides traversing the children
+        }
+        else if (!prim.GetTypeName().GetString().empty())
+        {
+            logWarning("Ignoring prim '{}' of unsupported type {}.", primName, prim.GetTypeName().GetString());
+            return true;
+        }
 
-        for (auto it = range.begin(); it != range.end(); ++it)
+        return false;
+    }
+
+    // Returns true if the prim only groups its children, in which case its children can be traversed independently.
+    bool isGroupPrim(const UsdPrim& prim)
+    {
+        if (prim.IsInstance()) return false;
+        if (prim.IsA<UsdGeomImageable>() && !isRenderable(UsdGeomImageable(prim))) return false;
+        return prim.IsPseudoRoot() || prim.IsA<UsdGeomXform>() || prim.IsA<UsdGeomScope>() || prim.GetTypeName().IsEmpty();
+    }
+
+    // Split the stage traversal into segments that can be gathered in parallel.
+    // Grouping prims, such as xforms and scopes, are split into their pre-visit, the subtrees of their children and their post-visit,
+    // until there are enough subtrees to keep all worker threads busy.
+    std::vector<TraversalSegment> splitTraversal(const UsdPrim& rootPrim, const ImporterContext& ctx)
+    {
+        const Usd_PrimFlagsPredicate pred = getTraversalPredicate(ctx);
+        const size_t targetSubtreeCount = kTraversalSegmentsPerThread * tbb::this_task_arena::max_concurrency();
+
+        std::vector<TraversalSegment> segments(1);
+        segments[0].prim = rootPrim;
+        size_t subtreeCount = 1;
+
+        for (uint32_t depth = 0; depth < kMaxTraversalSplitDepth && subtreeCount < targetSubtreeCount; ++depth)
         {
-            UsdPrim prim = *it;
-            std::string primName = prim.GetPath().GetString();
+            std::vector<TraversalSegment> splitSegments;
+            subtreeCount = 0;
+            bool didSplit = false;
 
-            if (!it.IsPostVisit())
+            for (auto& segment : segments)
             {
-                // Pre visits
-                if (prim.HasVariantSets())
+                if (segment.kind != TraversalSegment::Kind::Subtree || !isGroupPrim(segment.prim))
                 {
-                    ctx.applyVariantOverrides(prim, ctx.builder.getSettings());
+                    if (segment.kind == TraversalSegment::Kind::Subtree) ++subtreeCount;
+                    splitSegments.push_back(std::move(segment));
+                    continue;
                 }
 
-                // If this prim has an xform associated with it, push it onto the xform stack
-                if (prim.IsA<UsdGeomXformable>())
+                splitSegments.push_back({ segment.prim, TraversalSegment::Kind::PreVisit });
+                for (const UsdPrim& child : segment.prim.GetFilteredChildren(pred))
                 {
-                    ctx.pushNode(UsdGeomXformable(prim));
+                    splitSegments.push_back({ child, TraversalSegment::Kind::Subtree });
+                    ++subtreeCount;
                 }
+                splitSegments.push_back({ segment.prim, TraversalSegment::Kind::PostVisit });
+                didSplit = true;
+            }
+
+            segments = std::move(splitSegments);
+            if (!didSplit) break;
+        }
+
+        return segments;
+    }
 
-                if (prim.IsA<UsdGeomImageable>() && !isRenderable(UsdGeomImageable(prim)))
+    // Gather the visits of a traversal segment. Only reads from the stage and the importer context, so segments can be gathered in parallel.
+    void gatherSegment(TraversalSegment& segment, const ImporterContext& ctx)
+    {
+        switch (segment.kind)
+        {
+        case TraversalSegment::Kind::Subtree:
+        {
+            UsdPrimRange range = UsdPrimRange::PreAndPostVisit(segment.prim, getTraversalPredicate(ctx));
+            for (auto it = range.begin(); it != range.end(); ++it)
+            {
+                if (it.IsPostVisit())
                 {
-                    logDebug("Pruning non-renderable prim '{}'.", primName);
-                    it.PruneChildren();
+                    // Only xformable prims need a post-visit, to pop their node.
+                    if (it->IsA<UsdGeomXformable>()) segment.visits.push_back(PrimVisit{ *it, PrimType::Other, true });
                     continue;
                 }
 
-                if (prim.IsInstance() && !ctx.useInstanceProxies)
-                {
-                    if (!checkPrim(prim, ctx.builder.getSettings())) continue;
-                    const UsdPrim protoPrim(prim.GetPrototype());
-
-                    if (protoPrim.IsValid())
-                    {
-                        logDebug("Adding instance '{}' of '{}'.", primName, protoPrim.GetPath().GetString());
-                        PrototypeInstance protoInst = { primName, protoPrim, ctx.nodeStack.back() };
-
-                        ctx.addPrototypeInstance(protoInst);
-                    }
-                    else
-                    {
-                        logError("No valid prototype prim for instance '{}'.", primName);
-                        it.PruneChildren();
-                        continue;
-                    }
-                }
-                else if (prim.IsA<UsdGeomPointInstancer>())
-                {
-                    if (!checkPrim(prim, ctx.builder.getSettings())) continue;
+                PrimVisit visit;
+                if (visitPrim(*it, ctx, visit)) it.PruneChildren();
+                segment.visits.push_back(std::move(visit));
+            }
+            break;
+        }
+        case TraversalSegment::Kind::PreVisit:
+        {
+            PrimVisit visit;
+            bool prune = visitPrim(segment.prim, ctx, visit);
+            FALCOR_ASSERT(!prune);
+            segment.visits.push_back(std::move(visit));
+            break;
+        }
+        case TraversalSegment::Kind::PostVisit:
+            if (segment.prim.IsA<UsdGeomXformable>()) segment.visits.push_back(PrimVisit{ segment.prim, PrimType::Other, true });
+            break;
+        }
+    }
 
-                    logDebug("Processing point instancer '{}'.", primName);
-                    ctx.createPointInstances(prim);
-                    it.PruneChildren();
-                }
-                else if (prim.IsA<UsdGeomMesh>())
-                {
-                    if (!checkPrim(prim, ctx.builder.getSettings())) continue;
+    // Add a visited prim to the importer context, converting supported prims from USD to Falcor equivalents.
+    // Visits must be added in traversal order, as they build up the scene graph.
+    void addPrim(PrimVisit& visit, ImporterContext& ctx)
+    {
+        const UsdPrim& prim = visit.prim;
 
-                    logDebug("Adding mesh '{}'.", primName);
-                    ctx.addMesh(prim);
-                    float4x4 bindXform = ctx.getGeomBindTransform(prim);
-                    ctx.addGeomInstance(primName, prim, float4x4::identity(), bindXform);
-                }
-                else if (prim.IsA<UsdGeomBasisCurves>())
-                {
-                    if (!checkPrim(prim, ctx.builder.getSettings())) continue;
+        if (visit.isPostVisit)
+        {
+            ctx.popNode();
+            return;
+        }
 
-                    logDebug("Adding curve '{}' for linear swept sphere tessellation.", primName);
-                    ctx.addCurve(prim);
+        if (visit.isXformable)
+        {
+            ctx.pushNode(UsdGeomXformable(prim), visit.localXform);
+        }
 
-                    // TODO: Add support for curve instancing
-                    // Now we assume each curve has only one instance.
-                    ctx.addCurveInstance(primName, prim, float4x4::identity(), ctx.nodeStack.back());
-                }
-                else if (prim.IsA<UsdSkelRoot>())
-                {
-                    logDebug("Processing Skeleton '{}'.", primName);
-                    ctx.createSkeleton(prim);
-                }
-                else if (prim.IsA<UsdLuxDistantLight>())
-                {
-                    logDebug("Processing distant light '{}'.", primName);
-                    ctx.createDistantLight(prim);
-                }
-                else if (prim.IsA<UsdLuxRectLight>())
-                {
-                    logDebug("Processing rect light '{}'.", primName);
-                    ctx.createRectLight(prim);
-                }
-                else if (prim.IsA<UsdLuxSphereLight>())
-                {
-                    logDebug("Processing sphere light '{}'.", primName);
-                    ctx.createSphereLight(prim);
-                }
-                else if (prim.IsA<UsdLuxDiskLight>())
-                {
-                    logDebug("Processing disk light '{}'.", primName);
-                    if (ctx.builder.getSettings().getOption("usdImporter:meshDiskLight", false))
-                    {
-                        ctx.createMeshedDiskLight(prim);
-                    }
-                    else
-                    {
-                        ctx.createDiskLight(prim);
-                    }
-                }
-                else if (prim.IsA<UsdLuxDomeLight>())
-                {
-                    logDebug("Processing dome light '{}'.", primName);
-                    ctx.createEnvMap(prim);
-                }
-                else if (prim.IsA<UsdGeomCamera>())
-                {
-                    logDebug("Processing camera '{}'.", primName);
-                    ctx.createCamera(prim);
-                }
-                else if (prim.IsA<UsdGeomXform>())
-                {
-                    logDebug("Processing xform '{}'.", primName);
-                    // Processing of this UsdGeomXformable performed above
-                }
-                else if (prim.IsA<UsdShadeMaterial>() ||
-                    prim.IsA<UsdShadeShader>() ||
-                    prim.IsA<UsdGeomSubset>())
-                {
-                    // No processing to do; ignore without issuing a warning.
-                    it.PruneChildren();
-                }
-                else if (prim.IsA<UsdGeomScope>())
-                {
-                    logDebug("Processing scope '{}'.", primName);
-                }
-                else if (!prim.GetTypeName().GetString().empty())
-                {
-                    logWarning("Ignoring prim '{}' of unsupported type {}.", primName, prim.GetTypeName().GetString());
-                    it.PruneChildren();
-                }
+        std::string primName = prim.GetPath().GetString();
+
+        switch (visit.type)
+        {
+        case PrimType::Instance:
+        {
+            const UsdPrim protoPrim(prim.GetPrototype());
+            logDebug("Adding instance '{}' of '{}'.", primName, protoPrim.GetPath().GetString());
+            PrototypeInstance protoInst = { primName, protoPrim, ctx.nodeStack.back() };
+            ctx.addPrototypeInstance(protoInst);
+            break;
+        }
+        case PrimType::PointInstancer:
+            logDebug("Processing point instancer '{}'.", primName);
+            ctx.createPointInstances(prim);
+            break;
+        case PrimType::Mesh:
+            logDebug("Adding mesh '{}'.", primName);
+            ctx.addMesh(prim, std::move(visit.timeSamples));
+            ctx.addGeomInstance(primName, prim, float4x4::identity(), visit.bindXform);
+            break;
+        case PrimType::Curve:
+            logDebug("Adding curve '{}' for linear swept sphere tessellation.", primName);
+            ctx.addCurve(prim);
+
+            // TODO: Add support for curve instancing
+            // Now we assume each curve has only one instance.
+            ctx.addCurveInstance(primName, prim, float4x4::identity(), ctx.nodeStack.back());
+            break;
+        case PrimType::SkelRoot:
+            logDebug("Processing Skeleton '{}'.", primName);
+            ctx.createSkeleton(prim);
+            break;
+        case PrimType::DistantLight:
+            logDebug("Processing distant light '{}'.", primName);
+            ctx.createDistantLight(prim);
+            break;
+        case PrimType::RectLight:
+            logDebug("Processing rect light '{}'.", primName);
+            ctx.createRectLight(prim);
+            break;
+        case PrimType::SphereLight:
+            logDebug("Processing sphere light '{}'.", primName);
+            ctx.createSphereLight(prim);
+            break;
+        case PrimType::DiskLight:
+            logDebug("Processing disk light '{}'.", primName);
+            if (ctx.builder.getSettings().getOption("usdImporter:meshDiskLight", false))
+            {
+                ctx.createMeshedDiskLight(prim);
             }
             else
             {
-                // Post visits
-                if (prim.IsA<UsdGeomXformable>())
-                {
-                    ctx.popNode();
-                }
+                ctx.createDiskLight(prim);
             }
+            break;
+        case PrimType::DomeLight:
+            logDebug("Processing dome light '{}'.", primName);
+            ctx.createEnvMap(prim);
+            break;
+        case PrimType::Camera:
+            logDebug("Processing camera '{}'.", primName);
+            ctx.createCamera(prim);
+            break;
+        case PrimType::Other:
+            break;
         }
     }
 
+    // Traverse scene graph, converting supported prims from USD to Falcor equivalents.
+    // The stage is split into subtrees that are inspected in parallel. The gathered visits are then added to the importer context
+    // sequentially in traversal order, so that the resulting scene does not depend on thread scheduling.
+    void traversePrims(const UsdPrim& rootPrim, ImporterContext& ctx, TimeReport& timeReport)
+    {
+        applyVariantOverrides(rootPrim, ctx);
+        timeReport.measure("Apply variant overrides");
+
+        std::vector<TraversalSegment> segments = splitTraversal(rootPrim, ctx);
+        tbb::parallel_for<size_t>(0, segments.size(),
+            [&](size_t i) { gatherSegment(segments[i], ctx); }
+        );
+
+        size_t visitCount = 0;
+        for (const auto& segment : segments) visitCount += segment.visits.size();
+        logInfo("USDImporter: Gathered {} prim visits in {} traversal segments.", visitCount, segments.size());
+        timeReport.measure("Gather prims");
+
+        for (auto& segment : segments)
+        {
+            for (auto& visit : segment.visits) addPrim(visit, ctx);
+        }
+        timeReport.measure("Create prims");
+    }
+
     template <typename T>
     T getMetadata(VtDictionary& renderDict, const std::string& key, T defaultValue)
     {
@@ -385,6 +613,8 @@ namespace Falcor
             }
             ctx.popNodeStack();
             FALCOR_ASSERT(ctx.getNodeStackDepth() == 0);
+
+            timeReport.measure("Create prototypes");
         }
 
         // Initialize stage-to-Falcor transformation based on specified stage up and unit scaling which
@@ -403,13 +633,11 @@ namespace Falcor
         ctx.setRootXform(rootXform);
 
         // Traverse the stage, converting USD prims to Falcor equivalents
-        traversePrims(rootPrim, ctx);
+        traversePrims(rootPrim, ctx, timeReport);
 
         // Only the stage root xform should remain.
         FALCOR_ASSERT(ctx.getNodeStackDepth() == 1);
 
-        timeReport.measure("Traverse prims");
-
         ctx.finalize();
 
         if (ctx.builder.getCameras().empty())
@@ -0,0 +1,41 @@
+import argparse
+import falcor
+
+DEFAULT_GRAPHS = ['scripts/SVAO++.py', 'scripts/PathTracer.py']
+
+def format_bytes(size):
+    for unit in ['B', 'kB', 'MB', 'GB']:
+        if size < 1024:
+            return f'{size:.2f} {unit}'
+        size /= 1024
+    return f'{size:.2f} TB'
+
+def main():
+    parser = argparse.ArgumentParser(description='Print render graph memory and bandwidth reports.')
+    parser.add_argument('graphs', nargs='*', default=DEFAULT_GRAPHS, help='Render graph scripts.')
+    parser.add_argument('--scene', type=str, default=None, help='Scene to load before compiling the graphs.')
+    parser.add_argument('--width', type=int, default=1920)
+    parser.add_argument('--height', type=int, default=1080)
+    parser.add_argument('--json', action='store_true', help='Print the full report as JSON.')
+    args = parser.parse_args()
+
+    testbed = falcor.Testbed(width=args.width, height=args.height, create_window=False)
+    if args.scene:
+        testbed.load_scene(args.scene)
+
+    for path in args.graphs:
+        graph = testbed.load_render_graph(path)
+        testbed.render_graph = graph
+
+        graph.resource_aliasing = True
+        report = graph.get_memory_report()
+
+        print(f'==== {path} ({args.width}x{args.height})')
+        print(report.to_json() if args.json else report.to_table())
+        print(f'Peak memory before aliasing: {format_bytes(report.peak_bytes_before_aliasing)}')
+        print(f'Peak memory after aliasing:  {format_bytes(report.peak_bytes_after_aliasing)}')
+        print(f'Peak alive (lower bound):    {format_bytes(report.min_peak_bytes)}')
+        print()
+
+if __name__ == '__main__':
+    main()